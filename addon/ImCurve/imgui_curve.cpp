@@ -1,4 +1,7 @@
 #include "imgui_curve.h"
+#if __AVX__
+#include <immintrin.h>
+#endif
 
 // CurveEdit from https://github.com/CedricGuillemet/ImGuizmo
 template <typename T>
@@ -95,6 +98,69 @@ float ImGui::ImCurveEdit::smoothstep(float edge0, float edge1, float t, CurveTyp
     }
 }
 
+#if __AVX__
+// float polynomial types 8 values per step, same operation order as scalar, returns values done
+static int smoothstep_avx(float edge0, float edge1, const float* t, float* out, int n, ImGui::ImCurveEdit::CurveType type)
+{
+    using namespace ImGui;
+    switch (type)
+    {
+        case ImCurveEdit::Hold: case ImCurveEdit::Step: case ImCurveEdit::Linear: case ImCurveEdit::Smooth:
+        case ImCurveEdit::QuadIn: case ImCurveEdit::QuadOut: case ImCurveEdit::QuadInOut:
+        case ImCurveEdit::CubicIn: case ImCurveEdit::CubicOut: break;
+        default: return 0;
+    }
+    const __m256 e0 = _mm256_set1_ps(edge0);
+    const __m256 range = _mm256_set1_ps(edge1 - edge0);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 two = _mm256_set1_ps(2.f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 x = _mm256_div_ps(_mm256_sub_ps(_mm256_loadu_ps(t + i), e0), range);
+        x = _mm256_min_ps(_mm256_max_ps(x, zero), one);
+        __m256 y = x;
+        switch (type)
+        {
+            case ImCurveEdit::Hold: y = zero; break;
+            case ImCurveEdit::Step: y = _mm256_and_ps(_mm256_cmp_ps(x, half, _CMP_GT_OQ), one); break;
+            case ImCurveEdit::Smooth: y = _mm256_mul_ps(_mm256_mul_ps(x, x), _mm256_sub_ps(_mm256_set1_ps(3.f), _mm256_mul_ps(two, x))); break;
+            case ImCurveEdit::QuadIn: y = _mm256_mul_ps(x, x); break;
+            case ImCurveEdit::QuadOut: y = _mm256_sub_ps(zero, _mm256_mul_ps(x, _mm256_sub_ps(x, two))); break;
+            case ImCurveEdit::QuadInOut:
+            {
+                __m256 in = _mm256_mul_ps(_mm256_mul_ps(two, x), x);
+                __m256 out_ = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(-2.f), x), x), _mm256_mul_ps(_mm256_set1_ps(4.f), x)), one);
+                y = _mm256_blendv_ps(out_, in, _mm256_cmp_ps(x, half, _CMP_LT_OQ));
+                break;
+            }
+            case ImCurveEdit::CubicIn: y = _mm256_mul_ps(_mm256_mul_ps(x, x), x); break;
+            case ImCurveEdit::CubicOut:
+            {
+                __m256 x1 = _mm256_sub_ps(x, one);
+                y = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(x1, x1), x1), one);
+                break;
+            }
+            default: break;
+        }
+        _mm256_storeu_ps(out + i, y);
+    }
+    return i;
+}
+#endif
+
+void ImGui::ImCurveEdit::smoothstep(float edge0, float edge1, const float* t, float* out, int n, CurveType type)
+{
+    int i = 0;
+#if __AVX__
+    i = smoothstep_avx(edge0, edge1, t, out, n, type);
+#endif
+    for (; i < n; i++)
+        out[i] = smoothstep(edge0, edge1, t[i], type);
+}
+
 float ImGui::ImCurveEdit::distance(float x1, float y1, float x2, float y2)
 {
     float dx = x2 - x1;
@@ -654,6 +720,7 @@ bool ImGui::ImCurveEdit::Edit(ImDrawList* draw_list, Delegate* delegate, const I
 ImGui::KeyPointEditor& ImGui::KeyPointEditor::operator=(const ImGui::KeyPointEditor& keypoint)
 {
     mKeys.clear();
+    mCaches.clear();
     for (auto curve : keypoint.mKeys)
     {
         auto curve_index = AddCurve(curve.name, curve.type, curve.color, curve.visible, curve.m_min, curve.m_max, curve.m_default);
@@ -848,12 +915,17 @@ int ImGui::KeyPointEditor::EditPoint(size_t curveIndex, size_t pointIndex, ImVec
         {
             auto value_range = fabs(GetCurveMax(curveIndex) - GetCurveMin(curveIndex)); 
             auto point_value = (value.y - GetCurveMin(curveIndex)) / (value_range + FLT_EPSILON);
+            InvalidateCache(curveIndex, pointIndex);
             mKeys[curveIndex].points[pointIndex] = {ImVec2(value.x, point_value), type};
             SortValues(curveIndex);
+            UpdateCache(curveIndex);
             for (size_t i = 0; i < GetCurvePointCount(curveIndex); i++)
             {
                 if (mKeys[curveIndex].points[i].point.x == value.x)
+                {
+                    InvalidateCache(curveIndex, i);
                     return (int)i;
+                }
             }
         }
     }
@@ -890,6 +962,12 @@ void ImGui::KeyPointEditor::AddPoint(size_t curveIndex, ImVec2 value, ImCurveEdi
         {
             mKeys[curveIndex].points.push_back({ImVec2(value.x, value.y), type});
             SortValues(curveIndex);
+            UpdateCache(curveIndex);
+            for (size_t i = 0; i < GetCurvePointCount(curveIndex); i++)
+            {
+                if (mKeys[curveIndex].points[i].point.x == value.x)
+                    InvalidateCache(curveIndex, i);
+            }
         }
     }
 }
@@ -899,6 +977,7 @@ void ImGui::KeyPointEditor::ClearPoint(size_t curveIndex)
     if (curveIndex < mKeys.size())
     {
         mKeys[curveIndex].points.clear();
+        InvalidateCache(curveIndex);
     }
 }
 
@@ -908,8 +987,10 @@ void ImGui::KeyPointEditor::DeletePoint(size_t curveIndex, size_t pointIndex)
     {
         if (pointIndex < mKeys[curveIndex].points.size())
         {
+            InvalidateCache(curveIndex, pointIndex);
             auto iter = mKeys[curveIndex].points.begin() + pointIndex;
             mKeys[curveIndex].points.erase(iter);
+            UpdateCache(curveIndex);
         }
     }
 }
@@ -920,6 +1001,7 @@ int ImGui::KeyPointEditor::AddCurve(std::string name, ImCurveEdit::CurveType typ
     new_key.m_id = _id;
     new_key.m_sub_id = _sub_id;
     mKeys.push_back(new_key);
+    mCaches.push_back(CurveCache());
     return mKeys.size() - 1;
 }
 
@@ -929,6 +1011,7 @@ void ImGui::KeyPointEditor::DeleteCurve(size_t curveIndex)
     {
         auto iter = mKeys.begin() + curveIndex;
         mKeys.erase(iter);
+        mCaches.erase(mCaches.begin() + curveIndex);
     }
 }
 
@@ -1002,39 +1085,514 @@ float ImGui::KeyPointEditor::GetPointValue(size_t curveIndex, float t)
 
 float ImGui::KeyPointEditor::GetValue(size_t curveIndex, float t)
 {
-    if (curveIndex < mKeys.size())
+    const size_t ptCount = GetCurvePointCount(curveIndex);
+    if (ptCount <= 1)
+    {
+        float value = 0;
+        GetValues(curveIndex, &t, &value, 1);
+        return value;
+    }
+    const CurveCache& cache = mCaches[curveIndex];
+    int cursor = 0;
+    const int index = FindSegment(cache, t, cursor);
+    if (index < 0)
+        return 0;
+    const CurveSegment& segment = cache.segments[index];
+    const ImCurveEdit::CurveType type = (t - segment.x0) < (segment.x1 - t) ? segment.type0 : segment.type1;
+    const float rt = segment.x1 > segment.x0 ? ImCurveEdit::smoothstep(segment.x0, segment.x1, t, type) : 0.f;
+    const float y = (segment.y0 + segment.dy * rt - mMin.y) / (mMax.y - mMin.y);
+    return y * fabs(GetCurveMax(curveIndex) - GetCurveMin(curveIndex)) + GetCurveMin(curveIndex);
+}
+
+// t belongs to the first segment containing it, so a shared key point ends the earlier segment
+static inline bool SegmentContains(const ImGui::KeyPointEditor::CurveSegment* segments, int index, float t)
+{
+    return (t > segments[index].x0 || (index == 0 && t == segments[index].x0)) && t <= segments[index].x1;
+}
+
+int ImGui::KeyPointEditor::FindSegment(const CurveCache& cache, float t, int& cursor)
+{
+    const CurveSegment* segments = cache.segments.data();
+    const int count = (int)cache.segments.size();
+    int index = ImClamp(cursor, 0, count - 1);
+    if (!SegmentContains(segments, index, t))
     {
-        auto range = GetMax() - GetMin() + ImVec2(1.f, 0.f); 
-        auto value_range = fabs(GetCurveMax(curveIndex) - GetCurveMin(curveIndex)); 
-        auto pointToRange = [&](ImVec2 pt) { return (pt - GetMin()) / range; };
-        const size_t ptCount = GetCurvePointCount(curveIndex);
-        if (ptCount <= 0)
-            return 0;
-        const ImCurveEdit::KeyPoint* pts = GetPoints(curveIndex);
-        if (ptCount <= 1)
-            return pointToRange(pts[0].point).x;
-        int found_index = -1;
-        for (int i = 0; i < ptCount - 1; i++)
+        if (index + 1 < count && SegmentContains(segments, index + 1, t))
+            index++;
+        else
         {
-            if (t >= pts[i].point.x && t <= pts[i + 1].point.x)
-            {
-                found_index = i;
-                break;
-            }
+            index = (int)(std::lower_bound(segments, segments + count, t, [](const CurveSegment& segment, float v) { return segment.x1 < v; }) - segments);
+            if (index == count || !SegmentContains(segments, index, t))
+                return -1;
         }
-        if (found_index != -1)
+    }
+    cursor = index;
+    return index;
+}
+
+void ImGui::KeyPointEditor::UpdateCache(size_t curveIndex)
+{
+    CurveCache& cache = mCaches[curveIndex];
+    const ImCurveEdit::keys& key = mKeys[curveIndex];
+    cache.segments.resize(key.points.size() > 1 ? key.points.size() - 1 : 0);
+    for (size_t i = 0; i < cache.segments.size(); i++)
+    {
+        const ImCurveEdit::KeyPoint& p1 = key.points[i];
+        const ImCurveEdit::KeyPoint& p2 = key.points[i + 1];
+        CurveSegment& segment = cache.segments[i];
+        segment.x0 = p1.point.x;
+        segment.x1 = p2.point.x;
+        segment.y0 = p1.point.y;
+        segment.dy = p2.point.y - p1.point.y;
+        segment.type0 = p1.type;
+        segment.type1 = p2.type;
+    }
+}
+
+void ImGui::KeyPointEditor::GetValues(size_t curveIndex, const float* ts, float* values, int n)
+{
+    if (n <= 0)
+        return;
+    const size_t ptCount = GetCurvePointCount(curveIndex);
+    if (ptCount <= 1)
+    {
+        // no segment, a single point gives its position in range like before
+        const float value = ptCount == 0 ? 0.f : (mKeys[curveIndex].points[0].point.x - GetMin().x) / (GetMax().x - GetMin().x + 1.f);
+        for (int i = 0; i < n; i++) values[i] = value;
+        return;
+    }
+    const CurveCache& cache = mCaches[curveIndex];
+    const CurveSegment* segments = cache.segments.data();
+    const float range_y = mMax.y - mMin.y;
+    const float value_range = fabs(GetCurveMax(curveIndex) - GetCurveMin(curveIndex));
+    const float value_min = GetCurveMin(curveIndex);
+    const int kRun = 256;
+    float rt[kRun];
+    int cursor = 0;
+    for (int i = 0; i < n;)
+    {
+        const float t = ts[i];
+        const int index = FindSegment(cache, t, cursor);
+        if (index < 0)
+        {
+            // outside of key points
+            values[i++] = 0;
+            continue;
+        }
+        // run of times in same half of segment, which share curve type
+        const CurveSegment& segment = segments[index];
+        const bool first_half = (t - segment.x0) < (segment.x1 - t);
+        int run = 1;
+        while (run < kRun && i + run < n && SegmentContains(segments, index, ts[i + run]) && ((ts[i + run] - segment.x0) < (segment.x1 - ts[i + run])) == first_half)
+            run++;
+        if (segment.x1 > segment.x0)
+            ImCurveEdit::smoothstep(segment.x0, segment.x1, ts + i, rt, run, first_half ? segment.type0 : segment.type1);
+        else
+            for (int k = 0; k < run; k++) rt[k] = 0;
+        for (int k = 0; k < run; k++)
+            values[i + k] = (segment.y0 + segment.dy * rt[k] - mMin.y) / range_y * value_range + value_min;
+        i += run;
+    }
+}
+
+// span of the segments next to a point, before and after it changes
+void ImGui::KeyPointEditor::InvalidateCache(size_t curveIndex, size_t pointIndex)
+{
+    if (curveIndex >= mCaches.size())
+        return;
+    CurveCache& cache = mCaches[curveIndex];
+    const std::vector<ImCurveEdit::KeyPoint>& points = mKeys[curveIndex].points;
+    if (pointIndex >= points.size())
+    {
+        cache.dirty_all = true;
+        return;
+    }
+    cache.dirty_x0 = ImMin(cache.dirty_x0, points[pointIndex > 0 ? pointIndex - 1 : 0].point.x);
+    cache.dirty_x1 = ImMax(cache.dirty_x1, points[ImMin(pointIndex + 1, points.size() - 1)].point.x);
+}
+
+// every key point and the x after it, so a key point is a piece of its own, curve types like ExpInOut
+// jump to their end value right at the key. And first x of the second half of segments that change
+// curve type there or step, as GetValues decides halves
+void ImGui::KeyPointEditor::CurveBreaks(size_t curveIndex, std::vector<float>& breaks)
+{
+    breaks.clear();
+    const CurveCache& cache = mCaches[curveIndex];
+    const int count = (int)cache.segments.size();
+    if (count > 0)
+        breaks.push_back(nextafterf(cache.segments[0].x0, FLT_MAX));
+    for (int index = 0; index < count; index++)
+    {
+        const CurveSegment& segment = cache.segments[index];
+        if (segment.x1 > segment.x0 && (segment.type0 != segment.type1 || segment.type1 == ImCurveEdit::Step))
         {
-            const ImVec2 p1 = pointToRange(pts[found_index].point);
-            const ImVec2 p2 = pointToRange(pts[found_index + 1].point);
-            float x = (t - pts[found_index].point.x) / (pts[found_index + 1].point.x - pts[found_index].point.x);
-            const ImVec2 sp = ImLerp(p1, p2, x);
-            ImCurveEdit::CurveType type = (t - pts[found_index].point.x) < (pts[found_index + 1].point.x - t) ? pts[found_index].type : pts[found_index + 1].type;
-            const float rt = ImCurveEdit::smoothstep(p1.x, p2.x, sp.x, type);
-            const float v = ImLerp(p1.y, p2.y, rt);
-            return v * value_range + GetCurveMin(curveIndex);
+            auto first_half = [&segment](float t) { return (t - segment.x0) < (segment.x1 - t); };
+            float x = segment.x0 + (segment.x1 - segment.x0) * 0.5f;
+            while (x > segment.x0 && !first_half(nextafterf(x, segment.x0)))
+                x = nextafterf(x, segment.x0);
+            while (x < segment.x1 && first_half(x))
+                x = nextafterf(x, segment.x1);
+            if (segment.type1 == ImCurveEdit::Step)
+                while (x < segment.x1 && ImCurveEdit::smoothstep(segment.x0, segment.x1, x, ImCurveEdit::Step) < 0.5f)
+                    x = nextafterf(x, segment.x1);
+            if (x > segment.x0 && x < segment.x1)
+                breaks.push_back(x);
+        }
+        breaks.push_back(segment.x1);
+        if (index + 1 < count)
+            breaks.push_back(nextafterf(segment.x1, FLT_MAX));
+    }
+}
+
+bool ImGui::KeyPointEditor::BakeCurve(size_t curveIndex, ImCurveTable& table, float tolerance, int maxSize)
+{
+    const size_t ptCount = GetCurvePointCount(curveIndex);
+    if (ptCount == 0)
+    {
+        table.Clear();
+        return false;
+    }
+    const std::vector<ImCurveEdit::KeyPoint>& points = mKeys[curveIndex].points;
+    std::vector<float> breaks;
+    if (ptCount > 1)
+        CurveBreaks(curveIndex, breaks);
+    bool ok = table.Bake([this, curveIndex](const float* xs, float* values, int n) { GetValues(curveIndex, xs, values, n); },
+                        points.front().point.x, points.back().point.x, tolerance, maxSize, breaks);
+    CurveCache& cache = mCaches[curveIndex];
+    cache.min_y = mMin.y;
+    cache.max_y = mMax.y;
+    cache.curve_min = mKeys[curveIndex].m_min;
+    cache.curve_max = mKeys[curveIndex].m_max;
+    cache.dirty_x0 = FLT_MAX;
+    cache.dirty_x1 = -FLT_MAX;
+    cache.dirty_all = false;
+    return ok;
+}
+
+bool ImGui::KeyPointEditor::UpdateBakedCurve(size_t curveIndex, ImCurveTable& table)
+{
+    const size_t ptCount = GetCurvePointCount(curveIndex);
+    if (ptCount == 0)
+    {
+        table.Clear();
+        return false;
+    }
+    const std::vector<ImCurveEdit::KeyPoint>& points = mKeys[curveIndex].points;
+    CurveCache& cache = mCaches[curveIndex];
+    // value range or key range changed, every piece has to be built again, min and max are also
+    // reachable by reference, so they are compared rather than tracked
+    const bool same_range = cache.min_y == mMin.y && cache.max_y == mMax.y && cache.curve_min == mKeys[curveIndex].m_min && cache.curve_max == mKeys[curveIndex].m_max;
+    if (table.Empty() || cache.dirty_all || !same_range || table.x0 != points.front().point.x || table.x1 != points.back().point.x)
+        return BakeCurve(curveIndex, table, table.tolerance > 0.f ? table.tolerance : 1e-3f, table.max_size > 0 ? table.max_size : 1 << 16);
+    if (cache.dirty_x0 > cache.dirty_x1)
+        return table.max_error <= table.tolerance;
+    const float from = cache.dirty_x0, to = cache.dirty_x1;
+    cache.dirty_x0 = FLT_MAX;
+    cache.dirty_x1 = -FLT_MAX;
+    std::vector<float> breaks;
+    CurveBreaks(curveIndex, breaks);
+    return table.Rebake([this, curveIndex](const float* xs, float* values, int n) { GetValues(curveIndex, xs, values, n); }, from, to, &breaks);
+}
+
+// grid and check positions, computed the same way for every piece so a rebuilt piece gets the same values
+static inline float TableX(float x0, float x1, int k, int intervals)
+{
+    return k == intervals ? x1 : x0 + (x1 - x0) * ((float)k / (float)intervals);
+}
+
+// lerp of one piece, same arithmetic as ImCurveTable::Sample
+static inline float PieceLerp(const float* values, int intervals, float start, float scale, float x)
+{
+    float u = (x - start) * scale;
+    u = u < 0.f ? 0.f : u > (float)intervals ? (float)intervals : u;
+    int i = (int)u;
+    if (i >= intervals) i = intervals - 1;
+    return values[i] + (values[i + 1] - values[i]) * (u - (float)i);
+}
+
+static inline float PieceScale(float start, float end, int intervals)
+{
+    return end > start ? (float)intervals / (end - start) : 0.f;
+}
+
+// values of [start, end] and error measured at kCheck points inside every interval, false when no float
+// lies between grid points any more, then a halved piece can not be sampled between them either
+static bool EvaluatePiece(const ImGui::ImCurveTable::Source& source, float start, float end, float& error, std::vector<float>& values)
+{
+    const int intervals = end > start ? ImGui::ImCurveTable::kBlock : 1;
+    const int checks = intervals * (ImGui::ImCurveTable::kCheck + 1);
+    std::vector<float> xs(checks);
+    values.resize(intervals + 1);
+    for (int k = 0; k <= intervals; k++)
+        xs[k] = TableX(start, end, k, intervals);
+    source(xs.data(), values.data(), intervals + 1);
+    error = 0.f;
+    if (intervals == 1)
+        return false;
+    bool resolvable = false;
+    for (int k = 0; k < intervals && !resolvable; k++)
+        resolvable = xs[k + 1] > nextafterf(xs[k], FLT_MAX);
+    int n = 0;
+    for (int i = 0; i < intervals; i++)
+        for (int j = 1; j <= ImGui::ImCurveTable::kCheck; j++)
+            xs[n++] = TableX(start, end, i * (ImGui::ImCurveTable::kCheck + 1) + j, checks);
+    std::vector<float> exact(n);
+    source(xs.data(), exact.data(), n);
+    const float scale = PieceScale(start, end, intervals);
+    for (int k = 0; k < n; k++)
+        error = ImMax(error, fabsf(exact[k] - PieceLerp(values.data(), intervals, start, scale, xs[k])));
+    return resolvable;
+}
+
+// pieces of [piece_breaks[0], end] cut at piece_breaks, pieces over tolerance are halved worst first while
+// budget intervals last
+void ImGui::ImCurveTable::BuildPieces(const Source& source, const std::vector<float>& piece_breaks, float end, int budget, std::vector<Piece>& pieces) const
+{
+    pieces.resize(piece_breaks.size());
+    std::vector<bool> splittable(pieces.size());
+    int intervals = 0;
+    for (size_t k = 0; k < pieces.size(); k++)
+    {
+        Piece& piece = pieces[k];
+        piece.start = piece_breaks[k];
+        piece.end = k + 1 < pieces.size() ? nextafterf(piece_breaks[k + 1], -FLT_MAX) : end;
+        splittable[k] = EvaluatePiece(source, piece.start, piece.end, piece.error, piece.values);
+        intervals += (int)piece.values.size() - 1;
+    }
+    // a quarter of the tolerance is kept for the error between check points, kinks of Bounce curves
+    // peak there
+    const float target = tolerance * 0.75f;
+    while (intervals + kBlock <= budget)
+    {
+        int worst = -1;
+        for (int k = 0; k < (int)pieces.size(); k++)
+            if (splittable[k] && pieces[k].error > target && (worst < 0 || pieces[k].error > pieces[worst].error))
+                worst = k;
+        if (worst < 0)
+            break;
+        Piece left, right;
+        left.start = pieces[worst].start;
+        right.end = pieces[worst].end;
+        right.start = left.start + (right.end - left.start) * 0.5f;
+        left.end = nextafterf(right.start, -FLT_MAX);
+        const bool left_splittable = EvaluatePiece(source, left.start, left.end, left.error, left.values);
+        const bool right_splittable = EvaluatePiece(source, right.start, right.end, right.error, right.values);
+        pieces[worst] = std::move(left);
+        splittable[worst] = left_splittable;
+        pieces.insert(pieces.begin() + worst + 1, std::move(right));
+        splittable.insert(splittable.begin() + worst + 1, right_splittable);
+        intervals += kBlock;
+    }
+}
+
+// pieces [first, last) of the table are replaced, offsets, lookup and max_error are built again
+void ImGui::ImCurveTable::Assemble(std::vector<Piece>& pieces, int first, int last)
+{
+    const int old_count = Pieces();
+    const int count = old_count - (last - first) + (int)pieces.size();
+    std::vector<float> new_starts, new_scales, new_errors, new_values;
+    std::vector<int> new_offsets;
+    new_starts.reserve(count + 1);
+    new_scales.reserve(count);
+    new_errors.reserve(count);
+    new_offsets.reserve(count + 1);
+    auto add = [&](float start, float end, float error, const float* v, int n)
+    {
+        new_starts.push_back(start);
+        new_scales.push_back(PieceScale(start, end, n - 1));
+        new_errors.push_back(error);
+        new_offsets.push_back((int)new_values.size());
+        new_values.insert(new_values.end(), v, v + n);
+    };
+    auto add_old = [&](int k)
+    {
+        const int n = offsets[k + 1] - offsets[k];
+        const float end = k + 1 < old_count ? nextafterf(starts[k + 1], -FLT_MAX) : x1;
+        add(starts[k], end, errors[k], values.data() + offsets[k], n);
+    };
+    for (int k = 0; k < first; k++)
+        add_old(k);
+    for (auto& piece : pieces)
+        add(piece.start, piece.end, piece.error, piece.values.data(), (int)piece.values.size());
+    for (int k = last; k < old_count; k++)
+        add_old(k);
+    new_starts.push_back(FLT_MAX);
+    new_offsets.push_back((int)new_values.size());
+    starts.swap(new_starts);
+    scales.swap(new_scales);
+    errors.swap(new_errors);
+    offsets.swap(new_offsets);
+    values.swap(new_values);
+
+    max_error = 0.f;
+    for (float error : errors)
+        max_error = ImMax(max_error, error);
+    // a few buckets per piece, walking from the bucket piece mostly ends at once
+    const int buckets = x1 > x0 ? ImClamp(count * 4, 16, 1 << 16) : 1;
+    lookup_scale = x1 > x0 ? (float)buckets / (x1 - x0) : 0.f;
+    auto bucket_of = [&](float x)
+    {
+        const int bucket = (int)((x - x0) * lookup_scale);
+        return bucket < 0 ? 0 : bucket >= buckets ? buckets - 1 : bucket;
+    };
+    lookup.resize(buckets);
+    // last piece starting in an earlier bucket, no x of the bucket lies before it
+    int piece = 0;
+    for (int b = 0; b < buckets; b++)
+    {
+        while (piece + 1 < count && bucket_of(starts[piece + 1]) < b)
+            piece++;
+        lookup[b] = piece;
+    }
+}
+
+bool ImGui::ImCurveTable::Bake(const Source& source, float _x0, float _x1, float _tolerance, int maxSize, const std::vector<float>& _breaks)
+{
+    x0 = _x0;
+    x1 = ImMax(_x0, _x1);
+    tolerance = _tolerance;
+    max_size = ImMax(maxSize, kBlock);
+    breaks.assign(1, x0);
+    for (float x : _breaks)
+        if (x > x0 && x <= x1 && x > breaks.back())
+            breaks.push_back(x);
+    std::vector<Piece> pieces;
+    BuildPieces(source, breaks, x1, max_size, pieces);
+    starts.clear();
+    scales.clear();
+    errors.clear();
+    offsets.clear();
+    values.clear();
+    Assemble(pieces, 0, 0);
+    return max_error <= tolerance;
+}
+
+bool ImGui::ImCurveTable::Rebake(const Source& source, float from, float to, const std::vector<float>* _breaks)
+{
+    if (Empty())
+        return false;
+    if (!(x1 > x0))
+        return Bake(source, x0, x1, tolerance, max_size);
+    if (from > to)
+        ImSwap(from, to);
+    if (to < x0 || from > x1)
+        return max_error <= tolerance;
+    // rebuilt range starts at a break and ends before one, so it gets the pieces a full bake would give
+    const int break0 = ImMax((int)(std::upper_bound(breaks.begin(), breaks.end(), from) - breaks.begin()) - 1, 0);
+    const int break1 = (int)(std::upper_bound(breaks.begin(), breaks.end(), to) - breaks.begin());
+    const float start = breaks[break0];
+    const float end = break1 < (int)breaks.size() ? nextafterf(breaks[break1], -FLT_MAX) : x1;
+    std::vector<float> range_breaks(1, start);
+    if (_breaks)
+    {
+        for (float x : *_breaks)
+            if (x > start && x <= end && x > range_breaks.back())
+                range_breaks.push_back(x);
+    }
+    else
+        range_breaks.insert(range_breaks.end(), breaks.begin() + break0 + 1, breaks.begin() + break1);
+    const int first = (int)(std::lower_bound(starts.begin(), starts.end() - 1, start) - starts.begin());
+    const int last = break1 < (int)breaks.size() ? (int)(std::lower_bound(starts.begin(), starts.end() - 1, breaks[break1]) - starts.begin()) : Pieces();
+    const int kept = Intervals() - (offsets[last] - offsets[first] - (last - first));
+    const bool was_capped = Intervals() + kBlock > max_size;
+    std::vector<Piece> pieces;
+    BuildPieces(source, range_breaks, end, max_size - kept, pieces);
+    Assemble(pieces, first, last);
+    breaks.erase(breaks.begin() + break0, breaks.begin() + break1);
+    breaks.insert(breaks.begin() + break0, range_breaks.begin(), range_breaks.end());
+    // the size cap decided which pieces got split, a full bake shares the intervals out again
+    if (max_error > tolerance && (was_capped || Intervals() + kBlock > max_size))
+        return Bake(source, x0, x1, tolerance, max_size, std::vector<float>(breaks.begin() + 1, breaks.end()));
+    return max_error <= tolerance;
+}
+
+// joints of the splines, splines are smooth across them but pieces should not straddle a joint
+static void SplineBreaks(int numSplines, const ImGui::ImSpline::cSpline2 splines[], std::vector<float>& breaks)
+{
+    breaks.clear();
+    for (int i = 1; i < numSplines; i++)
+        breaks.push_back(ImGui::ImSpline::Position0(splines[i]).x);
+}
+
+bool ImGui::ImCurveTable::BakeSplines(int numSplines, const ImSpline::cSpline2 splines[], float _tolerance, int maxSize)
+{
+    if (numSplines <= 0)
+    {
+        Clear();
+        return false;
+    }
+    std::vector<float> joints;
+    SplineBreaks(numSplines, splines, joints);
+    return Bake([numSplines, splines](const float* xs, float* out, int n) { ImSpline::EvaluateY(numSplines, splines, n, xs, out); },
+                ImSpline::Position0(splines[0]).x, ImSpline::Position1(splines[numSplines - 1]).x, _tolerance, maxSize, joints);
+}
+
+bool ImGui::ImCurveTable::RebakeSplines(int numSplines, const ImSpline::cSpline2 splines[], float from, float to)
+{
+    if (numSplines <= 0)
+        return false;
+    std::vector<float> joints;
+    SplineBreaks(numSplines, splines, joints);
+    return Rebake([numSplines, splines](const float* xs, float* out, int n) { ImSpline::EvaluateY(numSplines, splines, n, xs, out); }, from, to, &joints);
+}
+
+void ImGui::ImCurveTable::Sample(const float* xs, float* out, int n) const
+{
+    if (Empty())
+    {
+        for (int i = 0; i < n; i++) out[i] = 0.f;
+        return;
+    }
+    int i = 0;
+#if __AVX2__
+    const __m256 lo = _mm256_set1_ps(x0), hi = _mm256_set1_ps(x1), lookup_scale8 = _mm256_set1_ps(lookup_scale);
+    const __m256i last_bucket = _mm256_set1_epi32((int)lookup.size() - 1), one = _mm256_set1_epi32(1);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(xs + i), lo), hi);
+        // sorted times mostly stay in the piece of the first lane, then only the values are gathered
+        const int first = FindPiece(ImClamp(xs[i], x0, x1));
+        const __m256 inside = _mm256_and_ps(_mm256_cmp_ps(x, _mm256_set1_ps(starts[first]), _CMP_GE_OQ), _mm256_cmp_ps(x, _mm256_set1_ps(starts[first + 1]), _CMP_LT_OQ));
+        if (_mm256_movemask_ps(inside) == 0xFF)
+        {
+            const int intervals = offsets[first + 1] - offsets[first] - 1;
+            __m256 u = _mm256_mul_ps(_mm256_sub_ps(x, _mm256_set1_ps(starts[first])), _mm256_set1_ps(scales[first]));
+            u = _mm256_min_ps(_mm256_max_ps(u, _mm256_setzero_ps()), _mm256_set1_ps((float)intervals));
+            const __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(u), _mm256_set1_epi32(intervals - 1));
+            const __m256 f = _mm256_sub_ps(u, _mm256_cvtepi32_ps(index));
+            const float* v = values.data() + offsets[first];
+            const __m256 v0 = _mm256_i32gather_ps(v, index, 4);
+            const __m256 v1 = _mm256_i32gather_ps(v + 1, index, 4);
+            _mm256_storeu_ps(out + i, _mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), f)));
+            continue;
+        }
+        __m256i bucket = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(x, lo), lookup_scale8));
+        bucket = _mm256_min_epi32(_mm256_max_epi32(bucket, _mm256_setzero_si256()), last_bucket);
+        __m256i piece = _mm256_i32gather_epi32(lookup.data(), bucket, 4);
+        // one step forward as FindPiece, buckets crossed by more pieces go scalar
+        __m256 behind = _mm256_cmp_ps(_mm256_i32gather_ps(starts.data() + 1, piece, 4), x, _CMP_LE_OQ);
+        piece = _mm256_sub_epi32(piece, _mm256_castps_si256(behind));
+        behind = _mm256_cmp_ps(_mm256_i32gather_ps(starts.data() + 1, piece, 4), x, _CMP_LE_OQ);
+        if (_mm256_movemask_ps(behind))
+        {
+            for (int k = 0; k < 8; k++)
+                out[i + k] = Sample(xs[i + k]);
+            continue;
         }
+        const __m256i offset = _mm256_i32gather_epi32(offsets.data(), piece, 4);
+        const __m256i intervals = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_i32gather_epi32(offsets.data() + 1, piece, 4), offset), one);
+        __m256 u = _mm256_mul_ps(_mm256_sub_ps(x, _mm256_i32gather_ps(starts.data(), piece, 4)), _mm256_i32gather_ps(scales.data(), piece, 4));
+        u = _mm256_min_ps(_mm256_max_ps(u, _mm256_setzero_ps()), _mm256_cvtepi32_ps(intervals));
+        const __m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(u), _mm256_sub_epi32(intervals, one));
+        const __m256 f = _mm256_sub_ps(u, _mm256_cvtepi32_ps(index));
+        const __m256i at = _mm256_add_epi32(offset, index);
+        const __m256 v0 = _mm256_i32gather_ps(values.data(), at, 4);
+        const __m256 v1 = _mm256_i32gather_ps(values.data() + 1, at, 4);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), f)));
     }
-    return 0;
+#endif
+    for (; i < n; i++)
+        out[i] = Sample(xs[i]);
 }
 
 void ImGui::KeyPointEditor::SetCurvePointDefault(size_t curveIndex, size_t pointIndex)
@@ -1048,6 +1606,8 @@ void ImGui::KeyPointEditor::SetCurvePointDefault(size_t curveIndex, size_t point
             value_default = (value_default - GetCurveMin(curveIndex)) / (value_range + FLT_EPSILON);
             mKeys[curveIndex].points[pointIndex].point.y = value_default;
             mKeys[curveIndex].points[pointIndex].type = GetCurveType(curveIndex);
+            InvalidateCache(curveIndex, pointIndex);
+            UpdateCache(curveIndex);
         }
     }
 }
@@ -1064,6 +1624,7 @@ void ImGui::KeyPointEditor::MoveTo(float x)
         {
             iter->point.x += offset;
         }
+        InvalidateCache(i);
     }
 }
 
@@ -1099,6 +1660,7 @@ void ImGui::KeyPointEditor::SetMin(ImVec2 vmin, bool dock)
                     start_iter->point.y = value;
                 }
             }
+            InvalidateCache(i);
         }
     }
     mMin = vmin;
@@ -1136,6 +1698,7 @@ void ImGui::KeyPointEditor::SetMax(ImVec2 vmax, bool dock)
                     end_iter->point.y = value;
                 }
             }
+            InvalidateCache(i);
         }
     }
     mMax = vmax;
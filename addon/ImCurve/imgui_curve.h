@@ -9,6 +9,7 @@
 #include <imgui_json.h>
 #include <imgui_helper.h>
 #include <imgui_extra_widget.h>
+#include "imgui_spline.h"
 
 // CurveEdit from https://github.com/CedricGuillemet/ImGuizmo
 namespace ImGui
@@ -131,7 +132,7 @@ struct IMGUI_API ImCurveEdit
         virtual std::string GetCurveName(size_t curveIndex) = 0;
         virtual int64_t GetCurveID(size_t curveIndex) = 0;
         virtual int64_t GetCurveSubID(size_t curveIndex) = 0;
-        virtual KeyPoint* GetPoints(size_t curveIndex) = 0;
+        virtual const KeyPoint* GetPoints(size_t curveIndex) = 0;
         virtual KeyPoint GetPoint(size_t curveIndex, size_t pointIndex) = 0;
         virtual ImVec2 GetPrevPoint(float pos) = 0;
         virtual ImVec2 GetNextPoint(float pos) = 0;
@@ -139,6 +140,7 @@ struct IMGUI_API ImCurveEdit
         virtual int EditPoint(size_t curveIndex, size_t pointIndex, ImVec2 value, CurveType type) = 0;
         virtual void AddPoint(size_t curveIndex, ImVec2 value, CurveType type) = 0;
         virtual float GetValue(size_t curveIndex, float t) = 0;
+        virtual void GetValues(size_t curveIndex, const float* ts, float* values, int n) { for (int i = 0; i < n; i++) values[i] = GetValue(curveIndex, ts[i]); }
         virtual float GetPointValue(size_t curveIndex, float t) = 0;
         virtual void ClearPoint(size_t curveIndex) = 0;
         virtual void DeletePoint(size_t curveIndex, size_t pointIndex) = 0;
@@ -175,6 +177,7 @@ private:
 public:
     static int GetCurveTypeName(char**& list);
     static float smoothstep(float edge0, float edge1, float t, CurveType type);
+    static void smoothstep(float edge0, float edge1, const float* t, float* out, int n, CurveType type);
     static float distance(float x1, float y1, float x2, float y2);
     static float distance(float x, float y, float x1, float y1, float x2, float y2);
     static bool Edit(ImDrawList* draw_list, Delegate* delegate, const ImVec2& size, unsigned int id, bool editable, float& cursor_pos, unsigned int flags = CURVE_EDIT_FLAG_NONE, const ImRect* clippingRect = NULL, bool * changed = nullptr);
@@ -183,6 +186,78 @@ public:
                     unsigned int flags = CURVE_EDIT_FLAG_NONE, const ImRect* clippingRect = NULL, bool * changed = nullptr);
 };
 
+// lookup table of a curve over [x0, x1], clamped outside of the range. The range is cut into pieces at
+// breaks, x where the source may jump or change type, and each piece is a uniform table of kBlock
+// intervals sampled by one lerp. Interpolation error is measured at kCheck points inside every interval,
+// and pieces are halved until it is within 3/4 of tolerance or maxSize intervals are used, so steps
+// and infinite slopes get short pieces next to them instead of a finer table everywhere. max_error is the
+// largest measured error of the final table. Rebake rebuilds only the pieces between the breaks around
+// an edited range.
+struct IMGUI_API ImCurveTable
+{
+    typedef std::function<void(const float* xs, float* values, int n)> Source;
+    static const int kBlock = 64;
+    static const int kCheck = 7;
+
+    float x0 {0.f}, x1 {0.f};
+    float tolerance {0.f};
+    float max_error {0.f};
+    int max_size {0};
+    std::vector<float> breaks;          // start of each unsplit piece, x0 first, a break starts a new piece
+    std::vector<float> starts;          // start of each piece, ascending, followed by FLT_MAX
+    std::vector<float> scales;          // intervals per x unit of each piece, 0 for a single point
+    std::vector<int> offsets;           // first value of each piece, followed by values.size()
+    std::vector<float> errors;          // measured error of each piece
+    std::vector<float> values;          // intervals + 1 values of each piece
+    std::vector<int> lookup;            // piece at or before each uniform bucket of [x0, x1]
+    float lookup_scale {0.f};           // buckets per x unit
+
+    // breaks must lie in (_x0, _x1], KeyPointEditor passes each key point, the x after it and the point
+    // where a segment changes curve type
+    bool Bake(const Source& source, float _x0, float _x1, float _tolerance = 1e-3f, int maxSize = 1 << 16, const std::vector<float>& _breaks = std::vector<float>());
+    // breaks of the rebuilt range are replaced by _breaks in it, other breaks stay
+    bool Rebake(const Source& source, float from, float to, const std::vector<float>* _breaks = nullptr);
+    bool BakeSplines(int numSplines, const ImSpline::cSpline2 splines[], float _tolerance = 1e-3f, int maxSize = 1 << 16);
+    bool RebakeSplines(int numSplines, const ImSpline::cSpline2 splines[], float from, float to); // splines keep the baked x range
+    void Clear() { breaks.clear(); starts.clear(); scales.clear(); offsets.clear(); errors.clear(); values.clear(); lookup.clear(); max_error = 0.f; }
+    bool Empty() const { return values.size() < 2; }
+    int Pieces() const { return (int)scales.size(); }
+    int Intervals() const { return (int)values.size() - Pieces(); }
+    inline int FindPiece(float x) const
+    {
+        const int buckets = (int)lookup.size();
+        int bucket = (int)((x - x0) * lookup_scale);
+        bucket = bucket < 0 ? 0 : bucket >= buckets ? buckets - 1 : bucket;
+        int piece = lookup[bucket];
+        while (starts[piece + 1] <= x) piece++;
+        return piece;
+    }
+    inline float Sample(float x) const
+    {
+        if (Empty()) return 0.f;
+        x = x < x0 ? x0 : x > x1 ? x1 : x;
+        const int piece = FindPiece(x);
+        const float* v = values.data() + offsets[piece];
+        const int intervals = offsets[piece + 1] - offsets[piece] - 1;
+        float u = (x - starts[piece]) * scales[piece];
+        u = u < 0.f ? 0.f : u > (float)intervals ? (float)intervals : u;
+        int i = (int)u;
+        if (i >= intervals) i = intervals - 1;
+        return v[i] + (v[i + 1] - v[i]) * (u - (float)i);
+    }
+    void Sample(const float* xs, float* out, int n) const;
+
+private:
+    struct Piece
+    {
+        float start, end;
+        float error;
+        std::vector<float> values;
+    };
+    void BuildPieces(const Source& source, const std::vector<float>& piece_breaks, float end, int budget, std::vector<Piece>& pieces) const;
+    void Assemble(std::vector<Piece>& pieces, int first, int last);
+};
+
 struct IMGUI_API KeyPointEditor : public ImCurveEdit::Delegate
 {
     KeyPointEditor() {}
@@ -191,7 +266,7 @@ struct IMGUI_API KeyPointEditor : public ImCurveEdit::Delegate
     {}
     ~KeyPointEditor() { mKeys.clear(); }
 
-    void Clear() { mKeys.clear(); }
+    void Clear() { mKeys.clear(); mCaches.clear(); }
 
     KeyPointEditor& operator=(const KeyPointEditor& keypoint);
     ImVec2 GetPrevPoint(float pos);
@@ -212,6 +287,12 @@ struct IMGUI_API KeyPointEditor : public ImCurveEdit::Delegate
     const ImCurveEdit::keys* GetCurveKey(size_t curveIndex);
     float GetPointValue(size_t curveIndex, float t);
     float GetValue(size_t curveIndex, float t);
+    // batch GetValue, sorted times walk the segments with a cursor, others are binary searched
+    void GetValues(size_t curveIndex, const float* ts, float* values, int n);
+    // table of one curve from first to last key point, broken at key points and curve type changes,
+    // UpdateBakedCurve re-bakes the ranges edited since, only one table per curve is tracked
+    bool BakeCurve(size_t curveIndex, ImCurveTable& table, float tolerance = 1e-3f, int maxSize = 1 << 16);
+    bool UpdateBakedCurve(size_t curveIndex, ImCurveTable& table);
     void SetCurvePointDefault(size_t curveIndex, size_t pointIndex);
     void MoveTo(float x);
     void SetMin(ImVec2 vmin, bool dock = false);
@@ -231,7 +312,7 @@ struct IMGUI_API KeyPointEditor : public ImCurveEdit::Delegate
     void SetCurveColor(size_t curveIndex, ImU32 color) { if (curveIndex < mKeys.size()) mKeys[curveIndex].color = color; }
     void SetCurveName(size_t curveIndex, std::string name) { if (curveIndex < mKeys.size()) mKeys[curveIndex].name = name; }
     void SetCurveVisible(size_t curveIndex, bool visible) { if (curveIndex < mKeys.size()) mKeys[curveIndex].visible = visible; }
-    ImCurveEdit::KeyPoint* GetPoints(size_t curveIndex) { if (curveIndex < mKeys.size()) return mKeys[curveIndex].points.data(); return nullptr; }
+    const ImCurveEdit::KeyPoint* GetPoints(size_t curveIndex) { if (curveIndex < mKeys.size()) return mKeys[curveIndex].points.data(); return nullptr; }
     ImVec2& GetMax() { return mMax; }
     ImVec2& GetMin() { return mMin; }
     float GetCurveMin(size_t curveIndex) { if (curveIndex < mKeys.size()) return mKeys[curveIndex].m_min; return 0.f; }
@@ -255,8 +336,35 @@ private:
     ImU32 BackgroundColor {IM_COL32(24, 24, 24, 255)};
     ImU32 GraticuleColor {IM_COL32(48, 48, 48, 128)};
 
+public:
+    // per segment key values of GetValue, rebuilt by the calls that change points, value ranges
+    // are applied when read, so GetValue and GetValues only read it
+    struct CurveSegment
+    {
+        float x0, x1;
+        float y0, dy;
+        ImCurveEdit::CurveType type0, type1;
+    };
+    struct CurveCache
+    {
+        std::vector<CurveSegment> segments;
+        // value ranges and x range edited since last bake
+        float min_y {0.f}, max_y {0.f};
+        float curve_min {0.f}, curve_max {0.f};
+        float dirty_x0 {FLT_MAX}, dirty_x1 {-FLT_MAX};
+        bool dirty_all {true};
+    };
+
+private:
+    std::vector<CurveCache> mCaches;
+
 private:
     void SortValues(size_t curveIndex);
+    void InvalidateCache(size_t curveIndex) { if (curveIndex < mCaches.size()) { mCaches[curveIndex].dirty_all = true; UpdateCache(curveIndex); } }
+    void InvalidateCache(size_t curveIndex, size_t pointIndex);
+    void UpdateCache(size_t curveIndex);
+    static int FindSegment(const CurveCache& cache, float t, int& cursor);
+    void CurveBreaks(size_t curveIndex, std::vector<float>& breaks);
 };
 
 IMGUI_API bool ImCurveEditKey(std::string button_lable, ImGui::ImCurveEdit::keys * key, std::string name, float _min, float _max, float _default, float space = 0);
@@ -447,6 +447,76 @@ float ImSpline::Curvature(const cSpline2& spline, float t)
     return avCrossLen / (vLen * vLen * vLen);
 }
 
+void ImSpline::EvaluateY(int numSplines, const cSpline2 splines[], int count, const float x[], float y[])
+{
+    if (numSplines <= 0)
+    {
+        for (int i = 0; i < count; i++) y[i] = 0.0f;
+        return;
+    }
+    const float xStart = splines[0].xb.x;
+    const float xEnd = splines[numSplines - 1].xb.w;
+    int index = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const float xi = x[i];
+        if (xi <= xStart)
+        {
+            y[i] = splines[0].yb.x;
+            continue;
+        }
+        if (xi >= xEnd)
+        {
+            y[i] = splines[numSplines - 1].yb.w;
+            continue;
+        }
+        // sorted x stay on the same or the next spline, others are binary searched
+        if (!(xi >= splines[index].xb.x && xi <= splines[index].xb.w))
+        {
+            if (index + 1 < numSplines && xi >= splines[index + 1].xb.x && xi <= splines[index + 1].xb.w)
+                index++;
+            else
+            {
+                int lo = 0, hi = numSplines - 1;
+                while (lo < hi)
+                {
+                    int mid = (lo + hi) / 2;
+                    if (splines[mid].xb.w < xi)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                index = lo;
+            }
+        }
+        const cSpline2& s = splines[index];
+
+        // x(t) in power basis, solved by Newton iteration kept inside a bisection bracket
+        const float a = s.xb.x;
+        const float b = 3.0f * (s.xb.y - s.xb.x);
+        const float c = 3.0f * (s.xb.x - 2.0f * s.xb.y + s.xb.z);
+        const float d = s.xb.w - s.xb.x + 3.0f * (s.xb.y - s.xb.z);
+        const float width = s.xb.w - s.xb.x;
+        const float epsilon = 1e-6f * (width > 0.0f ? width : 1.0f);
+        float lo = 0.0f, hi = 1.0f;
+        float t = width > 0.0f ? (xi - s.xb.x) / width : 0.0f;
+        for (int iter = 0; iter < 16; iter++)
+        {
+            float f = a + t * (b + t * (c + t * d)) - xi;
+            if (fabsf(f) <= epsilon)
+                break;
+            if (f < 0.0f)
+                lo = t;
+            else
+                hi = t;
+            float df = b + t * (2.0f * c + t * 3.0f * d);
+            float tn = df != 0.0f ? t - f / df : lo - 1.0f;
+            t = (tn > lo && tn < hi) ? tn : 0.5f * (lo + hi);
+        }
+        y[i] = Evaluate(s, BezierWeights(t)).y;
+    }
+}
+
 float ImSpline::LengthEstimate(const cSpline2& s, float* error)
 {
     // Our convex hull is p0, p1, p2, p3, so p0_p3 is our minimum possible length, and p0_p1 + p1_p2 + p2_p3 our maximum.
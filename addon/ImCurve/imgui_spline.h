@@ -53,6 +53,7 @@ namespace ImSpline
     IMGUI_API ImVec2 Velocity    (const cSpline2& spline, float t); ///< Returns interpolated velocity
     IMGUI_API ImVec2 Acceleration(const cSpline2& spline, float t); ///< Returns interpolated acceleration
     IMGUI_API float  Curvature    (const cSpline2& spline, float t); ///< Returns interpolated curvature. Curvature = 1 / r where r is the radius of the local turning circle, so 0 for flat.
+    IMGUI_API void   EvaluateY    (int numSplines, const cSpline2 splines[], int count, const float x[], float y[]); ///< Fills y[i] with the y of the splines at x[i], for splines continuous and monotonic in x such as animation curves. x outside of the splines is clamped to the end points.
 
     IMGUI_API float LengthEstimate(const cSpline2& s, float* error);              ///< Returns estimate of length of s and optionally in 'error' the maximum error of that length.
     IMGUI_API float Length        (const cSpline2& s, float maxError = 0.01f);    ///< Returns length of spline accurate to the given tolerance, using multiple LengthEstimate() calls.
@@ -92,8 +92,10 @@ void* ImVulkanVkMatMapping(const VkMat &src)
     return nullptr;
 }
 
-void ImVulkanShaderInit()
+void ImVulkanShaderInit(const std::string& cache_dir)
 {
+    if (!cache_dir.empty())
+        set_shader_cache_dir(cache_dir);
     create_gpu_instance();
 }
 
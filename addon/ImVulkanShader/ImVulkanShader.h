@@ -14,7 +14,7 @@ namespace ImGui
     VKSHADER_API void  ImVulkanVkMatToImMat(const VkMat &src, ImMat &dst);
     VKSHADER_API void  ImVulkanVkMatToVkImageMat(const VkMat &src, VkImageMat &dst);
     VKSHADER_API void* ImVulkanVkMatMapping(const VkMat &src);
-    VKSHADER_API void  ImVulkanShaderInit();
+    VKSHADER_API void  ImVulkanShaderInit(const std::string& cache_dir = std::string());
     VKSHADER_API void  ImVulkanShaderClear();
     VKSHADER_API float ImVulkanPeak(VulkanDevice* vkdev, int loop, int count_mb, int cmd_loop, int storage_type, int arithmetic_type, int packing_type);
 } //namespace ImGui
\ No newline at end of file
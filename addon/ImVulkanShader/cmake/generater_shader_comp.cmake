@@ -7,13 +7,20 @@ set(LOCAL_SHADER_COMP ${CMAKE_CURRENT_BINARY_DIR}/comp/${SHADER_SRC_NAME_WE}_${S
 set(LOCAL_SHADER_GENERATE ${CMAKE_CURRENT_BINARY_DIR}/src/${SHADER_SRC_NAME_WE}_${SHADER_DATA}.cpp)
 set(LOCAL_SHADER_GENERATE_OBJ ${CMAKE_CURRENT_BINARY_DIR}/gen/${SHADER_SRC_NAME_WE}_${SHADER_DATA}.o)
 set(LOCAL_SHADER_GENERATE_EXE ${CMAKE_CURRENT_BINARY_DIR}/gen/${SHADER_SRC_NAME_WE}_${SHADER_DATA})
+# extra arguments are macros the runtime source defines before including the shader header
+set(LOCAL_SHADER_DEFINES "")
+foreach(SHADER_DEFINE ${ARGN})
+    string(APPEND LOCAL_SHADER_DEFINES "#define ${SHADER_DEFINE}\n")
+endforeach()
+# comp is written in binary mode, spirv keys hash its bytes against the runtime LF strings
 file(WRITE ${LOCAL_SHADER_GENERATE}
+    "${LOCAL_SHADER_DEFINES}"
     "#include \"${SHADER_SRC}\"\n"
     "#include <stdio.h>\n"
     "#include <string.h>\n"
     "int main() \n"
     "{\n"
-    "    FILE * f = fopen(\"${LOCAL_SHADER_COMP}\", \"w\");\n"
+    "    FILE * f = fopen(\"${LOCAL_SHADER_COMP}\", \"wb\");\n"
     "    if (f)\n"
     "    {\n"
     "        fwrite(${SHADER_DATA}, 1, strlen(${SHADER_DATA}), f);\n"
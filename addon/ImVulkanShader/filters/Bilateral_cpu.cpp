@@ -0,0 +1,411 @@
+#include "Bilateral_cpu.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+// Output rows of one exact tile
+#define EXACT_TILE_ROWS 32
+// Grid cells padded around x and range, blur kernel is 5 taps
+#define GRID_PAD 2
+// Grid rows sliced by one band, bands are built and blurred independently
+#define GRID_BAND_ROWS 16
+#define GRID_MAX_DEPTH 256
+
+namespace ImGui
+{
+// same as shader color_format_mapping_vec4, 3 channels formats keep rgb order of their own
+static inline void color_format_mapping(ImColorFormat format, int map[4])
+{
+    switch (format)
+    {
+        case IM_CF_ABGR: case IM_CF_BGR: map[0] = 0; map[1] = 1; map[2] = 2; map[3] = 3; break;
+        case IM_CF_ARGB: case IM_CF_RGB: map[0] = 2; map[1] = 1; map[2] = 0; map[3] = 3; break;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; map[3] = 0; break;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; map[3] = 0; break;
+        default: map[0] = map[1] = map[2] = map[3] = 0; break;
+    }
+}
+
+static inline bool is_supported_type(ImDataType type)
+{
+    return type == IM_DT_INT8 || type == IM_DT_INT16 || type == IM_DT_INT16_BE || type == IM_DT_FLOAT16 || type == IM_DT_FLOAT32;
+}
+
+template<typename T, typename F>
+static inline void load_pixels(const ImMat& src, const int map[4], int y, int x0, int n, float* rgba, F cvt)
+{
+    const T* p = (const T *)src.data + ((size_t)y * src.w + x0) * src.c;
+    for (int i = 0; i < n; i++, p += src.c, rgba += 4)
+    {
+        for (int k = 0; k < 3; k++)
+            rgba[k] = cvt(p[map[k] < src.c ? map[k] : 0]);
+        rgba[3] = src.c == 4 ? cvt(p[map[3]]) : 1.f;
+    }
+}
+
+// n pixels of row y from x0 as r, g, b, a floats in 0..1
+static void load_row(const ImMat& src, const int map[4], int y, int x0, int n, float* rgba)
+{
+    switch (src.type)
+    {
+        case IM_DT_INT8: load_pixels<uint8_t>(src, map, y, x0, n, rgba, [](uint8_t v) { return (float)v / 255.f; }); break;
+        case IM_DT_INT16: load_pixels<uint16_t>(src, map, y, x0, n, rgba, [](uint16_t v) { return (float)v / 65535.f; }); break;
+        case IM_DT_INT16_BE: load_pixels<uint16_t>(src, map, y, x0, n, rgba, [](uint16_t v) { return (float)(uint16_t)((v << 8) | (v >> 8)) / 65535.f; }); break;
+        case IM_DT_FLOAT16: load_pixels<uint16_t>(src, map, y, x0, n, rgba, [](uint16_t v) { return im_float16_to_float32(v); }); break;
+        case IM_DT_FLOAT32: load_pixels<float>(src, map, y, x0, n, rgba, [](float v) { return v; }); break;
+        default: break;
+    }
+}
+
+// uint(floor(v * scale)) clamped to [0, scale], as shader store functions
+static inline uint32_t quantize(float v, float scale)
+{
+    return (uint32_t)std::min(std::max(floorf(v * scale), 0.f), scale);
+}
+
+static void store_row(ImMat& dst, const int map[4], int y, int n, const float* rgba)
+{
+    const size_t offset = (size_t)y * dst.w * 4;
+    switch (dst.type)
+    {
+        case IM_DT_INT8:
+        {
+            uint8_t* o = (uint8_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = (uint8_t)quantize(rgba[k], 255.f);
+            break;
+        }
+        case IM_DT_INT16:
+        case IM_DT_INT16_BE:
+        {
+            const bool be = dst.type == IM_DT_INT16_BE;
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++)
+                {
+                    const uint16_t v = (uint16_t)quantize(rgba[k], 65535.f);
+                    o[map[k]] = be ? (uint16_t)((v << 8) | (v >> 8)) : v;
+                }
+            break;
+        }
+        case IM_DT_FLOAT16:
+        {
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = im_float32_to_float16(std::min(std::max(rgba[k], 0.f), 1.f));
+            break;
+        }
+        case IM_DT_FLOAT32:
+        {
+            float* o = (float *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = std::min(std::max(rgba[k], 0.f), 1.f);
+            break;
+        }
+        default: break;
+    }
+}
+
+static inline int exact_radius(int ksz, float sigma_spatial)
+{
+    // taps farther than 4 sigma weight less than exp(-8)
+    return std::min(ksz / 2, (int)ceilf(4.f * sigma_spatial));
+}
+
+#if __AVX2__
+// exp for x <= 0, 2^(x * log2(e)) split in integer and fraction, fraction by 6th order series
+static inline __m256 exp256_neg(__m256 x)
+{
+    x = _mm256_max_ps(x, _mm256_set1_ps(-87.f));
+    const __m256 fx = _mm256_mul_ps(x, _mm256_set1_ps(1.44269504f));
+    const __m256 fi = _mm256_floor_ps(fx);
+    const __m256 f = _mm256_sub_ps(fx, fi);
+    __m256 p = _mm256_set1_ps(1.5403530e-4f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(1.3333558e-3f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(9.6181291e-3f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(5.5504109e-2f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(2.4022651e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(6.9314718e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(1.f));
+    const __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(fi), _mm256_set1_epi32(127)), 23);
+    return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+}
+
+static inline __m256 abs256(__m256 x)
+{
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.f), x);
+}
+#endif
+
+struct bilateral_tap
+{
+    int dx, dy;
+    float weight;
+};
+
+// Tiles of EXACT_TILE_ROWS rows are copied into planar r, g, b with clamped border of radius,
+// then every output pixel sums its taps. AVX2 takes 8 neighbor pixels of a tap at once.
+static void bilateral_exact(const ImMat& src, ImMat& dst, const int in_map[4], const int out_map[4], int ksz, float sigma_spatial, float sigma_color)
+{
+    const int w = src.w, h = src.h;
+    const int r = ksz / 2, radius = exact_radius(ksz, sigma_spatial);
+    const float ks = -0.5f / (sigma_spatial * sigma_spatial);
+    const float kc = -0.5f / (sigma_color * sigma_color);
+
+    // shader window is [-r, ksz - r) inside disk of r, taps are kept in row order
+    std::vector<bilateral_tap> taps;
+    for (int dy = -r; dy < ksz - r; dy++)
+        for (int dx = -r; dx < ksz - r; dx++)
+        {
+            const int space2 = dx * dx + dy * dy;
+            if (space2 < r * r && space2 <= radius * radius)
+                taps.push_back({dx, dy, expf((float)space2 * ks)});
+        }
+    const int pad = std::max(r, 1);
+    const int pw = w + 2 * pad;
+    const int tiles = (h + EXACT_TILE_ROWS - 1) / EXACT_TILE_ROWS;
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int t = 0; t < tiles; t++)
+    {
+        const int y0 = t * EXACT_TILE_ROWS;
+        const int rows = std::min(EXACT_TILE_ROWS, h - y0);
+        const int ph = rows + 2 * pad;
+        std::vector<float> planes((size_t)pw * ph * 3);
+        std::vector<float> line((size_t)w * 4);
+        std::vector<float> alpha((size_t)w * rows);
+        float* R = planes.data();
+        float* G = R + (size_t)pw * ph;
+        float* B = G + (size_t)pw * ph;
+        for (int py = 0; py < ph; py++)
+        {
+            const int y = std::min(std::max(y0 - pad + py, 0), h - 1);
+            load_row(src, in_map, y, 0, w, line.data());
+            for (int px = 0; px < pw; px++)
+            {
+                const float* p = line.data() + (size_t)std::min(std::max(px - pad, 0), w - 1) * 4;
+                R[(size_t)py * pw + px] = p[0];
+                G[(size_t)py * pw + px] = p[1];
+                B[(size_t)py * pw + px] = p[2];
+            }
+            if (py >= pad && py < pad + rows)
+                for (int x = 0; x < w; x++) alpha[(size_t)(py - pad) * w + x] = line[(size_t)x * 4 + 3];
+        }
+
+        for (int ty = 0; ty < rows; ty++)
+        {
+            const size_t center = (size_t)(ty + pad) * pw + pad;
+            int x = 0;
+#if __AVX2__
+            const __m256 vkc = _mm256_set1_ps(kc);
+            for (; x + 8 <= w; x += 8)
+            {
+                const __m256 cr = _mm256_loadu_ps(R + center + x);
+                const __m256 cg = _mm256_loadu_ps(G + center + x);
+                const __m256 cb = _mm256_loadu_ps(B + center + x);
+                __m256 sr = _mm256_setzero_ps(), sg = _mm256_setzero_ps(), sb = _mm256_setzero_ps(), sw = _mm256_setzero_ps();
+                for (const auto& tap : taps)
+                {
+                    const size_t offset = center + x + (ptrdiff_t)tap.dy * pw + tap.dx;
+                    const __m256 vr = _mm256_loadu_ps(R + offset);
+                    const __m256 vg = _mm256_loadu_ps(G + offset);
+                    const __m256 vb = _mm256_loadu_ps(B + offset);
+                    const __m256 norm = _mm256_add_ps(_mm256_add_ps(abs256(_mm256_sub_ps(vr, cr)), abs256(_mm256_sub_ps(vg, cg))), abs256(_mm256_sub_ps(vb, cb)));
+                    const __m256 weight = _mm256_mul_ps(_mm256_set1_ps(tap.weight), exp256_neg(_mm256_mul_ps(_mm256_mul_ps(norm, norm), vkc)));
+                    sr = _mm256_add_ps(sr, _mm256_mul_ps(weight, vr));
+                    sg = _mm256_add_ps(sg, _mm256_mul_ps(weight, vg));
+                    sb = _mm256_add_ps(sb, _mm256_mul_ps(weight, vb));
+                    sw = _mm256_add_ps(sw, weight);
+                }
+                // no tap in window keeps center
+                const __m256 empty = _mm256_cmp_ps(sw, _mm256_setzero_ps(), _CMP_EQ_OQ);
+                const __m256 inv = _mm256_div_ps(_mm256_set1_ps(1.f), _mm256_blendv_ps(sw, _mm256_set1_ps(1.f), empty));
+                float out[3][8];
+                _mm256_storeu_ps(out[0], _mm256_blendv_ps(_mm256_mul_ps(sr, inv), cr, empty));
+                _mm256_storeu_ps(out[1], _mm256_blendv_ps(_mm256_mul_ps(sg, inv), cg, empty));
+                _mm256_storeu_ps(out[2], _mm256_blendv_ps(_mm256_mul_ps(sb, inv), cb, empty));
+                for (int i = 0; i < 8; i++)
+                {
+                    float* o = line.data() + (size_t)(x + i) * 4;
+                    o[0] = out[0][i]; o[1] = out[1][i]; o[2] = out[2][i];
+                }
+            }
+#endif
+            for (; x < w; x++)
+            {
+                const float cr = R[center + x], cg = G[center + x], cb = B[center + x];
+                float sr = 0, sg = 0, sb = 0, sw = 0;
+                for (const auto& tap : taps)
+                {
+                    const size_t offset = center + x + (ptrdiff_t)tap.dy * pw + tap.dx;
+                    const float norm = fabsf(R[offset] - cr) + fabsf(G[offset] - cg) + fabsf(B[offset] - cb);
+                    const float weight = tap.weight * expf(norm * norm * kc);
+                    sr += weight * R[offset];
+                    sg += weight * G[offset];
+                    sb += weight * B[offset];
+                    sw += weight;
+                }
+                float* o = line.data() + (size_t)x * 4;
+                o[0] = sw > 0 ? sr / sw : cr;
+                o[1] = sw > 0 ? sg / sw : cg;
+                o[2] = sw > 0 ? sb / sw : cb;
+            }
+            for (int i = 0; i < w; i++)
+                line[(size_t)i * 4 + 3] = alpha[(size_t)ty * w + i];
+            store_row(dst, out_map, y0 + ty, w, line.data());
+        }
+    }
+}
+
+// [1 4 6 4 1] along one axis of count items, item is lanes floats at stride, zero outside
+static void grid_blur(const float* in, float* out, int count, size_t stride, int lanes)
+{
+    static const float k[5] = {1.f, 4.f, 6.f, 4.f, 1.f};
+    for (int i = 0; i < count; i++)
+    {
+        float* o = out + (size_t)i * stride;
+        std::fill(o, o + lanes, 0.f);
+        for (int t = -2; t <= 2; t++)
+        {
+            const int j = i + t;
+            if (j < 0 || j >= count)
+                continue;
+            const float* p = in + (size_t)j * stride;
+            const float kt = k[t + 2];
+            for (int l = 0; l < lanes; l++)
+                o[l] += kt * p[l];
+        }
+    }
+}
+
+// Bilateral grid, cells are premultiplied r, g, b and weight. Grid rows are processed in bands of
+// GRID_BAND_ROWS with halo, so grid memory stays small and bands run in parallel.
+static void bilateral_grid(const ImMat& src, ImMat& dst, const int in_map[4], const int out_map[4], int ksz, float sigma_spatial, float sigma_color)
+{
+    const int w = src.w, h = src.h;
+    // window of exact filter cuts the gaussian, narrower grid gaussian follows it
+    const float ss = std::max(std::min(sigma_spatial, (float)(ksz / 2) / 2.f), 1.f);
+    const float sr = sigma_color;
+    const int gw = (int)((w - 1) / ss) + 2 + 2 * GRID_PAD;
+    const int gd = (int)(3.f / sr) + 2 + 2 * GRID_PAD;
+    const int grid_rows = (int)((h - 1) / ss) + 2;
+    const int bands = (grid_rows + GRID_BAND_ROWS - 1) / GRID_BAND_ROWS;
+    const size_t row_floats = (size_t)gw * gd * 4;
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int b = 0; b < bands; b++)
+    {
+        // slice reads blurred grid rows [j0, j1 + 1], they are blurred from raw rows [j0 - 2, j1 + 3]
+        const int j0 = b * GRID_BAND_ROWS;
+        const int j1 = std::min(j0 + GRID_BAND_ROWS, grid_rows) - 1;
+        const int base = j0 - 2;
+        const int rows = j1 - j0 + 6;
+        std::vector<float> grid(row_floats * rows), temp(row_floats * rows);
+        std::vector<float> line((size_t)w * 4);
+
+        // splat image rows touching raw rows, y / ss in (base - 1, base + rows)
+        const int ys = std::max((int)ceilf((base - 1) * ss), 0);
+        const int ye = std::min((int)((base + rows) * ss), h - 1);
+        for (int y = ys; y <= ye; y++)
+        {
+            const float fy = y / ss - base;
+            const int iy = (int)floorf(fy);
+            const float wy = fy - iy;
+            load_row(src, in_map, y, 0, w, line.data());
+            for (int x = 0; x < w; x++)
+            {
+                const float* p = line.data() + (size_t)x * 4;
+                const float fx = x / ss + GRID_PAD;
+                const float fz = std::min(std::max(p[0] + p[1] + p[2], 0.f), 3.f) / sr + GRID_PAD;
+                const int ix = (int)fx, iz = (int)fz;
+                const float wx = fx - ix, wz = fz - iz;
+                for (int cy = 0; cy < 2; cy++)
+                {
+                    const int row = iy + cy;
+                    if (row < 0 || row >= rows)
+                        continue;
+                    const float vy = cy ? wy : 1.f - wy;
+                    for (int cx = 0; cx < 2; cx++)
+                    for (int cz = 0; cz < 2; cz++)
+                    {
+                        const float weight = vy * (cx ? wx : 1.f - wx) * (cz ? wz : 1.f - wz);
+                        float* cell = grid.data() + (size_t)row * row_floats + ((size_t)(ix + cx) * gd + iz + cz) * 4;
+                        cell[0] += weight * p[0];
+                        cell[1] += weight * p[1];
+                        cell[2] += weight * p[2];
+                        cell[3] += weight;
+                    }
+                }
+            }
+        }
+
+        // blur range, x and y, gaussian of one cell
+        for (int row = 0; row < rows; row++)
+            for (int x = 0; x < gw; x++)
+            {
+                const size_t offset = (size_t)row * row_floats + (size_t)x * gd * 4;
+                grid_blur(grid.data() + offset, temp.data() + offset, gd, 4, 4);
+            }
+        for (int row = 0; row < rows; row++)
+            grid_blur(temp.data() + (size_t)row * row_floats, grid.data() + (size_t)row * row_floats, gw, (size_t)gd * 4, gd * 4);
+        grid_blur(grid.data(), temp.data(), rows, row_floats, (int)row_floats);
+
+        // slice image rows whose grid row is inside band
+        const int y_begin = std::max((int)ceilf(j0 * ss), 0);
+        const int y_end = b == bands - 1 ? h : std::min((int)ceilf((j1 + 1) * ss), h);
+        for (int y = y_begin; y < y_end; y++)
+        {
+            const float fy = y / ss - base;
+            const int iy = std::min((int)fy, rows - 2);
+            const float wy = fy - iy;
+            load_row(src, in_map, y, 0, w, line.data());
+            for (int x = 0; x < w; x++)
+            {
+                float* p = line.data() + (size_t)x * 4;
+                const float fx = x / ss + GRID_PAD;
+                const float fz = std::min(std::max(p[0] + p[1] + p[2], 0.f), 3.f) / sr + GRID_PAD;
+                const int ix = (int)fx, iz = (int)fz;
+                const float wx = fx - ix, wz = fz - iz;
+                float sum[4] = {0, 0, 0, 0};
+                for (int cy = 0; cy < 2; cy++)
+                for (int cx = 0; cx < 2; cx++)
+                for (int cz = 0; cz < 2; cz++)
+                {
+                    const float weight = (cy ? wy : 1.f - wy) * (cx ? wx : 1.f - wx) * (cz ? wz : 1.f - wz);
+                    const float* cell = temp.data() + (size_t)(iy + cy) * row_floats + ((size_t)(ix + cx) * gd + iz + cz) * 4;
+                    for (int k = 0; k < 4; k++) sum[k] += weight * cell[k];
+                }
+                if (sum[3] > 1e-6f)
+                {
+                    p[0] = sum[0] / sum[3];
+                    p[1] = sum[1] / sum[3];
+                    p[2] = sum[2] / sum[3];
+                }
+            }
+            store_row(dst, out_map, y, w, line.data());
+        }
+    }
+}
+
+bool Bilateral_cpu::filter(const ImMat& src, ImMat& dst, int ksz, float sigma_spatial, float sigma_color, int mode)
+{
+    if (src.empty() || src.device != IM_DD_CPU || !is_supported_type(src.type))
+        return false;
+    ImDataType type = is_supported_type(dst.type) ? dst.type : src.type;
+    dst.create_type(src.w, src.h, 4, type);
+    if (dst.empty())
+        return false;
+
+    int in_map[4], out_map[4];
+    color_format_mapping(src.color_format, in_map);
+    color_format_mapping(dst.color_format, out_map);
+    ksz = std::max(ksz, 1);
+    sigma_spatial = std::max(sigma_spatial, 1e-3f);
+    sigma_color = std::max(sigma_color, 1e-3f);
+    if (mode == BILATERAL_GRID && 3.f / sigma_color <= GRID_MAX_DEPTH)
+        bilateral_grid(src, dst, in_map, out_map, ksz, sigma_spatial, sigma_color);
+    else
+        bilateral_exact(src, dst, in_map, out_map, ksz, sigma_spatial, sigma_color);
+    return true;
+}
+} // namespace ImGui
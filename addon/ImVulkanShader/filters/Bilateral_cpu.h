@@ -0,0 +1,33 @@
+#pragma once
+#include "immat.h"
+#include "imvk_platform.h"
+
+namespace ImGui
+{
+enum BilateralMode : int32_t
+{
+    BILATERAL_EXACT = 0,
+    BILATERAL_GRID,
+};
+
+// CPU bilateral filter, used by Bilateral_vulkan when there is no vulkan device.
+//
+// Exact mode weights every pixel of the ksz disk by exp(-d^2 / 2 sigma_spatial^2) and by
+// exp(-n^2 / 2 sigma_color^2), n is L1 distance of rgb, as the reference shader formula. Unlike the
+// shader, the window is cut to a radius of 4 sigma_spatial when ksz is larger: those taps weight
+// less than exp(-8) of the center tap, so output moves by a fraction of that share. Rows are
+// filtered in tiles, 8 pixels at once with AVX2.
+//
+// Grid mode is bilateral grid of Chen/Paris/Durand, colors are splatted into a grid sampled at
+// sigma_spatial in x/y and sigma_color in r+g+b, the grid is blurred and sliced. Its cost does not
+// depend on ksz, but range distance is of r+g+b instead of L1 rgb, so color edges of equal
+// brightness are smoothed, colored frames are far from exact output. Grid is only used when asked
+// for, and falls back to exact when sigma_color is too small for the grid depth.
+//
+// Output is 4 channels of dst.type with source alpha.
+class VKSHADER_API Bilateral_cpu
+{
+public:
+    static bool filter(const ImMat& src, ImMat& dst, int ksz, float sigma_spatial, float sigma_color, int mode = BILATERAL_EXACT);
+};
+} // namespace ImGui
@@ -1,6 +1,7 @@
 #define BILATERAL_DEFECT
 #include "Bilateral_vulkan.h"
 #include "Bilateral_shader.h"
+#include "Bilateral_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
@@ -8,6 +9,7 @@ namespace ImGui
 Bilateral_vulkan::Bilateral_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev) return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -74,10 +76,26 @@ void Bilateral_vulkan::upload_param(const VkMat& src, VkMat& dst, int ksz, float
     cmd->record_pipeline(pipe, bindings, constants, dst);
 }
 
-double Bilateral_vulkan::filter(const ImMat& src, ImMat& dst, int ksz, float sigma_spatial, float sigma_color)
+double Bilateral_vulkan::filter(const ImMat& src, ImMat& dst, int ksz, float sigma_spatial, float sigma_color, int mode)
 {
     double ret = 0.0;
-    if (!vkdev || !pipe || !cmd)
+    if (!vkdev)
+    {
+        // no vulkan device, bilateral on cpu, exact unless caller asks for bilateral grid
+        if (src.device != IM_DD_CPU)
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Bilateral_cpu::filter(src, dst, ksz, sigma_spatial, sigma_color, mode))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst.copy_attribute(src);
+        return ret;
+    }
+    if (!pipe || !cmd)
     {
         return ret;
     }
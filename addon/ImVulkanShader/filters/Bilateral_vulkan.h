@@ -2,6 +2,7 @@
 #include "imvk_gpu.h"
 #include "imvk_pipeline.h"
 #include "immat.h"
+#include "Bilateral_cpu.h"
 
 namespace ImGui 
 {
@@ -11,7 +12,8 @@ public:
     Bilateral_vulkan(int gpu = -1);
     ~Bilateral_vulkan();
 
-    double filter(const ImMat& src, ImMat& dst, int ksz, float sigma_spatial, float sigma_color);
+    // mode is used by cpu backend without vulkan device, see Bilateral_cpu, shader is always exact
+    double filter(const ImMat& src, ImMat& dst, int ksz, float sigma_spatial, float sigma_color, int mode = BILATERAL_EXACT);
 
 public:
     const VulkanDevice* vkdev {nullptr};
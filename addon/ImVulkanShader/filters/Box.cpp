@@ -1,4 +1,5 @@
 #include "Box.h"
+#include "Box_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
@@ -33,6 +34,9 @@ void BoxBlur_vulkan::prepare_kernel()
         }
 
     }
+    kvalue = kvulve;
+    if (!vkdev)
+        return;
     VkTransfer tran(vkdev);
     tran.record_upload(kernel, vk_kernel, opt, false);
     tran.submit_and_wait();
@@ -47,4 +51,25 @@ void BoxBlur_vulkan::SetParam(int _xSize, int _ySize)
         prepare_kernel();
     }
 }
+
+double BoxBlur_vulkan::filter(const ImMat& src, ImMat& dst) const
+{
+    double ret = 0.0;
+    if (vkdev)
+        return Filter2DS_vulkan::filter(src, dst);
+
+    // no vulkan device, box blur on cpu with running sums, cost does not grow with box size
+    if (src.device != IM_DD_CPU)
+        return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+    double start = GetSysCurrentTime();
+#endif
+    if (!Box_cpu::Blur(src, dst, xSize, ySize, kvalue))
+        return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+    ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+    dst.copy_attribute(src);
+    return ret;
+}
 } // namespace ImGui
\ No newline at end of file
@@ -11,10 +11,12 @@ public:
     BoxBlur_vulkan(int gpu = 0);
     ~BoxBlur_vulkan();
     void SetParam(int _xSize, int _ySize);
+    double filter(const ImMat& src, ImMat& dst) const override;
 
 private:
     int xSize {3};
     int ySize {3};
+    float kvalue {1.0f / 3.0f};
     void prepare_kernel();
 };
 } // namespace ImGui
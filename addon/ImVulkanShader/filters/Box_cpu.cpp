@@ -0,0 +1,299 @@
+#include "Box_cpu.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+// Pixels of one column strip, the column pass is vectorized across STRIP_PIXELS * 4 floats
+#define STRIP_PIXELS 32
+
+namespace ImGui
+{
+// same as shader color_format_mapping_vec4, 3 channels formats keep rgb order of their own
+static inline void color_format_mapping(ImColorFormat format, int map[4])
+{
+    switch (format)
+    {
+        case IM_CF_ABGR: case IM_CF_BGR: map[0] = 0; map[1] = 1; map[2] = 2; map[3] = 3; break;
+        case IM_CF_ARGB: case IM_CF_RGB: map[0] = 2; map[1] = 1; map[2] = 0; map[3] = 3; break;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; map[3] = 0; break;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; map[3] = 0; break;
+        default: map[0] = map[1] = map[2] = map[3] = 0; break;
+    }
+}
+
+static inline bool is_supported_type(ImDataType type)
+{
+    return type == IM_DT_INT8 || type == IM_DT_INT16 || type == IM_DT_INT16_BE || type == IM_DT_FLOAT16 || type == IM_DT_FLOAT32;
+}
+
+template<typename T, typename F>
+static inline void load_pixels(const ImMat& src, const int map[4], int y, int x0, int n, float* rgba, F cvt)
+{
+    const T* p = (const T *)src.data + ((size_t)y * src.w + x0) * src.c;
+    for (int i = 0; i < n; i++, p += src.c, rgba += 4)
+    {
+        for (int k = 0; k < 3; k++)
+            rgba[k] = cvt(p[map[k] < src.c ? map[k] : 0]);
+        rgba[3] = src.c == 4 ? cvt(p[map[3]]) : 1.f;
+    }
+}
+
+// n pixels of row y from x0 as r, g, b, a floats in 0..1
+static void load_row(const ImMat& src, const int map[4], int y, int x0, int n, float* rgba)
+{
+    switch (src.type)
+    {
+        case IM_DT_INT8: load_pixels<uint8_t>(src, map, y, x0, n, rgba, [](uint8_t v) { return (float)v / 255.f; }); break;
+        case IM_DT_INT16: load_pixels<uint16_t>(src, map, y, x0, n, rgba, [](uint16_t v) { return (float)v / 65535.f; }); break;
+        case IM_DT_INT16_BE: load_pixels<uint16_t>(src, map, y, x0, n, rgba, [](uint16_t v) { return (float)(uint16_t)((v << 8) | (v >> 8)) / 65535.f; }); break;
+        case IM_DT_FLOAT16: load_pixels<uint16_t>(src, map, y, x0, n, rgba, [](uint16_t v) { return im_float16_to_float32(v); }); break;
+        case IM_DT_FLOAT32: load_pixels<float>(src, map, y, x0, n, rgba, [](float v) { return v; }); break;
+        default: break;
+    }
+}
+
+// uint(floor(v * scale)) clamped to [0, scale], as shader store functions
+static inline uint32_t quantize(float v, float scale)
+{
+    return (uint32_t)std::min(std::max(floorf(v * scale), 0.f), scale);
+}
+
+static void store_row(ImMat& dst, const int map[4], int y, int x0, int n, const float* rgba)
+{
+    const size_t offset = ((size_t)y * dst.w + x0) * 4;
+    switch (dst.type)
+    {
+        case IM_DT_INT8:
+        {
+            uint8_t* o = (uint8_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = (uint8_t)quantize(rgba[k], 255.f);
+            break;
+        }
+        case IM_DT_INT16:
+        case IM_DT_INT16_BE:
+        {
+            const bool be = dst.type == IM_DT_INT16_BE;
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++)
+                {
+                    const uint16_t v = (uint16_t)quantize(rgba[k], 65535.f);
+                    o[map[k]] = be ? (uint16_t)((v << 8) | (v >> 8)) : v;
+                }
+            break;
+        }
+        case IM_DT_FLOAT16:
+        {
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = im_float32_to_float16(std::min(std::max(rgba[k], 0.f), 1.f));
+            break;
+        }
+        case IM_DT_FLOAT32:
+        {
+            float* o = (float *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = std::min(std::max(rgba[k], 0.f), 1.f);
+            break;
+        }
+        default: break;
+    }
+}
+
+// Lane kernels, a line item is n contiguous floats, 4 for a pixel of row pass and a strip row of
+// column pass.
+static inline void lane_add_sub(float* acc, const float* plus, const float* minus, int n)
+{
+    int i = 0;
+#if __AVX2__
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_sub_ps(_mm256_loadu_ps(plus + i), _mm256_loadu_ps(minus + i))));
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_sub_ps(_mm_loadu_ps(plus + i), _mm_loadu_ps(minus + i))));
+#elif __ARM_NEON && __aarch64__
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(acc + i, vaddq_f32(vld1q_f32(acc + i), vsubq_f32(vld1q_f32(plus + i), vld1q_f32(minus + i))));
+#endif
+    for (; i < n; i++)
+        acc[i] += plus[i] - minus[i];
+}
+
+static inline void lane_scale(float* out, const float* acc, float scale, int n)
+{
+    int i = 0;
+#if __AVX2__
+    const __m256 s8 = _mm256_set1_ps(scale);
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(acc + i), s8));
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(acc + i), _mm256_castps256_ps128(s8)));
+#elif __ARM_NEON && __aarch64__
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32(out + i, vmulq_n_f32(vld1q_f32(acc + i), scale));
+#endif
+    for (; i < n; i++)
+        out[i] = acc[i] * scale;
+}
+
+template<bool is_max>
+static inline void lane_minmax(float* out, const float* a, const float* b, int n)
+{
+    int i = 0;
+#if __AVX2__
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 va = _mm256_loadu_ps(a + i), vb = _mm256_loadu_ps(b + i);
+        _mm256_storeu_ps(out + i, is_max ? _mm256_max_ps(va, vb) : _mm256_min_ps(va, vb));
+    }
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128 va = _mm_loadu_ps(a + i), vb = _mm_loadu_ps(b + i);
+        _mm_storeu_ps(out + i, is_max ? _mm_max_ps(va, vb) : _mm_min_ps(va, vb));
+    }
+#elif __ARM_NEON && __aarch64__
+    for (; i + 4 <= n; i += 4)
+    {
+        const float32x4_t va = vld1q_f32(a + i), vb = vld1q_f32(b + i);
+        vst1q_f32(out + i, is_max ? vmaxq_f32(va, vb) : vminq_f32(va, vb));
+    }
+#endif
+    for (; i < n; i++)
+        out[i] = is_max ? std::max(a[i], b[i]) : std::min(a[i], b[i]);
+}
+
+// A line has count items of lanes floats, item i at in + i * stride. Window of item i is
+// [i - lo, i - lo + ksz - 1] with index clamped into line, emit(i, result) gets every item.
+template<typename Emit>
+static void box_line(const float* in, int count, size_t stride, int lanes, int ksz, float weight, float* acc, float* out, Emit emit)
+{
+    const int lo = ksz / 2, hi = ksz - 1 - lo;
+    auto item = [&](int i) { return in + (size_t)std::min(std::max(i, 0), count - 1) * stride; };
+    std::fill(acc, acc + lanes, 0.f);
+    for (int j = -lo; j <= hi; j++)
+    {
+        const float* p = item(j);
+        for (int k = 0; k < lanes; k++) acc[k] += p[k];
+    }
+    for (int i = 0; i < count; i++)
+    {
+        lane_scale(out, acc, weight, lanes);
+        emit(i, out);
+        lane_add_sub(acc, item(i + hi + 1), item(i - lo), lanes);
+    }
+}
+
+// van Herk/Gil-Werman, line is padded by lo items before and ksz - 1 - lo after, padded line is
+// cut into blocks of ksz, g is min/max from block start and h is min/max to block end. Window of
+// item i is padded [i, i + ksz - 1], it covers tail of one block and head of next, so result is
+// op(h[i], g[i + ksz - 1]), 3 ops per item for any ksz.
+template<bool is_max, typename Emit>
+static void minmax_line(const float* in, int count, size_t stride, int lanes, int ksz, float* g, float* h, float* out, Emit emit)
+{
+    const int lo = ksz / 2;
+    const int padded = count + ksz - 1;
+    auto item = [&](int p) { return in + (size_t)std::min(std::max(p - lo, 0), count - 1) * stride; };
+    for (int p = 0; p < padded; p++)
+    {
+        float* gp = g + (size_t)p * lanes;
+        if (p % ksz == 0)
+            std::copy(item(p), item(p) + lanes, gp);
+        else
+            lane_minmax<is_max>(gp, gp - lanes, item(p), lanes);
+    }
+    for (int p = padded - 1; p >= 0; p--)
+    {
+        float* hp = h + (size_t)p * lanes;
+        if ((p + 1) % ksz == 0 || p == padded - 1)
+            std::copy(item(p), item(p) + lanes, hp);
+        else
+            lane_minmax<is_max>(hp, hp + lanes, item(p), lanes);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        lane_minmax<is_max>(out, h + (size_t)i * lanes, g + (size_t)(i + ksz - 1) * lanes, lanes);
+        emit(i, out);
+    }
+}
+
+enum { BOX_BLUR, BOX_EROSION, BOX_DILATION };
+
+// scratch holds lanes * (2 * (count + ksz) + 1) floats
+template<int op, typename Emit>
+static inline void filter_line(const float* in, int count, size_t stride, int lanes, int ksz, float weight, float* scratch, Emit emit)
+{
+    const size_t padded = (size_t)(count + ksz - 1) * lanes;
+    if (op == BOX_BLUR)
+        box_line(in, count, stride, lanes, ksz, weight, scratch, scratch + lanes, emit);
+    else if (op == BOX_EROSION)
+        minmax_line<false>(in, count, stride, lanes, ksz, scratch, scratch + padded, scratch + 2 * padded, emit);
+    else
+        minmax_line<true>(in, count, stride, lanes, ksz, scratch, scratch + padded, scratch + 2 * padded, emit);
+}
+
+// Row pass from src into float rgba buffer, then column pass on strips from buffer into dst.
+template<int op>
+static bool box_filter(const ImMat& src, ImMat& dst, int xsize, int ysize, float weight)
+{
+    if (src.empty() || src.device != IM_DD_CPU || !is_supported_type(src.type))
+        return false;
+    const int w = src.w, h = src.h;
+    ImDataType type = is_supported_type(dst.type) ? dst.type : src.type;
+    dst.create_type(w, h, 4, type);
+    if (dst.empty())
+        return false;
+
+    int in_map[4], out_map[4];
+    color_format_mapping(src.color_format, in_map);
+    color_format_mapping(dst.color_format, out_map);
+    std::vector<float> buffer((size_t)w * h * 4);
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < h; y++)
+    {
+        std::vector<float> scratch((size_t)(w + 2 * (w + xsize) + 1) * 4);
+        float* row = scratch.data();
+        float* out = buffer.data() + (size_t)y * w * 4;
+        load_row(src, in_map, y, 0, w, row);
+        filter_line<op>(row, w, 4, 4, xsize, weight, row + (size_t)w * 4, [out](int i, const float* v) {
+            std::copy(v, v + 4, out + (size_t)i * 4);
+        });
+    }
+
+    const int strips = (w + STRIP_PIXELS - 1) / STRIP_PIXELS;
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int s = 0; s < strips; s++)
+    {
+        const int x0 = s * STRIP_PIXELS;
+        const int n = std::min(STRIP_PIXELS, w - x0);
+        const int lanes = n * 4;
+        std::vector<float> scratch((size_t)(2 * (h + ysize) + 1) * lanes);
+        float alpha[STRIP_PIXELS * 4];
+        filter_line<op>(buffer.data() + (size_t)x0 * 4, h, (size_t)w * 4, lanes, ysize, weight, scratch.data(), [&](int y, float* v) {
+            if (op == BOX_BLUR)
+            {
+                // blur keeps source alpha, like shader
+                load_row(src, in_map, y, x0, n, alpha);
+                for (int i = 0; i < n; i++) v[i * 4 + 3] = alpha[i * 4 + 3];
+            }
+            store_row(dst, out_map, y, x0, n, v);
+        });
+    }
+    return true;
+}
+
+bool Box_cpu::Blur(const ImMat& src, ImMat& dst, int xsize, int ysize, float weight)
+{
+    return box_filter<BOX_BLUR>(src, dst, std::max(xsize, 1), std::max(ysize, 1), weight);
+}
+
+bool Box_cpu::Erosion(const ImMat& src, ImMat& dst, int ksz)
+{
+    return box_filter<BOX_EROSION>(src, dst, std::max(ksz, 1), std::max(ksz, 1), 1.f);
+}
+
+bool Box_cpu::Dilation(const ImMat& src, ImMat& dst, int ksz)
+{
+    return box_filter<BOX_DILATION>(src, dst, std::max(ksz, 1), std::max(ksz, 1), 1.f);
+}
+} // namespace ImGui
@@ -0,0 +1,23 @@
+#pragma once
+#include "immat.h"
+#include "imvk_platform.h"
+
+namespace ImGui
+{
+// CPU implementation of box blur, erosion and dilation, used by BoxBlur_vulkan, Erosion_vulkan and
+// Dilation_vulkan when there is no vulkan device. Cost per pixel does not depend on window size,
+// blur is a running sum and erosion/dilation are van Herk/Gil-Werman block min/max.
+//
+// Both passes are separable. Rows are filtered in parallel, then the column pass runs on strips of
+// columns in parallel, vectorized across the strip. Window of ksz starts at -ksz / 2 and borders are
+// clamped, like shaders. Output is 4 channels of dst.type.
+class VKSHADER_API Box_cpu
+{
+public:
+    // every pass sums its window and scales sum by weight, alpha is kept from source
+    static bool Blur(const ImMat& src, ImMat& dst, int xsize, int ysize, float weight);
+    // minimum/maximum of ksz x ksz window on all 4 channels
+    static bool Erosion(const ImMat& src, ImMat& dst, int ksz);
+    static bool Dilation(const ImMat& src, ImMat& dst, int ksz);
+};
+} // namespace ImGui
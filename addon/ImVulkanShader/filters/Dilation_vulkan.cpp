@@ -1,5 +1,6 @@
 #include "Dilation_vulkan.h"
 #include "Dilation_shader.h"
+#include "Box_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
@@ -7,6 +8,7 @@ namespace ImGui
 Dilation_vulkan::Dilation_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev) return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -69,7 +71,23 @@ void Dilation_vulkan::upload_param(const VkMat& src, VkMat& dst, int ksz)
 double Dilation_vulkan::filter(const ImMat& src, ImMat& dst, int ksz)
 {
     double ret = 0.0;
-    if (!vkdev || !pipe || !cmd)
+    if (!vkdev)
+    {
+        // no vulkan device, dilation on cpu
+        if (src.device != IM_DD_CPU)
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Box_cpu::Dilation(src, dst, ksz))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst.copy_attribute(src);
+        return ret;
+    }
+    if (!pipe || !cmd)
     {
         return ret;
     }
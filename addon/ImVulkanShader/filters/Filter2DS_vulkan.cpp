@@ -7,6 +7,7 @@ namespace ImGui
 Filter2DS_vulkan::Filter2DS_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev) return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -9,9 +9,10 @@ class VKSHADER_API Filter2DS_vulkan
 {
 public:
     Filter2DS_vulkan(int gpu = -1);
-    ~Filter2DS_vulkan();
+    virtual ~Filter2DS_vulkan();
 
-    double filter(const ImMat& src, ImMat& dst) const;
+    // virtual so kernels with their own cpu path (BoxBlur_vulkan) are used through a base pointer too
+    virtual double filter(const ImMat& src, ImMat& dst) const;
 
 public:
     ImMat kernel;
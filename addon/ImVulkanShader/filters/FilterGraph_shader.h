@@ -0,0 +1,76 @@
+#pragma once
+#include <imvk_mat_shader.h>
+
+// Fused point filters shader is generated by FilterGraph_vulkan from the parts below, push constants
+// are SHADER_PARAM_BEGIN, one float v<n> for every fused filter and SHADER_PARAM_END.
+#define SHADER_PARAM_BEGIN \
+" \n\
+layout (push_constant) uniform parameter \n\
+{ \n\
+    int w; \n\
+    int h; \n\
+    int cstep; \n\
+    int in_format; \n\
+    int in_type; \n\
+    \n\
+    int out_w; \n\
+    int out_h; \n\
+    int out_cstep; \n\
+    int out_format; \n\
+    int out_type; \n\
+    \n\
+"
+
+#define SHADER_PARAM_END \
+"} p; \
+"
+
+#define SHADER_POINT_FUNCTIONS \
+" \n\
+const sfpvec3 kLuminance   = sfpvec3(sfp(0.2125f), sfp(0.7154f), sfp(0.0721f)); \n\
+const sfpvec3 kRGBToYPrime = sfpvec3(sfp(0.299f), sfp(0.587f), sfp(0.114f)); \n\
+const sfpvec3 kRGBToI      = sfpvec3(sfp(0.595716f), sfp(-0.274453f), sfp(-0.321263f)); \n\
+const sfpvec3 kRGBToQ      = sfpvec3(sfp(0.211456f), sfp(-0.522591f), sfp(0.31135f)); \n\
+const sfpvec3 kYIQToR      = sfpvec3(sfp(1.0f), sfp(0.9563f), sfp(0.6210f)); \n\
+const sfpvec3 kYIQToG      = sfpvec3(sfp(1.0f), sfp(-0.2721f), sfp(-0.6474f)); \n\
+const sfpvec3 kYIQToB      = sfpvec3(sfp(1.0f), sfp(-1.1070f), sfp(1.7046f)); \n\
+sfpvec3 hue(sfpvec3 color, sfp angle) \n\
+{ \n\
+    sfp   YPrime    = dot(color, kRGBToYPrime); \n\
+    sfp   I         = dot(color, kRGBToI); \n\
+    sfp   Q         = dot(color, kRGBToQ); \n\
+    sfp   hue       = atan (Q, I) - angle; \n\
+    sfp   chroma    = sqrt (I * I + Q * Q); \n\
+    sfpvec3 yIQ     = sfpvec3 (YPrime, chroma * cos (hue), chroma * sin (hue)); \n\
+    return sfpvec3(dot(yIQ, kYIQToR), dot(yIQ, kYIQToG), dot(yIQ, kYIQToB)); \n\
+} \n\
+"
+
+#define SHADER_MAIN_BEGIN \
+" \n\
+void main() \n\
+{ \n\
+    int gx = int(gl_GlobalInvocationID.x); \n\
+    int gy = int(gl_GlobalInvocationID.y); \n\
+    if (gx >= p.out_w || gy >= p.out_h) \n\
+        return; \n\
+    sfpvec4 color = load_rgba(gx, gy, p.w, p.h, p.cstep, p.in_format, p.in_type); \n\
+    sfpvec3 result = color.rgb; \n\
+"
+
+#define SHADER_MAIN_END \
+"    store_rgba(sfpvec4(result, color.a), gx, gy, p.out_w, p.out_h, p.out_cstep, p.out_format, p.out_type); \n\
+} \
+"
+
+// statement of every FilterGraphOp, %d is index of its float in push constants, same math as
+// Brightness, Contrast, Gamma, Exposure, Saturation, Hue and ColorInvert shaders
+static const char* const Filter_op_code[] = {
+"    result = clamp(result + sfpvec3(sfp(p.v%d)), sfpvec3(0.f), sfpvec3(1.0f)); \n",
+"    result = clamp((result - sfpvec3(0.5f)) * sfp(p.v%d) + sfpvec3(0.5f), sfpvec3(0.f), sfpvec3(1.0f)); \n",
+"    result = clamp(pow(result, sfpvec3(sfp(p.v%d))), sfpvec3(0.f), sfpvec3(1.0f)); \n",
+"    result = clamp(result * pow(sfp(2.0f), sfp(p.v%d)), sfpvec3(0.f), sfpvec3(1.0f)); \n",
+"    result = clamp(mix(sfpvec3(dot(result, kLuminance)), result, sfp(p.v%d)), sfpvec3(0.f), sfpvec3(1.0f)); \n",
+"    result = clamp(hue(result, sfp(p.v%d)), sfpvec3(0.f), sfpvec3(1.0f)); \n",
+"    result = sfp(1.f) - result; \n",
+};
@@ -0,0 +1,461 @@
+#include "FilterGraph_vulkan.h"
+#include "FilterGraph_shader.h"
+#include "ImVulkanShader.h"
+#include <math.h>
+#include <algorithm>
+
+namespace ImGui
+{
+// same as shader color_format_mapping_vec4, 3 channels formats keep rgb order of their own
+static inline void color_format_mapping(ImColorFormat format, int map[4])
+{
+    switch (format)
+    {
+        case IM_CF_ABGR: case IM_CF_BGR: map[0] = 0; map[1] = 1; map[2] = 2; map[3] = 3; break;
+        case IM_CF_ARGB: case IM_CF_RGB: map[0] = 2; map[1] = 1; map[2] = 0; map[3] = 3; break;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; map[3] = 0; break;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; map[3] = 0; break;
+        default: map[0] = map[1] = map[2] = map[3] = 0; break;
+    }
+}
+
+static inline bool is_supported_type(ImDataType type)
+{
+    return type == IM_DT_INT8 || type == IM_DT_INT16 || type == IM_DT_INT16_BE || type == IM_DT_FLOAT16 || type == IM_DT_FLOAT32;
+}
+
+template<typename T, typename F>
+static inline void load_pixels(const ImMat& src, const int map[4], int y, int n, float* rgba, F cvt)
+{
+    const T* p = (const T *)src.data + (size_t)y * src.w * src.c;
+    for (int i = 0; i < n; i++, p += src.c, rgba += 4)
+    {
+        for (int k = 0; k < 3; k++)
+            rgba[k] = cvt(p[map[k] < src.c ? map[k] : 0]);
+        rgba[3] = src.c == 4 ? cvt(p[map[3]]) : 1.f;
+    }
+}
+
+// row y as r, g, b, a floats in 0..1
+static void load_row(const ImMat& src, const int map[4], int y, float* rgba)
+{
+    switch (src.type)
+    {
+        case IM_DT_INT8: load_pixels<uint8_t>(src, map, y, src.w, rgba, [](uint8_t v) { return (float)v / 255.f; }); break;
+        case IM_DT_INT16: load_pixels<uint16_t>(src, map, y, src.w, rgba, [](uint16_t v) { return (float)v / 65535.f; }); break;
+        case IM_DT_INT16_BE: load_pixels<uint16_t>(src, map, y, src.w, rgba, [](uint16_t v) { return (float)(uint16_t)((v << 8) | (v >> 8)) / 65535.f; }); break;
+        case IM_DT_FLOAT16: load_pixels<uint16_t>(src, map, y, src.w, rgba, [](uint16_t v) { return im_float16_to_float32(v); }); break;
+        case IM_DT_FLOAT32: load_pixels<float>(src, map, y, src.w, rgba, [](float v) { return v; }); break;
+        default: break;
+    }
+}
+
+// uint(floor(v * scale)) clamped to [0, scale], as shader store functions
+static inline uint32_t quantize(float v, float scale)
+{
+    return (uint32_t)std::min(std::max(floorf(v * scale), 0.f), scale);
+}
+
+static void store_row(ImMat& dst, const int map[4], int y, const float* rgba)
+{
+    const size_t offset = (size_t)y * dst.w * 4;
+    const int n = dst.w;
+    switch (dst.type)
+    {
+        case IM_DT_INT8:
+        {
+            uint8_t* o = (uint8_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = (uint8_t)quantize(rgba[k], 255.f);
+            break;
+        }
+        case IM_DT_INT16:
+        case IM_DT_INT16_BE:
+        {
+            const bool be = dst.type == IM_DT_INT16_BE;
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++)
+                {
+                    const uint16_t v = (uint16_t)quantize(rgba[k], 65535.f);
+                    o[map[k]] = be ? (uint16_t)((v << 8) | (v >> 8)) : v;
+                }
+            break;
+        }
+        case IM_DT_FLOAT16:
+        {
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = im_float32_to_float16(std::min(std::max(rgba[k], 0.f), 1.f));
+            break;
+        }
+        case IM_DT_FLOAT32:
+        {
+            float* o = (float *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4, rgba += 4)
+                for (int k = 0; k < 4; k++) o[map[k]] = std::min(std::max(rgba[k], 0.f), 1.f);
+            break;
+        }
+        default: break;
+    }
+}
+
+static inline float clamp01(float v)
+{
+    return std::min(std::max(v, 0.f), 1.f);
+}
+
+// hue value in degrees as Hue_vulkan, shader takes radians
+static inline float hue_angle(float hue)
+{
+    return fmodf(hue, 360.0f) * (float)M_PI / 180.0f;
+}
+
+// one op on rgb of n rgba pixels
+static void apply_op_row(int op, float value, float* rgba, int n)
+{
+    switch (op)
+    {
+        case FILTER_OP_BRIGHTNESS:
+            for (int i = 0; i < n; i++, rgba += 4)
+                for (int k = 0; k < 3; k++) rgba[k] = clamp01(rgba[k] + value);
+            break;
+        case FILTER_OP_CONTRAST:
+            for (int i = 0; i < n; i++, rgba += 4)
+                for (int k = 0; k < 3; k++) rgba[k] = clamp01((rgba[k] - 0.5f) * value + 0.5f);
+            break;
+        case FILTER_OP_GAMMA:
+            for (int i = 0; i < n; i++, rgba += 4)
+                for (int k = 0; k < 3; k++) rgba[k] = clamp01(powf(rgba[k], value));
+            break;
+        case FILTER_OP_EXPOSURE:
+        {
+            const float scale = powf(2.f, value);
+            for (int i = 0; i < n; i++, rgba += 4)
+                for (int k = 0; k < 3; k++) rgba[k] = clamp01(rgba[k] * scale);
+            break;
+        }
+        case FILTER_OP_SATURATION:
+            for (int i = 0; i < n; i++, rgba += 4)
+            {
+                const float luminance = rgba[0] * 0.2125f + rgba[1] * 0.7154f + rgba[2] * 0.0721f;
+                for (int k = 0; k < 3; k++) rgba[k] = clamp01(luminance + (rgba[k] - luminance) * value);
+            }
+            break;
+        case FILTER_OP_HUE:
+        {
+            // rotating chroma of YIQ by -angle, same as atan/sin/cos of shader
+            const float angle = hue_angle(value);
+            const float ca = cosf(angle), sa = sinf(angle);
+            for (int i = 0; i < n; i++, rgba += 4)
+            {
+                const float r = rgba[0], g = rgba[1], b = rgba[2];
+                const float Y = r * 0.299f + g * 0.587f + b * 0.114f;
+                const float I = r * 0.595716f - g * 0.274453f - b * 0.321263f;
+                const float Q = r * 0.211456f - g * 0.522591f + b * 0.31135f;
+                const float i2 = I * ca + Q * sa;
+                const float q2 = Q * ca - I * sa;
+                rgba[0] = clamp01(Y + i2 * 0.9563f + q2 * 0.6210f);
+                rgba[1] = clamp01(Y - i2 * 0.2721f - q2 * 0.6474f);
+                rgba[2] = clamp01(Y - i2 * 1.1070f + q2 * 1.7046f);
+            }
+            break;
+        }
+        case FILTER_OP_COLOR_INVERT:
+            for (int i = 0; i < n; i++, rgba += 4)
+                for (int k = 0; k < 3; k++) rgba[k] = 1.f - rgba[k];
+            break;
+        default: break;
+    }
+}
+
+FilterGraph_vulkan::FilterGraph_vulkan(int gpu, int frames)
+{
+    vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
+#ifdef VULKAN_SHADER_FP16
+    opt.use_fp16_arithmetic = true;
+    opt.use_fp16_storage = true;
+#endif
+    // allocators are set by ring for every frame
+    ring = new VkComputeRing(vkdev, "FilterGraph", frames);
+}
+
+FilterGraph_vulkan::~FilterGraph_vulkan()
+{
+    if (vkdev)
+    {
+        if (ring) { delete ring; ring = nullptr; }
+        for (auto& it : pipelines) { if (it.second) delete it.second; }
+        pipelines.clear();
+    }
+}
+
+int FilterGraph_vulkan::add(FilterGraphOp op, float value)
+{
+    nodes.push_back({(int)op, value, FilterGraphStage()});
+    return (int)nodes.size() - 1;
+}
+
+int FilterGraph_vulkan::add_stage(const FilterGraphStage& stage)
+{
+    nodes.push_back({-1, 0.f, stage});
+    return (int)nodes.size() - 1;
+}
+
+void FilterGraph_vulkan::set_value(int node, float value)
+{
+    if (node >= 0 && node < (int)nodes.size())
+        nodes[node].value = value;
+}
+
+void FilterGraph_vulkan::clear()
+{
+    nodes.clear();
+}
+
+// pipeline of a run of point filters, compiled once for every sequence of ops
+const Pipeline* FilterGraph_vulkan::fused_pipeline(const std::string& key, const Node* run, int count) const
+{
+    auto it = pipelines.find(key);
+    if (it != pipelines.end())
+        return it->second;
+
+    std::string code = SHADER_HEADER SHADER_PARAM_BEGIN;
+    for (int i = 0; i < count; i++)
+        code += "    float v" + std::to_string(i) + "; \n";
+    code += SHADER_PARAM_END SHADER_INPUT_OUTPUT_DATA SHADER_LOAD_RGBA SHADER_STORE_RGBA SHADER_POINT_FUNCTIONS SHADER_MAIN_BEGIN;
+    for (int i = 0; i < count; i++)
+    {
+        char line[256];
+        snprintf(line, sizeof(line), Filter_op_code[run[i].op], i);
+        code += line;
+    }
+    code += SHADER_MAIN_END;
+
+    Pipeline* pipe = nullptr;
+    std::vector<vk_specialization_type> specializations(0);
+    std::vector<uint32_t> spirv_data;
+    if (compile_spirv_module(code.c_str(), opt, spirv_data) == 0)
+    {
+        pipe = new Pipeline(vkdev);
+        pipe->create(spirv_data.data(), spirv_data.size() * 4, specializations);
+    }
+    // failed compile is kept as well, it is not retried every frame
+    pipelines[key] = pipe;
+    return pipe;
+}
+
+void FilterGraph_vulkan::upload_param(VkCompute* cmd, const Pipeline* pipe, const VkMat& src, VkMat& dst, const Node* run, int count) const
+{
+    std::vector<VkMat> bindings(8);
+    if      (dst.type == IM_DT_INT8)     bindings[0] = dst;
+    else if (dst.type == IM_DT_INT16 || dst.type == IM_DT_INT16_BE)    bindings[1] = dst;
+    else if (dst.type == IM_DT_FLOAT16)  bindings[2] = dst;
+    else if (dst.type == IM_DT_FLOAT32)  bindings[3] = dst;
+
+    if      (src.type == IM_DT_INT8)     bindings[4] = src;
+    else if (src.type == IM_DT_INT16 || src.type == IM_DT_INT16_BE)    bindings[5] = src;
+    else if (src.type == IM_DT_FLOAT16)  bindings[6] = src;
+    else if (src.type == IM_DT_FLOAT32)  bindings[7] = src;
+    std::vector<vk_constant_type> constants(10 + count);
+    constants[0].i = src.w;
+    constants[1].i = src.h;
+    constants[2].i = src.c;
+    constants[3].i = src.color_format;
+    constants[4].i = src.type;
+    constants[5].i = dst.w;
+    constants[6].i = dst.h;
+    constants[7].i = dst.c;
+    constants[8].i = dst.color_format;
+    constants[9].i = dst.type;
+    for (int i = 0; i < count; i++)
+        constants[10 + i].f = run[i].op == FILTER_OP_HUE ? hue_angle(run[i].value) : run[i].value;
+    cmd->record_pipeline(pipe, bindings, constants, dst);
+}
+
+bool FilterGraph_vulkan::filter_cpu(const ImMat& src, ImMat& dst) const
+{
+    if (src.empty() || src.device != IM_DD_CPU || src.c < 3 || !is_supported_type(src.type))
+        return false;
+    for (auto& node : nodes)
+        if (node.op < 0)
+            return false;
+    const int w = src.w, h = src.h;
+    ImDataType type = is_supported_type(dst.type) ? dst.type : src.type;
+    dst.create_type(w, h, 4, type);
+    if (dst.empty())
+        return false;
+
+    // leading filters which work on every channel alone are one table for 8 bits source
+    size_t prefix = 0;
+    std::vector<float> table;
+    if (src.type == IM_DT_INT8)
+    {
+        while (prefix < nodes.size() && nodes[prefix].op != FILTER_OP_SATURATION && nodes[prefix].op != FILTER_OP_HUE)
+            prefix++;
+        table.resize(256 * 4);
+        for (int v = 0; v < 256; v++)
+            table[v * 4] = table[v * 4 + 1] = table[v * 4 + 2] = table[v * 4 + 3] = (float)v / 255.f;
+        for (size_t i = 0; i < prefix; i++)
+            apply_op_row(nodes[i].op, nodes[i].value, table.data(), 256);
+    }
+
+    int in_map[4], out_map[4];
+    color_format_mapping(src.color_format, in_map);
+    color_format_mapping(dst.color_format, out_map);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < h; y++)
+    {
+        std::vector<float> row((size_t)w * 4);
+        load_row(src, in_map, y, row.data());
+        if (prefix > 0)
+        {
+            for (size_t i = 0; i < (size_t)w * 4; i += 4)
+                for (int k = 0; k < 3; k++)
+                    row[i + k] = table[(int)(row[i + k] * 255.f + 0.5f) * 4];
+        }
+        for (size_t i = prefix; i < nodes.size(); i++)
+            apply_op_row(nodes[i].op, nodes[i].value, row.data(), w);
+        store_row(dst, out_map, y, row.data());
+    }
+    return true;
+}
+
+// runs of point filters and stages, an empty graph is one run without op, false when a run has
+// no pipeline
+bool FilterGraph_vulkan::build_segments(std::vector<Segment>& segments) const
+{
+    segments.clear();
+    if (!vkdev || !ring)
+        return false;
+    for (int i = 0; i < (int)nodes.size() || segments.empty();)
+    {
+        if (i < (int)nodes.size() && nodes[i].op < 0)
+        {
+            segments.push_back({i, 1, nullptr});
+            i++;
+            continue;
+        }
+        int j = i;
+        std::string key;
+        while (j < (int)nodes.size() && nodes[j].op >= 0 && j - i < FILTER_GRAPH_MAX_FUSED)
+            key += (char)('a' + nodes[j++].op);
+        const Pipeline* pipe = fused_pipeline(key, nodes.data() + i, j - i);
+        if (!pipe)
+            return false;
+        segments.push_back({i, j - i, pipe});
+        i = j;
+    }
+    return true;
+}
+
+uint64_t FilterGraph_vulkan::submit(const ImMat& src, ImMat& dst) const
+{
+    std::vector<Segment> segments;
+    if (!build_segments(segments))
+    {
+        // no vulkan device or fused shader, point filters on cpu
+        if (src.device == IM_DD_CPU && filter_cpu(src, dst))
+            dst.copy_attribute(src);
+        return 0;
+    }
+
+    Option frame_opt = opt;
+    VkCompute* cmd = ring->begin_frame(frame_opt);
+    if (!cmd)
+        return 0;
+
+    VkMat src_gpu;
+    if (src.device == IM_DD_VULKAN)
+    {
+        src_gpu = src;
+    }
+    else if (src.device == IM_DD_CPU)
+    {
+        cmd->record_clone(src, src_gpu, frame_opt);
+    }
+
+#ifdef VULKAN_SHADER_BENCHMARK
+    cmd->benchmark_stage("upload");
+    cmd->benchmark_start();
+#endif
+
+    // intermediates are released after submit, memory of frame allocators is not reused before
+    // the frame is complete
+    std::vector<VkMat> chain(1, src_gpu);
+    for (size_t s = 0; s < segments.size(); s++)
+    {
+        const Segment& segment = segments[s];
+        const VkMat& in = chain.back();
+        VkMat out;
+        if (!segment.pipe)
+        {
+            nodes[segment.start].stage(cmd, in, out, frame_opt);
+        }
+        else
+        {
+            ImDataType type = s + 1 == segments.size() ? dst.type : IM_DT_FLOAT32;
+            out.create_type(in.w, in.h, 4, type, frame_opt.blob_vkallocator);
+            upload_param(cmd, segment.pipe, in, out, nodes.data() + segment.start, segment.count);
+        }
+        chain.push_back(out);
+    }
+
+#ifdef VULKAN_SHADER_BENCHMARK
+    cmd->benchmark_end();
+    cmd->benchmark_stage("filter");
+#endif
+
+    // download
+    if (dst.device == IM_DD_CPU)
+        cmd->record_clone(chain.back(), dst, frame_opt);
+    else if (dst.device == IM_DD_VULKAN)
+        dst = chain.back();
+#ifdef VULKAN_SHADER_BENCHMARK
+    cmd->benchmark_stage("download");
+#endif
+    dst.copy_attribute(src);
+    return ring->submit();
+}
+
+int FilterGraph_vulkan::wait(uint64_t ticket) const
+{
+    if (!ticket || !ring)
+        return 0;
+    return ring->wait(ticket);
+}
+
+double FilterGraph_vulkan::filter(const ImMat& src, ImMat& dst) const
+{
+    double ret = 0.0;
+    std::vector<Segment> segments;
+    if (!build_segments(segments))
+    {
+        // no vulkan device or fused shader, point filters on cpu
+        if (src.device != IM_DD_CPU)
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!filter_cpu(src, dst))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst.copy_attribute(src);
+        return ret;
+    }
+
+    uint64_t ticket = submit(src, dst);
+    if (!ticket || ring->wait(ticket) != 0)
+        return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+    VkCompute* cmd = ring->get(ticket);
+    if (cmd)
+        ret = cmd->benchmark();
+#endif
+    return ret;
+}
+} // namespace ImGui
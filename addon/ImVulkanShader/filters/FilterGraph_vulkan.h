@@ -0,0 +1,93 @@
+#pragma once
+#include "imvk_gpu.h"
+#include "imvk_pipeline.h"
+#include "imvk_command.h"
+#include "immat.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Point filters fused into one dispatch, every fused filter takes one float of push constants
+#define FILTER_GRAPH_MAX_FUSED 16
+
+namespace ImGui
+{
+enum FilterGraphOp : int
+{
+    FILTER_OP_BRIGHTNESS = 0,
+    FILTER_OP_CONTRAST,
+    FILTER_OP_GAMMA,
+    FILTER_OP_EXPOSURE,
+    FILTER_OP_SATURATION,
+    FILTER_OP_HUE,
+    FILTER_OP_COLOR_INVERT,
+};
+
+// Records a filter which is not point-wise into the graph command buffer, src is on device and
+// stage creates dst with opt.blob_vkallocator, it must not submit or reset cmd.
+typedef std::function<void(VkCompute* cmd, const VkMat& src, VkMat& dst, const Option& opt)> FilterGraphStage;
+
+// Chain of filters applied by one command buffer with a single upload, download and submit.
+//
+// Consecutive point filters are fused into one generated shader, same math and clamping as
+// Brightness_vulkan, Contrast_vulkan, Gamma_vulkan, Exposure_vulkan, Saturation_vulkan, Hue_vulkan
+// and ColorInvert_vulkan applied one by one, except intermediate results keep float precision.
+// A fused shader is compiled once for every sequence of ops, values are push constants, so
+// set_value() does not compile anything. Stages between runs of point filters are recorded into
+// the same command buffer and intermediates stay on device.
+//
+// Frames are recorded into a ring of command buffers, submit() returns without waiting so the
+// caller keeps working while device runs the graph, and the next frame is recorded and uploaded
+// while the previous one still runs. filter() is submit() and wait().
+//
+// Generated shaders are not precompiled, they need glslang or spirv from shader cache. Without
+// vulkan device, or when fused shader fails to compile, point filters run on cpu for cpu source
+// and a graph with stages fails.
+class VKSHADER_API FilterGraph_vulkan
+{
+public:
+    FilterGraph_vulkan(int gpu = -1, int frames = 2);
+    ~FilterGraph_vulkan();
+
+    // returns node index for set_value()
+    int add(FilterGraphOp op, float value = 0.f);
+    int add_stage(const FilterGraphStage& stage);
+    void set_value(int node, float value);
+    void clear();
+    size_t size() const { return nodes.size(); }
+
+    double filter(const ImMat& src, ImMat& dst) const;
+    // dst is valid after wait(ticket), ticket is 0 when graph ran on cpu already or failed
+    uint64_t submit(const ImMat& src, ImMat& dst) const;
+    int wait(uint64_t ticket) const;
+
+public:
+    const VulkanDevice* vkdev {nullptr};
+    VkComputeRing * ring      {nullptr};
+    Option opt;
+
+private:
+    struct Node
+    {
+        int op;     // FilterGraphOp or -1 for stage
+        float value;
+        FilterGraphStage stage;
+    };
+    std::vector<Node> nodes;
+    mutable std::map<std::string, Pipeline*> pipelines;
+    // run of point filters with its pipeline, or a stage without pipeline
+    struct Segment
+    {
+        int start;
+        int count;
+        const Pipeline* pipe;
+    };
+
+private:
+    bool build_segments(std::vector<Segment>& segments) const;
+    const Pipeline* fused_pipeline(const std::string& key, const Node* run, int count) const;
+    void upload_param(VkCompute* cmd, const Pipeline* pipe, const VkMat& src, VkMat& dst, const Node* run, int count) const;
+    bool filter_cpu(const ImMat& src, ImMat& dst) const;
+};
+} // namespace ImGui
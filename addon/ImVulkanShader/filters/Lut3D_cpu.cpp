@@ -0,0 +1,385 @@
+#include "Lut3D_cpu.h"
+#include <math.h>
+#include <algorithm>
+
+// Number of pixels loaded, mapped and stored at once, fits on stack
+#define LUT_ROW_CHUNK 256
+
+namespace ImGui
+{
+// same as shader color_format_mapping_vec4, 3 channels formats keep rgb order of their own
+static inline void color_format_mapping(ImColorFormat format, int map[4])
+{
+    switch (format)
+    {
+        case IM_CF_ABGR: case IM_CF_BGR: map[0] = 0; map[1] = 1; map[2] = 2; map[3] = 3; break;
+        case IM_CF_ARGB: case IM_CF_RGB: map[0] = 2; map[1] = 1; map[2] = 0; map[3] = 3; break;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; map[3] = 0; break;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; map[3] = 0; break;
+        default: map[0] = map[1] = map[2] = map[3] = 0; break;
+    }
+}
+
+template<typename T, typename F>
+static inline void load_row(const ImMat& src, const int map[4], int y, int x0, int n, float* R, float* G, float* B, F cvt)
+{
+    const T* row = (const T *)src.data + ((size_t)y * src.w + x0) * src.c;
+    for (int i = 0; i < n; i++, row += src.c)
+    {
+        // lut index must stay inside table
+        R[i] = std::min(std::max(cvt(row[map[0]]), 0.f), 1.f);
+        G[i] = std::min(std::max(cvt(row[map[1]]), 0.f), 1.f);
+        B[i] = std::min(std::max(cvt(row[map[2]]), 0.f), 1.f);
+    }
+}
+
+static void load_rgb_row(const ImMat& src, const int map[4], int y, int x0, int n, float* R, float* G, float* B)
+{
+    switch (src.type)
+    {
+        case IM_DT_INT8: load_row<uint8_t>(src, map, y, x0, n, R, G, B, [](uint8_t v) { return (float)v / 255.f; }); break;
+        case IM_DT_INT16: load_row<uint16_t>(src, map, y, x0, n, R, G, B, [](uint16_t v) { return (float)v / 65535.f; }); break;
+        case IM_DT_INT16_BE: load_row<uint16_t>(src, map, y, x0, n, R, G, B, [](uint16_t v) { return (float)(uint16_t)((v << 8) | (v >> 8)) / 65535.f; }); break;
+        case IM_DT_FLOAT16: load_row<uint16_t>(src, map, y, x0, n, R, G, B, [](uint16_t v) { return im_float16_to_float32(v); }); break;
+        case IM_DT_FLOAT32: load_row<float>(src, map, y, x0, n, R, G, B, [](float v) { return v; }); break;
+        default: break;
+    }
+}
+
+// uint(floor(v * scale)) clamped to [0, scale], as shader store functions
+static inline uint32_t quantize(float v, float scale)
+{
+    return (uint32_t)std::min(std::max(floorf(v * scale), 0.f), scale);
+}
+
+static void store_rgb_row(ImMat& dst, const int map[4], int y, int x0, int n, const float* R, const float* G, const float* B)
+{
+    const size_t offset = ((size_t)y * dst.w + x0) * 4;
+    switch (dst.type)
+    {
+        case IM_DT_INT8:
+        {
+            uint8_t* o = (uint8_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4)
+            {
+                o[map[0]] = (uint8_t)quantize(R[i], 255.f);
+                o[map[1]] = (uint8_t)quantize(G[i], 255.f);
+                o[map[2]] = (uint8_t)quantize(B[i], 255.f);
+                o[map[3]] = 255;
+            }
+            break;
+        }
+        case IM_DT_INT16:
+        case IM_DT_INT16_BE:
+        {
+            const bool be = dst.type == IM_DT_INT16_BE;
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4)
+            {
+                uint16_t v[3] = {(uint16_t)quantize(R[i], 65535.f), (uint16_t)quantize(G[i], 65535.f), (uint16_t)quantize(B[i], 65535.f)};
+                for (int k = 0; k < 3; k++)
+                    o[map[k]] = be ? (uint16_t)((v[k] << 8) | (v[k] >> 8)) : v[k];
+                o[map[3]] = 0xFFFF;
+            }
+            break;
+        }
+        case IM_DT_FLOAT16:
+        {
+            uint16_t* o = (uint16_t *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4)
+            {
+                o[map[0]] = im_float32_to_float16(std::min(std::max(R[i], 0.f), 1.f));
+                o[map[1]] = im_float32_to_float16(std::min(std::max(G[i], 0.f), 1.f));
+                o[map[2]] = im_float32_to_float16(std::min(std::max(B[i], 0.f), 1.f));
+                o[map[3]] = im_float32_to_float16(1.f);
+            }
+            break;
+        }
+        case IM_DT_FLOAT32:
+        {
+            float* o = (float *)dst.data + offset;
+            for (int i = 0; i < n; i++, o += 4)
+            {
+                o[map[0]] = std::min(std::max(R[i], 0.f), 1.f);
+                o[map[1]] = std::min(std::max(G[i], 0.f), 1.f);
+                o[map[2]] = std::min(std::max(B[i], 0.f), 1.f);
+                o[map[3]] = 1.f;
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+static void interp_nearest_row(const float* table, int size, const float* R, const float* G, const float* B, float* oR, float* oG, float* oB, int n)
+{
+    const float s = (float)(size - 1);
+    for (int i = 0; i < n; i++)
+    {
+        const int offset = ((int)(R[i] * s + .5f) * size + (int)(G[i] * s + .5f)) * size + (int)(B[i] * s + .5f);
+        const float* c = table + offset * 4;
+        oR[i] = c[0];
+        oG[i] = c[1];
+        oB[i] = c[2];
+    }
+}
+
+#if __AVX2__
+// r, g, b of 8 lattice points, entries are 4 floats
+static inline void gather_rgb(const float* table, __m256i index, __m256& r, __m256& g, __m256& b)
+{
+    const __m256i offset = _mm256_slli_epi32(index, 2);
+    r = _mm256_i32gather_ps(table, offset, 4);
+    g = _mm256_i32gather_ps(table + 1, offset, 4);
+    b = _mm256_i32gather_ps(table + 2, offset, 4);
+}
+
+static inline __m256 lerp8(__m256 v0, __m256 v1, __m256 f)
+{
+    return _mm256_add_ps(v0, _mm256_mul_ps(_mm256_sub_ps(v1, v0), f));
+}
+
+// lattice cell of 8 pixels, scaled position, integer corner and step to next corner of every axis
+struct LatticeCell8
+{
+    __m256 dr, dg, db;
+    __m256i base, step_r, step_g, step_b;
+
+    LatticeCell8(const float* R, const float* G, const float* B, int size)
+    {
+        const __m256 s = _mm256_set1_ps((float)(size - 1));
+        const __m256i last = _mm256_set1_epi32(size - 1), one = _mm256_set1_epi32(1);
+        const __m256 r = _mm256_mul_ps(_mm256_loadu_ps(R), s);
+        const __m256 g = _mm256_mul_ps(_mm256_loadu_ps(G), s);
+        const __m256 b = _mm256_mul_ps(_mm256_loadu_ps(B), s);
+        const __m256i pr = _mm256_cvttps_epi32(r), pg = _mm256_cvttps_epi32(g), pb = _mm256_cvttps_epi32(b);
+        dr = _mm256_sub_ps(r, _mm256_cvtepi32_ps(pr));
+        dg = _mm256_sub_ps(g, _mm256_cvtepi32_ps(pg));
+        db = _mm256_sub_ps(b, _mm256_cvtepi32_ps(pb));
+        // step is 0 on the last lattice point, as shader clamps next to size - 1
+        const __m256i size1 = _mm256_set1_epi32(size), size2 = _mm256_set1_epi32(size * size);
+        base = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(pr, size2), _mm256_mullo_epi32(pg, size1)), pb);
+        step_r = _mm256_mullo_epi32(_mm256_sub_epi32(_mm256_min_epi32(_mm256_add_epi32(pr, one), last), pr), size2);
+        step_g = _mm256_mullo_epi32(_mm256_sub_epi32(_mm256_min_epi32(_mm256_add_epi32(pg, one), last), pg), size1);
+        step_b = _mm256_sub_epi32(_mm256_min_epi32(_mm256_add_epi32(pb, one), last), pb);
+    }
+};
+#endif
+
+static inline void lattice_cell(float v, int size, int& prev, int& step, float& d)
+{
+    const float s = v * (float)(size - 1);
+    prev = (int)s;
+    step = prev + 1 > size - 1 ? 0 : 1;
+    d = s - (float)prev;
+}
+
+static void interp_trilinear_row(const float* table, int size, const float* R, const float* G, const float* B, float* oR, float* oG, float* oB, int n)
+{
+    int i = 0;
+#if __AVX2__
+    for (; i + 8 <= n; i += 8)
+    {
+        LatticeCell8 cell(R + i, G + i, B + i, size);
+        const __m256i rg = _mm256_add_epi32(cell.step_r, cell.step_g);
+        const __m256i index[8] = {
+            cell.base,
+            _mm256_add_epi32(cell.base, cell.step_b),
+            _mm256_add_epi32(cell.base, cell.step_g),
+            _mm256_add_epi32(_mm256_add_epi32(cell.base, cell.step_g), cell.step_b),
+            _mm256_add_epi32(cell.base, cell.step_r),
+            _mm256_add_epi32(_mm256_add_epi32(cell.base, cell.step_r), cell.step_b),
+            _mm256_add_epi32(cell.base, rg),
+            _mm256_add_epi32(_mm256_add_epi32(cell.base, rg), cell.step_b),
+        };
+        __m256 c[8][3];
+        for (int k = 0; k < 8; k++)
+            gather_rgb(table, index[k], c[k][0], c[k][1], c[k][2]);
+        __m256 out[3];
+        for (int ch = 0; ch < 3; ch++)
+        {
+            const __m256 c00 = lerp8(c[0][ch], c[4][ch], cell.dr);
+            const __m256 c10 = lerp8(c[2][ch], c[6][ch], cell.dr);
+            const __m256 c01 = lerp8(c[1][ch], c[5][ch], cell.dr);
+            const __m256 c11 = lerp8(c[3][ch], c[7][ch], cell.dr);
+            const __m256 c0 = lerp8(c00, c10, cell.dg);
+            const __m256 c1 = lerp8(c01, c11, cell.dg);
+            out[ch] = lerp8(c0, c1, cell.db);
+        }
+        _mm256_storeu_ps(oR + i, out[0]);
+        _mm256_storeu_ps(oG + i, out[1]);
+        _mm256_storeu_ps(oB + i, out[2]);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        int pr, pg, pb, sr, sg, sb;
+        float dr, dg, db;
+        lattice_cell(R[i], size, pr, sr, dr);
+        lattice_cell(G[i], size, pg, sg, dg);
+        lattice_cell(B[i], size, pb, sb, db);
+        sr *= size * size;
+        sg *= size;
+        const int base = (pr * size + pg) * size + pb;
+        const float* c[8] = {
+            table + base * 4,                   table + (base + sb) * 4,
+            table + (base + sg) * 4,            table + (base + sg + sb) * 4,
+            table + (base + sr) * 4,            table + (base + sr + sb) * 4,
+            table + (base + sr + sg) * 4,       table + (base + sr + sg + sb) * 4,
+        };
+        float out[3];
+        for (int ch = 0; ch < 3; ch++)
+        {
+            const float c00 = c[0][ch] + (c[4][ch] - c[0][ch]) * dr;
+            const float c10 = c[2][ch] + (c[6][ch] - c[2][ch]) * dr;
+            const float c01 = c[1][ch] + (c[5][ch] - c[1][ch]) * dr;
+            const float c11 = c[3][ch] + (c[7][ch] - c[3][ch]) * dr;
+            const float c0 = c00 + (c10 - c00) * dg;
+            const float c1 = c01 + (c11 - c01) * dg;
+            out[ch] = c0 + (c1 - c0) * db;
+        }
+        oR[i] = out[0];
+        oG[i] = out[1];
+        oB[i] = out[2];
+    }
+}
+
+// The cell is split in 6 tetrahedrons by order of fractions. Walking from corner 000 to 111 along
+// axes in descending fraction order, x >= y >= z, the weights are 1 - x, x - y, y - z and z.
+// Ties pick the same tetrahedron as shader.
+static void interp_tetrahedral_row(const float* table, int size, const float* R, const float* G, const float* B, float* oR, float* oG, float* oB, int n)
+{
+    int i = 0;
+#if __AVX2__
+    for (; i + 8 <= n; i += 8)
+    {
+        LatticeCell8 cell(R + i, G + i, B + i, size);
+        const __m256 r_g = _mm256_cmp_ps(cell.dr, cell.dg, _CMP_GT_OQ);
+        const __m256 g_b = _mm256_cmp_ps(cell.dg, cell.db, _CMP_GT_OQ);
+        const __m256 r_b = _mm256_cmp_ps(cell.dr, cell.db, _CMP_GT_OQ);
+        const __m256 b_g = _mm256_cmp_ps(cell.db, cell.dg, _CMP_GT_OQ);
+        const __m256 b_r = _mm256_cmp_ps(cell.db, cell.dr, _CMP_GT_OQ);
+        // first axis is r, b or g, second axis follows shader branches
+        const __m256 first_r = _mm256_and_ps(r_g, _mm256_or_ps(g_b, r_b));
+        const __m256 first_b = _mm256_or_ps(_mm256_andnot_ps(_mm256_or_ps(g_b, r_b), r_g), _mm256_andnot_ps(r_g, b_g));
+        const __m256 second_g = _mm256_or_ps(_mm256_and_ps(r_g, g_b), _mm256_andnot_ps(r_g, b_g));
+        const __m256 second_b = _mm256_or_ps(_mm256_andnot_ps(g_b, _mm256_and_ps(r_g, r_b)), _mm256_andnot_ps(_mm256_or_ps(r_g, b_g), b_r));
+        #define SELECT3(r, g, b, is_r, is_b) _mm256_blendv_ps(_mm256_blendv_ps(g, b, is_b), r, is_r)
+        #define SELECT3I(r, g, b, is_r, is_b) _mm256_castps_si256(SELECT3(_mm256_castsi256_ps(r), _mm256_castsi256_ps(g), _mm256_castsi256_ps(b), is_r, is_b))
+        const __m256 second_r = _mm256_andnot_ps(_mm256_or_ps(second_g, second_b), _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+        const __m256 x = SELECT3(cell.dr, cell.dg, cell.db, first_r, first_b);
+        const __m256 y = SELECT3(cell.dr, cell.dg, cell.db, second_r, second_b);
+        // third fraction is the one left, sum of all minus first and second
+        const __m256 z = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(cell.dr, cell.dg), cell.db), _mm256_add_ps(x, y));
+        const __m256i step1 = SELECT3I(cell.step_r, cell.step_g, cell.step_b, first_r, first_b);
+        const __m256i step2 = SELECT3I(cell.step_r, cell.step_g, cell.step_b, second_r, second_b);
+        #undef SELECT3I
+        #undef SELECT3
+        const __m256i index1 = _mm256_add_epi32(cell.base, step1);
+        const __m256i index2 = _mm256_add_epi32(index1, step2);
+        const __m256i index3 = _mm256_add_epi32(_mm256_add_epi32(cell.base, cell.step_r), _mm256_add_epi32(cell.step_g, cell.step_b));
+        const __m256 w0 = _mm256_sub_ps(_mm256_set1_ps(1.f), x), w1 = _mm256_sub_ps(x, y), w2 = _mm256_sub_ps(y, z);
+        __m256 c0[3], c1[3], c2[3], c3[3];
+        gather_rgb(table, cell.base, c0[0], c0[1], c0[2]);
+        gather_rgb(table, index1, c1[0], c1[1], c1[2]);
+        gather_rgb(table, index2, c2[0], c2[1], c2[2]);
+        gather_rgb(table, index3, c3[0], c3[1], c3[2]);
+        __m256 out[3];
+        for (int ch = 0; ch < 3; ch++)
+            out[ch] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w0, c0[ch]), _mm256_mul_ps(w1, c1[ch])),
+                                    _mm256_add_ps(_mm256_mul_ps(w2, c2[ch]), _mm256_mul_ps(z, c3[ch])));
+        _mm256_storeu_ps(oR + i, out[0]);
+        _mm256_storeu_ps(oG + i, out[1]);
+        _mm256_storeu_ps(oB + i, out[2]);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        int pr, pg, pb, sr, sg, sb;
+        float dr, dg, db;
+        lattice_cell(R[i], size, pr, sr, dr);
+        lattice_cell(G[i], size, pg, sg, dg);
+        lattice_cell(B[i], size, pb, sb, db);
+        sr *= size * size;
+        sg *= size;
+        float x, y, z;
+        int step1, step2;
+        if (dr > dg)
+        {
+            if (dg > db)      { x = dr; y = dg; z = db; step1 = sr; step2 = sg; }
+            else if (dr > db) { x = dr; y = db; z = dg; step1 = sr; step2 = sb; }
+            else              { x = db; y = dr; z = dg; step1 = sb; step2 = sr; }
+        }
+        else
+        {
+            if (db > dg)      { x = db; y = dg; z = dr; step1 = sb; step2 = sg; }
+            else if (db > dr) { x = dg; y = db; z = dr; step1 = sg; step2 = sb; }
+            else              { x = dg; y = dr; z = db; step1 = sg; step2 = sr; }
+        }
+        const int base = (pr * size + pg) * size + pb;
+        const float* c0 = table + base * 4;
+        const float* c1 = table + (base + step1) * 4;
+        const float* c2 = table + (base + step1 + step2) * 4;
+        const float* c3 = table + (base + sr + sg + sb) * 4;
+        const float w0 = 1.f - x, w1 = x - y, w2 = y - z;
+        oR[i] = w0 * c0[0] + w1 * c1[0] + w2 * c2[0] + z * c3[0];
+        oG[i] = w0 * c0[1] + w1 * c1[1] + w2 * c2[1] + z * c3[1];
+        oB[i] = w0 * c0[2] + w1 * c1[2] + w2 * c2[2] + z * c3[2];
+    }
+}
+
+bool LUT3D_cpu::filter(const ImMat& src, ImMat& dst, const float* table, int size, int interpolation)
+{
+    if (src.empty() || src.device != IM_DD_CPU || !table || size < 2)
+        return false;
+    if (src.type != IM_DT_INT8 && src.type != IM_DT_INT16 && src.type != IM_DT_INT16_BE &&
+        src.type != IM_DT_FLOAT16 && src.type != IM_DT_FLOAT32)
+        return false;
+
+    void (*interp_row)(const float*, int, const float*, const float*, const float*, float*, float*, float*, int) = nullptr;
+    switch (interpolation)
+    {
+        case IM_INTERPOLATE_NEAREST: interp_row = interp_nearest_row; break;
+        case IM_INTERPOLATE_TRILINEAR: interp_row = interp_trilinear_row; break;
+        case IM_INTERPOLATE_TETRAHEDRAL: interp_row = interp_tetrahedral_row; break;
+        default: break;
+    }
+
+    ImDataType type = dst.type;
+    if (type != IM_DT_INT8 && type != IM_DT_INT16 && type != IM_DT_INT16_BE && type != IM_DT_FLOAT16 && type != IM_DT_FLOAT32)
+        type = src.type;
+    dst.create_type(src.w, src.h, 4, type);
+    if (dst.empty())
+        return false;
+
+    int in_map[4], out_map[4];
+    color_format_mapping(src.color_format, in_map);
+    color_format_mapping(dst.color_format, out_map);
+    // only interleaved data is read, formats of other channel count read first channels
+    for (int k = 0; k < 3; k++)
+        if (in_map[k] >= src.c) in_map[k] = 0;
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < src.h; y++)
+    {
+        float R[LUT_ROW_CHUNK], G[LUT_ROW_CHUNK], B[LUT_ROW_CHUNK];
+        float oR[LUT_ROW_CHUNK], oG[LUT_ROW_CHUNK], oB[LUT_ROW_CHUNK];
+        for (int x0 = 0; x0 < src.w; x0 += LUT_ROW_CHUNK)
+        {
+            const int n = std::min(LUT_ROW_CHUNK, src.w - x0);
+            load_rgb_row(src, in_map, y, x0, n, R, G, B);
+            if (interp_row)
+                interp_row(table, size, R, G, B, oR, oG, oB, n);
+            else
+            {
+                // unknown interpolation passes rgb through, as shader does
+                std::copy(R, R + n, oR);
+                std::copy(G, G + n, oG);
+                std::copy(B, B + n, oB);
+            }
+            store_rgb_row(dst, out_map, y, x0, n, oR, oG, oB);
+        }
+    }
+    return true;
+}
+} // namespace ImGui
@@ -0,0 +1,18 @@
+#pragma once
+#include "immat.h"
+#include "imvk_platform.h"
+
+namespace ImGui
+{
+// CPU implementation of LUT3D shader, used by LUT3D_vulkan when there is no vulkan device.
+// Table is LUT3D_vulkan layout, size^3 padded rgba float entries indexed by (r * size + g) * size + b,
+// so the 3 values of a lattice point share one cache line.
+//
+// Rows are processed in parallel, nearest/trilinear/tetrahedral kernels gather lattice points with
+// AVX2, output is 4 channels of dst.type with opaque alpha, like shader output.
+class VKSHADER_API LUT3D_cpu
+{
+public:
+    static bool filter(const ImMat& src, ImMat& dst, const float* table, int size, int interpolation);
+};
+} // namespace ImGui
@@ -1,10 +1,14 @@
 #include "Lut3D_vulkan.h"
 #include "Lut3D_shader.h"
+#include "Lut3D_cpu.h"
 #include "ImVulkanShader.h"
+#include <sys/stat.h>
 #include <algorithm>
+#include <map>
 
 #define MAX_LEVEL 256
 #define MAX_LINE_SIZE 512
+#define MAX_CACHED_CUBE 8
 #define NEXT_LINE(loop_cond) do {                           \
     if (!fgets(line, sizeof(line), f)) {                    \
         fprintf(stderr, "Unexpected EOF\n");                \
@@ -98,10 +102,6 @@ LUT3D_vulkan::LUT3D_vulkan(void * table, int size, float r_scale, float g_scale,
     {
         return;
     }
-    if (init(interpolation, gpu) != 0)
-    {
-        return;
-    }
 
     lutsize = size;
     lut = table;
@@ -109,13 +109,19 @@ LUT3D_vulkan::LUT3D_vulkan(void * table, int size, float r_scale, float g_scale,
     scale.g = g_scale;
     scale.b = b_scale;
     scale.a = a_scale;
+    from_file = false;
+
+    // without vulkan device the table is kept for cpu filter
+    if (init(interpolation, gpu) != 0)
+    {
+        return;
+    }
 
     ImMat lut_cpu;
     lut_cpu.create_type(lutsize, lutsize * 4, lutsize, (void *)lut, IM_DT_FLOAT32);
     VkTransfer tran(vkdev);
     tran.record_upload(lut_cpu, lut_gpu, opt, false);
     tran.submit_and_wait();
-    from_file = false;
 }
 
 LUT3D_vulkan::LUT3D_vulkan(std::string lut_path, int interpolation, int gpu)
@@ -131,6 +137,9 @@ LUT3D_vulkan::LUT3D_vulkan(std::string lut_path, int interpolation, int gpu)
         }
         return;
     }
+    from_file = true;
+
+    // without vulkan device the table is kept for cpu filter
     if (init(interpolation, gpu) != 0)
     {
         return;
@@ -141,7 +150,6 @@ LUT3D_vulkan::LUT3D_vulkan(std::string lut_path, int interpolation, int gpu)
     VkTransfer tran(vkdev);
     tran.record_upload(lut_cpu, lut_gpu, opt, false);
     tran.submit_and_wait();
-    from_file = true;
 }
 
 LUT3D_vulkan::~LUT3D_vulkan()
@@ -157,6 +165,7 @@ LUT3D_vulkan::~LUT3D_vulkan()
 
 int LUT3D_vulkan::init(int interpolation, int gpu)
 {
+    interpolation_mode = interpolation;
     vkdev = get_gpu_device(gpu);
     if (vkdev == NULL) return -1;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
@@ -176,7 +185,6 @@ int LUT3D_vulkan::init(int interpolation, int gpu)
     }
 
     cmd->reset();
-    interpolation_mode = interpolation;
     return 0;
 }
 
@@ -202,7 +210,76 @@ int LUT3D_vulkan::allocate_3dlut(int size)
     return 0;
 }
 
+// Parsed cube files, keyed by path and checked by modify time and file size. Parsing a
+// 65^3 cube text is much slower than creating the filter, and the same lut is often
+// loaded by many clips.
+struct cube_cache_entry
+{
+    int64_t mtime {0};
+    int64_t file_size {0};
+    int lutsize {0};
+    rgbvec scale {1.0, 1.0, 1.0, 0.0};
+    std::vector<rgbvec> table;
+    uint64_t last_used {0};
+};
+
+static Mutex g_cube_cache_lock;
+static std::map<std::string, cube_cache_entry> g_cube_cache;
+static uint64_t g_cube_cache_clock = 0;
+
+static bool cube_file_stat(const std::string& path, int64_t& mtime, int64_t& file_size)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+    mtime = (int64_t)st.st_mtime;
+    file_size = (int64_t)st.st_size;
+    return true;
+}
+
 int LUT3D_vulkan::parse_cube(std::string lut_file)
+{
+    int64_t mtime = 0, file_size = 0;
+    if (!cube_file_stat(lut_file, mtime, file_size))
+        return -1;
+
+    {
+        MutexLockGuard lock(g_cube_cache_lock);
+        auto it = g_cube_cache.find(lut_file);
+        if (it != g_cube_cache.end() && it->second.mtime == mtime && it->second.file_size == file_size)
+        {
+            if (allocate_3dlut(it->second.lutsize) < 0)
+                return -1;
+            memcpy(lut, it->second.table.data(), it->second.table.size() * sizeof(rgbvec));
+            scale = it->second.scale;
+            it->second.last_used = ++g_cube_cache_clock;
+            return 0;
+        }
+    }
+
+    int ret = parse_cube_file(lut_file);
+    if (ret != 0 || !lut || lutsize == 0)
+        return ret;
+
+    MutexLockGuard lock(g_cube_cache_lock);
+    if (g_cube_cache.find(lut_file) == g_cube_cache.end() && g_cube_cache.size() >= MAX_CACHED_CUBE)
+    {
+        auto oldest = g_cube_cache.begin();
+        for (auto it = g_cube_cache.begin(); it != g_cube_cache.end(); ++it)
+            if (it->second.last_used < oldest->second.last_used) oldest = it;
+        g_cube_cache.erase(oldest);
+    }
+    cube_cache_entry& entry = g_cube_cache[lut_file];
+    entry.mtime = mtime;
+    entry.file_size = file_size;
+    entry.lutsize = lutsize;
+    entry.scale = scale;
+    entry.table.assign((rgbvec *)lut, (rgbvec *)lut + (size_t)lutsize * lutsize * lutsize);
+    entry.last_used = ++g_cube_cache_clock;
+    return 0;
+}
+
+int LUT3D_vulkan::parse_cube_file(std::string lut_file)
 {
     FILE *f = fopen(lut_file.c_str(), "r");
     if (f == NULL) return -1;
@@ -346,7 +423,22 @@ void LUT3D_vulkan::upload_param(const VkMat& src, VkMat& dst)
 double LUT3D_vulkan::filter(const ImMat& src, ImMat& dst)
 {
     double ret = 0.0;
-    if (!vkdev || !pipeline_lut3d || lut_gpu.empty() || !cmd)
+    if (!vkdev)
+    {
+        // no vulkan device, lut on cpu
+        if (!lut || lutsize == 0 || src.device != IM_DD_CPU)
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!LUT3D_cpu::filter(src, dst, (const float *)lut, lutsize, interpolation_mode))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        return ret;
+    }
+    if (!pipeline_lut3d || lut_gpu.empty() || !cmd)
     {
         return ret;
     }
@@ -23,7 +23,7 @@ public:
     void write_header_file(std::string filename);
     
 public:
-    const VulkanDevice* vkdev;
+    const VulkanDevice* vkdev {nullptr};
     Pipeline * pipeline_lut3d = nullptr;
     VkCompute * cmd = nullptr;
     Option opt;
@@ -41,6 +41,7 @@ private:
     int init(int interpolation, int gpu);
     int allocate_3dlut(int size);
     int parse_cube(std::string lut_file);
+    int parse_cube_file(std::string lut_file);
     void upload_param(const VkMat& src, VkMat& dst);
 };
 } // namespace ImGui 
\ No newline at end of file
@@ -253,10 +253,7 @@ int Cast_vulkan::forward(const ImMat& bottom_blob, ImMat& top_blob, const Option
             const float* ptr = bottom_blob.channel(q);
             unsigned short* outptr = top_blob.channel(q);
 
-            for (int i = 0; i < size; i++)
-            {
-                outptr[i] = im_float32_to_float16(ptr[i]);
-            }
+            im_float32_to_float16_n(outptr, ptr, size);
         }
     }
 
@@ -268,10 +265,7 @@ int Cast_vulkan::forward(const ImMat& bottom_blob, ImMat& top_blob, const Option
             const unsigned short* ptr = bottom_blob.channel(q);
             float* outptr = top_blob.channel(q);
 
-            for (int i = 0; i < size; i++)
-            {
-                outptr[i] = im_float16_to_float32(ptr[i]);
-            }
+            im_float16_to_float32_n(outptr, ptr, size);
         }
     }
 
@@ -298,10 +292,7 @@ int Cast_vulkan::forward(const ImMat& bottom_blob, ImMat& top_blob, const Option
             const float* ptr = bottom_blob.channel(q);
             unsigned short* outptr = top_blob.channel(q);
 
-            for (int i = 0; i < size; i++)
-            {
-                outptr[i] = im_float32_to_bfloat16(ptr[i]);
-            }
+            im_float32_to_bfloat16_n(outptr, ptr, size);
         }
     }
 
@@ -313,10 +304,7 @@ int Cast_vulkan::forward(const ImMat& bottom_blob, ImMat& top_blob, const Option
             const unsigned short* ptr = bottom_blob.channel(q);
             float* outptr = top_blob.channel(q);
 
-            for (int i = 0; i < size; i++)
-            {
-                outptr[i] = im_bfloat16_to_float32(ptr[i]);
-            }
+            im_bfloat16_to_float32_n(outptr, ptr, size);
         }
     }
 
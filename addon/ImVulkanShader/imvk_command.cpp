@@ -1,6 +1,7 @@
 #include "imvk_command.h"
 #include "imvk_option.h"
 #include "imvk_pipeline.h"
+#include <algorithm>
 
 namespace ImGui
 {
@@ -13,6 +14,10 @@ public:
     int init();
     int begin_command_buffer();
     int end_command_buffer();
+#ifdef VULKAN_SHADER_BENCHMARK
+    void reset_queries();
+    void write_timestamp(uint32_t query, VkPipelineStageFlagBits stage);
+#endif // VULKAN_SHADER_BENCHMARK
 
     const VulkanDevice* vkdev;
     std::string m_Name;
@@ -22,6 +27,8 @@ public:
     VkCommandBuffer compute_command_buffer;
 
     VkFence compute_command_fence;
+    // fence is pending until wait()
+    bool submitted;
 
     std::vector<VkMat> upload_staging_buffers;
     std::vector<VkMat> download_post_buffers;
@@ -149,6 +156,7 @@ public:
             struct
             {
                 uint32_t query;
+                VkPipelineStageFlagBits stage;
             } write_timestamp;
 #endif // VULKAN_SHADER_BENCHMARK
 
@@ -170,6 +178,8 @@ public:
 #ifdef VULKAN_SHADER_BENCHMARK
     uint32_t query_count;
     VkQueryPool query_pool;
+    // query 0 and 1 are benchmark start and end, 2 is top of command buffer, stages follow
+    std::vector<std::string> stage_names;
 #endif // VULKAN_SHADER_BENCHMARK
 };
 
@@ -179,6 +189,7 @@ VkComputePrivate::VkComputePrivate(const VulkanDevice* _vkdev, std::string name)
     compute_command_pool = 0;
     compute_command_buffer = 0;
     compute_command_fence = 0;
+    submitted = false;
 
 #ifdef VULKAN_SHADER_BENCHMARK
     query_count = 0;
@@ -190,6 +201,10 @@ VkComputePrivate::VkComputePrivate(const VulkanDevice* _vkdev, std::string name)
 
 VkComputePrivate::~VkComputePrivate()
 {
+    // commands in flight must complete before their resources are freed
+    if (submitted)
+        vkWaitForFences(vkdev->vkdevice(), 1, &compute_command_fence, VK_TRUE, UINT64_MAX);
+
     for (size_t i = 0; i < image_blocks_to_destroy.size(); i++)
     {
         VkImageMemory* ptr = image_blocks_to_destroy[i];
@@ -290,8 +305,7 @@ int VkComputePrivate::init()
         begin_command_buffer();
 
 #ifdef VULKAN_SHADER_BENCHMARK
-        if (query_pool)
-            vkCmdResetQueryPool(compute_command_buffer, query_pool, 0, query_count);
+        reset_queries();
 #endif // VULKAN_SHADER_BENCHMARK
     }
 
@@ -328,11 +342,42 @@ int VkComputePrivate::end_command_buffer()
     return 0;
 }
 
+#ifdef VULKAN_SHADER_BENCHMARK
+void VkComputePrivate::reset_queries()
+{
+    if (!query_pool)
+        return;
+
+    vkCmdResetQueryPool(compute_command_buffer, query_pool, 0, query_count);
+    // origin of first stage
+    if (query_count > 2)
+        vkCmdWriteTimestamp(compute_command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, 2);
+}
+
+void VkComputePrivate::write_timestamp(uint32_t query, VkPipelineStageFlagBits stage)
+{
+    if (vkdev->info.support_VK_KHR_push_descriptor())
+    {
+        if (query_pool)
+            vkCmdWriteTimestamp(compute_command_buffer, stage, query_pool, query);
+    }
+    else
+    {
+        record r;
+        r.type = record::TYPE_write_timestamp;
+        r.command_buffer = compute_command_buffer;
+        r.write_timestamp.query = query;
+        r.write_timestamp.stage = stage;
+        delayed_records.push_back(r);
+    }
+}
+#endif // VULKAN_SHADER_BENCHMARK
+
 VkCompute::VkCompute(const VulkanDevice* _vkdev, std::string name)
     : vkdev(_vkdev), m_Name(name), d(new VkComputePrivate(_vkdev, name))
 {
 #ifdef VULKAN_SHADER_BENCHMARK
-    create_query_pool(2);
+    create_query_pool(3 + VK_COMPUTE_BENCHMARK_STAGES);
 #endif
 }
 
@@ -1865,19 +1910,7 @@ void VkCompute::record_pipeline(const Pipeline* pipeline, const std::vector<VkMa
 #ifdef VULKAN_SHADER_BENCHMARK
 void VkCompute::record_write_timestamp(uint32_t query)
 {
-    if (vkdev->info.support_VK_KHR_push_descriptor())
-    {
-        if (d->query_pool)
-            vkCmdWriteTimestamp(d->compute_command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, d->query_pool, query);
-    }
-    else
-    {
-        VkComputePrivate::record r;
-        r.type = VkComputePrivate::record::TYPE_write_timestamp;
-        r.command_buffer = d->compute_command_buffer;
-        r.write_timestamp.query = query;
-        d->delayed_records.push_back(r);
-    }
+    d->write_timestamp(query, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
 }
 
 void VkCompute::benchmark_start()
@@ -1916,19 +1949,65 @@ void VkCompute::benchmark_print()
         fprintf(stderr, "[Benchmark] - %s %8.3lfms\n", m_Name.c_str(), duration_ms);
     }
 }
+
+void VkCompute::benchmark_stage(const std::string& name)
+{
+    if (!d->query_pool || d->stage_names.size() + 3 >= d->query_count)
+        return;
+
+    // bottom of pipe, transfers of upload and download stages are complete as well
+    d->write_timestamp(3 + (uint32_t)d->stage_names.size(), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+    d->stage_names.push_back(name);
+}
+
+void VkCompute::benchmark_stages(std::vector<std::pair<std::string, double>>& stages)
+{
+    stages.clear();
+    const uint32_t count = (uint32_t)d->stage_names.size();
+    if (!d->query_pool || count == 0)
+        return;
+
+    std::vector<uint64_t> results(3 + count, 0);
+    get_query_pool_results(2, 1 + count, results);
+    uint64_t previous = results[2];
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint64_t end = results[3 + i];
+        double duration_ms = 0.0;
+        if (previous != 0 && end >= previous)
+            duration_ms = (end - previous) * vkdev->info.timestamp_period() / 1000000.f;
+        stages.push_back(std::make_pair(d->stage_names[i], duration_ms));
+        if (end != 0)
+            previous = end;
+    }
+}
 #endif // VULKAN_SHADER_BENCHMARK
 
 
 int VkCompute::submit_and_wait(uint64_t timeout)
+{
+    int ret = submit();
+    if (ret != 0)
+        return ret;
+
+    return wait(timeout);
+}
+
+int VkCompute::submit()
 {
     //fprintf(stderr, "[Vkshader Debug]: %s\n", m_Name.c_str());
+    if (d->submitted)
+    {
+        fprintf(stderr, "VkCompute %s submitted twice without reset\n", m_Name.c_str());
+        return -1;
+    }
+
     if (!vkdev->info.support_VK_KHR_push_descriptor())
     {
         d->begin_command_buffer();
 
 #ifdef VULKAN_SHADER_BENCHMARK
-        if (d->query_pool)
-            vkCmdResetQueryPool(d->compute_command_buffer, d->query_pool, 0, d->query_count);
+        d->reset_queries();
 #endif // VULKAN_SHADER_BENCHMARK
 
         const size_t record_count = d->delayed_records.size();
@@ -2007,7 +2086,7 @@ int VkCompute::submit_and_wait(uint64_t timeout)
             case VkComputePrivate::record::TYPE_write_timestamp:
             {
                 if (d->query_pool)
-                    vkCmdWriteTimestamp(r.command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, d->query_pool, r.write_timestamp.query);
+                    vkCmdWriteTimestamp(r.command_buffer, r.write_timestamp.stage, d->query_pool, r.write_timestamp.query);
                 break;
             }
 #endif // VULKAN_SHADER_BENCHMARK
@@ -2055,6 +2134,15 @@ int VkCompute::submit_and_wait(uint64_t timeout)
     }
 
     vkdev->reclaim_queue(vkdev->info.compute_queue_family_index(), compute_queue);
+    d->submitted = true;
+
+    return 0;
+}
+
+int VkCompute::wait(uint64_t timeout)
+{
+    if (!d->submitted)
+        return 0;
 
     // wait
     {
@@ -2065,6 +2153,7 @@ int VkCompute::submit_and_wait(uint64_t timeout)
             return -1;
         }
     }
+    d->submitted = false;
 
     // handle delayed post records
     for (size_t i = 0; i < d->delayed_records.size(); i++)
@@ -2102,6 +2191,11 @@ int VkCompute::submit_and_wait(uint64_t timeout)
     return 0;
 }
 
+bool VkCompute::is_finished() const
+{
+    return !d->submitted || vkGetFenceStatus(vkdev->vkdevice(), d->compute_command_fence) == VK_SUCCESS;
+}
+
 void VkCompute::flash()
 {
     VkResult ret;
@@ -2126,6 +2220,9 @@ void VkCompute::flash()
 
 int VkCompute::reset()
 {
+    if (d->submitted && wait() != 0)
+        return -1;
+
     d->upload_staging_buffers.clear();
     d->download_post_buffers.clear();
     d->download_post_mats_fp16.clear();
@@ -2187,10 +2284,12 @@ int VkCompute::reset()
         d->begin_command_buffer();
 
 #ifdef VULKAN_SHADER_BENCHMARK
-        if (d->query_pool)
-            vkCmdResetQueryPool(d->compute_command_buffer, d->query_pool, 0, d->query_count);
+        d->reset_queries();
 #endif // VULKAN_SHADER_BENCHMARK
     }
+#ifdef VULKAN_SHADER_BENCHMARK
+    d->stage_names.clear();
+#endif // VULKAN_SHADER_BENCHMARK
 
     return 0;
 }
@@ -2217,8 +2316,7 @@ int VkCompute::create_query_pool(uint32_t _query_count)
 
     if (vkdev->info.support_VK_KHR_push_descriptor())
     {
-        if (d->query_pool)
-            vkCmdResetQueryPool(d->compute_command_buffer, d->query_pool, 0, d->query_count);
+        d->reset_queries();
     }
 
     return 0;
@@ -2385,6 +2483,104 @@ void VkCompute::barrier_readonly(const VkImageMat& binding)
     }
 }
 
+VkComputeRing::VkComputeRing(const VulkanDevice* _vkdev, std::string name, int frames)
+    : vkdev(_vkdev)
+{
+    frames = std::max(frames, 1);
+    for (int i = 0; i < frames; i++)
+    {
+        cmds.push_back(new VkCompute(vkdev, name + "#" + std::to_string(i)));
+        blob_allocators.push_back(vkdev->acquire_blob_allocator());
+        staging_allocators.push_back(vkdev->acquire_staging_allocator());
+    }
+}
+
+VkComputeRing::~VkComputeRing()
+{
+    wait_all();
+    for (size_t i = 0; i < cmds.size(); i++)
+    {
+        delete cmds[i];
+        vkdev->reclaim_blob_allocator(blob_allocators[i]);
+        vkdev->reclaim_staging_allocator(staging_allocators[i]);
+    }
+    cmds.clear();
+    blob_allocators.clear();
+    staging_allocators.clear();
+}
+
+VkCompute* VkComputeRing::begin_frame(Option& opt)
+{
+    const int slot = (int)(next_ticket % cmds.size());
+    if (!recording)
+    {
+        // slot is free when frame submitted to it one round ago is complete
+        if (next_ticket > cmds.size() && wait(next_ticket - cmds.size()) != 0)
+            return nullptr;
+        if (cmds[slot]->reset() != 0)
+            return nullptr;
+        recording = true;
+    }
+    opt.blob_vkallocator = blob_allocators[slot];
+    opt.staging_vkallocator = staging_allocators[slot];
+    return cmds[slot];
+}
+
+uint64_t VkComputeRing::submit()
+{
+    if (!recording)
+        return 0;
+
+    recording = false;
+    VkCompute* cmd = cmds[next_ticket % cmds.size()];
+    if (cmd->submit() != 0)
+    {
+        // drop recorded commands, slot is begun again by next frame
+        cmd->reset();
+        return 0;
+    }
+    return next_ticket++;
+}
+
+int VkComputeRing::wait(uint64_t ticket, uint64_t timeout)
+{
+    if (ticket >= next_ticket)
+        return -1;
+
+    // in submit order, downloads of older frames complete first
+    for (uint64_t t = completed_ticket + 1; t <= ticket; t++)
+    {
+        if (cmds[t % cmds.size()]->wait(timeout) != 0)
+            return -1;
+        completed_ticket = t;
+    }
+    return 0;
+}
+
+int VkComputeRing::wait_all(uint64_t timeout)
+{
+    return next_ticket > 1 ? wait(next_ticket - 1, timeout) : 0;
+}
+
+bool VkComputeRing::is_finished(uint64_t ticket) const
+{
+    if (ticket <= completed_ticket)
+        return true;
+    if (ticket >= next_ticket)
+        return false;
+    return cmds[ticket % cmds.size()]->is_finished();
+}
+
+VkCompute* VkComputeRing::get(uint64_t ticket) const
+{
+    if (ticket == 0 || ticket >= next_ticket)
+        return nullptr;
+    // slot is begun again by a newer frame
+    if (ticket + cmds.size() < next_ticket || (ticket + cmds.size() == next_ticket && recording))
+        return nullptr;
+    return cmds[ticket % cmds.size()];
+}
+
 class VkTransferPrivate
 {
 public:
@@ -4,6 +4,9 @@
 #include "imvk_gpu.h"
 #include <vulkan/vulkan.h>
 
+// stage timestamps of a VkCompute submit
+#define VK_COMPUTE_BENCHMARK_STAGES 8
+
 namespace ImGui 
 {
 class Pipeline;
@@ -59,10 +62,21 @@ public:
     void benchmark_end();
     double benchmark();
     void benchmark_print();
+    // ends a stage of at most VK_COMPUTE_BENCHMARK_STAGES per submit, a stage starts where previous
+    // one ends, first one at the top of command buffer
+    void benchmark_stage(const std::string& name);
+    void benchmark_stages(std::vector<std::pair<std::string, double>>& stages);
 #endif // VULKAN_SHADER_BENCHMARK
 
     int submit_and_wait(uint64_t timeout = UINT64_MAX);
 
+    // submit without waiting, recorded downloads to cpu mats are complete after wait()
+    int submit();
+    int wait(uint64_t timeout = UINT64_MAX);
+    // true when nothing is in flight, wait() does not block then
+    bool is_finished() const;
+
+    // waits for submitted commands before reset
     int reset();
 
     void flash();
@@ -85,6 +99,43 @@ private:
     VkComputePrivate* const d;
 };
 
+// Ring of VkCompute for frames in flight, every slot has its own command buffer, fence, blob and
+// staging allocators. Frame n records into slot n % frames while older frames still run on device,
+// so upload of next frame overlaps compute and download of previous one. Tickets of submitted
+// frames increase by one like a timeline, waiting a ticket completes older frames as well.
+class VKSHADER_API VkComputeRing
+{
+public:
+    explicit VkComputeRing(const VulkanDevice* vkdev, std::string name, int frames = 2);
+    virtual ~VkComputeRing();
+
+public:
+    // command buffer of next frame, reset for recording, allocators of slot are set into opt,
+    // waits for the frame submitted to the same slot before
+    VkCompute* begin_frame(Option& opt);
+
+    // submit frame from begin_frame without waiting, returns its ticket or 0 on failure
+    uint64_t submit();
+
+    // downloads to cpu mats of ticket and older frames are complete after wait
+    int wait(uint64_t ticket, uint64_t timeout = UINT64_MAX);
+    int wait_all(uint64_t timeout = UINT64_MAX);
+    bool is_finished(uint64_t ticket) const;
+
+    // command buffer which ran ticket, for benchmark, valid until its slot begins a new frame
+    VkCompute* get(uint64_t ticket) const;
+    int frames() const { return (int)cmds.size(); }
+
+protected:
+    const VulkanDevice* vkdev;
+    std::vector<VkCompute*> cmds;
+    std::vector<VkAllocator*> blob_allocators;
+    std::vector<VkAllocator*> staging_allocators;
+    uint64_t next_ticket {1};
+    uint64_t completed_ticket {0};
+    bool recording {false};
+};
+
 class VkTransferPrivate;
 class VKSHADER_API VkTransfer
 {
@@ -1,10 +1,21 @@
 #include "imvk_gpu.h"
 #include <math.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <atomic>
+#if defined(_WIN32)
+#include <direct.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 #include <vulkan/vulkan.h>
 
+#if !VKSHADER_WITHOUT_GLSLANG
 #include "glslang/SPIRV/GlslangToSpv.h"
 #include "glslang/Public/ShaderLang.h"
+#endif
 
 #include "imvk_command.h"
 #include "imvk_pipelinecache.h"
@@ -122,6 +133,183 @@ static GpuInfo* g_gpu_infos[MAX_GPU_COUNT] = {0};
 static Mutex g_default_vkdev_lock;
 static VulkanDevice* g_default_vkdev[MAX_GPU_COUNT] = {0};
 
+// persistent shader cache, compiled spirv and pipeline cache data live in g_shader_cache_dir
+#define SHADER_CACHE_MAGIC      0x534b5649 // IVKS
+#define SHADER_CACHE_VERSION    1
+static Mutex g_shader_cache_lock;
+static std::string g_shader_cache_dir;
+static std::atomic<unsigned int> g_cache_file_serial(0);
+
+struct spirv_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t check;
+    uint64_t data_hash;
+    uint32_t word_count;
+    uint32_t reserved;
+};
+
+static uint64_t fnv1a_64(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static void make_cache_directory(const std::string& path)
+{
+    // create every missing level
+    for (size_t i = 1; i <= path.size(); i++)
+    {
+        if (i < path.size() && path[i] != '/' && path[i] != '\\')
+            continue;
+        const std::string dir = path.substr(0, i);
+#if defined(_WIN32)
+        _mkdir(dir.c_str());
+#else
+        mkdir(dir.c_str(), 0755);
+#endif
+    }
+}
+
+static std::string shader_cache_path(const char* name)
+{
+    MutexLockGuard lock(g_shader_cache_lock);
+    if (g_shader_cache_dir.empty())
+        return std::string();
+    return g_shader_cache_dir + name;
+}
+
+static bool read_cache_file(const std::string& path, std::vector<uint8_t>& data)
+{
+    data.clear();
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp)
+        return false;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size > 0)
+    {
+        data.resize(size);
+        if (fread(data.data(), 1, size, fp) != (size_t)size)
+            data.clear();
+    }
+    fclose(fp);
+    return !data.empty();
+}
+
+static bool write_cache_file(const std::string& path, const void* header, size_t header_size, const void* data, size_t size)
+{
+    // write to a temporary file first, other threads and processes never read a partial file
+#if defined(_WIN32)
+    const int pid = _getpid();
+#else
+    const int pid = getpid();
+#endif
+    const std::string temp = path + "." + std::to_string(pid) + "." + std::to_string(g_cache_file_serial++) + ".tmp";
+    FILE* fp = fopen(temp.c_str(), "wb");
+    if (!fp)
+        return false;
+    bool ok = (header_size == 0 || fwrite(header, 1, header_size, fp) == header_size) && fwrite(data, 1, size, fp) == size;
+    ok = fclose(fp) == 0 && ok;
+#if defined(_WIN32)
+    ok = ok && MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+    ok = ok && rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok)
+        remove(temp.c_str());
+    return ok;
+}
+
+static std::string spirv_cache_path(uint64_t key)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "spirv/%016llx.spv", (unsigned long long)key);
+    return shader_cache_path(name);
+}
+
+static bool load_spirv_cache(uint64_t key, uint64_t check, std::vector<uint32_t>& spirv)
+{
+    const std::string path = spirv_cache_path(key);
+    std::vector<uint8_t> data;
+    if (path.empty() || !read_cache_file(path, data) || data.size() < sizeof(spirv_cache_header))
+        return false;
+    spirv_cache_header header;
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key || header.check != check ||
+        header.word_count == 0 || data.size() != sizeof(header) + header.word_count * sizeof(uint32_t) ||
+        header.data_hash != fnv1a_64(data.data() + sizeof(header), header.word_count * sizeof(uint32_t)))
+        return false;
+    spirv.resize(header.word_count);
+    memcpy(spirv.data(), data.data() + sizeof(header), header.word_count * sizeof(uint32_t));
+    return true;
+}
+
+static void store_spirv_cache(uint64_t key, uint64_t check, const std::vector<uint32_t>& spirv)
+{
+    const std::string path = spirv_cache_path(key);
+    if (path.empty() || spirv.empty())
+        return;
+    const uint64_t data_hash = fnv1a_64(spirv.data(), spirv.size() * sizeof(uint32_t));
+    spirv_cache_header header = {SHADER_CACHE_MAGIC, SHADER_CACHE_VERSION, key, check, data_hash, (uint32_t)spirv.size(), 0};
+    write_cache_file(path, &header, sizeof(header), spirv.data(), spirv.size() * sizeof(uint32_t));
+}
+
+void set_shader_cache_dir(const std::string& path)
+{
+    MutexLockGuard lock(g_shader_cache_lock);
+    g_shader_cache_dir = path;
+    if (g_shader_cache_dir.empty())
+        return;
+    if (g_shader_cache_dir.back() != '/' && g_shader_cache_dir.back() != '\\')
+        g_shader_cache_dir += "/";
+    make_cache_directory(g_shader_cache_dir + "spirv/");
+}
+
+std::string get_shader_cache_dir()
+{
+    MutexLockGuard lock(g_shader_cache_lock);
+    return g_shader_cache_dir;
+}
+
+#if !VKSHADER_WITHOUT_GLSLANG
+// glslang is set up by the first compile, spirv is compiled and cached without a vulkan device
+static Mutex g_glslang_lock;
+static bool g_glslang_initialized = false;
+
+static void initialize_glslang()
+{
+    MutexLockGuard lock(g_glslang_lock);
+    if (g_glslang_initialized)
+        return;
+    glslang::InitializeProcess();
+    g_glslang_initialized = true;
+}
+
+static void finalize_glslang()
+{
+    MutexLockGuard lock(g_glslang_lock);
+    if (!g_glslang_initialized)
+        return;
+    glslang::FinalizeProcess();
+    g_glslang_initialized = false;
+}
+#endif
+
+#if VKSHADER_SPIRV_PREBUILT
+// generated by vkshader_spirv_prebuild
+extern const spirv_prebuilt_entry g_spirv_prebuilt[];
+extern const int g_spirv_prebuilt_count;
+#endif
+
 struct layer_shader_registry_entry
 {
     const char* comp_data;
@@ -1799,8 +1987,6 @@ int create_gpu_instance()
     // the default gpu device
     g_default_gpu_index = find_default_vulkan_device_index();
 
-    glslang::InitializeProcess();
-
     return 0;
 }
 
@@ -1813,13 +1999,16 @@ void destroy_gpu_instance()
 {
     MutexLockGuard lock(g_instance_lock);
 
+#if !VKSHADER_WITHOUT_GLSLANG
+    // compiles may have run without an instance
+    finalize_glslang();
+#endif
+
     if ((VkInstance)g_instance == 0)
         return;
 
     // fprintf(stderr, "destroy_gpu_instance");
 
-    glslang::FinalizeProcess();
-
     for (int i = 0; i < MAX_GPU_COUNT; i++)
     {
         delete g_default_vkdev[i];
@@ -1927,6 +2116,10 @@ public:
     const Packing_vulkan* get_utility_operator(int storage_type_from, int storage_type_to, int cast_type_from_index, int cast_type_to_index, int packing_type_to_index) const;
     void destroy_utility_operator();
 
+    // vulkan pipeline cache, loaded from and saved to shader cache dir
+    void create_vk_pipeline_cache();
+    void destroy_vk_pipeline_cache();
+
     VkDevice device;
 
     // hardware queue
@@ -1963,6 +2156,10 @@ public:
     // device-wide pipeline cache
     PipelineCache* pipeline_cache;
 
+    // vulkan pipeline cache and hash of data it is created with
+    VkPipelineCache vk_pipeline_cache;
+    uint64_t vk_pipeline_cache_hash;
+
     // utility operator
     // from buffer | image
     // to buffer | image
@@ -2030,9 +2227,7 @@ const Packing_vulkan* VulkanDevicePrivate::get_utility_operator(int storage_type
 
     // create uop
     Option opt;
-    opt.use_image_storage = (storage_type_from == 1 || storage_type_to == 1);
-    opt.use_fp16_packed = (cast_type_from_index == 1 || cast_type_to_index == 1);
-    opt.use_fp16_storage = (cast_type_from_index == 2 || cast_type_to_index == 2);
+    get_uop_option(storage_type_from, storage_type_to, cast_type_from_index, cast_type_to_index, opt);
 
     if (!vkdev->info.support_fp16_packed() && opt.use_fp16_packed)
     {
@@ -2046,20 +2241,6 @@ const Packing_vulkan* VulkanDevicePrivate::get_utility_operator(int storage_type
         return 0;
     }
 
-    // fp16/int8 arithmetic are not necessary for packing
-    // and may conflict with storage options
-    opt.use_fp16_arithmetic = false;
-    opt.use_int8_arithmetic = false;
-
-    // enable pack8 for pack8to1/pack8to4
-    opt.use_shader_pack8 = true;
-
-    // do not enable spirv-1.3 from cooperative matrix
-    opt.use_cooperative_matrix = false;
-
-    // cache uop pipeline as device member explicitly
-    opt.pipeline_cache = 0;
-
     Packing_vulkan* uop = new Packing_vulkan;
     uop->vkdev = vkdev;
 
@@ -2080,10 +2261,6 @@ const Packing_vulkan* VulkanDevicePrivate::get_utility_operator(int storage_type
 void VulkanDevicePrivate::destroy_utility_operator()
 {
     Option opt;
-    opt.use_fp16_arithmetic = false;
-    opt.use_int8_arithmetic = false;
-    opt.use_cooperative_matrix = false;
-    opt.pipeline_cache = 0;
 
     // from buffer | image
     // to buffer | image
@@ -2091,8 +2268,6 @@ void VulkanDevicePrivate::destroy_utility_operator()
     {
         for (int i1 = 0; i1 < 2; i1++)
         {
-            opt.use_image_storage = (i0 == 1 || i1 == 1);
-
             // from fp32-b/i | fp16p-b/i | fp16s-b/i
             // to fp32-b/i | fp16p-b/i | fp16s-b/i
             for (int j0 = 0; j0 < 3; j0++)
@@ -2105,8 +2280,7 @@ void VulkanDevicePrivate::destroy_utility_operator()
                         continue;
                     }
 
-                    opt.use_fp16_packed = (j0 == 1 || j1 == 1);
-                    opt.use_fp16_storage = (j0 == 2 || j1 == 2);
+                    get_uop_option(i0, i1, j0, j1, opt);
 
                     if (!vkdev->info.support_fp16_packed() && opt.use_fp16_packed)
                         continue;
@@ -2117,9 +2291,6 @@ void VulkanDevicePrivate::destroy_utility_operator()
                     // to pack1 | pack4 | pack8
                     for (int k = 0; k < 3; k++)
                     {
-                        // enable pack8 for pack8to1/pack8to4
-                        opt.use_shader_pack8 = true;
-
                         Packing_vulkan* uop = uop_packing[i0][i1][j0][j1][k];
                         if (!uop)
                             continue;
@@ -2136,6 +2307,82 @@ void VulkanDevicePrivate::destroy_utility_operator()
     }
 }
 
+static std::string pipeline_cache_path(const GpuInfo& info)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "pipeline_%04x_%04x_%08x.bin", info.vendor_id(), info.device_id(), info.driver_version());
+    return shader_cache_path(name);
+}
+
+void VulkanDevicePrivate::create_vk_pipeline_cache()
+{
+    vk_pipeline_cache = 0;
+    vk_pipeline_cache_hash = 0;
+
+    // driver corrupts pipeline cache, do not feed it with one
+    if (vkdev->info.bug_corrupted_online_pipeline_cache())
+        return;
+
+    std::vector<uint8_t> data;
+    const std::string path = pipeline_cache_path(vkdev->info);
+    if (!path.empty() && read_cache_file(path, data))
+    {
+        // header is VkPipelineCacheHeaderVersionOne, data of other device or driver is dropped
+        uint32_t header[4] = {0};
+        if (data.size() >= sizeof(header) + VK_UUID_SIZE)
+            memcpy(header, data.data(), sizeof(header));
+        if (header[0] < sizeof(header) + VK_UUID_SIZE || header[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header[2] != vkdev->info.vendor_id() || header[3] != vkdev->info.device_id() ||
+            memcmp(data.data() + sizeof(header), vkdev->info.pipeline_cache_uuid(), VK_UUID_SIZE) != 0)
+            data.clear();
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo;
+    pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheCreateInfo.pNext = 0;
+    pipelineCacheCreateInfo.flags = 0;
+    pipelineCacheCreateInfo.initialDataSize = data.size();
+    pipelineCacheCreateInfo.pInitialData = data.empty() ? 0 : data.data();
+
+    VkResult ret = vkCreatePipelineCache(device, &pipelineCacheCreateInfo, 0, &vk_pipeline_cache);
+    if (ret != VK_SUCCESS && !data.empty())
+    {
+        // retry without data
+        pipelineCacheCreateInfo.initialDataSize = 0;
+        pipelineCacheCreateInfo.pInitialData = 0;
+        data.clear();
+        ret = vkCreatePipelineCache(device, &pipelineCacheCreateInfo, 0, &vk_pipeline_cache);
+    }
+    if (ret != VK_SUCCESS)
+    {
+        fprintf(stderr, "vkCreatePipelineCache failed %d", ret);
+        vk_pipeline_cache = 0;
+        return;
+    }
+    if (!data.empty())
+        vk_pipeline_cache_hash = fnv1a_64(data.data(), data.size());
+}
+
+void VulkanDevicePrivate::destroy_vk_pipeline_cache()
+{
+    if (!vk_pipeline_cache)
+        return;
+
+    const std::string path = pipeline_cache_path(vkdev->info);
+    size_t size = 0;
+    if (!path.empty() && vkGetPipelineCacheData(device, vk_pipeline_cache, &size, 0) == VK_SUCCESS && size > 0)
+    {
+        std::vector<uint8_t> data(size);
+        // only write back when pipelines are added
+        if (vkGetPipelineCacheData(device, vk_pipeline_cache, &size, data.data()) == VK_SUCCESS &&
+            fnv1a_64(data.data(), size) != vk_pipeline_cache_hash)
+            write_cache_file(path, 0, 0, data.data(), size);
+    }
+
+    vkDestroyPipelineCache(device, vk_pipeline_cache, 0);
+    vk_pipeline_cache = 0;
+}
+
 VulkanDevice::VulkanDevice(int device_index)
     : info(get_gpu_info(device_index)), d(new VulkanDevicePrivate(this)), device_number(device_index)
 {
@@ -2420,6 +2667,8 @@ VulkanDevice::VulkanDevice(int device_index)
 
     d->pipeline_cache = new PipelineCache(this);
 
+    d->create_vk_pipeline_cache();
+
     memset(d->uop_packing, 0, sizeof(d->uop_packing));
 }
 
@@ -2447,6 +2696,8 @@ VulkanDevice::~VulkanDevice()
 
     delete d->pipeline_cache;
 
+    d->destroy_vk_pipeline_cache();
+
     vkDestroyDevice(d->device, 0);
 
     delete d;
@@ -2733,7 +2984,7 @@ int VulkanDevice::create_pipeline(VkShaderModule shader_module, VkPipelineLayout
     computePipelineCreateInfo.basePipelineHandle = 0;
     computePipelineCreateInfo.basePipelineIndex = 0;
 
-    VkResult ret = vkCreateComputePipelines(d->device, 0, 1, &computePipelineCreateInfo, 0, pipeline);
+    VkResult ret = vkCreateComputePipelines(d->device, d->vk_pipeline_cache, 1, &computePipelineCreateInfo, 0, pipeline);
     if (ret != VK_SUCCESS)
     {
         fprintf(stderr, "vkCreateComputePipelines failed %d", ret);
@@ -3471,6 +3722,7 @@ VulkanDevice* get_gpu_device(int device_index)
     return g_default_vkdev[device_index];
 }
 
+#if !VKSHADER_WITHOUT_GLSLANG
 static TBuiltInResource get_default_TBuiltInResource()
 {
     TBuiltInResource resource;
@@ -3583,6 +3835,7 @@ static TBuiltInResource get_default_TBuiltInResource()
 
     return resource;
 }
+#endif
 
 int compile_spirv_module(const char* comp_string, const Option& opt, std::vector<uint32_t>& spirv)
 {
@@ -3597,6 +3850,7 @@ int compile_spirv_module(const char* comp_string, const Option& opt, std::vector
     return compile_spirv_module(comp_string, length, opt, spirv, log);
 }
 
+#if !VKSHADER_WITHOUT_GLSLANG
 static size_t GetLines(std::string& str, std::vector<std::string>& lines)
 {
     size_t start = 0;
@@ -3665,7 +3919,9 @@ static void ParserLog(const char* prog, const char *log)
     }
 }
 
-int compile_spirv_module(const char* comp_data, int comp_data_size, const Option& opt, std::vector<uint32_t>& spirv, std::string& log)
+#endif
+
+static void get_spirv_preamble(const Option& opt, std::string& preamble, std::vector<std::string>& processes)
 {
     std::vector<std::pair<const char*, const char*> > custom_defines;
 
@@ -4131,9 +4387,7 @@ int compile_spirv_module(const char* comp_data, int comp_data_size, const Option
     custom_defines.push_back(std::make_pair("ImVulkan_moltenvk", "1"));
 #endif
 
-    std::string preamble;
-    std::vector<std::string> processes;
-
+    preamble.clear();
     processes.resize(custom_defines.size());
     for (size_t i = 0; i < custom_defines.size(); i++)
     {
@@ -4143,6 +4397,122 @@ int compile_spirv_module(const char* comp_data, int comp_data_size, const Option
         preamble += std::string("#define ") + key + " " + def + "\n";
         processes[i] = std::string("define-macro ") + key + "=" + def;
     }
+}
+
+static void get_spirv_cache_key(const char* comp_data, int comp_data_size, const Option& opt, const std::string& preamble, uint64_t& key, uint64_t& check)
+{
+    // keyed by source, defines from option flags and spirv target
+    // specialization constants are applied at pipeline creation and kept by vulkan pipeline cache
+    const uint8_t target = (opt.use_subgroup_basic || opt.use_cooperative_matrix) ? 1 : 0;
+    key = fnv1a_64(comp_data, comp_data_size);
+    key = fnv1a_64(preamble.data(), preamble.size(), key);
+    key = fnv1a_64(&target, sizeof(target), key);
+    // second hash with another offset basis to reject key collision
+    check = fnv1a_64(comp_data, comp_data_size, 0x84222325cbf29ce4ULL);
+    check = fnv1a_64(preamble.data(), preamble.size(), check);
+    check = fnv1a_64(&target, sizeof(target), check);
+}
+
+void get_spirv_module_key(const char* comp_string, const Option& opt, uint64_t& key, uint64_t& check)
+{
+    std::string preamble;
+    std::vector<std::string> processes;
+    get_spirv_preamble(opt, preamble, processes);
+
+    // -1 for omitting the tail '\0', same as compile_spirv_module
+    int length = strlen(comp_string) - 1;
+    get_spirv_cache_key(comp_string, length, opt, preamble, key, check);
+}
+
+void get_uop_option(int storage_type_from, int storage_type_to, int cast_type_from_index, int cast_type_to_index, Option& opt)
+{
+    opt = Option();
+    opt.use_image_storage = (storage_type_from == 1 || storage_type_to == 1);
+    opt.use_fp16_packed = (cast_type_from_index == 1 || cast_type_to_index == 1);
+    opt.use_fp16_storage = (cast_type_from_index == 2 || cast_type_to_index == 2);
+
+    // fp16/int8 arithmetic are not necessary for packing
+    // and may conflict with storage options
+    opt.use_fp16_arithmetic = false;
+    opt.use_int8_arithmetic = false;
+
+    // enable pack8 for pack8to1/pack8to4
+    opt.use_shader_pack8 = true;
+
+    // do not enable spirv-1.3 from cooperative matrix
+    opt.use_cooperative_matrix = false;
+
+    // cache uop pipeline as device member explicitly
+    opt.pipeline_cache = 0;
+}
+
+static bool find_prebuilt_spirv(uint64_t key, uint64_t check, std::vector<uint32_t>& spirv)
+{
+#if VKSHADER_SPIRV_PREBUILT
+    // table is sorted by key
+    int lo = 0;
+    int hi = g_spirv_prebuilt_count;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) / 2;
+        if (g_spirv_prebuilt[mid].key < key)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == g_spirv_prebuilt_count || g_spirv_prebuilt[lo].key != key || g_spirv_prebuilt[lo].check != check)
+        return false;
+    const spirv_prebuilt_entry& entry = g_spirv_prebuilt[lo];
+    spirv.assign(entry.words, entry.words + entry.word_count);
+    return true;
+#else
+    (void)key;
+    (void)check;
+    (void)spirv;
+    return false;
+#endif
+}
+
+int get_prebuilt_spirv_count()
+{
+#if VKSHADER_SPIRV_PREBUILT
+    return g_spirv_prebuilt_count;
+#else
+    return 0;
+#endif
+}
+
+bool has_prebuilt_spirv(const char* comp_string, const Option& opt)
+{
+    uint64_t key = 0;
+    uint64_t check = 0;
+    get_spirv_module_key(comp_string, opt, key, check);
+    std::vector<uint32_t> spirv;
+    return find_prebuilt_spirv(key, check, spirv);
+}
+
+int compile_spirv_module(const char* comp_data, int comp_data_size, const Option& opt, std::vector<uint32_t>& spirv, std::string& log)
+{
+    std::string preamble;
+    std::vector<std::string> processes;
+    get_spirv_preamble(opt, preamble, processes);
+
+    uint64_t cache_key = 0;
+    uint64_t cache_check = 0;
+    get_spirv_cache_key(comp_data, comp_data_size, opt, preamble, cache_key, cache_check);
+
+    // internal shaders precompiled at build time, then persistent cache
+    if (find_prebuilt_spirv(cache_key, cache_check, spirv))
+        return 0;
+    if (load_spirv_cache(cache_key, cache_check, spirv))
+        return 0;
+
+#if VKSHADER_WITHOUT_GLSLANG
+    log = "vkshader is built without glslang, only precompiled shaders are available";
+    fprintf(stderr, "%s\n", log.c_str());
+    return -1;
+#else
+    initialize_glslang();
 
     bool compile_success = true;
 
@@ -4203,11 +4573,13 @@ int compile_spirv_module(const char* comp_data, int comp_data_size, const Option
                 auto* ir = program.getIntermediate(EShLangCompute);
                 glslang::GlslangToSpv(*ir, spirv, &logger, &options);
                 fprintf(stderr, "%s", logger.getAllMessages().c_str());
+                store_spirv_cache(cache_key, cache_check, spirv);
             }
         }
     }
 
     return compile_success ? 0 : -1;
+#endif
 }
 
 int resolve_shader_info(const uint32_t* spv_data, size_t spv_data_size, ShaderInfo& shader_info)
@@ -348,6 +348,29 @@ VKSHADER_API int compile_spirv_module(const char* comp_string, const Option& opt
 VKSHADER_API int compile_spirv_module(const char* comp_string, const Option& opt, std::vector<uint32_t>& spirv, std::string& log);
 VKSHADER_API int compile_spirv_module(const char* comp_data, int comp_data_size, const Option& opt, std::vector<uint32_t>& spirv, std::string& log);
 
+// key of spirv compiled from comp_string with opt, internal shaders precompiled at build time
+// are looked up by it before glslang, see VKSHADER_SPIRV_PREBUILT
+VKSHADER_API void get_spirv_module_key(const char* comp_string, const Option& opt, uint64_t& key, uint64_t& check);
+// number of embedded modules, 0 without VKSHADER_SPIRV_PREBUILT
+VKSHADER_API int get_prebuilt_spirv_count();
+// true when compile_spirv_module(comp_string, opt) is served by an embedded module
+VKSHADER_API bool has_prebuilt_spirv(const char* comp_string, const Option& opt);
+// option packing uops of VulkanDevice are compiled with, vkshader_spirv_prebuild builds the same
+// storage type 0=buffer 1=image, cast type index 0=fp32 1=fp16p 2=fp16s
+VKSHADER_API void get_uop_option(int storage_type_from, int storage_type_to, int cast_type_from_index, int cast_type_to_index, Option& opt);
+struct spirv_prebuilt_entry
+{
+    uint64_t key;
+    uint64_t check;
+    const uint32_t* words;
+    uint32_t word_count;
+};
+
+// persistent shader cache, compiled spirv and vulkan pipeline cache are kept under path
+// empty path disables disk cache, must be set before create_gpu_instance() for pipeline cache
+VKSHADER_API void set_shader_cache_dir(const std::string& path);
+VKSHADER_API std::string get_shader_cache_dir();
+
 // info from spirv
 class ShaderInfo
 {
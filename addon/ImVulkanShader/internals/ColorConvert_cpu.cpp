@@ -0,0 +1,827 @@
+#include "ColorConvert_cpu.h"
+#include <math.h>
+#include <algorithm>
+
+// Results must round exactly like shaders do, so multiply and add are never fused into fma
+// here, otherwise scalar tail, SIMD body and shader would disagree on quantization borders.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#endif
+
+#define CPU_ROW_CHUNK 256
+
+namespace ImGui
+{
+extern const ImMat * color_table[2][2][4];
+
+static inline uint16_t swap_16bit(uint16_t v)
+{
+    return (uint16_t)((v << 8) | (v >> 8));
+}
+
+static inline float load_element(const void* data, size_t i, ImDataType type)
+{
+    switch (type)
+    {
+        case IM_DT_INT8:     return (float)((const uint8_t *)data)[i];
+        case IM_DT_INT16:    return (float)((const uint16_t *)data)[i];
+        case IM_DT_INT16_BE: return (float)swap_16bit(((const uint16_t *)data)[i]);
+        case IM_DT_FLOAT16:  return im_float16_to_float32(((const uint16_t *)data)[i]);
+        case IM_DT_FLOAT32:  return ((const float *)data)[i];
+        default:             return 0.f;
+    }
+}
+
+// same as color_format_mapping_vec4/vec3 in shader, returns false if format isn't rgb
+static inline bool color_format_mapping(ImColorFormat format, int map[4])
+{
+    map[0] = map[1] = map[2] = map[3] = 0;
+    switch (format)
+    {
+        case IM_CF_ABGR: map[0] = 0; map[1] = 1; map[2] = 2; map[3] = 3; return true;
+        case IM_CF_ARGB: map[0] = 2; map[1] = 1; map[2] = 0; map[3] = 3; return true;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; map[3] = 0; return true;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; map[3] = 0; return true;
+        case IM_CF_BGR:  map[0] = 0; map[1] = 1; map[2] = 2; return true;
+        case IM_CF_RGB:  map[0] = 2; map[1] = 1; map[2] = 0; return true;
+        default: return false;
+    }
+}
+
+static inline bool is_int16_type(ImDataType type)
+{
+    return type == IM_DT_INT16 || type == IM_DT_INT16_BE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Row kernels
+////////////////////////////////////////////////////////////////////////////////
+struct CSCParam
+{
+    const float* m;     // 3x3 row major matrix from color_table
+    float offset[3];    // yuv offset
+    float scale[3];     // source values are divided by scale before matrix
+};
+
+// rgb = clamp(M * (yuv / scale - offset), 0, 1)
+static void yuv_to_rgb_row(const float* Y, const float* U, const float* V, float* R, float* G, float* B, int n, const CSCParam& p)
+{
+    const float* m = p.m;
+    int i = 0;
+#if __AVX2__
+    const __m256 sy = _mm256_set1_ps(p.scale[0]), su = _mm256_set1_ps(p.scale[1]), sv = _mm256_set1_ps(p.scale[2]);
+    const __m256 oy = _mm256_set1_ps(p.offset[0]), ou = _mm256_set1_ps(p.offset[1]), ov = _mm256_set1_ps(p.offset[2]);
+    const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+    const __m256 m3 = _mm256_set1_ps(m[3]), m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]);
+    const __m256 m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]), m8 = _mm256_set1_ps(m[8]);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 y = _mm256_sub_ps(_mm256_div_ps(_mm256_loadu_ps(Y + i), sy), oy);
+        __m256 u = _mm256_sub_ps(_mm256_div_ps(_mm256_loadu_ps(U + i), su), ou);
+        __m256 v = _mm256_sub_ps(_mm256_div_ps(_mm256_loadu_ps(V + i), sv), ov);
+        __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, y), _mm256_mul_ps(m1, u)), _mm256_mul_ps(m2, v));
+        __m256 g = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m3, y), _mm256_mul_ps(m4, u)), _mm256_mul_ps(m5, v));
+        __m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m6, y), _mm256_mul_ps(m7, u)), _mm256_mul_ps(m8, v));
+        _mm256_storeu_ps(R + i, _mm256_min_ps(_mm256_max_ps(r, zero), one));
+        _mm256_storeu_ps(G + i, _mm256_min_ps(_mm256_max_ps(g, zero), one));
+        _mm256_storeu_ps(B + i, _mm256_min_ps(_mm256_max_ps(b, zero), one));
+    }
+#elif __ARM_NEON && __aarch64__
+    const float32x4_t sy = vdupq_n_f32(p.scale[0]), su = vdupq_n_f32(p.scale[1]), sv = vdupq_n_f32(p.scale[2]);
+    const float32x4_t oy = vdupq_n_f32(p.offset[0]), ou = vdupq_n_f32(p.offset[1]), ov = vdupq_n_f32(p.offset[2]);
+    const float32x4_t zero = vdupq_n_f32(0.f), one = vdupq_n_f32(1.f);
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t y = vsubq_f32(vdivq_f32(vld1q_f32(Y + i), sy), oy);
+        float32x4_t u = vsubq_f32(vdivq_f32(vld1q_f32(U + i), su), ou);
+        float32x4_t v = vsubq_f32(vdivq_f32(vld1q_f32(V + i), sv), ov);
+        float32x4_t r = vaddq_f32(vaddq_f32(vmulq_n_f32(y, m[0]), vmulq_n_f32(u, m[1])), vmulq_n_f32(v, m[2]));
+        float32x4_t g = vaddq_f32(vaddq_f32(vmulq_n_f32(y, m[3]), vmulq_n_f32(u, m[4])), vmulq_n_f32(v, m[5]));
+        float32x4_t b = vaddq_f32(vaddq_f32(vmulq_n_f32(y, m[6]), vmulq_n_f32(u, m[7])), vmulq_n_f32(v, m[8]));
+        vst1q_f32(R + i, vminq_f32(vmaxq_f32(r, zero), one));
+        vst1q_f32(G + i, vminq_f32(vmaxq_f32(g, zero), one));
+        vst1q_f32(B + i, vminq_f32(vmaxq_f32(b, zero), one));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float y = Y[i] / p.scale[0] - p.offset[0];
+        float u = U[i] / p.scale[1] - p.offset[1];
+        float v = V[i] / p.scale[2] - p.offset[2];
+        float r = m[0] * y + m[1] * u + m[2] * v;
+        float g = m[3] * y + m[4] * u + m[5] * v;
+        float b = m[6] * y + m[7] * u + m[8] * v;
+        R[i] = std::min(std::max(r, 0.f), 1.f);
+        G[i] = std::min(std::max(g, 0.f), 1.f);
+        B[i] = std::min(std::max(b, 0.f), 1.f);
+    }
+}
+
+// yuv = clamp(offset + M * (rgb / scale), 0, 1)
+static void rgb_to_yuv_row(const float* R, const float* G, const float* B, float* Y, float* U, float* V, int n, const CSCParam& p)
+{
+    const float* m = p.m;
+    int i = 0;
+#if __AVX2__
+    const __m256 s = _mm256_set1_ps(p.scale[0]);
+    const __m256 oy = _mm256_set1_ps(p.offset[0]), ou = _mm256_set1_ps(p.offset[1]), ov = _mm256_set1_ps(p.offset[2]);
+    const __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+    const __m256 m3 = _mm256_set1_ps(m[3]), m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]);
+    const __m256 m6 = _mm256_set1_ps(m[6]), m7 = _mm256_set1_ps(m[7]), m8 = _mm256_set1_ps(m[8]);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 r = _mm256_div_ps(_mm256_loadu_ps(R + i), s);
+        __m256 g = _mm256_div_ps(_mm256_loadu_ps(G + i), s);
+        __m256 b = _mm256_div_ps(_mm256_loadu_ps(B + i), s);
+        __m256 y = _mm256_add_ps(oy, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, r), _mm256_mul_ps(m1, g)), _mm256_mul_ps(m2, b)));
+        __m256 u = _mm256_add_ps(ou, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m3, r), _mm256_mul_ps(m4, g)), _mm256_mul_ps(m5, b)));
+        __m256 v = _mm256_add_ps(ov, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m6, r), _mm256_mul_ps(m7, g)), _mm256_mul_ps(m8, b)));
+        _mm256_storeu_ps(Y + i, _mm256_min_ps(_mm256_max_ps(y, zero), one));
+        _mm256_storeu_ps(U + i, _mm256_min_ps(_mm256_max_ps(u, zero), one));
+        _mm256_storeu_ps(V + i, _mm256_min_ps(_mm256_max_ps(v, zero), one));
+    }
+#elif __ARM_NEON && __aarch64__
+    const float32x4_t s = vdupq_n_f32(p.scale[0]);
+    const float32x4_t oy = vdupq_n_f32(p.offset[0]), ou = vdupq_n_f32(p.offset[1]), ov = vdupq_n_f32(p.offset[2]);
+    const float32x4_t zero = vdupq_n_f32(0.f), one = vdupq_n_f32(1.f);
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t r = vdivq_f32(vld1q_f32(R + i), s);
+        float32x4_t g = vdivq_f32(vld1q_f32(G + i), s);
+        float32x4_t b = vdivq_f32(vld1q_f32(B + i), s);
+        float32x4_t y = vaddq_f32(oy, vaddq_f32(vaddq_f32(vmulq_n_f32(r, m[0]), vmulq_n_f32(g, m[1])), vmulq_n_f32(b, m[2])));
+        float32x4_t u = vaddq_f32(ou, vaddq_f32(vaddq_f32(vmulq_n_f32(r, m[3]), vmulq_n_f32(g, m[4])), vmulq_n_f32(b, m[5])));
+        float32x4_t v = vaddq_f32(ov, vaddq_f32(vaddq_f32(vmulq_n_f32(r, m[6]), vmulq_n_f32(g, m[7])), vmulq_n_f32(b, m[8])));
+        vst1q_f32(Y + i, vminq_f32(vmaxq_f32(y, zero), one));
+        vst1q_f32(U + i, vminq_f32(vmaxq_f32(u, zero), one));
+        vst1q_f32(V + i, vminq_f32(vmaxq_f32(v, zero), one));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float r = R[i] / p.scale[0];
+        float g = G[i] / p.scale[0];
+        float b = B[i] / p.scale[0];
+        float y = p.offset[0] + (m[0] * r + m[1] * g + m[2] * b);
+        float u = p.offset[1] + (m[3] * r + m[4] * g + m[5] * b);
+        float v = p.offset[2] + (m[6] * r + m[7] * g + m[8] * b);
+        Y[i] = std::min(std::max(y, 0.f), 1.f);
+        U[i] = std::min(std::max(u, 0.f), 1.f);
+        V[i] = std::min(std::max(v, 0.f), 1.f);
+    }
+}
+
+// uint(floor(v * scale)) clamped to [0, scale], as shader store functions
+static inline uint32_t quantize(float v, float scale)
+{
+    float f = floorf(v * scale);
+    return (uint32_t)std::min(std::max(f, 0.f), scale);
+}
+
+// store rgba row to dst(x0...x0+n, y), a == nullptr means opaque
+static void store_rgba_row(const float* R, const float* G, const float* B, const float* A, int n, ImMat& dst, int x0, int y)
+{
+    int map[4];
+    bool has_map = color_format_mapping(dst.color_format, map);
+#if __AVX2__ || (__ARM_NEON && __aarch64__)
+    // packed pixel store needs every byte of pixel written by one of channels
+    const bool is_rgba = has_map && dst.c == 4 && dst.color_format != IM_CF_BGR && dst.color_format != IM_CF_RGB;
+#else
+    (void)has_map;
+#endif
+    const size_t cstep = dst.c;
+    const size_t offset = ((size_t)y * dst.w + x0) * cstep;
+    int i = 0;
+    switch (dst.type)
+    {
+        case IM_DT_INT8:
+        {
+            uint8_t* out = (uint8_t *)dst.data + offset;
+#if __AVX2__
+            if (is_rgba)
+            {
+                const __m256 s = _mm256_set1_ps(255.f), zero = _mm256_setzero_ps();
+                const __m128i sr = _mm_cvtsi32_si128(map[0] * 8), sg = _mm_cvtsi32_si128(map[1] * 8);
+                const __m128i sb = _mm_cvtsi32_si128(map[2] * 8), sa = _mm_cvtsi32_si128(map[3] * 8);
+                const __m256i opaque = _mm256_sll_epi32(_mm256_set1_epi32(255), sa);
+                #define QUANTIZE_INT8(v) _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_floor_ps(_mm256_mul_ps(v, s)), zero), s))
+                for (; i + 8 <= n; i += 8)
+                {
+                    __m256i px = _mm256_or_si256(_mm256_sll_epi32(QUANTIZE_INT8(_mm256_loadu_ps(R + i)), sr),
+                                                 _mm256_sll_epi32(QUANTIZE_INT8(_mm256_loadu_ps(G + i)), sg));
+                    px = _mm256_or_si256(px, _mm256_sll_epi32(QUANTIZE_INT8(_mm256_loadu_ps(B + i)), sb));
+                    px = _mm256_or_si256(px, A ? _mm256_sll_epi32(QUANTIZE_INT8(_mm256_loadu_ps(A + i)), sa) : opaque);
+                    _mm256_storeu_si256((__m256i *)(out + i * 4), px);
+                }
+                #undef QUANTIZE_INT8
+            }
+#elif __ARM_NEON && __aarch64__
+            if (is_rgba)
+            {
+                const float32x4_t s = vdupq_n_f32(255.f), zero = vdupq_n_f32(0.f);
+                const int32x4_t sr = vdupq_n_s32(map[0] * 8), sg = vdupq_n_s32(map[1] * 8);
+                const int32x4_t sb = vdupq_n_s32(map[2] * 8), sa = vdupq_n_s32(map[3] * 8);
+                const uint32x4_t opaque = vshlq_u32(vdupq_n_u32(255), sa);
+                #define QUANTIZE_INT8(v) vcvtq_u32_f32(vminq_f32(vmaxq_f32(vrndmq_f32(vmulq_f32(v, s)), zero), s))
+                for (; i + 4 <= n; i += 4)
+                {
+                    uint32x4_t px = vorrq_u32(vshlq_u32(QUANTIZE_INT8(vld1q_f32(R + i)), sr),
+                                              vshlq_u32(QUANTIZE_INT8(vld1q_f32(G + i)), sg));
+                    px = vorrq_u32(px, vshlq_u32(QUANTIZE_INT8(vld1q_f32(B + i)), sb));
+                    px = vorrq_u32(px, A ? vshlq_u32(QUANTIZE_INT8(vld1q_f32(A + i)), sa) : opaque);
+                    vst1q_u32((uint32_t *)(out + i * 4), px);
+                }
+                #undef QUANTIZE_INT8
+            }
+#endif
+            for (; i < n; i++)
+            {
+                uint8_t* o = out + i * cstep;
+                o[map[0]] = (uint8_t)quantize(R[i], 255.f);
+                o[map[1]] = (uint8_t)quantize(G[i], 255.f);
+                o[map[2]] = (uint8_t)quantize(B[i], 255.f);
+                o[map[3]] = A ? (uint8_t)quantize(A[i], 255.f) : 255;
+            }
+        }
+        break;
+        case IM_DT_INT16:
+        case IM_DT_INT16_BE:
+        {
+            const bool be = dst.type == IM_DT_INT16_BE;
+            uint16_t* out = (uint16_t *)dst.data + offset;
+            for (; i < n; i++)
+            {
+                uint16_t* o = out + i * cstep;
+                uint16_t r = (uint16_t)quantize(R[i], 65535.f), g = (uint16_t)quantize(G[i], 65535.f), b = (uint16_t)quantize(B[i], 65535.f);
+                uint16_t a = A ? (uint16_t)quantize(A[i], 65535.f) : 65535;
+                o[map[0]] = be ? swap_16bit(r) : r;
+                o[map[1]] = be ? swap_16bit(g) : g;
+                o[map[2]] = be ? swap_16bit(b) : b;
+                o[map[3]] = be ? swap_16bit(a) : a;
+            }
+        }
+        break;
+        case IM_DT_FLOAT16:
+        {
+            uint16_t* out = (uint16_t *)dst.data + offset;
+            for (; i < n; i++)
+            {
+                uint16_t* o = out + i * cstep;
+                o[map[0]] = im_float32_to_float16(std::min(std::max(R[i], 0.f), 1.f));
+                o[map[1]] = im_float32_to_float16(std::min(std::max(G[i], 0.f), 1.f));
+                o[map[2]] = im_float32_to_float16(std::min(std::max(B[i], 0.f), 1.f));
+                o[map[3]] = A ? im_float32_to_float16(std::min(std::max(A[i], 0.f), 1.f)) : 0x3C00;
+            }
+        }
+        break;
+        case IM_DT_FLOAT32:
+        {
+            float* out = (float *)dst.data + offset;
+            for (; i < n; i++)
+            {
+                float* o = out + i * cstep;
+                o[map[0]] = std::min(std::max(R[i], 0.f), 1.f);
+                o[map[1]] = std::min(std::max(G[i], 0.f), 1.f);
+                o[map[2]] = std::min(std::max(B[i], 0.f), 1.f);
+                o[map[3]] = A ? std::min(std::max(A[i], 0.f), 1.f) : 1.f;
+            }
+        }
+        break;
+        default: break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// YUV source, same addressing as load_src_yuv in ColorConvert_shader.h
+////////////////////////////////////////////////////////////////////////////////
+struct YUVSource
+{
+    const void* y_data {nullptr};
+    const void* u_data {nullptr};
+    const void* v_data {nullptr};
+    size_t u_base {0};              // chroma plane offset in elements
+    size_t v_base {0};
+    ImDataType type {IM_DT_INT8};
+    int w {0};
+    int h {0};
+    int uv_scale_w {1};
+    int uv_scale_h {1};
+    bool interleaved {false};       // NV12/P010 chroma, U and V are read from u_data
+    float y_scale {1.f};
+    float uv_scale {1.f};
+
+    bool setup(ImColorFormat format, ImDataType _type, int _w, int _h, float scale)
+    {
+        if (_type != IM_DT_INT8 && !is_int16_type(_type) && _type != IM_DT_FLOAT16 && _type != IM_DT_FLOAT32)
+            return false;
+        type = _type;
+        w = _w;
+        h = _h;
+        uv_scale_w = format == IM_CF_YUV420 || format == IM_CF_YUV422 ? 2 : 1;
+        uv_scale_h = format == IM_CF_YUV420 || format == IM_CF_NV12 || format == IM_CF_P010LE ? 2 : 1;
+        // P010 chroma is only interleaved when it's stored as 16bits
+        interleaved = format == IM_CF_NV12 || (format == IM_CF_P010LE && is_int16_type(type));
+        if (type == IM_DT_INT8)
+            y_scale = uv_scale = scale;
+        else if (is_int16_type(type))
+            y_scale = uv_scale = format == IM_CF_P010LE ? 65535.f : scale;
+        else
+            y_scale = uv_scale = 1.f;
+        return w > 0 && h > 0;
+    }
+    size_t u_index(int x, int y) const
+    {
+        if (interleaved)
+            return u_base + (size_t)(((y / 2) * w / 2 + x / 2) * 2);
+        return u_base + (size_t)((y / uv_scale_h) * w / uv_scale_w + x / uv_scale_w);
+    }
+    size_t v_index(int x, int y) const
+    {
+        if (interleaved)
+            return u_index(x, y) + 1;
+        return v_base + (size_t)((y / uv_scale_h) * w / uv_scale_w + x / uv_scale_w);
+    }
+    // raw values of row, not divided by scale
+    template<typename T, typename Conv>
+    void load_row_t(int y, int x0, int n, float* Y, float* U, float* V, Conv conv) const
+    {
+        const T* py = (const T *)y_data + (size_t)y * w + x0;
+        for (int i = 0; i < n; i++)
+            Y[i] = conv(py[i]);
+        const T* pu = (const T *)u_data;
+        const T* pv = (const T *)(interleaved ? u_data : v_data);
+        if (uv_scale_w == 1 && !interleaved)
+        {
+            pu += u_index(x0, y);
+            pv += v_index(x0, y);
+            for (int i = 0; i < n; i++)
+            {
+                U[i] = conv(pu[i]);
+                V[i] = conv(pv[i]);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < n; i++)
+            {
+                U[i] = conv(pu[u_index(x0 + i, y)]);
+                V[i] = conv(pv[v_index(x0 + i, y)]);
+            }
+        }
+    }
+    void load_row(int y, int x0, int n, float* Y, float* U, float* V) const
+    {
+        switch (type)
+        {
+            case IM_DT_INT8:     load_row_t<uint8_t> (y, x0, n, Y, U, V, [](uint8_t v)  { return (float)v; }); break;
+            case IM_DT_INT16:    load_row_t<uint16_t>(y, x0, n, Y, U, V, [](uint16_t v) { return (float)v; }); break;
+            case IM_DT_INT16_BE: load_row_t<uint16_t>(y, x0, n, Y, U, V, [](uint16_t v) { return (float)swap_16bit(v); }); break;
+            case IM_DT_FLOAT16:  load_row_t<uint16_t>(y, x0, n, Y, U, V, [](uint16_t v) { return im_float16_to_float32(v); }); break;
+            case IM_DT_FLOAT32:  load_row_t<float>   (y, x0, n, Y, U, V, [](float v)    { return v; }); break;
+            default: break;
+        }
+    }
+    // normalized yuv at (x, y), used by interpolation
+    void load(int x, int y, float yuv[3]) const
+    {
+        x = std::min(std::max(x, 0), w - 1);
+        y = std::min(std::max(y, 0), h - 1);
+        yuv[0] = load_element(y_data, (size_t)y * w + x, type) / y_scale;
+        yuv[1] = load_element(u_data, u_index(x, y), type) / uv_scale;
+        yuv[2] = load_element(interleaved ? u_data : v_data, v_index(x, y), type) / uv_scale;
+    }
+};
+
+// interpolation functions are same as INTERPLATE_* in ColorConvert_shader.h
+static void interpolate_nearest(const YUVSource& s, int real_w, int real_h, int out_w, int out_h, int x, int y, float yuv[3])
+{
+    float fx = float(out_w) / float(real_w);
+    float fy = float(out_h) / float(real_h);
+    int srcx = (int)floorf(x / fx);
+    int srcy = (int)floorf(y / fy);
+    s.load(std::min(srcx, s.w - 1), std::min(srcy, s.h - 1), yuv);
+}
+
+static void interpolate_bilinear(const YUVSource& s, int real_w, int real_h, int out_w, int out_h, int x, int y, float yuv[3])
+{
+    float fx = float(out_w) / float(real_w);
+    float fy = float(out_h) / float(real_h);
+    float srcx = x / fx;
+    float srcy = y / fy;
+    int _x = (int)floorf(srcx);
+    float u = srcx - _x;
+    if (u < 0.f) { _x = 0; u = 0.f; }
+    if (_x >= s.w - 1) { _x = s.w - 2; u = 1.f; }
+    int _y = (int)floorf(srcy);
+    float v = srcy - _y;
+    if (v < 0.f) { _y = 0; v = 0.f; }
+    if (_y >= s.h - 1) { _y = s.h - 2; v = 1.f; }
+    float _x_y[3], _x1_y[3], _x_y1[3], _x1_y1[3];
+    s.load(_x,     _y,     _x_y);
+    s.load(_x + 1, _y,     _x1_y);
+    s.load(_x,     _y + 1, _x_y1);
+    s.load(_x + 1, _y + 1, _x1_y1);
+    for (int i = 0; i < 3; i++)
+        yuv[i] = (1.f - u) * (1.f - v) * _x_y[i] + (1.f - u) * v * _x_y1[i] + u * (1.f - v) * _x1_y[i] + u * v * _x1_y1[i];
+}
+
+static void interpolate_bicubic(const YUVSource& s, int real_w, int real_h, int out_w, int out_h, int x, int y, float yuv[3])
+{
+    const float A = -0.75f;
+    float scale_x = float(real_w) / float(out_w);
+    float scale_y = float(real_h) / float(out_h);
+    float fx = (x + 0.5f) * scale_x - 0.5f;
+    int sx = (int)floorf(fx);
+    fx -= sx;
+    if (sx < 1) { fx = 0.f; sx = 1; }
+    if (sx >= s.w - 3) { fx = 0.f; sx = s.w - 3; }
+    float cbufX[4];
+    cbufX[0] = ((A * (fx + 1.f) - 5.f * A) * (fx + 1.f) + 8.f * A) * (fx + 1.f) - 4.f * A;
+    cbufX[1] = ((A + 2.f) * fx - (A + 3.f)) * fx * fx + 1.f;
+    cbufX[2] = ((A + 2.f) * (1.f - fx) - (A + 3.f)) * (1.f - fx) * (1.f - fx) + 1.f;
+    cbufX[3] = 1.f - cbufX[0] - cbufX[1] - cbufX[2];
+    float fy = (y + 0.5f) * scale_y - 0.5f;
+    int sy = (int)floorf(fy);
+    fy -= sy;
+    sy = std::min(sy, s.h - 3);
+    sy = std::max(1, sy);
+    float cbufY[4];
+    cbufY[0] = ((A * (fy + 1.f) - 5.f * A) * (fy + 1.f) + 8.f * A) * (fy + 1.f) - 4.f * A;
+    cbufY[1] = ((A + 2.f) * fy - (A + 3.f)) * fy * fy + 1.f;
+    cbufY[2] = ((A + 2.f) * (1.f - fy) - (A + 3.f)) * (1.f - fy) * (1.f - fy) + 1.f;
+    cbufY[3] = 1.f - cbufY[0] - cbufY[1] - cbufY[2];
+    yuv[0] = yuv[1] = yuv[2] = 0.f;
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            float v[3];
+            s.load(sx - 1 + i, sy - 1 + j, v);
+            for (int k = 0; k < 3; k++)
+                yuv[k] = yuv[k] + v[k] * cbufX[i] * cbufY[j];
+        }
+    }
+}
+
+static void interpolate_area(const YUVSource& s, int real_w, int real_h, int out_w, int out_h, int x, int y, float yuv[3])
+{
+    float scale_x = float(real_w) / float(out_w);
+    float scale_y = float(real_h) / float(out_h);
+    float inv_scale_x = 1.f / scale_x;
+    float inv_scale_y = 1.f / scale_y;
+    yuv[0] = yuv[1] = yuv[2] = 0.f;
+    if (scale_x > 2.f && scale_y > 2.f)
+    {
+        float fsx1 = x * scale_x;
+        float fsx2 = fsx1 + scale_x;
+        float fsy1 = y * scale_y;
+        float fsy2 = fsy1 + scale_y;
+        int sx1 = (int)floorf(fsx1), sx2 = (int)ceilf(fsx2);
+        int sy1 = (int)floorf(fsy1), sy2 = (int)ceilf(fsy2);
+        if (sx1 < 0) sx1 = 0;
+        if (sx2 > s.w - 1) sx2 = s.w - 1;
+        if (sy1 < 0) sy1 = 0;
+        if (sy2 > s.h - 1) sy2 = s.h - 1;
+        int cell_w = std::max(sx2 - sx1, 1);
+        int cell_h = std::max(sy2 - sy1, 1);
+        for (int j = 0; j < cell_h; j++)
+        {
+            for (int i = 0; i < cell_w; i++)
+            {
+                float v[3];
+                s.load(sx1 + i, sy1 + j, v);
+                for (int k = 0; k < 3; k++)
+                    yuv[k] += v[k];
+            }
+        }
+        for (int k = 0; k < 3; k++)
+            yuv[k] /= float(cell_w * cell_h);
+    }
+    else
+    {
+        int sx = (int)floorf(x * scale_x);
+        float fx = (float)(x + 1) - (float)(sx + 1) * inv_scale_x;
+        fx = fx < 0.f ? 0.f : fx - floorf(fx);
+        if (sx < 0) { fx = 0.f; sx = 0; }
+        if (sx >= s.w - 1) { fx = 0.f; sx = s.w - 2; }
+        float cbufx[2];
+        cbufx[0] = 1.f - fx;
+        cbufx[1] = 1.f - cbufx[0];
+        int sy = (int)floorf(y * scale_y);
+        float fy = (float)(y + 1) - (float)(sy + 1) * inv_scale_y;
+        fy = fy <= 0.f ? 0.f : fy - floorf(fy);
+        sy = std::min(sy, s.h - 2);
+        float cbufy[2];
+        cbufy[0] = 1.f - fy;
+        cbufy[1] = 1.f - cbufy[0];
+        float v00[3], v01[3], v10[3], v11[3];
+        s.load(sx,     sy,     v00);
+        s.load(sx,     sy + 1, v01);
+        s.load(sx + 1, sy,     v10);
+        s.load(sx + 1, sy + 1, v11);
+        for (int k = 0; k < 3; k++)
+            yuv[k] = v00[k] * cbufx[0] * cbufy[0] + v01[k] * cbufx[0] * cbufy[1] + v10[k] * cbufx[1] * cbufy[0] + v11[k] * cbufx[1] * cbufy[1];
+    }
+}
+
+static bool yuv_to_rgba(const YUVSource& s, ImColorSpace color_space, ImColorRange color_range, int real_w, int real_h, bool resize, ImInterpolateMode type, ImMat& dst)
+{
+    if (color_space < IM_CS_SRGB || color_space > IM_CS_BT2020 || color_range < IM_CR_FULL_RANGE || color_range > IM_CR_NARROW_RANGE)
+        return false;
+    if (resize && (s.w < 4 || s.h < 4 || real_w <= 0 || real_h <= 0))
+        return false;
+    CSCParam param;
+    param.m = (const float *)color_table[0][color_range][color_space]->data;
+    param.offset[0] = color_range == IM_CR_NARROW_RANGE ? 16.0f / 255.0f : 0.f;
+    param.offset[1] = param.offset[2] = 0.5f;
+    param.scale[0] = resize ? 1.f : s.y_scale;
+    param.scale[1] = param.scale[2] = resize ? 1.f : s.uv_scale;
+    const int out_w = resize ? dst.w : s.w;
+    const int out_h = resize ? dst.h : s.h;
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < out_h; y++)
+    {
+        float Y[CPU_ROW_CHUNK], U[CPU_ROW_CHUNK], V[CPU_ROW_CHUNK];
+        float R[CPU_ROW_CHUNK], G[CPU_ROW_CHUNK], B[CPU_ROW_CHUNK];
+        for (int x0 = 0; x0 < out_w; x0 += CPU_ROW_CHUNK)
+        {
+            const int n = std::min(CPU_ROW_CHUNK, out_w - x0);
+            if (!resize)
+                s.load_row(y, x0, n, Y, U, V);
+            else
+            {
+                for (int i = 0; i < n; i++)
+                {
+                    float yuv[3];
+                    switch (type)
+                    {
+                        case IM_INTERPOLATE_BILINEAR: interpolate_bilinear(s, real_w, real_h, out_w, out_h, x0 + i, y, yuv); break;
+                        case IM_INTERPOLATE_BICUBIC:  interpolate_bicubic (s, real_w, real_h, out_w, out_h, x0 + i, y, yuv); break;
+                        case IM_INTERPOLATE_AREA:     interpolate_area    (s, real_w, real_h, out_w, out_h, x0 + i, y, yuv); break;
+                        default:                      interpolate_nearest (s, real_w, real_h, out_w, out_h, x0 + i, y, yuv); break;
+                    }
+                    Y[i] = yuv[0]; U[i] = yuv[1]; V[i] = yuv[2];
+                }
+            }
+            yuv_to_rgb_row(Y, U, V, R, G, B, n, param);
+            store_rgba_row(R, G, B, nullptr, n, dst, x0, y);
+        }
+    }
+    return true;
+}
+
+static bool check_rgba_dst(const ImMat& dst)
+{
+    return !dst.empty() && dst.device == IM_DD_CPU && dst.c >= 4 &&
+           (dst.type == IM_DT_INT8 || is_int16_type(dst.type) || dst.type == IM_DT_FLOAT16 || dst.type == IM_DT_FLOAT32);
+}
+
+bool ColorConvert_cpu::YUV2RGBA(const ImMat& im_YUV, ImMat& im_RGB, ImInterpolateMode type, float scale)
+{
+    if (im_YUV.empty() || im_YUV.device != IM_DD_CPU || !check_rgba_dst(im_RGB))
+        return false;
+    YUVSource s;
+    if (!s.setup(im_YUV.color_format, im_YUV.type, im_YUV.w, im_YUV.h, scale))
+        return false;
+    const size_t plane = (size_t)s.w * s.h;
+    s.y_data = s.u_data = s.v_data = im_YUV.data;
+    s.u_base = plane;
+    s.v_base = im_YUV.color_format == IM_CF_YUV444 ? plane * 2 : plane + (size_t)(s.w / s.uv_scale_w) * (s.h / s.uv_scale_h);
+    if (std::max(s.u_index(s.w - 1, s.h - 1), s.v_index(s.w - 1, s.h - 1)) >= im_YUV.total())
+        return false;
+    bool resize = im_RGB.w != im_YUV.w || im_RGB.h != im_YUV.h;
+    return yuv_to_rgba(s, im_YUV.color_space, im_YUV.color_range, im_YUV.dw, im_YUV.dh, resize, type, im_RGB);
+}
+
+bool ColorConvert_cpu::YUV2RGBA(const ImMat& im_Y, const ImMat& im_U, const ImMat& im_V, ImMat& im_RGB, ImInterpolateMode type, float scale)
+{
+    if (im_Y.empty() || im_U.empty() || im_Y.device != IM_DD_CPU || im_U.device != IM_DD_CPU || !check_rgba_dst(im_RGB))
+        return false;
+    YUVSource s;
+    if (!s.setup(im_Y.color_format, im_Y.type, im_Y.w, im_Y.h, scale))
+        return false;
+    if (im_U.type != im_Y.type || (!s.interleaved && (im_V.empty() || im_V.device != IM_DD_CPU || im_V.type != im_Y.type)))
+        return false;
+    s.y_data = im_Y.data;
+    s.u_data = im_U.data;
+    s.v_data = s.interleaved ? im_U.data : im_V.data;
+    if ((size_t)s.w * s.h > im_Y.total() || s.u_index(s.w - 1, s.h - 1) >= im_U.total() ||
+        s.v_index(s.w - 1, s.h - 1) >= (s.interleaved ? im_U.total() : im_V.total()))
+        return false;
+    bool resize = im_RGB.w != im_Y.w || im_RGB.h != im_Y.h || im_Y.dw != im_Y.w || im_Y.dh != im_Y.h;
+    return yuv_to_rgba(s, im_Y.color_space, im_Y.color_range, im_Y.dw, im_Y.dh, resize, type, im_RGB);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// RGB(A) source, same as load_rgba/load_rgb/load_gray in imvk_mat_shader.h
+////////////////////////////////////////////////////////////////////////////////
+// raw channel values of src(x0...x0+n, y), coordinates are clamped to source size
+static void load_rgba_row(const ImMat& src, const int map[4], int x0, int y, int n, float* R, float* G, float* B, float* A)
+{
+    y = std::min(y, src.h - 1);
+    const size_t cstep = src.c;
+    for (int i = 0; i < n; i++)
+    {
+        const int x = std::min(x0 + i, src.w - 1);
+        const size_t offset = ((size_t)y * src.w + x) * cstep;
+        R[i] = load_element(src.data, offset + map[0], src.type);
+        G[i] = load_element(src.data, offset + map[1], src.type);
+        B[i] = load_element(src.data, offset + map[2], src.type);
+        if (A) A[i] = load_element(src.data, offset + map[3], src.type);
+    }
+}
+
+static inline float rgb_load_scale(ImDataType type)
+{
+    return type == IM_DT_INT8 ? 255.f : is_int16_type(type) ? 65535.f : 1.f;
+}
+
+// uint(floor(v * scale)) as store_yuv_int16, P010 keeps 8bits value in low bits like shader does
+static inline uint16_t quantize_yuv_int16(float v, float scale, bool p010)
+{
+    if (p010)
+        return (uint16_t)((uint32_t)floorf(v * 255.f) | (uint32_t)floorf(v * 65535.f));
+    return (uint16_t)quantize(v, scale);
+}
+
+static void store_yuv_value(void* data, size_t index, float v, ImDataType type, float scale, bool p010)
+{
+    switch (type)
+    {
+        case IM_DT_INT8:     ((uint8_t *)data)[index] = (uint8_t)quantize(v, 255.f); break;
+        case IM_DT_INT16:    ((uint16_t *)data)[index] = quantize_yuv_int16(v, scale, p010); break;
+        case IM_DT_INT16_BE: ((uint16_t *)data)[index] = swap_16bit(quantize_yuv_int16(v, scale, p010)); break;
+        case IM_DT_FLOAT16:  ((uint16_t *)data)[index] = im_float32_to_float16(v); break;
+        case IM_DT_FLOAT32:  ((float *)data)[index] = v; break;
+        default: break;
+    }
+}
+
+static void store_y_row(void* data, size_t offset, const float* Y, int n, ImDataType type, float scale, bool p010)
+{
+    int i = 0;
+    if (type == IM_DT_INT8)
+    {
+        uint8_t* out = (uint8_t *)data + offset;
+#if __AVX2__
+        const __m256 s = _mm256_set1_ps(255.f), zero = _mm256_setzero_ps();
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i q = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_floor_ps(_mm256_mul_ps(_mm256_loadu_ps(Y + i), s)), zero), s));
+            __m128i w = _mm_packus_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+            _mm_storel_epi64((__m128i *)(out + i), _mm_packus_epi16(w, w));
+        }
+#elif __ARM_NEON && __aarch64__
+        const float32x4_t s = vdupq_n_f32(255.f), zero = vdupq_n_f32(0.f);
+        for (; i + 8 <= n; i += 8)
+        {
+            uint32x4_t q0 = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vrndmq_f32(vmulq_f32(vld1q_f32(Y + i), s)), zero), s));
+            uint32x4_t q1 = vcvtq_u32_f32(vminq_f32(vmaxq_f32(vrndmq_f32(vmulq_f32(vld1q_f32(Y + i + 4), s)), zero), s));
+            vst1_u8(out + i, vmovn_u16(vcombine_u16(vmovn_u32(q0), vmovn_u32(q1))));
+        }
+#endif
+        for (; i < n; i++)
+            out[i] = (uint8_t)quantize(Y[i], 255.f);
+        return;
+    }
+    for (; i < n; i++)
+        store_yuv_value(data, offset + i, Y[i], type, scale, p010);
+}
+
+bool ColorConvert_cpu::RGBA2YUV(const ImMat& im_RGB, ImMat& im_YUV, ImColorFormat color_format, ImColorSpace color_space, ImColorRange color_range, float scale)
+{
+    if (im_RGB.empty() || im_RGB.device != IM_DD_CPU || im_YUV.empty() || im_YUV.device != IM_DD_CPU)
+        return false;
+    if (color_space < IM_CS_SRGB || color_space > IM_CS_BT2020 || color_range < IM_CR_FULL_RANGE || color_range > IM_CR_NARROW_RANGE)
+        return false;
+    const ImDataType in_type = im_RGB.type, out_type = im_YUV.type;
+    if ((in_type != IM_DT_INT8 && !is_int16_type(in_type) && in_type != IM_DT_FLOAT16 && in_type != IM_DT_FLOAT32) ||
+        (out_type != IM_DT_INT8 && !is_int16_type(out_type) && out_type != IM_DT_FLOAT16 && out_type != IM_DT_FLOAT32))
+        return false;
+    int map[4];
+    color_format_mapping(im_RGB.color_format, map);
+
+    // same layout as store_dst_yuv
+    const int w = im_RGB.w, h = im_RGB.h;
+    const size_t out_cstep = im_YUV.cstep;
+    const int uv_scale_w = color_format == IM_CF_YUV420 || color_format == IM_CF_YUV422 ? 2 : 1;
+    const int uv_scale_h = color_format == IM_CF_YUV420 || color_format == IM_CF_NV12 ? 2 : 1;
+    const bool p010 = color_format == IM_CF_P010LE && is_int16_type(out_type);
+    const bool interleaved = color_format == IM_CF_NV12 || p010;
+    const size_t v_base = color_format == IM_CF_YUV444 ? out_cstep * 2 : out_cstep + (size_t)(w / uv_scale_w) * (h / uv_scale_h);
+    // every chroma sample is written by first pixel of its block
+    const int block_w = interleaved ? 2 : uv_scale_w;
+    const int block_h = interleaved ? 2 : uv_scale_h;
+    auto u_index = [&](int x, int y) -> size_t
+    {
+        if (interleaved)
+            return out_cstep + (size_t)(((y / 2) * w / 2 + x / 2) * 2);
+        return out_cstep + (size_t)((y / uv_scale_h) * w / uv_scale_w + x / uv_scale_w);
+    };
+    auto v_index = [&](int x, int y) -> size_t
+    {
+        if (interleaved)
+            return u_index(x, y) + 1;
+        return v_base + (size_t)((y / uv_scale_h) * w / uv_scale_w + x / uv_scale_w);
+    };
+    if ((size_t)w * h > im_YUV.total() || std::max(u_index(w - 1, h - 1), v_index(w - 1, h - 1)) >= im_YUV.total())
+        return false;
+
+    CSCParam param;
+    param.m = (const float *)color_table[1][color_range][color_space]->data;
+    param.offset[0] = color_range == IM_CR_NARROW_RANGE ? 16.0f / 255.0f : 0.f;
+    param.offset[1] = param.offset[2] = 0.5f;
+    param.scale[0] = param.scale[1] = param.scale[2] = rgb_load_scale(in_type);
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < h; y++)
+    {
+        float R[CPU_ROW_CHUNK], G[CPU_ROW_CHUNK], B[CPU_ROW_CHUNK];
+        float Y[CPU_ROW_CHUNK], U[CPU_ROW_CHUNK], V[CPU_ROW_CHUNK];
+        for (int x0 = 0; x0 < w; x0 += CPU_ROW_CHUNK)
+        {
+            const int n = std::min(CPU_ROW_CHUNK, w - x0);
+            load_rgba_row(im_RGB, map, x0, y, n, R, G, B, nullptr);
+            rgb_to_yuv_row(R, G, B, Y, U, V, n, param);
+            store_y_row(im_YUV.data, (size_t)y * w + x0, Y, n, out_type, scale, p010);
+            if (y % block_h != 0)
+                continue;
+            for (int i = (block_w - x0 % block_w) % block_w; i < n; i += block_w)
+            {
+                store_yuv_value(im_YUV.data, u_index(x0 + i, y), U[i], out_type, scale, p010);
+                store_yuv_value(im_YUV.data, v_index(x0 + i, y), V[i], out_type, scale, p010);
+            }
+        }
+    }
+    return true;
+}
+
+bool ColorConvert_cpu::GRAY2RGBA(const ImMat& im, ImMat& im_RGB, float scale)
+{
+    if (im.empty() || im.device != IM_DD_CPU || !check_rgba_dst(im_RGB))
+        return false;
+    if (im.type != IM_DT_INT8 && !is_int16_type(im.type) && im.type != IM_DT_FLOAT16 && im.type != IM_DT_FLOAT32)
+        return false;
+    if ((size_t)im.w * im.h > im.total())
+        return false;
+    const float divisor = im.type == IM_DT_FLOAT16 || im.type == IM_DT_FLOAT32 ? 1.f : scale;
+    const int out_w = im_RGB.w, out_h = im_RGB.h;
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < out_h; y++)
+    {
+        float L[CPU_ROW_CHUNK];
+        const size_t row = (size_t)std::min(y, im.h - 1) * im.w;
+        for (int x0 = 0; x0 < out_w; x0 += CPU_ROW_CHUNK)
+        {
+            const int n = std::min(CPU_ROW_CHUNK, out_w - x0);
+            for (int i = 0; i < n; i++)
+                L[i] = load_element(im.data, row + std::min(x0 + i, im.w - 1), im.type) / divisor;
+            store_rgba_row(L, L, L, nullptr, n, im_RGB, x0, y);
+        }
+    }
+    return true;
+}
+
+bool ColorConvert_cpu::Conv(const ImMat& im, ImMat& om)
+{
+    if (im.empty() || im.device != IM_DD_CPU || !check_rgba_dst(om))
+        return false;
+    if (im.type != IM_DT_INT8 && !is_int16_type(im.type) && im.type != IM_DT_FLOAT16 && im.type != IM_DT_FLOAT32)
+        return false;
+    if ((size_t)im.w * im.h * im.c > im.total())
+        return false;
+    int map[4];
+    color_format_mapping(im.color_format, map);
+    const bool has_alpha = im.color_format != IM_CF_BGR && im.color_format != IM_CF_RGB;
+    const float divisor = rgb_load_scale(im.type);
+    const int out_w = om.w, out_h = om.h;
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < out_h; y++)
+    {
+        float R[CPU_ROW_CHUNK], G[CPU_ROW_CHUNK], B[CPU_ROW_CHUNK], A[CPU_ROW_CHUNK];
+        for (int x0 = 0; x0 < out_w; x0 += CPU_ROW_CHUNK)
+        {
+            const int n = std::min(CPU_ROW_CHUNK, out_w - x0);
+            load_rgba_row(im, map, x0, y, n, R, G, B, has_alpha ? A : nullptr);
+            for (int i = 0; i < n; i++)
+            {
+                R[i] /= divisor;
+                G[i] /= divisor;
+                B[i] /= divisor;
+                if (has_alpha) A[i] /= divisor;
+            }
+            store_rgba_row(R, G, B, has_alpha ? A : nullptr, n, om, x0, y);
+        }
+    }
+    return true;
+}
+} // namespace ImGui
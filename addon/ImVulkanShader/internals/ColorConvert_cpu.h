@@ -0,0 +1,22 @@
+#pragma once
+#include "immat.h"
+#include "imvk_platform.h"
+
+namespace ImGui
+{
+// CPU implementation of ColorConvert shaders, used by ColorConvert_vulkan when there is no
+// vulkan device. Every function follows the math of its shader step by step, so output is
+// same as shader output. Rows are converted in parallel with AVX2/NEON row kernels.
+//
+// Destination mat must be created by caller with shader output layout, scale is maximum
+// integer value of source(or destination for RGBA2YUV) bit depth, like shader 'in_scale'.
+class VKSHADER_API ColorConvert_cpu
+{
+public:
+    static bool YUV2RGBA(const ImMat& im_YUV, ImMat& im_RGB, ImInterpolateMode type, float scale);
+    static bool YUV2RGBA(const ImMat& im_Y, const ImMat& im_U, const ImMat& im_V, ImMat& im_RGB, ImInterpolateMode type, float scale);
+    static bool RGBA2YUV(const ImMat& im_RGB, ImMat& im_YUV, ImColorFormat color_format, ImColorSpace color_space, ImColorRange color_range, float scale);
+    static bool GRAY2RGBA(const ImMat& im, ImMat& im_RGB, float scale);
+    static bool Conv(const ImMat& im, ImMat& om);
+};
+} // namespace ImGui
@@ -1,14 +1,25 @@
 #include <sstream>
 #include "ColorConvert_vulkan.h"
 #include "ColorConvert_shader.h"
+#include "ColorConvert_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
 {
 extern const ImMat * color_table[2][2][4];
+
+// maximum integer value of bit depth, shader 'in_scale'
+static inline float BitDepthScale(int depth, ImDataType type)
+{
+    int bitDepth = depth != 0 ? depth : type == IM_DT_INT8 ? 8 : type == IM_DT_INT16 || type == IM_DT_INT16_BE ? 16 : 8;
+    return bitDepth >= 32 ? 1.f : (float)((1 << bitDepth) - 1);
+}
+
 ColorConvert_vulkan::ColorConvert_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -76,7 +87,7 @@ ColorConvert_vulkan::~ColorConvert_vulkan()
 double ColorConvert_vulkan::ConvertColorFormat(const ImMat& srcMat, ImMat& dstMat, ImInterpolateMode type)
 {
     double ret = -1.0;
-    if (!vkdev || !pipeline_gray_rgb || !pipeline_yuv_rgb || !pipeline_rgb_yuv || !pipeline_conv)
+    if (vkdev && (!pipeline_gray_rgb || !pipeline_yuv_rgb || !pipeline_rgb_yuv || !pipeline_conv))
         return ret;
     if (dstMat.color_format < IM_CF_BGR)
     {
@@ -121,6 +132,33 @@ double ColorConvert_vulkan::ConvertColorFormat(const ImMat& srcMat, ImMat& dstMa
         dstMat.color_range = IM_CR_FULL_RANGE;
     }
 
+    if (!vkdev)
+    {
+        if (srcMat.device != IM_DD_CPU || dstMat.device != IM_DD_CPU)
+        {
+            mErrMsg = "Without vulkan device, only support cpu mat conversion!";
+            return ret;
+        }
+        ImMat tmp;
+        tmp.create_type(dstMat.w > 0 ? dstMat.w : srcMat.w, dstMat.h > 0 ? dstMat.h : srcMat.h, GetChannelCountByColorFormat(dstMat.color_format), dstMat.type);
+        tmp.copy_attribute(dstMat);
+        tmp.color_format = dstMat.color_format;
+        tmp.color_range = dstMat.color_range;
+        tmp.color_space = srcMat.color_space;
+        dstMat = tmp;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!UploadParam_cpu(srcMat, dstMat, type))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#else
+        ret = 1.f;
+#endif
+        return ret;
+    }
+
     // prepare source vulkan mat
     VkMat srcVkMat;
     if (srcMat.device == IM_DD_VULKAN)
@@ -344,6 +382,49 @@ bool ColorConvert_vulkan::UploadParam(const VkMat& src, VkMat& dst, ImInterpolat
     return true;
 }
 
+bool ColorConvert_vulkan::UploadParam_cpu(const ImMat& src, ImMat& dst, ImInterpolateMode type)
+{
+    int srcClrCatg = GetColorFormatCategory(src.color_format);
+    int dstClrCatg = GetColorFormatCategory(dst.color_format);
+    if (srcClrCatg < 0 || dstClrCatg < 0)
+    {
+        std::ostringstream oss;
+        oss << "Unknown color format category! 'src.color_format' is " << src.color_format
+            << ", 'dst.color_format' is " << dst.color_format << ".";
+        mErrMsg = oss.str();
+        return false;
+    }
+
+    bool ret = false;
+    // GRAY -> RGB
+    if (srcClrCatg == 0 && dstClrCatg == 1)
+        ret = ColorConvert_cpu::GRAY2RGBA(src, dst, BitDepthScale(src.depth, src.type));
+    // YUV -> RGB
+    else if (srcClrCatg == 2 && dstClrCatg == 1)
+        ret = ColorConvert_cpu::YUV2RGBA(src, dst, type, BitDepthScale(src.depth, src.type));
+    // RGB -> YUV
+    else if (srcClrCatg == 1 && dstClrCatg == 2)
+        ret = ColorConvert_cpu::RGBA2YUV(src, dst, dst.color_format, dst.color_space, dst.color_range, BitDepthScale(dst.depth, dst.type));
+    // conversion in same color format category
+    else if (srcClrCatg == dstClrCatg)
+        ret = ColorConvert_cpu::Conv(src, dst);
+    else
+    {
+        std::ostringstream oss;
+        oss << "UNSUPPORTED color format conversion! From " << src.color_format << " to " << dst.color_format << ".";
+        mErrMsg = oss.str();
+        return false;
+    }
+
+    if (!ret)
+    {
+        std::ostringstream oss;
+        oss << "CPU color format conversion failed! From " << src.color_format << " to " << dst.color_format << ".";
+        mErrMsg = oss.str();
+    }
+    return ret;
+}
+
 // YUV to RGBA functions
 void ColorConvert_vulkan::upload_param(const VkMat& Im_YUV, VkMat& dst, ImInterpolateMode type, ImColorFormat color_format, ImColorSpace color_space, ImColorRange color_range, int video_depth) const
 {
@@ -391,7 +472,30 @@ void ColorConvert_vulkan::upload_param(const VkMat& Im_YUV, VkMat& dst, ImInterp
 double ColorConvert_vulkan::YUV2RGBA(const ImMat& im_YUV, ImMat & im_RGB, ImInterpolateMode type) const
 {
     double ret = -1.f;
-    if (!vkdev || !pipeline_yuv_rgb || !cmd)
+    if (!vkdev)
+    {
+        if (im_YUV.device != IM_DD_CPU || im_RGB.device != IM_DD_CPU)
+            return ret;
+        ImMat dst;
+        dst.create_type(im_RGB.w > 0 ? im_RGB.w : im_YUV.w, im_RGB.h > 0 ? im_RGB.h : im_YUV.h, 4, im_RGB.type);
+        dst.copy_attribute(im_YUV);
+        dst.color_format = im_RGB.color_format;
+        dst.color_range = IM_CR_FULL_RANGE;
+        dst.color_space = im_YUV.color_space;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!ColorConvert_cpu::YUV2RGBA(im_YUV, dst, type, BitDepthScale(im_YUV.depth, im_YUV.type)))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#else
+        ret = 1.f;
+#endif
+        im_RGB = dst;
+        return ret;
+    }
+    if (!pipeline_yuv_rgb || !cmd)
     {
         return ret;
     }
@@ -499,7 +603,30 @@ void ColorConvert_vulkan::upload_param(const VkMat& Im_Y, const VkMat& Im_U, con
 double ColorConvert_vulkan::YUV2RGBA(const ImMat& im_Y, const ImMat& im_U, const ImMat& im_V, ImMat & im_RGB, ImInterpolateMode type) const
 {
     double ret = -1.f;
-    if (!vkdev || !pipeline_y_u_v_rgb || !cmd)
+    if (!vkdev)
+    {
+        if (im_Y.device != IM_DD_CPU || im_U.device != IM_DD_CPU || (!im_V.empty() && im_V.device != IM_DD_CPU) || im_RGB.device != IM_DD_CPU)
+            return ret;
+        ImMat dst;
+        dst.create_type(im_RGB.w > 0 ? im_RGB.w : im_Y.w, im_RGB.h > 0 ? im_RGB.h : im_Y.h, 4, im_RGB.type);
+        dst.copy_attribute(im_Y);
+        dst.color_format = im_RGB.color_format;
+        dst.color_range = IM_CR_FULL_RANGE;
+        dst.color_space = im_Y.color_space;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!ColorConvert_cpu::YUV2RGBA(im_Y, im_U, im_V, dst, type, BitDepthScale(im_Y.depth, im_Y.type)))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#else
+        ret = 1.f;
+#endif
+        im_RGB = dst;
+        return ret;
+    }
+    if (!pipeline_y_u_v_rgb || !cmd)
     {
         return ret;
     }
@@ -608,7 +735,30 @@ void ColorConvert_vulkan::upload_param(const VkMat& Im_RGB, VkMat& dst, ImColorF
 double ColorConvert_vulkan::RGBA2YUV(const ImMat& im_RGB, ImMat & im_YUV) const
 {
     double ret = -1.f;
-    if (!vkdev || !pipeline_rgb_yuv || !cmd)
+    if (!vkdev)
+    {
+        if (im_RGB.device != IM_DD_CPU || im_YUV.device != IM_DD_CPU)
+            return ret;
+        ImMat dst;
+        dst.create_type(im_RGB.w, im_RGB.h, 4, im_YUV.type);
+        dst.copy_attribute(im_RGB);
+        dst.color_format = im_YUV.color_format;
+        dst.color_space = im_YUV.color_space;
+        dst.color_range = im_YUV.color_range;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!ColorConvert_cpu::RGBA2YUV(im_RGB, dst, im_YUV.color_format, im_YUV.color_space, im_YUV.color_range, BitDepthScale(im_YUV.depth, im_YUV.type)))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#else
+        ret = 1.f;
+#endif
+        im_YUV = dst;
+        return ret;
+    }
+    if (!pipeline_rgb_yuv || !cmd)
     {
         return ret;
     }
@@ -683,7 +833,28 @@ void ColorConvert_vulkan::upload_param(const VkMat& Im, VkMat& dst, ImColorSpace
 double ColorConvert_vulkan::GRAY2RGBA(const ImMat& im, ImMat & im_RGB, ImColorSpace color_space, ImColorRange color_range, int video_depth, int video_shift) const
 {
     double ret = -1.f;
-    if (!vkdev || !pipeline_gray_rgb || !cmd)
+    if (!vkdev)
+    {
+        if (im.device != IM_DD_CPU || im_RGB.device != IM_DD_CPU)
+            return ret;
+        ImMat dst;
+        // same as shader path, output is stored as ABGR
+        dst.create_type(im.w, im.h, 4, im_RGB.type);
+        dst.copy_attribute(im);
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!ColorConvert_cpu::GRAY2RGBA(im, dst, BitDepthScale(video_shift, im.type)))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#else
+        ret = 1.f;
+#endif
+        im_RGB = dst;
+        return ret;
+    }
+    if (!pipeline_gray_rgb || !cmd)
     {
         return ret;
     }
@@ -757,7 +928,28 @@ void ColorConvert_vulkan::upload_param(const VkMat& Im, VkMat& dst) const
 double ColorConvert_vulkan::Conv(const ImMat& im, ImMat & om) const
 {
     double ret = -1.f;
-    if (!vkdev || !pipeline_conv || !cmd)
+    if (!vkdev)
+    {
+        if (im.device != IM_DD_CPU || om.device != IM_DD_CPU)
+            return ret;
+        // same as shader path, output is stored as ABGR
+        ImMat dst;
+        dst.create_type(im.w, im.h, 4, om.type);
+        dst.copy_attribute(im);
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!ColorConvert_cpu::Conv(im, dst))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#else
+        ret = 1.f;
+#endif
+        om = dst;
+        return ret;
+    }
+    if (!pipeline_conv || !cmd)
     {
         return ret;
     }
@@ -8,6 +8,8 @@ namespace ImGui
 class VKSHADER_API ColorConvert_vulkan
 {
 public:
+    // without vulkan device every conversion falls back to ColorConvert_cpu,
+    // source and destination mats must be cpu mats in that case
     ColorConvert_vulkan(int gpu = -1);
     ~ColorConvert_vulkan();
 
@@ -39,6 +41,7 @@ private:
     void upload_param(const VkMat& Im, VkMat& dst) const;
 
     bool UploadParam(const VkMat& src, VkMat& dst, ImInterpolateMode type);
+    bool UploadParam_cpu(const ImMat& src, ImMat& dst, ImInterpolateMode type);
 
     std::string mErrMsg;
 };
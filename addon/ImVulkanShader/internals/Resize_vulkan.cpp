@@ -1,5 +1,6 @@
 #include "Resize_vulkan.h"
 #include "Resize_shader.h"
+#include "Warp_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
@@ -7,6 +8,8 @@ namespace ImGui
 Resize_vulkan::Resize_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -68,11 +71,6 @@ void Resize_vulkan::upload_param(const VkMat& src, VkMat& dst, ImInterpolateMode
 double Resize_vulkan::Resize(const ImMat& src, ImMat& dst, float fx, float fy, ImInterpolateMode type) const
 {
     double ret = 0.0;
-    if (!vkdev || !pipe || !cmd)
-    {
-        return ret;
-    }
-
     int dst_width = dst.w;
     if (dst_width <= 0)
         dst_width = fx <= 0.f ? src.w : src.w * fx;
@@ -81,6 +79,29 @@ double Resize_vulkan::Resize(const ImMat& src, ImMat& dst, float fx, float fy, I
         dst_height = fy <= 0.f ? (fx <= 0.f ? src.h : src.h * fx) : src.h * fy;
     auto color_format = dst.color_format;
     int channels = IM_ISALPHA(color_format) ? 4 : IM_ISRGB(color_format) ? 3 : IM_ISMONO(color_format) ? 1 : 4;
+    if (!vkdev)
+    {
+        // no vulkan device, resize on cpu
+        if (src.device != IM_DD_CPU)
+            return ret;
+        ImMat dst_cpu;
+        dst_cpu.create_type(dst_width, dst_height, channels, dst.type);
+        dst_cpu.color_format = color_format;
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Warp_cpu::Resize(src, dst_cpu, type))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst = dst_cpu;
+        dst.copy_attribute(src);
+        return ret;
+    }
+    if (!pipe || !cmd)
+        return ret;
+
     VkMat dst_gpu;
     dst_gpu.create_type(dst_width, dst_height, channels, dst.type, opt.blob_vkallocator);
     dst_gpu.color_format = color_format;
@@ -0,0 +1,840 @@
+#include "Warp_cpu.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// Destination rows of one resize task, every task fills its own ring of horizontal rows
+#define RESIZE_BAND_ROWS 32
+// Fixed point of 8 bits resize coefficients, same as MatResize of imgui_helper
+#define RESIZE_COEF_BITS 11
+#define RESIZE_COEF_SCALE (1 << RESIZE_COEF_BITS)
+// Destination tile of warps, source area read by a tile stays compact for any rotation
+#define WARP_TILE_SIZE 64
+// Sub pixel grid and fixed point of warps, same as warp shaders
+#define INTER_BITS 5
+#define INTER_TAB_SIZE (1 << INTER_BITS)
+#define AB_BITS 10
+#define AB_SCALE (1 << AB_BITS)
+#define ROUND_DELTA (1 << (AB_BITS - INTER_BITS - 1))
+#define INTER_REMAP_COEF_BITS 15
+#define INTER_REMAP_COEF_SCALE (1 << INTER_REMAP_COEF_BITS)
+
+namespace ImGui
+{
+// same as shader color_format_mapping_vec4, 3 channels formats keep rgb order of their own
+static inline void color_format_mapping(ImColorFormat format, int map[4])
+{
+    switch (format)
+    {
+        case IM_CF_ABGR: case IM_CF_BGR: map[0] = 0; map[1] = 1; map[2] = 2; map[3] = 3; break;
+        case IM_CF_ARGB: case IM_CF_RGB: map[0] = 2; map[1] = 1; map[2] = 0; map[3] = 3; break;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; map[3] = 0; break;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; map[3] = 0; break;
+        default: map[0] = map[1] = map[2] = map[3] = 0; break;
+    }
+}
+
+static inline bool is_supported(const ImMat& mat)
+{
+    return !mat.empty() && mat.device == IM_DD_CPU && (mat.c == 1 || mat.c == 3 || mat.c == 4) &&
+            (mat.type == IM_DT_INT8 || mat.type == IM_DT_INT16 || mat.type == IM_DT_FLOAT32);
+}
+
+// same type, channels and channel order, transform writes dst directly
+static bool same_layout(const ImMat& src, const ImMat& dst)
+{
+    if (src.type != dst.type || src.c != dst.c)
+        return false;
+    int src_map[4], dst_map[4];
+    color_format_mapping(src.color_format, src_map);
+    color_format_mapping(dst.color_format, dst_map);
+    return src.c == 1 || std::equal(src_map, src_map + src.c, dst_map);
+}
+
+// transform output, dst itself when it has source layout, else a mat of source layout and dst size
+static ImMat output_of(const ImMat& src, ImMat& dst)
+{
+    if (same_layout(src, dst))
+        return dst;
+    ImMat out;
+    out.create_type(dst.w, dst.h, src.c, src.type);
+    out.color_format = src.color_format;
+    return out;
+}
+
+static inline int pixel_bytes(const ImMat& mat)
+{
+    return mat.c * (mat.type == IM_DT_INT8 ? 1 : mat.type == IM_DT_INT16 ? 2 : 4);
+}
+
+static inline int32_t load_u32(const void* p)
+{
+    int32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store_u32(void* p, int32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+// unit float into channel value, uint(floor(v * scale)) as shader store functions
+static inline void from_unit(float v, uint8_t& o) { o = (uint8_t)std::min(std::max(floorf(v * 255.f), 0.f), 255.f); }
+static inline void from_unit(float v, uint16_t& o) { o = (uint16_t)std::min(std::max(floorf(v * 65535.f), 0.f), 65535.f); }
+static inline void from_unit(float v, float& o) { o = std::min(std::max(v, 0.f), 1.f); }
+static inline float to_unit(uint8_t v) { return (float)v / 255.f; }
+static inline float to_unit(uint16_t v) { return (float)v / 65535.f; }
+static inline float to_unit(float v) { return v; }
+
+template<typename S, typename D>
+static void convert_rows(const ImMat& src, ImMat& dst)
+{
+    int src_map[4], dst_map[4];
+    color_format_mapping(src.color_format, src_map);
+    color_format_mapping(dst.color_format, dst_map);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < dst.h; y++)
+    {
+        const S* s = (const S *)src.data + (size_t)y * src.w * src.c;
+        D* d = (D *)dst.data + (size_t)y * dst.w * dst.c;
+        for (int x = 0; x < dst.w; x++, s += src.c, d += dst.c)
+        {
+            float rgba[4];
+            for (int k = 0; k < 3; k++)
+                rgba[k] = to_unit(s[src_map[k] < src.c ? src_map[k] : 0]);
+            rgba[3] = src.c == 4 ? to_unit(s[src_map[3]]) : 1.f;
+            for (int k = 0; k < dst.c; k++)
+                from_unit(rgba[k], d[dst_map[k]]);
+        }
+    }
+}
+
+template<typename S>
+static void convert_to(const ImMat& src, ImMat& dst)
+{
+    switch (dst.type)
+    {
+        case IM_DT_INT8: convert_rows<S, uint8_t>(src, dst); break;
+        case IM_DT_INT16: convert_rows<S, uint16_t>(src, dst); break;
+        case IM_DT_FLOAT32: convert_rows<S, float>(src, dst); break;
+        default: break;
+    }
+}
+
+// src and dst of same size, dst takes its own type, channels and channel order
+static void convert_layout(const ImMat& src, ImMat& dst)
+{
+    switch (src.type)
+    {
+        case IM_DT_INT8: convert_to<uint8_t>(src, dst); break;
+        case IM_DT_INT16: convert_to<uint16_t>(src, dst); break;
+        case IM_DT_FLOAT32: convert_to<float>(src, dst); break;
+        default: break;
+    }
+}
+
+// fixed point weights sum to scale exactly, rounding error goes to the largest weight
+static void quantize_weights(const float* weights, int32_t* iweights, int n, int scale)
+{
+    int sum = 0, big = 0;
+    for (int k = 0; k < n; k++)
+    {
+        iweights[k] = (int32_t)lrintf(weights[k] * scale);
+        sum += iweights[k];
+        if (fabsf(weights[k]) > fabsf(weights[big]))
+            big = k;
+    }
+    iweights[big] += scale - sum;
+}
+
+// bicubic weights of A = -0.75 as shaders
+static inline void cubic_coeffs(float x, float coeffs[4])
+{
+    const float A = -0.75f;
+    coeffs[0] = ((A * (x + 1.f) - 5.f * A) * (x + 1.f) + 8.f * A) * (x + 1.f) - 4.f * A;
+    coeffs[1] = ((A + 2.f) * x - (A + 3.f)) * x * x + 1.f;
+    coeffs[2] = ((A + 2.f) * (1.f - x) - (A + 3.f)) * (1.f - x) * (1.f - x) + 1.f;
+    coeffs[3] = 1.f - coeffs[0] - coeffs[1] - coeffs[2];
+}
+
+// Coefficients of one resize axis, output i reads ksize source items from ofs[i] with weights
+// alpha[i * ksize + k], ialpha in RESIZE_COEF_BITS fixed point. Taps out of source are folded into
+// edge items, so every window is contiguous and inside source.
+struct AxisTable
+{
+    int ksize {0};
+    std::vector<int> ofs;
+    std::vector<float> alpha;
+    std::vector<int32_t> ialpha;
+};
+
+// taps of output i before folding, returns count, first is source index of weights[0]
+static int axis_taps(int i, int src_n, double scale, ImInterpolateMode type, float* weights, int& first)
+{
+    switch (type)
+    {
+        case IM_INTERPOLATE_BILINEAR:
+        {
+            const double s = i * scale;
+            first = (int)floor(s);
+            weights[1] = (float)(s - first);
+            weights[0] = 1.f - weights[1];
+            return 2;
+        }
+        case IM_INTERPOLATE_BICUBIC:
+        {
+            const double s = (i + 0.5) * scale - 0.5;
+            const int sx = (int)floor(s);
+            first = sx - 1;
+            cubic_coeffs((float)(s - sx), weights);
+            return 4;
+        }
+        case IM_INTERPOLATE_AREA:
+        {
+            if (scale > 1.0)
+            {
+                // coverage of source items by [i, i + 1) of output
+                const double s0 = i * scale, s1 = std::min(s0 + scale, (double)src_n);
+                first = (int)floor(s0);
+                const int last = std::min((int)ceil(s1), src_n) - 1;
+                int n = 0;
+                for (int k = first; k <= last; k++)
+                    weights[n++] = (float)((std::min(s1, k + 1.0) - std::max(s0, (double)k)) / (s1 - s0));
+                return n;
+            }
+            const int sx = (int)floor(i * scale);
+            double f = (i + 1) - (sx + 1) / scale;
+            f = f <= 0 ? 0 : f - floor(f);
+            first = sx;
+            weights[0] = (float)(1.0 - f);
+            weights[1] = (float)f;
+            return 2;
+        }
+        default:
+        {
+            first = std::min((int)floor(i * scale), src_n - 1);
+            weights[0] = 1.f;
+            return 1;
+        }
+    }
+}
+
+static void build_axis(AxisTable& table, int src_n, int dst_n, ImInterpolateMode type)
+{
+    const double scale = (double)src_n / dst_n;
+    const int max_taps = type == IM_INTERPOLATE_AREA ? (scale > 1.0 ? (int)ceil(scale) + 1 : 2) :
+                        type == IM_INTERPOLATE_BICUBIC ? 4 : type == IM_INTERPOLATE_BILINEAR ? 2 : 1;
+    const int ksize = std::min(max_taps, src_n);
+    table.ksize = ksize;
+    table.ofs.resize(dst_n);
+    table.alpha.assign((size_t)dst_n * ksize, 0.f);
+    table.ialpha.resize((size_t)dst_n * ksize);
+    std::vector<float> weights(max_taps + 1);
+    for (int i = 0; i < dst_n; i++)
+    {
+        int first = 0;
+        const int n = axis_taps(i, src_n, scale, type, weights.data(), first);
+        const int start = std::min(std::max(first, 0), src_n - ksize);
+        float* alpha = &table.alpha[(size_t)i * ksize];
+        for (int k = 0; k < n; k++)
+            alpha[std::min(std::max(first + k, 0), src_n - 1) - start] += weights[k];
+        table.ofs[i] = start;
+        quantize_weights(alpha, &table.ialpha[(size_t)i * ksize], ksize, RESIZE_COEF_SCALE);
+    }
+}
+
+#if __AVX2__
+static inline __m128 load_px4(const float* p) { return _mm_loadu_ps(p); }
+static inline __m128 load_px4(const uint16_t* p) { return _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)p))); }
+static inline void store_px4(__m128 v, float* p) { _mm_storeu_ps(p, _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f))); }
+static inline void store_px4(__m128 v, uint16_t* p) { const __m128i i = _mm_cvtps_epi32(v); _mm_storel_epi64((__m128i *)p, _mm_packus_epi32(i, i)); }
+#elif __ARM_NEON && __aarch64__
+static inline float32x4_t load_px4(const float* p) { return vld1q_f32(p); }
+static inline float32x4_t load_px4(const uint16_t* p) { return vcvtq_f32_u32(vmovl_u16(vld1_u16(p))); }
+static inline void store_px4(float32x4_t v, float* p) { vst1q_f32(p, vminq_f32(vmaxq_f32(v, vdupq_n_f32(0.f)), vdupq_n_f32(1.f))); }
+static inline void store_px4(float32x4_t v, uint16_t* p) { vst1_u16(p, vqmovun_s32(vcvtnq_s32_f32(v))); }
+static inline int32x4_t load_u8x4(const uint8_t* p) { return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_s32(vdup_n_s32(load_u32(p))))))); }
+#endif
+
+// float result into channel value, uint16 rounds as fixed point paths
+static inline void store_value(float v, uint16_t& o) { o = (uint16_t)std::min(std::max(lrintf(v), 0L), 65535L); }
+static inline void store_value(float v, float& o) { o = std::min(std::max(v, 0.f), 1.f); }
+
+// horizontal pass of 8 bits row, sums in RESIZE_COEF_BITS fixed point
+static void hresize_row(const uint8_t* src, int32_t* dst, int dst_w, int cn, const AxisTable& xt)
+{
+    const int ksize = xt.ksize;
+    int x = 0;
+    if (cn == 4)
+    {
+#if __AVX2__
+        // 2 taps at once, channels of 2 pixels interleaved into 16 bits pairs for madd
+        const __m128i interleave = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+        for (; x < dst_w; x++)
+        {
+            const uint8_t* s = src + (size_t)xt.ofs[x] * 4;
+            const int32_t* alpha = &xt.ialpha[(size_t)x * ksize];
+            __m128i acc = _mm_setzero_si128();
+            int k = 0;
+            for (; k + 2 <= ksize; k += 2)
+            {
+                const __m128i px = _mm_cvtepu8_epi16(_mm_shuffle_epi8(_mm_loadl_epi64((const __m128i *)(s + k * 4)), interleave));
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(px, _mm_set1_epi32((int32_t)(((uint32_t)alpha[k + 1] << 16) | (uint16_t)alpha[k]))));
+            }
+            if (k < ksize)
+                acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(load_u32(s + k * 4))), _mm_set1_epi32(alpha[k])));
+            _mm_storeu_si128((__m128i *)(dst + (size_t)x * 4), acc);
+        }
+#elif __ARM_NEON && __aarch64__
+        for (; x < dst_w; x++)
+        {
+            const uint8_t* s = src + (size_t)xt.ofs[x] * 4;
+            const int32_t* alpha = &xt.ialpha[(size_t)x * ksize];
+            int32x4_t acc = vdupq_n_s32(0);
+            for (int k = 0; k < ksize; k++)
+                acc = vmlaq_n_s32(acc, load_u8x4(s + k * 4), alpha[k]);
+            vst1q_s32(dst + (size_t)x * 4, acc);
+        }
+#endif
+    }
+    for (; x < dst_w; x++)
+    {
+        const uint8_t* s = src + (size_t)xt.ofs[x] * cn;
+        const int32_t* alpha = &xt.ialpha[(size_t)x * ksize];
+        for (int c = 0; c < cn; c++)
+        {
+            int32_t sum = 0;
+            for (int k = 0; k < ksize; k++)
+                sum += s[k * cn + c] * alpha[k];
+            dst[(size_t)x * cn + c] = sum;
+        }
+    }
+}
+
+// horizontal pass of 16 bits and float rows, sums in float of source scale
+template<typename T>
+static void hresize_row(const T* src, float* dst, int dst_w, int cn, const AxisTable& xt)
+{
+    const int ksize = xt.ksize;
+    int x = 0;
+    if (cn == 4)
+    {
+#if __AVX2__
+        for (; x < dst_w; x++)
+        {
+            const T* s = src + (size_t)xt.ofs[x] * 4;
+            const float* alpha = &xt.alpha[(size_t)x * ksize];
+            __m128 acc = _mm_setzero_ps();
+            for (int k = 0; k < ksize; k++)
+                acc = _mm_add_ps(acc, _mm_mul_ps(load_px4(s + k * 4), _mm_set1_ps(alpha[k])));
+            _mm_storeu_ps(dst + (size_t)x * 4, acc);
+        }
+#elif __ARM_NEON && __aarch64__
+        for (; x < dst_w; x++)
+        {
+            const T* s = src + (size_t)xt.ofs[x] * 4;
+            const float* alpha = &xt.alpha[(size_t)x * ksize];
+            float32x4_t acc = vdupq_n_f32(0.f);
+            for (int k = 0; k < ksize; k++)
+                acc = vmlaq_n_f32(acc, load_px4(s + k * 4), alpha[k]);
+            vst1q_f32(dst + (size_t)x * 4, acc);
+        }
+#endif
+    }
+    for (; x < dst_w; x++)
+    {
+        const T* s = src + (size_t)xt.ofs[x] * cn;
+        const float* alpha = &xt.alpha[(size_t)x * ksize];
+        for (int c = 0; c < cn; c++)
+        {
+            float sum = 0.f;
+            for (int k = 0; k < ksize; k++)
+                sum += s[k * cn + c] * alpha[k];
+            dst[(size_t)x * cn + c] = sum;
+        }
+    }
+}
+
+// vertical pass of 8 bits, weights of both passes make 2 * RESIZE_COEF_BITS fixed point
+static void vresize_row(const int32_t* const* rows, const AxisTable& yt, int y, uint8_t* dst, int n)
+{
+    const int ksize = yt.ksize;
+    const int32_t* beta = &yt.ialpha[(size_t)y * ksize];
+    const int32_t delta = 1 << (RESIZE_COEF_BITS * 2 - 1);
+    int i = 0;
+#if __AVX2__
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i acc = _mm256_set1_epi32(delta);
+        for (int k = 0; k < ksize; k++)
+            acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(rows[k] + i)), _mm256_set1_epi32(beta[k])));
+        acc = _mm256_srai_epi32(acc, RESIZE_COEF_BITS * 2);
+        const __m128i v16 = _mm_packs_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        _mm_storel_epi64((__m128i *)(dst + i), _mm_packus_epi16(v16, v16));
+    }
+#elif __ARM_NEON && __aarch64__
+    for (; i + 8 <= n; i += 8)
+    {
+        int32x4_t acc0 = vdupq_n_s32(delta), acc1 = vdupq_n_s32(delta);
+        for (int k = 0; k < ksize; k++)
+        {
+            acc0 = vmlaq_n_s32(acc0, vld1q_s32(rows[k] + i), beta[k]);
+            acc1 = vmlaq_n_s32(acc1, vld1q_s32(rows[k] + i + 4), beta[k]);
+        }
+        const int16x8_t v16 = vcombine_s16(vqmovn_s32(vshrq_n_s32(acc0, RESIZE_COEF_BITS * 2)), vqmovn_s32(vshrq_n_s32(acc1, RESIZE_COEF_BITS * 2)));
+        vst1_u8(dst + i, vqmovun_s16(v16));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        int32_t acc = delta;
+        for (int k = 0; k < ksize; k++)
+            acc += rows[k][i] * beta[k];
+        dst[i] = (uint8_t)std::min(std::max(acc >> (RESIZE_COEF_BITS * 2), 0), 255);
+    }
+}
+
+// vertical pass of 16 bits and float rows
+template<typename T>
+static void vresize_row(const float* const* rows, const AxisTable& yt, int y, T* dst, int n)
+{
+    const int ksize = yt.ksize;
+    const float* beta = &yt.alpha[(size_t)y * ksize];
+    int i = 0;
+#if __AVX2__
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < ksize; k++)
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(rows[k] + i), _mm256_set1_ps(beta[k])));
+        store_px4(_mm256_castps256_ps128(acc), dst + i);
+        store_px4(_mm256_extractf128_ps(acc, 1), dst + i + 4);
+    }
+#elif __ARM_NEON && __aarch64__
+    for (; i + 8 <= n; i += 8)
+    {
+        float32x4_t acc0 = vdupq_n_f32(0.f), acc1 = vdupq_n_f32(0.f);
+        for (int k = 0; k < ksize; k++)
+        {
+            acc0 = vmlaq_n_f32(acc0, vld1q_f32(rows[k] + i), beta[k]);
+            acc1 = vmlaq_n_f32(acc1, vld1q_f32(rows[k] + i + 4), beta[k]);
+        }
+        store_px4(acc0, dst + i);
+        store_px4(acc1, dst + i + 4);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        float acc = 0.f;
+        for (int k = 0; k < ksize; k++)
+            acc += rows[k][i] * beta[k];
+        store_value(acc, dst[i]);
+    }
+}
+
+// Bands of destination rows in parallel, source rows needed by a band are resized horizontally
+// once into a ring of ksize rows, slot of source row sy is sy % ksize.
+template<typename T, typename WT>
+static void resize_separable(const ImMat& src, ImMat& dst, const AxisTable& xt, const AxisTable& yt)
+{
+    const int cn = src.c;
+    const int row_len = dst.w * cn;
+    const int ksize = yt.ksize;
+    const int bands = (dst.h + RESIZE_BAND_ROWS - 1) / RESIZE_BAND_ROWS;
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int b = 0; b < bands; b++)
+    {
+        std::vector<WT> ring((size_t)ksize * row_len);
+        std::vector<int> ring_row(ksize, -1);
+        std::vector<const WT*> rows(ksize);
+        const int y1 = std::min((b + 1) * RESIZE_BAND_ROWS, dst.h);
+        for (int y = b * RESIZE_BAND_ROWS; y < y1; y++)
+        {
+            for (int k = 0; k < ksize; k++)
+            {
+                const int sy = yt.ofs[y] + k, slot = sy % ksize;
+                WT* row = ring.data() + (size_t)slot * row_len;
+                if (ring_row[slot] != sy)
+                {
+                    hresize_row((const T *)src.data + (size_t)sy * src.w * cn, row, dst.w, cn, xt);
+                    ring_row[slot] = sy;
+                }
+                rows[k] = row;
+            }
+            vresize_row(rows.data(), yt, y, (T *)dst.data + (size_t)y * row_len, row_len);
+        }
+    }
+}
+
+template<int N> struct PixelBytes { uint8_t b[N]; };
+
+template<int N>
+static void resize_nearest(const ImMat& src, ImMat& dst, const AxisTable& xt, const AxisTable& yt)
+{
+    typedef PixelBytes<N> Pixel;
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < dst.h; y++)
+    {
+        const Pixel* s = (const Pixel *)src.data + (size_t)yt.ofs[y] * src.w;
+        Pixel* d = (Pixel *)dst.data + (size_t)y * dst.w;
+        for (int x = 0; x < dst.w; x++)
+            d[x] = s[xt.ofs[x]];
+    }
+}
+
+bool Warp_cpu::Resize(const ImMat& src, ImMat& dst, ImInterpolateMode type)
+{
+    if (!is_supported(src) || !is_supported(dst))
+        return false;
+    if (src.w == dst.w && src.h == dst.h)
+    {
+        if (same_layout(src, dst))
+            memcpy(dst.data, src.data, (size_t)src.w * src.h * pixel_bytes(src));
+        else
+            convert_layout(src, dst);
+        return true;
+    }
+    // shader falls back to nearest for other modes
+    if (type != IM_INTERPOLATE_BILINEAR && type != IM_INTERPOLATE_BICUBIC && type != IM_INTERPOLATE_AREA)
+        type = IM_INTERPOLATE_NEAREST;
+    ImMat out = output_of(src, dst);
+    if (out.empty())
+        return false;
+    AxisTable xt, yt;
+    build_axis(xt, src.w, out.w, type);
+    build_axis(yt, src.h, out.h, type);
+    if (type == IM_INTERPOLATE_NEAREST)
+    {
+        switch (pixel_bytes(src))
+        {
+            case 1: resize_nearest<1>(src, out, xt, yt); break;
+            case 2: resize_nearest<2>(src, out, xt, yt); break;
+            case 3: resize_nearest<3>(src, out, xt, yt); break;
+            case 4: resize_nearest<4>(src, out, xt, yt); break;
+            case 6: resize_nearest<6>(src, out, xt, yt); break;
+            case 8: resize_nearest<8>(src, out, xt, yt); break;
+            case 12: resize_nearest<12>(src, out, xt, yt); break;
+            case 16: resize_nearest<16>(src, out, xt, yt); break;
+            default: break;
+        }
+    }
+    else
+    {
+        switch (src.type)
+        {
+            case IM_DT_INT8: resize_separable<uint8_t, int32_t>(src, out, xt, yt); break;
+            case IM_DT_INT16: resize_separable<uint16_t, float>(src, out, xt, yt); break;
+            case IM_DT_FLOAT32: resize_separable<float, float>(src, out, xt, yt); break;
+            default: break;
+        }
+    }
+    if (out.data != dst.data)
+        convert_layout(out, dst);
+    return true;
+}
+
+// Interpolation weights of every 1/INTER_TAB_SIZE sub pixel position of warps, index is
+// ay * INTER_TAB_SIZE + ax, fixed point weights of a position sum to INTER_REMAP_COEF_SCALE.
+struct WarpTables
+{
+    float linear[INTER_TAB_SIZE * INTER_TAB_SIZE][4];
+    float cubic[INTER_TAB_SIZE * INTER_TAB_SIZE][16];
+    int32_t ilinear[INTER_TAB_SIZE * INTER_TAB_SIZE][4];
+    int32_t icubic[INTER_TAB_SIZE * INTER_TAB_SIZE][16];
+
+    WarpTables()
+    {
+        for (int ay = 0; ay < INTER_TAB_SIZE; ay++)
+        for (int ax = 0; ax < INTER_TAB_SIZE; ax++)
+        {
+            const int pos = ay * INTER_TAB_SIZE + ax;
+            const float fx = (float)ax / INTER_TAB_SIZE, fy = (float)ay / INTER_TAB_SIZE;
+            const float lx[2] = {1.f - fx, fx}, ly[2] = {1.f - fy, fy};
+            float cx[4], cy[4];
+            cubic_coeffs(fx, cx);
+            cubic_coeffs(fy, cy);
+            for (int j = 0; j < 2; j++)
+                for (int k = 0; k < 2; k++)
+                    linear[pos][j * 2 + k] = ly[j] * lx[k];
+            for (int j = 0; j < 4; j++)
+                for (int k = 0; k < 4; k++)
+                    cubic[pos][j * 4 + k] = cy[j] * cx[k];
+            quantize_weights(linear[pos], ilinear[pos], 4, INTER_REMAP_COEF_SCALE);
+            quantize_weights(cubic[pos], icubic[pos], 16, INTER_REMAP_COEF_SCALE);
+        }
+    }
+};
+
+static const WarpTables& warp_tables()
+{
+    static const WarpTables tables;
+    return tables;
+}
+
+static inline const int32_t* linear_weights(const WarpTables& tables, int pos, const uint8_t*) { return tables.ilinear[pos]; }
+static inline const int32_t* cubic_weights(const WarpTables& tables, int pos, const uint8_t*) { return tables.icubic[pos]; }
+template<typename T> static inline const float* linear_weights(const WarpTables& tables, int pos, const T*) { return tables.linear[pos]; }
+template<typename T> static inline const float* cubic_weights(const WarpTables& tables, int pos, const T*) { return tables.cubic[pos]; }
+
+// out = sum of n taps[k] * weights[k] in INTER_REMAP_COEF_BITS fixed point
+template<int n>
+static inline void blend_taps(const uint8_t* const* taps, const int32_t* weights, int cn, uint8_t* out)
+{
+    const int32_t delta = 1 << (INTER_REMAP_COEF_BITS - 1);
+    if (cn == 4)
+    {
+#if __AVX2__
+        __m128i acc = _mm_set1_epi32(delta);
+        for (int k = 0; k < n; k++)
+            acc = _mm_add_epi32(acc, _mm_mullo_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(load_u32(taps[k]))), _mm_set1_epi32(weights[k])));
+        const __m128i v16 = _mm_packs_epi32(_mm_srai_epi32(acc, INTER_REMAP_COEF_BITS), _mm_setzero_si128());
+        store_u32(out, _mm_cvtsi128_si32(_mm_packus_epi16(v16, v16)));
+        return;
+#elif __ARM_NEON && __aarch64__
+        int32x4_t acc = vdupq_n_s32(delta);
+        for (int k = 0; k < n; k++)
+            acc = vmlaq_n_s32(acc, load_u8x4(taps[k]), weights[k]);
+        const uint8x8_t v8 = vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(acc, INTER_REMAP_COEF_BITS)), vdup_n_s16(0)));
+        store_u32(out, vget_lane_s32(vreinterpret_s32_u8(v8), 0));
+        return;
+#endif
+    }
+    for (int c = 0; c < cn; c++)
+    {
+        int32_t acc = delta;
+        for (int k = 0; k < n; k++)
+            acc += taps[k][c] * weights[k];
+        out[c] = (uint8_t)std::min(std::max(acc >> INTER_REMAP_COEF_BITS, 0), 255);
+    }
+}
+
+template<int n, typename T>
+static inline void blend_taps(const T* const* taps, const float* weights, int cn, T* out)
+{
+    if (cn == 4)
+    {
+#if __AVX2__
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < n; k++)
+            acc = _mm_add_ps(acc, _mm_mul_ps(load_px4(taps[k]), _mm_set1_ps(weights[k])));
+        store_px4(acc, out);
+        return;
+#elif __ARM_NEON && __aarch64__
+        float32x4_t acc = vdupq_n_f32(0.f);
+        for (int k = 0; k < n; k++)
+            acc = vmlaq_n_f32(acc, load_px4(taps[k]), weights[k]);
+        store_px4(acc, out);
+        return;
+#endif
+    }
+    for (int c = 0; c < cn; c++)
+    {
+        float acc = 0.f;
+        for (int k = 0; k < n; k++)
+            acc += taps[k][c] * weights[k];
+        store_value(acc, out[c]);
+    }
+}
+
+// source pixel or border pixel out of rect(l, t, r, b), r and b exclusive
+template<typename T>
+struct WarpSource
+{
+    const T* data;
+    int w, cn;
+    int rect[4];
+    T border[4];
+
+    inline bool inside(int sx, int sy, int n) const { return sx >= rect[0] && sx + n <= rect[2] && sy >= rect[1] && sy + n <= rect[3]; }
+    inline const T* pixel(int sx, int sy) const { return inside(sx, sy, 1) ? data + ((size_t)sy * w + sx) * cn : border; }
+};
+
+// n x n taps from sx, sy in row order
+template<int n, typename T>
+static inline void gather_taps(const WarpSource<T>& source, int sx, int sy, const T** taps)
+{
+    if (source.inside(sx, sy, n))
+    {
+        const T* p = source.data + ((size_t)sy * source.w + sx) * source.cn;
+        const size_t stride = (size_t)source.w * source.cn;
+        for (int j = 0; j < n; j++, p += stride)
+            for (int k = 0; k < n; k++)
+                taps[j * n + k] = p + k * source.cn;
+    }
+    else
+    {
+        for (int j = 0; j < n; j++)
+            for (int k = 0; k < n; k++)
+                taps[j * n + k] = source.pixel(sx + k, sy + j);
+    }
+}
+
+// X, Y are source positions of a row in 1/INTER_TAB_SIZE pixels, window of n x n taps starts
+// n / 2 - 1 pixels before position, weights are 2x2 bilinear or 4x4 bicubic of sub pixel
+template<int n, typename T>
+static void sample_row(const WarpSource<T>& source, const int* X, const int* Y, int count, T* out)
+{
+    const WarpTables& tables = warp_tables();
+    const int cn = source.cn;
+    const T* taps[n * n];
+    for (int i = 0; i < count; i++, out += cn)
+    {
+        const int sx = (X[i] >> INTER_BITS) - (n / 2 - 1), sy = (Y[i] >> INTER_BITS) - (n / 2 - 1);
+        const int pos = (Y[i] & (INTER_TAB_SIZE - 1)) * INTER_TAB_SIZE + (X[i] & (INTER_TAB_SIZE - 1));
+        gather_taps<n>(source, sx, sy, taps);
+        if (n == 2)
+            blend_taps<n * n>(taps, linear_weights(tables, pos, source.data), cn, out);
+        else
+            blend_taps<n * n>(taps, cubic_weights(tables, pos, source.data), cn, out);
+    }
+}
+
+// X, Y are source pixels of a row
+template<typename T>
+static void sample_row_nearest(const WarpSource<T>& source, const int* X, const int* Y, int count, T* out)
+{
+    const int cn = source.cn;
+    for (int i = 0; i < count; i++, out += cn)
+    {
+        const T* p = source.pixel(X[i], Y[i]);
+        if (cn == 4)
+        {
+            out[0] = p[0]; out[1] = p[1]; out[2] = p[2]; out[3] = p[3];
+        }
+        else
+        {
+            for (int c = 0; c < cn; c++)
+                out[c] = p[c];
+        }
+    }
+}
+
+static inline int saturate_round(double v)
+{
+    return (int)lrint(std::min(std::max(v, (double)-(1 << 30)), (double)(1 << 30)));
+}
+
+template<typename T>
+static void warp_tiles(const ImMat& src, ImMat& dst, const float m[9], bool perspective, ImInterpolateMode type, ImPixel border_col, const int rect[4])
+{
+    WarpSource<T> source;
+    source.data = (const T *)src.data;
+    source.w = src.w;
+    source.cn = src.c;
+    std::copy(rect, rect + 4, source.rect);
+    int map[4];
+    color_format_mapping(src.color_format, map);
+    const float border_rgba[4] = {border_col.r, border_col.g, border_col.b, border_col.a};
+    for (int k = 0; k < 4; k++)
+        from_unit(border_rgba[k], source.border[k < src.c ? map[k] : k]);
+
+    // affine column terms in AB_BITS fixed point, same for all rows
+    std::vector<int> adelta, bdelta;
+    if (!perspective)
+    {
+        adelta.resize(dst.w);
+        bdelta.resize(dst.w);
+        for (int x = 0; x < dst.w; x++)
+        {
+            adelta[x] = saturate_round((double)m[0] * x * AB_SCALE);
+            bdelta[x] = saturate_round((double)m[3] * x * AB_SCALE);
+        }
+    }
+    const bool nearest = type == IM_INTERPOLATE_NEAREST;
+    const int tiles_x = (dst.w + WARP_TILE_SIZE - 1) / WARP_TILE_SIZE;
+    const int tiles = tiles_x * ((dst.h + WARP_TILE_SIZE - 1) / WARP_TILE_SIZE);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int t = 0; t < tiles; t++)
+    {
+        const int x0 = (t % tiles_x) * WARP_TILE_SIZE, y0 = (t / tiles_x) * WARP_TILE_SIZE;
+        const int x1 = std::min(x0 + WARP_TILE_SIZE, dst.w), y1 = std::min(y0 + WARP_TILE_SIZE, dst.h);
+        int X[WARP_TILE_SIZE], Y[WARP_TILE_SIZE];
+        for (int y = y0; y < y1; y++)
+        {
+            if (!perspective)
+            {
+                // nearest rounds to pixel, others to sub pixel
+                const int round_delta = nearest ? AB_SCALE / 2 : ROUND_DELTA;
+                const int shift = nearest ? AB_BITS : AB_BITS - INTER_BITS;
+                const int X0 = saturate_round(((double)m[1] * y + m[2]) * AB_SCALE) + round_delta;
+                const int Y0 = saturate_round(((double)m[4] * y + m[5]) * AB_SCALE) + round_delta;
+                for (int x = x0; x < x1; x++)
+                {
+                    X[x - x0] = (adelta[x] + X0) >> shift;
+                    Y[x - x0] = (bdelta[x] + Y0) >> shift;
+                }
+            }
+            else
+            {
+                const double scale = nearest ? 1.0 : INTER_TAB_SIZE;
+                for (int x = x0; x < x1; x++)
+                {
+                    const double X0 = (double)m[0] * x + (double)m[1] * y + m[2];
+                    const double Y0 = (double)m[3] * x + (double)m[4] * y + m[5];
+                    double W = (double)m[6] * x + (double)m[7] * y + m[8];
+                    W = W != 0.0 ? scale / W : 0.0;
+                    X[x - x0] = saturate_round(X0 * W);
+                    Y[x - x0] = saturate_round(Y0 * W);
+                }
+            }
+            T* out = (T *)dst.data + ((size_t)y * dst.w + x0) * src.c;
+            if (nearest)
+                sample_row_nearest(source, X, Y, x1 - x0, out);
+            else if (type == IM_INTERPOLATE_BILINEAR)
+                sample_row<2>(source, X, Y, x1 - x0, out);
+            else
+                sample_row<4>(source, X, Y, x1 - x0, out);
+        }
+    }
+}
+
+// first n elements of M as float, M is float or double matrix on cpu
+static bool read_matrix(const ImMat& M, float m[9], int n)
+{
+    if (M.empty() || M.device != IM_DD_CPU || (int)M.total() < n)
+        return false;
+    for (int i = 0; i < n; i++)
+    {
+        if (M.type == IM_DT_FLOAT32) m[i] = ((const float *)M.data)[i];
+        else if (M.type == IM_DT_FLOAT64) m[i] = (float)((const double *)M.data)[i];
+        else return false;
+    }
+    return true;
+}
+
+static bool warp(const ImMat& src, ImMat& dst, const ImMat& M, bool perspective, ImInterpolateMode type, ImPixel border_col, ImPixel crop)
+{
+    float m[9];
+    if (!is_supported(src) || !is_supported(dst) || !read_matrix(M, m, perspective ? 9 : 6))
+        return false;
+    // shader falls back to nearest for other modes
+    if (type != IM_INTERPOLATE_BILINEAR && type != IM_INTERPOLATE_BICUBIC)
+        type = IM_INTERPOLATE_NEAREST;
+    ImMat out = output_of(src, dst);
+    if (out.empty())
+        return false;
+    const int rect[4] = {(int)crop.r, (int)crop.g, src.w - (int)crop.b, src.h - (int)crop.a};
+    switch (src.type)
+    {
+        case IM_DT_INT8: warp_tiles<uint8_t>(src, out, m, perspective, type, border_col, rect); break;
+        case IM_DT_INT16: warp_tiles<uint16_t>(src, out, m, perspective, type, border_col, rect); break;
+        case IM_DT_FLOAT32: warp_tiles<float>(src, out, m, perspective, type, border_col, rect); break;
+        default: break;
+    }
+    if (out.data != dst.data)
+        convert_layout(out, dst);
+    return true;
+}
+
+bool Warp_cpu::warpAffine(const ImMat& src, ImMat& dst, const ImMat& M, ImInterpolateMode type, ImPixel border_col, ImPixel crop)
+{
+    return warp(src, dst, M, false, type, border_col, crop);
+}
+
+bool Warp_cpu::warpPerspective(const ImMat& src, ImMat& dst, const ImMat& M, ImInterpolateMode type, ImPixel border_col, ImPixel crop)
+{
+    return warp(src, dst, M, true, type, border_col, crop);
+}
+} // namespace ImGui
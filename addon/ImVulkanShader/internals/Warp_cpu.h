@@ -0,0 +1,31 @@
+#pragma once
+#include "immat.h"
+#include "imvk_platform.h"
+
+namespace ImGui
+{
+// CPU geometric transforms, used by Resize_vulkan, warpAffine_vulkan and warpPerspective_vulkan
+// when there is no vulkan device. Source and destination are INT8, INT16 or FLOAT32 mats on cpu.
+//
+// Resize is separable, coefficients of both axes are computed once per call into tables of
+// contiguous source windows, 8 bits mats use fixed point coefficients. Every task resizes a band
+// of destination rows, source rows are resized horizontally once into a ring and then blended
+// vertically, both passes are vectorized. Nearest and bilinear sample as shaders, bicubic and
+// area sample as OpenCV INTER_CUBIC and INTER_AREA with clamped borders.
+//
+// Warps map every destination pixel into source by M, as shaders M maps destination to source
+// (getAffineTransform(dst_points, src_points) for example), 2x3 for affine and 3x3 for perspective.
+// Source position is quantized to 1/32 pixel and fixed point interpolation tables of all sub pixel
+// positions are built once. Destination is cut into tiles warped in parallel. Pixels outside of
+// crop rect(l, t, r, b in ImPixel r, g, b, a) are border_col, area falls back to nearest.
+//
+// Destination mat must be created by caller with output size, channels and color format, it is
+// converted from source layout after transform when they differ.
+class VKSHADER_API Warp_cpu
+{
+public:
+    static bool Resize(const ImMat& src, ImMat& dst, ImInterpolateMode type);
+    static bool warpAffine(const ImMat& src, ImMat& dst, const ImMat& M, ImInterpolateMode type, ImPixel border_col, ImPixel crop);
+    static bool warpPerspective(const ImMat& src, ImMat& dst, const ImMat& M, ImInterpolateMode type, ImPixel border_col, ImPixel crop);
+};
+} // namespace ImGui
@@ -1,5 +1,6 @@
 #include "warpAffine_vulkan.h"
 #include "warpAffine_shader.h"
+#include "Warp_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
@@ -7,6 +8,8 @@ namespace ImGui
 warpAffine_vulkan::warpAffine_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -79,10 +82,30 @@ void warpAffine_vulkan::upload_param(const VkMat& src, VkMat& dst, const VkMat&
 double warpAffine_vulkan::warp(const ImMat& src, ImMat& dst, const ImMat& M, ImInterpolateMode type, ImPixel border_col, ImPixel crop) const
 {
     double ret = 0.0;
-    if (!vkdev || !pipe || !cmd)
+    if (!vkdev)
     {
+        // no vulkan device, warp on cpu
+        if (src.device != IM_DD_CPU)
+            return ret;
+        ImMat dst_cpu;
+        if (dst.w != 0 && dst.h != 0)
+            dst_cpu.create_type(dst.w, dst.h, 4, dst.type);
+        else
+            dst_cpu.create_type(src.w, src.h, 4, dst.type);
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Warp_cpu::warpAffine(src, dst_cpu, M, type, border_col, crop))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst = dst_cpu;
+        dst.copy_attribute(src);
         return ret;
     }
+    if (!pipe || !cmd)
+        return ret;
 
     VkMat dst_gpu;
     if (dst.w != 0 && dst.h != 0)
@@ -1,5 +1,6 @@
 #include "warpPerspective_vulkan.h"
 #include "warpPerspective_shader.h"
+#include "Warp_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui 
@@ -7,6 +8,8 @@ namespace ImGui
 warpPerspective_vulkan::warpPerspective_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -79,10 +82,27 @@ void warpPerspective_vulkan::upload_param(const VkMat& src, VkMat& dst, const Vk
 double warpPerspective_vulkan::warp(const ImMat& src, ImMat& dst, const ImMat& M, ImInterpolateMode type, ImPixel border_col, ImPixel crop) const
 {
     double ret = 0.0;
-    if (!vkdev || !pipe || !cmd)
+    if (!vkdev)
     {
+        // no vulkan device, warp on cpu
+        if (src.device != IM_DD_CPU)
+            return ret;
+        ImMat dst_cpu;
+        dst_cpu.create_type(src.w, src.h, 4, dst.type);
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Warp_cpu::warpPerspective(src, dst_cpu, M, type, border_col, crop))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst = dst_cpu;
+        dst.copy_attribute(src);
         return ret;
     }
+    if (!pipe || !cmd)
+        return ret;
 
     VkMat dst_gpu;
     dst_gpu.create_type(src.w, src.h, 4, dst.type, opt.blob_vkallocator);
@@ -1,5 +1,6 @@
 #include "CIE_vulkan.h"
 #include "CIE_shader.h"
+#include "Scopes_cpu.h"
 #include "ImVulkanShader.h"
 #ifndef MAX
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
@@ -1043,6 +1044,8 @@ CIE_vulkan::CIE_vulkan(int gpu)
     draw_backbroud();
 
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -1147,6 +1150,8 @@ void CIE_vulkan::SetParam(int _color_system, int _cie, int _size, int _gamuts, f
         invert_matrix3x3(xyz_matrix, xyz_imatrix);
         backgroud.create(size, size, 4, 1u, 4);
         draw_backbroud();
+        if (!vkdev)
+            return;
 
         VkTransfer tran_xyz_matrix(vkdev);
         tran_xyz_matrix.record_upload(xyz_matrix, xyz_matrix_gpu, opt, false);
@@ -1242,6 +1247,21 @@ void CIE_vulkan::upload_param(const VkMat& src, VkMat& dst, float intensity, boo
 double CIE_vulkan::scope(const ImMat& src, ImMat& dst, float intensity, bool show_color)
 {
     double ret = 0.0;
+    if (!vkdev)
+    {
+        // no vulkan device, scope on cpu
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Scopes_cpu::CIE(src, dst, xyz_matrix, backgroud, cie, intensity, show_color))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst.copy_attribute(src);
+        dst.flags |= IM_MAT_FLAGS_CUSTOM_UPDATED;
+        return ret;
+    }
     if (!vkdev || !pipe_set || !pipe || !pipe_merge || !cmd)
     {
         return ret;
@@ -0,0 +1,464 @@
+#include "Scopes_cpu.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Source is split into tiles, every tile is accumulated by one thread into its own counters
+#define SCOPE_TILES     OMP_THREADS
+// Number of source samples loaded and converted at once, fits on stack
+#define SCOPE_CHUNK     256
+// Waveform column tile width, counters of a tile are disjoint from other tiles
+#define WAVEFORM_TILE   64
+
+namespace ImGui
+{
+// same as shader color_format_mapping_vec4, rgb part only
+static inline void color_format_mapping(ImColorFormat format, int map[3])
+{
+    switch (format)
+    {
+        case IM_CF_ABGR: case IM_CF_BGR: map[0] = 0; map[1] = 1; map[2] = 2; break;
+        case IM_CF_ARGB: case IM_CF_RGB: map[0] = 2; map[1] = 1; map[2] = 0; break;
+        case IM_CF_BGRA: map[0] = 1; map[1] = 2; map[2] = 3; break;
+        case IM_CF_RGBA: map[0] = 3; map[1] = 2; map[2] = 1; break;
+        default: map[0] = map[1] = map[2] = 0; break;
+    }
+}
+
+static inline int tile_begin(int count, int tiles, int t)
+{
+    return (int)((int64_t)count * t / tiles);
+}
+
+// Loads rgb of source samples into planar float rows, same value as shader load_rgba
+class RGBLoader
+{
+public:
+    RGBLoader(const ImMat& mat)
+        : m_data((const uint8_t *)mat.data), m_w(mat.w), m_c(mat.c), m_type(mat.type)
+    {
+        color_format_mapping(mat.color_format, m_map);
+        // shader reads interleaved data only, 3 channels formats keep their own map
+        for (int i = 0; i < 3; i++)
+            if (m_map[i] >= m_c) m_map[i] = 0;
+    }
+
+    bool valid() const
+    {
+        return m_data && (m_type == IM_DT_INT8 || m_type == IM_DT_INT16 || m_type == IM_DT_INT16_BE ||
+                          m_type == IM_DT_FLOAT16 || m_type == IM_DT_FLOAT32);
+    }
+
+    // load n samples of row y, sample i is pixel x0 + i * step
+    void load(int y, int x0, int step, int n, float* r, float* g, float* b) const
+    {
+        switch (m_type)
+        {
+            case IM_DT_INT8:
+                load_row<uint8_t>(y, x0, step, n, r, g, b, [](uint8_t v) { return (float)v / 255.f; });
+            break;
+            case IM_DT_INT16:
+                load_row<uint16_t>(y, x0, step, n, r, g, b, [](uint16_t v) { return (float)v / 65535.f; });
+            break;
+            case IM_DT_INT16_BE:
+                load_row<uint16_t>(y, x0, step, n, r, g, b, [](uint16_t v) { return (float)(uint16_t)((v << 8) | (v >> 8)) / 65535.f; });
+            break;
+            case IM_DT_FLOAT16:
+                load_row<uint16_t>(y, x0, step, n, r, g, b, [](uint16_t v) { return im_float16_to_float32(v); });
+            break;
+            case IM_DT_FLOAT32:
+                load_row<float>(y, x0, step, n, r, g, b, [](float v) { return v; });
+            break;
+            default: break;
+        }
+    }
+
+private:
+    template<typename T, typename F>
+    void load_row(int y, int x0, int step, int n, float* r, float* g, float* b, F cvt) const
+    {
+        const T* row = (const T *)m_data + ((size_t)y * m_w + x0) * m_c;
+        const size_t stride = (size_t)step * m_c;
+        for (int i = 0; i < n; i++)
+        {
+            const T* p = row + i * stride;
+            r[i] = cvt(p[m_map[0]]);
+            g[i] = cvt(p[m_map[1]]);
+            b[i] = cvt(p[m_map[2]]);
+        }
+    }
+
+private:
+    const uint8_t* m_data;
+    int m_w, m_c;
+    ImDataType m_type;
+    int m_map[3];
+};
+
+// rgb -> yuv -> rgb round trip of Histogram and Waveform shaders, clamps rgb to legal range
+static inline void rgb_yuv_rgb(float r, float g, float b, float& Y, float& R, float& G, float& B)
+{
+    Y = std::min(std::max(0.262700f * r + 0.678000f * g + 0.059300f * b, 0.f), 1.f);
+    const float U = std::min(std::max(0.5f - 0.139630f * r - 0.360370f * g + 0.500000f * b, 0.f), 1.f) - 0.5f;
+    const float V = std::min(std::max(0.5f + 0.500000f * r - 0.459786f * g - 0.040214f * b, 0.f), 1.f) - 0.5f;
+    R = std::min(std::max(Y + 1.474600f * V, 0.f), 1.f);
+    G = std::min(std::max(Y - 0.164553f * U - 0.571353f * V, 0.f), 1.f);
+    B = std::min(std::max(Y + 1.881400f * U, 0.f), 1.f);
+}
+
+static inline uint8_t store_unorm8(float v)
+{
+    return (uint8_t)std::min(std::max(std::floor(v * 255.f), 0.f), 255.f);
+}
+
+// sum of tile counters at index i
+static inline int32_t reduce_tiles(const std::vector<int32_t>& counters, size_t tile_size, int tiles, size_t i)
+{
+    int32_t sum = 0;
+    for (int t = 0; t < tiles; t++)
+        sum += counters[t * tile_size + i];
+    return sum;
+}
+
+bool Scopes_cpu::Histogram(const ImMat& src, ImMat& dst, int level, float scale, bool log_view)
+{
+    RGBLoader loader(src);
+    if (src.empty() || src.device != IM_DD_CPU || level <= 0 || !loader.valid())
+        return false;
+
+    // shader samples pixels on even rows and even columns
+    const int rows = (src.h + 1) / 2;
+    const int cols = (src.w + 1) / 2;
+    const int tiles = std::min(SCOPE_TILES, rows);
+    // bins of r, g, b, y, last one takes samples which are not counted
+    const size_t tile_size = (size_t)level * 4 + 1;
+    const int skip = level * 4;
+    std::vector<int32_t> bins(tile_size * tiles, 0);
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int t = 0; t < tiles; t++)
+    {
+        int32_t* hist = bins.data() + t * tile_size;
+        float r[SCOPE_CHUNK], g[SCOPE_CHUNK], b[SCOPE_CHUNK];
+        int index[4][SCOPE_CHUNK];
+        const float fmax = (float)(level - 1);
+        for (int row = tile_begin(rows, tiles, t); row < tile_begin(rows, tiles, t + 1); row++)
+        {
+            for (int x0 = 0; x0 < cols; x0 += SCOPE_CHUNK)
+            {
+                const int n = std::min(SCOPE_CHUNK, cols - x0);
+                loader.load(row * 2, x0 * 2, 2, n, r, g, b);
+                for (int i = 0; i < n; i++)
+                {
+                    float Y, R, G, B;
+                    rgb_yuv_rgb(r[i], g[i], b[i], Y, R, G, B);
+                    R *= fmax; G *= fmax; B *= fmax; Y *= fmax;
+                    index[0][i] = R > 0.f ? std::min((int)R, level - 1) + level * 0 : skip;
+                    index[1][i] = G > 0.f ? std::min((int)G, level - 1) + level * 1 : skip;
+                    index[2][i] = B > 0.f ? std::min((int)B, level - 1) + level * 2 : skip;
+                    index[3][i] = Y > 0.f ? std::min((int)Y, level - 1) + level * 3 : skip;
+                }
+                for (int k = 0; k < 4; k++)
+                    for (int i = 0; i < n; i++)
+                        hist[index[k][i]]++;
+            }
+        }
+    }
+
+    ImMat out;
+    out.create_type(level, 1, 4, IM_DT_FLOAT32);
+    for (int k = 0; k < 4; k++)
+    {
+        float* data = (float *)out.data + k * out.cstep;
+        for (int i = 0; i < level; i++)
+        {
+            const int32_t v = reduce_tiles(bins, tile_size, tiles, (size_t)k * level + i);
+            data[i] = (log_view ? std::log2((float)(v + 1)) : (float)v) * scale;
+        }
+    }
+    dst = out;
+    return true;
+}
+
+bool Scopes_cpu::Waveform(const ImMat& src, ImMat& dst, int level, float intensity, bool separate, bool show_y)
+{
+    RGBLoader loader(src);
+    if (src.empty() || src.device != IM_DD_CPU || level <= 0 || !loader.valid())
+        return false;
+
+    const int w = src.w;
+    const int part = show_y ? 4 : 3;
+    const int ox = separate ? w / part : 0;
+    // tiles start at multiple of part, so separated columns of tiles never overlap
+    const int tile_w = separate ? WAVEFORM_TILE * part : WAVEFORM_TILE;
+    const int tiles = (w + tile_w - 1) / tile_w;
+    // interleaved r, g, b, y counters, same layout as shader int32 buffer
+    std::vector<int32_t> counters((size_t)w * level * 4, 0);
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int t = 0; t < tiles; t++)
+    {
+        int32_t* data = counters.data();
+        float r[SCOPE_CHUNK], g[SCOPE_CHUNK], b[SCOPE_CHUNK];
+        int row[4][SCOPE_CHUNK];
+        const float fmax = (float)(level - 1);
+        const int x0 = t * tile_w;
+        const int n = std::min(tile_w, w - x0);
+        for (int y = 0; y < src.h; y += 2)
+        {
+            for (int c0 = 0; c0 < n; c0 += SCOPE_CHUNK)
+            {
+                const int cn = std::min(SCOPE_CHUNK, n - c0);
+                loader.load(y, x0 + c0, 1, cn, r, g, b);
+                for (int i = 0; i < cn; i++)
+                {
+                    float Y, R, G, B;
+                    rgb_yuv_rgb(r[i], g[i], b[i], Y, R, G, B);
+                    row[0][i] = std::min((int)(R * fmax), level - 1);
+                    row[1][i] = std::min((int)(G * fmax), level - 1);
+                    row[2][i] = std::min((int)(B * fmax), level - 1);
+                    row[3][i] = (int)(Y * fmax);
+                }
+                for (int i = 0; i < cn; i++)
+                {
+                    const int gx = x0 + c0 + i;
+                    const int dx = separate ? gx / part : gx;
+                    data[((size_t)row[0][i] * w + dx) * 4 + 0]++;
+                    data[((size_t)row[1][i] * w + dx + ox) * 4 + 1]++;
+                    data[((size_t)row[2][i] * w + dx + ox * 2) * 4 + 2]++;
+                    // y counter is only read when it is shown
+                    if (show_y) data[((size_t)row[3][i] * w + dx + ox * 3) * 4 + 3]++;
+                }
+            }
+        }
+    }
+
+    ImMat out;
+    out.create_type(w, level, 4, IM_DT_INT8);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < level; y++)
+    {
+        const int32_t* in = counters.data() + (size_t)y * w * 4;
+        uint8_t* o = (uint8_t *)out.data + (size_t)y * w * 4;
+        for (int x = 0; x < w; x++, in += 4, o += 4)
+        {
+            const bool y_only = show_y && (!separate || x >= w * 3 / 4);
+            for (int k = 0; k < 3; k++)
+                o[k] = (uint8_t)std::min(std::max(in[y_only ? 3 : k] * intensity, 0.f), 255.f);
+            o[3] = 255;
+        }
+    }
+    dst = out;
+    return true;
+}
+
+bool Scopes_cpu::Vector(const ImMat& src, ImMat& dst, int size, float intensity)
+{
+    RGBLoader loader(src);
+    if (src.empty() || src.device != IM_DD_CPU || size <= 0 || !loader.valid())
+        return false;
+
+    // shader samples one pixel of every 4x4 block
+    const int rows = (src.h + 3) / 4;
+    const int cols = (src.w + 3) / 4;
+    const int tiles = std::min(SCOPE_TILES, rows);
+    const size_t tile_size = (size_t)size * size;
+    std::vector<int32_t> counters(tile_size * tiles, 0);
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int t = 0; t < tiles; t++)
+    {
+        int32_t* data = counters.data() + t * tile_size;
+        float r[SCOPE_CHUNK], g[SCOPE_CHUNK], b[SCOPE_CHUNK];
+        const int half = size / 2;
+        for (int row = tile_begin(rows, tiles, t); row < tile_begin(rows, tiles, t + 1); row++)
+        {
+            for (int x0 = 0; x0 < cols; x0 += SCOPE_CHUNK)
+            {
+                const int n = std::min(SCOPE_CHUNK, cols - x0);
+                loader.load(row * 4, x0 * 4, 4, n, r, g, b);
+                for (int i = 0; i < n; i++)
+                {
+                    // rgb_to_hsl
+                    const float vmax = std::max(std::max(r[i], g[i]), b[i]);
+                    const float vmin = std::min(std::min(r[i], g[i]), b[i]);
+                    float h = 0.f;
+                    if (vmax == vmin)   h = 0.f;
+                    else if (vmax == r[i]) h = 60.f * (g[i] - b[i]) / (vmax - vmin);
+                    else if (vmax == g[i]) h = 60.f * (2.0f + (b[i] - r[i]) / (vmax - vmin));
+                    else                h = 60.f * (4.0f + (r[i] - g[i]) / (vmax - vmin));
+                    const float l = (vmax + vmin) / 2.f;
+                    const float s = (l == 0.f || l == 1.f) ? 0.f : (vmax - l) / std::min(l, 1.f - l);
+                    // hs_to_point
+                    float length = std::min(std::max(s, 0.f), 1.f);
+                    length *= l <= 0.5f ? l * 2.f : (1.f - l) * 2.f;
+                    float px = 0.f, py = 0.f;
+                    if (h == 0.f)           px = length;
+                    else if (h == 180.f)    px = -length;
+                    else if (h == 90.f)     py = length;
+                    else if (h == 270.f)    py = -length;
+                    else
+                    {
+                        const float angle = h * 0.017453f;
+                        px = length * std::cos(angle);
+                        py = length * std::sin(angle);
+                    }
+                    const int x = half + (int)(px * (float)half);
+                    const int y = half - (int)(py * (float)half);
+                    if (x > 0 && x < size && y >= 0 && y < size)
+                        data[(size_t)y * size + x] += (int)(l * 20.f);
+                }
+            }
+        }
+    }
+
+    ImMat out;
+    out.create_type(size, size, 4, IM_DT_INT8);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < size; y++)
+    {
+        uint8_t* o = (uint8_t *)out.data + (size_t)y * size * 4;
+        for (int x = 0; x < size; x++, o += 4)
+        {
+            const float fx = (float)(x - size / 2) / ((float)size / 2.f);
+            const float fy = -(float)(y - size / 2) / ((float)size / 2.f);
+            const float dist = std::sqrt(fx * fx + fy * fy);
+            if (dist > 1.f)
+            {
+                // shader leaves pixels out of circle untouched
+                o[0] = o[1] = o[2] = o[3] = 0;
+                continue;
+            }
+            // point_to_angle
+            const float to_degree = 180.f / 3.141592653589793f;
+            float angle = 0.f;
+            if (fy == 0.f && fx > 0.f)          angle = 0.f;
+            else if (fy == 0.f && fx < 0.f)     angle = 180.f;
+            else if (fx == 0.f && fy < 0.f)     angle = 270.f;
+            else if (fx == 0.f && fy > 0.f)     angle = 90.f;
+            else if (fx > 0.f && fy > 0.f)      angle = 90.f - std::atan2(fx, fy) * to_degree;
+            else if (fx < 0.f && fy > 0.f)      angle = 90.f + std::atan2(-fx, fy) * to_degree;
+            else if (fx < 0.f && fy < 0.f)      angle = 270.f - std::atan2(-fx, -fy) * to_degree;
+            else if (fx > 0.f && fy < 0.f)      angle = 270.f + std::atan2(fx, -fy) * to_degree;
+            angle = std::min(std::max(angle, 0.f), 360.f);
+            // hsv_to_rgb with value 1
+            float rgb[3] = {1.f, 1.f, 1.f};
+            if (dist != 0.f)
+            {
+                const float a = angle / 360.f;
+                const float hh = (a - std::floor(a)) / (60.0f / 360.0f);
+                const int i = (int)hh;
+                const float f = hh - (float)i;
+                const float p = 1.f - dist;
+                const float q = 1.f - dist * f;
+                const float u = 1.f - dist * (1.f - f);
+                if      (i == 0) { rgb[0] = 1; rgb[1] = u; rgb[2] = p; }
+                else if (i == 1) { rgb[0] = q; rgb[1] = 1; rgb[2] = p; }
+                else if (i == 2) { rgb[0] = p; rgb[1] = 1; rgb[2] = u; }
+                else if (i == 3) { rgb[0] = p; rgb[1] = q; rgb[2] = 1; }
+                else if (i == 4) { rgb[0] = u; rgb[1] = p; rgb[2] = 1; }
+                else             { rgb[0] = 1; rgb[1] = p; rgb[2] = q; }
+            }
+            const int alpha = (int)(reduce_tiles(counters, tile_size, tiles, (size_t)y * size + x) * intensity);
+            o[0] = store_unorm8(rgb[0]);
+            o[1] = store_unorm8(rgb[1]);
+            o[2] = store_unorm8(rgb[2]);
+            o[3] = alpha > 0 ? store_unorm8(std::min(std::max(alpha / 255.f, 0.f), 1.f)) : 0;
+        }
+    }
+    dst = out;
+    return true;
+}
+
+bool Scopes_cpu::CIE(const ImMat& src, ImMat& dst, const ImMat& xyz_matrix, const ImMat& background, int cie, float intensity, bool show_color)
+{
+    RGBLoader loader(src);
+    if (src.empty() || src.device != IM_DD_CPU || !loader.valid() ||
+        xyz_matrix.total() < 9 || xyz_matrix.type != IM_DT_FLOAT32 ||
+        background.empty() || background.type != IM_DT_INT8 || background.c < 4)
+        return false;
+
+    // same as CieSystem of CIE_vulkan
+    enum { XYY = 0, UCS, LUV };
+    const int size = background.w;
+    const float* m = (const float *)xyz_matrix.data;
+    // shader samples one pixel of every 4x4 block
+    const int rows = (src.h + 3) / 4;
+    const int cols = (src.w + 3) / 4;
+    const int tiles = std::min(SCOPE_TILES, rows);
+    const size_t tile_size = (size_t)size * background.h;
+    std::vector<int32_t> counters(tile_size * tiles, 0);
+
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int t = 0; t < tiles; t++)
+    {
+        int32_t* data = counters.data() + t * tile_size;
+        float r[SCOPE_CHUNK], g[SCOPE_CHUNK], b[SCOPE_CHUNK];
+        const int outh = background.h;
+        for (int row = tile_begin(rows, tiles, t); row < tile_begin(rows, tiles, t + 1); row++)
+        {
+            for (int x0 = 0; x0 < cols; x0 += SCOPE_CHUNK)
+            {
+                const int n = std::min(SCOPE_CHUNK, cols - x0);
+                loader.load(row * 4, x0 * 4, 4, n, r, g, b);
+                for (int i = 0; i < n; i++)
+                {
+                    // rgb_to_xyz
+                    const float X = r[i] * m[0] + g[i] * m[3] + b[i] * m[6];
+                    const float Y = r[i] * m[1] + g[i] * m[4] + b[i] * m[7];
+                    const float Z = r[i] * m[2] + g[i] * m[5] + b[i] * m[8];
+                    float sum = X + Y + Z;
+                    if (sum == 0.f) sum = 1.f;
+                    float fx = X / sum;
+                    float fy = Y / sum;
+                    if (cie == LUV || cie == UCS)
+                    {
+                        const float d = -2.f * fx + 12.f * fy + 3.f;
+                        const float u = 4.f * fx / d;
+                        fy = (cie == LUV ? 9.f : 6.f) * fy / d;
+                        fx = u;
+                    }
+                    const int ix = (int)((float)(size - 1) * fx);
+                    const int iy = (outh - 1) - (int)((float)(outh - 1) * fy);
+                    if (ix >= 0 && ix < size && iy >= 0 && iy < outh)
+                        data[(size_t)iy * size + ix]++;
+                }
+            }
+        }
+    }
+
+    int map[3];
+    color_format_mapping(background.color_format, map);
+    ImMat out;
+    out.create_type(size, background.h, 4, IM_DT_INT8);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (int y = 0; y < background.h; y++)
+    {
+        const uint8_t* bg = (const uint8_t *)background.data + (size_t)y * size * background.c;
+        uint8_t* o = (uint8_t *)out.data + (size_t)y * size * 4;
+        for (int x = 0; x < size; x++, bg += background.c, o += 4)
+        {
+            const int alpha = (int)(reduce_tiles(counters, tile_size, tiles, (size_t)y * size + x) * intensity);
+            float rgb[3] = { bg[map[0]] / 255.f, bg[map[1]] / 255.f, bg[map[2]] / 255.f };
+            if (show_color)
+            {
+                if (alpha > 0)
+                    rgb[0] = rgb[1] = rgb[2] = std::min(std::max(alpha / 255.f, 0.f), 1.f);
+            }
+            else
+            {
+                // alpha of outline and gamut lines is 128, keep their color
+                const float a = bg[3] / 255.f;
+                if (!(a <= 0.51f && a >= 0.49f) && alpha == 0)
+                    rgb[0] = rgb[1] = rgb[2] = 0.f;
+            }
+            o[0] = store_unorm8(rgb[0]);
+            o[1] = store_unorm8(rgb[1]);
+            o[2] = store_unorm8(rgb[2]);
+            o[3] = 255;
+        }
+    }
+    dst = out;
+    return true;
+}
+} // namespace ImGui
@@ -0,0 +1,22 @@
+#pragma once
+#include "immat.h"
+#include "imvk_platform.h"
+
+namespace ImGui
+{
+// CPU implementation of scope shaders, used by Histogram/Waveform/Vector/CIE_vulkan when there
+// is no vulkan device. Every function samples source like its shader does and creates output
+// mat with shader output layout.
+//
+// Instead of atomic add, source is split into tiles processed in parallel. Every tile owns its
+// int32 counters(privatized bins for Histogram/Vector/CIE, a disjoint column range for Waveform),
+// counters are reduced before intensity mapping.
+class VKSHADER_API Scopes_cpu
+{
+public:
+    static bool Histogram(const ImMat& src, ImMat& dst, int level, float scale, bool log_view);
+    static bool Waveform(const ImMat& src, ImMat& dst, int level, float intensity, bool separate, bool show_y);
+    static bool Vector(const ImMat& src, ImMat& dst, int size, float intensity);
+    static bool CIE(const ImMat& src, ImMat& dst, const ImMat& xyz_matrix, const ImMat& background, int cie, float intensity, bool show_color);
+};
+} // namespace ImGui
@@ -1,5 +1,6 @@
 #include "Vector_vulkan.h"
 #include "Vector_shader.h"
+#include "Scopes_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui
@@ -7,6 +8,8 @@ namespace ImGui
 Vector_vulkan::Vector_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -110,6 +113,21 @@ void Vector_vulkan::upload_param(const ImGui::VkMat& src, ImGui::VkMat& dst, flo
 double Vector_vulkan::scope(const ImGui::ImMat& src, ImGui::ImMat& dst, float intensity)
 {
     double ret = 0.0;
+    if (!vkdev)
+    {
+        // no vulkan device, scope on cpu
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Scopes_cpu::Vector(src, dst, size, intensity))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst.copy_attribute(src);
+        dst.flags |= IM_MAT_FLAGS_CUSTOM_UPDATED;
+        return ret;
+    }
     if (!vkdev || !pipe || !pipe_zero || !pipe_merge || !cmd)
     {
         return ret;
@@ -1,5 +1,6 @@
 #include "Waveform_vulkan.h"
 #include "Waveform_shader.h"
+#include "Scopes_cpu.h"
 #include "ImVulkanShader.h"
 
 namespace ImGui
@@ -7,6 +8,8 @@ namespace ImGui
 Waveform_vulkan::Waveform_vulkan(int gpu)
 {
     vkdev = get_gpu_device(gpu);
+    if (!vkdev)
+        return;
     opt.blob_vkallocator = vkdev->acquire_blob_allocator();
     opt.staging_vkallocator = vkdev->acquire_staging_allocator();
 #ifdef VULKAN_SHADER_FP16
@@ -106,6 +109,21 @@ void Waveform_vulkan::upload_param(const ImGui::VkMat& src, ImGui::VkMat& dst, f
 double Waveform_vulkan::scope(const ImGui::ImMat& src, ImGui::ImMat& dst, int level, float fintensity, bool separate, bool show_y)
 {
     double ret = 0.0;
+    if (!vkdev)
+    {
+        // no vulkan device, scope on cpu
+#ifdef VULKAN_SHADER_BENCHMARK
+        double start = GetSysCurrentTime();
+#endif
+        if (!Scopes_cpu::Waveform(src, dst, level, fintensity, separate, show_y))
+            return ret;
+#ifdef VULKAN_SHADER_BENCHMARK
+        ret = (GetSysCurrentTime() - start) * 1000;
+#endif
+        dst.copy_attribute(src);
+        dst.flags |= IM_MAT_FLAGS_CUSTOM_UPDATED;
+        return ret;
+    }
     if (!vkdev || !pipe || !pipe_zero || !pipe_conv || !cmd)
     {
         return ret;
@@ -0,0 +1,209 @@
+// Precompile internal shaders to SPIR-V at build time.
+//
+// Every comp file is the text of one *_shader.h data array, written by generater_shader_comp.
+// It is compiled with the options the runtime builds for it: get_uop_option for packing/cast uops,
+// the fp16 storage/arithmetic variants of ImVulkanPeak for imvk_mat shaders, and default or fp16
+// options of filters for the others. Options are built from Option() like at runtime, so flags the
+// tool does not set, local memory, int8 and subgroup, match too. All modules are written to one
+// source file as constant arrays, sorted by the key compile_spirv_module looks up.
+//
+// usage: vkshader_spirv_prebuild output.cpp comp [comp ...]
+
+#include "imvk_gpu.h"
+#include "imvk_option.h"
+#include "glslang/Public/ShaderLang.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct prebuild_profile
+{
+    std::string name;
+    ImGui::Option opt;
+};
+
+// every storage and cast type pair VulkanDevice creates a packing uop for
+static void uop_profiles(std::vector<prebuild_profile>& profiles)
+{
+    static const char* storage_names[] = {"b", "i"};
+    static const char* cast_names[] = {"fp32", "fp16p", "fp16s"};
+    for (int i0 = 0; i0 < 2; i0++)
+        for (int i1 = 0; i1 < 2; i1++)
+            for (int j0 = 0; j0 < 3; j0++)
+                for (int j1 = 0; j1 < 3; j1++)
+                {
+                    if ((j0 == 1 && j1 == 2) || (j0 == 2 && j1 == 1))
+                        continue;
+                    prebuild_profile profile;
+                    profile.name = std::string(storage_names[i0]) + storage_names[i1] + "_" + cast_names[j0] + "_" + cast_names[j1];
+                    ImGui::get_uop_option(i0, i1, j0, j1, profile.opt);
+                    profiles.push_back(profile);
+                }
+}
+
+// storage and arithmetic types of ImVulkanPeak
+static void peak_profiles(std::vector<prebuild_profile>& profiles)
+{
+    static const char* storage_names[] = {"fp32", "fp16p", "fp16s"};
+    for (int storage_type = 0; storage_type < 3; storage_type++)
+        for (int arithmetic_type = 0; arithmetic_type < 2; arithmetic_type++)
+        {
+            prebuild_profile profile;
+            profile.name = std::string(storage_names[storage_type]) + (arithmetic_type == 1 ? "a" : "");
+            profile.opt.use_fp16_packed = storage_type == 1;
+            profile.opt.use_fp16_storage = storage_type == 2;
+            profile.opt.use_fp16_arithmetic = arithmetic_type == 1;
+            profiles.push_back(profile);
+        }
+}
+
+// filters keep default option and turn on fp16 storage and arithmetic with VULKAN_SHADER_FP16
+static void filter_profiles(std::vector<prebuild_profile>& profiles)
+{
+    prebuild_profile profile;
+    profile.name = "fp32";
+    profiles.push_back(profile);
+    profile.name = "fp16";
+    profile.opt.use_fp16_arithmetic = true;
+    profile.opt.use_fp16_storage = true;
+    profiles.push_back(profile);
+}
+
+struct prebuilt_module
+{
+    uint64_t key;
+    uint64_t check;
+    std::string name;
+    std::vector<uint32_t> spirv;
+};
+
+static bool read_text(const char* path, std::string& text)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    char buffer[4096];
+    size_t n;
+    text.clear();
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        text.append(buffer, n);
+    fclose(fp);
+    return !text.empty();
+}
+
+static std::string base_name(const char* path)
+{
+    std::string name(path);
+    size_t pos = name.find_last_of("/\\");
+    if (pos != std::string::npos)
+        name = name.substr(pos + 1);
+    pos = name.find_last_of('.');
+    if (pos != std::string::npos)
+        name = name.substr(0, pos);
+    return name;
+}
+
+static void compile_profiles(const std::string& name, const std::string& text, const std::vector<prebuild_profile>& profiles, std::vector<prebuilt_module>& modules)
+{
+    for (const auto& profile : profiles)
+    {
+        const ImGui::Option& opt = profile.opt;
+        prebuilt_module module;
+        module.name = name + "_" + profile.name;
+        ImGui::get_spirv_module_key(text.c_str(), opt, module.key, module.check);
+        bool duplicated = false;
+        for (const auto& m : modules)
+            duplicated = duplicated || (m.key == module.key && m.check == module.check);
+        if (duplicated)
+            continue;
+
+        std::string log;
+        if (ImGui::compile_spirv_module(text.c_str(), opt, module.spirv, log) != 0 || module.spirv.empty())
+        {
+            // some shaders have no fp16 packed or image path
+            fprintf(stderr, "skip %s\n", module.name.c_str());
+            continue;
+        }
+        modules.push_back(module);
+    }
+}
+
+static bool write_modules(const char* path, std::vector<prebuilt_module>& modules)
+{
+    std::sort(modules.begin(), modules.end(), [](const prebuilt_module& a, const prebuilt_module& b) { return a.key < b.key; });
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+        return false;
+    fprintf(fp, "// generated by vkshader_spirv_prebuild, do not edit\n");
+    fprintf(fp, "#include \"imvk_gpu.h\"\n\n");
+    fprintf(fp, "namespace ImGui\n{\n");
+    for (size_t i = 0; i < modules.size(); i++)
+    {
+        fprintf(fp, "// %s\n", modules[i].name.c_str());
+        fprintf(fp, "static const uint32_t spirv_%zu[] = {", i);
+        for (size_t j = 0; j < modules[i].spirv.size(); j++)
+            fprintf(fp, "%s0x%08x,", j % 8 == 0 ? "\n    " : " ", modules[i].spirv[j]);
+        fprintf(fp, "\n};\n");
+    }
+    fprintf(fp, "\nextern const spirv_prebuilt_entry g_spirv_prebuilt[];\n");
+    fprintf(fp, "extern const int g_spirv_prebuilt_count;\n");
+    fprintf(fp, "const spirv_prebuilt_entry g_spirv_prebuilt[] = {\n");
+    for (size_t i = 0; i < modules.size(); i++)
+        fprintf(fp, "    {0x%016llxULL, 0x%016llxULL, spirv_%zu, %zu},\n",
+                (unsigned long long)modules[i].key, (unsigned long long)modules[i].check, i, modules[i].spirv.size());
+    if (modules.empty())
+        fprintf(fp, "    {0, 0, 0, 0},\n");
+    fprintf(fp, "};\n");
+    fprintf(fp, "const int g_spirv_prebuilt_count = %zu;\n", modules.size());
+    fprintf(fp, "} // namespace ImGui\n");
+    return fclose(fp) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s output.cpp comp [comp ...]\n", argv[0]);
+        return -1;
+    }
+
+    glslang::InitializeProcess();
+
+    std::vector<prebuilt_module> modules;
+    int failed = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string text;
+        if (!read_text(argv[i], text))
+        {
+            fprintf(stderr, "read %s failed\n", argv[i]);
+            failed++;
+            continue;
+        }
+        const std::string name = base_name(argv[i]);
+        const size_t before = modules.size();
+        std::vector<prebuild_profile> profiles;
+        if (name.compare(0, 9, "imvk_mat_") == 0)
+            peak_profiles(profiles);
+        else if (name.compare(0, 5, "imvk_") == 0)
+            uop_profiles(profiles);
+        else
+            filter_profiles(profiles);
+        compile_profiles(name, text, profiles, modules);
+        if (modules.size() == before)
+        {
+            fprintf(stderr, "compile %s failed\n", argv[i]);
+            failed++;
+        }
+    }
+
+    glslang::FinalizeProcess();
+
+    if (failed > 0 || !write_modules(argv[1], modules))
+        return -1;
+    fprintf(stdout, "%zu spirv modules precompiled\n", modules.size());
+    return 0;
+}
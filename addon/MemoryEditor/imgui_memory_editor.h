@@ -20,6 +20,12 @@
 //   mem_edit_2.DrawContents(this, sizeof(*this), (size_t)this);
 //   ImGui::End();
 //
+// Usage:
+//   // Large or virtual data (files, remote processes) read a page at a time, mem_data is only passed back to the handlers:
+//   static MemoryEditor mem_edit_3;
+//   mem_edit_3.PageReadFn = [](const ImU8* file, size_t off, ImU8* buf, size_t size) -> size_t { return pread(fileno((FILE*)file), buf, size, off); };
+//   mem_edit_3.DrawWindow("File", file, file_size);
+//
 // Changelog:
 // - v0.10: initial version
 // - v0.23 (2017/08/17): added to github. fixed right-arrow triggering a byte write.
@@ -39,6 +45,7 @@
 // - v0.43 (2021/03/12): added OptFooterExtraHeight to allow for custom drawing at the bottom of the editor [@leiradel]
 // - v0.44 (2021/03/12): use ImGuiInputTextFlags_AlwaysOverwrite in 1.82 + fix hardcoded width.
 // - v0.50 (2021/11/12): various fixes for recent dear imgui versions (fixed misuse of clipper, relying on SetKeyboardFocusHere() handling scrolling from 1.85). added default size.
+// - v0.51 (2026/10/19): added PageReadFn with LRU page cache and prefetch of rows around the view for large or virtual data (scrolling is windowed past 1M rows, jump with the address input), HighlightRangeFn, background search of hex/ascii patterns.
 //
 // Todo/Bugs:
 // - This is generally old/crappy code, it should work but isn't very good.. to be rewritten some day.
@@ -50,6 +57,20 @@
 
 #include <stdio.h>      // sprintf, scanf
 #include <stdint.h>     // uint8_t, etc.
+#include <string.h>     // memchr, memcmp
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>     // _BitScanForward
+#endif
 
 #ifdef _MSC_VER
 #define _PRISizeT   "I"
@@ -91,6 +112,12 @@ struct MemoryEditor
     ImU8            (*ReadFn)(const ImU8* data, size_t off);    // = 0      // optional handler to read bytes.
     void            (*WriteFn)(ImU8* data, size_t off, ImU8 d); // = 0      // optional handler to write bytes.
     bool            (*HighlightFn)(const ImU8* data, size_t off);//= 0      // optional handler to return Highlight property (to support non-contiguous highlighting).
+    void            (*HighlightRangeFn)(const ImU8* data, size_t off, size_t size, bool* highlight); // = 0 // optional handler to return Highlight property of a whole row at once, used instead of HighlightFn.
+    size_t          (*PageReadFn)(const ImU8* data, size_t off, ImU8* buf, size_t size); // = 0 // optional handler to read pages of bytes, returns bytes read. mem_data is then only passed back and mem_size may exceed memory. must be thread safe when searching.
+    size_t          PageSize;                                   // = 4096   // bytes per PageReadFn page.
+    int             PageCacheCount;                             // = 256    // pages kept by PageReadFn, least recently used are dropped. grows to twice the pages around the view.
+    int             OptPrefetchRows;                            // = 64     // rows read ahead above and below the visible ones with PageReadFn.
+    bool            OptSearchHex;                               // = true   // search pattern is hex bytes like "DE AD BE EF", otherwise ascii text.
 
     // [Internal State]
     bool            ContentsWidthChanged;
@@ -103,6 +130,43 @@ struct MemoryEditor
     size_t          HighlightMin, HighlightMax;
     int             PreviewEndianess;
     ImGuiDataType   PreviewDataType;
+    size_t          ScrollBaseLine, ScrollBaseLineNext;        // first line of the scrolling window when there are more lines than ScrollWindowLines
+    char            SearchInputBuf[64];
+    size_t          SearchPatternSize;
+    size_t          SearchResultIndex;
+
+    struct CachedPage
+    {
+        size_t              Index;
+        size_t              Size;
+        unsigned int        LastUse;
+        std::vector<ImU8>   Data;
+    };
+    std::vector<CachedPage>             Pages;
+    std::unordered_map<size_t, int>     PageSlots;
+    std::vector<ImU8>                   PageReadBuf;
+    ImVector<ImU8>                      RowData;
+    ImVector<bool>                      RowHighlight;
+    unsigned int    PageUseCounter;
+    int             PageLastSlot;
+    const void*     PageCacheData;
+    size_t          PageCacheMemSize, PageCachePageSize;
+    size_t          PageReadCount;                              // PageReadFn calls, for statistics
+
+    // state of the search thread, kept apart so the editor can move while it runs
+    struct SearchState
+    {
+        std::thread             Thread;
+        std::atomic<bool>       Running {false};
+        std::atomic<bool>       Cancel {false};
+        std::atomic<size_t>     Scanned {0};
+        std::atomic<size_t>     Matches {0};
+        size_t                  Size {0};
+        std::mutex              Mutex;
+        std::vector<size_t>     Results;                        // first SearchMaxResults match addresses, sorted
+    };
+    std::unique_ptr<SearchState> Search;
+    enum { SearchMaxResults = 1 << 16, SearchChunkSize = 1 << 20, ScrollWindowLines = 1 << 20 };
 
     MemoryEditor()
     {
@@ -123,6 +187,12 @@ struct MemoryEditor
         ReadFn = NULL;
         WriteFn = NULL;
         HighlightFn = NULL;
+        HighlightRangeFn = NULL;
+        PageReadFn = NULL;
+        PageSize = 4096;
+        PageCacheCount = 256;
+        OptPrefetchRows = 64;
+        OptSearchHex = true;
 
         // State/Internals
         ContentsWidthChanged = false;
@@ -134,6 +204,20 @@ struct MemoryEditor
         HighlightMin = HighlightMax = (size_t)-1;
         PreviewEndianess = 0;
         PreviewDataType = ImGuiDataType_S32;
+        ScrollBaseLine = ScrollBaseLineNext = 0;
+        memset(SearchInputBuf, 0, sizeof(SearchInputBuf));
+        SearchPatternSize = 0;
+        SearchResultIndex = (size_t)-1;
+        PageUseCounter = 0;
+        PageLastSlot = -1;
+        PageCacheData = NULL;
+        PageCacheMemSize = PageCachePageSize = 0;
+        PageReadCount = 0;
+    }
+
+    ~MemoryEditor()
+    {
+        CancelSearch();
     }
 
     void GotoAddrAndHighlight(size_t addr_min, size_t addr_max)
@@ -143,6 +227,320 @@ struct MemoryEditor
         HighlightMax = addr_max;
     }
 
+    // Page cache of PageReadFn, call InvalidatePages() when the underlying data changes
+    void InvalidatePages()
+    {
+        Pages.clear();
+        PageSlots.clear();
+        PageLastSlot = -1;
+    }
+
+    CachedPage* FindPage(size_t index)
+    {
+        if (PageLastSlot >= 0 && Pages[PageLastSlot].Index == index)
+            return &Pages[PageLastSlot];
+        std::unordered_map<size_t, int>::iterator it = PageSlots.find(index);
+        if (it == PageSlots.end())
+            return NULL;
+        PageLastSlot = it->second;
+        return &Pages[it->second];
+    }
+
+    int AllocPage(int capacity)
+    {
+        if ((int)Pages.size() < capacity)
+        {
+            Pages.push_back(CachedPage());
+            Pages.back().Data.resize(PageSize);
+            return (int)Pages.size() - 1;
+        }
+        int slot = 0;
+        for (int i = 1; i < (int)Pages.size(); i++)
+            if (Pages[i].LastUse < Pages[slot].LastUse)
+                slot = i;
+        PageSlots.erase(Pages[slot].Index);
+        if (PageLastSlot == slot)
+            PageLastSlot = -1;
+        return slot;
+    }
+
+    // Touch pages [first, first + count) and read the missing ones, one PageReadFn call per run of up to 64 pages
+    void FetchPages(const ImU8* mem_data, size_t first, size_t count)
+    {
+        const int capacity = std::max<int>(PageCacheCount, (int)count * 2);
+        PageUseCounter++;
+        for (size_t i = first; i < first + count;)
+        {
+            if (CachedPage* page = FindPage(i))
+            {
+                page->LastUse = PageUseCounter;
+                i++;
+                continue;
+            }
+            size_t run = 1;
+            while (i + run < first + count && run < 64 && PageSlots.find(i + run) == PageSlots.end())
+                run++;
+            const size_t off = i * PageSize;
+            const size_t size = std::min<size_t>(run * PageSize, PageCacheMemSize - off);
+            PageReadBuf.resize(run * PageSize);
+            size_t read = PageReadFn(mem_data, off, PageReadBuf.data(), size);
+            PageReadCount++;
+            if (read > size)
+                read = size;
+            memset(PageReadBuf.data() + read, 0, run * PageSize - read); // unreadable bytes show as zeroes
+            for (size_t k = 0; k < run; k++)
+            {
+                const int slot = AllocPage(capacity);
+                CachedPage& page = Pages[slot];
+                page.Index = i + k;
+                page.Size = std::min<size_t>(PageSize, PageCacheMemSize - (i + k) * PageSize);
+                page.LastUse = PageUseCounter;
+                memcpy(page.Data.data(), PageReadBuf.data() + k * PageSize, PageSize);
+                PageSlots[i + k] = slot;
+            }
+            i += run;
+        }
+    }
+
+    void PrefetchLines(const ImU8* mem_data, size_t line_start, size_t line_end)
+    {
+        const size_t line_total_count = (PageCacheMemSize + Cols - 1) / Cols;
+        const size_t prefetch = (size_t)std::max<int>(OptPrefetchRows, 0);
+        line_start = line_start > prefetch ? line_start - prefetch : 0;
+        line_end = std::min<size_t>(line_end + prefetch, line_total_count);
+        const size_t addr_start = line_start * Cols;
+        const size_t addr_end = std::min<size_t>(line_end * Cols, PageCacheMemSize);
+        if (addr_end > addr_start)
+            FetchPages(mem_data, addr_start / PageSize, (addr_end - 1) / PageSize - addr_start / PageSize + 1);
+    }
+
+    void ReadBytes(const ImU8* mem_data, size_t addr, ImU8* out, size_t size)
+    {
+        if (PageReadFn)
+        {
+            while (size > 0)
+            {
+                const size_t index = addr / PageSize;
+                const size_t offset = addr - index * PageSize;
+                CachedPage* page = FindPage(index);
+                if (!page)
+                {
+                    FetchPages(mem_data, index, 1);
+                    page = FindPage(index);
+                }
+                const size_t n = std::min<size_t>(size, PageSize - offset);
+                memcpy(out, page->Data.data() + offset, n);
+                out += n;
+                addr += n;
+                size -= n;
+            }
+        }
+        else if (ReadFn)
+        {
+            for (size_t i = 0; i < size; i++)
+                out[i] = ReadFn(mem_data, addr + i);
+        }
+        else
+            memcpy(out, mem_data + addr, size);
+    }
+
+    void WriteByte(ImU8* mem_data, size_t addr, ImU8 value)
+    {
+        if (WriteFn)
+            WriteFn(mem_data, addr, value);
+        else
+            mem_data[addr] = value;
+        if (PageReadFn)
+            if (CachedPage* page = FindPage(addr / PageSize))
+                page->Data[addr % PageSize] = value;
+    }
+
+    // Search for a byte pattern on a background thread, results are sorted addresses of the first SearchMaxResults matches
+    bool StartSearch(const void* mem_data, size_t mem_size, const ImU8* pattern, size_t pattern_size)
+    {
+        CancelSearch();
+        Search.reset();
+        SearchPatternSize = 0;
+        SearchResultIndex = (size_t)-1;
+        if (pattern_size == 0 || pattern_size > SearchChunkSize || pattern_size > mem_size)
+            return false;
+        Search.reset(new SearchState());
+        SearchState* state = Search.get();
+        state->Size = mem_size;
+        state->Running = true;
+        SearchPatternSize = pattern_size;
+        std::vector<ImU8> needle(pattern, pattern + pattern_size);
+        ImU8 (*read_fn)(const ImU8*, size_t) = ReadFn;
+        size_t (*page_read_fn)(const ImU8*, size_t, ImU8*, size_t) = PageReadFn;
+        state->Thread = std::thread([state, mem_data, mem_size, needle, read_fn, page_read_fn]()
+        {
+            SearchWorker(state, (const ImU8*)mem_data, mem_size, needle, read_fn, page_read_fn);
+            state->Running = false;
+        });
+        return true;
+    }
+
+    void CancelSearch()
+    {
+        if (Search && Search->Thread.joinable())
+        {
+            Search->Cancel = true;
+            Search->Thread.join();
+        }
+    }
+
+    bool IsSearching() const { return Search && Search->Running; }
+    float GetSearchProgress() const { return Search && Search->Size ? (float)((double)Search->Scanned / (double)Search->Size) : 0.0f; }
+    size_t GetSearchMatchCount() const { return Search ? Search->Matches.load() : 0; }
+    size_t GetSearchResultCount() const { return Search ? std::min<size_t>(Search->Matches.load(), (size_t)SearchMaxResults) : 0; }
+    size_t GetSearchResult(size_t index) const
+    {
+        if (!Search)
+            return (size_t)-1;
+        std::lock_guard<std::mutex> lock(Search->Mutex);
+        return index < Search->Results.size() ? Search->Results[index] : (size_t)-1;
+    }
+
+    // Scan in chunks overlapping by pattern_size - 1, so matches across chunks are found once
+    static void SearchWorker(SearchState* state, const ImU8* mem_data, size_t mem_size, const std::vector<ImU8>& pattern, ImU8 (*read_fn)(const ImU8*, size_t), size_t (*page_read_fn)(const ImU8*, size_t, ImU8*, size_t))
+    {
+        const size_t pattern_size = pattern.size();
+        std::vector<ImU8> buf;
+        std::vector<size_t> found;
+        for (size_t pos = 0; pos + pattern_size <= mem_size && !state->Cancel; pos += SearchChunkSize)
+        {
+            const size_t len = std::min<size_t>((size_t)SearchChunkSize + pattern_size - 1, mem_size - pos);
+            const ImU8* data = mem_data + pos;
+            if (page_read_fn || read_fn)
+            {
+                buf.resize(len);
+                if (page_read_fn)
+                {
+                    size_t read = page_read_fn(mem_data, pos, buf.data(), len);
+                    if (read < len)
+                        memset(buf.data() + read, 0, len - read);
+                }
+                else
+                    for (size_t i = 0; i < len; i++)
+                        buf[i] = read_fn(mem_data, pos + i);
+                data = buf.data();
+            }
+            found.clear();
+            for (const ImU8* p = data; (p = FindBytes(p, len - (size_t)(p - data), pattern.data(), pattern_size)) != NULL; p++)
+                found.push_back(pos + (size_t)(p - data));
+            if (!found.empty())
+            {
+                std::lock_guard<std::mutex> lock(state->Mutex);
+                const size_t room = SearchMaxResults - state->Results.size();
+                state->Results.insert(state->Results.end(), found.begin(), found.begin() + std::min<size_t>(room, found.size()));
+            }
+            state->Matches += found.size();
+            state->Scanned = std::min<size_t>(pos + (size_t)SearchChunkSize, mem_size);
+        }
+        if (!state->Cancel)
+            state->Scanned = mem_size;
+    }
+
+    static inline int CountTrailingZeros(unsigned int v)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, v);
+        return (int)index;
+#else
+        return __builtin_ctz(v);
+#endif
+    }
+
+    // memmem, candidates where first and last pattern bytes match are found 32 or 16 at a time, then compared
+    static const ImU8* FindBytes(const ImU8* data, size_t size, const ImU8* pattern, size_t pattern_size)
+    {
+        if (pattern_size == 0)
+            return data;
+        if (pattern_size > size)
+            return NULL;
+        if (pattern_size == 1)
+            return (const ImU8*)memchr(data, pattern[0], size);
+        const size_t last = pattern_size - 1;
+        const size_t end = size - last;
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i first32 = _mm256_set1_epi8((char)pattern[0]);
+        const __m256i last32 = _mm256_set1_epi8((char)pattern[last]);
+        for (; i + 32 <= end; i += 32)
+        {
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(data + i));
+            const __m256i b = _mm256_loadu_si256((const __m256i*)(data + i + last));
+            unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first32), _mm256_cmpeq_epi8(b, last32)));
+            for (; mask != 0; mask &= mask - 1)
+            {
+                const size_t k = i + CountTrailingZeros(mask);
+                if (memcmp(data + k + 1, pattern + 1, last - 1) == 0)
+                    return data + k;
+            }
+        }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+        const __m128i first16 = _mm_set1_epi8((char)pattern[0]);
+        const __m128i last16 = _mm_set1_epi8((char)pattern[last]);
+        for (; i + 16 <= end; i += 16)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i*)(data + i));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(data + i + last));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first16), _mm_cmpeq_epi8(b, last16)));
+            for (; mask != 0; mask &= mask - 1)
+            {
+                const size_t k = i + CountTrailingZeros(mask);
+                if (memcmp(data + k + 1, pattern + 1, last - 1) == 0)
+                    return data + k;
+            }
+        }
+#endif
+        for (; i < end; i++)
+        {
+            const ImU8* p = (const ImU8*)memchr(data + i, pattern[0], end - i);
+            if (!p)
+                return NULL;
+            i = (size_t)(p - data);
+            if (data[i + last] == pattern[last] && memcmp(p + 1, pattern + 1, last - 1) == 0)
+                return p;
+        }
+        return NULL;
+    }
+
+    // Hex pairs with optional spaces, or the text as is. Returns pattern size, 0 when invalid
+    size_t ParseSearchPattern(const char* text, ImU8* out, size_t out_size) const
+    {
+        size_t n = 0;
+        if (!OptSearchHex)
+        {
+            for (; text[n] && n < out_size; n++)
+                out[n] = (ImU8)text[n];
+            return n;
+        }
+        int nibbles = 0;
+        for (; *text; text++)
+        {
+            const char c = *text;
+            int v;
+            if (c == ' ') continue;
+            else if (c >= '0' && c <= '9') v = c - '0';
+            else if (c >= 'a' && c <= 'f') v = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') v = c - 'A' + 10;
+            else return 0;
+            if ((nibbles & 1) == 0)
+            {
+                if (n == out_size)
+                    return 0;
+                out[n++] = (ImU8)(v << 4);
+            }
+            else
+                out[n - 1] |= (ImU8)v;
+            nibbles++;
+        }
+        return (nibbles & 1) ? 0 : n;
+    }
+
     struct Sizes
     {
         int     AddrDigitsCount;
@@ -215,6 +613,18 @@ struct MemoryEditor
         CalcSizes(s, mem_size, base_display_addr);
         ImGuiStyle& style = ImGui::GetStyle();
 
+        // Page cache belongs to one data source, without WriteFn paged data can't be written
+        if (PageSize == 0)
+            PageSize = 4096;
+        if (PageReadFn && (PageCacheData != mem_data_void || PageCacheMemSize != mem_size || PageCachePageSize != PageSize))
+        {
+            InvalidatePages();
+            PageCacheData = mem_data_void;
+            PageCacheMemSize = mem_size;
+            PageCachePageSize = PageSize;
+        }
+        const bool read_only = ReadOnly || (PageReadFn && !WriteFn);
+
         // We begin into our scrolling region with the 'ImGuiWindowFlags_NoMove' in order to prevent click from moving the window.
         // This is used as a facility since our main click detection code doesn't assign an ActiveId so the click would normally be caught as a window-move.
         const float height_separator = style.ItemSpacing.y;
@@ -229,14 +639,33 @@ struct MemoryEditor
         ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
 
+        // Past ScrollWindowLines the clipper scrolls a window of lines starting at ScrollBaseLine, as the int line count and the float
+        // scroll position don't reach every line. The window moves by half when scrolled near its ends, the matching scroll is
+        // requested now and both apply next frame.
+        const size_t line_total_count = (mem_size + Cols - 1) / Cols;
+        ScrollBaseLine = ScrollBaseLineNext;
+        if (line_total_count <= ScrollWindowLines)
+            ScrollBaseLine = ScrollBaseLineNext = 0;
+        else if (ScrollBaseLine > line_total_count - ScrollWindowLines)
+            ScrollBaseLine = ScrollBaseLineNext = line_total_count - ScrollWindowLines;
+        if (line_total_count > ScrollWindowLines)
+        {
+            const float scroll_line = ImGui::GetScrollY() / s.LineHeight;
+            if (scroll_line < ScrollWindowLines / 4 && ScrollBaseLine > 0)
+                ScrollBaseLineNext = ScrollBaseLine > ScrollWindowLines / 2 ? ScrollBaseLine - ScrollWindowLines / 2 : 0;
+            else if (scroll_line > ScrollWindowLines / 4 * 3 && ScrollBaseLine + ScrollWindowLines < line_total_count)
+                ScrollBaseLineNext = std::min<size_t>(ScrollBaseLine + ScrollWindowLines / 2, line_total_count - ScrollWindowLines);
+            if (ScrollBaseLineNext != ScrollBaseLine)
+                ImGui::SetScrollY(ImGui::GetScrollY() + (float)((double)ScrollBaseLine - (double)ScrollBaseLineNext) * s.LineHeight);
+        }
+
         // We are not really using the clipper API correctly here, because we rely on visible_start_addr/visible_end_addr for our scrolling function.
-        const int line_total_count = (int)((mem_size + Cols - 1) / Cols);
         ImGuiListClipper clipper;
-        clipper.Begin(line_total_count, s.LineHeight);
+        clipper.Begin((int)std::min<size_t>(line_total_count - ScrollBaseLine, (size_t)ScrollWindowLines), s.LineHeight);
 
         bool data_next = false;
 
-        if (ReadOnly || DataEditingAddr >= mem_size)
+        if (read_only || DataEditingAddr >= mem_size)
             DataEditingAddr = (size_t)-1;
         if (DataPreviewAddr >= mem_size)
             DataPreviewAddr = (size_t)-1;
@@ -266,10 +695,20 @@ struct MemoryEditor
         const char* format_byte = OptUpperCaseHex ? "%02X" : "%02x";
         const char* format_byte_space = OptUpperCaseHex ? "%02X " : "%02x ";
 
+        RowData.resize(Cols);
+        RowHighlight.resize(Cols);
         while (clipper.Step())
+        {
+            // Paged data reads the visible rows and the ones around them in bulk
+            if (PageReadFn)
+                PrefetchLines(mem_data, ScrollBaseLine + clipper.DisplayStart, ScrollBaseLine + clipper.DisplayEnd);
             for (int line_i = clipper.DisplayStart; line_i < clipper.DisplayEnd; line_i++) // display only visible lines
             {
-                size_t addr = (size_t)(line_i * Cols);
+                size_t addr = (ScrollBaseLine + (size_t)line_i) * Cols;
+                const size_t row_size = std::min<size_t>((size_t)Cols, mem_size - addr);
+                ReadBytes(mem_data, addr, RowData.Data, row_size);
+                if (HighlightRangeFn)
+                    HighlightRangeFn(mem_data, addr, row_size, RowHighlight.Data);
                 ImGui::Text(format_address, s.AddrDigitsCount, base_display_addr + addr);
 
                 // Draw Hexadecimal
@@ -282,13 +721,13 @@ struct MemoryEditor
 
                     // Draw highlight
                     bool is_highlight_from_user_range = (addr >= HighlightMin && addr < HighlightMax);
-                    bool is_highlight_from_user_func = (HighlightFn && HighlightFn(mem_data, addr));
+                    bool is_highlight_from_user_func = HighlightRangeFn ? RowHighlight[n] : (HighlightFn && HighlightFn(mem_data, addr));
                     bool is_highlight_from_preview = (addr >= DataPreviewAddr && addr < DataPreviewAddr + preview_data_type_size);
                     if (is_highlight_from_user_range || is_highlight_from_user_func || is_highlight_from_preview)
                     {
                         ImVec2 pos = ImGui::GetCursorScreenPos();
                         float highlight_width = s.GlyphWidth * 2;
-                        bool is_next_byte_highlighted = (addr + 1 < mem_size) && ((HighlightMax != (size_t)-1 && addr + 1 < HighlightMax) || (HighlightFn && HighlightFn(mem_data, addr + 1)));
+                        bool is_next_byte_highlighted = (addr + 1 < mem_size) && ((HighlightMax != (size_t)-1 && addr + 1 < HighlightMax) || (HighlightRangeFn ? (n + 1 < (int)row_size && RowHighlight[n + 1]) : (HighlightFn && HighlightFn(mem_data, addr + 1))));
                         if (is_next_byte_highlighted || (n + 1 == Cols))
                         {
                             highlight_width = s.HexCellWidth;
@@ -307,7 +746,7 @@ struct MemoryEditor
                         {
                             ImGui::SetKeyboardFocusHere(0);
                             snprintf(AddrInputBuf, 32, format_data, s.AddrDigitsCount, base_display_addr + addr);
-                            snprintf(DataInputBuf, 32, format_byte, ReadFn ? ReadFn(mem_data, addr) : mem_data[addr]);
+                            snprintf(DataInputBuf, 32, format_byte, RowData[n]);
                         }
                         struct UserData
                         {
@@ -334,7 +773,7 @@ struct MemoryEditor
                         };
                         UserData user_data;
                         user_data.CursorPos = -1;
-                        snprintf(user_data.CurrentBufOverwrite, 3, format_byte, ReadFn ? ReadFn(mem_data, addr) : mem_data[addr]);
+                        snprintf(user_data.CurrentBufOverwrite, 3, format_byte, RowData[n]);
                         ImGuiInputTextFlags flags = ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll | ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_CallbackAlways;
 #if IMGUI_VERSION_NUM >= 18104
                         flags |= ImGuiInputTextFlags_AlwaysOverwrite;
@@ -353,18 +792,13 @@ struct MemoryEditor
                             data_write = data_next = false;
                         unsigned int data_input_value = 0;
                         if (data_write && sscanf(DataInputBuf, "%X", &data_input_value) == 1)
-                        {
-                            if (WriteFn)
-                                WriteFn(mem_data, addr, (ImU8)data_input_value);
-                            else
-                                mem_data[addr] = (ImU8)data_input_value;
-                        }
+                            WriteByte(mem_data, addr, (ImU8)data_input_value);
                         ImGui::PopID();
                     }
                     else
                     {
                         // NB: The trailing space is not visible but ensure there's no gap that the mouse cannot click on.
-                        ImU8 b = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+                        ImU8 b = RowData[n];
 
                         if (OptShowHexII)
                         {
@@ -384,7 +818,7 @@ struct MemoryEditor
                             else
                                 ImGui::Text(format_byte_space, b);
                         }
-                        if (!ReadOnly && ImGui::IsItemHovered() && ImGui::IsMouseClicked(0))
+                        if (!read_only && ImGui::IsItemHovered() && ImGui::IsMouseClicked(0))
                         {
                             DataEditingTakeFocus = true;
                             data_editing_addr_next = addr;
@@ -397,7 +831,7 @@ struct MemoryEditor
                     // Draw ASCII values
                     ImGui::SameLine(s.PosAsciiStart);
                     ImVec2 pos = ImGui::GetCursorScreenPos();
-                    addr = line_i * Cols;
+                    addr = (ScrollBaseLine + (size_t)line_i) * Cols;
                     ImGui::PushID(line_i);
                     if (ImGui::InvisibleButton("ascii", ImVec2(s.PosAsciiEnd - s.PosAsciiStart, s.LineHeight)))
                     {
@@ -412,13 +846,14 @@ struct MemoryEditor
                             draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), ImGui::GetColorU32(ImGuiCol_FrameBg));
                             draw_list->AddRectFilled(pos, ImVec2(pos.x + s.GlyphWidth, pos.y + s.LineHeight), ImGui::GetColorU32(ImGuiCol_TextSelectedBg));
                         }
-                        unsigned char c = ReadFn ? ReadFn(mem_data, addr) : mem_data[addr];
+                        unsigned char c = RowData[n];
                         char display_c = (c < 32 || c >= 128) ? '.' : c;
                         draw_list->AddText(pos, (display_c == c) ? color_text : color_disabled, &display_c, &display_c + 1);
                         pos.x += s.GlyphWidth;
                     }
                 }
             }
+        }
         ImGui::PopStyleVar(2);
         ImGui::EndChild();
 
@@ -452,7 +887,6 @@ struct MemoryEditor
 
     void DrawOptionsLine(const Sizes& s, void* mem_data, size_t mem_size, size_t base_display_addr)
     {
-        IM_UNUSED(mem_data);
         ImGuiStyle& style = ImGui::GetStyle();
         const char* format_range = OptUpperCaseHex ? "Range %0*" _PRISizeT "X..%0*" _PRISizeT "X" : "Range %0*" _PRISizeT "x..%0*" _PRISizeT "x";
 
@@ -468,6 +902,7 @@ struct MemoryEditor
             if (ImGui::Checkbox("Show Ascii", &OptShowAscii)) { ContentsWidthChanged = true; }
             ImGui::Checkbox("Grey out zeroes", &OptGreyOutZeroes);
             ImGui::Checkbox("Uppercase Hex", &OptUpperCaseHex);
+            ImGui::Checkbox("Search Hex", &OptSearchHex);
 
             ImGui::EndPopup();
         }
@@ -486,12 +921,61 @@ struct MemoryEditor
             }
         }
 
+        // Search, results step from the current one
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(s.GlyphWidth * 16 + style.FramePadding.x * 2.0f);
+        if (ImGui::InputTextWithHint("##search", OptSearchHex ? "Find hex" : "Find text", SearchInputBuf, IM_ARRAYSIZE(SearchInputBuf), ImGuiInputTextFlags_EnterReturnsTrue))
+        {
+            ImU8 pattern[IM_ARRAYSIZE(SearchInputBuf)];
+            size_t pattern_size = ParseSearchPattern(SearchInputBuf, pattern, sizeof(pattern));
+            if (pattern_size > 0)
+                StartSearch(mem_data, mem_size, pattern, pattern_size);
+        }
+        if (Search)
+        {
+            char found[32];
+            ImSnprintf(found, IM_ARRAYSIZE(found), "%" _PRISizeT "u found", GetSearchMatchCount());
+            ImGui::SameLine();
+            if (IsSearching())
+            {
+                ImGui::ProgressBar(GetSearchProgress(), ImVec2(s.GlyphWidth * 16, 0.0f), found);
+                ImGui::SameLine();
+                if (ImGui::Button("Cancel"))
+                    CancelSearch();
+            }
+            else
+                ImGui::TextUnformatted(found);
+            const size_t result_count = GetSearchResultCount();
+            if (result_count > 0)
+            {
+                size_t result_index = SearchResultIndex;
+                ImGui::SameLine();
+                if (ImGui::ArrowButton("##prev", ImGuiDir_Left))
+                    result_index = result_index == (size_t)-1 || result_index == 0 ? result_count - 1 : result_index - 1;
+                ImGui::SameLine();
+                if (ImGui::ArrowButton("##next", ImGuiDir_Right))
+                    result_index = result_index + 1 >= result_count ? 0 : result_index + 1;
+                if (result_index != SearchResultIndex)
+                {
+                    SearchResultIndex = result_index;
+                    size_t addr = GetSearchResult(result_index);
+                    GotoAddrAndHighlight(addr, addr + SearchPatternSize);
+                }
+            }
+        }
+
         if (GotoAddr != (size_t)-1)
         {
             if (GotoAddr < mem_size)
             {
+                // Windowed scrolling centers the window on the address
+                const size_t line_total_count = (mem_size + Cols - 1) / Cols;
+                const size_t goto_line = GotoAddr / Cols;
+                ScrollBaseLineNext = 0;
+                if (line_total_count > ScrollWindowLines)
+                    ScrollBaseLineNext = std::min<size_t>(goto_line > ScrollWindowLines / 2 ? goto_line - ScrollWindowLines / 2 : 0, line_total_count - ScrollWindowLines);
                 ImGui::BeginChild("##scrolling");
-                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + (GotoAddr / Cols) * ImGui::GetTextLineHeight());
+                ImGui::SetScrollFromPosY(ImGui::GetCursorStartPos().y + (goto_line - ScrollBaseLineNext) * ImGui::GetTextLineHeight());
                 ImGui::EndChild();
                 DataEditingAddr = DataPreviewAddr = GotoAddr;
                 DataEditingTakeFocus = true;
@@ -623,16 +1107,12 @@ struct MemoryEditor
     }
 
     // [Internal]
-    void DrawPreviewData(size_t addr, const ImU8* mem_data, size_t mem_size, ImGuiDataType data_type, DataFormat data_format, char* out_buf, size_t out_buf_size) const
+    void DrawPreviewData(size_t addr, const ImU8* mem_data, size_t mem_size, ImGuiDataType data_type, DataFormat data_format, char* out_buf, size_t out_buf_size)
     {
         uint8_t buf[8];
         size_t elem_size = DataTypeGetSize(data_type);
         size_t size = addr + elem_size > mem_size ? mem_size - addr : elem_size;
-        if (ReadFn)
-            for (int i = 0, n = (int)size; i < n; ++i)
-                buf[i] = ReadFn(mem_data, addr + i);
-        else
-            memcpy(buf, mem_data + addr, size);
+        ReadBytes(mem_data, addr, buf, size);
 
         if (data_format == DataFormat_Bin)
         {
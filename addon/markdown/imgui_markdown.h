@@ -201,6 +201,14 @@ void Markdown( const std::string& markdown_ )
     ImGui::Markdown( markdown_.c_str(), markdown_.length(), mdConfig );
 }
 
+// For long texts such as help pages keep a MarkdownDocument, which parses the text once and
+// only renders the lines inside the clip rect, the text is compared to the previous one
+static ImGui::MarkdownDocument helpDocument;
+void MarkdownHelp( const std::string& markdown_ )
+{
+    ImGui::Markdown( helpDocument, markdown_.c_str(), markdown_.length(), mdConfig );
+}
+
 void MarkdownExample()
 {
     const std::string markdownText = u8R"(
@@ -227,6 +235,9 @@ ___
 
 
 #include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
 
 namespace ImGui
 {
@@ -331,6 +342,10 @@ namespace ImGui
 
     inline void Markdown( const char* markdown_, size_t markdownLength_, const MarkdownConfig& mdConfig_ );
 
+    // Cached version for long texts, see MarkdownDocument
+    struct MarkdownDocument;
+    inline void Markdown( MarkdownDocument& document_, const char* markdown_, size_t markdownLength_, const MarkdownConfig& mdConfig_ );
+
     //-----------------------------------------------------------------------------
     // Internals
     //-----------------------------------------------------------------------------
@@ -1028,4 +1043,181 @@ namespace ImGui
         }
     }
 
+
+    // Markdown text parsed once and kept between frames.
+    // The renderer resets all state at each new line, so the text is split into lines (blocks) which render independently.
+    // Block heights are measured by rendering the whole text once per layout, keyed by content width and font, after that
+    // only blocks intersecting the clip rect are rendered and the others are skipped with one Dummy above and one below.
+    // Re-layout happens on text change, resize or font change, call Invalidate() after changing the config.
+    struct MarkdownBlock
+    {
+        int                     start = 0;                          // offset of the first character
+        int                     end = 0;                            // offset after the new line
+        float                   offset = 0.0f;                      // y from the document start
+        float                   height = 0.0f;                      // cursor advance, including item spacing
+    };
+
+    struct MarkdownDocument
+    {
+        std::string                 text;
+        std::vector<MarkdownBlock>  blocks;
+        bool                        layoutValid = false;
+        bool                        offsetsValid = false;
+        float                       layoutWidth = 0.0f;
+        ImFont*                     layoutFont = NULL;
+        float                       layoutFontSize = 0.0f;
+        float                       layoutFontScale = 0.0f;
+        int                         renderedBlocks = 0;             // blocks rendered by the last Render(), for statistics
+
+        // copies and splits the text, nothing happens if it didn't change
+        void SetText( const char* markdown_, size_t markdownLength_ )
+        {
+            const char* nul = (const char*)memchr( markdown_, 0, markdownLength_ );   // the renderer stops at 0
+            if( nul )
+            {
+                markdownLength_ = (size_t)( nul - markdown_ );
+            }
+            if( markdownLength_ == text.size() && memcmp( markdown_, text.data(), markdownLength_ ) == 0 )
+            {
+                return;
+            }
+            text.assign( markdown_, markdownLength_ );
+            blocks.clear();
+            const char* data = text.data();
+            int start = 0;
+            while( start < (int)text.size() )
+            {
+                const char* newLine = (const char*)memchr( data + start, '\n', text.size() - start );
+                MarkdownBlock block;
+                block.start = start;
+                block.end = newLine ? (int)( newLine - data ) + 1 : (int)text.size();
+                blocks.push_back( block );
+                start = block.end;
+            }
+            Invalidate();
+        }
+
+        void Invalidate()
+        {
+            layoutValid = false;
+            offsetsValid = false;
+        }
+
+        float Height() const
+        {
+            return blocks.empty() ? 0.0f : blocks.back().offset + blocks.back().height;
+        }
+
+        void Render( const MarkdownConfig& mdConfig_ )
+        {
+            const float width = ImGui::GetContentRegionAvail().x;
+            ImFont* font = ImGui::GetFont();
+            const float fontSize = ImGui::GetFontSize();
+            const float fontScale = ImGui::GetIO().FontGlobalScale;
+            if( width != layoutWidth || font != layoutFont || fontSize != layoutFontSize || fontScale != layoutFontScale )
+            {
+                layoutWidth = width;
+                layoutFont = font;
+                layoutFontSize = fontSize;
+                layoutFontScale = fontScale;
+                layoutValid = false;
+            }
+            renderedBlocks = 0;
+            if( blocks.empty() )
+            {
+                return;
+            }
+            if( !layoutValid )
+            {
+                // render everything once to measure
+                for( size_t i = 0; i < blocks.size(); ++i )
+                {
+                    RenderBlock( i, mdConfig_ );
+                }
+                layoutValid = true;
+                offsetsValid = false;
+                UpdateOffsets();
+                return;
+            }
+            UpdateOffsets();
+
+            // blocks intersecting the clip rect, found by offset
+            ImDrawList* drawList = ImGui::GetWindowDrawList();
+            const float top = ImGui::GetCursorScreenPos().y;
+            const float clipMin = drawList->GetClipRectMin().y - top;
+            const float clipMax = drawList->GetClipRectMax().y - top;
+            size_t first = FindBlock( clipMin );
+            size_t last = FindBlock( clipMax ) + 1;
+            const float spacing = ImGui::GetStyle().ItemSpacing.y;
+            if( first > 0 )
+            {
+                ImGui::Dummy( ImVec2( 0.0f, blocks[ first ].offset - spacing ) );
+            }
+            for( size_t i = first; i < last; ++i )
+            {
+                RenderBlock( i, mdConfig_ );
+            }
+            if( last < blocks.size() )
+            {
+                ImGui::Dummy( ImVec2( 0.0f, Height() - blocks[ last ].offset - spacing ) );
+            }
+        }
+
+    private:
+        // renders one line and keeps its height, a changed height moves the following blocks
+        void RenderBlock( size_t index_, const MarkdownConfig& mdConfig_ )
+        {
+            MarkdownBlock& block = blocks[ index_ ];
+            const float y = ImGui::GetCursorPosY();
+            Markdown( text.data() + block.start, (size_t)( block.end - block.start ), mdConfig_ );
+            const float height = ImGui::GetCursorPosY() - y;
+            if( height != block.height )
+            {
+                block.height = height;
+                offsetsValid = false;
+            }
+            ++renderedBlocks;
+        }
+
+        void UpdateOffsets()
+        {
+            if( offsetsValid )
+            {
+                return;
+            }
+            float offset = 0.0f;
+            for( size_t i = 0; i < blocks.size(); ++i )
+            {
+                blocks[ i ].offset = offset;
+                offset += blocks[ i ].height;
+            }
+            offsetsValid = true;
+        }
+
+        // last block starting at or before y
+        size_t FindBlock( float y_ ) const
+        {
+            size_t lo = 0, hi = blocks.size();
+            while( hi - lo > 1 )
+            {
+                size_t mid = ( lo + hi ) / 2;
+                if( blocks[ mid ].offset <= y_ )
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+    };
+
+    inline void Markdown( MarkdownDocument& document_, const char* markdown_, size_t markdownLength_, const MarkdownConfig& mdConfig_ )
+    {
+        document_.SetText( markdown_, markdownLength_ );
+        document_.Render( mdConfig_ );
+    }
+
 }
@@ -5,6 +5,8 @@
 # include <clocale>
 # include <cmath>
 # include <cstring>
+# include <cstdio>
+# include <memory>
 # if JSON_IO
 #     include <stdio.h>
 #     include <memory>
@@ -12,7 +14,7 @@
 
 namespace imgui_json {
 
-value::value(value&& other)
+value::value(value&& other) noexcept
     : m_Type(other.m_Type)
 {
     switch (m_Type)
@@ -192,15 +194,98 @@ void value::swap(value& other)
     }
 }
 
+namespace {
+
+char current_decimal_point()
+{
+    auto decimal_point = localeconv()->decimal_point;
+    return decimal_point && decimal_point[0] ? decimal_point[0] : '.';
+}
+
+// Appends number the way ostream with default float format and precision of
+// max_digits10 + 1 would, with '.' as decimal point regardless of locale.
+void write_number(string& out, double v, char decimal_point)
+{
+    if (v == 0 && std::signbit(v))
+    {
+        out += "-0";
+        return;
+    }
+
+    // Integers are common in documents and do not need printf machinery
+    if (std::fabs(v) < 1e15 && v == static_cast<double>(static_cast<int64_t>(v)))
+    {
+        char  buffer[24];
+        char* end = buffer + sizeof(buffer);
+        char* p   = end;
+
+        auto i = static_cast<int64_t>(v);
+        auto u = static_cast<uint64_t>(i < 0 ? -i : i);
+        do
+        {
+            *--p = static_cast<char>('0' + u % 10);
+            u /= 10;
+        }
+        while (u);
+        if (i < 0)
+            *--p = '-';
+
+        out.append(p, end);
+        return;
+    }
+
+    char buffer[40];
+    auto size = snprintf(buffer, sizeof(buffer), "%.*g", std::numeric_limits<double>::max_digits10 + 1, v);
+    if (size <= 0)
+        return;
+
+    // printf uses decimal point of current C locale
+    if (decimal_point != '.')
+        std::replace(buffer, buffer + size, decimal_point, '.');
+
+    out.append(buffer, static_cast<size_t>(size));
+}
+
+void write_string(string& out, const string& str)
+{
+    out += '\"';
+
+    size_t run = 0; // characters which do not need escaping, appended in bulk
+    for (size_t i = 0, size = str.size(); i < size; ++i)
+    {
+        const char* escaped = nullptr;
+        switch (str[i])
+        {
+            case '\"': escaped = "\\\"";     break;
+            case '\\': escaped = "\\\\";     break;
+            case '/':  escaped = "\\/";      break;
+            case '\b': escaped = "\\b";      break;
+            case '\f': escaped = "\\f";      break;
+            case '\n': escaped = "\\n";      break;
+            case '\r': escaped = "\\r";      break;
+            case '\t': escaped = "\\t";      break;
+            case '\0': escaped = "\\u0000";  break;
+            default:   continue;
+        }
+
+        out.append(str, run, i - run);
+        out += escaped;
+        run = i + 1;
+    }
+    out.append(str, run, string::npos);
+
+    out += '\"';
+}
+
+} // namespace
+
 string value::dump(const int indent, const char indent_char) const
 {
     dump_context_t context(indent, indent_char);
-
-    context.out.precision(std::numeric_limits<double>::max_digits10 + 1);
-    context.out << std::defaultfloat;
+    context.decimal_point = current_decimal_point();
 
     dump(context, 0);
-    return context.out.str();
+    return std::move(context.out);
 }
 
 void value::dump_context_t::write_indent(int level)
@@ -208,10 +293,7 @@ void value::dump_context_t::write_indent(int level)
     if (indent <= 0 || level == 0)
         return;
 
-    out.fill(indent_char);
-    out.width(indent * level);
-    out << indent_char;
-    out.width(0);
+    out.append(static_cast<size_t>(indent * level), indent_char);
 }
 
 void value::dump_context_t::write_separator()
@@ -219,7 +301,7 @@ void value::dump_context_t::write_separator()
     if (indent < 0)
         return;
 
-    out.put(' ');
+    out += ' ';
 }
 
 void value::dump_context_t::write_newline()
@@ -227,7 +309,7 @@ void value::dump_context_t::write_newline()
     if (indent < 0)
         return;
 
-    out.put('\n');
+    out += '\n';
 }
 
 void value::dump(dump_context_t& context, int level) const
@@ -237,19 +319,21 @@ void value::dump(dump_context_t& context, int level) const
     switch (m_Type)
     {
         case type_t::null:
-            context.out << "null";
+            context.out += "null";
             break;
 
         case type_t::object:
-            context.out << '{';
+            context.out += '{';
             {
                 context.write_newline();
                 bool first = true;
                 for (auto& entry : *object_ptr(m_Storage))
                 {
-                    if (!first) { context.out << ','; context.write_newline(); } else first = false;
+                    if (!first) { context.out += ','; context.write_newline(); } else first = false;
                     context.write_indent(level + 1);
-                    context.out << '\"' << entry.first << "\":";
+                    context.out += '\"';
+                    context.out += entry.first;
+                    context.out += "\":";
                     if (!entry.second.is_structured())
                     {
                         context.write_separator();
@@ -265,17 +349,17 @@ void value::dump(dump_context_t& context, int level) const
                     context.write_newline();
             }
             context.write_indent(level);
-            context.out << '}';
+            context.out += '}';
             break;
 
         case type_t::array:
-            context.out << '[';
+            context.out += '[';
             {
                 context.write_newline();
                 bool first = true;
                 for (auto& entry : *array_ptr(m_Storage))
                 {
-                    if (!first) { context.out << ','; context.write_newline(); } else first = false;
+                    if (!first) { context.out += ','; context.write_newline(); } else first = false;
                     if (!entry.is_structured())
                     {
                         context.write_indent(level + 1);
@@ -290,71 +374,50 @@ void value::dump(dump_context_t& context, int level) const
                     context.write_newline();
             }
             context.write_indent(level);
-            context.out << ']';
+            context.out += ']';
             break;
 
         case type_t::string:
-            context.out << '\"';
-
-            if (string_ptr(m_Storage)->find_first_of("\"\\/\b\f\n\r") != string::npos || string_ptr(m_Storage)->find('\0') != string::npos)
-            {
-                for (auto c : *string_ptr(m_Storage))
-                {
-                         if (c == '\"')  context.out << "\\\"";
-                    else if (c == '\\')  context.out << "\\\\";
-                    else if (c == '/')   context.out << "\\/";
-                    else if (c == '\b')  context.out << "\\b";
-                    else if (c == '\f')  context.out << "\\f";
-                    else if (c == '\n')  context.out << "\\n";
-                    else if (c == '\r')  context.out << "\\r";
-                    else if (c == '\t')  context.out << "\\t";
-                    else if (c == 0)     context.out << "\\u0000";
-                    else                 context.out << c;
-                }
-            }
-            else
-                context.out << *string_ptr(m_Storage);
-            context.out << '\"';
+            write_string(context.out, *string_ptr(m_Storage));
             break;
 
-
         case type_t::boolean:
             if (*boolean_ptr(m_Storage))
-                context.out << "true";
+                context.out += "true";
             else
-                context.out << "false";
+                context.out += "false";
             break;
 
         case type_t::number:
-            context.out << *number_ptr(m_Storage);
+            write_number(context.out, *number_ptr(m_Storage), context.decimal_point);
             break;
 
         case type_t::point:
-            context.out << *point_ptr(m_Storage);
+            context.out += std::to_string(*point_ptr(m_Storage));
             break;
 
         case type_t::vec2:
-            context.out << '(';
+            context.out += '(';
             {
-                context.out << (*vec2_ptr(m_Storage)).x;
-                context.out << ',' << ' ';
-                context.out << (*vec2_ptr(m_Storage)).y;
+                write_number(context.out, (*vec2_ptr(m_Storage)).x, context.decimal_point);
+                context.out += ", ";
+                write_number(context.out, (*vec2_ptr(m_Storage)).y, context.decimal_point);
             }
-            context.out << ')';
+            context.out += ')';
             break;
 
         case type_t::vec4:
-            context.out << '(';
+            context.out += '(';
             {
-                context.out << (*vec4_ptr(m_Storage)).x;
-                context.out << ',' << ' ';
-                context.out << (*vec4_ptr(m_Storage)).y;
-                context.out << ',' << ' ';
-                context.out << (*vec4_ptr(m_Storage)).z;
-                context.out << ',' << ' ';
-                context.out << (*vec4_ptr(m_Storage)).w;
+                write_number(context.out, (*vec4_ptr(m_Storage)).x, context.decimal_point);
+                context.out += ", ";
+                write_number(context.out, (*vec4_ptr(m_Storage)).y, context.decimal_point);
+                context.out += ", ";
+                write_number(context.out, (*vec4_ptr(m_Storage)).z, context.decimal_point);
+                context.out += ", ";
+                write_number(context.out, (*vec4_ptr(m_Storage)).w, context.decimal_point);
             }
-            context.out << ')';
+            context.out += ')';
             break;
 
         default:
@@ -362,589 +425,791 @@ void value::dump(dump_context_t& context, int level) const
     }
 }
 
-struct value::parser
+namespace {
+
+// Single pass recursive descent parser. Handler is a template parameter, so
+// builders used internally are called directly, while sax_parse() goes
+// through virtual sax_handler interface.
+template <typename Handler>
+struct sax_parser
 {
-    parser(const char* begin, const char* end)
+    sax_parser(const char* begin, const char* end, Handler& handler)
         : m_Cursor(begin)
         , m_End(end)
+        , m_Handler(handler)
+        , m_DecimalPoint(current_decimal_point())
     {
     }
 
-    value parse()
+    // Accept single value only when end of the stream is reached.
+    bool parse()
     {
-        value v;
-
-        // Switch to C locale to make strtod and strtol work as expected
-        auto previous_locale = std::setlocale(LC_NUMERIC, "C");
-
-        // Accept single value only when end of the stream is reached.
-        if (!accept_element(v) || !eof())
-            v = value(type_t::discarded);
-
-        if (previous_locale && strcmp(previous_locale, "C") != 0)
-            std::setlocale(LC_NUMERIC, previous_locale);
-
-        return v;
+        skip_ws();
+        if (!parse_value(0))
+            return false;
+        skip_ws();
+        return eof();
     }
 
 private:
-    struct cursor_state
-    {
-        cursor_state(parser* p)
-            : m_Owner(p)
-            , m_LastCursor(p->m_Cursor)
-        {
-        }
+    static const int max_depth = 512;
 
-        void reset()
-        {
-            m_Owner->m_Cursor = m_LastCursor;
-        }
+    bool parse_value(int depth)
+    {
+        if (eof() || depth > max_depth)
+            return false;
 
-        bool operator()(bool accept)
+        switch (*m_Cursor)
         {
-            if (!accept)
-                reset();
-            else
-                m_LastCursor = m_Owner->m_Cursor;
-            return accept;
+            case '{': return parse_object(depth);
+            case '[': return parse_array(depth);
+            case '(': return parse_vector();
+            case '\"':
+                {
+                    const char* str  = nullptr;
+                    size_t      size = 0;
+                    return parse_string(str, size) && m_Handler.on_string(str, size);
+                }
+            case 't': return accept("true")  && m_Handler.on_boolean(true);
+            case 'f': return accept("false") && m_Handler.on_boolean(false);
+            case 'n': return accept("null")  && m_Handler.on_null();
+            case 'p': return accept("point") && m_Handler.on_null();
+            default:
+                {
+                    number v = 0;
+                    return parse_number(v) && m_Handler.on_number(v);
+                }
         }
-
-    private:
-        parser*     m_Owner;
-        const char* m_LastCursor;
-    };
-
-    cursor_state state()
-    {
-        return cursor_state(this);
     }
 
-    bool accept_value(value& result)
+    bool parse_object(int depth)
     {
-        return accept_object(result)
-            || accept_array(result)
-            || accept_string(result)
-            || accept_number(result)
-            || accept_boolean(result)
-            || accept_point(result)
-            || accept_vec2(result)
-            || accept_vec4(result)
-            || accept_null(result);
-    }
+        ++m_Cursor; // '{'
+        if (!m_Handler.on_begin_object())
+            return false;
 
-    bool accept_object(value& result)
-    {
-        auto s = state();
+        skip_ws();
+        if (accept('}'))
+            return m_Handler.on_end_object();
 
-        object o;
-        if (s(accept('{') && accept_ws() && accept('}')))
+        for (;;)
         {
-            result = o;
-            return true;
-        }
-        else if (s(accept('{') && accept_members(o) && accept('}')))
-        {
-            result = std::move(o);
-            return true;
-        }
+            const char* key      = nullptr;
+            size_t      key_size = 0;
+            if (!expect('\"') || !parse_string(key, key_size) || !m_Handler.on_key(key, key_size))
+                return false;
 
-        return false;
+            skip_ws();
+            if (!accept(':'))
+                return false;
+            skip_ws();
+            if (!parse_value(depth + 1))
+                return false;
+            skip_ws();
+
+            if (accept(','))
+            {
+                skip_ws();
+                continue;
+            }
+
+            return accept('}') && m_Handler.on_end_object();
+        }
     }
 
-    bool accept_members(object& o)
+    bool parse_array(int depth)
     {
-        if (!accept_member(o))
+        ++m_Cursor; // '['
+        if (!m_Handler.on_begin_array())
             return false;
 
-        while (true)
+        skip_ws();
+        if (accept(']'))
+            return m_Handler.on_end_array();
+
+        for (;;)
         {
-            auto s = state();
-            if (!s(accept(',') && accept_member(o)))
-                break;
-        }
+            if (!parse_value(depth + 1))
+                return false;
+            skip_ws();
 
-        return true;
+            if (accept(','))
+            {
+                skip_ws();
+                continue;
+            }
+
+            return accept(']') && m_Handler.on_end_array();
+        }
     }
 
-    bool accept_member(object& o)
+    // (x, y) or (x, y, z, w)
+    bool parse_vector()
     {
-        auto s = state();
+        ++m_Cursor; // '('
 
-        value key;
-        value v;
-        if (s(accept_ws() && accept_string(key) && accept_ws() && accept(':') && accept_element(v)))
+        number components[4] = {};
+        int    count = 0;
+        for (;;)
         {
-            o.emplace(std::move(key.get<string>()), std::move(v));
-            return true;
+            skip_ws();
+            if (count == 4 || !parse_number(components[count++]))
+                return false;
+            skip_ws();
+
+            if (accept(','))
+                continue;
+            if (!accept(')'))
+                return false;
+            break;
         }
 
+        if (count == 2)
+            return m_Handler.on_vec2(vec2(static_cast<float>(components[0]), static_cast<float>(components[1])));
+        else if (count == 4)
+            return m_Handler.on_vec4(vec4(static_cast<float>(components[0]), static_cast<float>(components[1]), static_cast<float>(components[2]), static_cast<float>(components[3])));
+
         return false;
     }
 
-    bool accept_array(value& result)
+    // Strings without escape sequences point directly into the input.
+    bool parse_string(const char*& result, size_t& size)
     {
-        auto s = state();
+        const char* begin = ++m_Cursor; // '"'
+        while (m_Cursor != m_End && *m_Cursor != '\"' && *m_Cursor != '\\')
+            ++m_Cursor;
+
+        if (eof())
+            return false;
 
-        if (s(accept('[') && accept_ws() && accept(']')))
+        if (*m_Cursor == '\"')
         {
-            result = array();
+            result = begin;
+            size   = static_cast<size_t>(m_Cursor - begin);
+            ++m_Cursor;
             return true;
         }
 
-        array a;
-        if (s(accept('[') && accept_elements(a) && accept(']')))
+        m_Scratch.assign(begin, m_Cursor);
+        while (!eof())
         {
-            result = std::move(a);
-            return true;
+            const char c = *m_Cursor++;
+            if (c == '\"')
+            {
+                result = m_Scratch.data();
+                size   = m_Scratch.size();
+                return true;
+            }
+            else if (c != '\\')
+            {
+                m_Scratch.push_back(c);
+                continue;
+            }
+
+            if (eof())
+                return false;
+
+            switch (*m_Cursor++)
+            {
+                case '\"': m_Scratch.push_back('\"'); break;
+                case '\\': m_Scratch.push_back('\\'); break;
+                case '/':  m_Scratch.push_back('/');  break;
+                case 'b':  m_Scratch.push_back('\b'); break;
+                case 'f':  m_Scratch.push_back('\f'); break;
+                case 'n':  m_Scratch.push_back('\n'); break;
+                case 'r':  m_Scratch.push_back('\r'); break;
+                case 't':  m_Scratch.push_back('\t'); break;
+                case 'u':
+                    {
+                        uint32_t code_point = 0;
+                        if (!parse_hex4(code_point))
+                            return false;
+
+                        // Surrogate pair encodes code point above U+FFFF
+                        if (code_point >= 0xD800 && code_point <= 0xDBFF && m_End - m_Cursor >= 6 && m_Cursor[0] == '\\' && m_Cursor[1] == 'u')
+                        {
+                            auto last = m_Cursor;
+                            m_Cursor += 2;
+                            uint32_t low = 0;
+                            if (parse_hex4(low) && low >= 0xDC00 && low <= 0xDFFF)
+                                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                            else
+                                m_Cursor = last;
+                        }
+
+                        append_utf8(code_point);
+                    }
+                    break;
+
+                default:
+                    return false;
+            }
         }
 
         return false;
     }
 
-    bool accept_elements(array& a)
+    bool parse_hex4(uint32_t& result)
     {
-        value v;
-        if (!accept_element(v))
+        if (m_End - m_Cursor < 4)
             return false;
 
-        a.emplace_back(std::move(v));
-        while (true)
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
         {
-            auto s = state();
-            v = nullptr;
-            if (!s(accept(',') && accept_element(v)))
-                break;
-            a.emplace_back(std::move(v));
+            const char c = *m_Cursor++;
+            v <<= 4;
+                 if (c >= '0' && c <= '9') v |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') v |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v |= static_cast<uint32_t>(c - 'A' + 10);
+            else return false;
         }
 
+        result = v;
         return true;
     }
 
-    bool accept_elements(vec2& a)
+    void append_utf8(uint32_t c)
     {
-        value v = nullptr;
-        auto s = state();
-        if (s(accept_number(v) && accept(',')))
-            a.x = v.get<number>();
-        else
-            return false;
-        s = state();
-        if (s(accept(' ') && accept_number(v)))
-            a.y = v.get<number>();
+        if (c < 0x80)
+            m_Scratch.push_back(static_cast<char>(c));
+        else if (c < 0x800)
+        {
+            m_Scratch.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            m_Scratch.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+        else if (c < 0x10000)
+        {
+            m_Scratch.push_back(static_cast<char>(0xE0 | (c >> 12)));
+            m_Scratch.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            m_Scratch.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
         else
-            return false;
-
-        return true;
+        {
+            m_Scratch.push_back(static_cast<char>(0xF0 | (c >> 18)));
+            m_Scratch.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+            m_Scratch.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            m_Scratch.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
     }
 
-    bool accept_elements(vec4& a)
+    // Grammar: '-'? ('0' | [1-9][0-9]*) ('.' [0-9]+)? ([eE] [+-]? [0-9]+)?
+    //
+    // Up to 19 significant digits are accumulated in an integer. When mantissa
+    // fits in 53 bits and power of ten is within 22, result is exact with single
+    // multiplication or division. Remaining cases are handed to strtod().
+    bool parse_number(number& result)
     {
-        value v = nullptr;
-        auto s = state();
-        if (s(accept_number(v) && accept(',')))
-            a.x = v.get<number>();
-        else
-            return false;
-        s = state();
-        if (s(accept(' ') && accept_number(v) && accept(',')))
-            a.y = v.get<number>();
-        else
-            return false;
-
-        s = state();
-        if (s(accept(' ') && accept_number(v) && accept(',')))
-            a.z = v.get<number>();
-        else
-            return false;
-        
-        s = state();
-        if (s(accept(' ') && accept_number(v)))
-            a.w = v.get<number>();
-        else
-            return false;
+        static const double powers_of_ten[] =
+        {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
 
-        return true;
-    }
+        const char* begin = m_Cursor;
 
-    bool accept_element(value& result)
-    {
-        auto s = state();
-        return s(accept_ws() && accept_value(result) && accept_ws());
-    }
+        const bool negative = accept('-');
 
-    bool accept_string(value& result)
-    {
-        auto s = state();
+        uint64_t mantissa  = 0;
+        int      digits    = 0;     // significant digits in mantissa
+        int      exponent  = 0;
+        bool     truncated = false;
 
-        string v;
-        if (s(accept('\"') && accept_characters(v) && accept('\"')))
+        if (accept('0'))
+            ;
+        else if (!eof() && *m_Cursor >= '1' && *m_Cursor <= '9')
         {
-            result = std::move(v);
-            return true;
+            while (!eof() && *m_Cursor >= '0' && *m_Cursor <= '9')
+            {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*m_Cursor - '0');
+                    ++digits;
+                }
+                else
+                {
+                    truncated |= *m_Cursor != '0';
+                    ++exponent;
+                }
+                ++m_Cursor;
+            }
         }
         else
             return false;
-    }
 
-    bool accept_characters(string& result)
-    {
-        int c;
-        while (accept_character(c))
+        if (accept('.'))
         {
-            //JSON_ASSERT(c < 128);
-            // disable check character is ascii in case we using UTF-8
-            // this will cause problem when UTF-8 character contain '"'
-            // TODO::Dicky json accept_characters for UTF-8
-            result.push_back(static_cast<char>(c));
+            if (eof() || *m_Cursor < '0' || *m_Cursor > '9')
+                return false;
+
+            while (!eof() && *m_Cursor >= '0' && *m_Cursor <= '9')
+            {
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*m_Cursor - '0');
+                    if (mantissa)
+                        ++digits;
+                    --exponent;
+                }
+                else
+                    truncated |= *m_Cursor != '0';
+                ++m_Cursor;
+            }
         }
 
-        return true;
-    }
+        if (accept('e') || accept('E'))
+        {
+            bool negative_exponent = false;
+            if (accept('-'))
+                negative_exponent = true;
+            else
+                accept('+');
 
-    bool accept_character(int& c)
-    {
-        auto s = state();
+            if (eof() || *m_Cursor < '0' || *m_Cursor > '9')
+                return false;
 
-        if (accept('\\'))
+            int e = 0;
+            while (!eof() && *m_Cursor >= '0' && *m_Cursor <= '9')
+            {
+                if (e < 100000)
+                    e = e * 10 + (*m_Cursor - '0');
+                ++m_Cursor;
+            }
+
+            exponent += negative_exponent ? -e : e;
+        }
+
+        double v = 0;
+        if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+        {
+            v = static_cast<double>(mantissa);
+            if (exponent < 0)
+                v /= powers_of_ten[-exponent];
+            else
+                v *= powers_of_ten[exponent];
+            if (negative)
+                v = -v;
+        }
+        else
         {
-            return accept_escape(c);
+            // strtod() expects decimal point of current C locale
+            const auto size = static_cast<size_t>(m_Cursor - begin);
+
+            char   buffer[64];
+            string long_buffer;
+            char*  text = buffer;
+            if (size >= sizeof(buffer))
+            {
+                long_buffer.resize(size + 1);
+                text = &long_buffer[0];
+            }
+            memcpy(text, begin, size);
+            text[size] = '\0';
+            if (m_DecimalPoint != '.')
+                std::replace(text, text + size, '.', m_DecimalPoint);
+
+            char* end = nullptr;
+            v = std::strtod(text, &end);
+            if (end != text + size)
+                return false;
         }
-        else if (expect('\"'))
+
+        if (v != 0 && !std::isnormal(v))
             return false;
 
-        // Handle UTF-8 sequences. only eof will return -1.
-        return s((c = peek()) != -1) && advance();
+        result = v;
+        return true;
     }
 
-    bool accept_escape(int& c)
+    void skip_ws()
     {
-        if (accept('\"')) { c = '\"'; return true; }
-        if (accept('\\')) { c = '\\'; return true; }
-        if (accept('/'))  { c = '/';  return true; }
-        if (accept('b'))  { c = '\b'; return true; }
-        if (accept('f'))  { c = '\f'; return true; }
-        if (accept('n'))  { c = '\n'; return true; }
-        if (accept('r'))  { c = '\r'; return true; }
-        if (accept('t'))  { c = '\t'; return true; }
+        while (m_Cursor != m_End && (*m_Cursor == ' ' || *m_Cursor == '\n' || *m_Cursor == '\r' || *m_Cursor == '\t'))
+            ++m_Cursor;
+    }
 
-        auto s = state();
+    bool accept(char c)
+    {
+        if (!expect(c))
+            return false;
+        ++m_Cursor;
+        return true;
+    }
 
-        string hex;
-        hex.reserve(4);
-        if (s(accept('u') && accept_hex(hex) && accept_hex(hex) && accept_hex(hex) && accept_hex(hex)))
-        {
-            char* end = nullptr;
-            auto v = std::strtol(hex.c_str(), &end, 16);
-            if (end != hex.c_str() + hex.size())
-                return false;
+    bool accept(const char* str)
+    {
+        const auto size = strlen(str);
+        if (static_cast<size_t>(m_End - m_Cursor) < size || memcmp(m_Cursor, str, size) != 0)
+            return false;
+        m_Cursor += size;
+        return true;
+    }
 
-            c = v;
-            return true;
-        }
+    bool expect(char c) const
+    {
+        return m_Cursor != m_End && *m_Cursor == c;
+    }
 
-        return false;
+    bool eof() const
+    {
+        return m_Cursor == m_End;
     }
 
-    bool accept_hex(string& result)
+    const char* m_Cursor;
+    const char* m_End;
+    Handler&    m_Handler;
+    char        m_DecimalPoint;
+    string      m_Scratch;
+};
+
+// Builds json::value tree from parser events.
+struct value_builder
+{
+    value               m_Root;
+    std::vector<value>  m_Stack;    // containers which are not closed yet
+    std::vector<string> m_Keys;     // last key for every open object
+
+    bool add(value&& v)
     {
-        if (accept_digit(result))
+        if (m_Stack.empty())
+        {
+            m_Root = std::move(v);
             return true;
+        }
 
-        auto c = peek();
-        if ((c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'))
+        auto& container = m_Stack.back();
+        if (container.is_array())
+            container.get<array>().emplace_back(std::move(v));
+        else
         {
-            advance();
-            result.push_back(static_cast<char>(c));
-            return true;
+            // Saved documents list keys in order, hint makes insertion constant
+            // time for them. Like emplace(), first of duplicated keys wins.
+            auto& o = container.get<object>();
+            o.emplace_hint(o.end(), std::move(m_Keys.back()), std::move(v));
         }
 
-        return false;
+        return true;
     }
 
-    bool accept_number(value& result)
+    bool on_null()                                  { return add(value()); }
+    bool on_boolean(boolean v)                      { return add(value(v)); }
+    bool on_number(number v)                        { return add(value(v)); }
+    bool on_string(const char* str, size_t size)    { return add(value(string(str, size))); }
+    bool on_vec2(const vec2& v)                     { return add(value(v)); }
+    bool on_vec4(const vec4& v)                     { return add(value(v)); }
+    bool on_key(const char* str, size_t size)       { m_Keys.back().assign(str, size); return true; }
+    bool on_begin_object()                          { m_Stack.emplace_back(type_t::object); m_Keys.emplace_back(); return true; }
+    bool on_begin_array()                           { m_Stack.emplace_back(type_t::array); return true; }
+    bool on_end_object()                            { m_Keys.pop_back(); return on_end_array(); }
+    bool on_end_array()
     {
-        auto s = state();
+        value v = std::move(m_Stack.back());
+        m_Stack.pop_back();
+        return add(std::move(v));
+    }
+};
 
-        string n;
-        if (s(accept_int(n) && accept_frac(n) && accept_exp(n)))
-        {
-            char* end = nullptr;
-            auto v = std::strtod(n.c_str(), &end);
-            if (end != n.c_str() + n.size())
-                return false;
+} // namespace
 
-            if (v != 0 && !std::isnormal(v))
-                return false;
+value value::parse(const string& data)
+{
+    return parse(data.data(), data.size());
+}
 
-            result = v;
-            return true;
-        }
+value value::parse(const char* data, size_t size)
+{
+    value_builder builder;
 
-        return false;
-    }
+    sax_parser<value_builder> parser(data, data + size, builder);
+    if (!parser.parse())
+        return value(type_t::discarded);
 
-    bool accept_int(string& result)
-    {
-        auto s = state();
+    return std::move(builder.m_Root);
+}
 
-        string part;
-        if (s(accept_onenine(part) && accept_digits(part)))
-        {
-            result += std::move(part);
-            return true;
-        }
+bool sax_parse(const char* data, size_t size, sax_handler& handler)
+{
+    sax_parser<sax_handler> parser(data, data + size, handler);
+    return parser.parse();
+}
 
-        part.resize(0);
-        if (accept_digit(part))
-        {
-            result += std::move(part);
-            return true;
-        }
 
-        part.resize(0);
-        if (s(accept('-') && accept_onenine(part) && accept_digits(part)))
-        {
-            result += '-';
-            result += std::move(part);
-            return true;
-        }
+//------------------------------------------------------------------------------
+// document
+//------------------------------------------------------------------------------
+namespace {
 
-        part.resize(0);
-        if (s(accept('-') && accept_digit(part)))
-        {
-            result += '-';
-            result += std::move(part);
-            return true;
-        }
+const document::node null_node;
 
-        return false;
-    }
+inline int compare_keys(const char* lhs, size_t lhs_size, const char* rhs, size_t rhs_size)
+{
+    if (auto result = memcmp(lhs, rhs, lhs_size < rhs_size ? lhs_size : rhs_size))
+        return result;
+    return lhs_size < rhs_size ? -1 : (lhs_size > rhs_size ? 1 : 0);
+}
 
-    bool accept_digits(string& result)
-    {
-        string part;
-        if (!accept_digit(part))
-            return false;
+} // namespace
 
-        while (accept_digit(part))
-            ;
+const document::node& document::node::operator[](size_t index) const
+{
+    if (is_array() && index < m_Size)
+        return m_Elements[index];
 
-        result += std::move(part);
+    JSON_ASSERT(false && "operator[] on unsupported type or index out of range");
+    return null_node;
+}
 
-        return true;
-    }
+const document::member& document::node::member_at(size_t index) const
+{
+    JSON_ASSERT(is_object() && index < m_Size);
+    return m_Members[index];
+}
 
-    bool accept_digit(string& result)
+const document::node* document::node::find(const char* key, size_t size) const
+{
+    if (!is_object())
+        return nullptr;
+
+    size_t first = 0;
+    size_t count = m_Size;
+    while (count > 0)
     {
-        if (accept('0'))
+        const size_t step = count / 2;
+        const auto&  m    = m_Members[first + step];
+        if (compare_keys(m.key, m.key_size, key, size) < 0)
         {
-            result.push_back('0');
-            return true;
+            first += step + 1;
+            count -= step + 1;
         }
-        else if (accept_onenine(result))
-            return true;
-
-        return false;
+        else
+            count = step;
     }
 
-    bool accept_onenine(string& result)
-    {
-        auto c = peek();
-        if (c >= '1' && c <= '9')
-        {
-            result.push_back(static_cast<char>(c));
-            return advance();
-        }
+    if (first < m_Size && compare_keys(m_Members[first].key, m_Members[first].key_size, key, size) == 0)
+        return &m_Members[first].value;
 
-        return false;
-    }
+    return nullptr;
+}
 
-    bool accept_frac(string& result)
+value document::node::to_value() const
+{
+    switch (m_Type)
     {
-        auto s = state();
+        case type_t::object:
+            {
+                // Members are sorted the same way std::map orders strings
+                object o;
+                for (uint32_t i = 0; i < m_Size; ++i)
+                    o.emplace_hint(o.end(), string(m_Members[i].key, m_Members[i].key_size), m_Members[i].value.to_value());
+                return value(std::move(o));
+            }
 
-        string part;
-        if (s(accept('.') && accept_digits(part)))
-        {
-            result += '.';
-            result += std::move(part);
-        }
+        case type_t::array:
+            {
+                array a;
+                a.reserve(m_Size);
+                for (uint32_t i = 0; i < m_Size; ++i)
+                    a.emplace_back(m_Elements[i].to_value());
+                return value(std::move(a));
+            }
 
-        return true;
+        case type_t::string:    return value(string(m_String, m_Size));
+        case type_t::boolean:   return value(m_Boolean);
+        case type_t::number:    return value(m_Number);
+        case type_t::vec2:      return value(as_vec2());
+        case type_t::vec4:      return value(as_vec4());
+        case type_t::discarded: return value(type_t::discarded);
+        default:                return value();
     }
+}
 
-    bool accept_exp(string& result)
+// Children of open containers are collected on a single stack and moved
+// to the arena in one piece once container is closed.
+struct document::builder
+{
+    document&             m_Document;
+    std::vector<member>   m_Stack;
+    std::vector<size_t>   m_Frames;   // m_Stack size at the beginning of each open container
+    std::vector<member>   m_Owners;   // key and type of each open container
+    const char*           m_Key     = nullptr;
+    uint32_t              m_KeySize = 0;
+
+    builder(document& document)
+        : m_Document(document)
     {
-        auto s = state();
-
-        string part;
-        if (s(accept('e') && accept_sign(part) && accept_digits(part)))
-        {
-            result += 'e';
-            result += std::move(part);
-            return true;
-        }
-        part.resize(0);
-        if (s(accept('E') && accept_sign(part) && accept_digits(part)))
-        {
-            result += 'E';
-            result += std::move(part);
-        }
-
-        return true;
     }
 
-    bool accept_sign(string& result)
+    const char* copy_string(const char* str, size_t size)
     {
-        if (accept('+'))
-            result.push_back('+');
-        else if (accept('-'))
-            result.push_back('-');
-
-        return true;
+        auto result = static_cast<char*>(m_Document.allocate(size + 1, 1));
+        memcpy(result, str, size);
+        result[size] = '\0';
+        return result;
     }
 
-    bool accept_ws()
+    bool add(const node& n)
     {
-        while (expect('\x09') || expect('\x0A') || expect('\x0D') || expect('\x20'))
-            advance();
+        member m;
+        m.key      = m_Key;
+        m.key_size = m_KeySize;
+        m.value    = n;
+        m_Stack.push_back(m);
+        m_Key      = nullptr;
+        m_KeySize  = 0;
         return true;
     }
 
-    bool accept_boolean(value& result)
+    bool on_null()                                  { return add(node()); }
+    bool on_boolean(boolean v)                      { node n; n.m_Type = type_t::boolean; n.m_Boolean = v; return add(n); }
+    bool on_number(number v)                        { node n; n.m_Type = type_t::number;  n.m_Number  = v; return add(n); }
+    bool on_vec2(const vec2& v)                     { node n; n.m_Type = type_t::vec2; n.m_Vector[0] = v.x; n.m_Vector[1] = v.y; return add(n); }
+    bool on_vec4(const vec4& v)                     { node n; n.m_Type = type_t::vec4; n.m_Vector[0] = v.x; n.m_Vector[1] = v.y; n.m_Vector[2] = v.z; n.m_Vector[3] = v.w; return add(n); }
+    bool on_string(const char* str, size_t size)
     {
-        if (accept("true"))
-        {
-            result = true;
-            return true;
-        }
-        else if (accept("false"))
-        {
-            result = false;
-            return true;
-        }
-
-        return false;
+        node n;
+        n.m_Type   = type_t::string;
+        n.m_Size   = static_cast<uint32_t>(size);
+        n.m_String = copy_string(str, size);
+        return add(n);
     }
-
-    bool accept_point(value& result)
+    bool on_key(const char* str, size_t size)
     {
-        if (accept("point"))
-        {
-            result = nullptr;
-            return true;
-        }
-
-        return false;
+        m_Key     = copy_string(str, size);
+        m_KeySize = static_cast<uint32_t>(size);
+        return true;
     }
 
-    bool accept_vec2(value& result)
-    {
-        auto s = state();
-        vec2 v;
-        if (s(accept('(') && accept_elements(v) && accept(')')))
-        {
-            result = v;
-            return true;
-        }
+    bool on_begin_object() { return begin(type_t::object); }
+    bool on_begin_array()  { return begin(type_t::array);  }
 
-        return false;
-    }
-
-    bool accept_vec4(value& result)
+    bool begin(type_t type)
     {
-        auto s = state();
-        vec4 v;
-        if (s(accept('(') && accept_elements(v) && accept(')')))
-        {
-            result = v;
-            return true;
-        }
-
-        return false;
+        member owner;
+        owner.key          = m_Key;
+        owner.key_size     = m_KeySize;
+        owner.value.m_Type = type;
+        m_Owners.push_back(owner);
+        m_Frames.push_back(m_Stack.size());
+        m_Key     = nullptr;
+        m_KeySize = 0;
+        return true;
     }
 
-    bool accept_null(value& result)
+    bool on_end_object()
     {
-        if (accept("null"))
-        {
-            result = nullptr;
-            return true;
-        }
+        const auto first = m_Frames.back();
+        const auto count = m_Stack.size() - first;
 
-        return false;
-    }
+        auto members = static_cast<member*>(m_Document.allocate(count * sizeof(member), alignof(member)));
+        std::uninitialized_copy(m_Stack.begin() + first, m_Stack.end(), members);
 
-    bool accept(char c)
-    {
-        if (expect(c))
-            return advance();
-        else
-            return false;
+        // Stable sort keeps first of duplicated keys in front, like value::parse() does
+        auto less = [](const member& lhs, const member& rhs) { return compare_keys(lhs.key, lhs.key_size, rhs.key, rhs.key_size) < 0; };
+        auto same = [](const member& lhs, const member& rhs) { return compare_keys(lhs.key, lhs.key_size, rhs.key, rhs.key_size) == 0; };
+        if (!std::is_sorted(members, members + count, less))
+            std::stable_sort(members, members + count, less);
+        auto last = std::unique(members, members + count, same);
+
+        return end(static_cast<size_t>(last - members), members, nullptr);
     }
 
-    bool accept(const char* str)
+    bool on_end_array()
     {
-        auto last = m_Cursor;
+        const auto first = m_Frames.back();
+        const auto count = m_Stack.size() - first;
 
-        while (*str)
-        {
-            if (eof() || *str != *m_Cursor)
-            {
-                m_Cursor = last;
-                return false;
-            }
+        auto elements = static_cast<node*>(m_Document.allocate(count * sizeof(node), alignof(node)));
+        for (size_t i = 0; i < count; ++i)
+            new (elements + i) node(m_Stack[first + i].value);
 
-            advance();
-            ++str;
-        }
-
-        return true;
+        return end(count, nullptr, elements);
     }
 
-    int peek() const
+    bool end(size_t size, const member* members, const node* elements)
     {
-        if (!eof())
-            return *m_Cursor;
+        m_Stack.resize(m_Frames.back());
+        m_Frames.pop_back();
+
+        auto owner = m_Owners.back();
+        m_Owners.pop_back();
+
+        owner.value.m_Size = static_cast<uint32_t>(size);
+        if (members)
+            owner.value.m_Members = members;
         else
-            return -1;
-    }
+            owner.value.m_Elements = elements;
 
-    bool expect(char c)
-    {
-        return peek() == c;
+        m_Key     = owner.key;
+        m_KeySize = owner.key_size;
+        return add(owner.value);
     }
+};
 
-    bool advance(int count = 1)
-    {
-        if (m_Cursor + count > m_End)
-        {
-            m_Cursor = m_End;
-            return false;
-        }
+document::document()
+    : m_Cursor(nullptr)
+    , m_End(nullptr)
+    , m_ArenaSize(0)
+{
+    m_Root.m_Type = type_t::discarded;
+}
 
-        m_Cursor += count;
+document::~document()
+{
+    clear();
+}
 
-        return true;
-    }
+bool document::parse(const char* data, size_t size)
+{
+    clear();
 
-    bool eof() const
+    builder b(*this);
+    sax_parser<builder> parser(data, data + size, b);
+    if (!parser.parse())
     {
-        return m_Cursor == m_End;
+        clear();
+        return false;
     }
 
-    const char* m_Cursor;
-    const char* m_End;
-};
+    m_Root = b.m_Stack.front().value;
+    return true;
+}
 
-value value::parse(const string& data)
+void document::clear()
 {
-    auto p = parser(data.c_str(), data.c_str() + data.size());
+    for (auto block : m_Blocks)
+        delete[] block;
+    m_Blocks.clear();
+
+    m_Cursor      = nullptr;
+    m_End         = nullptr;
+    m_ArenaSize   = 0;
+    m_Root        = node();
+    m_Root.m_Type = type_t::discarded;
+}
+
+void* document::allocate(size_t size, size_t alignment)
+{
+    auto align = [alignment](char* p) { return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(uintptr_t(alignment) - 1)); };
 
-    auto v = p.parse();
+    char* result = m_Cursor ? align(m_Cursor) : nullptr;
+    if (!result || result + size > m_End)
+    {
+        // Blocks grow with the document, oversized requests get block of their own
+        const size_t min_block_size = 64 * 1024;
+        const size_t max_block_size = 4 * 1024 * 1024;
+        size_t block_size = m_ArenaSize < min_block_size ? min_block_size : (m_ArenaSize < max_block_size ? m_ArenaSize : max_block_size);
+        if (block_size < size + alignment)
+            block_size = size + alignment;
+
+        auto block = new char[block_size];
+        m_Blocks.push_back(block);
+        m_ArenaSize += block_size;
+        m_End        = block + block_size;
+
+        result = align(block);
+    }
 
-    return v;
+    m_Cursor = result + size;
+    return result;
 }
 
 # if JSON_IO
@@ -50,7 +50,7 @@ enum class type_t
 struct IMGUI_API value
 {
     value(type_t type = type_t::null): m_Type(construct(m_Storage, type)) {}
-    value(value&& other);
+    value(value&& other) noexcept;
     value(const value& other);
 
     value(      null)      : m_Type(construct(m_Storage,      null()))  {}
@@ -132,6 +132,7 @@ struct IMGUI_API value
 
     // Returns discarded value for invalid inputs.
     static value parse(const string& data);
+    static value parse(const char* data, size_t size);
 
 # if JSON_IO
     static std::pair<value, bool> load(const string& path);
@@ -139,8 +140,6 @@ struct IMGUI_API value
 # endif
 
 private:
-    struct parser;
-
     // VS2015: std::max() is not constexpr yet.
 # define JSON_MAX2(a, b)                ((a) < (b) ? (b) : (a))
 # define JSON_MAX3(a, b, c)             JSON_MAX2(JSON_MAX2(a, b), c)
@@ -225,9 +224,10 @@ private:
 
     struct dump_context_t
     {
-        std::ostringstream out;
+        string     out;
         const int  indent = -1;
         const char indent_char = ' ';
+        char       decimal_point = '.'; // of current C locale, printf output is translated back to '.'
 
         // VS2015: Aggregate initialization isn't a thing yet.
         dump_context_t(const int indent, const char indent_char)
@@ -283,6 +283,122 @@ template <> inline       point*   value::get_ptr<point>()         { if (m_Type =
 template <> inline       vec2*    value::get_ptr<vec2>()          { if (m_Type == type_t::vec2)    return vec2_ptr(m_Storage);    else return nullptr; }
 template <> inline       vec4*    value::get_ptr<vec4>()          { if (m_Type == type_t::vec4)    return vec4_ptr(m_Storage);    else return nullptr; }
 
+// Streaming parser interface, events are reported in document order.
+// Returning false from any handler aborts parsing. String and key pointers
+// are valid only for the duration of the call.
+struct IMGUI_API sax_handler
+{
+    virtual ~sax_handler() {}
+
+    virtual bool on_null()                                  { return true; }
+    virtual bool on_boolean(boolean v)                      { (void)v; return true; }
+    virtual bool on_number(number v)                        { (void)v; return true; }
+    virtual bool on_string(const char* str, size_t size)    { (void)str; (void)size; return true; }
+    virtual bool on_vec2(const vec2& v)                     { (void)v; return true; }
+    virtual bool on_vec4(const vec4& v)                     { (void)v; return true; }
+    virtual bool on_begin_object()                          { return true; }
+    virtual bool on_key(const char* str, size_t size)       { (void)str; (void)size; return true; }
+    virtual bool on_end_object()                            { return true; }
+    virtual bool on_begin_array()                           { return true; }
+    virtual bool on_end_array()                             { return true; }
+};
+
+// Accepts same syntax as value::parse(). Numbers are parsed independently
+// of current C locale.
+IMGUI_API bool sax_parse(const char* data, size_t size, sax_handler& handler);
+
+// Read-only DOM with all nodes and strings allocated from an arena owned by
+// the document. Object members are stored in a flat array sorted by key, so
+// find() is a binary search. Nodes are valid until document is cleared or
+// destroyed. Use node::to_value() to get mutable json::value.
+struct IMGUI_API document
+{
+    struct member;
+
+    struct IMGUI_API node
+    {
+        node(): m_Type(type_t::null), m_Size(0) { m_Number = 0; }
+
+        type_t type() const { return m_Type; }
+
+        bool is_null()       const { return m_Type == type_t::null;      }
+        bool is_object()     const { return m_Type == type_t::object;    }
+        bool is_array()      const { return m_Type == type_t::array;     }
+        bool is_string()     const { return m_Type == type_t::string;    }
+        bool is_boolean()    const { return m_Type == type_t::boolean;   }
+        bool is_number()     const { return m_Type == type_t::number;    }
+        bool is_vec2()       const { return m_Type == type_t::vec2;      }
+        bool is_vec4()       const { return m_Type == type_t::vec4;      }
+
+        // Number of elements, members or characters for arrays, objects and strings.
+        size_t size() const { return m_Size; }
+
+        const node&   operator[](size_t index) const;           // array element
+        const member& member_at(size_t index) const;            // object member, in key order
+        const node*   find(const char* key, size_t size) const; // object member value, nullptr if not found
+        const node*   find(const string& key) const { return find(key.data(), key.size()); }
+        bool          contains(const string& key) const { return find(key) != nullptr; }
+
+        const char* c_str()      const { JSON_ASSERT(is_string());  return m_String;  }
+        number      as_number()  const { JSON_ASSERT(is_number());  return m_Number;  }
+        boolean     as_boolean() const { JSON_ASSERT(is_boolean()); return m_Boolean; }
+        vec2        as_vec2()    const { JSON_ASSERT(is_vec2());    return vec2(m_Vector[0], m_Vector[1]); }
+        vec4        as_vec4()    const { JSON_ASSERT(is_vec4());    return vec4(m_Vector[0], m_Vector[1], m_Vector[2], m_Vector[3]); }
+
+        value to_value() const;
+
+    private:
+        friend struct document;
+
+        type_t   m_Type;
+        uint32_t m_Size;
+        union
+        {
+            number        m_Number;
+            boolean       m_Boolean;
+            float         m_Vector[4];
+            const char*   m_String;
+            const node*   m_Elements;
+            const member* m_Members;
+        };
+    };
+
+    struct member
+    {
+        const char* key;
+        uint32_t    key_size;
+        node        value;
+    };
+
+    document();
+    ~document();
+
+    document(const document&) = delete;
+    document& operator=(const document&) = delete;
+
+    // Replaces content of the document, root is discarded on failure.
+    bool parse(const char* data, size_t size);
+    bool parse(const string& data) { return parse(data.data(), data.size()); }
+
+    const node& root() const { return m_Root; }
+
+    void clear();
+
+    // Bytes reserved by the arena.
+    size_t memory_used() const { return m_ArenaSize; }
+
+private:
+    struct builder;
+
+    void* allocate(size_t size, size_t alignment);
+
+    node                m_Root;
+    std::vector<char*>  m_Blocks;
+    char*               m_Cursor;
+    char*               m_End;
+    size_t              m_ArenaSize;
+};
+
 template <typename T>
 inline bool GetPtrTo(const imgui_json::value& value, std::string key, const T*& result)
 {
@@ -9,6 +9,7 @@
 //------------------------------------------------------------------------------
 # include "imgui_node_editor_internal.h"
 # include <cstdio> // snprintf
+# include <cstring>
 # include <string>
 # include <fstream>
 # include <bitset>
@@ -17,6 +18,15 @@
 # include <sstream>
 # include <streambuf>
 # include <type_traits>
+# if defined(_WIN32)
+#     ifndef WIN32_LEAN_AND_MEAN
+#         define WIN32_LEAN_AND_MEAN
+#     endif
+#     ifndef NOMINMAX
+#         define NOMINMAX
+#     endif
+#     include <windows.h> // MoveFileExA
+# endif
 
 //------------------------------------------------------------------------------
 namespace ed = ax::NodeEditor::Detail;
@@ -56,6 +66,7 @@ static const float c_LinkSelectThickness        = 5.0f;  // canvas pixels
 static const float c_NavigationZoomMargin       = 0.1f;  // percentage of visible bounds
 static const float c_MouseZoomDuration          = 0.15f; // seconds
 static const float c_SelectionFadeOutDuration   = 0.15f; // seconds
+static const int   c_LinkSimplifiedSegments     = 6;     // bezier segments used below LinkSimplifyZoom
 
 static const auto  c_MaxMoveOverEdgeSpeed       = 10.0f;
 static const auto  c_MaxMoveOverEdgeDistance    = 300.0f;
@@ -438,7 +449,7 @@ static void ImDrawList_PolyFillScanFlood(ImDrawList *draw, std::vector<ImVec2>*
 
 static void ImDrawList_AddBezierWithArrows(ImDrawList* drawList, const ImCubicBezierPoints& curve, float thickness,
     float startArrowSize, float startArrowWidth, float endArrowSize, float endArrowWidth,
-    bool fill, ImU32 color, float strokeThickness)
+    bool fill, ImU32 color, float strokeThickness, int segments = 0)
 {
     using namespace ax;
 
@@ -449,7 +460,7 @@ static void ImDrawList_AddBezierWithArrows(ImDrawList* drawList, const ImCubicBe
 
     if (fill)
     {
-        drawList->AddBezierCubic(curve.P0, curve.P1, curve.P2, curve.P3, color, thickness);
+        drawList->AddBezierCubic(curve.P0, curve.P1, curve.P2, curve.P3, color, thickness, segments);
 
         if (startArrowSize > 0.0f)
         {
@@ -859,12 +870,99 @@ void ed::Link::Draw(ImDrawList* drawList, ImU32 color, float extraThickness) con
 
     const auto curve = GetCurve();
 
-    ImDrawList_AddBezierWithArrows(drawList, curve, m_Thickness + extraThickness,
-        m_StartPin && m_StartPin->m_ArrowSize  > 0.0f ? m_StartPin->m_ArrowSize  + extraThickness : 0.0f,
-        m_StartPin && m_StartPin->m_ArrowWidth > 0.0f ? m_StartPin->m_ArrowWidth + extraThickness : 0.0f,
-          m_EndPin &&   m_EndPin->m_ArrowSize  > 0.0f ?   m_EndPin->m_ArrowSize  + extraThickness : 0.0f,
-          m_EndPin &&   m_EndPin->m_ArrowWidth > 0.0f ?   m_EndPin->m_ArrowWidth + extraThickness : 0.0f,
-        true, color, 2.0f);
+    const auto lod = GetLevelOfDetail();
+    if (lod == LevelOfDetail::Straight)
+    {
+        // Far away link is only a few pixels long, arrows and curvature are not noticeable
+        if ((color >> 24) != 0)
+            drawList->AddLine(curve.P0, curve.P3, color, m_Thickness + extraThickness);
+        return;
+    }
+
+    if ((color >> 24) == 0)
+        return;
+
+    LinkGeometry::MeshKey key;
+    key.m_Thickness       = m_Thickness + extraThickness;
+    key.m_StartArrowSize  = m_StartPin && m_StartPin->m_ArrowSize  > 0.0f ? m_StartPin->m_ArrowSize  + extraThickness : 0.0f;
+    key.m_StartArrowWidth = m_StartPin && m_StartPin->m_ArrowWidth > 0.0f ? m_StartPin->m_ArrowWidth + extraThickness : 0.0f;
+    key.m_EndArrowSize    =   m_EndPin &&   m_EndPin->m_ArrowSize  > 0.0f ?   m_EndPin->m_ArrowSize  + extraThickness : 0.0f;
+    key.m_EndArrowWidth   =   m_EndPin &&   m_EndPin->m_ArrowWidth > 0.0f ?   m_EndPin->m_ArrowWidth + extraThickness : 0.0f;
+    key.m_Segments        = lod == LevelOfDetail::Simplified ? c_LinkSimplifiedSegments : 0;
+    key.m_FringeScale     = drawList->_FringeScale;
+    key.m_TessellationTol = drawList->_Data->CurveTessellationTol;
+    key.m_TexUvWhitePixel = drawList->_Data->TexUvWhitePixel;
+    key.m_Flags           = drawList->Flags;
+
+    auto& geometry = m_Geometry;
+
+    // Nothing changed since last time, copy vertices over
+    if (geometry.m_HasMesh && geometry.m_MeshKey == key)
+    {
+        const auto vertexCount = geometry.m_MeshVertices.Size;
+        const auto indexCount  = geometry.m_MeshIndices.Size;
+
+        drawList->PrimReserve(indexCount, vertexCount);
+
+        // Color is not part of the key, so hovered and selected links reuse geometry
+        const auto baseIndex        = drawList->_VtxCurrentIdx;
+        const auto transparentColor = color & ~IM_COL32_A_MASK;
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            const auto& vertex = geometry.m_MeshVertices.Data[i];
+            drawList->_VtxWritePtr[i].pos = vertex.pos;
+            drawList->_VtxWritePtr[i].uv  = vertex.uv;
+            drawList->_VtxWritePtr[i].col = (vertex.col & IM_COL32_A_MASK) ? color : transparentColor;
+        }
+        for (int i = 0; i < indexCount; ++i)
+            drawList->_IdxWritePtr[i] = static_cast<ImDrawIdx>(baseIndex + geometry.m_MeshIndices.Data[i]);
+
+        drawList->_VtxWritePtr   += vertexCount;
+        drawList->_IdxWritePtr   += indexCount;
+        drawList->_VtxCurrentIdx += vertexCount;
+        return;
+    }
+
+    const auto firstVertex  = drawList->VtxBuffer.Size;
+    const auto firstIndex   = drawList->IdxBuffer.Size;
+    const auto baseIndex    = drawList->_VtxCurrentIdx;
+    const auto commandCount = drawList->CmdBuffer.Size;
+
+    ImDrawList_AddBezierWithArrows(drawList, curve, key.m_Thickness,
+        key.m_StartArrowSize, key.m_StartArrowWidth, key.m_EndArrowSize, key.m_EndArrowWidth,
+        true, color, 2.0f, key.m_Segments);
+
+    // Geometry which did not fit into current draw command (vertex offset
+    // changed) is not cached, indices would not be relative to single base
+    geometry.m_HasMesh = false;
+    if (drawList->CmdBuffer.Size != commandCount || drawList->_VtxCurrentIdx < baseIndex)
+        return;
+
+    const auto vertexCount = drawList->VtxBuffer.Size - firstVertex;
+    const auto indexCount  = drawList->IdxBuffer.Size - firstIndex;
+
+    geometry.m_MeshVertices.resize(vertexCount);
+    memcpy(geometry.m_MeshVertices.Data, drawList->VtxBuffer.Data + firstVertex, vertexCount * sizeof(ImDrawVert));
+
+    geometry.m_MeshIndices.resize(indexCount);
+    for (int i = 0; i < indexCount; ++i)
+        geometry.m_MeshIndices.Data[i] = static_cast<ImDrawIdx>(drawList->IdxBuffer.Data[firstIndex + i] - baseIndex);
+
+    geometry.m_MeshKey = key;
+    geometry.m_HasMesh = true;
+}
+
+ed::Link::LevelOfDetail ed::Link::GetLevelOfDetail() const
+{
+    const auto& editorStyle = Editor->GetStyle();
+    const auto  zoom        = Editor->GetView().Scale;
+
+    if (editorStyle.LinkStraightZoom > 0.0f && zoom < editorStyle.LinkStraightZoom)
+        return LevelOfDetail::Straight;
+    else if (editorStyle.LinkSimplifyZoom > 0.0f && zoom < editorStyle.LinkSimplifyZoom)
+        return LevelOfDetail::Simplified;
+    else
+        return LevelOfDetail::Full;
 }
 
 void ed::Link::UpdateEndpoints()
@@ -876,6 +974,19 @@ void ed::Link::UpdateEndpoints()
 
 ImCubicBezierPoints ed::Link::GetCurve() const
 {
+    auto& geometry = m_Geometry;
+
+    LinkGeometry::CurveKey key;
+    key.m_Start         = m_Start;
+    key.m_End           = m_End;
+    key.m_StartDir      = m_StartPin->m_Dir;
+    key.m_EndDir        = m_EndPin->m_Dir;
+    key.m_StartStrength = m_StartPin->m_Strength;
+    key.m_EndStrength   = m_EndPin->m_Strength;
+
+    if (geometry.m_HasCurve && geometry.m_CurveKey == key)
+        return geometry.m_Curve;
+
     auto easeLinkStrength = [](const ImVec2& a, const ImVec2& b, float strength)
     {
         const auto distanceX    = b.x - a.x;
@@ -900,9 +1011,45 @@ ImCubicBezierPoints ed::Link::GetCurve() const
     result.P2 = cp1;
     result.P3 = m_End;
 
+    geometry.InvalidateCurve();
+    geometry.m_CurveKey = key;
+    geometry.m_Curve    = result;
+    geometry.m_HasCurve = true;
+
     return result;
 }
 
+float ed::Link::GetLength() const
+{
+    const auto curve = GetCurve();
+
+    auto& geometry = m_Geometry;
+    if (geometry.m_Length < 0.0f)
+        geometry.m_Length = ImCubicBezierLength(curve.P0, curve.P1, curve.P2, curve.P3);
+
+    return geometry.m_Length;
+}
+
+const ed::vector<ed::LinkGeometry::LengthSample>& ed::Link::GetLengthTable(float step) const
+{
+    const auto curve = GetCurve();
+
+    auto& geometry = m_Geometry;
+    if (geometry.m_LengthTable.empty() || geometry.m_LengthStep != step)
+    {
+        auto collectPointsCallback = [&geometry](ImCubicBezierFixedStepSample& result)
+        {
+            geometry.m_LengthTable.push_back(LinkGeometry::LengthSample{ result.Length, result.Point });
+        };
+
+        geometry.m_LengthTable.resize(0);
+        geometry.m_LengthStep = step;
+        ImCubicBezierFixedStep(collectPointsCallback, curve, step, false, 0.5f, 0.001f);
+    }
+
+    return geometry.m_LengthTable;
+}
+
 bool ed::Link::TestHit(const ImVec2& point, float extraThickness) const
 {
     if (!m_IsLive)
@@ -958,6 +1105,11 @@ ImRect ed::Link::GetBounds() const
     if (m_IsLive)
     {
         const auto curve = GetCurve();
+
+        auto& geometry = m_Geometry;
+        if (geometry.m_HasBounds && geometry.m_BoundsStartArrow == m_StartPin->m_ArrowSize && geometry.m_BoundsEndArrow == m_EndPin->m_ArrowSize)
+            return geometry.m_Bounds;
+
         auto bounds = ImCubicBezierBoundingRect(curve.P0, curve.P1, curve.P2, curve.P3);
 
         if (bounds.GetWidth() == 0.0f)
@@ -994,6 +1146,11 @@ ImRect ed::Link::GetBounds() const
             bounds.Add(arrowBounds);
         }
 
+        geometry.m_Bounds           = bounds;
+        geometry.m_BoundsStartArrow = m_StartPin->m_ArrowSize;
+        geometry.m_BoundsEndArrow   = m_EndPin->m_ArrowSize;
+        geometry.m_HasBounds        = true;
+
         return bounds;
     }
     else
@@ -1057,11 +1214,18 @@ ed::EditorContext::EditorContext(const ax::NodeEditor::Config* config)
 ed::EditorContext::~EditorContext()
 {
     if (m_IsInitialized)
+    {
+        m_SettingsLog.Flush();
         SaveSettings();
+    }
+
+    m_LinkMap.Clear();
+    m_PinMap.Clear();
+    m_NodeMap.Clear();
 
-    for (auto link  : m_Links)  delete link.m_Object;
-    for (auto pin   : m_Pins)   delete pin.m_Object;
-    for (auto node  : m_Nodes)  delete node.m_Object;
+    m_LinkPool.Clear();
+    m_PinPool.Clear();
+    m_NodePool.Clear();
 
     m_Splitter.ClearFreeMemory();
 }
@@ -1081,6 +1245,8 @@ void ed::EditorContext::Begin(const char* id, const ImVec2& size)
     for (auto pin   : m_Pins)     pin->Reset();
     for (auto link  : m_Links)   link->Reset();
 
+    m_RenderStats = RenderStats();
+
     m_DrawList = ImGui::GetWindowDrawList();
 
     ImDrawList_SwapSplitter(m_DrawList, m_Splitter);
@@ -1216,13 +1382,35 @@ void ed::EditorContext::End()
 
     // Draw nodes
     for (auto node : m_Nodes)
-        if (node->m_IsLive && node->IsVisible())
+    {
+        if (!node->m_IsLive)
+            continue;
+
+        if (node->IsVisible())
+        {
             node->Draw(m_DrawList);
+            ++m_RenderStats.VisibleNodes;
+        }
+        else
+            ++m_RenderStats.CulledNodes;
+    }
 
     // Draw links
     for (auto link : m_Links)
-        if (link->m_IsLive && link->IsVisible())
+    {
+        if (!link->m_IsLive)
+            continue;
+
+        if (link->IsVisible())
+        {
             link->Draw(m_DrawList);
+            ++m_RenderStats.VisibleLinks;
+            if (link->GetLevelOfDetail() != Link::LevelOfDetail::Full)
+                ++m_RenderStats.SimplifiedLinks;
+        }
+        else
+            ++m_RenderStats.CulledLinks;
+    }
 
     // Highlight selected objects
     {
@@ -1961,18 +2149,18 @@ int ed::EditorContext::CountLiveLinks() const
 ed::Pin* ed::EditorContext::CreatePin(PinId id, PinKind kind)
 {
     IM_ASSERT(nullptr == FindObject(id));
-    auto pin = new Pin(this, id, kind);
+    auto pin = m_PinPool.Create(this, id, kind);
     m_Pins.push_back({id, pin});
-    std::sort(m_Pins.begin(), m_Pins.end());
+    m_PinMap.Insert(id, pin);
     return pin;
 }
 
 ed::Node* ed::EditorContext::CreateNode(NodeId id)
 {
     IM_ASSERT(nullptr == FindObject(id));
-    auto node = new Node(this, id);
+    auto node = m_NodePool.Create(this, id);
     m_Nodes.push_back({id, node});
-    //std::sort(Nodes.begin(), Nodes.end());
+    m_NodeMap.Insert(id, node);
 
     auto settings = m_Settings.FindNode(id);
     if (!settings)
@@ -1992,81 +2180,31 @@ ed::Node* ed::EditorContext::CreateNode(NodeId id)
 ed::Link* ed::EditorContext::CreateLink(LinkId id)
 {
     IM_ASSERT(nullptr == FindObject(id));
-    auto link = new Link(this, id);
+    auto link = m_LinkPool.Create(this, id);
     m_Links.push_back({id, link});
-    std::sort(m_Links.begin(), m_Links.end());
+    m_LinkMap.Insert(id, link);
 
     return link;
 }
 
-template <typename C, typename Id>
-static inline auto FindItemInLinear(C& container, Id id)
-{
-# if defined(_DEBUG)
-    auto start = container.data();
-    auto end   = container.data() + container.size();
-    for (auto it = start; it < end; ++it)
-        if ((*it).m_ID == id)
-            return it->m_Object;
-# else
-    for (auto item : container)
-        if (item.m_ID == id)
-            return item.m_Object;
-# endif
-
-   return static_cast<decltype(container[0].m_Object)>(nullptr);
-}
-
-template <typename C, typename Id>
-static inline auto FindItemIn(C& container, Id id)
-{
-//# if defined(_DEBUG)
-//    auto start = container.data();
-//    auto end   = container.data() + container.size();
-//    for (auto it = start; it < end; ++it)
-//        if ((*it)->ID == id)
-//            return *it;
-//# else
-//    for (auto item : container)
-//        if (item->ID == id)
-//            return item;
-//# endif
-    auto key = typename C::value_type{ id, nullptr };
-    auto first = container.cbegin();
-    auto last  = container.cend();
-    auto it    = std::lower_bound(first, last, key);
-    if (it != last && (key.m_ID == it->m_ID))
-        return it->m_Object;
-    else
-        return static_cast<decltype(it->m_Object)>(nullptr);
-}
-
 ed::Node* ed::EditorContext::FindNode(NodeId id)
 {
-    if (m_Nodes.size() == 0)
-        return nullptr;
-    return FindItemInLinear(m_Nodes, id);
+    return m_NodeMap.Find(id);
 }
 
 const ed::Node* ed::EditorContext::FindNode(NodeId id) const
 {
-    if (m_Nodes.size() == 0)
-        return nullptr;
-    return FindItemInLinear(m_Nodes, id);
+    return m_NodeMap.Find(id);
 }
 
 ed::Pin* ed::EditorContext::FindPin(PinId id)
 {
-    if (m_Pins.size() == 0)
-        return nullptr;
-    return FindItemIn(m_Pins, id);
+    return m_PinMap.Find(id);
 }
 
 ed::Link* ed::EditorContext::FindLink(LinkId id)
 {
-    if (m_Links.size() == 0)
-        return nullptr;
-    return FindItemIn(m_Links, id);
+    return m_LinkMap.Find(id);
 }
 
 ed::Object* ed::EditorContext::FindObject(ObjectId id)
@@ -2376,6 +2514,12 @@ void ed::EditorContext::LoadSettings()
 {
     EditorState state;
 
+    if (m_Config.SettingsBinaryFile && SettingsLog::Read(m_Config.SettingsBinaryFile, state))
+    {
+        ApplyState(state);
+        return;
+    }
+
     string error;
     if (!Serialization::Parse(m_Config.Load(), state, &error))
         return;
@@ -2385,27 +2529,116 @@ void ed::EditorContext::LoadSettings()
 
 void ed::EditorContext::SaveSettings()
 {
-    RecordState(m_State);
+    const bool saveState = m_Config.HasSaveTarget();
+    const bool saveNodes = m_Config.HasSaveNodeTarget();
+    const bool saveLog   = m_Config.SettingsBinaryFile != nullptr;
 
-    m_Config.BeginSave();
+    if (!saveState && !saveNodes && !saveLog)
+    {
+        // Nothing will consume settings, do not record state over and over again
+        m_Settings.ClearDirty();
+        return;
+    }
 
-    for (auto& node : m_Nodes)
+    if (m_Settings.m_IsSavePending)
     {
-        auto settings = m_Settings.FindNode(node->m_ID);
+        // Dirty state stays until background write is confirmed
+        bool written = false;
+        if (!m_SettingsLog.Poll(written))
+            return;
+
+        m_Settings.m_IsSavePending = false;
+        if (written && m_Settings.m_ChangeCount == m_Settings.m_PendingChangeCount)
+        {
+            m_Settings.ClearDirty();
+            return;
+        }
+
+        // Write failed or settings changed meanwhile, save again
+    }
+
+    const bool rewriteLog = saveLog && m_SettingsLog.NeedsRewrite();
 
-        if (!node->m_RestoreState && settings->m_IsDirty && (m_Config.SaveNodeSettings || m_Config.SaveNodeSettingsJson))
+    if (saveState || rewriteLog)
+        RecordState(m_State);
+    else
+    {
+        // Log only needs nodes which changed since last save
+        for (auto nodeId : m_Settings.m_DirtyNodes)
         {
+            auto node = FindNode(nodeId);
+            if (node && node->m_IsLive && !node->m_RestoreState)
+                RecordState(node, m_State.m_NodesState.m_Nodes[nodeId]);
+        }
+
+        RecordState(m_State.m_SelectionState);
+        RecordState(m_State.m_ViewState);
+    }
+
+    m_Config.BeginSave();
+
+    bool nodesSaved = true;
+    if (saveNodes)
+    {
+        for (auto nodeId : m_Settings.m_DirtyNodes)
+        {
+            auto node     = FindNode(nodeId);
+            auto settings = m_Settings.FindNode(nodeId);
+            if (!node || node->m_RestoreState || !settings->m_IsDirty)
+                continue;
+
             NodeState nodeState;
             RecordState(node, nodeState);
 
             if (m_Config.SaveNode(node->m_ID, Serialization::ToJson(nodeState), settings->m_DirtyReason))
                 settings->ClearDirty();
+            else
+                nodesSaved = false;
         }
     }
 
-    auto serializedState = Serialization::ToJson(m_State);
+    bool saved = true;
+
+    if (saveLog)
+    {
+        const auto reason = m_Settings.m_DirtyReason;
+        const auto& nodes = m_State.m_NodesState.m_Nodes;
+
+        if (rewriteLog)
+        {
+            for (auto& entry : nodes)
+                m_SettingsLog.AppendNode(entry.first, entry.second);
+        }
+        else
+        {
+            for (auto nodeId : m_Settings.m_DirtyNodes)
+            {
+                auto it = nodes.find(nodeId);
+                if (it != nodes.end())
+                    m_SettingsLog.AppendNode(it->first, it->second);
+            }
+        }
+
+        if (rewriteLog || (reason & SaveReasonFlags::Selection) != SaveReasonFlags::None)
+            m_SettingsLog.AppendSelection(m_State.m_SelectionState);
+        if (rewriteLog || (reason & SaveReasonFlags::Navigation) != SaveReasonFlags::None)
+            m_SettingsLog.AppendView(m_State.m_ViewState);
+
+        saved &= m_SettingsLog.Commit(m_Config.SettingsBinaryFile, rewriteLog, m_Config.SaveSettingsInBackground);
+    }
+
+    if (saveState)
+        saved &= m_Config.Save(Serialization::ToJson(m_State), m_Settings.m_DirtyReason);
+
+    if (!saveState && !saveLog)
+        saved = nodesSaved;
 
-    if (m_Config.Save(serializedState, m_Settings.m_DirtyReason))
+    if (saved && saveLog && m_Config.SaveSettingsInBackground)
+    {
+        m_Settings.m_IsSavePending      = true;
+        m_Settings.m_PendingChangeCount = m_Settings.m_ChangeCount;
+    }
+    else if (saved)
         m_Settings.ClearDirty();
 
     m_Config.EndSave();
@@ -2809,6 +3042,8 @@ void ed::EditorContext::ShowMetrics(const Control& control)
     ImGui::Text("Live Nodes: %d", liveNodeCount);
     ImGui::Text("Live Pins: %d", livePinCount);
     ImGui::Text("Live Links: %d", liveLinkCount);
+    ImGui::Text("Visible Nodes: %d (culled: %d, collapsed: %d)", m_RenderStats.VisibleNodes, m_RenderStats.CulledNodes, m_RenderStats.CollapsedNodes);
+    ImGui::Text("Visible Links: %d (culled: %d, simplified: %d)", m_RenderStats.VisibleLinks, m_RenderStats.CulledLinks, m_RenderStats.SimplifiedLinks);
     ImGui::Text("Hot Object: %s (%p)", getHotObjectName(), control.HotObject ? control.HotObject->ID().AsPointer() : nullptr);
     if (auto node = control.HotObject ? control.HotObject->AsNode() : nullptr)
     {
@@ -2888,8 +3123,14 @@ void ed::Settings::ClearDirty(Node* node)
         m_IsDirty     = false;
         m_DirtyReason = SaveReasonFlags::None;
 
-        for (auto& knownNode : m_Nodes)
-            knownNode.second.ClearDirty();
+        for (auto nodeId : m_DirtyNodes)
+        {
+            auto settings = FindNode(nodeId);
+            settings->ClearDirty();
+            settings->m_IsQueued = false;
+        }
+
+        m_DirtyNodes.clear();
     }
 }
 
@@ -2897,6 +3138,7 @@ void ed::Settings::MakeDirty(SaveReasonFlags reason, Node* node)
 {
     m_IsDirty     = true;
     m_DirtyReason = m_DirtyReason | reason;
+    ++m_ChangeCount;
 
     if (node)
     {
@@ -2904,6 +3146,388 @@ void ed::Settings::MakeDirty(SaveReasonFlags reason, Node* node)
         IM_ASSERT(settings);
 
         settings->MakeDirty(reason);
+
+        if (!settings->m_IsQueued)
+        {
+            settings->m_IsQueued = true;
+            m_DirtyNodes.push_back(node->m_ID);
+        }
+    }
+}
+
+
+
+
+//------------------------------------------------------------------------------
+//
+// Settings Log
+//
+//------------------------------------------------------------------------------
+namespace ax {
+namespace NodeEditor {
+namespace Detail {
+
+static const char     c_SettingsLogMagic[4]     = { 'N', 'E', 'S', 'L' };
+static const uint32_t c_SettingsLogVersion      = 1;
+static const size_t   c_SettingsLogHeaderSize   = sizeof(c_SettingsLogMagic) + sizeof(c_SettingsLogVersion);
+static const size_t   c_SettingsLogMinRewrite   = 64 * 1024; // Log is allowed to grow at least that much before rewrite
+
+enum class SettingsRecord : uint8_t
+{
+    Node      = 1,
+    Selection = 2,
+    View      = 3
+};
+
+template <typename T>
+static void SettingsLog_Put(string& out, const T& value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Writes record header and returns offset of its size field, to be patched
+// by SettingsLog_EndRecord() once payload is known.
+static size_t SettingsLog_BeginRecord(string& out, SettingsRecord type)
+{
+    SettingsLog_Put(out, static_cast<uint8_t>(type));
+    auto sizeOffset = out.size();
+    SettingsLog_Put(out, uint32_t(0));
+    return sizeOffset;
+}
+
+static void SettingsLog_EndRecord(string& out, size_t sizeOffset)
+{
+    const auto size = static_cast<uint32_t>(out.size() - sizeOffset - sizeof(uint32_t));
+    memcpy(&out[sizeOffset], &size, sizeof(size));
+}
+
+struct SettingsLogReader
+{
+    const char* m_Data;
+    const char* m_End;
+
+    template <typename T>
+    bool Get(T& value)
+    {
+        if (static_cast<size_t>(m_End - m_Data) < sizeof(T))
+            return false;
+        memcpy(&value, m_Data, sizeof(T));
+        m_Data += sizeof(T);
+        return true;
+    }
+
+    bool Get(ImVec2& value)
+    {
+        return Get(value.x) && Get(value.y);
+    }
+
+    bool Get(ImRect& value)
+    {
+        return Get(value.Min) && Get(value.Max);
+    }
+};
+
+} // namespace Detail
+} // namespace NodeEditor
+} // namespace ax
+
+ed::SettingsLog::SettingsLog()
+    : m_SnapshotSize(0)
+    , m_LogSize(0)
+    , m_HasSnapshot(false)
+    , m_Failed(false)
+    , m_WriteFailed(false)
+    , m_IsWriting(false)
+    , m_Quit(false)
+{
+}
+
+ed::SettingsLog::~SettingsLog()
+{
+    if (m_Worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Quit = true;
+        }
+        m_WakeUp.notify_one();
+        m_Worker.join();
+    }
+}
+
+bool ed::SettingsLog::Read(const char* path, EditorState& state)
+{
+    std::ifstream file(path, std::ios_base::binary);
+    if (!file)
+        return false;
+
+    string data;
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    if (data.size() < c_SettingsLogHeaderSize || memcmp(data.data(), c_SettingsLogMagic, sizeof(c_SettingsLogMagic)) != 0)
+        return false;
+
+    SettingsLogReader reader = { data.data() + sizeof(c_SettingsLogMagic), data.data() + data.size() };
+
+    uint32_t version = 0;
+    if (!reader.Get(version) || version != c_SettingsLogVersion)
+        return false;
+
+    EditorState result;
+
+    for (;;)
+    {
+        uint8_t  type = 0;
+        uint32_t size = 0;
+        if (!reader.Get(type) || !reader.Get(size) || static_cast<size_t>(reader.m_End - reader.m_Data) < size)
+            break; // End of log or record truncated by interrupted write
+
+        SettingsLogReader record = { reader.m_Data, reader.m_Data + size };
+        reader.m_Data += size;
+
+        switch (static_cast<SettingsRecord>(type))
+        {
+            case SettingsRecord::Node:
+                {
+                    uint64_t  id = 0;
+                    NodeState nodeState;
+                    if (record.Get(id) && record.Get(nodeState.m_Location) && record.Get(nodeState.m_Size) && record.Get(nodeState.m_GroupSize))
+                        result.m_NodesState.m_Nodes[NodeId(static_cast<uintptr_t>(id))] = nodeState;
+                }
+                break;
+
+            case SettingsRecord::Selection:
+                {
+                    uint32_t count = 0;
+                    if (!record.Get(count))
+                        break;
+
+                    SelectionState selection;
+                    selection.m_Selection.reserve(count);
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        uint8_t  objectType = 0;
+                        uint64_t id         = 0;
+                        if (!record.Get(objectType) || !record.Get(id))
+                            break;
+
+                        const auto pointer = static_cast<uintptr_t>(id);
+                        switch (static_cast<ObjectType>(objectType))
+                        {
+                            case ObjectType::Node: selection.m_Selection.push_back(NodeId(pointer)); break;
+                            case ObjectType::Link: selection.m_Selection.push_back(LinkId(pointer)); break;
+                            case ObjectType::Pin:  selection.m_Selection.push_back(PinId(pointer));  break;
+                            default: break;
+                        }
+                    }
+
+                    result.m_SelectionState = std::move(selection);
+                }
+                break;
+
+            case SettingsRecord::View:
+                {
+                    ViewState view;
+                    uint32_t  themeSize = 0;
+                    if (!record.Get(view.m_ViewScroll) || !record.Get(view.m_ViewZoom) || !record.Get(view.m_VisibleRect) || !record.Get(themeSize))
+                        break;
+                    if (static_cast<size_t>(record.m_End - record.m_Data) < themeSize)
+                        break;
+                    view.m_Theme.assign(record.m_Data, themeSize);
+
+                    result.m_ViewState = std::move(view);
+                }
+                break;
+
+            default:
+                break; // Unknown record, written by newer version
+        }
+    }
+
+    state = std::move(result);
+
+    return true;
+}
+
+bool ed::SettingsLog::NeedsRewrite() const
+{
+    return !m_HasSnapshot || m_Failed || m_LogSize > ImMax(m_SnapshotSize, c_SettingsLogMinRewrite);
+}
+
+void ed::SettingsLog::AppendNode(NodeId id, const NodeState& state)
+{
+    auto record = SettingsLog_BeginRecord(m_Pending, SettingsRecord::Node);
+    SettingsLog_Put(m_Pending, static_cast<uint64_t>(id.Get()));
+    SettingsLog_Put(m_Pending, state.m_Location);
+    SettingsLog_Put(m_Pending, state.m_Size);
+    SettingsLog_Put(m_Pending, state.m_GroupSize);
+    SettingsLog_EndRecord(m_Pending, record);
+}
+
+void ed::SettingsLog::AppendSelection(const SelectionState& state)
+{
+    auto record = SettingsLog_BeginRecord(m_Pending, SettingsRecord::Selection);
+    SettingsLog_Put(m_Pending, static_cast<uint32_t>(state.m_Selection.size()));
+    for (auto& objectId : state.m_Selection)
+    {
+        SettingsLog_Put(m_Pending, static_cast<uint8_t>(objectId.Type()));
+        SettingsLog_Put(m_Pending, static_cast<uint64_t>(objectId.Get()));
+    }
+    SettingsLog_EndRecord(m_Pending, record);
+}
+
+void ed::SettingsLog::AppendView(const ViewState& state)
+{
+    auto record = SettingsLog_BeginRecord(m_Pending, SettingsRecord::View);
+    SettingsLog_Put(m_Pending, state.m_ViewScroll);
+    SettingsLog_Put(m_Pending, state.m_ViewZoom);
+    SettingsLog_Put(m_Pending, state.m_VisibleRect.Min);
+    SettingsLog_Put(m_Pending, state.m_VisibleRect.Max);
+    SettingsLog_Put(m_Pending, static_cast<uint32_t>(state.m_Theme.size()));
+    m_Pending.append(state.m_Theme);
+    SettingsLog_EndRecord(m_Pending, record);
+}
+
+bool ed::SettingsLog::Commit(const char* path, bool rewrite, bool background)
+{
+    Job job;
+    job.m_Path    = path;
+    job.m_Rewrite = rewrite;
+
+    if (rewrite)
+    {
+        job.m_Data.reserve(c_SettingsLogHeaderSize + m_Pending.size());
+        job.m_Data.append(c_SettingsLogMagic, sizeof(c_SettingsLogMagic));
+        SettingsLog_Put(job.m_Data, c_SettingsLogVersion);
+        job.m_Data.append(m_Pending);
+
+        m_SnapshotSize = job.m_Data.size();
+        m_LogSize      = 0;
+        m_HasSnapshot  = true;
+        m_Failed       = false;
+    }
+    else
+    {
+        job.m_Data    = std::move(m_Pending);
+        m_LogSize    += job.m_Data.size();
+    }
+
+    m_Pending.clear();
+
+# if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    if (background)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Jobs.push_back(std::move(job));
+        }
+
+        if (!m_Worker.joinable())
+            m_Worker = std::thread(&SettingsLog::WorkerMain, this);
+        else
+            m_WakeUp.notify_one();
+
+        return true;
+    }
+# else
+    IM_UNUSED(background);
+# endif
+
+    // Do not let synchronous write overtake ones still queued
+    Flush();
+
+    if (!Write(job))
+    {
+        m_Failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool ed::SettingsLog::Poll(bool& written)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Jobs.empty() || m_IsWriting)
+        return false;
+
+    written       = !m_WriteFailed;
+    m_WriteFailed = false;
+    return true;
+}
+
+void ed::SettingsLog::Flush()
+{
+    if (!m_Worker.joinable())
+        return;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Idle.wait(lock, [this] { return m_Jobs.empty() && !m_IsWriting; });
+}
+
+bool ed::SettingsLog::Write(const Job& job)
+{
+    if (!job.m_Rewrite)
+    {
+        auto file = fopen(job.m_Path.c_str(), "ab");
+        if (!file)
+            return false;
+        const bool written = fwrite(job.m_Data.data(), 1, job.m_Data.size(), file) == job.m_Data.size();
+        return (fclose(file) == 0) && written;
+    }
+
+    // New snapshot goes to temporary file first, so a crash never leaves
+    // settings file half written
+    const auto tempPath = job.m_Path + ".tmp";
+
+    auto file = fopen(tempPath.c_str(), "wb");
+    if (!file)
+        return false;
+    const bool written = fwrite(job.m_Data.data(), 1, job.m_Data.size(), file) == job.m_Data.size();
+    if (fclose(file) != 0 || !written)
+    {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    // Replace in one step, old file stays in place until new one is complete
+# if defined(_WIN32)
+    const bool replaced = MoveFileExA(tempPath.c_str(), job.m_Path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+# else
+    const bool replaced = rename(tempPath.c_str(), job.m_Path.c_str()) == 0;
+# endif
+    if (!replaced)
+        remove(tempPath.c_str());
+    return replaced;
+}
+
+void ed::SettingsLog::WorkerMain()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;)
+    {
+        m_WakeUp.wait(lock, [this] { return m_Quit || !m_Jobs.empty(); });
+        if (m_Jobs.empty())
+            break;
+
+        auto job = std::move(m_Jobs.front());
+        m_Jobs.pop_front();
+        m_IsWriting = true;
+
+        lock.unlock();
+        const bool written = Write(job);
+        lock.lock();
+
+        // Failed append leaves log with a hole, next commit rewrites whole file
+        if (!written)
+        {
+            m_Failed      = true;
+            m_WriteFailed = true;
+        }
+
+        m_IsWriting = false;
+        if (m_Jobs.empty())
+            m_Idle.notify_all();
     }
 }
 
@@ -3064,8 +3688,7 @@ ed::FlowAnimation::FlowAnimation(FlowAnimationController* controller):
     Animation(controller->Editor),
     Controller(controller),
     m_Link(nullptr),
-    m_Offset(0.0f),
-    m_PathLength(0.0f)
+    m_Offset(0.0f)
 {
 }
 
@@ -3094,13 +3717,7 @@ void ed::FlowAnimation::Flow(ed::Link* link, float markerDistance, float speed,
     }
 
     if (m_Link != link)
-    {
         m_Offset = 0.0f;
-        ClearPath();
-    }
-
-    if (m_MarkerDistance != markerDistance)
-        ClearPath();
 
     m_MarkerDistance = markerDistance;
     //m_Speed          = speed;
@@ -3111,13 +3728,7 @@ void ed::FlowAnimation::Flow(ed::Link* link, float markerDistance, float speed,
     Stop();
 
     if (m_Link != link)
-    {
         m_Offset = 0.0f;
-        ClearPath();
-    }
-
-    if (m_MarkerDistance != markerDistance)
-        ClearPath();
 
     m_MarkerDistance = markerDistance;
     m_Speed          = speed;
@@ -3132,9 +3743,6 @@ void ed::FlowAnimation::Draw(ImDrawList* drawList)
     if (!IsPlaying() || !IsLinkValid() || !m_Link->IsVisible())
         return;
 
-    if (!IsPathValid())
-        UpdatePath();
-
     m_Offset = fmodf(m_Offset, m_MarkerDistance);
     if (m_Offset < 0)
         m_Offset += m_MarkerDistance;
@@ -3147,7 +3755,11 @@ void ed::FlowAnimation::Draw(ImDrawList* drawList)
 
     m_Link->Draw(drawList, flowColor, 2.0f);
 
-    if (IsPathValid())
+    // Both are cached by the link until its curve changes
+    const auto& path       = m_Link->GetLengthTable(ImMax(m_MarkerDistance * 0.5f, 15.0f));
+    const auto  pathLength = m_Link->GetLength();
+
+    if (path.size() > 1 && pathLength > 0.0f)
     {
         //Offset = 0;
         bool dmark = m_Link->m_StartPin->m_Dir.x == -1;
@@ -3155,8 +3767,8 @@ void ed::FlowAnimation::Draw(ImDrawList* drawList)
         const auto markerRadius = 3.0f * (1.0f - progress) + 2.0f;
         const auto markerColor  = Editor->GetColor(dmark ? StyleColor_FlowDMarker : StyleColor_FlowMarker, markerAlpha);
 
-        for (float d = m_Offset; d < m_PathLength; d += m_MarkerDistance)
-            drawList->AddCircleFilled(SamplePath(d), markerRadius, markerColor);
+        for (float d = m_Offset; d < pathLength; d += m_MarkerDistance)
+            drawList->AddCircleFilled(SamplePath(path, d), markerRadius, markerColor);
     }
 }
 
@@ -3165,57 +3777,21 @@ bool ed::FlowAnimation::IsLinkValid() const
     return m_Link && m_Link->m_IsLive;
 }
 
-bool ed::FlowAnimation::IsPathValid() const
-{
-    return m_Path.size() > 1 && m_PathLength > 0.0f && m_Link->m_Start == m_LastStart && m_Link->m_End == m_LastEnd;
-}
-
-void ed::FlowAnimation::UpdatePath()
-{
-    if (!IsLinkValid())
-    {
-        ClearPath();
-        return;
-    }
-
-    const auto curve  = m_Link->GetCurve();
-
-    m_LastStart  = m_Link->m_Start;
-    m_LastEnd    = m_Link->m_End;
-    m_PathLength = ImCubicBezierLength(curve.P0, curve.P1, curve.P2, curve.P3);
-
-    auto collectPointsCallback = [this](ImCubicBezierFixedStepSample& result)
-    {
-        m_Path.push_back(CurvePoint{ result.Length, result.Point });
-    };
-
-    const auto step = ImMax(m_MarkerDistance * 0.5f, 15.0f);
-
-    m_Path.resize(0);
-    ImCubicBezierFixedStep(collectPointsCallback, curve, step, false, 0.5f, 0.001f);
-}
-
-void ed::FlowAnimation::ClearPath()
-{
-    vector<CurvePoint>().swap(m_Path);
-    m_PathLength = 0.0f;
-}
-
-ImVec2 ed::FlowAnimation::SamplePath(float distance) const
+ImVec2 ed::FlowAnimation::SamplePath(const vector<LinkGeometry::LengthSample>& path, float distance) const
 {
     //distance = ImMax(0.0f, std::min(distance, PathLength));
 
-    auto endPointIt = std::find_if(m_Path.begin(), m_Path.end(), [distance](const CurvePoint& p) { return distance < p.Distance; });
-    if (endPointIt == m_Path.end())
-        endPointIt = m_Path.end() - 1;
-    else if (endPointIt == m_Path.begin())
-        endPointIt = m_Path.begin() + 1;
+    auto endPointIt = std::upper_bound(path.begin(), path.end(), distance, [](float d, const LinkGeometry::LengthSample& p) { return d < p.m_Distance; });
+    if (endPointIt == path.end())
+        endPointIt = path.end() - 1;
+    else if (endPointIt == path.begin())
+        endPointIt = path.begin() + 1;
 
     const auto& start = endPointIt[-1];
     const auto& end   = *endPointIt;
-    const auto  t     = (distance - start.Distance) / (end.Distance - start.Distance);
+    const auto  t     = (distance - start.m_Distance) / (end.m_Distance - start.m_Distance);
 
-    return start.Point + (end.Point - start.Point) * t;
+    return start.m_Point + (end.m_Point - start.m_Point) * t;
 }
 
 void ed::FlowAnimation::OnUpdate(float progress)
@@ -5312,7 +5888,8 @@ void ed::DeleteItemsAction::RemoveItem(bool deleteDependencies)
 ed::NodeBuilder::NodeBuilder(EditorContext* editor):
     Editor(editor),
     m_CurrentNode(nullptr),
-    m_CurrentPin(nullptr)
+    m_CurrentPin(nullptr),
+    m_IsContentClipped(false)
 {
 }
 
@@ -5405,12 +5982,40 @@ void ed::NodeBuilder::Begin(NodeId nodeId)
         ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(editorStyle.NodePadding.x, editorStyle.NodePadding.y));
         ImGui::BeginGroup();
     }
+
+    // Node content is still laid out to keep node and pin bounds up to date,
+    // but off-screen or collapsed nodes get empty clip rectangle. ImGui items
+    // outside of clip rectangle are not rendered and produce no draw commands.
+    // Bounds are from previous frame, new nodes are never clipped.
+    auto nodeBounds = m_CurrentNode->m_Bounds;
+    if (::IsGroup(m_CurrentNode))
+        nodeBounds.Add(m_CurrentNode->m_GroupBounds);
+
+    const bool isCollapsed = editorStyle.NodeCollapseZoom > 0.0f && Editor->GetView().Scale < editorStyle.NodeCollapseZoom;
+    const bool isCulled    = !ImRect_IsEmpty(nodeBounds) && !ImGui::IsRectVisible(nodeBounds.Min, nodeBounds.Max);
+
+    m_IsContentClipped = isCollapsed || isCulled;
+    if (m_IsContentClipped)
+    {
+        if (isCollapsed && !isCulled)
+            ++Editor->GetRenderStats().CollapsedNodes;
+
+        // Zero area rectangle just outside of node top-left corner, nothing laid out inside node can overlap it
+        const auto clipPoint = m_CurrentNode->m_Bounds.Min - ImVec2(1.0f, 1.0f);
+        ImGui::PushClipRect(clipPoint, clipPoint, false);
+    }
 }
 
 void ed::NodeBuilder::End()
 {
     IM_ASSERT(nullptr != m_CurrentNode);
 
+    if (m_IsContentClipped)
+    {
+        ImGui::PopClipRect();
+        m_IsContentClipped = false;
+    }
+
     if (auto drawList = Editor->GetDrawList())
     {
         IM_ASSERT(drawList->_Splitter._Count == 1); // Did you forgot to call drawList->ChannelsMerge()?
@@ -5852,6 +6457,9 @@ float* ed::Style::GetVarFloatAddr(StyleVar idx)
         case StyleVar_PinArrowWidth:            return &PinArrowWidth;
         case StyleVar_GroupRounding:            return &GroupRounding;
         case StyleVar_GroupBorderWidth:         return &GroupBorderWidth;
+        case StyleVar_NodeCollapseZoom:         return &NodeCollapseZoom;
+        case StyleVar_LinkSimplifyZoom:         return &LinkSimplifyZoom;
+        case StyleVar_LinkStraightZoom:         return &LinkStraightZoom;
         default:                                return nullptr;
     }
 }
@@ -6001,3 +6609,13 @@ void ed::Config::EndSave()
     if (EndSaveSession)
         EndSaveSession(UserPointer);
 }
+
+bool ed::Config::HasSaveTarget() const
+{
+    return SaveSettingsJson || SaveSettings || SettingsFile;
+}
+
+bool ed::Config::HasSaveNodeTarget() const
+{
+    return SaveNodeSettingsJson || SaveNodeSettings;
+}
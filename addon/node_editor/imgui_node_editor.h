@@ -120,6 +120,8 @@ struct Config
     using CanvasSizeModeAlias = ax::NodeEditor::CanvasSizeMode;
 
     const char*                 SettingsFile;
+    const char*                 SettingsBinaryFile;       // Incremental binary settings log, loaded before SettingsFile. Set SettingsFile to null to save binary only
+    bool                        SaveSettingsInBackground; // Write SettingsBinaryFile from a worker thread
     ConfigSession               BeginSaveSession;
     ConfigSession               EndSaveSession;
     ConfigSaveSettings          SaveSettings;
@@ -141,6 +143,8 @@ struct Config
 
     Config()
         : SettingsFile(nullptr)
+        , SettingsBinaryFile(nullptr)
+        , SaveSettingsInBackground(false)
         , BeginSaveSession(nullptr)
         , EndSaveSession(nullptr)
         , SaveSettings(nullptr)
@@ -227,6 +231,9 @@ enum StyleVar
     StyleVar_PinArrowWidth,
     StyleVar_GroupRounding,
     StyleVar_GroupBorderWidth,
+    StyleVar_NodeCollapseZoom,
+    StyleVar_LinkSimplifyZoom,
+    StyleVar_LinkStraightZoom,
 
     StyleVar_Count
 };
@@ -256,6 +263,9 @@ struct Style
     float   PinArrowWidth;
     float   GroupRounding;
     float   GroupBorderWidth;
+    float   NodeCollapseZoom;       // Below this zoom nodes are drawn as plain rectangles, node content is not rendered (0 - disabled)
+    float   LinkSimplifyZoom;       // Below this zoom links are tessellated with fixed, low number of segments (0 - disabled)
+    float   LinkStraightZoom;       // Below this zoom links are drawn as straight lines without arrows (0 - disabled)
     ImVec4  Colors[StyleColor_Count];
 
     Style()
@@ -283,6 +293,9 @@ struct Style
         PinArrowWidth           = 0.0f;
         GroupRounding           = 6.0f;
         GroupBorderWidth        = 1.0f;
+        NodeCollapseZoom        = 0.0f;
+        LinkSimplifyZoom        = 0.0f;
+        LinkStraightZoom        = 0.0f;
 
         Colors[StyleColor_Bg]                 = ImColor( 60,  60,  70,  50);
         Colors[StyleColor_Grid]               = ImColor(120, 120, 120,  40);
@@ -306,6 +319,28 @@ struct Style
 };
 
 
+//------------------------------------------------------------------------------
+struct RenderStats
+{
+    int VisibleNodes;       // Live nodes which intersect view
+    int CulledNodes;        // Live nodes outside of view, nothing is drawn for them
+    int CollapsedNodes;     // Nodes which content was hidden by NodeCollapseZoom
+    int VisibleLinks;       // Live links which intersect view
+    int CulledLinks;        // Live links outside of view
+    int SimplifiedLinks;    // Visible links drawn with reduced detail (LinkSimplifyZoom or LinkStraightZoom)
+
+    RenderStats()
+        : VisibleNodes(0)
+        , CulledNodes(0)
+        , CollapsedNodes(0)
+        , VisibleLinks(0)
+        , CulledLinks(0)
+        , SimplifiedLinks(0)
+    {
+    }
+};
+
+
 //------------------------------------------------------------------------------
 struct EditorContext;
 
@@ -492,6 +527,7 @@ IMGUI_API ImVec2 GetViewSize();
 IMGUI_API ImRect GetViewRect();
 
 IMGUI_API int GetNodeCount();                                // Returns number of submitted nodes since Begin() call
+IMGUI_API RenderStats GetRenderStats();                      // Returns visible/culled object counts, valid after End() call
 IMGUI_API int GetOrderedNodeIds(NodeId* nodes, int size);    // Fills an array with node id's in order they're drawn; up to 'size` elements are set. Returns actual size of filled id's.
 
 IMGUI_API void DrawLastLine(bool light = false);
@@ -1055,6 +1055,11 @@ int ax::NodeEditor::GetNodeCount()
     return s_Editor->CountLiveNodes();
 }
 
+ax::NodeEditor::RenderStats ax::NodeEditor::GetRenderStats()
+{
+    return s_Editor->GetRenderStats();
+}
+
 int ax::NodeEditor::GetOrderedNodeIds(NodeId* nodes, int size)
 {
     return s_Editor->GetNodeIds(nodes, size);
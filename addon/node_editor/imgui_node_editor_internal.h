@@ -25,8 +25,15 @@
 # include "imgui_json.h"
 
 # include <map>
+# include <new>
+# include <deque>
 # include <vector>
 # include <string>
+# include <utility>
+# include <mutex>
+# include <atomic>
+# include <thread>
+# include <condition_variable>
 
 
 //------------------------------------------------------------------------------
@@ -235,6 +242,7 @@ using ax::NodeEditor::PinKind;
 using ax::NodeEditor::StyleColor;
 using ax::NodeEditor::StyleVar;
 using ax::NodeEditor::SaveReasonFlags;
+using ax::NodeEditor::RenderStats;
 
 using ax::NodeEditor::NodeId;
 using ax::NodeEditor::PinId;
@@ -290,6 +298,144 @@ struct ObjectWrapper
     }
 };
 
+// Open addressing hash map from object ID to object pointer.
+// Linear probing over power of two table, nullptr marks free slot.
+// Objects are never removed individually, only whole map is cleared.
+template <typename T, typename Id = typename T::IdType>
+struct ObjectMap
+{
+    ObjectMap() = default;
+    ObjectMap(const ObjectMap&) = delete;
+    ObjectMap& operator=(const ObjectMap&) = delete;
+
+    T* Find(Id id) const
+    {
+        if (m_Count == 0)
+            return nullptr;
+
+        const auto key = id.Get();
+        for (auto index = Hash(key) & m_Mask; ; index = (index + 1) & m_Mask)
+        {
+            const auto& slot = m_Slots[index];
+            if (slot.m_Object == nullptr)
+                return nullptr;
+            if (slot.m_Key == key)
+                return slot.m_Object;
+        }
+    }
+
+    void Insert(Id id, T* object)
+    {
+        IM_ASSERT(object != nullptr);
+
+        // Keep load factor below 1/2, probe sequences stay short
+        if ((m_Count + 1) * 2 > m_Slots.size())
+            Rehash(m_Slots.empty() ? 64 : m_Slots.size() * 2);
+
+        InsertSlot(id.Get(), object);
+        ++m_Count;
+    }
+
+    void Clear()
+    {
+        m_Slots.clear();
+        m_Mask  = 0;
+        m_Count = 0;
+    }
+
+    size_t Size() const { return m_Count; }
+
+private:
+    struct Slot
+    {
+        uintptr_t m_Key    = 0;
+        T*        m_Object = nullptr;
+    };
+
+    static size_t Hash(uintptr_t key)
+    {
+        // Fibonacci hashing, user IDs are often small sequential integers
+        // or pointers with low bits zeroed
+        auto h = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    void InsertSlot(uintptr_t key, T* object)
+    {
+        for (auto index = Hash(key) & m_Mask; ; index = (index + 1) & m_Mask)
+        {
+            auto& slot = m_Slots[index];
+            if (slot.m_Object == nullptr)
+            {
+                slot.m_Key    = key;
+                slot.m_Object = object;
+                return;
+            }
+            IM_ASSERT(slot.m_Key != key && "Object with this ID is already registered.");
+        }
+    }
+
+    void Rehash(size_t capacity)
+    {
+        vector<Slot> slots(capacity);
+        m_Slots.swap(slots);
+        m_Mask = capacity - 1;
+
+        for (auto& slot : slots)
+            if (slot.m_Object != nullptr)
+                InsertSlot(slot.m_Key, slot.m_Object);
+    }
+
+    vector<Slot> m_Slots;
+    size_t       m_Mask  = 0;
+    size_t       m_Count = 0;
+};
+
+// Chunked storage for editor objects. Objects never move once created, so
+// pointers handed out stay valid until pool is cleared. Chunks are allocated
+// in bulk, which avoids one heap allocation per node, pin or link.
+template <typename T, size_t ChunkSize = 256>
+struct ObjectPool
+{
+    ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    ~ObjectPool() { Clear(); }
+
+    template <typename... Args>
+    T* Create(Args&&... args)
+    {
+        if (m_Chunks.empty() || m_LastChunkSize == ChunkSize)
+        {
+            m_Chunks.push_back(static_cast<T*>(::operator new(sizeof(T) * ChunkSize)));
+            m_LastChunkSize = 0;
+        }
+
+        auto object = new (m_Chunks.back() + m_LastChunkSize) T(std::forward<Args>(args)...);
+        ++m_LastChunkSize;
+        return object;
+    }
+
+    void Clear()
+    {
+        for (size_t i = 0; i < m_Chunks.size(); ++i)
+        {
+            auto chunk = m_Chunks[i];
+            auto count = (i + 1 == m_Chunks.size()) ? m_LastChunkSize : ChunkSize;
+            for (size_t j = 0; j < count; ++j)
+                chunk[j].~T();
+            ::operator delete(chunk);
+        }
+
+        m_Chunks.clear();
+        m_LastChunkSize = 0;
+    }
+
+private:
+    vector<T*> m_Chunks;
+    size_t     m_LastChunkSize = 0;
+};
+
 struct Object
 {
     enum DrawFlags
@@ -531,6 +677,95 @@ struct Node final: Object
     virtual Node* AsNode() override final { return this; }
 };
 
+// Geometry derived from link endpoints and pin style. Everything is built
+// lazily and kept until inputs of the curve change, so links between nodes
+// which do not move are not tessellated again.
+struct LinkGeometry
+{
+    // Inputs of Link::GetCurve()
+    struct CurveKey
+    {
+        ImVec2 m_Start;
+        ImVec2 m_End;
+        ImVec2 m_StartDir;
+        ImVec2 m_EndDir;
+        float  m_StartStrength;
+        float  m_EndStrength;
+
+        friend bool operator==(const CurveKey& lhs, const CurveKey& rhs)
+        {
+            return lhs.m_Start         == rhs.m_Start
+                && lhs.m_End           == rhs.m_End
+                && lhs.m_StartDir      == rhs.m_StartDir
+                && lhs.m_EndDir        == rhs.m_EndDir
+                && lhs.m_StartStrength == rhs.m_StartStrength
+                && lhs.m_EndStrength   == rhs.m_EndStrength;
+        }
+    };
+
+    // Everything besides the curve and color which ends up in vertices of a filled link
+    struct MeshKey
+    {
+        float           m_Thickness       = 0.0f;
+        float           m_StartArrowSize  = 0.0f;
+        float           m_StartArrowWidth = 0.0f;
+        float           m_EndArrowSize    = 0.0f;
+        float           m_EndArrowWidth   = 0.0f;
+        int             m_Segments        = 0;
+        float           m_FringeScale     = 0.0f;
+        float           m_TessellationTol = 0.0f;
+        ImVec2          m_TexUvWhitePixel;
+        ImDrawListFlags m_Flags           = 0;
+
+        friend bool operator==(const MeshKey& lhs, const MeshKey& rhs)
+        {
+            return lhs.m_Thickness       == rhs.m_Thickness
+                && lhs.m_StartArrowSize  == rhs.m_StartArrowSize
+                && lhs.m_StartArrowWidth == rhs.m_StartArrowWidth
+                && lhs.m_EndArrowSize    == rhs.m_EndArrowSize
+                && lhs.m_EndArrowWidth   == rhs.m_EndArrowWidth
+                && lhs.m_Segments        == rhs.m_Segments
+                && lhs.m_FringeScale     == rhs.m_FringeScale
+                && lhs.m_TessellationTol == rhs.m_TessellationTol
+                && lhs.m_TexUvWhitePixel == rhs.m_TexUvWhitePixel
+                && lhs.m_Flags           == rhs.m_Flags;
+        }
+    };
+
+    struct LengthSample
+    {
+        float  m_Distance;
+        ImVec2 m_Point;
+    };
+
+    CurveKey             m_CurveKey;
+    ImCubicBezierPoints  m_Curve;
+    bool                 m_HasCurve        = false;
+
+    ImRect               m_Bounds;
+    float                m_BoundsStartArrow = 0.0f;
+    float                m_BoundsEndArrow   = 0.0f;
+    bool                 m_HasBounds       = false;
+
+    float                m_Length          = -1.0f; // Negative when not measured yet
+    float                m_LengthStep      = 0.0f;
+    vector<LengthSample> m_LengthTable;             // Points along the curve with distance from start
+
+    MeshKey              m_MeshKey;
+    bool                 m_HasMesh         = false;
+    ImVector<ImDrawVert> m_MeshVertices;            // Opaque vertices have alpha set, fringe vertices are transparent
+    ImVector<ImDrawIdx>  m_MeshIndices;             // Relative to first vertex
+
+    // Drops everything built on top of the curve
+    void InvalidateCurve()
+    {
+        m_HasBounds = false;
+        m_Length    = -1.0f;
+        m_HasMesh   = false;
+        m_LengthTable.resize(0);
+    }
+};
+
 struct Link final: Object
 {
     using IdType = LinkId;
@@ -543,6 +778,8 @@ struct Link final: Object
     ImVec2 m_Start;
     ImVec2 m_End;
 
+    mutable LinkGeometry m_Geometry;
+
     Link(EditorContext* editor, LinkId id)
         : Object(editor)
         , m_ID(id)
@@ -560,9 +797,14 @@ struct Link final: Object
     virtual void Draw(ImDrawList* drawList, DrawFlags flags = None) override final;
     void Draw(ImDrawList* drawList, ImU32 color, float extraThickness = 0.0f) const;
 
+    enum class LevelOfDetail { Full, Simplified, Straight };
+    LevelOfDetail GetLevelOfDetail() const;
+
     void UpdateEndpoints();
 
     ImCubicBezierPoints GetCurve() const;
+    float GetLength() const;
+    const vector<LinkGeometry::LengthSample>& GetLengthTable(float step) const;
 
     virtual bool TestHit(const ImVec2& point, float extraThickness = 0.0f) const override final;
     virtual bool TestHit(const ImRect& rect, bool allowIntersect = true) const override final;
@@ -652,12 +894,14 @@ struct NodeSettings
 
     bool            m_Saved;
     bool            m_IsDirty;
+    bool            m_IsQueued;     // Node is already on Settings::m_DirtyNodes
     SaveReasonFlags m_DirtyReason;
 
     NodeSettings()
         : m_WasUsed(false)
         , m_Saved(false)
         , m_IsDirty(false)
+        , m_IsQueued(false)
         , m_DirtyReason(SaveReasonFlags::None)
     {
     }
@@ -670,12 +914,19 @@ struct Settings
 {
     bool                 m_IsDirty;
     SaveReasonFlags      m_DirtyReason;
+    unsigned             m_ChangeCount;        // Incremented by every MakeDirty()
+    bool                 m_IsSavePending;      // Settings log is written in background, dirty state is kept until it is done
+    unsigned             m_PendingChangeCount; // m_ChangeCount when pending save was committed
 
     map<NodeId, NodeSettings> m_Nodes;
+    vector<NodeId>            m_DirtyNodes; // Nodes made dirty since last save, without duplicates
 
     Settings()
         : m_IsDirty(false)
         , m_DirtyReason(SaveReasonFlags::None)
+        , m_ChangeCount(0)
+        , m_IsSavePending(false)
+        , m_PendingChangeCount(0)
     {
     }
 
@@ -686,6 +937,62 @@ struct Settings
     void MakeDirty(SaveReasonFlags reason, Node* node = nullptr);
 };
 
+// Binary settings file: a header followed by a log of records. Saving appends
+// records of changed nodes only, later records override earlier ones on load.
+// Once the log grows past the snapshot it follows, whole file is rewritten.
+struct SettingsLog
+{
+    SettingsLog();
+    ~SettingsLog();
+
+    static bool Read(const char* path, EditorState& state);
+
+    bool NeedsRewrite() const;
+
+    void AppendNode(NodeId id, const NodeState& state);
+    void AppendSelection(const SelectionState& state);
+    void AppendView(const ViewState& state);
+
+    // Writes pending records to 'path', replacing file content if 'rewrite' is set.
+    // With 'background' set data is handed over to writer thread and call returns
+    // immediately, result is reported later by Poll().
+    bool Commit(const char* path, bool rewrite, bool background);
+
+    // Returns false while writer thread has jobs. Otherwise 'written' tells whether
+    // every background write since last Poll() succeeded.
+    bool Poll(bool& written);
+
+    // Waits for writer thread to finish pending jobs.
+    void Flush();
+
+private:
+    struct Job
+    {
+        string m_Path;
+        string m_Data;
+        bool   m_Rewrite;
+    };
+
+    static bool Write(const Job& job);
+
+    void WorkerMain();
+
+    string                  m_Pending;
+    size_t                  m_SnapshotSize;
+    size_t                  m_LogSize;
+    bool                    m_HasSnapshot;
+    std::atomic<bool>       m_Failed;       // Set by writer thread, forces rewrite on next commit
+    bool                    m_WriteFailed;  // Set by writer thread, cleared by Poll()
+
+    std::thread             m_Worker;
+    std::mutex              m_Mutex;
+    std::condition_variable m_WakeUp;
+    std::condition_variable m_Idle;
+    std::deque<Job>         m_Jobs;
+    bool                    m_IsWriting;
+    bool                    m_Quit;
+};
+
 struct Control
 {
     Object* HotObject;
@@ -846,23 +1153,9 @@ struct FlowAnimation final: Animation
     void Draw(ImDrawList* drawList);
 
 private:
-    struct CurvePoint
-    {
-        float  Distance;
-        ImVec2 Point;
-    };
-
-    ImVec2 m_LastStart;
-    ImVec2 m_LastEnd;
-    float  m_PathLength;
-    vector<CurvePoint> m_Path;
-
     bool IsLinkValid() const;
-    bool IsPathValid() const;
-    void UpdatePath();
-    void ClearPath();
 
-    ImVec2 SamplePath(float distance) const;
+    ImVec2 SamplePath(const vector<LinkGeometry::LengthSample>& path, float distance) const;
 
     void OnUpdate(float progress) override final;
     void OnStop() override final;
@@ -1331,6 +1624,7 @@ struct NodeBuilder
 
     ImRect m_GroupBounds;
     bool   m_IsGroup;
+    bool   m_IsContentClipped; // Node is out of view or collapsed, content is laid out but not rendered
 
     ImDrawListSplitter m_Splitter;
     ImDrawListSplitter m_PinSplitter;
@@ -1420,6 +1714,9 @@ struct Config: ax::NodeEditor::Config
     bool Save(const json::value& data, SaveReasonFlags flags);
     bool SaveNode(NodeId nodeId, const json::value& data, SaveReasonFlags flags);
     void EndSave();
+
+    bool HasSaveTarget() const;
+    bool HasSaveNodeTarget() const;
 };
 
 enum class SuspendFlags : uint8_t
@@ -1525,6 +1822,9 @@ struct IMGUI_API EditorContext
     int CountLivePins() const;
     int CountLiveLinks() const;
 
+    const RenderStats& GetRenderStats() const { return m_RenderStats; }
+    RenderStats& GetRenderStats() { return m_RenderStats; }
+
     Pin*    CreatePin(PinId id, PinKind kind);
     Node*   CreateNode(NodeId id);
     Link*   CreateLink(LinkId id);
@@ -1686,9 +1986,17 @@ private:
 
     Style               m_Style;
 
-    vector<ObjectWrapper<Node>> m_Nodes;
-    vector<ObjectWrapper<Pin>>  m_Pins;
-    vector<ObjectWrapper<Link>> m_Links;
+    vector<ObjectWrapper<Node>> m_Nodes; // in drawing order
+    vector<ObjectWrapper<Pin>>  m_Pins;  // in creation order
+    vector<ObjectWrapper<Link>> m_Links; // in creation order
+
+    ObjectMap<Node>     m_NodeMap;
+    ObjectMap<Pin>      m_PinMap;
+    ObjectMap<Link>     m_LinkMap;
+
+    ObjectPool<Node>    m_NodePool;
+    ObjectPool<Pin>     m_PinPool;
+    ObjectPool<Link>    m_LinkPool;
 
     vector<Object*>     m_SelectedObjects;
 
@@ -1730,6 +2038,7 @@ private:
 
     bool                m_IsInitialized;
     Settings            m_Settings;
+    SettingsLog         m_SettingsLog;
     EditorState         m_State;
 
     Transaction*        m_Transaction = nullptr;
@@ -1739,6 +2048,8 @@ private:
     ImDrawList*         m_DrawList;
     int                 m_ExternalChannel;
     ImDrawListSplitter  m_Splitter;
+
+    RenderStats         m_RenderStats;
 };
 
 
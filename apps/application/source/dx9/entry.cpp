@@ -219,7 +219,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     ImGui_ImplDX9_Init(g_pd3dDevice);
 
 #if IMGUI_VULKAN_SHADER
-    ImGui::ImVulkanShaderInit();
+    ImGui::ImVulkanShaderInit(ImGuiHelper::getCacheDir() + "/ImVulkanShader");
 #endif
 
     ImVec4 clear_color = ImVec4(0.f, 0.f, 0.f, 1.00f);
@@ -261,7 +261,10 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             ImGui::SetMaxWaitBeforeNextFrame(1.0 / property.fps);
 
         if (property.application.Application_Frame)
+        {
+            IM_PROFILE_ZONE("Application_Frame");
             app_done = property.application.Application_Frame(property.handle, done);
+        }
         else
             app_done = done;
         
@@ -0,0 +1,548 @@
+// Headless application entry, without window system or GPU, for benchmark and CI.
+//
+// Frames run back to back on a simulated clock (io.DeltaTime = 1 / fps), input comes from a script file
+// and ImDrawData goes to a null sink, which only walks the draw lists, or to a software rasterizer.
+// Each frame NewFrame, the application frame, Render and rasterize are timed, with vertex and index counts.
+//
+// Options, removed from argv before the application sees it:
+//   --headless-frames=N      frames to run before the application is asked to quit (default 600)
+//   --headless-fps=F         simulated frame rate (default property.fps)
+//   --headless-script=FILE   input events, see below
+//   --headless-stats=FILE    per frame timing and counts as CSV
+//   --headless-raster=FILE   rasterize every frame in software and save the last one as PPM
+//   --headless-profile=FILE  enable ImProfile and export a Chrome trace at exit
+//
+// Script lines are "frame command arguments", events are queued before the frame starts, '#' starts a comment:
+//   0   mouse 100 200        mouse position
+//   1   down 0               mouse button down, 0 left, 1 right, 2 middle
+//   2   up 0                 mouse button up
+//   10  wheel 0 -1           horizontal and vertical wheel
+//   20  key Enter 1          key down (1) or up (0), names as ImGui::GetKeyName(), or Ctrl, Shift, Alt, Super
+//   21  text hello world     characters
+//   30  resize 1280 720      display size
+//   40  drop /path/a /path/b files dropped from system
+//   100 quit                 ask the application to quit
+//
+// Textures created by the application with ImCreateTexture() go to the rendering backend imgui is built with,
+// which has no device here, apps creating textures need imgui built without one. Then the textures are null
+// and the rasterizer draws them as plain color.
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "imgui_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "application.h"
+
+static ApplicationWindowProperty property;
+
+struct HeadlessEvent
+{
+    int frame {0};
+    std::string command;
+    std::vector<std::string> args;
+};
+
+struct HeadlessFrameStats
+{
+    double new_frame_ms {0};
+    double app_ms {0};
+    double render_ms {0};
+    double raster_ms {0};
+    int draw_lists {0};
+    int draw_cmds {0};
+    int vertices {0};
+    int indices {0};
+};
+
+struct HeadlessTexture
+{
+    const unsigned char* pixels {nullptr};
+    int width {0};
+    int height {0};
+};
+
+static HeadlessTexture font_texture;
+static std::vector<unsigned int> framebuffer;
+static int framebuffer_width = 0;
+static int framebuffer_height = 0;
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void Application_FullScreen(bool on)
+{
+    (void)on;
+}
+
+static bool LoadScript(const std::string& path, std::vector<HeadlessEvent>& events)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        fprintf(stderr, "Headless: Open script %s Error!!!\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        auto comment = line.find('#');
+        if (comment != std::string::npos)
+            line.resize(comment);
+        std::istringstream stream(line);
+        HeadlessEvent event;
+        if (!(stream >> event.frame >> event.command))
+            continue;
+        if (event.command == "text")
+        {
+            // keep the spaces of the text
+            std::string text;
+            std::getline(stream, text);
+            auto start = text.find_first_not_of(' ');
+            event.args.push_back(start == std::string::npos ? "" : text.substr(start));
+        }
+        else
+        {
+            std::string arg;
+            while (stream >> arg)
+                event.args.push_back(arg);
+        }
+        events.push_back(event);
+    }
+    std::stable_sort(events.begin(), events.end(), [](const HeadlessEvent& a, const HeadlessEvent& b) { return a.frame < b.frame; });
+    return true;
+}
+
+static ImGuiKey FindKey(const std::string& name)
+{
+    if (name == "Ctrl") return ImGuiMod_Ctrl;
+    if (name == "Shift") return ImGuiMod_Shift;
+    if (name == "Alt") return ImGuiMod_Alt;
+    if (name == "Super") return ImGuiMod_Super;
+    for (int key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; key++)
+    {
+        if (name == ImGui::GetKeyName((ImGuiKey)key))
+            return (ImGuiKey)key;
+    }
+    return ImGuiKey_None;
+}
+
+// queue the events of the frame, returns true on quit
+static bool ApplyEvents(const std::vector<HeadlessEvent>& events, size_t& next_event, int frame)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    bool quit = false;
+    for (; next_event < events.size() && events[next_event].frame <= frame; next_event++)
+    {
+        const HeadlessEvent& event = events[next_event];
+        const auto& args = event.args;
+        auto arg_float = [&](size_t i) { return i < args.size() ? (float)atof(args[i].c_str()) : 0.f; };
+        if (event.command == "mouse")
+            io.AddMousePosEvent(arg_float(0), arg_float(1));
+        else if (event.command == "down" || event.command == "up")
+            io.AddMouseButtonEvent((int)arg_float(0), event.command == "down");
+        else if (event.command == "wheel")
+            io.AddMouseWheelEvent(arg_float(0), arg_float(1));
+        else if (event.command == "key" && !args.empty())
+        {
+            ImGuiKey key = FindKey(args[0]);
+            if (key != ImGuiKey_None)
+                io.AddKeyEvent(key, args.size() < 2 || args[1] != "0");
+            else
+                fprintf(stderr, "Headless: Unknown key %s at frame %d\n", args[0].c_str(), event.frame);
+        }
+        else if (event.command == "text" && !args.empty())
+            io.AddInputCharactersUTF8(args[0].c_str());
+        else if (event.command == "resize")
+        {
+            property.width = (int)arg_float(0);
+            property.height = (int)arg_float(1);
+        }
+        else if (event.command == "drop")
+        {
+            std::vector<std::string> file_paths = args;
+            if (!file_paths.empty() && property.application.Application_DropFromSystem)
+                property.application.Application_DropFromSystem(file_paths);
+        }
+        else if (event.command == "quit")
+            quit = true;
+        else
+            fprintf(stderr, "Headless: Unknown command %s at frame %d\n", event.command.c_str(), event.frame);
+    }
+    return quit;
+}
+
+static inline unsigned int SampleTexture(ImTextureID texture_id, const ImVec2& uv)
+{
+    if (texture_id != (ImTextureID)&font_texture || !font_texture.pixels)
+        return 0xFFFFFFFF;
+    int x = ImClamp((int)(uv.x * font_texture.width), 0, font_texture.width - 1);
+    int y = ImClamp((int)(uv.y * font_texture.height), 0, font_texture.height - 1);
+    return ((const unsigned int*)font_texture.pixels)[y * font_texture.width + x];
+}
+
+static inline float EdgeFunction(const ImVec2& a, const ImVec2& b, float x, float y)
+{
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+// colors and texels are ImU32 RGBA, blended as src_alpha, one_minus_src_alpha like the GPU backends
+static void RasterTriangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2, ImTextureID texture_id, int clip_x0, int clip_y0, int clip_x1, int clip_y1)
+{
+    float area = EdgeFunction(v0.pos, v1.pos, v2.pos.x, v2.pos.y);
+    if (area == 0.f)
+        return;
+    int x0 = ImMax(clip_x0, (int)floorf(ImMin(v0.pos.x, ImMin(v1.pos.x, v2.pos.x))));
+    int y0 = ImMax(clip_y0, (int)floorf(ImMin(v0.pos.y, ImMin(v1.pos.y, v2.pos.y))));
+    int x1 = ImMin(clip_x1, (int)ceilf(ImMax(v0.pos.x, ImMax(v1.pos.x, v2.pos.x))));
+    int y1 = ImMin(clip_y1, (int)ceilf(ImMax(v0.pos.y, ImMax(v1.pos.y, v2.pos.y))));
+    if (x1 <= x0 || y1 <= y0)
+        return;
+    const float inv_area = 1.f / area;
+    const ImDrawVert* v[3] = { &v0, &v1, &v2 };
+    float c[3][4];
+    for (int i = 0; i < 3; i++)
+        for (int k = 0; k < 4; k++)
+            c[i][k] = (float)((v[i]->col >> (k * 8)) & 0xFF);
+    // solid color without texture, like most of the window backgrounds
+    const bool flat_color = v0.col == v1.col && v0.col == v2.col && (texture_id != (ImTextureID)&font_texture || (v0.uv.x == v1.uv.x && v0.uv.x == v2.uv.x && v0.uv.y == v1.uv.y && v0.uv.y == v2.uv.y));
+    const unsigned int flat_texel = SampleTexture(texture_id, v0.uv);
+    // barycentric weights step linearly along x
+    const float w0_dx = -(v2.pos.y - v1.pos.y) * inv_area;
+    const float w1_dx = -(v0.pos.y - v2.pos.y) * inv_area;
+    for (int y = y0; y < y1; y++)
+    {
+        const float py = y + 0.5f;
+        float w0 = EdgeFunction(v1.pos, v2.pos, x0 + 0.5f, py) * inv_area;
+        float w1 = EdgeFunction(v2.pos, v0.pos, x0 + 0.5f, py) * inv_area;
+        unsigned int* row = framebuffer.data() + (size_t)y * framebuffer_width;
+        for (int x = x0; x < x1; x++, w0 += w0_dx, w1 += w1_dx)
+        {
+            float w2 = 1.f - w0 - w1;
+            if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+                continue;
+            unsigned int src_col, texel;
+            if (flat_color)
+            {
+                src_col = v0.col;
+                texel = flat_texel;
+            }
+            else
+            {
+                src_col = 0;
+                for (int k = 0; k < 4; k++)
+                    src_col |= (unsigned int)(c[0][k] * w0 + c[1][k] * w1 + c[2][k] * w2 + 0.5f) << (k * 8);
+                texel = SampleTexture(texture_id, ImVec2(v0.uv.x * w0 + v1.uv.x * w1 + v2.uv.x * w2, v0.uv.y * w0 + v1.uv.y * w1 + v2.uv.y * w2));
+            }
+            // modulate by texel then blend, channels in 0..255
+            unsigned int alpha = ((src_col >> IM_COL32_A_SHIFT) & 0xFF) * ((texel >> IM_COL32_A_SHIFT) & 0xFF) / 255;
+            if (alpha == 0)
+                continue;
+            unsigned int dst = row[x], out = IM_COL32_A_MASK;
+            for (int shift = 0; shift < 24; shift += 8)
+            {
+                unsigned int s = ((src_col >> shift) & 0xFF) * ((texel >> shift) & 0xFF) / 255;
+                unsigned int d = (dst >> shift) & 0xFF;
+                out |= ((s * alpha + d * (255 - alpha)) / 255) << shift;
+            }
+            row[x] = out;
+        }
+    }
+}
+
+// walks the draw data like a renderer backend, rasterizes when the framebuffer is enabled
+static void RenderDrawData(ImDrawData* draw_data, bool raster, HeadlessFrameStats& stats)
+{
+    if (raster)
+    {
+        framebuffer_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+        framebuffer_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+        framebuffer.assign((size_t)ImMax(framebuffer_width * framebuffer_height, 0), IM_COL32(0, 0, 0, 255));
+    }
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    const ImVec2 clip_scale = draw_data->FramebufferScale;
+    stats.draw_lists = draw_data->CmdListsCount;
+    stats.vertices = draw_data->TotalVtxCount;
+    stats.indices = draw_data->TotalIdxCount;
+    for (int n = 0; n < draw_data->CmdListsCount; n++)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        stats.draw_cmds += cmd_list->CmdBuffer.Size;
+        if (!raster)
+            continue;
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+        {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->UserCallback != NULL)
+            {
+                // user callbacks talk to a GPU, skip them
+                continue;
+            }
+            int clip_x0 = ImMax(0, (int)((pcmd->ClipRect.x - clip_off.x) * clip_scale.x));
+            int clip_y0 = ImMax(0, (int)((pcmd->ClipRect.y - clip_off.y) * clip_scale.y));
+            int clip_x1 = ImMin(framebuffer_width, (int)((pcmd->ClipRect.z - clip_off.x) * clip_scale.x));
+            int clip_y1 = ImMin(framebuffer_height, (int)((pcmd->ClipRect.w - clip_off.y) * clip_scale.y));
+            if (clip_x1 <= clip_x0 || clip_y1 <= clip_y0)
+                continue;
+            const ImDrawIdx* idx = cmd_list->IdxBuffer.Data + pcmd->IdxOffset;
+            const ImDrawVert* vtx = cmd_list->VtxBuffer.Data + pcmd->VtxOffset;
+            for (unsigned int i = 0; i + 2 < pcmd->ElemCount; i += 3)
+            {
+                ImDrawVert v[3] = { vtx[idx[i]], vtx[idx[i + 1]], vtx[idx[i + 2]] };
+                for (auto& vert : v)
+                    vert.pos = ImVec2((vert.pos.x - clip_off.x) * clip_scale.x, (vert.pos.y - clip_off.y) * clip_scale.y);
+                RasterTriangle(v[0], v[1], v[2], pcmd->GetTexID(), clip_x0, clip_y0, clip_x1, clip_y1);
+            }
+        }
+    }
+}
+
+static bool SaveFramebuffer(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    fprintf(file, "P6\n%d %d\n255\n", framebuffer_width, framebuffer_height);
+    std::vector<unsigned char> row(framebuffer_width * 3);
+    for (int y = 0; y < framebuffer_height; y++)
+    {
+        for (int x = 0; x < framebuffer_width; x++)
+        {
+            unsigned int pixel = framebuffer[y * framebuffer_width + x];
+            row[x * 3 + 0] = (pixel >> IM_COL32_R_SHIFT) & 0xFF;
+            row[x * 3 + 1] = (pixel >> IM_COL32_G_SHIFT) & 0xFF;
+            row[x * 3 + 2] = (pixel >> IM_COL32_B_SHIFT) & 0xFF;
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+    fclose(file);
+    return true;
+}
+
+static double Percentile(std::vector<double> values, double percent)
+{
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    return values[ImMin((size_t)(values.size() * percent / 100.0), values.size() - 1)];
+}
+
+static void PrintSummary(const std::vector<HeadlessFrameStats>& frames, bool raster)
+{
+    if (frames.empty())
+        return;
+    struct Column { const char* name; double HeadlessFrameStats::* value; };
+    const Column columns[] = {
+        { "NewFrame", &HeadlessFrameStats::new_frame_ms },
+        { "Frame", &HeadlessFrameStats::app_ms },
+        { "Render", &HeadlessFrameStats::render_ms },
+        { "Raster", &HeadlessFrameStats::raster_ms },
+    };
+    fprintf(stdout, "Headless: %zu frames\n", frames.size());
+    fprintf(stdout, "  %-10s %10s %10s %10s %10s\n", "ms", "mean", "p50", "p95", "max");
+    for (auto& column : columns)
+    {
+        if (column.value == &HeadlessFrameStats::raster_ms && !raster)
+            continue;
+        std::vector<double> values;
+        double sum = 0;
+        for (auto& frame : frames)
+        {
+            values.push_back(frame.*column.value);
+            sum += frame.*column.value;
+        }
+        fprintf(stdout, "  %-10s %10.3f %10.3f %10.3f %10.3f\n", column.name, sum / frames.size(), Percentile(values, 50), Percentile(values, 95), Percentile(values, 100));
+    }
+    double vertices = 0, indices = 0, cmds = 0;
+    for (auto& frame : frames)
+    {
+        vertices += frame.vertices;
+        indices += frame.indices;
+        cmds += frame.draw_cmds;
+    }
+    fprintf(stdout, "  mean vertices %.0f, indices %.0f, draw commands %.0f\n", vertices / frames.size(), indices / frames.size(), cmds / frames.size());
+}
+
+int main(int argc, char** argv)
+{
+    int max_frames = 600;
+    float fps = 0;
+    std::string script_path, stats_path, raster_path, profile_path;
+    std::vector<char*> app_argv;
+    for (int i = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        auto value = arg.substr(arg.find('=') + 1);
+        if (arg.rfind("--headless-frames=", 0) == 0) max_frames = atoi(value.c_str());
+        else if (arg.rfind("--headless-fps=", 0) == 0) fps = (float)atof(value.c_str());
+        else if (arg.rfind("--headless-script=", 0) == 0) script_path = value;
+        else if (arg.rfind("--headless-stats=", 0) == 0) stats_path = value;
+        else if (arg.rfind("--headless-raster=", 0) == 0) raster_path = value;
+        else if (arg.rfind("--headless-profile=", 0) == 0) profile_path = value;
+        else app_argv.push_back(argv[i]);
+    }
+    app_argv.push_back(nullptr);
+
+    std::vector<HeadlessEvent> events;
+    if (!script_path.empty() && !LoadScript(script_path, events))
+        return 1;
+
+    property.argc = (int)app_argv.size() - 1;
+    property.argv = app_argv.data();
+    Application_Setup(property);
+    if (fps <= 0) fps = property.fps > 0 ? property.fps : 30.f;
+    const bool raster = !raster_path.empty();
+
+    // Setup Dear ImGui context
+    IMGUI_CHECKVERSION();
+    auto ctx = ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO(); (void)io;
+    io.ApplicationName = property.name.c_str();
+    io.BackendPlatformName = "imgui_impl_null";
+    io.BackendRendererName = "imgui_impl_null";
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    io.Fonts->AddFontDefault(property.font_scale);
+    io.FontGlobalScale = 1.0f / property.font_scale;
+    // no settings file, runs must not depend on each other
+    io.IniFilename = NULL;
+    if (property.navigator)
+    {
+        io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+        io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+    }
+    if (property.docking) io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;           // Enable Docking
+
+    // Setup Dear ImGui style
+    ImGui::StyleColorsDark();
+
+    // font atlas stays in memory for the rasterizer
+    unsigned char* pixels = nullptr;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &font_texture.width, &font_texture.height);
+    font_texture.pixels = pixels;
+    io.Fonts->SetTexID((ImTextureID)&font_texture);
+
+    if (!profile_path.empty())
+    {
+        ImGui::ImProfileSetThreadName("Main");
+        ImGui::ImProfileEnable(true);
+    }
+
+    // first call application initialize
+    if (property.application.Application_Initialize)
+        property.application.Application_Initialize(&property.handle);
+
+    std::vector<HeadlessFrameStats> frame_stats;
+    size_t next_event = 0;
+    int frame = 0;
+
+    // splash screen runs in the display size of the splash window
+    if (property.application.Application_SplashScreen &&
+        property.splash_screen_width > 0 &&
+        property.splash_screen_height > 0)
+    {
+        if (property.application.Application_SetupContext)
+            property.application.Application_SetupContext(ctx, true);
+        bool splash_done = false;
+        for (int splash_frame = 0; !splash_done && splash_frame < max_frames; splash_frame++)
+        {
+            io.DisplaySize = ImVec2((float)property.splash_screen_width, (float)property.splash_screen_height);
+            io.DeltaTime = 1.0f / fps;
+            ImGui::NewFrame();
+            auto _splash_done = property.application.Application_SplashScreen(property.handle, false);
+            // work around with context assert frame_count
+            if (splash_frame > 0) splash_done = _splash_done;
+            ImGui::EndFrame();
+            ImGui::Render();
+        }
+        if (property.application.Application_SplashFinalize)
+            property.application.Application_SplashFinalize(&property.handle);
+    }
+    if (property.application.Application_SetupContext)
+        property.application.Application_SetupContext(ctx, false);
+
+    // Main loop, after max_frames the application is asked to quit and may take some more frames to do so
+    bool done = false;
+    bool app_done = false;
+    const int max_quit_frames = 100;
+    for (; !app_done && frame < max_frames + max_quit_frames; frame++)
+    {
+        HeadlessFrameStats stats;
+        ImGui::ImUpdateTextures();
+        if (ApplyEvents(events, next_event, frame) || frame >= max_frames)
+            done = true;
+        io.DisplaySize = ImVec2((float)property.width, (float)property.height);
+        io.DeltaTime = 1.0f / fps;
+
+        auto start = Clock::now();
+        ImGui::NewFrame();
+        stats.new_frame_ms = ElapsedMs(start);
+
+        start = Clock::now();
+        if (property.application.Application_Frame)
+        {
+            IM_PROFILE_ZONE("Application_Frame");
+            app_done = property.application.Application_Frame(property.handle, done);
+        }
+        else
+            app_done = done;
+        stats.app_ms = ElapsedMs(start);
+
+        start = Clock::now();
+        ImGui::EndFrame();
+        ImGui::Render();
+        stats.render_ms = ElapsedMs(start);
+
+        start = Clock::now();
+        {
+            IM_PROFILE_ZONE("RenderDrawData");
+            RenderDrawData(ImGui::GetDrawData(), raster, stats);
+        }
+        stats.raster_ms = ElapsedMs(start);
+        frame_stats.push_back(stats);
+    }
+    if (!app_done)
+        fprintf(stderr, "Headless: Application didn't quit after %d frames\n", frame);
+
+    if (property.application.Application_Finalize)
+        property.application.Application_Finalize(&property.handle);
+
+    PrintSummary(frame_stats, raster);
+    if (!stats_path.empty())
+    {
+        FILE* file = fopen(stats_path.c_str(), "w");
+        if (file)
+        {
+            fprintf(file, "frame,new_frame_ms,frame_ms,render_ms,raster_ms,draw_lists,draw_cmds,vertices,indices\n");
+            for (size_t i = 0; i < frame_stats.size(); i++)
+            {
+                auto& stats = frame_stats[i];
+                fprintf(file, "%zu,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d\n", i, stats.new_frame_ms, stats.app_ms, stats.render_ms, stats.raster_ms, stats.draw_lists, stats.draw_cmds, stats.vertices, stats.indices);
+            }
+            fclose(file);
+        }
+        else
+            fprintf(stderr, "Headless: Open stats %s Error!!!\n", stats_path.c_str());
+    }
+    if (raster && !SaveFramebuffer(raster_path))
+        fprintf(stderr, "Headless: Save %s Error!!!\n", raster_path.c_str());
+
+    if (!profile_path.empty() && !ImGui::ImProfileExportChromeTrace(profile_path.c_str()))
+        fprintf(stderr, "Headless: Save %s Error!!!\n", profile_path.c_str());
+
+    // Cleanup
+    ImGui::ImDestroyTextures();
+    ImGui::DestroyContext();
+
+    return app_done ? 0 : 1;
+}
@@ -35,7 +35,10 @@ void glut_display_func()
         ImGui::SetMaxWaitBeforeNextFrame(1.0 / property.fps);
     
     if (property.application.Application_Frame)
+    {
+        IM_PROFILE_ZONE("Application_Frame");
         app_done = property.application.Application_Frame(property.handle, done);
+    }
     else
         app_done = done;
     
@@ -131,7 +134,7 @@ int main(int argc, char** argv)
     ImGui_ImplOpenGL2_Init();
 
 #if IMGUI_VULKAN_SHADER
-    ImGui::ImVulkanShaderInit();
+    ImGui::ImVulkanShaderInit(ImGuiHelper::getCacheDir() + "/ImVulkanShader");
 #endif
 
     // init application
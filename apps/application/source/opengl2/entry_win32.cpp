@@ -226,7 +226,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     ImGui_ImplOpenGL2_Init();
 
 #if IMGUI_VULKAN_SHADER
-    ImGui::ImVulkanShaderInit();
+    ImGui::ImVulkanShaderInit(ImGuiHelper::getCacheDir() + "/ImVulkanShader");
 #endif
 
     // Show the window
@@ -277,7 +277,10 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             ImGui::SetMaxWaitBeforeNextFrame(1.0 / property.fps);
         
         if (property.application.Application_Frame)
+        {
+            IM_PROFILE_ZONE("Application_Frame");
             app_done = property.application.Application_Frame(property.handle, done);
+        }
         else
             app_done = done;
         
@@ -364,7 +364,7 @@ int main(int argc, char** argv)
     ImGui_ImplOpenGL3_Init(glsl_version);
 
 #if IMGUI_VULKAN_SHADER
-    ImGui::ImVulkanShaderInit();
+    ImGui::ImVulkanShaderInit(ImGuiHelper::getCacheDir() + "/ImVulkanShader");
 #endif
 
     ImVec4 clear_color = ImVec4(0.f, 0.f, 0.f, 1.f);
@@ -393,7 +393,10 @@ int main(int argc, char** argv)
             ImGui::SetMaxWaitBeforeNextFrame(1.0 / property.fps);
         
         if (property.application.Application_Frame)
+        {
+            IM_PROFILE_ZONE("Application_Frame");
             app_done = property.application.Application_Frame(property.handle, done);
+        }
         else
             app_done = done;
 
@@ -7,14 +7,20 @@
 #include <errno.h>
 #include <mutex>
 #include <thread>
+#include <atomic>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
+#include <implot.h>
 
 #if __ARM_NEON
 #include <arm_neon.h>
 #elif __SSE__ || __AVX__
 #include <neon2sse.h>
 #endif // __ARM_NEON
+#if __AVX2__ || __SSSE3__
+#include <immintrin.h>
+#endif
 
 #ifdef _WIN32
 #include <windows.h>
@@ -39,6 +45,8 @@ struct IUnknown;
 #include <stdlib.h> // system
 #include <pwd.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <sys/resource.h>
 #define PATH_SEP '/'
 #endif //_WIN32
@@ -307,6 +315,7 @@ void ImGenerateOrUpdateTexture(ImTextureID& imtexid,int width,int height,int cha
 {
     IM_ASSERT(pixels);
     IM_ASSERT(channels>0 && channels<=4);
+    ImProfileAddTextureUpload((size_t)width * height * channels);
     unsigned char* data = nullptr;
 #if IMGUI_RENDERING_VULKAN
     VkBuffer buffer {nullptr};
@@ -532,6 +541,7 @@ void ImCopyToTexture(ImTextureID& imtexid, unsigned char* pixels, int width, int
     IM_ASSERT(imtexid);
     IM_ASSERT(pixels);
     IM_ASSERT(channels>0 && channels<=4);
+    ImProfileAddTextureUpload((size_t)width * height * channels);
     auto texture_width = ImGetTextureWidth(imtexid);
     auto texture_height = ImGetTextureHeight(imtexid);
     if (offset_x < 0 || offset_y < 0 ||
@@ -638,6 +648,7 @@ void ImCopyToTexture(ImTextureID& imtexid, unsigned char* pixels, int width, int
 
 ImTextureID ImCreateTexture(const void* data, int width, int height, double time_stamp, int bit_depth)
 {
+    if (data) ImProfileAddTextureUpload((size_t)width * height * 4 * (bit_depth > 8 ? 2 : 1));
 #if IMGUI_RENDERING_VULKAN
     g_tex_mutex.lock();
     g_Textures.resize(g_Textures.size() + 1);
@@ -841,6 +852,7 @@ void ImDestroyTextures()
 
 void ImUpdateTextures()
 {
+    IM_PROFILE_ZONE("ImUpdateTextures");
     g_tex_mutex.lock();
     for (auto iter = g_Textures.begin(); iter != g_Textures.end();)
     {
@@ -868,6 +880,473 @@ size_t ImGetTextureCount()
     return g_Textures.size();
 }
 
+// Instrumentation
+namespace
+{
+struct ProfileEvent
+{
+    const char* Name    {nullptr};
+    int64_t     StartNs {0};
+    int64_t     EndNs   {0};
+    int         Depth   {0};
+};
+
+// written by its thread only, read under g_profile_mutex, slots being overwritten while read are dropped
+struct ProfileThread
+{
+    enum { MaxDepth = 64 };
+    std::string                 Name;
+    int                         Id {0};
+    std::vector<ProfileEvent>   Events;
+    std::atomic<uint64_t>       Head {0};
+    uint64_t                    Start {0};              // first event after ImProfileClear, under g_profile_mutex
+    ProfileEvent                Stack[MaxDepth];
+    int                         Depth {0};
+};
+
+struct ProfileState
+{
+    std::chrono::steady_clock::time_point Epoch;
+    bool                        EpochSet {false};
+    ImGuiContext*               Context {nullptr};
+    ImGuiID                     HookIds[5] {};
+    ImGuiMemAllocFunc           PrevAlloc {nullptr};
+    ImGuiMemFreeFunc            PrevFree {nullptr};
+    void*                       PrevUserData {nullptr};
+    std::vector<std::unique_ptr<ProfileThread>> Threads;
+    ImProfileFrame              Frames[ImProfileFrameHistory];
+    int                         FrameHead {0};          // next slot
+    int                         FrameCount {0};
+    ImProfileFrame              Current;
+    bool                        CurrentValid {false};
+    int64_t                     CurrentStartNs {0};
+    int                         MainThreadId {0};
+};
+}
+
+static std::atomic<bool> g_profile_enabled {false};
+static std::atomic<int> g_profile_alloc_count {0};
+static std::atomic<size_t> g_profile_alloc_bytes {0};
+static std::atomic<int> g_profile_free_count {0};
+static std::atomic<size_t> g_profile_upload_bytes {0};
+static std::mutex g_profile_mutex;
+static ProfileState g_profile;
+static thread_local ProfileThread* g_profile_thread = nullptr;
+
+static int64_t ProfileNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_profile.Epoch).count();
+}
+
+static ProfileThread* ProfileGetThread()
+{
+    if (!g_profile_thread)
+    {
+        std::lock_guard<std::mutex> lock(g_profile_mutex);
+        g_profile.Threads.emplace_back(new ProfileThread());
+        g_profile_thread = g_profile.Threads.back().get();
+        g_profile_thread->Id = (int)g_profile.Threads.size();
+        g_profile_thread->Name = "Thread " + std::to_string(g_profile_thread->Id);
+        g_profile_thread->Events.resize(ImProfileZoneCapacity);
+    }
+    return g_profile_thread;
+}
+
+static void* ProfileAlloc(size_t size, void* user_data)
+{
+    IM_UNUSED(user_data);
+    g_profile_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_profile_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    return g_profile.PrevAlloc(size, g_profile.PrevUserData);
+}
+
+static void ProfileFree(void* ptr, void* user_data)
+{
+    IM_UNUSED(user_data);
+    if (ptr) g_profile_free_count.fetch_add(1, std::memory_order_relaxed);
+    g_profile.PrevFree(ptr, g_profile.PrevUserData);
+}
+
+// counters are read when the frame is stored, so they include everything up to the next NewFrame()
+static void ProfileUpdateCounters()
+{
+    ImProfileFrame& frame = g_profile.Current;
+    frame.AllocCount = g_profile_alloc_count;
+    frame.AllocBytes = g_profile_alloc_bytes;
+    frame.FreeCount = g_profile_free_count;
+    frame.TextureUploadBytes = g_profile_upload_bytes;
+}
+
+// previous frame ends at NewFrame(), counters start again
+static void ProfileNewFramePre(ImGuiContext*, ImGuiContextHook*)
+{
+    const int64_t now = ProfileNowNs();
+    if (g_profile.CurrentValid)
+    {
+        ProfileUpdateCounters();
+        g_profile.Current.FrameMs = (float)((now - g_profile.CurrentStartNs) / 1e6);
+        g_profile.Frames[g_profile.FrameHead] = g_profile.Current;
+        g_profile.FrameHead = (g_profile.FrameHead + 1) % ImProfileFrameHistory;
+        g_profile.FrameCount = ImMin(g_profile.FrameCount + 1, (int)ImProfileFrameHistory);
+    }
+    g_profile.Current = ImProfileFrame();
+    g_profile.Current.Time = now / 1e6;
+    g_profile.CurrentStartNs = now;
+    g_profile.CurrentValid = true;
+    g_profile.MainThreadId = ProfileGetThread()->Id;
+    g_profile_alloc_count = 0;
+    g_profile_alloc_bytes = 0;
+    g_profile_free_count = 0;
+    g_profile_upload_bytes = 0;
+    ImProfileZoneBegin("NewFrame");
+}
+
+static void ProfileNewFramePost(ImGuiContext*, ImGuiContextHook*)
+{
+    ImProfileZoneEnd();
+}
+
+static void ProfileRenderPre(ImGuiContext*, ImGuiContextHook*)
+{
+    ImProfileZoneBegin("Render");
+}
+
+static void ProfileRenderPost(ImGuiContext*, ImGuiContextHook*)
+{
+    ImProfileZoneEnd();
+    if (!g_profile.CurrentValid)
+        return;
+    ImProfileFrame& frame = g_profile.Current;
+    frame.CpuMs = (float)((ProfileNowNs() - g_profile.CurrentStartNs) / 1e6);
+    if (ImDrawData* draw_data = ImGui::GetDrawData())
+    {
+        frame.DrawLists = draw_data->CmdListsCount;
+        frame.Vertices = draw_data->TotalVtxCount;
+        frame.Indices = draw_data->TotalIdxCount;
+        frame.DrawCmds = 0;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+            frame.DrawCmds += draw_data->CmdLists[n]->CmdBuffer.Size;
+    }
+    // allocations and uploads after Render() go to the frame too
+    frame.TextureCount = ImGetTextureCount();
+}
+
+static void ProfileShutdown(ImGuiContext*, ImGuiContextHook*)
+{
+    ImProfileEnable(false);
+}
+
+void ImProfileEnable(bool enable)
+{
+    if (enable == g_profile_enabled)
+        return;
+    if (enable)
+    {
+        ImGuiContext* ctx = ImGui::GetCurrentContext();
+        IM_ASSERT(ctx && "ImProfileEnable() needs a context");
+        if (!g_profile.EpochSet)
+        {
+            g_profile.Epoch = std::chrono::steady_clock::now();
+            g_profile.EpochSet = true;
+        }
+        g_profile.Context = ctx;
+        const ImGuiContextHookType types[5] = { ImGuiContextHookType_NewFramePre, ImGuiContextHookType_NewFramePost, ImGuiContextHookType_RenderPre, ImGuiContextHookType_RenderPost, ImGuiContextHookType_Shutdown };
+        const ImGuiContextHookCallback callbacks[5] = { ProfileNewFramePre, ProfileNewFramePost, ProfileRenderPre, ProfileRenderPost, ProfileShutdown };
+        for (int i = 0; i < 5; i++)
+        {
+            ImGuiContextHook hook;
+            hook.Type = types[i];
+            hook.Callback = callbacks[i];
+            g_profile.HookIds[i] = ImGui::AddContextHook(ctx, &hook);
+        }
+        ImGui::GetAllocatorFunctions(&g_profile.PrevAlloc, &g_profile.PrevFree, &g_profile.PrevUserData);
+        ImGui::SetAllocatorFunctions(ProfileAlloc, ProfileFree, nullptr);
+        g_profile.CurrentValid = false;
+        g_profile_enabled = true;
+    }
+    else
+    {
+        g_profile_enabled = false;
+        // blocks allocated by the wrapper are freed by the same functions it forwards to
+        ImGui::SetAllocatorFunctions(g_profile.PrevAlloc, g_profile.PrevFree, g_profile.PrevUserData);
+        for (auto id : g_profile.HookIds)
+            ImGui::RemoveContextHook(g_profile.Context, id);
+        g_profile.Context = nullptr;
+        g_profile.CurrentValid = false;
+    }
+}
+
+bool ImProfileIsEnabled()
+{
+    return g_profile_enabled;
+}
+
+void ImProfileClear()
+{
+    std::lock_guard<std::mutex> lock(g_profile_mutex);
+    g_profile.FrameHead = 0;
+    g_profile.FrameCount = 0;
+    for (auto& thread : g_profile.Threads)
+        thread->Start = thread->Head.load(std::memory_order_acquire);
+}
+
+void ImProfileSetThreadName(const char* name)
+{
+    ProfileThread* thread = ProfileGetThread();
+    std::lock_guard<std::mutex> lock(g_profile_mutex);
+    thread->Name = name;
+}
+
+bool ImProfileZoneBegin(const char* name)
+{
+    if (!g_profile_enabled.load(std::memory_order_relaxed))
+        return false;
+    ProfileThread* thread = ProfileGetThread();
+    if (thread->Depth >= ProfileThread::MaxDepth)
+        return false;
+    ProfileEvent& event = thread->Stack[thread->Depth];
+    event.Name = name;
+    event.Depth = thread->Depth++;
+    event.StartNs = ProfileNowNs();
+    return true;
+}
+
+void ImProfileZoneEnd()
+{
+    ProfileThread* thread = g_profile_thread;
+    if (!thread || thread->Depth <= 0)
+        return;
+    ProfileEvent& event = thread->Stack[--thread->Depth];
+    event.EndNs = ProfileNowNs();
+    const uint64_t head = thread->Head.load(std::memory_order_relaxed);
+    thread->Events[head % ImProfileZoneCapacity] = event;
+    thread->Head.store(head + 1, std::memory_order_release);
+}
+
+void ImProfileAddTextureUpload(size_t bytes)
+{
+    if (g_profile_enabled.load(std::memory_order_relaxed))
+        g_profile_upload_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+int ImProfileGetFrameCount()
+{
+    return g_profile.FrameCount;
+}
+
+const ImProfileFrame& ImProfileGetFrame(int index)
+{
+    IM_ASSERT(index >= 0 && index < g_profile.FrameCount);
+    return g_profile.Frames[(g_profile.FrameHead - g_profile.FrameCount + index + ImProfileFrameHistory) % ImProfileFrameHistory];
+}
+
+// stored events of a thread, oldest first
+static void ProfileCopyEvents(const ProfileThread& thread, std::vector<ProfileEvent>& events)
+{
+    events.clear();
+    const uint64_t head = thread.Head.load(std::memory_order_acquire);
+    const uint64_t start = ImMax(thread.Start, head > ImProfileZoneCapacity ? head - ImProfileZoneCapacity : 0);
+    for (uint64_t i = start; i < head; i++)
+        events.push_back(thread.Events[i % ImProfileZoneCapacity]);
+    // the thread may have overwritten the oldest ones meanwhile, and may be writing slot new_head,
+    // which holds event new_head - capacity
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t new_head = thread.Head.load(std::memory_order_relaxed);
+    const uint64_t valid = new_head + 1 > ImProfileZoneCapacity ? new_head + 1 - ImProfileZoneCapacity : 0;
+    if (valid > start)
+        events.erase(events.begin(), events.begin() + (size_t)ImMin(valid - start, (uint64_t)events.size()));
+}
+
+static void ProfileWriteString(FILE* file, const char* str)
+{
+    fputc('"', file);
+    for (const char* p = str; p && *p; p++)
+    {
+        if (*p == '"' || *p == '\\') fputc('\\', file);
+        if ((unsigned char)*p >= 0x20) fputc(*p, file);
+    }
+    fputc('"', file);
+}
+
+bool ImProfileExportChromeTrace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+    std::lock_guard<std::mutex> lock(g_profile_mutex);
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    auto separator = [&]() { if (!first) fprintf(file, ",\n"); first = false; };
+    std::vector<ProfileEvent> events;
+    for (auto& thread : g_profile.Threads)
+    {
+        separator();
+        fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", thread->Id);
+        ProfileWriteString(file, thread->Name.c_str());
+        fprintf(file, "}}");
+        ProfileCopyEvents(*thread, events);
+        for (auto& event : events)
+        {
+            separator();
+            fprintf(file, "{\"name\":");
+            ProfileWriteString(file, event.Name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", thread->Id, event.StartNs / 1e3, (event.EndNs - event.StartNs) / 1e3);
+        }
+    }
+    // frames as zones around everything of the main thread, counters as tracks
+    for (int i = 0; i < g_profile.FrameCount; i++)
+    {
+        const ImProfileFrame& frame = ImProfileGetFrame(i);
+        separator();
+        fprintf(file, "{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"cpu_ms\":%.3f}},\n", g_profile.MainThreadId, frame.Time * 1e3, frame.FrameMs * 1e3, frame.CpuMs);
+        fprintf(file, "{\"name\":\"MemAlloc\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"calls\":%d,\"bytes\":%zu,\"frees\":%d}},\n", frame.Time * 1e3, frame.AllocCount, frame.AllocBytes, frame.FreeCount);
+        fprintf(file, "{\"name\":\"DrawData\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"draw_cmds\":%d,\"vertices\":%d,\"indices\":%d}},\n", frame.Time * 1e3, frame.DrawCmds, frame.Vertices, frame.Indices);
+        fprintf(file, "{\"name\":\"Textures\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"upload_bytes\":%zu,\"count\":%zu}}", frame.Time * 1e3, frame.TextureUploadBytes, frame.TextureCount);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
+
+void ShowProfileWindow(bool* p_open)
+{
+    static int selected_frame = -1;
+    static char trace_path[256] = "imgui_trace.json";
+    static std::string export_status;
+    if (!ImPlot::GetCurrentContext())
+        ImPlot::CreateContext();
+    ImGui::SetNextWindowSize(ImVec2(640, 560), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profile", p_open))
+    {
+        ImGui::End();
+        return;
+    }
+    bool enabled = ImProfileIsEnabled();
+    if (ImGui::Checkbox("Enable", &enabled))
+        ImProfileEnable(enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+    {
+        ImProfileClear();
+        selected_frame = -1;
+    }
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(200);
+    ImGui::InputText("##TracePath", trace_path, IM_ARRAYSIZE(trace_path));
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace"))
+        export_status = ImProfileExportChromeTrace(trace_path) ? std::string("saved ") + trace_path : std::string("can't write ") + trace_path;
+    if (!export_status.empty())
+    {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(export_status.c_str());
+    }
+
+    const int count = ImProfileGetFrameCount();
+    std::vector<float> frame_ms(count), cpu_ms(count), allocs(count);
+    double sum_ms = 0, sum_allocs = 0, sum_vertices = 0;
+    float max_ms = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const ImProfileFrame& frame = ImProfileGetFrame(i);
+        frame_ms[i] = frame.FrameMs;
+        cpu_ms[i] = frame.CpuMs;
+        allocs[i] = (float)frame.AllocCount;
+        sum_ms += frame.FrameMs;
+        sum_allocs += frame.AllocCount;
+        sum_vertices += frame.Vertices;
+        max_ms = ImMax(max_ms, frame.FrameMs);
+    }
+    if (count > 0)
+    {
+        const ImProfileFrame& last = ImProfileGetFrame(count - 1);
+        ImGui::Text("%d frames, mean %.2f ms, max %.2f ms, %.0f allocs and %.0f vertices per frame", count, sum_ms / count, max_ms, sum_allocs / count, sum_vertices / count);
+        ImGui::Text("last: %.2f ms, cpu %.2f ms, %d allocs %zu bytes, %d draw cmds, %d vertices, %zu bytes uploaded, %zu textures",
+                    last.FrameMs, last.CpuMs, last.AllocCount, last.AllocBytes, last.DrawCmds, last.Vertices, last.TextureUploadBytes, last.TextureCount);
+    }
+    else
+        ImGui::TextUnformatted(enabled ? "no frame yet" : "profile is disabled");
+
+    if (ImPlot::BeginPlot("##Frames", ImVec2(-1, 180), ImPlotFlags_NoMenus))
+    {
+        ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxis(ImAxis_Y2, "allocs", ImPlotAxisFlags_AuxDefault | ImPlotAxisFlags_AutoFit);
+        ImPlot::SetAxes(ImAxis_X1, ImAxis_Y2);
+        ImPlot::PlotBars("allocs", allocs.data(), count, 0.67);
+        ImPlot::SetAxes(ImAxis_X1, ImAxis_Y1);
+        ImPlot::PlotLine("frame ms", frame_ms.data(), count);
+        ImPlot::PlotLine("cpu ms", cpu_ms.data(), count);
+        if (selected_frame >= 0 && selected_frame < count)
+            ImPlot::TagX(selected_frame, ImVec4(1, 0.5f, 0, 1), "%d", selected_frame);
+        // click selects a frame
+        if (ImPlot::IsPlotHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+            selected_frame = ImClamp((int)(ImPlot::GetPlotMousePos().x + 0.5), 0, ImMax(count - 1, 0));
+        ImPlot::EndPlot();
+    }
+
+    // hot frames, slowest first
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return frame_ms[a] > frame_ms[b]; });
+    ImGui::BeginChild("##HotFrames", ImVec2(220, 0), true);
+    ImGui::TextUnformatted("Hot frames");
+    for (int i = 0; i < ImMin(count, 20); i++)
+    {
+        char label[64];
+        ImFormatString(label, IM_ARRAYSIZE(label), "#%d  %.2f ms", order[i], frame_ms[order[i]]);
+        if (ImGui::Selectable(label, selected_frame == order[i]))
+            selected_frame = order[i];
+    }
+    ImGui::EndChild();
+    ImGui::SameLine();
+
+    // zones of the selected frame
+    ImGui::BeginChild("##Zones", ImVec2(0, 0), true);
+    if (selected_frame >= 0 && selected_frame < count)
+    {
+        const ImProfileFrame& frame = ImProfileGetFrame(selected_frame);
+        ImGui::Text("frame #%d: %.2f ms, cpu %.2f ms, %d allocs %zu bytes, %d frees, %d draw lists, %d draw cmds, %d vertices",
+                    selected_frame, frame.FrameMs, frame.CpuMs, frame.AllocCount, frame.AllocBytes, frame.FreeCount, frame.DrawLists, frame.DrawCmds, frame.Vertices);
+        const int64_t start = (int64_t)(frame.Time * 1e6), end = start + (int64_t)(frame.FrameMs * 1e6);
+        if (ImGui::BeginTable("##ZoneTable", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable))
+        {
+            ImGui::TableSetupColumn("Thread");
+            ImGui::TableSetupColumn("Zone");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableHeadersRow();
+            std::lock_guard<std::mutex> lock(g_profile_mutex);
+            std::vector<ProfileEvent> events;
+            for (auto& thread : g_profile.Threads)
+            {
+                ProfileCopyEvents(*thread, events);
+                std::vector<ProfileEvent> zones;
+                for (auto& event : events)
+                    if (event.StartNs >= start && event.StartNs < end)
+                        zones.push_back(event);
+                std::sort(zones.begin(), zones.end(), [](const ProfileEvent& a, const ProfileEvent& b) { return a.StartNs < b.StartNs || (a.StartNs == b.StartNs && a.Depth < b.Depth); });
+                for (auto& zone : zones)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(thread->Name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Indent(zone.Depth * 12.f + 1.f);
+                    ImGui::TextUnformatted(zone.Name);
+                    ImGui::Unindent(zone.Depth * 12.f + 1.f);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", (zone.EndNs - zone.StartNs) / 1e6);
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+    else
+        ImGui::TextUnformatted("select a frame in the plot or the hot frames");
+    ImGui::EndChild();
+    ImGui::End();
+}
+
 int ImGetTextureWidth(ImTextureID texture)
 {
     auto textureIt = ImFindTexture(texture);
@@ -1700,13 +2179,20 @@ void Grid::End()
 namespace ImGuiHelper
 {
 static const char* FieldTypeNames[ImGui::FT_COUNT+1] = {"INT","UNSIGNED","FLOAT","DOUBLE","STRING","ENUM","BOOL","COLOR","TEXTLINE","CUSTOM","COUNT"};
-static const char* FieldTypeFormats[ImGui::FT_COUNT]={"%d","%u","%f","%f","%s","%d","%d","%f","%s","%s"};
 static const char* FieldTypeFormatsWithCustomPrecision[ImGui::FT_COUNT]={"%.*d","%*u","%.*f","%.*f","%*s","%*d","%*d","%.*f","%*s","%*s"};
 
 void Deserializer::clear()
 {
-    if (f_data) ImGui::MemFree(f_data);
-    f_data = NULL;f_size=0;
+    if (f_data)
+    {
+        if (!f_mapped) ImGui::MemFree(f_data);
+#ifdef _WIN32
+        else ::UnmapViewOfFile(f_data);
+#else
+        else ::munmap(f_data,f_size);
+#endif
+    }
+    f_data = NULL;f_size=0;f_mapped=false;
 }
 
 bool Deserializer::loadFromFile(const char *filename)
@@ -1744,6 +2230,51 @@ bool Deserializer::loadFromFile(const char *filename)
     ++f_size;
     return true;
 }
+bool Deserializer::mapFile(const char *filename)
+{
+    clear();
+    if (!filename) return false;
+#ifdef _WIN32
+    const int wlen = ::MultiByteToWideChar(CP_UTF8, 0, filename, -1, NULL, 0);
+    ImVector<wchar_t> wfilename;wfilename.resize(wlen>0 ? wlen : 1);wfilename[0]=L'\0';
+    if (wlen>0) ::MultiByteToWideChar(CP_UTF8, 0, filename, -1, wfilename.Data, wlen);
+    HANDLE file = ::CreateFileW(wfilename.Data, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+        if (::GetFileSizeEx(file, &size) && size.QuadPart>0 && (unsigned long long)size.QuadPart<=(unsigned long long)(size_t)-1)
+        {
+            HANDLE mapping = ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping)
+            {
+                void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                ::CloseHandle(mapping);     // view keeps the mapping alive
+                if (view) {f_data = (char*)view;f_size = (size_t)size.QuadPart;f_mapped = true;}
+            }
+        }
+        ::CloseHandle(file);
+    }
+#else //_WIN32
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (::fstat(fd, &st)==0 && st.st_size>0)
+        {
+            void* view = ::mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED)
+            {
+#ifdef MADV_SEQUENTIAL
+                ::madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+                f_data = (char*)view;f_size = (size_t)st.st_size;f_mapped = true;
+            }
+        }
+        ::close(fd);
+    }
+#endif //_WIN32
+    return f_mapped || loadFromFile(filename);
+}
 bool Deserializer::allocate(size_t sizeToAllocate, const char *optionalTextToCopy, size_t optionalTextToCopySize)
 {
     clear();
@@ -1754,254 +2285,392 @@ bool Deserializer::allocate(size_t sizeToAllocate, const char *optionalTextToCop
     if (optionalTextToCopy && optionalTextToCopySize>0) memcpy(f_data,optionalTextToCopy,optionalTextToCopySize>f_size ? f_size:optionalTextToCopySize);
     return true;
 }
-Deserializer::Deserializer(const char *filename) : f_data(NULL),f_size(0)
+Deserializer::Deserializer(const char *filename) : f_data(NULL),f_size(0),f_mapped(false)
 {
     if (filename) loadFromFile(filename);
 }
-Deserializer::Deserializer(const char *text, size_t textSizeInBytes) : f_data(NULL),f_size(0)
+Deserializer::Deserializer(const char *text, size_t textSizeInBytes) : f_data(NULL),f_size(0),f_mapped(false)
 {
     allocate(textSizeInBytes,text,textSizeInBytes);
 }
 
-const char* Deserializer::parse(Deserializer::ParseCallback cb, void *userPtr, const char *optionalBufferStart) const
+// Fields are parsed in [begin,end) without writing to the buffer, so that a read only mapping can
+// be parsed in place and sections can be parsed by several threads at once.
+namespace DeserializerParser
 {
-    if (!cb || !f_data || f_size==0) return NULL;
-    //------------------------------------------------
-    // Parse file in memory
-    char name[128];name[0]='\0';
-    char typeName[32];char format[32]="";bool quitParsing = false;
-    char charBuffer[sizeof(double)*10];void* voidBuffer = (void*) &charBuffer[0];
-    static char textBuffer[2050];
-    const char* varName = NULL;int numArrayElements = 0;FieldType ft = ImGui::FT_COUNT;
-    const char* buf_end = f_data + f_size-1;
-    for (const char* line_start = optionalBufferStart ? optionalBufferStart : f_data; line_start < buf_end; )
-    {
-        const char* line_end = line_start;
-        while (line_end < buf_end && *line_end != '\n' && *line_end != '\r') line_end++;
-
-        if (name[0]=='\0' && line_start[0] == '[' && line_end > line_start && line_end[-1] == ']')
-        {
-            ImFormatString(name, IM_ARRAYSIZE(name), "%.*s", (int)(line_end-line_start-2), line_start+1);
-            //fprintf(stderr,"name: %s\n",name);  // dbg
-
-            // Here we have something like: FLOAT-4:VariableName
-            // We have to split into FLOAT 4 VariableName
-            varName = NULL;numArrayElements = 0;ft = ImGui::FT_COUNT;format[0]='\0';
-            const char* colonCh = strchr(name,':');
-            const char* minusCh = strchr(name,'-');
-            if (!colonCh)
-            {
-                fprintf(stderr,"ImGuiHelper::Deserializer::parse(...) warning (skipping line with no semicolon). name: %s\n",name);  // dbg
-                name[0]='\0';
-            }
-            else
-            {
-                ptrdiff_t diff = 0,diff2 = 0;
-                if (!minusCh || (minusCh-colonCh)>0)  {diff = (colonCh-name);numArrayElements=1;}
-                else
-                {
-                    diff = (minusCh-name);
-                    diff2 = colonCh-minusCh;
-                    if (diff2>1 && diff2<7)
-                    {
-                        static char buff[8];
-                        strncpy(&buff[0],(const char*) &minusCh[1],diff2);buff[diff2-1]='\0';
-                        sscanf(buff,"%d",&numArrayElements);
-                        //fprintf(stderr,"WARN: %s\n",buff);
-                    }
-                    else if (diff>0) numArrayElements = ((char)name[diff+1]-(char)'0');  // TODO: FT_STRING needs multibytes -> rewrite!
-                }
-                if (diff>0)
-                {
-                    const size_t len = (size_t)(diff>31?31:diff);
-                    strncpy(typeName,name,len);typeName[len]='\0';
+struct FieldHeader
+{
+    char name[128];         // "FLOAT-4:VariableName"
+    const char* varName;    // points into name
+    FieldType ft;
+    int numArrayElements;
+    bool hasCount;          // "-N" is present
+};
 
-                    for (int t=0;t<=ImGui::FT_COUNT;t++)
-                    {
-                        if (strcmp(typeName,FieldTypeNames[t])==0)
-                        {
-                            ft = (FieldType) t;break;
-                        }
-                    }
-                    varName = ++colonCh;
+// Points to '\r', '\n' or end
+static inline const char* LineEnd(const char* p,const char* end)
+{
+    const char* nl = (const char*)memchr(p,'\n',(size_t)(end-p));
+    if (!nl) nl = end;
+    const char* cr = (const char*)memchr(p,'\r',(size_t)(nl-p));
+    return cr ? cr : nl;
+}
+// "\r\n" is a single line ending
+static inline const char* NextLine(const char* line_end,const char* end)
+{
+    if (line_end<end && *line_end=='\r') ++line_end;
+    if (line_end<end && *line_end=='\n') ++line_end;
+    return line_end;
+}
+static inline bool IsBlank(char c) {return c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\v' || c=='\f';}
+static inline bool IsDigit(char c) {return (unsigned)(c-'0')<10;}
 
-                    const bool isTextOrCustomType = ft==ImGui::FT_STRING || ft==ImGui::FT_TEXTLINE  || ft==ImGui::FT_CUSTOM;
-                    if (ft==ImGui::FT_COUNT || numArrayElements<1 || (numArrayElements>4 && !isTextOrCustomType))
-                    {
-                        fprintf(stderr,"ImGuiHelper::Deserializer::parse(...) Error (wrong type detected): line:%s type:%d numArrayElements:%d varName:%s typeName:%s\n",name,(int)ft,numArrayElements,varName,typeName);
-                        varName=NULL;
-                    }
-                    else
-                    {
-                        if (ft==ImGui::FT_STRING && varName && varName[0]!='\0')
-                        {
-                            if (numArrayElements==1 && (!minusCh || (minusCh-colonCh)>0))
-                            {
-                                numArrayElements=0;   // NEW! To handle blank strings ""
-                            }
-                            //Process soon here, as the string can be multiline
-                            line_start = ++line_end;
-                            //--------------------------------------------------------
-                            int cnt = 0;
-                            while (line_end < buf_end && cnt++ < numArrayElements-1) ++line_end;
-                            textBuffer[0]=textBuffer[2049]='\0';
-                            const int maxLen = numArrayElements>0 ? (cnt>2049?2049:cnt) : 0;
-                            strncpy(textBuffer,line_start,maxLen+1);
-                            textBuffer[maxLen]='\0';
-                            quitParsing = cb(ft,numArrayElements,(void*)textBuffer,varName,userPtr);
-                            //fprintf(stderr,"Deserializer::parse(...) value:\"%s\" to type:%d numArrayElements:%d varName:%s maxLen:%d\n",textBuffer,(int)ft,numArrayElements,varName,maxLen);  // dbg
-
-
-                            //else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-                            //--------------------------------------------------------
-                            ft = ImGui::FT_COUNT;name[0]='\0';varName=NULL; // mandatory                            
-
-                        }
-                        else if (!isTextOrCustomType)
-                        {
-                            format[0]='\0';
-                            for (int t=0;t<numArrayElements;t++)
-                            {
-                                if (t>0) strcat(format," ");
-                                strcat(format,FieldTypeFormats[ft]);
-                            }
-                            // DBG:
-                            //fprintf(stderr,"Deserializer::parse(...) DBG: line:%s type:%d numArrayElements:%d varName:%s format:%s\n",name,(int)ft,numArrayElements,varName,format);  // dbg
-                        }
-                    }
-                }
-            }
+static const char* ParseInteger(const char* p,const char* end,long long& value)
+{
+    while (p<end && IsBlank(*p)) ++p;
+    bool negative = false;
+    if (p<end && (*p=='-' || *p=='+')) negative = (*p++=='-');
+    const char* digits = p;
+    unsigned long long v = 0;
+    while (p<end && IsDigit(*p)) v = v*10 + (unsigned)(*p++-'0');
+    if (p==digits) return NULL;
+    value = negative ? -(long long)v : (long long)v;
+    return p;
+}
+
+// Locale independent replacement of strtod(...): ',' is accepted as decimal separator too, so files
+// written with printf(...) under a ',' locale load everywhere. Exact when the significant digits fit
+// in 53 bits and the decimal exponent is within 22 (all what Serializer writes by default), other
+// values are scaled in long double.
+static const char* ParseDouble(const char* p,const char* end,double& value)
+{
+    static const double powersOfTen[23] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+    while (p<end && IsBlank(*p)) ++p;
+    bool negative = false;
+    if (p<end && (*p=='-' || *p=='+')) negative = (*p++=='-');
+    if (p<end && ((*p|0x20)=='n' || (*p|0x20)=='i'))
+    {
+        // nan, inf and infinity
+        const char* word = (*p|0x20)=='n' ? "nan" : "infinity";
+        int len = 0;
+        while (word[len] && p+len<end && (p[len]|0x20)==word[len]) ++len;
+        if (len<3) return NULL;
+        if (word[0]=='i' && len<8) len = 3;
+        value = word[0]=='n' ? (double)NAN : (negative ? -(double)INFINITY : (double)INFINITY);
+        return p+len;
+    }
+    unsigned long long mantissa = 0;
+    int significantDigits = 0, exponent = 0;
+    bool anyDigit = false;
+    for (;p<end && IsDigit(*p);++p)
+    {
+        anyDigit = true;
+        if (significantDigits<19) {mantissa = mantissa*10 + (unsigned)(*p-'0');if (mantissa) ++significantDigits;}
+        else ++exponent;
+    }
+    if (p<end && (*p=='.' || *p==','))
+    {
+        for (++p;p<end && IsDigit(*p);++p)
+        {
+            anyDigit = true;
+            if (significantDigits<19) {mantissa = mantissa*10 + (unsigned)(*p-'0');if (mantissa) ++significantDigits;--exponent;}
         }
-        else if (varName && varName[0]!='\0')
+    }
+    if (!anyDigit) return NULL;
+    if (p<end && (*p|0x20)=='e')
+    {
+        const char* q = p+1;
+        bool negativeExponent = false;
+        if (q<end && (*q=='-' || *q=='+')) negativeExponent = (*q++=='-');
+        if (q<end && IsDigit(*q))
         {
-            switch (ft)
-            {
-            case ImGui::FT_FLOAT:
-            case ImGui::FT_COLOR:
-            {
-                float* p = (float*) voidBuffer;
-                if ((numArrayElements==1 && sscanf(line_start, format, p)==numArrayElements) ||
-                    (numArrayElements==2 && sscanf(line_start, format, &p[0],&p[1])==numArrayElements) ||
-                    (numArrayElements==3 && sscanf(line_start, format, &p[0],&p[1],&p[2])==numArrayElements) ||
-                    (numArrayElements==4 && sscanf(line_start, format, &p[0],&p[1],&p[2],&p[3])==numArrayElements))
-                    quitParsing = cb(ft,numArrayElements,voidBuffer,varName,userPtr);
-                else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-            }
-            break;
-            case ImGui::FT_DOUBLE:
-            {
-                double* p = (double*) voidBuffer;
-                if ((numArrayElements==1 && sscanf(line_start, format, p)==numArrayElements) ||
-                    (numArrayElements==2 && sscanf(line_start, format, &p[0],&p[1])==numArrayElements) ||
-                    (numArrayElements==3 && sscanf(line_start, format, &p[0],&p[1],&p[2])==numArrayElements) ||
-                    (numArrayElements==4 && sscanf(line_start, format, &p[0],&p[1],&p[2],&p[3])==numArrayElements))
-                    quitParsing = cb(ft,numArrayElements,voidBuffer,varName,userPtr);
-                else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-            }
-            break;
-            case ImGui::FT_INT:
-            case ImGui::FT_ENUM:
-            {
-                int* p = (int*) voidBuffer;
-                if ((numArrayElements==1 && sscanf(line_start, format, p)==numArrayElements) ||
-                    (numArrayElements==2 && sscanf(line_start, format, &p[0],&p[1])==numArrayElements) ||
-                    (numArrayElements==3 && sscanf(line_start, format, &p[0],&p[1],&p[2])==numArrayElements) ||
-                    (numArrayElements==4 && sscanf(line_start, format, &p[0],&p[1],&p[2],&p[3])==numArrayElements))
-                    quitParsing = cb(ft,numArrayElements,voidBuffer,varName,userPtr);
-                else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-            }
-            break;
-            case ImGui::FT_BOOL:
-            {
-                bool* p = (bool*) voidBuffer;
-                int tmp[4];
-                if ((numArrayElements==1 && sscanf(line_start, format, &tmp[0])==numArrayElements) ||
-                    (numArrayElements==2 && sscanf(line_start, format, &tmp[0],&tmp[1])==numArrayElements) ||
-                    (numArrayElements==3 && sscanf(line_start, format, &tmp[0],&tmp[1],&tmp[2])==numArrayElements) ||
-                    (numArrayElements==4 && sscanf(line_start, format, &tmp[0],&tmp[1],&tmp[2],&tmp[3])==numArrayElements))    {
-                    for (int i=0;i<numArrayElements;i++) p[i] = tmp[i];
-                    quitParsing = cb(ft,numArrayElements,voidBuffer,varName,userPtr);quitParsing = cb(ft,numArrayElements,voidBuffer,varName,userPtr);
-                }
-                else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-            }
-            break;
-            case ImGui::FT_UNSIGNED:
-            {
-                unsigned* p = (unsigned*) voidBuffer;
-                if ((numArrayElements==1 && sscanf(line_start, format, p)==numArrayElements) ||
-                    (numArrayElements==2 && sscanf(line_start, format, &p[0],&p[1])==numArrayElements) ||
-                    (numArrayElements==3 && sscanf(line_start, format, &p[0],&p[1],&p[2])==numArrayElements) ||
-                    (numArrayElements==4 && sscanf(line_start, format, &p[0],&p[1],&p[2],&p[3])==numArrayElements))
-                    quitParsing = cb(ft,numArrayElements,voidBuffer,varName,userPtr);
-                else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-            }
-            break;
-            case ImGui::FT_CUSTOM:
-            case ImGui::FT_TEXTLINE:
-            {
-                // A similiar code can be used to parse "numArrayElements" line of text
-                for (int i=0;i<numArrayElements;i++)
-                {
-                    textBuffer[0]=textBuffer[2049]='\0';
-                    const int maxLen = (line_end-line_start)>2049?2049:(line_end-line_start);
-                    if (maxLen<=0) break;
-                    strncpy(textBuffer,line_start,maxLen+1);textBuffer[maxLen]='\0';
-                    quitParsing = cb(ft,i,(void*)textBuffer,varName,userPtr);
-
-                    //fprintf(stderr,"%d) \"%s\"\n",i,textBuffer);  // Dbg
-
-                    if (quitParsing) break;
-                    line_start = line_end+1;
-                    line_end = line_start;
-                    if (line_end == buf_end) break;
-                    while (line_end < buf_end && *line_end != '\n' && *line_end != '\r') line_end++;
-                }
-            }
-            break;
-            default:
-            fprintf(stderr,"Deserializer::parse(...) Warning missing value type:\"%s\" to type:%d numArrayElements:%d varName:%s\n",line_start,(int)ft,numArrayElements,varName);  // dbg
-            break;
-            }
-            //---------------------------------------------------------------------------------
-            name[0]='\0';varName=NULL; // mandatory
+            int e = 0;
+            for (;q<end && IsDigit(*q);++q) if (e<100000) e = e*10 + (*q-'0');
+            exponent += negativeExponent ? -e : e;
+            p = q;
         }
-
-        line_start = line_end+1;
-
-        if (quitParsing) return line_start;
     }
-
-    //------------------------------------------------
-    return buf_end;
+    double v;
+    if (mantissa==0) v = 0.0;
+    else if (mantissa<=(1ULL<<53) && exponent>=-22 && exponent<=22)
+        v = exponent<0 ? (double)mantissa/powersOfTen[-exponent] : (double)mantissa*powersOfTen[exponent];
+    else if (exponent>400) v = (double)INFINITY;
+    else if (exponent<-400) v = 0.0;
+    else v = (double)((long double)mantissa*powl(10.0L,(long double)exponent));
+    value = negative ? -v : v;
+    return p;
 }
 
-bool GetFileContent(const char *filePath, ImVector<char> &contentOut, bool clearContentOutBeforeUsage, const char *modes, bool appendTrailingZeroIfModesIsNotBinary)
+// Splits "[FLOAT-4:VariableName]" into FLOAT 4 VariableName
+static bool ParseFieldHeader(const char* line_start,const char* line_end,FieldHeader& h,bool warn)
 {
-    ImVector<char>& f_data = contentOut;
-    if (clearContentOutBeforeUsage) f_data.clear();
-//----------------------------------------------------
-    if (!filePath) return false;
-    const bool appendTrailingZero = appendTrailingZeroIfModesIsNotBinary && modes && strlen(modes)>0 && modes[strlen(modes)-1]!='b';
-    FILE* f;
-    if ((f = (FILE *)ImFileOpen(filePath, modes)) == NULL) return false;
-    if (fseek(f, 0, SEEK_END))
+    if (line_end-line_start<2 || line_start[0]!='[' || line_end[-1]!=']') return false;
+    const size_t len = ImMin((size_t)(line_end-line_start-2),sizeof(h.name)-1);
+    memcpy(h.name,line_start+1,len);h.name[len]='\0';
+    const char* colonCh = strchr(h.name,':');
+    if (!colonCh)
     {
-        fclose(f);
+        if (warn) fprintf(stderr,"ImGuiHelper::Deserializer::parse(...) warning (skipping line with no semicolon). name: %s\n",h.name);
         return false;
     }
-    const long f_size_signed = ftell(f);
-    if (f_size_signed == -1)
+    const char* minusCh = strchr(h.name,'-');
+    h.hasCount = minusCh && minusCh<colonCh;
+    const char* typeEnd = h.hasCount ? minusCh : colonCh;
+    h.numArrayElements = 1;
+    if (h.hasCount)
     {
-        fclose(f);
-        return false;
+        long long n = 0;
+        h.numArrayElements = (ParseInteger(minusCh+1,colonCh,n)==colonCh && n>0 && n<=INT_MAX) ? (int)n : 0;
     }
-    size_t f_size = (size_t)f_size_signed;
-    if (fseek(f, 0, SEEK_SET))
+    h.ft = ImGui::FT_COUNT;
+    const size_t typeLen = (size_t)(typeEnd-h.name);
+    for (int t=0;t<ImGui::FT_COUNT;t++)
     {
-        fclose(f);
+        if (strlen(FieldTypeNames[t])==typeLen && strncmp(h.name,FieldTypeNames[t],typeLen)==0)
+        {
+            h.ft = (FieldType) t;break;
+        }
+    }
+    h.varName = colonCh+1;
+    // numeric fields with more than 4 values must be binary, checked with the value
+    if (h.ft==ImGui::FT_COUNT || h.numArrayElements<1 || (h.numArrayElements>4 && h.ft==ImGui::FT_BOOL) || h.varName[0]=='\0')
+    {
+        if (warn) fprintf(stderr,"ImGuiHelper::Deserializer::parse(...) Error (wrong type detected): line:%s type:%d numArrayElements:%d varName:%s\n",h.name,(int)h.ft,h.numArrayElements,h.varName);
         return false;
     }
-    f_data.resize(f_size+(appendTrailingZero?1:0));
+    return true;
+}
+
+// FT_STRING-N values are N chars long and can span lines, without "-N" the value is the rest of the line
+static size_t StringValueLength(const FieldHeader& h,const char* value_start,const char* end)
+{
+    if (!h.hasCount) return (size_t)(LineEnd(value_start,end)-value_start);
+    return ImMin((size_t)h.numArrayElements,(size_t)(end-value_start));
+}
+
+// Value of fields saved by Serializer::saveBinary(...): "#B85 <numBytes> <checksum> <base85 data>"
+static inline bool IsBinaryValue(const char* value_start,const char* end)
+{
+    return end-value_start>=5 && memcmp(value_start,"#B85 ",5)==0;
+}
+static size_t BinaryElementSize(FieldType ft)
+{
+    switch (ft)
+    {
+    case ImGui::FT_FLOAT: case ImGui::FT_COLOR: return sizeof(float);
+    case ImGui::FT_DOUBLE:                      return sizeof(double);
+    case ImGui::FT_INT: case ImGui::FT_ENUM:    return sizeof(int);
+    case ImGui::FT_UNSIGNED:                    return sizeof(unsigned);
+    default:                                    return 0;
+    }
+}
+static bool ParseBinaryValue(const FieldHeader& h,const char* value_start,const char* line_end,ImVector<char>& values)
+{
+    long long numBytes = 0, checksum = 0;
+    const char* p = ParseInteger(value_start+5,line_end,numBytes);
+    if (p) p = ParseInteger(p,line_end,checksum);
+    if (!p || p>=line_end || *p!=' ') return false;
+    const size_t elementSize = BinaryElementSize(h.ft);
+    if (elementSize==0 || numBytes!=(long long)elementSize*h.numArrayElements || numBytes>INT_MAX || (size_t)(line_end-p-1)!=(size_t)(numBytes+3)/4*5) return false;
+    // groups of 5 chars to little endian words, same alphabet as Base85Encode(...)
+    values.resize((int)((numBytes+3)&~3LL));
+    const unsigned char* src = (const unsigned char*)p+1;
+    unsigned char* dst = (unsigned char*)values.Data;
+    for (int i=0;i<values.size();i+=4,src+=5)
+    {
+        unsigned int w = 0;
+        for (int k=4;k>=0;k--)
+        {
+            const unsigned int c = src[k];
+            if (c<35 || c>120 || c=='\\') return false;
+            w = w*85 + (c>='\\' ? c-36 : c-35);
+        }
+        dst[i] = (unsigned char)w;dst[i+1] = (unsigned char)(w>>8);dst[i+2] = (unsigned char)(w>>16);dst[i+3] = (unsigned char)(w>>24);
+    }
+    return ImHashData(values.Data,(size_t)numBytes,0)==(ImGuiID)checksum;
+}
+
+// Returns the line after the value of a field, the same parse(...) goes on from
+static const char* SkipFieldValue(const FieldHeader& h,const char* value_start,const char* end)
+{
+    if (h.ft==ImGui::FT_STRING) return NextLine(value_start+StringValueLength(h,value_start,end),end);
+    if (h.ft==ImGui::FT_TEXTLINE || h.ft==ImGui::FT_CUSTOM)
+    {
+        const char* line_start = value_start;
+        for (int i=0;i<h.numArrayElements && line_start<end;i++)
+        {
+            const char* line_end = LineEnd(line_start,end);
+            if (line_end==line_start) break;    // an empty line ends the field
+            line_start = NextLine(line_end,end);
+        }
+        return line_start;
+    }
+    return NextLine(LineEnd(value_start,end),end);
+}
+
+// cb(ft,numArrayElements,pValue,name) returns whether to stop parsing
+template <typename Callback> static const char* ParseFields(const char* begin,const char* end,Callback& cb)
+{
+    FieldHeader h;
+    ImVector<char> textBuffer, binaryBuffer;
+    union {float f[4];double d[4];int i[4];unsigned u[4];bool b[4];} value;
+    for (const char* line_start = begin; line_start < end; )
+    {
+        const char* line_end = LineEnd(line_start,end);
+        const char* value_start = NextLine(line_end,end);
+        if (!ParseFieldHeader(line_start,line_end,h,true)) {line_start = value_start;continue;}
+
+        bool quitParsing = false;
+        const int numArrayElements = h.numArrayElements;
+        switch (h.ft)
+        {
+        case ImGui::FT_STRING:
+        {
+            const size_t len = StringValueLength(h,value_start,end);
+            textBuffer.resize((int)len+1);
+            memcpy(textBuffer.Data,value_start,len);textBuffer[(int)len]='\0';
+            quitParsing = cb(h.ft,(int)len,(void*)textBuffer.Data,h.varName);
+            line_start = NextLine(value_start+len,end);
+        }
+        break;
+        case ImGui::FT_CUSTOM:
+        case ImGui::FT_TEXTLINE:
+        {
+            // served once per line
+            line_start = value_start;
+            for (int i=0;i<numArrayElements && line_start<end;i++)
+            {
+                line_end = LineEnd(line_start,end);
+                const int len = (int)(line_end-line_start);
+                if (len==0) break;
+                textBuffer.resize(len+1);
+                memcpy(textBuffer.Data,line_start,len);textBuffer[len]='\0';
+                quitParsing = cb(h.ft,i,(void*)textBuffer.Data,h.varName);
+                line_start = NextLine(line_end,end);
+                if (quitParsing) break;
+            }
+        }
+        break;
+        default:
+        if (IsBinaryValue(value_start,end))
+        {
+            line_end = LineEnd(value_start,end);
+            if (ParseBinaryValue(h,value_start,line_end,binaryBuffer)) quitParsing = cb(h.ft,numArrayElements,(void*)binaryBuffer.Data,h.varName);
+            else fprintf(stderr,"Deserializer::parse(...) Error broken binary value to type:%d numArrayElements:%d varName:%s\n",(int)h.ft,numArrayElements,h.varName);  // dbg
+            line_start = NextLine(line_end,end);
+        }
+        else if (numArrayElements>4)
+        {
+            fprintf(stderr,"ImGuiHelper::Deserializer::parse(...) Error (wrong type detected): line:%s type:%d numArrayElements:%d varName:%s\n",h.name,(int)h.ft,numArrayElements,h.varName);
+            line_start = NextLine(LineEnd(value_start,end),end);
+        }
+        else
+        {
+            // numbers can be on the value line or after it, like sscanf(...) did
+            const char* p = value_start;
+            for (int i=0;i<numArrayElements && p;i++)
+            {
+                double d = 0;long long n = 0;
+                switch (h.ft)
+                {
+                case ImGui::FT_FLOAT:
+                case ImGui::FT_COLOR:   if ((p = ParseDouble(p,end,d))) value.f[i] = (float)d;break;
+                case ImGui::FT_DOUBLE:  p = ParseDouble(p,end,value.d[i]);break;
+                case ImGui::FT_UNSIGNED:if ((p = ParseInteger(p,end,n))) value.u[i] = (unsigned)n;break;
+                case ImGui::FT_BOOL:    if ((p = ParseInteger(p,end,n))) value.b[i] = n!=0;break;
+                default:                if ((p = ParseInteger(p,end,n))) value.i[i] = (int)n;break;
+                }
+            }
+            if (p) quitParsing = cb(h.ft,numArrayElements,(void*)&value,h.varName);
+            else fprintf(stderr,"Deserializer::parse(...) Error converting value:\"%.*s\" to type:%d numArrayElements:%d varName:%s\n",(int)(LineEnd(value_start,end)-value_start),value_start,(int)h.ft,numArrayElements,h.varName);  // dbg
+            line_start = NextLine(LineEnd(value_start,end),end);
+        }
+        break;
+        }
+
+        if (quitParsing) return line_start;
+    }
+    return end;
+}
+} // namespace DeserializerParser
+
+const char* Deserializer::parse(Deserializer::ParseCallback cb, void *userPtr, const char *optionalBufferStart) const
+{
+    if (!cb || !f_data || f_size==0) return NULL;
+    auto fieldCb = [cb,userPtr](FieldType ft,int numArrayElements,void* pValue,const char* name) {return cb(ft,numArrayElements,pValue,name,userPtr);};
+    return DeserializerParser::ParseFields(optionalBufferStart ? optionalBufferStart : f_data,getBufferEnd(),fieldCb);
+}
+
+int Deserializer::findSections(const char* sectionName, ImVector<const char*>& sectionStarts) const
+{
+    using namespace DeserializerParser;
+    sectionStarts.clear();
+    if (!sectionName || !f_data || f_size==0) return 0;
+    const char* buf_end = getBufferEnd();
+    FieldHeader h;
+    for (const char* line_start = f_data; line_start < buf_end; )
+    {
+        const char* line_end = LineEnd(line_start,buf_end);
+        const char* value_start = NextLine(line_end,buf_end);
+        if (!ParseFieldHeader(line_start,line_end,h,false)) {line_start = value_start;continue;}
+        // section 0 starts at the first field, values are skipped so that their text is never taken for a header
+        if (sectionStarts.empty() || strcmp(h.varName,sectionName)==0) sectionStarts.push_back(line_start);
+        line_start = SkipFieldValue(h,value_start,buf_end);
+    }
+    return sectionStarts.size();
+}
+
+int Deserializer::parseSections(const char* sectionName, Deserializer::SectionParseCallback cb, void *userPtr, int numThreads) const
+{
+    if (!cb) return 0;
+    ImVector<const char*> sectionStarts;
+    const int numSections = findSections(sectionName,sectionStarts);
+    if (numSections==0) return 0;
+    if (numThreads<=0) numThreads = (int)std::thread::hardware_concurrency();
+    numThreads = ImClamp(numThreads,1,numSections);
+    const char* buf_end = getBufferEnd();
+    std::atomic<int> nextSection(0);
+    auto worker = [&]() {
+        for (int section = nextSection++; section < numSections; section = nextSection++)
+        {
+            auto fieldCb = [cb,userPtr,section](FieldType ft,int numArrayElements,void* pValue,const char* name) {return cb(ft,numArrayElements,pValue,name,section,userPtr);};
+            DeserializerParser::ParseFields(sectionStarts[section],section+1<numSections ? sectionStarts[section+1] : buf_end,fieldCb);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i=1;i<numThreads;i++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+    return numSections;
+}
+
+bool GetFileContent(const char *filePath, ImVector<char> &contentOut, bool clearContentOutBeforeUsage, const char *modes, bool appendTrailingZeroIfModesIsNotBinary)
+{
+    ImVector<char>& f_data = contentOut;
+    if (clearContentOutBeforeUsage) f_data.clear();
+//----------------------------------------------------
+    if (!filePath) return false;
+    const bool appendTrailingZero = appendTrailingZeroIfModesIsNotBinary && modes && strlen(modes)>0 && modes[strlen(modes)-1]!='b';
+    FILE* f;
+    if ((f = (FILE *)ImFileOpen(filePath, modes)) == NULL) return false;
+    if (fseek(f, 0, SEEK_END))
+    {
+        fclose(f);
+        return false;
+    }
+    const long f_size_signed = ftell(f);
+    if (f_size_signed == -1)
+    {
+        fclose(f);
+        return false;
+    }
+    size_t f_size = (size_t)f_size_signed;
+    if (fseek(f, 0, SEEK_SET))
+    {
+        fclose(f);
+        return false;
+    }
+    f_data.resize(f_size+(appendTrailingZero?1:0));
     const size_t f_size_read = f_size>0 ? fread(&f_data[0], 1, f_size, f) : 0;
     fclose(f);
     if (f_size_read == 0 || f_size_read!=f_size)    return false;
@@ -2028,6 +2697,7 @@ public:
     virtual void close()=0;
     virtual bool isValid() const=0;
     virtual int print(const char* fmt, ...)=0;
+    virtual bool write(const char* data, size_t size)=0;
     virtual int getTypeID() const=0;
 };
 class SerializeToFile : public ISerializable
@@ -2054,6 +2724,7 @@ public:
         va_end(args);
         return rv;
     }
+    bool write(const char* data, size_t size) {return fwrite(data,1,size,f)==size;}
     int getTypeID() const {return 0;}
 protected:
     FILE* f;
@@ -2081,13 +2752,21 @@ public:
 
         const int startSz = b.size();
         b.resize(startSz+additionalSize);
-        const int rv = vsnprintf(&b[startSz-1],additionalSize,fmt,args2);
+        const int rv = vsnprintf(&b[startSz-1],additionalSize+1,fmt,args2);   // +1: the '\0' goes where b ends
         va_end(args2);
         //IM_ASSERT(additionalSize==rv);
         //IM_ASSERT(v[startSz+additionalSize-1]=='\0');
 
         return rv;
     }
+    bool write(const char* data, size_t size)
+    {
+        const int startSz = b.size();
+        b.resize(startSz+(int)size);
+        memcpy(&b[startSz-1],data,size);
+        b[b.size()-1]='\0';
+        return true;
+    }
     inline const char* getBuffer() const {return b.size()>0 ? &b[0] : NULL;}
     inline int getBufferSize() const {return b.size();}
     int getTypeID() const {return 1;}
@@ -2177,6 +2856,39 @@ bool Serializer::save(const unsigned* pValue,const char* name,int numArrayElemen
     if (prec==0) prec=-1;
     return SaveTemplate<unsigned>(f,ImGui::FT_UNSIGNED,pValue,name,numArrayElements,prec);
 }
+static bool SaveBinaryTemplate(ISerializable* f,FieldType ft,const void* pValue,size_t elementSize,const char* name,int numArrayElements)
+{
+    if (!f || !pValue || !name || name[0]=='\0' || numArrayElements<=0 || (size_t)numArrayElements>(size_t)INT_MAX/elementSize) return false;
+    const size_t numBytes = elementSize*(size_t)numArrayElements;
+    // name
+    f->print( "[%s",FieldTypeNames[ft]);
+    if (numArrayElements>1) f->print( "-%d",numArrayElements);
+    f->print( ":%s]\n",name);
+    // value
+    f->print("#B85 %u %u ",(unsigned)numBytes,(unsigned)ImHashData(pValue,numBytes,0));
+    ImGui::ImBase85Encoder encoder([f](const char* data, size_t size) {return f->write(data,size);},ImMin(numBytes*2,(size_t)64*1024));
+    const bool ok = encoder.push((const char*)pValue,numBytes) && encoder.finish();
+    f->print("\n\n");
+    return ok;
+}
+bool Serializer::saveBinary(FieldType ft, const float* pValue, const char* name, int numArrayElements)
+{
+    IM_ASSERT(ft==ImGui::FT_FLOAT || ft==ImGui::FT_COLOR);
+    return SaveBinaryTemplate(f,ft,pValue,sizeof(float),name,numArrayElements);
+}
+bool Serializer::saveBinary(FieldType ft, const int* pValue, const char* name, int numArrayElements)
+{
+    IM_ASSERT(ft==ImGui::FT_INT || ft==ImGui::FT_ENUM);
+    return SaveBinaryTemplate(f,ft,pValue,sizeof(int),name,numArrayElements);
+}
+bool Serializer::saveBinary(const unsigned* pValue, const char* name, int numArrayElements)
+{
+    return SaveBinaryTemplate(f,ImGui::FT_UNSIGNED,pValue,sizeof(unsigned),name,numArrayElements);
+}
+bool Serializer::saveBinary(const double* pValue, const char* name, int numArrayElements)
+{
+    return SaveBinaryTemplate(f,ImGui::FT_DOUBLE,pValue,sizeof(double),name,numArrayElements);
+}
 bool Serializer::save(const char* pValue,const char* name,int pValueSize)
 {
     FieldType ft = ImGui::FT_STRING;
@@ -2801,314 +3513,52 @@ std::string MillisecToString(int64_t millisec, int show_millisec)
 }
 } //namespace ImGuiHelper
 
-namespace base64 
-{
-// Decoder here
-extern "C"
-{
-typedef enum {step_a, step_b, step_c, step_d} base64_decodestep;
-typedef struct {base64_decodestep step;char plainchar;} base64_decodestate;
-
-inline int base64_decode_value(char value_in)
-{
-	static const char decoding[] = {62,-1,-1,-1,63,52,53,54,55,56,57,58,59,60,61,-1,-1,-1,-2,-1,-1,-1,0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,-1,-1,-1,-1,-1,-1,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51};
-	static const char decoding_size = sizeof(decoding);
-	value_in -= 43;
-	if (value_in < 0 || value_in > decoding_size) return -1;
-	return decoding[(int)value_in];
-}
-inline void base64_init_decodestate(base64_decodestate* state_in)
-{
-	state_in->step = step_a;
-	state_in->plainchar = 0;
-}
-inline int base64_decode_block(const char* code_in, const int length_in, char* plaintext_out, base64_decodestate* state_in)
-{
-	const char* codechar = code_in;
-	char* plainchar = plaintext_out;
-	char fragment;
-	
-	*plainchar = state_in->plainchar;
-	
-	switch (state_in->step)
-	{
-		while (1)
-		{
-        case step_a:
-			do
-            {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_a;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar    = (fragment & 0x03f) << 2;
-        case step_b:
-			do
-            {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_b;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar++ |= (fragment & 0x030) >> 4;
-			*plainchar    = (fragment & 0x00f) << 4;
-        case step_c:
-			do
-            {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_c;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar++ |= (fragment & 0x03c) >> 2;
-			*plainchar    = (fragment & 0x003) << 6;
-        case step_d:
-			do
-            {
-				if (codechar == code_in+length_in)
-				{
-					state_in->step = step_d;
-					state_in->plainchar = *plainchar;
-					return plainchar - plaintext_out;
-				}
-				fragment = (char)base64_decode_value(*codechar++);
-			} while (fragment < 0);
-			*plainchar++   |= (fragment & 0x03f);
-		}
-	}
-	/* control should not reach here */
-	return plainchar - plaintext_out;
-}
-}	// extern "C"
-struct decoder
-{
-	base64_decodestate _state;
-	int _buffersize;
-	
-	decoder(int buffersize_in = 4096) : _buffersize(buffersize_in) {}
-	int decode(char value_in) {return base64_decode_value(value_in);}
-	int decode(const char* code_in, const int length_in, char* plaintext_out)	{return base64_decode_block(code_in, length_in, plaintext_out, &_state);}
-};
-
-// Encoder Here
-extern "C"
-{
-typedef enum {step_A, step_B, step_C} base64_encodestep;
-typedef struct {base64_encodestep step;char result;int stepcount;} base64_encodestate;
-
-const int CHARS_PER_LINE = 2147483647;//72; // This was hard coded to 72 originally. But here we add '\n' at a later step. So we use MAX_INT here.
-inline void base64_init_encodestate(base64_encodestate* state_in)
+namespace ImGui
 {
-	state_in->step = step_A;
-	state_in->result = 0;
-	state_in->stepcount = 0;
-}
-inline char base64_encode_value(char value_in)
+namespace Stringifier
 {
-	static const char* encoding = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-	if (value_in > 63) return '=';
-	return encoding[(int)value_in];
-}
-inline int base64_encode_block(const char* plaintext_in, int length_in, char* code_out, base64_encodestate* state_in)
+template <typename VectorChar> static ImCodecSink AppendSink(VectorChar& output)
 {
-	const char* plainchar = plaintext_in;
-	const char* const plaintextend = plaintext_in + length_in;
-	char* codechar = code_out;
-    char result = '\0';
-    char fragment = '\0';
-	
-	result = state_in->result;
-	
-	switch (state_in->step)
-	{
-		while (1)
-		{
-        case step_A:
-			if (plainchar == plaintextend)
-			{
-				state_in->result = result;
-				state_in->step = step_A;
-				return codechar - code_out;
-			}
-			fragment = *plainchar++;
-			result = (fragment & 0x0fc) >> 2;
-			*codechar++ = base64_encode_value(result);
-			result = (fragment & 0x003) << 4;
-        case step_B:
-			if (plainchar == plaintextend)
-			{
-				state_in->result = result;
-				state_in->step = step_B;
-				return codechar - code_out;
-			}
-			fragment = *plainchar++;
-			result |= (fragment & 0x0f0) >> 4;
-			*codechar++ = base64_encode_value(result);
-			result = (fragment & 0x00f) << 2;
-        case step_C:
-			if (plainchar == plaintextend)
-			{
-				state_in->result = result;
-				state_in->step = step_C;
-				return codechar - code_out;
-			}
-			fragment = *plainchar++;
-			result |= (fragment & 0x0c0) >> 6;
-			*codechar++ = base64_encode_value(result);
-			result  = (fragment & 0x03f) >> 0;
-			*codechar++ = base64_encode_value(result);
-			
-			++(state_in->stepcount);
-			if (state_in->stepcount == CHARS_PER_LINE/4)
-			{
-				*codechar++ = '\n';
-				state_in->stepcount = 0;
-			}
-		}
-	}
-	/* control should not reach here */
-	return codechar - code_out;
+    return [&output](const char* data, size_t size)
+    {
+        const int start = output.size();
+        output.resize(start + (int)size);
+        memcpy(&output[start], data, size);
+        return true;
+    };
 }
 
-inline int base64_encode_blockend(char* code_out, base64_encodestate* state_in)
-{
-	char* codechar = code_out;
-	
-	switch (state_in->step)
-	{
-	case step_B:
-		*codechar++ = base64_encode_value(state_in->result);
-		*codechar++ = '=';
-		*codechar++ = '=';
-		break;
-	case step_C:
-		*codechar++ = base64_encode_value(state_in->result);
-		*codechar++ = '=';
-		break;
-	case step_A:
-		break;
-	}
-	*codechar++ = '\n';
-	
-	return codechar - code_out;
-}	
-} // extern "C"
-struct encoder
-{
-	base64_encodestate _state;
-	int _buffersize;
-	
-	encoder(int buffersize_in = 4096)
-	: _buffersize(buffersize_in)
-	{}
-	int encode(char value_in)
-	{
-		return base64_encode_value(value_in);
-	}
-	int encode(const char* code_in, const int length_in, char* plaintext_out)
-	{
-		return base64_encode_block(code_in, length_in, plaintext_out, &_state);
-	}
-	int encode_end(char* plaintext_out)
-	{
-		return base64_encode_blockend(plaintext_out, &_state);
-	}
-};
-} // namespace base64
-
-namespace ImGui
-{
-namespace Stringifier
-{
 template <typename VectorChar> static bool Base64Decode(const char* input,VectorChar& output)
 {
     output.clear();if (!input) return false;
-    const int N = 4096;
-    base64::decoder d(N);
-    base64_init_decodestate(&d._state);
-
-    int outputStart=0,outputlength = 0;
-    int codelength = strlen(input);
-    const char* pIn = input;
-    int stepCodeLength = 0;
-    do
-    {
-        output.resize(outputStart+N);
-        stepCodeLength = codelength>=N?N:codelength;
-        outputlength = d.decode(pIn, stepCodeLength, &output[outputStart]);
-        outputStart+=outputlength;
-        pIn+=stepCodeLength;
-        codelength-=stepCodeLength;
-    }
-    while (codelength>0);
-
-    output.resize(outputStart);
-    //
-    base64_init_decodestate(&d._state);
-    return true;
+    const size_t codelength = strlen(input);
+    output.reserve((int)(codelength / 4 * 3 + 3));
+    ImBase64Decoder d(AppendSink(output));
+    d.push(input, codelength);
+    return d.finish();
 }
 
 template <typename VectorChar> static bool Base64Encode(const char* input,int inputSize,VectorChar& output)
 {
 	output.clear();if (!input || inputSize==0) return false;
 
-    const int N=4096;
-    base64::encoder e(N);
-    base64_init_encodestate(&e._state);
-
-    int outputStart=0,outputlength = 0;
-    int codelength = inputSize;
-    const char* pIn = input;
-    int stepCodeLength = 0;
-
-    do
-    {
-        output.resize(outputStart+2*N);
-        stepCodeLength = codelength>=N?N:codelength;
-        outputlength = e.encode(pIn, stepCodeLength,&output[outputStart]);
-        outputStart+=outputlength;
-        pIn+=stepCodeLength;
-        codelength-=stepCodeLength;
-    }
-    while (codelength>0);
-
-    output.resize(outputStart+2*N);
-    outputlength = e.encode_end(&output[outputStart]);
-    outputStart+=outputlength;
-    output.resize(outputStart);
-    //
-    base64_init_encodestate(&e._state);
+    output.reserve((inputSize + 2) / 3 * 4 + 1);
+    ImBase64Encoder e(AppendSink(output));
+    e.push(input, inputSize);
+    if (!e.finish()) return false;
+    output.push_back('\n');
 
 	return true;
 }
 inline static unsigned int Decode85Byte(char c)   { return c >= '\\' ? c-36 : c-35; }
-static void Decode85(const unsigned char* src, unsigned char* dst)
-{
-    while (*src)
-    {
-        unsigned int tmp = Decode85Byte(src[0]) + 85*(Decode85Byte(src[1]) + 85*(Decode85Byte(src[2]) + 85*(Decode85Byte(src[3]) + 85*Decode85Byte(src[4]))));
-        dst[0] = ((tmp >> 0) & 0xFF); dst[1] = ((tmp >> 8) & 0xFF); dst[2] = ((tmp >> 16) & 0xFF); dst[3] = ((tmp >> 24) & 0xFF);   // We can't assume little-endianness.
-        src += 5;
-        dst += 4;
-    }
-}
 template <typename VectorChar> static bool Base85Decode(const char* input,VectorChar& output)
 {
 	output.clear();if (!input) return false;
-	const int outputSize = (((int)strlen(input) + 4) / 5) * 4;
-	output.resize(outputSize);
-    Decode85((const unsigned char*)input,(unsigned char*)&output[0]);
-    return true;
+	const size_t codelength = strlen(input);
+	output.reserve((int)((codelength + 4) / 5 * 4));
+	ImBase85Decoder d(AppendSink(output));
+	d.push(input, codelength);
+	return d.finish();
 }
 
 inline static char Encode85Byte(unsigned int x)
@@ -3120,13 +3570,23 @@ template <typename VectorChar> static bool Base85Encode(const char* input,int in
 {
     // Adapted from binary_to_compressed_c(...) inside imgui_draw.cpp
     output.clear();if (!input || inputSize==0) return false;
+    if (!outputStringifiedMode)
+    {
+        output.reserve((inputSize + 3) / 4 * 5 + 1);
+        ImBase85Encoder e(AppendSink(output));
+        e.push(input, inputSize);
+        if (!e.finish()) return false;
+        output.push_back('\0');	// End character
+        return true;
+    }
     output.reserve((int)((float)inputSize*1.3f));
     if (numCharsPerLineInStringifiedMode<=12) numCharsPerLineInStringifiedMode = 12;
     if (outputStringifiedMode) output.push_back('"');
     char prev_c = 0;int cnt=0;
     for (int src_i = 0; src_i < inputSize; src_i += 4)
     {
-        unsigned int d = *(unsigned int*)(input + src_i);
+        unsigned int d = 0;
+        memcpy(&d, input + src_i, inputSize - src_i < 4 ? inputSize - src_i : 4);
         for (unsigned int n5 = 0; n5 < 5; n5++, d /= 85)
         {
             char c = Encode85Byte(d);
@@ -3160,6 +3620,439 @@ template <typename VectorChar> static bool Base85Encode(const char* input,int in
 }
 } // namespace Stringifier
 
+// Streaming codecs
+#define CODEC_STORE_SLACK 32    // SIMD stores of decoders may write this much past the output
+
+static const char Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct CodecTables
+{
+    signed char base64[256];    // -1 out of alphabet
+    signed char base85[256];
+    CodecTables()
+    {
+        memset(base64, -1, sizeof(base64));
+        memset(base85, -1, sizeof(base85));
+        for (int i = 0; i < 64; i++) base64[(unsigned char)Base64Alphabet[i]] = (signed char)i;
+        for (int c = 35; c <= 120; c++) if (c != '\\') base85[c] = (signed char)Stringifier::Decode85Byte((char)c);
+    }
+};
+static const CodecTables s_codec_tables;
+
+static inline void Base64EncodeTriple(const unsigned char* s, char* d)
+{
+    const unsigned int v = ((unsigned int)s[0] << 16) | ((unsigned int)s[1] << 8) | s[2];
+    d[0] = Base64Alphabet[v >> 18];
+    d[1] = Base64Alphabet[(v >> 12) & 63];
+    d[2] = Base64Alphabet[(v >> 6) & 63];
+    d[3] = Base64Alphabet[v & 63];
+}
+
+// W. Mula and D. Lemire, Faster Base64 Encoding and Decoding using AVX2 Instructions:
+// 12 bytes of every 128 bit lane are spread to 16 6 bit indices, which are turned to ascii by
+// adding an offset picked with pshufb. Decoding validates every byte with two nibble lookups.
+#if __SSSE3__
+static inline __m128i Base64EncodeSSE(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t0, t1);
+    __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    reduced = _mm_or_si128(reduced, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(shift, reduced), indices);
+}
+
+static inline bool Base64DecodeSSE(const char* src, unsigned char* dst)
+{
+    const __m128i in = _mm_loadu_si128((const __m128i *)src);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask_2f));
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xffff)
+        return false;
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2f), hi_nibbles));
+    __m128i out = _mm_maddubs_epi16(_mm_add_epi8(in, roll), _mm_set1_epi32(0x01400140));
+    out = _mm_madd_epi16(out, _mm_set1_epi32(0x00011000));
+    out = _mm_shuffle_epi8(out, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i *)dst, out);
+    return true;
+}
+#endif // __SSSE3__
+
+#if __AVX2__
+static inline __m256i Base64EncodeAVX2(__m256i in)
+{
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+    const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(t0, t1);
+    __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    reduced = _mm256_or_si256(reduced, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+    const __m256i shift = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                           'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(shift, reduced), indices);
+}
+
+static inline bool Base64DecodeAVX2(const char* src, unsigned char* dst)
+{
+    const __m256i in = _mm256_loadu_si256((const __m256i *)src);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+    const __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(in, mask_2f));
+    const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    if (!_mm256_testz_si256(lo, hi))
+        return false;
+    const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask_2f), hi_nibbles));
+    __m256i out = _mm256_maddubs_epi16(_mm256_add_epi8(in, roll), _mm256_set1_epi32(0x01400140));
+    out = _mm256_madd_epi16(out, _mm256_set1_epi32(0x00011000));
+    out = _mm256_shuffle_epi8(out, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    out = _mm256_permutevar8x32_epi32(out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_storeu_si256((__m256i *)dst, out);
+    return true;
+}
+#endif // __AVX2__
+
+#if __ARM_NEON
+// 48 bytes are deinterleaved to 4 x 16 indices, ascii is index plus offsets of alphabet ranges
+static inline uint8x16_t Base64EncodeNEON(uint8x16_t i)
+{
+    uint8x16_t c = vaddq_u8(i, vdupq_n_u8('A'));
+    c = vaddq_u8(c, vandq_u8(vcgeq_u8(i, vdupq_n_u8(26)), vdupq_n_u8('a' - 26 - 'A')));
+    c = vsubq_u8(c, vandq_u8(vcgeq_u8(i, vdupq_n_u8(52)), vdupq_n_u8('a' - 26 - '0' + 52)));
+    c = vsubq_u8(c, vandq_u8(vcgeq_u8(i, vdupq_n_u8(62)), vdupq_n_u8('0' - 52 - '+' + 62)));
+    c = vaddq_u8(c, vandq_u8(vcgeq_u8(i, vdupq_n_u8(63)), vdupq_n_u8('/' - 63 - '+' + 62)));
+    return c;
+}
+
+static inline uint8x16_t Base64DecodeNEON(uint8x16_t c, uint8x16_t& valid)
+{
+    const uint8x16_t upper = vsubq_u8(c, vdupq_n_u8('A'));
+    const uint8x16_t lower = vsubq_u8(c, vdupq_n_u8('a'));
+    const uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+    const uint8x16_t is_upper = vcltq_u8(upper, vdupq_n_u8(26));
+    const uint8x16_t is_lower = vcltq_u8(lower, vdupq_n_u8(26));
+    const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+    const uint8x16_t is_plus = vceqq_u8(c, vdupq_n_u8('+'));
+    const uint8x16_t is_slash = vceqq_u8(c, vdupq_n_u8('/'));
+    uint8x16_t v = vandq_u8(is_upper, upper);
+    v = vorrq_u8(v, vandq_u8(is_lower, vaddq_u8(lower, vdupq_n_u8(26))));
+    v = vorrq_u8(v, vandq_u8(is_digit, vaddq_u8(digit, vdupq_n_u8(52))));
+    v = vorrq_u8(v, vandq_u8(is_plus, vdupq_n_u8(62)));
+    v = vorrq_u8(v, vandq_u8(is_slash, vdupq_n_u8(63)));
+    valid = vandq_u8(valid, vorrq_u8(vorrq_u8(vorrq_u8(is_upper, is_lower), vorrq_u8(is_digit, is_plus)), is_slash));
+    return v;
+}
+#endif // __ARM_NEON
+
+// size is multiple of 3, returns written characters
+static size_t Base64EncodeBlocks(const unsigned char* src, size_t size, char* dst)
+{
+    size_t i = 0;
+    char* d = dst;
+#if __AVX2__
+    for (; i + 28 <= size; i += 24, d += 32)
+    {
+        const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(src + i))),
+                                                   _mm_loadu_si128((const __m128i *)(src + i + 12)), 1);
+        _mm256_storeu_si256((__m256i *)d, Base64EncodeAVX2(in));
+    }
+#endif
+#if __SSSE3__
+    for (; i + 16 <= size; i += 12, d += 16)
+        _mm_storeu_si128((__m128i *)d, Base64EncodeSSE(_mm_loadu_si128((const __m128i *)(src + i))));
+#elif __ARM_NEON
+    for (; i + 48 <= size; i += 48, d += 64)
+    {
+        const uint8x16_t mask = vdupq_n_u8(63);
+        uint8x16x3_t in = vld3q_u8(src + i);
+        uint8x16x4_t out;
+        out.val[0] = Base64EncodeNEON(vshrq_n_u8(in.val[0], 2));
+        out.val[1] = Base64EncodeNEON(vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask));
+        out.val[2] = Base64EncodeNEON(vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask));
+        out.val[3] = Base64EncodeNEON(vandq_u8(in.val[2], mask));
+        vst4q_u8((uint8_t *)d, out);
+    }
+#endif
+    for (; i < size; i += 3, d += 4)
+        Base64EncodeTriple(src + i, d);
+    return d - dst;
+}
+
+// decodes whole blocks up to first block with a character out of alphabet, returns used characters
+static size_t Base64DecodeBlocks(const char* src, size_t size, unsigned char* dst, size_t& written)
+{
+    size_t i = 0;
+    unsigned char* d = dst;
+#if __AVX2__
+    for (; i + 32 <= size && Base64DecodeAVX2(src + i, d); i += 32, d += 24) {}
+#endif
+#if __SSSE3__
+    for (; i + 16 <= size && Base64DecodeSSE(src + i, d); i += 16, d += 12) {}
+#elif __ARM_NEON
+    for (; i + 64 <= size; i += 64, d += 48)
+    {
+        uint8x16_t valid = vdupq_n_u8(0xff);
+        uint8x16x4_t in = vld4q_u8((const uint8_t *)src + i);
+        const uint8x16_t a = Base64DecodeNEON(in.val[0], valid);
+        const uint8x16_t b = Base64DecodeNEON(in.val[1], valid);
+        const uint8x16_t c = Base64DecodeNEON(in.val[2], valid);
+        const uint8x16_t e = Base64DecodeNEON(in.val[3], valid);
+        const uint64x2_t valid64 = vreinterpretq_u64_u8(valid);
+        if ((vgetq_lane_u64(valid64, 0) & vgetq_lane_u64(valid64, 1)) != ~(uint64_t)0)
+            break;
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(a, 2), vshrq_n_u8(b, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(b, 4), vshrq_n_u8(c, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(c, 6), e);
+        vst3q_u8(d, out);
+    }
+#endif
+    const signed char* table = s_codec_tables.base64;
+    for (; i + 4 <= size; i += 4, d += 3)
+    {
+        const int a = table[(unsigned char)src[i]], b = table[(unsigned char)src[i + 1]];
+        const int c = table[(unsigned char)src[i + 2]], e = table[(unsigned char)src[i + 3]];
+        if ((a | b | c | e) < 0) break;
+        const unsigned int v = ((unsigned int)a << 18) | ((unsigned int)b << 12) | ((unsigned int)c << 6) | (unsigned int)e;
+        d[0] = (unsigned char)(v >> 16); d[1] = (unsigned char)(v >> 8); d[2] = (unsigned char)v;
+    }
+    written = d - dst;
+    return i;
+}
+
+ImCodecStream::ImCodecStream(const ImCodecSink& _sink, size_t bufferSize)
+    : sink(_sink), capacity(bufferSize < 256 ? 256 : bufferSize)
+{
+    buffer.resize(capacity + CODEC_STORE_SLACK);
+}
+
+bool ImCodecStream::flush()
+{
+    if (used > 0 && !error && sink && !sink(buffer.data(), used))
+        error = true;
+    total_out += used;
+    used = 0;
+    return !error;
+}
+
+bool ImBase64Encoder::push(const char* data, size_t size)
+{
+    if (error) return false;
+    total_in += size;
+    const unsigned char* src = (const unsigned char*)data;
+    while (pending > 0 && size > 0)
+    {
+        tail[pending++] = *src++;
+        size--;
+        if (pending == 3)
+        {
+            if (space() < 4 && !flush()) return false;
+            Base64EncodeTriple(tail, &buffer[used]);
+            used += 4;
+            pending = 0;
+        }
+    }
+    while (size >= 3)
+    {
+        if (space() < 4 && !flush()) return false;
+        const size_t n = std::min(size / 3, space() / 4) * 3;
+        used += Base64EncodeBlocks(src, n, &buffer[used]);
+        src += n;
+        size -= n;
+    }
+    for (; size > 0; size--) tail[pending++] = *src++;
+    return true;
+}
+
+bool ImBase64Encoder::finish()
+{
+    if (error) return false;
+    if (pending > 0)
+    {
+        if (space() < 4 && !flush()) return false;
+        unsigned char last[3] = {tail[0], pending > 1 ? tail[1] : (unsigned char)0, 0};
+        Base64EncodeTriple(last, &buffer[used]);
+        buffer[used + 3] = '=';
+        if (pending == 1) buffer[used + 2] = '=';
+        used += 4;
+        pending = 0;
+    }
+    return flush();
+}
+
+bool ImBase64Decoder::push(const char* data, size_t size)
+{
+    if (error) return false;
+    total_in += size;
+    while (size > 0)
+    {
+        if (space() < 64 && !flush()) return false;
+        if (pending == 0)
+        {
+            size_t written = 0;
+            const size_t n = Base64DecodeBlocks(data, std::min(size, space() / 3 * 4), (unsigned char*)&buffer[used], written);
+            data += n;
+            size -= n;
+            used += written;
+            if (space() < 64) continue;
+        }
+        // characters out of alphabet and what is left after SIMD blocks, back to SIMD once
+        // skipped characters are behind and a quad is complete
+        const size_t n = std::min(size, (size_t)64);
+        bool skipped = false;
+        size_t i = 0;
+        while (i < n)
+        {
+            const int v = s_codec_tables.base64[(unsigned char)data[i++]];
+            if (v < 0) { skipped = true; continue; }
+            quad = (quad << 6) | (unsigned int)v;
+            if (++pending == 4)
+            {
+                buffer[used++] = (char)(quad >> 16);
+                buffer[used++] = (char)(quad >> 8);
+                buffer[used++] = (char)quad;
+                pending = 0;
+                if (skipped) break;
+            }
+        }
+        data += i;
+        size -= i;
+    }
+    return true;
+}
+
+bool ImBase64Decoder::finish()
+{
+    if (error) return false;
+    if (space() < 2 && !flush()) return false;
+    if (pending == 2)
+        buffer[used++] = (char)(quad >> 4);
+    else if (pending == 3)
+    {
+        buffer[used++] = (char)(quad >> 10);
+        buffer[used++] = (char)(quad >> 2);
+    }
+    pending = 0;
+    return flush();
+}
+
+static inline void Base85EncodeWord(const unsigned char* s, char* d)
+{
+    unsigned int v = (unsigned int)s[0] | ((unsigned int)s[1] << 8) | ((unsigned int)s[2] << 16) | ((unsigned int)s[3] << 24);
+    for (int k = 0; k < 5; k++, v /= 85)
+        d[k] = Stringifier::Encode85Byte(v);
+}
+
+bool ImBase85Encoder::push(const char* data, size_t size)
+{
+    if (error) return false;
+    total_in += size;
+    const unsigned char* src = (const unsigned char*)data;
+    while (pending > 0 && size > 0)
+    {
+        tail[pending++] = *src++;
+        size--;
+        if (pending == 4)
+        {
+            if (space() < 5 && !flush()) return false;
+            Base85EncodeWord(tail, &buffer[used]);
+            used += 5;
+            pending = 0;
+        }
+    }
+    while (size >= 4)
+    {
+        if (space() < 5 && !flush()) return false;
+        const size_t n = std::min(size / 4, space() / 5);
+        char* d = &buffer[used];
+        for (size_t i = 0; i < n; i++, src += 4, d += 5)
+            Base85EncodeWord(src, d);
+        used += n * 5;
+        size -= n * 4;
+    }
+    for (; size > 0; size--) tail[pending++] = *src++;
+    return true;
+}
+
+bool ImBase85Encoder::finish()
+{
+    if (error) return false;
+    if (pending > 0)
+    {
+        // last word is padded with zeros, like Base85Encode(...) does
+        if (space() < 5 && !flush()) return false;
+        for (int k = pending; k < 4; k++) tail[k] = 0;
+        Base85EncodeWord(tail, &buffer[used]);
+        used += 5;
+        pending = 0;
+    }
+    return flush();
+}
+
+static inline void Base85DecodeGroup(const unsigned int* g, char* d)
+{
+    const unsigned int w = g[0] + 85 * (g[1] + 85 * (g[2] + 85 * (g[3] + 85 * g[4])));
+    d[0] = (char)w; d[1] = (char)(w >> 8); d[2] = (char)(w >> 16); d[3] = (char)(w >> 24);
+}
+
+bool ImBase85Decoder::push(const char* data, size_t size)
+{
+    if (error) return false;
+    total_in += size;
+    while (size > 0)
+    {
+        if (space() < 64 && !flush()) return false;
+        const size_t n = std::min(size, (size_t)80);
+        for (size_t i = 0; i < n; i++)
+        {
+            const int v = s_codec_tables.base85[(unsigned char)data[i]];
+            if (v < 0) continue;
+            group[pending++] = (unsigned int)v;
+            if (pending == 5)
+            {
+                Base85DecodeGroup(group, &buffer[used]);
+                used += 4;
+                pending = 0;
+            }
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool ImBase85Decoder::finish()
+{
+    if (error) return false;
+    if (pending > 0)
+    {
+        // a truncated group of n chars holds n - 1 bytes, its missing high digits are zero
+        if (space() < 4 && !flush()) return false;
+        for (int k = pending; k < 5; k++) group[k] = 0;
+        Base85DecodeGroup(group, &buffer[used]);
+        used += pending - 1;
+        pending = 0;
+    }
+    return flush();
+}
+
 bool Base64Encode(const char* input,int inputSize,ImVector<char>& output,bool stringifiedMode,int numCharsPerLineInStringifiedMode)
 {
     if (!stringifiedMode) return Stringifier::Base64Encode<ImVector<char> >(input,inputSize,output);
@@ -3323,26 +4216,218 @@ bool TextStringify(const char* input, ImVector<char>& output, int numCharsPerLin
 #include <zlib.h>
 namespace ImGui
 {
+ImGzEncoder::ImGzEncoder(const ImCodecSink& _sink, int level, size_t bufferSize) : ImCodecStream(_sink, bufferSize)
+{
+    z_stream* zs = new z_stream();
+    if (deflateInit2(zs, level, Z_DEFLATED, (16+MAX_WBITS), 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        delete zs;
+        error = true;
+        return;
+    }
+    stream = zs;
+}
+
+ImGzEncoder::~ImGzEncoder()
+{
+    if (stream)
+    {
+        deflateEnd((z_stream*)stream);
+        delete (z_stream*)stream;
+    }
+}
+
+bool ImGzEncoder::push(const char* data, size_t size)
+{
+    if (error || ended) return false;
+    total_in += size;
+    z_stream* zs = (z_stream*)stream;
+    while (size > 0)
+    {
+        const uInt n = (uInt)std::min(size, (size_t)1 << 30);
+        zs->next_in = (Bytef *)data;
+        zs->avail_in = n;
+        while (zs->avail_in > 0)
+        {
+            if (space() == 0 && !flush()) return false;
+            zs->next_out = (Bytef *)&buffer[used];
+            zs->avail_out = (uInt)space();
+            if (deflate(zs, Z_NO_FLUSH) == Z_STREAM_ERROR) { error = true; return false; }
+            used = capacity - zs->avail_out;
+        }
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool ImGzEncoder::finish()
+{
+    if (error) return false;
+    z_stream* zs = (z_stream*)stream;
+    zs->avail_in = 0;
+    while (!ended)
+    {
+        if (space() == 0 && !flush()) return false;
+        zs->next_out = (Bytef *)&buffer[used];
+        zs->avail_out = (uInt)space();
+        const int err = deflate(zs, Z_FINISH);
+        used = capacity - zs->avail_out;
+        if (err == Z_STREAM_END) ended = true;
+        else if (err != Z_OK && err != Z_BUF_ERROR) { error = true; return false; }
+    }
+    return flush();
+}
+
+ImGzDecoder::ImGzDecoder(const ImCodecSink& _sink, size_t bufferSize) : ImCodecStream(_sink, bufferSize)
+{
+    z_stream* zs = new z_stream();
+    if (inflateInit2(zs, (16+MAX_WBITS)) != Z_OK)
+    {
+        delete zs;
+        error = true;
+        return;
+    }
+    stream = zs;
+}
+
+ImGzDecoder::~ImGzDecoder()
+{
+    if (stream)
+    {
+        inflateEnd((z_stream*)stream);
+        delete (z_stream*)stream;
+    }
+}
+
+// inflates until input is used or a member ends, returns bytes used, 0 with error set on failure
+size_t ImGzDecoder::inflateInput(const char* data, size_t size)
+{
+    z_stream* zs = (z_stream*)stream;
+    const uInt n = (uInt)std::min(size, (size_t)1 << 30);
+    zs->next_in = (Bytef *)data;
+    zs->avail_in = n;
+    while (zs->avail_in > 0 && !ended)
+    {
+        if (space() == 0 && !flush()) return 0;
+        zs->next_out = (Bytef *)&buffer[used];
+        zs->avail_out = (uInt)space();
+        const int err = inflate(zs, Z_NO_FLUSH);
+        used = capacity - zs->avail_out;
+        if (err == Z_STREAM_END) ended = true;
+        else if (err != Z_OK && err != Z_BUF_ERROR) { error = true; return 0; }
+    }
+    return n - zs->avail_in;
+}
+
+bool ImGzDecoder::push(const char* data, size_t size)
+{
+    if (error) return false;
+    total_in += size;
+    while (size > 0 && !tail)
+    {
+        if (ended)
+        {
+            // another member starts with the gzip magic, anything else is trailing padding
+            const unsigned char* p = (const unsigned char*)data;
+            if (magic_split ? p[0] != 0x8b : (p[0] != 0x1f || (size > 1 && p[1] != 0x8b))) { tail = true; break; }
+            if (!magic_split && size == 1) { magic_split = true; break; }
+            if (inflateReset((z_stream*)stream) != Z_OK) { error = true; return false; }
+            ended = false;
+            if (magic_split)
+            {
+                static const char magic = (char)0x1f;
+                magic_split = false;
+                if (inflateInput(&magic, 1) == 0) return false;
+            }
+        }
+        const size_t n = inflateInput(data, size);
+        if (error) return false;
+        data += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool ImGzDecoder::finish()
+{
+    if (error) return false;
+    z_stream* zs = (z_stream*)stream;
+    zs->avail_in = 0;
+    // inflate may still hold output of the last input when buffer was full
+    while (!ended)
+    {
+        if (space() == 0 && !flush()) return false;
+        zs->next_out = (Bytef *)&buffer[used];
+        zs->avail_out = (uInt)space();
+        const int err = inflate(zs, Z_NO_FLUSH);
+        const bool progress = zs->avail_out != space();
+        used = capacity - zs->avail_out;
+        if (err == Z_STREAM_END) ended = true;
+        else if ((err != Z_OK && err != Z_BUF_ERROR) || !progress) { error = true; return false; }   // truncated stream
+    }
+    return flush();
+}
+
+// gzip trailer ends with uncompressed size modulo 2^32, deflate never expands more than 1032:1
+static size_t GzExpectedSize(const unsigned char* trailer, size_t compressedSize)
+{
+    const size_t isize = (size_t)trailer[0] | ((size_t)trailer[1] << 8) | ((size_t)trailer[2] << 16) | ((size_t)trailer[3] << 24);
+    return std::min(isize, compressedSize * 1032);
+}
+
+// pushes file content to stream in chunks, reserves rv for the gzip size when gzipped
+static bool StreamFile(const char* filePath, const char* modes, ImCodecStream& stream, ImVector<char>* gzReserve)
+{
+    if (!filePath) return false;
+    FILE* f;
+    if ((f = (FILE *)ImFileOpen(filePath, modes)) == NULL) return false;
+    unsigned char trailer[4];
+    if (gzReserve && fseek(f, -4, SEEK_END) == 0)
+    {
+        const long compressedSize = ftell(f) + 4;
+        if (fread(trailer, 1, 4, f) == 4)
+        {
+            const size_t expected = GzExpectedSize(trailer, (size_t)compressedSize);
+            if (expected < (size_t)(INT_MAX - gzReserve->size())) gzReserve->reserve(gzReserve->size() + (int)expected);
+        }
+    }
+    if (fseek(f, 0, SEEK_SET)) { fclose(f); return false; }
+    std::vector<char> chunk(256 * 1024);
+    bool ok = true;
+    size_t n;
+    while (ok && (n = fread(chunk.data(), 1, chunk.size(), f)) > 0)
+        ok = stream.push(chunk.data(), n);
+    ok = ok && !ferror(f);
+    fclose(f);
+    return ok && stream.finish();
+}
+
 bool GzDecompressFromFile(const char* filePath,ImVector<char>& rv,bool clearRvBeforeUsage)
 {
     if (clearRvBeforeUsage) rv.clear();
-    ImVector<char> f_data;
-    if (!ImGuiHelper::GetFileContent(filePath,f_data,true,"rb",false)) return false;
+    const int startRv = rv.size();
+    ImGzDecoder gz(Stringifier::AppendSink(rv));
     //----------------------------------------------------
-    return GzDecompressFromMemory(&f_data[0],f_data.size(),rv,clearRvBeforeUsage);
+    if (!StreamFile(filePath,"rb",gz,&rv)) { rv.resize(startRv); return false; }
+    return true;
     //----------------------------------------------------
 }
 bool GzBase64DecompressFromFile(const char* filePath,ImVector<char>& rv)
 {
-    ImVector<char> f_data;
-    if (!ImGuiHelper::GetFileContent(filePath,f_data,true,"r",true)) return false;
-    return ImGui::GzBase64DecompressFromMemory(&f_data[0],rv);
+    rv.clear();
+    ImGzDecoder gz(Stringifier::AppendSink(rv));
+    ImBase64Decoder b64([&gz](const char* data, size_t size) { return gz.push(data, size); });
+    if (!StreamFile(filePath,"rb",b64,NULL) || !gz.finish()) { rv.clear(); return false; }
+    return true;
 }
 bool GzBase85DecompressFromFile(const char* filePath,ImVector<char>& rv)
 {
-    ImVector<char> f_data;
-    if (!ImGuiHelper::GetFileContent(filePath,f_data,true,"r",true)) return false;
-    return ImGui::GzBase85DecompressFromMemory(&f_data[0],rv);
+    rv.clear();
+    ImGzDecoder gz(Stringifier::AppendSink(rv));
+    ImBase85Decoder b85([&gz](const char* data, size_t size) { return gz.push(data, size); });
+    if (!StreamFile(filePath,"rb",b85,NULL) || !gz.finish()) { rv.clear(); return false; }
+    return true;
 }
 
 bool GzDecompressFromMemory(const char* memoryBuffer,int memoryBufferSize,ImVector<char>& rv,bool clearRvBeforeUsage)
@@ -3351,33 +4436,46 @@ bool GzDecompressFromMemory(const char* memoryBuffer,int memoryBufferSize,ImVect
     const int startRv = rv.size();
 
     if (memoryBufferSize == 0  || !memoryBuffer) return false;
-    const int memoryChunk = memoryBufferSize > (16*1024) ? (16*1024) : memoryBufferSize;
-    rv.resize(startRv+memoryChunk);  // we start using the memoryChunk length
+    // output is sized from the gzip trailer, with a little room so inflate can reach the stream end
+    size_t expected = memoryBufferSize >= 18 ? GzExpectedSize((const unsigned char*)memoryBuffer + memoryBufferSize - 4, memoryBufferSize) : 0;
+    expected = std::min(std::max(expected + 64, (size_t)16*1024), (size_t)(INT_MAX - startRv));
+    rv.resize(startRv+(int)expected);
 
-    z_stream myZStream;
+    z_stream myZStream = {};
     myZStream.next_in = (Bytef *) memoryBuffer;
     myZStream.avail_in = memoryBufferSize;
-    myZStream.total_out = 0;
-    myZStream.zalloc = Z_NULL;
-    myZStream.zfree = Z_NULL;
 
     bool done = false;
+    size_t out = 0;
     if (inflateInit2(&myZStream, (16+MAX_WBITS)) == Z_OK)
     {
         int err = Z_OK;
         while (!done)
         {
-            if (myZStream.total_out >= (uLong)(rv.size()-startRv)) rv.resize(rv.size()+memoryChunk);    // not enough space: we add the memoryChunk each step
-
-            myZStream.next_out = (Bytef *) (&rv[startRv] + myZStream.total_out);
-            myZStream.avail_out = rv.size() - startRv - myZStream.total_out;
+            if (out == (size_t)(rv.size()-startRv))
+            {
+                // not enough space: output grows geometrically
+                const size_t grow = std::min(std::max(out / 2, (size_t)16*1024), (size_t)(INT_MAX - rv.size()));
+                if (grow == 0) break;
+                rv.resize(rv.size()+(int)grow);
+            }
+            myZStream.next_out = (Bytef *) (&rv[startRv] + out);
+            myZStream.avail_out = rv.size() - startRv - out;
+            const uInt avail_out = myZStream.avail_out;
 
-            if ((err = inflate (&myZStream, Z_SYNC_FLUSH))==Z_STREAM_END) done = true;
-            else if (err != Z_OK)  break;
+            err = inflate (&myZStream, Z_NO_FLUSH);
+            out += avail_out - myZStream.avail_out;
+            if (err == Z_STREAM_END)
+            {
+                // next gzip member starts with the magic, other trailing bytes are ignored
+                if (myZStream.avail_in < 2 || myZStream.next_in[0] != 0x1f || myZStream.next_in[1] != 0x8b) done = true;
+                else if (inflateReset(&myZStream) != Z_OK) break;
+            }
+            else if (err != Z_OK) break;
         }
         if ((err=inflateEnd(&myZStream))!= Z_OK) done = false;
     }
-    rv.resize(startRv+(done ? myZStream.total_out : 0));
+    rv.resize(startRv+(done ? (int)out : 0));
 
     return done;
 }
@@ -3387,50 +4485,59 @@ bool GzCompressFromMemory(const char* memoryBuffer,int memoryBufferSize,ImVector
     const int startRv = rv.size();
 
     if (memoryBufferSize == 0  || !memoryBuffer) return false;
-    const int memoryChunk = memoryBufferSize/3 > (16*1024) ? (16*1024) : memoryBufferSize/3;
-    rv.resize(startRv+memoryChunk);  // we start using the memoryChunk length
 
-    z_stream myZStream;
+    z_stream myZStream = {};
     myZStream.next_in =  (Bytef *) memoryBuffer;
     myZStream.avail_in = memoryBufferSize;
-    myZStream.total_out = 0;
-    myZStream.zalloc = Z_NULL;
-    myZStream.zfree = Z_NULL;
 
     bool done = false;
+    size_t out = 0;
     if (deflateInit2(&myZStream,Z_BEST_COMPRESSION,Z_DEFLATED,(16+MAX_WBITS),8,Z_DEFAULT_STRATEGY) == Z_OK)
     {
+        // deflateBound is enough for one deflate call
+        rv.resize(startRv+(int)std::min((size_t)deflateBound(&myZStream, memoryBufferSize), (size_t)(INT_MAX - startRv)));
         int err = Z_OK;
         while (!done)
         {
-            if (myZStream.total_out >= (uLong)(rv.size()-startRv)) rv.resize(rv.size()+memoryChunk);    // not enough space: we add the full memoryChunk each step
-
-            myZStream.next_out = (Bytef *) (&rv[startRv] + myZStream.total_out);
-            myZStream.avail_out = rv.size() - startRv - myZStream.total_out;
-
-            if ((err = deflate (&myZStream, Z_FINISH))==Z_STREAM_END) done = true;
-            else if (err != Z_OK)  break;
+            if (out == (size_t)(rv.size()-startRv))
+            {
+                const size_t grow = std::min(std::max(out / 2, (size_t)16*1024), (size_t)(INT_MAX - rv.size()));
+                if (grow == 0) break;
+                rv.resize(rv.size()+(int)grow);
+            }
+            myZStream.next_out = (Bytef *) (&rv[startRv] + out);
+            myZStream.avail_out = rv.size() - startRv - out;
+            const uInt avail_out = myZStream.avail_out;
+
+            err = deflate (&myZStream, Z_FINISH);
+            out += avail_out - myZStream.avail_out;
+            if (err == Z_STREAM_END) done = true;
+            else if (err != Z_OK && err != Z_BUF_ERROR) break;
         }
         if ((err=deflateEnd(&myZStream))!= Z_OK) done=false;
     }
-    rv.resize(startRv+(done ? myZStream.total_out : 0));
+    rv.resize(startRv+(done ? (int)out : 0));
 
     return done;
 }
 
 bool GzBase64DecompressFromMemory(const char* input,ImVector<char>& rv)
 {
-    rv.clear();ImVector<char> v;
-    if (ImGui::Base64Decode(input,v)) return false;
-    if (v.size()==0) return false;
-    return GzDecompressFromMemory(&v[0],v.size(),rv);
+    rv.clear();
+    if (!input) return false;
+    ImGzDecoder gz(Stringifier::AppendSink(rv));
+    ImBase64Decoder b64([&gz](const char* data, size_t size) { return gz.push(data, size); });
+    if (!b64.push(input, strlen(input)) || !b64.finish() || !gz.finish()) { rv.clear(); return false; }
+    return true;
 }
 bool GzBase85DecompressFromMemory(const char* input,ImVector<char>& rv)
 {
-    rv.clear();ImVector<char> v;
-    if (ImGui::Base85Decode(input,v)) return false;
-    if (v.size()==0) return false;
-    return GzDecompressFromMemory(&v[0],v.size(),rv);
+    rv.clear();
+    if (!input) return false;
+    ImGzDecoder gz(Stringifier::AppendSink(rv));
+    ImBase85Decoder b85([&gz](const char* data, size_t size) { return gz.push(data, size); });
+    if (!b85.push(input, strlen(input)) || !b85.finish() || !gz.finish()) { rv.clear(); return false; }
+    return true;
 }
 bool GzBase64CompressFromMemory(const char* input,int inputSize,ImVector<char>& output,bool stringifiedMode,int numCharsPerLineInStringifiedMode)
 {
@@ -10,6 +10,7 @@
 #include <memory>
 #include <mutex>
 #include <random>
+#include <limits>
 // the alignment of all the allocated buffers
 #if __AVX__
 #define IM_MALLOC_ALIGN 32
@@ -140,92 +141,67 @@ static inline unsigned short im_float32_to_float16(float value)
 
     tmp.f = value;
 
-    // 1 : 8 : 23
-    unsigned short sign = (tmp.u & 0x80000000) >> 31;
-    unsigned short exponent = (tmp.u & 0x7F800000) >> 23;
-    unsigned int significand = tmp.u & 0x7FFFFF;
+    // round to nearest even like F16C and gpu, fp16 denormals are kept
+    unsigned int sign = tmp.u & 0x80000000;
+    tmp.u ^= sign;
 
     // 1 : 5 : 10
     unsigned short fp16;
-    if (exponent == 0)
+    if (tmp.u >= 0x47800000)
     {
-        // zero or denormal, always underflow
-        fp16 = (sign << 15) | (0x00 << 10) | 0x00;
+        // overflow to infinity, or NaN
+        fp16 = tmp.u > 0x7F800000 ? 0x7E00 : 0x7C00;
     }
-    else if (exponent == 0xFF)
+    else if (tmp.u < 0x38800000)
     {
-        // infinity or NaN
-        fp16 = (sign << 15) | (0x1F << 10) | (significand ? 0x200 : 0x00);
+        // denormal or zero, float add rounds the significand into place
+        union
+        {
+            unsigned int u;
+            float f;
+        } denorm_magic;
+        denorm_magic.u = ((127 - 15) + (23 - 10) + 1) << 23;
+        tmp.f += denorm_magic.f;
+        fp16 = (unsigned short)(tmp.u - denorm_magic.u);
     }
     else
     {
-        // normalized
-        short newexp = exponent + (-127 + 15);
-        if (newexp >= 31)
-        {
-            // overflow, return infinity
-            fp16 = (sign << 15) | (0x1F << 10) | 0x00;
-        }
-        else if (newexp <= 0)
-        {
-            // Some normal fp32 cannot be expressed as normal fp16
-            fp16 = (sign << 15) | (0x00 << 10) | 0x00;
-        }
-        else
-        {
-            // normal fp16
-            fp16 = (sign << 15) | (newexp << 10) | (significand >> 13);
-        }
+        // normalized, rebias exponent and round
+        unsigned int mant_odd = (tmp.u >> 13) & 1;
+        tmp.u += ((unsigned int)(15 - 127) << 23) + 0xFFF;
+        tmp.u += mant_odd;
+        fp16 = (unsigned short)(tmp.u >> 13);
     }
 
-    return fp16;
+    return fp16 | (unsigned short)(sign >> 16);
 }
 
 static inline float im_float16_to_float32(unsigned short value)
 {
-    // 1 : 5 : 10
-    unsigned short sign = (value & 0x8000) >> 15;
-    unsigned short exponent = (value & 0x7c00) >> 10;
-    unsigned short significand = value & 0x03FF;
-
     // 1 : 8 : 23
     union
     {
         unsigned int u;
         float f;
-    } tmp;
-    if (exponent == 0)
-    {
-        if (significand == 0)
-        {
-            // zero
-            tmp.u = (sign << 31);
-        }
-        else
-        {
-            // denormal
-            exponent = 0;
-            // find non-zero bit
-            while ((significand & 0x200) == 0)
-            {
-                significand <<= 1;
-                exponent++;
-            }
-            significand <<= 1;
-            significand &= 0x3FF;
-            tmp.u = (sign << 31) | ((-exponent + (-15 + 127)) << 23) | (significand << 13);
-        }
-    }
-    else if (exponent == 0x1F)
+    } tmp, denorm_magic;
+
+    // 1 : 5 : 10, exponent and significand moved into place and rebiased
+    tmp.u = (unsigned int)(value & 0x7FFF) << 13;
+    unsigned int exponent = tmp.u & 0x0F800000;
+    tmp.u += (127 - 15) << 23;
+    if (exponent == 0x0F800000)
     {
         // infinity or NaN
-        tmp.u = (sign << 31) | (0xFF << 23) | (significand << 13);
+        tmp.u += (128 - 16) << 23;
     }
-    else
+    else if (exponent == 0)
     {
-        // normalized
-        tmp.u = (sign << 31) | ((exponent + (-15 + 127)) << 23) | (significand << 13);
+        // zero or denormal, renormalized by float subtract
+        denorm_magic.u = 113 << 23;
+        tmp.u += 1 << 23;
+        tmp.f -= denorm_magic.f;
     }
+    tmp.u |= (unsigned int)(value & 0x8000) << 16;
 
     return tmp.f;
 }
@@ -254,6 +230,121 @@ static inline float im_bfloat16_to_float32(unsigned short value)
     return tmp.f;
 }
 
+// bulk conversions of len elements, src and dst can not overlap
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define IM_F16C 1
+#endif
+#if __ARM_NEON && (defined(__aarch64__) || (__ARM_FP & 2))
+#define IM_NEON_FP16 1
+#endif
+static inline void im_float16_to_float32_n(float* dst, const unsigned short* src, size_t len)
+{
+    size_t i = 0;
+#if IM_F16C
+    for (; i + 8 <= len; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(src + i))));
+#elif IM_NEON_FP16
+    for (; i + 4 <= len; i += 4)
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+#endif
+    for (; i < len; i++) dst[i] = im_float16_to_float32(src[i]);
+}
+
+static inline void im_float32_to_float16_n(unsigned short* dst, const float* src, size_t len)
+{
+    size_t i = 0;
+#if IM_F16C
+    for (; i + 8 <= len; i += 8)
+        _mm_storeu_si128((__m128i *)(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#elif IM_NEON_FP16
+    for (; i + 4 <= len; i += 4)
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+#endif
+    for (; i < len; i++) dst[i] = im_float32_to_float16(src[i]);
+}
+
+static inline void im_bfloat16_to_float32_n(float* dst, const unsigned short* src, size_t len)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(__AVX__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= len; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(zero, v));
+        _mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(zero, v));
+    }
+#elif __ARM_NEON
+    for (; i + 4 <= len; i += 4)
+        vst1q_u32((uint32_t *)(dst + i), vshll_n_u16(vld1_u16(src + i), 16));
+#endif
+    for (; i < len; i++) dst[i] = im_bfloat16_to_float32(src[i]);
+}
+
+static inline void im_float32_to_bfloat16_n(unsigned short* dst, const float* src, size_t len)
+{
+    size_t i = 0;
+#if defined(__SSE2__) || defined(__AVX__)
+    for (; i + 8 <= len; i += 8)
+    {
+        // arithmetic shift keeps high halves in int16 range, pack does not saturate them
+        __m128i lo = _mm_srai_epi32(_mm_castps_si128(_mm_loadu_ps(src + i)), 16);
+        __m128i hi = _mm_srai_epi32(_mm_castps_si128(_mm_loadu_ps(src + i + 4)), 16);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#elif __ARM_NEON
+    for (; i + 4 <= len; i += 4)
+        vst1_u16(dst + i, vshrn_n_u32(vld1q_u32((const uint32_t *)(src + i)), 16));
+#endif
+    for (; i < len; i++) dst[i] = im_float32_to_bfloat16(src[i]);
+}
+
+// FLOAT16 element-wise ops convert a block to float, compute and convert it back
+#define IM_FP16_BLOCK 256
+template<typename Op> static inline void im_float16_apply(unsigned short* dst, const unsigned short* src, const size_t len, Op op)
+{
+#if !IM_F16C && !IM_NEON_FP16
+    // without conversion instructions a fused scalar loop is faster than blocks
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (long i = 0; i < (long)len; i++)
+        dst[i] = im_float32_to_float16(op(im_float16_to_float32(src[i])));
+    return;
+#endif
+    const long blocks = (long)((len + IM_FP16_BLOCK - 1) / IM_FP16_BLOCK);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (long b = 0; b < blocks; b++)
+    {
+        float x[IM_FP16_BLOCK];
+        const size_t start = (size_t)b * IM_FP16_BLOCK;
+        const size_t n = len - start < IM_FP16_BLOCK ? len - start : IM_FP16_BLOCK;
+        im_float16_to_float32_n(x, src + start, n);
+        for (size_t i = 0; i < n; i++) x[i] = op(x[i]);
+        im_float32_to_float16_n(dst + start, x, n);
+    }
+}
+
+template<typename Op> static inline void im_float16_apply(unsigned short* dst, const unsigned short* src1, const unsigned short* src2, const size_t len, Op op)
+{
+#if !IM_F16C && !IM_NEON_FP16
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (long i = 0; i < (long)len; i++)
+        dst[i] = im_float32_to_float16(op(im_float16_to_float32(src1[i]), im_float16_to_float32(src2[i])));
+    return;
+#endif
+    const long blocks = (long)((len + IM_FP16_BLOCK - 1) / IM_FP16_BLOCK);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (long b = 0; b < blocks; b++)
+    {
+        float x[IM_FP16_BLOCK], y[IM_FP16_BLOCK];
+        const size_t start = (size_t)b * IM_FP16_BLOCK;
+        const size_t n = len - start < IM_FP16_BLOCK ? len - start : IM_FP16_BLOCK;
+        im_float16_to_float32_n(x, src1 + start, n);
+        im_float16_to_float32_n(y, src2 + start, n);
+        for (size_t i = 0; i < n; i++) x[i] = op(x[i], y[i]);
+        im_float32_to_float16_n(dst + start, x, n);
+    }
+}
+
 
 ////////////////////////////////////////////////////////////////////
 // Type define
@@ -546,6 +637,9 @@ public:
     template<typename T> ImMat& operator/= (T v);
     // deep copy
     ImMat clone(Allocator* allocator = 0) const;
+    // deep copy with data type changed, values are not normalized, integer types are unsigned,
+    // float to integer rounds and saturates, IM_DT_INT16_BE is not supported
+    ImMat convert_type(ImDataType t, Allocator* allocator = 0) const;
     // deep copy from other buffer, inplace
     void clone_from(const ImMat& mat, Allocator* allocator = 0);
     // reshape vec
@@ -1725,6 +1819,123 @@ inline ImMat ImMat::clone(Allocator* _allocator) const
     return m;
 }
 
+// dtype conversion for convert_type, block by block through float for FLOAT16
+template<typename D, typename S> static inline D im_cast_value(S v)
+{
+    if (std::numeric_limits<D>::is_integer)
+    {
+        if (!(v > 0)) return 0;
+        if (std::numeric_limits<S>::is_integer)
+        {
+            // only a narrower D clamps, (S)max of a wider D would wrap
+            if (sizeof(S) > sizeof(D) && v > (S)std::numeric_limits<D>::max()) return std::numeric_limits<D>::max();
+            return (D)v;
+        }
+        if (v >= (S)std::numeric_limits<D>::max()) return std::numeric_limits<D>::max();
+        return (D)(v + (S)0.5);
+    }
+    return (D)v;
+}
+
+template<typename S> static inline void im_convert_to(void* dst, ImDataType dt, const S* src, size_t len)
+{
+    switch (dt)
+    {
+        case IM_DT_INT8:    for (size_t i = 0; i < len; i++) ((uint8_t *) dst)[i] = im_cast_value<uint8_t> (src[i]); break;
+        case IM_DT_INT16:   for (size_t i = 0; i < len; i++) ((uint16_t *)dst)[i] = im_cast_value<uint16_t>(src[i]); break;
+        case IM_DT_INT32:   for (size_t i = 0; i < len; i++) ((uint32_t *)dst)[i] = im_cast_value<uint32_t>(src[i]); break;
+        case IM_DT_INT64:   for (size_t i = 0; i < len; i++) ((uint64_t *)dst)[i] = im_cast_value<uint64_t>(src[i]); break;
+        case IM_DT_FLOAT32: for (size_t i = 0; i < len; i++) ((float *)   dst)[i] = im_cast_value<float>   (src[i]); break;
+        case IM_DT_FLOAT64: for (size_t i = 0; i < len; i++) ((double *)  dst)[i] = im_cast_value<double>  (src[i]); break;
+        default: break;
+    }
+}
+
+static inline void im_convert_block(void* dst, ImDataType dt, const void* src, ImDataType st, size_t len)
+{
+    float x[IM_FP16_BLOCK];
+    if (st == IM_DT_FLOAT16 && dt == IM_DT_FLOAT32)
+        im_float16_to_float32_n((float *)dst, (const uint16_t *)src, len);
+    else if (st == IM_DT_FLOAT32 && dt == IM_DT_FLOAT16)
+        im_float32_to_float16_n((uint16_t *)dst, (const float *)src, len);
+    else if (st == IM_DT_FLOAT16)
+    {
+        im_float16_to_float32_n(x, (const uint16_t *)src, len);
+        im_convert_to(dst, dt, x, len);
+    }
+    else if (dt == IM_DT_FLOAT16)
+    {
+        switch (st)
+        {
+            case IM_DT_INT8:    im_convert_to(x, IM_DT_FLOAT32, (const uint8_t *) src, len); break;
+            case IM_DT_INT16:   im_convert_to(x, IM_DT_FLOAT32, (const uint16_t *)src, len); break;
+            case IM_DT_INT32:   im_convert_to(x, IM_DT_FLOAT32, (const uint32_t *)src, len); break;
+            case IM_DT_INT64:   im_convert_to(x, IM_DT_FLOAT32, (const uint64_t *)src, len); break;
+            case IM_DT_FLOAT64: im_convert_to(x, IM_DT_FLOAT32, (const double *)  src, len); break;
+            default: break;
+        }
+        im_float32_to_float16_n((uint16_t *)dst, x, len);
+    }
+    else
+    {
+        switch (st)
+        {
+            case IM_DT_INT8:    im_convert_to(dst, dt, (const uint8_t *) src, len); break;
+            case IM_DT_INT16:   im_convert_to(dst, dt, (const uint16_t *)src, len); break;
+            case IM_DT_INT32:   im_convert_to(dst, dt, (const uint32_t *)src, len); break;
+            case IM_DT_INT64:   im_convert_to(dst, dt, (const uint64_t *)src, len); break;
+            case IM_DT_FLOAT32: im_convert_to(dst, dt, (const float *)   src, len); break;
+            case IM_DT_FLOAT64: im_convert_to(dst, dt, (const double *)  src, len); break;
+            default: break;
+        }
+    }
+}
+
+inline ImMat ImMat::convert_type(ImDataType t, Allocator* _allocator) const
+{
+    if (empty() || device != IM_DD_CPU || t == IM_DT_INT16_BE || type == IM_DT_INT16_BE || IM_ESIZE(t) == 0)
+        return ImMat();
+    if (t == type)
+        return clone(_allocator);
+
+    ImMat m;
+    const size_t _elemsize = elemsize / IM_ESIZE(type) * IM_ESIZE(t);
+    if (dims == 1)
+        m.create(w, _elemsize, elempack, _allocator);
+    else if (dims == 2)
+        m.create(w, h, _elemsize, elempack, _allocator);
+    else if (dims == 3)
+        m.create(w, h, c, _elemsize, elempack, _allocator);
+    if (!m.data)
+        return m;
+
+    // channels are converted in blocks, all blocks of all channels in one parallel pass
+    const size_t channel_size = (size_t)w * h * elempack;
+    const long channel_blocks = (long)((channel_size + IM_FP16_BLOCK - 1) / IM_FP16_BLOCK);
+    const size_t src_esize = IM_ESIZE(type), dst_esize = IM_ESIZE(t);
+    #pragma omp parallel for num_threads(OMP_THREADS)
+    for (long b = 0; b < channel_blocks * c; b++)
+    {
+        const int q = (int)(b / channel_blocks);
+        const size_t start = (size_t)(b % channel_blocks) * IM_FP16_BLOCK;
+        const size_t n = channel_size - start < IM_FP16_BLOCK ? channel_size - start : IM_FP16_BLOCK;
+        const unsigned char* src = (const unsigned char *)data + (q * cstep + start / elempack) * elemsize + start % elempack * src_esize;
+        unsigned char* dst = (unsigned char *)m.data + (q * m.cstep + start / elempack) * m.elemsize + start % elempack * dst_esize;
+        im_convert_block(dst, t, src, type, n);
+    }
+    m.color_format = color_format;
+    m.color_range = color_range;
+    m.color_space = color_space;
+    m.type = t;
+    m.time_stamp = time_stamp;
+    m.duration = duration;
+    m.flags = flags;
+    m.depth = IM_DEPTH(t);
+    m.rate = rate;
+    m.ord = ord;
+    return m;
+}
+
 inline void ImMat::clone_from(const ImMat& mat, Allocator* allocator)
 {
     *this = mat.clone(allocator);
@@ -2098,6 +2309,12 @@ template<typename T> ImMat& ImMat::clip(T v_min, T v_max)
 {
     assert(device == IM_DD_CPU);
     assert(total() > 0);
+    if (type == IM_DT_FLOAT16)
+    {
+        const float lo = (float)v_min, hi = (float)v_max;
+        im_float16_apply((uint16_t *)this->data, (uint16_t *)this->data, total(), [lo, hi](float x) { return x < lo ? lo : x > hi ? hi : x; });
+        return *this;
+    }
     #pragma omp parallel for num_threads(OMP_THREADS)
     for (int i = 0; i < total(); i++)
     {
@@ -2115,8 +2332,6 @@ template<typename T> ImMat& ImMat::clip(T v_min, T v_max)
                                     if (((float *)  this->data)[i] > (float)   v_max) ((float *)  this->data)[i]= (float)   v_max; } break; 
             case IM_DT_FLOAT64: {   if (((double *) this->data)[i] < (double)  v_min) ((double *) this->data)[i]= (double)  v_min;
                                     if (((double *) this->data)[i] > (double)  v_max) ((double *) this->data)[i]= (double)  v_max; } break;
-            case IM_DT_FLOAT16: {   if (im_float16_to_float32(((uint16_t *)this->data)[i]) < (float)v_min) ((uint16_t *)this->data)[i] = im_float32_to_float16((float)v_min);
-                                    if (im_float16_to_float32(((uint16_t *)this->data)[i]) > (float)v_max) ((uint16_t *)this->data)[i] = im_float32_to_float16((float)v_max); } break;
             default: break;
         }
     }
@@ -2206,9 +2421,7 @@ static inline __attribute__((unused)) void add_double_avx(double* dst, const dou
 }
 static inline __attribute__((unused)) void add_float16_avx(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) + v);
+    im_float16_apply(dst, src, len, [v](float x) { return x + v; });
 }
 #define add_int8_simd add_int8_avx
 #define add_int16_simd add_int16_avx
@@ -2298,9 +2511,7 @@ static inline __attribute__((unused)) void add_double_sse(double* dst, const dou
 }
 static inline __attribute__((unused)) void add_float16_sse(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) + v);
+    im_float16_apply(dst, src, len, [v](float x) { return x + v; });
 }
 #define add_int8_simd add_int8_sse
 #define add_int16_simd add_int16_sse
@@ -2382,9 +2593,7 @@ static inline __attribute__((unused)) void add_double_neon(double* dst, const do
 }
 static inline __attribute__((unused)) void add_float16_neon(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) + v);
+    im_float16_apply(dst, src, len, [v](float x) { return x + v; });
 }
 #define add_int8_simd add_int8_neon
 #define add_int16_simd add_int16_neon
@@ -2426,9 +2635,7 @@ static inline __attribute__((unused)) void add_double_c(double* dst, const doubl
 }
 static inline __attribute__((unused)) void add_float16_c(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) + v);
+    im_float16_apply(dst, src, len, [v](float x) { return x + v; });
 }
 #define add_int8_simd add_int8_c
 #define add_int16_simd add_int16_c
@@ -2521,9 +2728,7 @@ static inline __attribute__((unused)) void sub_double_avx(double* dst, const dou
 }
 static inline __attribute__((unused)) void sub_float16_avx(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) - v);
+    im_float16_apply(dst, src, len, [v](float x) { return x - v; });
 }
 #define sub_int8_simd sub_int8_avx
 #define sub_int16_simd sub_int16_avx
@@ -2613,9 +2818,7 @@ static inline __attribute__((unused)) void sub_double_sse(double* dst, const dou
 }
 static inline __attribute__((unused)) void sub_float16_sse(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) - v);
+    im_float16_apply(dst, src, len, [v](float x) { return x - v; });
 }
 #define sub_int8_simd sub_int8_sse
 #define sub_int16_simd sub_int16_sse
@@ -2697,9 +2900,7 @@ static inline __attribute__((unused)) void sub_double_neon(double* dst, const do
 }
 static inline __attribute__((unused)) void sub_float16_neon(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) - v);
+    im_float16_apply(dst, src, len, [v](float x) { return x - v; });
 }
 #define sub_int8_simd sub_int8_neon
 #define sub_int16_simd sub_int16_neon
@@ -2741,9 +2942,7 @@ static inline __attribute__((unused)) void sub_double_c(double* dst, const doubl
 }
 static inline __attribute__((unused)) void sub_float16_c(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) - v);
+    im_float16_apply(dst, src, len, [v](float x) { return x - v; });
 }
 #define sub_int8_simd sub_int8_c
 #define sub_int16_simd sub_int16_c
@@ -2822,9 +3021,7 @@ static inline __attribute__((unused)) void mul_double_avx(double* dst, const dou
 }
 static inline __attribute__((unused)) void mul_float16_avx(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) * v);
+    im_float16_apply(dst, src, len, [v](float x) { return x * v; });
 }
 #define mul_int8_simd mul_int8_avx
 #define mul_int16_simd mul_int16_avx
@@ -2900,9 +3097,7 @@ static inline __attribute__((unused)) void mul_double_sse(double* dst, const dou
 }
 static inline __attribute__((unused)) void mul_float16_sse(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) * v);
+    im_float16_apply(dst, src, len, [v](float x) { return x * v; });
 }
 #define mul_int8_simd mul_int8_sse
 #define mul_int16_simd mul_int16_sse
@@ -2976,9 +3171,7 @@ static inline __attribute__((unused)) void mul_double_neon(double* dst, const do
 }
 static inline __attribute__((unused)) void mul_float16_neon(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) * v);
+    im_float16_apply(dst, src, len, [v](float x) { return x * v; });
 }
 #define mul_int8_simd mul_int8_neon
 #define mul_int16_simd mul_int16_neon
@@ -3020,9 +3213,7 @@ static inline __attribute__((unused)) void mul_double_c(double* dst, const doubl
 }
 static inline __attribute__((unused)) void mul_float16_c(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) * v);
+    im_float16_apply(dst, src, len, [v](float x) { return x * v; });
 }
 #define mul_int8_simd mul_int8_c
 #define mul_int16_simd mul_int16_c
@@ -3083,9 +3274,7 @@ static inline __attribute__((unused)) void div_double_avx(double* dst, const dou
 }
 static inline __attribute__((unused)) void div_float16_avx(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) / v);
+    im_float16_apply(dst, src, len, [v](float x) { return x / v; });
 }
 #define div_int8_simd div_int8_avx
 #define div_int16_simd div_int16_avx
@@ -3143,9 +3332,7 @@ static inline __attribute__((unused)) void div_double_sse(double* dst, const dou
 }
 static inline __attribute__((unused)) void div_float16_sse(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) / v);
+    im_float16_apply(dst, src, len, [v](float x) { return x / v; });
 }
 #define div_int8_simd div_int8_sse
 #define div_int16_simd div_int16_sse
@@ -3187,9 +3374,7 @@ static inline __attribute__((unused)) void div_double_c(double* dst, const doubl
 }
 static inline __attribute__((unused)) void div_float16_c(uint16_t* dst, const uint16_t* src, const size_t len, const float v)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src + i)) / v);
+    im_float16_apply(dst, src, len, [v](float x) { return x / v; });
 }
 #define div_int8_simd div_int8_c
 #define div_int16_simd div_int16_c
@@ -3282,9 +3467,7 @@ static inline __attribute__((unused)) void madd_double_avx(double* dst, const do
 }
 static inline __attribute__((unused)) void madd_float16_avx(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) + im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x + y; });
 }
 #define madd_int8_simd      madd_int8_avx
 #define madd_int16_simd     madd_int16_avx
@@ -3374,9 +3557,7 @@ static inline __attribute__((unused)) void madd_double_sse(double* dst, const do
 }
 static inline __attribute__((unused)) void madd_float16_sse(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) + im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x + y; });
 }
 #define madd_int8_simd      madd_int8_sse
 #define madd_int16_simd     madd_int16_sse
@@ -3458,9 +3639,7 @@ static inline __attribute__((unused)) void madd_double_neon(double* dst, const d
 }
 static inline __attribute__((unused)) void madd_float16_neon(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) + im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x + y; });
 }
 #define madd_int8_simd      madd_int8_neon
 #define madd_int16_simd     madd_int16_neon
@@ -3502,9 +3681,7 @@ static inline __attribute__((unused)) void madd_double_c(double* dst, const doub
 }
 static inline __attribute__((unused)) void madd_float16_c(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) + im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x + y; });
 }
 #define madd_int8_simd      madd_int8_c
 #define madd_int16_simd     madd_int16_c
@@ -3597,9 +3774,7 @@ static inline __attribute__((unused)) void msub_double_avx(double* dst, const do
 }
 static inline __attribute__((unused)) void msub_float16_avx(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) - im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x - y; });
 }
 #define msub_int8_simd      msub_int8_avx
 #define msub_int16_simd     msub_int16_avx
@@ -3689,9 +3864,7 @@ static inline __attribute__((unused)) void msub_double_sse(double* dst, const do
 }
 static inline __attribute__((unused)) void msub_float16_sse(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) - im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x - y; });
 }
 #define msub_int8_simd      msub_int8_sse
 #define msub_int16_simd     msub_int16_sse
@@ -3773,9 +3946,7 @@ static inline __attribute__((unused)) void msub_double_neon(double* dst, const d
 }
 static inline __attribute__((unused)) void msub_float16_neon(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) - im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x - y; });
 }
 #define msub_int8_simd      msub_int8_neon
 #define msub_int16_simd     msub_int16_neon
@@ -3817,9 +3988,7 @@ static inline __attribute__((unused)) void msub_double_c(double* dst, const doub
 }
 static inline __attribute__((unused)) void msub_float16_c(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) - im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x - y; });
 }
 #define msub_int8_simd      msub_int8_c
 #define msub_int16_simd     msub_int16_c
@@ -3880,9 +4049,7 @@ static inline __attribute__((unused)) void mdiv_double_avx(double* dst, const do
 }
 static inline __attribute__((unused)) void mdiv_float16_avx(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) / im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x / y; });
 }
 #define mdiv_int8_simd       mdiv_int8_avx
 #define mdiv_int16_simd      mdiv_int16_avx
@@ -3940,9 +4107,7 @@ static inline __attribute__((unused)) void mdiv_double_sse(double* dst, const do
 }
 static inline __attribute__((unused)) void mdiv_float16_sse(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) / im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x / y; });
 }
 #define mdiv_int8_simd       mdiv_int8_sse
 #define mdiv_int16_simd      mdiv_int16_sse
@@ -3986,9 +4151,7 @@ static inline __attribute__((unused)) void mdiv_double_c(double* dst, const doub
 }
 static inline __attribute__((unused)) void mdiv_float16_c(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) / im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x / y; });
 }
 #define mdiv_int8_simd       mdiv_int8_c
 #define mdiv_int16_simd      mdiv_int16_c
@@ -4065,9 +4228,7 @@ static inline __attribute__((unused)) void mmul_double_avx(double* dst, const do
 }
 static inline __attribute__((unused)) void mmul_float16_avx(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) * im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x * y; });
 }
 #define mmul_int8_simd       mmul_int8_avx
 #define mmul_int16_simd      mmul_int16_avx
@@ -4141,9 +4302,7 @@ static inline __attribute__((unused)) void mmul_double_sse(double* dst, const do
 }
 static inline __attribute__((unused)) void mmul_float16_sse(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) * im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x * y; });
 }
 #define mmul_int8_simd       mmul_int8_sse
 #define mmul_int16_simd      mmul_int16_sse
@@ -4217,9 +4376,7 @@ static inline __attribute__((unused)) void mmul_double_neon(double* dst, const d
 }
 static inline __attribute__((unused)) void mmul_float16_neon(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) * im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x * y; });
 }
 #define mmul_int8_simd       mmul_int8_neon
 #define mmul_int16_simd      mmul_int16_neon
@@ -4261,9 +4418,7 @@ static inline __attribute__((unused)) void mmul_double_c(double* dst, const doub
 }
 static inline __attribute__((unused)) void mmul_float16_c(uint16_t* dst, const uint16_t* src1, const uint16_t* src2, const size_t len)
 {
-    #pragma omp parallel for num_threads(OMP_THREADS)
-    for (int i = 0; i < len; ++i) 
-        *(dst + i) = im_float32_to_float16(im_float16_to_float32(*(src1 + i)) * im_float16_to_float32(*(src2 + i)));
+    im_float16_apply(dst, src1, src2, len, [](float x, float y) { return x * y; });
 }
 #define mmul_int8_simd       mmul_int8_c
 #define mmul_int16_simd      mmul_int16_c
@@ -4618,6 +4773,13 @@ inline ImMat ImMat::operator*(const ImMat& mat)
     assert(device == IM_DD_CPU);
     assert(dims == 2);
     assert(w == mat.h);
+    if (type == IM_DT_FLOAT16)
+    {
+        // accumulate in float, operands and result are converted in one pass each
+        ImMat a = convert_type(IM_DT_FLOAT32);
+        ImMat m = a * mat.convert_type(IM_DT_FLOAT32);
+        return m.convert_type(IM_DT_FLOAT16, allocator);
+    }
     ImMat m;
     m.create_type(mat.w, h, type, allocator);
     if (!m.data)
@@ -4636,10 +4798,6 @@ inline ImMat ImMat::operator*(const ImMat& mat)
                     case IM_DT_INT64:   m.at<int64_t>(j, i) += this->at<int64_t>(k, i) * mat.at<int64_t>(j, k); break;
                     case IM_DT_FLOAT32: m.at<float>  (j, i) += this->at<float>  (k, i) * mat.at<float>  (j, k); break;
                     case IM_DT_FLOAT64: m.at<double> (j, i) += this->at<double> (k, i) * mat.at<double> (j, k); break;
-                    case IM_DT_FLOAT16: m.at<uint16_t>(j, i) = im_float32_to_float16(
-                                                                im_float16_to_float32(m.at<uint16_t>(j, i)) + 
-                                                                im_float16_to_float32(this->at<uint16_t>(k, i)) *
-                                                                im_float16_to_float32(mat.at<uint16_t> (j, k))); break;
                     default: break;
                 }
             }
@@ -4653,6 +4811,11 @@ inline ImMat& ImMat::operator*=(const ImMat& mat)
     assert(device == IM_DD_CPU);
     assert(dims == 2);
     assert(w == mat.h);
+    if (type == IM_DT_FLOAT16)
+    {
+        *this = *this * mat;
+        return *this;
+    }
     ImMat m;
     m.clone_from(*this);
     this->release();
@@ -4671,10 +4834,6 @@ inline ImMat& ImMat::operator*=(const ImMat& mat)
                     case IM_DT_INT64:   this->at<int64_t>(j, i) += m.at<int64_t>(k, i) * mat.at<int64_t>(j, k); break;
                     case IM_DT_FLOAT32: this->at<float>  (j, i) += m.at<float>  (k, i) * mat.at<float>  (j, k); break;
                     case IM_DT_FLOAT64: this->at<double> (j, i) += m.at<double> (k, i) * mat.at<double> (j, k); break;
-                    case IM_DT_FLOAT16: this->at<uint16_t>(j, i) = im_float32_to_float16(
-                                                                    im_float16_to_float32(this->at<uint16_t>(j, i)) + 
-                                                                    im_float16_to_float32(m.at<uint16_t>(k, i)) *
-                                                                    im_float16_to_float32(mat.at<uint16_t> (j, k))); break;
                     default: break;
                 }
             }
@@ -4757,7 +4916,15 @@ inline void ImMat::clean(ImPixel color)
         }
         break;
         case IM_DT_FLOAT16:
-        // TODO::Dicky add float16 clean with ImPixel
+        {
+            float f_buf[4] = {color.r, color.g, color.b, color.a};
+            uint16_t s_buf[4];
+            im_float32_to_float16_n(s_buf, f_buf, 4);
+            for (int i = 0; i < total() / c; i++)
+            {
+                memcpy((uint8_t*)data + i * elemsize * c, s_buf, c * elemsize);
+            }
+        }
         break;
         default: break;
     }
@@ -4795,7 +4962,10 @@ inline void ImMat::get_pixel(int x, int y, ImPixel& color) const
             if (c > 3) color.a = (float)at<uint64_t>(x, y, 3) / (float)UINT64_MAX;
         break;
         case IM_DT_FLOAT16:
-            // TODO::Dicky add FLOAT16 get pixel from ImPixel
+            if (c > 0) color.r = im_float16_to_float32(at<uint16_t>(x, y, 0));
+            if (c > 1) color.g = im_float16_to_float32(at<uint16_t>(x, y, 1));
+            if (c > 2) color.b = im_float16_to_float32(at<uint16_t>(x, y, 2));
+            if (c > 3) color.a = im_float16_to_float32(at<uint16_t>(x, y, 3));
         break;
         case IM_DT_FLOAT32:
             if (c > 0) color.r = at<float>(x, y, 0);
@@ -4852,7 +5022,10 @@ inline void ImMat::draw_dot(int x, int y, ImPixel color)
             if (c > 3) at<uint64_t>(x, y, 3) = color.a * (float)UINT64_MAX;
         break;
         case IM_DT_FLOAT16:
-            // TODO::Dicky add FLOAT16 draw dot
+            if (c > 0) at<uint16_t>(x, y, 0) = im_float32_to_float16(color.r);
+            if (c > 1) at<uint16_t>(x, y, 1) = im_float32_to_float16(color.g);
+            if (c > 2) at<uint16_t>(x, y, 2) = im_float32_to_float16(color.b);
+            if (c > 3) at<uint16_t>(x, y, 3) = im_float32_to_float16(color.a);
         break;
         case IM_DT_FLOAT32:
             if (c > 0) at<float>(x, y, 0) = color.r;
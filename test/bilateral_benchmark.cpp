@@ -0,0 +1,136 @@
+// Bilateral cpu backend benchmark.
+//
+// A flat frame must stay flat with both exact and grid mode, and without a vulkan device
+// Bilateral_vulkan must give exact output for a large window. Then for windows from 5 to 61 the
+// exact kernel and the bilateral grid are timed on a noisy frame with edges, and grid accuracy
+// is reported as PSNR against exact output. Exact cost grows with ksz^2, grid cost stays flat.
+// Grid range axis is r+g+b, so PSNR is bound by colored edges of the frame, gray frames reach
+// about 49dB.
+// When a vulkan device is present, the shader filter is measured as well.
+//
+// usage: bilateral_benchmark [iterations]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <Bilateral_vulkan.h>
+#include <Bilateral_cpu.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "test_utils.h"
+
+// blocks of flat colors over a gradient with noise, width is not multiple of 8 to run scalar tail
+static ImGui::ImMat MakeFrame(int w, int h, bool flat)
+{
+    ImGui::ImMat mat;
+    mat.create_type(w, h, 4, IM_DT_INT8);
+    uint32_t seed = 0x1234567;
+    for (int y = 0; y < h; y++)
+    {
+        uint8_t* p = (uint8_t *)mat.data + (size_t)y * w * 4;
+        for (int x = 0; x < w; x++, p += 4)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const int noise = flat ? 0 : (int)(seed >> 27) - 16;
+            const bool block = ((x / 97) + (y / 61)) % 3 == 0;
+            const int base[3] = {block ? 200 : x * 160 / w, block ? 60 : 90, block ? 40 : y * 200 / h};
+            for (int k = 0; k < 3; k++)
+                p[k] = (uint8_t)std::min(std::max(flat ? 128 : base[k] + noise, 0), 255);
+            p[3] = 255;
+        }
+    }
+    return mat;
+}
+
+static double PSNR(const ImGui::ImMat& a, const ImGui::ImMat& b)
+{
+    double mse = 0;
+    const size_t pixels = (size_t)a.w * a.h;
+    for (size_t i = 0; i < pixels; i++)
+        for (int k = 0; k < 3; k++)
+        {
+            const double d = ((const float *)a.data)[i * 4 + k] - ((const float *)b.data)[i * 4 + k];
+            mse += d * d;
+        }
+    mse /= pixels * 3;
+    return mse > 0 ? 10.0 * log10(1.0 / mse) : 99.0;
+}
+
+static void CheckFlat()
+{
+    ImGui::ImMat src = MakeFrame(203, 97, true);
+    const int modes[2] = {ImGui::BILATERAL_EXACT, ImGui::BILATERAL_GRID};
+    for (int mode : modes)
+    {
+        ImGui::ImMat dst;
+        dst.type = IM_DT_INT8;
+        Check(ImGui::Bilateral_cpu::filter(src, dst, 31, 8.f, 0.1f, mode), "filter failed");
+        if (dst.empty())
+            continue;
+        int max_diff = 0;
+        for (size_t i = 0; i < (size_t)src.w * src.h * 4; i++)
+            max_diff = std::max(max_diff, std::abs((int)((const uint8_t *)src.data)[i] - (int)((const uint8_t *)dst.data)[i]));
+        Check(max_diff <= 1, mode == ImGui::BILATERAL_EXACT ? "exact changes flat frame" : "grid changes flat frame");
+    }
+}
+
+// grid is opt-in, default of Bilateral_vulkan cpu backend is exact for any window
+static void CheckDefault()
+{
+    ImGui::ImMat src = MakeFrame(203, 97, false);
+    ImGui::ImMat expected, result;
+    expected.type = result.type = IM_DT_INT8;
+    ImGui::Bilateral_cpu::filter(src, expected, 31, 8.f, 0.1f, ImGui::BILATERAL_EXACT);
+    ImGui::Bilateral_vulkan bilateral;
+    bilateral.filter(src, result, 31, 8.f, 0.1f);
+    Check(!result.empty() && result.total() == expected.total() &&
+          memcmp(result.data, expected.data, expected.total() * expected.elemsize) == 0, "Bilateral_vulkan default is not exact");
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 3;
+    if (iterations <= 0)
+        return 1;
+
+    const bool gpu = ImGui::get_gpu_count() > 0;
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, shader filter is measured as well" : "no, cpu backend only");
+
+    CheckFlat();
+    if (!gpu)
+        CheckDefault();
+    fprintf(stdout, "flat frame check: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+
+    struct { int ksz; float sigma_spatial; float sigma_color; } params[] = {
+        {5, 1.5f, 0.1f}, {9, 3.f, 0.1f}, {15, 4.f, 0.1f}, {31, 8.f, 0.1f}, {61, 16.f, 0.15f},
+    };
+    const int w = 966, h = 540;
+    ImGui::ImMat src = MakeFrame(w, h, false);
+    fprintf(stdout, "%dx%d cpu backend:\n", w, h);
+    fprintf(stdout, "  ksz  sigma_s sigma_c  exact ms   grid ms  grid PSNR\n");
+    for (auto param : params)
+    {
+        ImGui::ImMat exact, grid;
+        exact.type = grid.type = IM_DT_FLOAT32;
+        const double exact_ms = Measure(iterations, [&]() { ImGui::Bilateral_cpu::filter(src, exact, param.ksz, param.sigma_spatial, param.sigma_color, ImGui::BILATERAL_EXACT); });
+        const double grid_ms = Measure(iterations, [&]() { ImGui::Bilateral_cpu::filter(src, grid, param.ksz, param.sigma_spatial, param.sigma_color, ImGui::BILATERAL_GRID); });
+        fprintf(stdout, "  %3d  %7.1f %7.2f  %8.2f  %8.2f  %6.2f dB\n", param.ksz, param.sigma_spatial, param.sigma_color,
+                exact_ms, grid_ms, PSNR(exact, grid));
+    }
+    if (gpu)
+    {
+        ImGui::Bilateral_vulkan bilateral(ImGui::get_default_gpu_index());
+        ImGui::ImMat dst;
+        dst.type = IM_DT_INT8;
+        fprintf(stdout, "%dx%d vulkan, with upload and download:\n", w, h);
+        for (auto param : params)
+        {
+            const double ms = Measure(iterations, [&]() { bilateral.filter(src, dst, param.ksz, param.sigma_spatial, param.sigma_color); });
+            fprintf(stdout, "  %3d  %7.1f %7.2f  %8.2f\n", param.ksz, param.sigma_spatial, param.sigma_color, ms);
+        }
+    }
+
+    return Result();
+}
@@ -0,0 +1,187 @@
+// Box blur, erosion and dilation cpu backend benchmark.
+//
+// Checks Box_cpu against brute force window sum/min/max with clamped borders on a small random
+// frame, for odd, even and larger than frame windows, and for every radius from 1 to 64. Without a
+// vulkan device BoxBlur_vulkan must give Box_cpu output when called through Filter2DS_vulkan.
+// Then measures radius 1, 2, 4 .. 64 at 1080p, cpu cost per pixel must stay flat while window
+// area grows 4000 times. When a vulkan device is present, the shader filters are measured as well.
+//
+// usage: box_benchmark [iterations]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <Box.h>
+#include <Box_cpu.h>
+#include <Erosion_vulkan.h>
+#include <Dilation_vulkan.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include "test_utils.h"
+
+static ImGui::ImMat MakeFrame(int w, int h)
+{
+    ImGui::ImMat mat;
+    mat.create_type(w, h, 4, IM_DT_INT8);
+    uint32_t seed = 0x1234567;
+    for (int y = 0; y < h; y++)
+    {
+        uint8_t* p = (uint8_t *)mat.data + (size_t)y * w * 4;
+        for (int x = 0; x < w; x++, p += 4)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            p[0] = (uint8_t)(x * 255 / w);
+            p[1] = (uint8_t)(seed >> 24);
+            p[2] = (uint8_t)(seed >> 16);
+            p[3] = (uint8_t)(y * 255 / h);
+        }
+    }
+    return mat;
+}
+
+// brute force of ksz x ksz window from -ksz / 2 with clamped borders, op 0 mean, 1 min, 2 max,
+// window is separable so rows are done first and then columns of row results
+static std::vector<float> Window(const ImGui::ImMat& src, int ksz, int op)
+{
+    const int w = src.w, h = src.h;
+    auto reduce = [&](float result, float v) { return op == 0 ? result + v / ksz : op == 1 ? std::min(result, v) : std::max(result, v); };
+    std::vector<float> rows((size_t)w * h * 4), result((size_t)w * h * 4);
+    for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++)
+    for (int k = 0; k < 4; k++)
+    {
+        float r = op == 1 ? 1.f : 0.f;
+        for (int i = 0; i < ksz; i++)
+        {
+            const int xx = std::min(std::max(x - ksz / 2 + i, 0), w - 1);
+            r = reduce(r, ((const uint8_t *)src.data)[((size_t)y * w + xx) * 4 + k] / 255.f);
+        }
+        rows[((size_t)y * w + x) * 4 + k] = r;
+    }
+    for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++)
+    for (int k = 0; k < 4; k++)
+    {
+        float r = op == 1 ? 1.f : 0.f;
+        for (int j = 0; j < ksz; j++)
+        {
+            const int yy = std::min(std::max(y - ksz / 2 + j, 0), h - 1);
+            r = reduce(r, rows[((size_t)yy * w + x) * 4 + k]);
+        }
+        result[((size_t)y * w + x) * 4 + k] = r;
+    }
+    return result;
+}
+
+static void CheckWindow(const ImGui::ImMat& src, int ksz)
+{
+    ImGui::ImMat blur, erosion, dilation;
+    blur.type = erosion.type = dilation.type = IM_DT_INT8;
+    Check(ImGui::Box_cpu::Blur(src, blur, ksz, ksz, 1.f / ksz), "Blur failed");
+    Check(ImGui::Box_cpu::Erosion(src, erosion, ksz), "Erosion failed");
+    Check(ImGui::Box_cpu::Dilation(src, dilation, ksz), "Dilation failed");
+    if (blur.empty() || erosion.empty() || dilation.empty())
+        return;
+    const std::vector<float> mean = Window(src, ksz, 0), min = Window(src, ksz, 1), max = Window(src, ksz, 2);
+    int blur_diff = 0, morph_diff = 0;
+    for (size_t i = 0; i < (size_t)src.w * src.h * 4; i++)
+    {
+        // blur keeps alpha
+        const int expected = i % 4 == 3 ? ((const uint8_t *)src.data)[i] : (int)floorf(mean[i] * 255.f);
+        blur_diff = std::max(blur_diff, std::abs(expected - (int)((const uint8_t *)blur.data)[i]));
+        morph_diff = std::max(morph_diff, std::abs((int)(min[i] * 255.f + .5f) - (int)((const uint8_t *)erosion.data)[i]));
+        morph_diff = std::max(morph_diff, std::abs((int)(max[i] * 255.f + .5f) - (int)((const uint8_t *)dilation.data)[i]));
+    }
+    // running sum may round a value below an integer step, min/max are exact
+    char what[128];
+    snprintf(what, sizeof(what), "Blur differs from window mean, window %d", ksz);
+    Check(blur_diff <= 1, what);
+    snprintf(what, sizeof(what), "Erosion/Dilation differs from window min/max, window %d", ksz);
+    Check(morph_diff == 0, what);
+}
+
+static void CheckWindows(bool gpu)
+{
+    ImGui::ImMat src = MakeFrame(97, 61);
+    const int sizes[] = {2, 4, 16, 150};
+    for (int ksz : sizes)
+        CheckWindow(src, ksz);
+    // every radius, windows from radius 23 on are larger than frame
+    ImGui::ImMat small = MakeFrame(53, 45);
+    for (int r = 0; r <= 64; r++)
+        CheckWindow(small, r * 2 + 1);
+
+    if (gpu)
+        return;
+    ImGui::BoxBlur_vulkan box;
+    const ImGui::Filter2DS_vulkan& filter2ds = box;
+    for (int r = 1; r <= 64; r++)
+    {
+        const int ksz = r * 2 + 1;
+        ImGui::ImMat expected, result;
+        expected.type = result.type = IM_DT_INT8;
+        box.SetParam(ksz, ksz);
+        ImGui::Box_cpu::Blur(src, expected, ksz, ksz, 1.f / ksz);
+        filter2ds.filter(src, result);
+        Check(!result.empty() && result.total() == expected.total() &&
+              memcmp(result.data, expected.data, expected.total() * expected.elemsize) == 0, "BoxBlur_vulkan through Filter2DS_vulkan differs from Box_cpu");
+    }
+}
+
+static void Benchmark(const char* label, int radius, int w, int h, int iterations, const std::function<void()>& func)
+{
+    func();
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+        func();
+    const double ms = ElapsedMs(start) / iterations;
+    fprintf(stdout, "  %-12s radius %2d %8.3f ms  %8.1f Mpixel/s\n", label, radius, ms, (double)w * h / 1000.0 / ms);
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+        return 1;
+
+    const bool gpu = ImGui::get_gpu_count() > 0;
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, shader filters are measured as well" : "no, cpu backend only");
+
+    CheckWindows(gpu);
+    fprintf(stdout, "window check: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+
+    const int w = 1920, h = 1080;
+    ImGui::ImMat src = MakeFrame(w, h);
+    ImGui::ImMat dst;
+    dst.type = IM_DT_INT8;
+    const int radius[] = {1, 2, 4, 8, 16, 32, 64};
+    fprintf(stdout, "%dx%d cpu backend:\n", w, h);
+    for (int r : radius)
+    {
+        const int ksz = r * 2 + 1;
+        Benchmark("Box blur", r, w, h, iterations, [&]() { ImGui::Box_cpu::Blur(src, dst, ksz, ksz, 1.f / ksz); });
+        Benchmark("Erosion", r, w, h, iterations, [&]() { ImGui::Box_cpu::Erosion(src, dst, ksz); });
+        Benchmark("Dilation", r, w, h, iterations, [&]() { ImGui::Box_cpu::Dilation(src, dst, ksz); });
+    }
+    if (gpu)
+    {
+        ImGui::BoxBlur_vulkan box(ImGui::get_default_gpu_index());
+        ImGui::Erosion_vulkan erosion(ImGui::get_default_gpu_index());
+        ImGui::Dilation_vulkan dilation(ImGui::get_default_gpu_index());
+        fprintf(stdout, "%dx%d vulkan, with upload and download:\n", w, h);
+        for (int r : radius)
+        {
+            const int ksz = r * 2 + 1;
+            box.SetParam(ksz, ksz);
+            Benchmark("Box blur", r, w, h, iterations, [&]() { box.filter(src, dst); });
+            Benchmark("Erosion", r, w, h, iterations, [&]() { erosion.filter(src, dst, ksz); });
+            Benchmark("Dilation", r, w, h, iterations, [&]() { dilation.filter(src, dst, ksz); });
+        }
+    }
+
+    return Result();
+}
@@ -0,0 +1,291 @@
+// Streaming codec throughput benchmark.
+//
+// A block of text like data is pushed through ImBase64Encoder/ImBase64Decoder,
+// ImBase85Encoder/ImBase85Decoder and, with IMGUI_USE_ZLIB, ImGzEncoder/ImGzDecoder until the
+// stream reaches the requested size, so a 1 GB stream needs a few MB of memory. Block size is
+// a multiple of 12, its encoding is the same wherever it starts, so decoders are fed the
+// encoded block again and again (gzip output repeats as concatenated members) and the decoded
+// stream is compared with the block. Small inputs check test vectors, truncated base85 groups,
+// gzip members followed by padding and GzBase85 round trips of every size up to a few words.
+// Whole buffer functions are timed on 64 MB.
+// Throughput is in MB/s of plain data.
+//
+// usage: codec_benchmark [megabytes]
+
+#include <imgui.h>
+#include <imgui_helper.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "test_utils.h"
+
+static const size_t kBlockSize = 12 * 87381;    // 1 MB down to whole base64 and base85 groups
+
+// json like lines, compresses about like a serialized node graph
+static std::vector<char> MakeBlock(size_t size)
+{
+    static const char* words[] = {"\"id\": ", "\"name\": \"Node\", ", "\"pins\": [", "], ", "\"location\": ",
+                                  "\"enabled\": true, ", "{", "}, ", "\n", "0.5, ", "\"link\", "};
+    std::vector<char> block;
+    block.reserve(size + 32);
+    uint32_t seed = 0x1234567;
+    while (block.size() < size)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const char* word = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+        block.insert(block.end(), word, word + strlen(word));
+        if ((seed & 7) == 0)
+        {
+            const std::string number = std::to_string(seed >> 12);
+            block.insert(block.end(), number.begin(), number.end());
+        }
+    }
+    block.resize(size);
+    return block;
+}
+
+static ImGui::ImCodecSink AppendTo(std::vector<char>& out)
+{
+    return [&out](const char* data, size_t size) { out.insert(out.end(), data, data + size); return true; };
+}
+
+// compares decoded stream with the block repeated
+struct Verifier
+{
+    const std::vector<char>* block;
+    size_t pos;
+    bool same;
+    bool push(const char* data, size_t size)
+    {
+        while (size > 0 && same)
+        {
+            const size_t offset = pos % block->size();
+            const size_t n = std::min(size, block->size() - offset);
+            same = memcmp(data, block->data() + offset, n) == 0;
+            data += n;
+            size -= n;
+            pos += n;
+        }
+        return same;
+    }
+};
+
+static void MeasureCodec(const char* name, ImGui::ImCodecStream& encoder, ImGui::ImCodecStream& decoder, Verifier& verifier,
+                         const std::vector<char>& block, const std::vector<char>& encoded, size_t blocks)
+{
+    auto start = Clock::now();
+    for (size_t i = 0; i < blocks; i++)
+        encoder.push(block.data(), block.size());
+    encoder.finish();
+    const double encode_ms = ElapsedMs(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < blocks; i++)
+        decoder.push(encoded.data(), encoded.size());
+    const bool ok = decoder.finish();
+    const double decode_ms = ElapsedMs(start);
+
+    const double mb = (double)blocks * block.size() / (1024.0 * 1024.0);
+    fprintf(stdout, "  %-14s encode %8.1f MB/s  decode %8.1f MB/s  (%.2f bytes per byte)\n", name,
+            mb / (encode_ms / 1000.0), mb / (decode_ms / 1000.0), (double)encoded.size() / block.size());
+    Check(ok && verifier.same && verifier.pos == blocks * block.size(), name);
+}
+
+static void CheckSmall()
+{
+    static const char* plain[] = {"f", "fo", "foo", "foob", "fooba", "foobar"};
+    static const char* base64[] = {"Zg==\n", "Zm8=\n", "Zm9v\n", "Zm9vYg==\n", "Zm9vYmE=\n", "Zm9vYmFy\n"};
+    for (int i = 0; i < 6; i++)
+    {
+        ImVector<char> out;
+        ImGui::Base64Encode(plain[i], (int)strlen(plain[i]), out);
+        Check(out.size() == (int)strlen(base64[i]) && memcmp(out.Data, base64[i], out.size()) == 0, "base64 test vector");
+    }
+
+    // random data split in random chunks, through SIMD blocks and scalar tails
+    uint32_t seed = 42;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    for (int length = 0; length < 400; length += 1 + length / 16)
+    {
+        std::vector<char> data(length);
+        for (auto& c : data) c = (char)next();
+        std::vector<char> b64, b85, b64_lines, back64, back85;
+        ImGui::ImBase64Encoder e64(AppendTo(b64));
+        ImGui::ImBase85Encoder e85(AppendTo(b85));
+        for (size_t i = 0; i < data.size();)
+        {
+            const size_t n = std::min<size_t>(1 + next() % 70, data.size() - i);
+            e64.push(&data[i], n);
+            e85.push(&data[i], n);
+            i += n;
+        }
+        Check(e64.finish() && e85.finish(), "encoder finish");
+        // line breaks and a stray character must be skipped like Base64Decode(...) does
+        for (size_t i = 0; i < b64.size(); i++)
+        {
+            b64_lines.push_back(b64[i]);
+            if (i % 76 == 75) b64_lines.push_back('\n');
+            if (i == 33) b64_lines.push_back('"');
+        }
+        ImGui::ImBase64Decoder d64(AppendTo(back64));
+        ImGui::ImBase85Decoder d85(AppendTo(back85));
+        for (size_t i = 0; i < b64_lines.size();)
+        {
+            const size_t n = std::min<size_t>(1 + next() % 90, b64_lines.size() - i);
+            d64.push(&b64_lines[i], n);
+            i += n;
+        }
+        d85.push(b85.data(), b85.size());
+        Check(d64.finish() && d85.finish(), "decoder finish");
+        back85.resize(std::min(back85.size(), data.size()));    // base85 pads last word
+        Check(back64 == data, "base64 round trip");
+        Check(back85 == data, "base85 round trip");
+        // last group cut to the chars its bytes need gives only those bytes
+        if (length % 4 != 0)
+        {
+            std::vector<char> cut;
+            ImGui::ImBase85Decoder d85_cut(AppendTo(cut));
+            d85_cut.push(b85.data(), b85.size() - 5 + length % 4 + 1);
+            Check(d85_cut.finish() && cut == data, "base85 truncated group");
+        }
+
+        b64.push_back('\0');
+        ImVector<char> whole;
+        Check(ImGui::Base64Decode(b64.data(), whole) && whole.size() == length && (length == 0 || memcmp(whole.Data, data.data(), length) == 0), "Base64Decode");
+    }
+}
+
+#ifdef IMGUI_USE_ZLIB
+static void CheckGzip()
+{
+    const std::vector<char> block = MakeBlock(4096);
+    ImVector<char> member, decoded;
+    ImGui::GzCompressFromMemory(block.data(), 1000, member);
+    auto same = [&](const ImVector<char>& out, size_t size) { return out.size() == (int)size && memcmp(out.Data, block.data(), size) == 0; };
+
+    // padding after the member is ignored, a second member is decoded
+    std::vector<std::vector<char>> inputs(4, std::vector<char>(member.begin(), member.end()));
+    inputs[1].insert(inputs[1].end(), 2, 0);
+    inputs[2].insert(inputs[2].end(), {'\x1f', 'x', 'y'});
+    inputs[3].insert(inputs[3].end(), member.begin(), member.end());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        std::vector<char> expected(block.begin(), block.begin() + 1000);
+        if (i == 3) expected.insert(expected.end(), block.begin(), block.begin() + 1000);
+        const bool ok = ImGui::GzDecompressFromMemory(inputs[i].data(), (int)inputs[i].size(), decoded);
+        Check(ok && std::vector<char>(decoded.begin(), decoded.end()) == expected, "GzDecompressFromMemory with trailing bytes");
+        // one byte pushes split the gzip magic between pushes
+        std::vector<char> streamed;
+        ImGui::ImGzDecoder gz(AppendTo(streamed));
+        bool pushed = true;
+        for (char c : inputs[i])
+            pushed = pushed && gz.push(&c, 1);
+        Check(pushed && gz.finish() && streamed == expected, "ImGzDecoder with trailing bytes");
+    }
+
+    // compressed sizes cover every remainder of base85 words
+    int sizes = 0;
+    for (size_t length = 1; length <= 4096; length += 1 + length / 8, sizes++)
+    {
+        ImVector<char> text;
+        Check(ImGui::GzBase85CompressFromMemory(block.data(), (int)length, text), "GzBase85CompressFromMemory");
+        Check(ImGui::GzBase85DecompressFromMemory(text.Data, decoded) && same(decoded, length), "GzBase85 round trip");
+        Check(ImGui::GzBase64CompressFromMemory(block.data(), (int)length, text), "GzBase64CompressFromMemory");
+        Check(ImGui::GzBase64DecompressFromMemory(text.Data, decoded) && same(decoded, length), "GzBase64 round trip");
+    }
+    fprintf(stdout, "  GzBase85 and GzBase64 round trips of %d sizes\n", sizes);
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    const int megabytes = argc > 1 ? atoi(argv[1]) : 1024;
+    if (megabytes <= 0)
+        return 1;
+
+    fprintf(stdout, "check of small inputs:\n");
+    CheckSmall();
+#ifdef IMGUI_USE_ZLIB
+    CheckGzip();
+#endif
+
+    const std::vector<char> block = MakeBlock(kBlockSize);
+    const size_t blocks = std::max<size_t>(1, (size_t)megabytes * 1024 * 1024 / kBlockSize);
+    fprintf(stdout, "streaming, %zu MB in %zu KB pushes:\n", blocks * kBlockSize / (1024 * 1024), kBlockSize / 1024);
+    {
+        std::vector<char> encoded;
+        ImGui::ImBase64Encoder once(AppendTo(encoded));
+        once.push(block.data(), block.size());
+        once.finish();
+        Verifier verifier {&block, 0, true};
+        ImGui::ImBase64Encoder encoder(ImGui::ImCodecSink{});
+        ImGui::ImBase64Decoder decoder([&verifier](const char* data, size_t size) { return verifier.push(data, size); });
+        MeasureCodec("base64", encoder, decoder, verifier, block, encoded, blocks);
+
+        std::vector<char> lines;
+        for (size_t i = 0; i < encoded.size(); i++)
+        {
+            lines.push_back(encoded[i]);
+            if (i % 76 == 75) lines.push_back('\n');
+        }
+        Verifier line_verifier {&block, 0, true};
+        ImGui::ImBase64Encoder line_encoder(ImGui::ImCodecSink{});
+        ImGui::ImBase64Decoder line_decoder([&line_verifier](const char* data, size_t size) { return line_verifier.push(data, size); });
+        MeasureCodec("base64 76/line", line_encoder, line_decoder, line_verifier, block, lines, blocks);
+    }
+    {
+        std::vector<char> encoded;
+        ImGui::ImBase85Encoder once(AppendTo(encoded));
+        once.push(block.data(), block.size());
+        once.finish();
+        Verifier verifier {&block, 0, true};
+        ImGui::ImBase85Encoder encoder(ImGui::ImCodecSink{});
+        ImGui::ImBase85Decoder decoder([&verifier](const char* data, size_t size) { return verifier.push(data, size); });
+        MeasureCodec("base85", encoder, decoder, verifier, block, encoded, blocks);
+    }
+#ifdef IMGUI_USE_ZLIB
+    {
+        // default zlib level, GzCompressFromMemory(...) uses 9 and is timed below
+        std::vector<char> encoded;
+        ImGui::ImGzEncoder once(AppendTo(encoded), 6);
+        once.push(block.data(), block.size());
+        once.finish();
+        Verifier verifier {&block, 0, true};
+        ImGui::ImGzEncoder encoder(ImGui::ImCodecSink{}, 6);
+        ImGui::ImGzDecoder decoder([&verifier](const char* data, size_t size) { return verifier.push(data, size); });
+        MeasureCodec("gzip level 6", encoder, decoder, verifier, block, encoded, blocks);
+    }
+#endif
+
+    const int whole_blocks = std::min<int>(64, (int)blocks);
+    std::vector<char> input;
+    for (int i = 0; i < whole_blocks; i++)
+        input.insert(input.end(), block.begin(), block.end());
+    const double mb = (double)input.size() / (1024.0 * 1024.0);
+    fprintf(stdout, "whole buffer, %.0f MB:\n", mb);
+    ImVector<char> encoded, decoded;
+    auto start = Clock::now();
+    ImGui::Base64Encode(input.data(), (int)input.size(), encoded);
+    const double encode_ms = ElapsedMs(start);
+    encoded.back() = '\0';
+    start = Clock::now();
+    ImGui::Base64Decode(encoded.Data, decoded);
+    const double decode_ms = ElapsedMs(start);
+    fprintf(stdout, "  %-14s encode %8.1f MB/s  decode %8.1f MB/s\n", "Base64", mb / (encode_ms / 1000.0), mb / (decode_ms / 1000.0));
+    Check(decoded.size() == (int)input.size() && memcmp(decoded.Data, input.data(), input.size()) == 0, "Base64Encode/Base64Decode");
+#ifdef IMGUI_USE_ZLIB
+    start = Clock::now();
+    ImGui::GzCompressFromMemory(input.data(), (int)input.size(), encoded);
+    const double compress_ms = ElapsedMs(start);
+    start = Clock::now();
+    const bool ok = ImGui::GzDecompressFromMemory(encoded.Data, encoded.size(), decoded);
+    const double decompress_ms = ElapsedMs(start);
+    fprintf(stdout, "  %-14s encode %8.1f MB/s  decode %8.1f MB/s\n", "Gz level 9", mb / (compress_ms / 1000.0), mb / (decompress_ms / 1000.0));
+    Check(ok && decoded.size() == (int)input.size() && memcmp(decoded.Data, input.data(), input.size()) == 0, "GzCompressFromMemory/GzDecompressFromMemory");
+#endif
+
+    return Result();
+}
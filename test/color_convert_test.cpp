@@ -0,0 +1,542 @@
+// ColorConvert cpu backend test.
+//
+// Every conversion of ColorConvert_cpu is checked against golden output, for
+// all yuv formats, 8/10/16 bits and float sources, BT601/709/2020 and
+// full/narrow range, and all rgba output layouts and types. Golden output
+// takes the samples of ColorConvert_shader.h and converts them with ImMat
+// code: the color table matrices of colorspace_table.cpp, ImMat matrix
+// product and clip(), and im_float32_to_float16() for half output. The
+// result must match bit by bit. When a vulkan device is present, cpu output
+// is compared with shader output as well and the largest difference is
+// reported. At the end 1080p conversion throughput is measured.
+//
+// usage: color_convert_test [iterations]
+
+// golden output must be rounded exactly like shader, see ColorConvert_cpu.cpp,
+// set before includes so ImMat inline code is compiled the same way
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract (off)
+#endif
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <ColorConvert_vulkan.h>
+#include <ColorConvert_cpu.h>
+#include <math.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include "test_utils.h"
+
+namespace ImGui { extern const ImMat * color_table[2][2][4]; }
+
+static const char* FormatName(ImColorFormat format)
+{
+    switch (format)
+    {
+        case IM_CF_YUV420: return "YUV420";
+        case IM_CF_YUV422: return "YUV422";
+        case IM_CF_YUV444: return "YUV444";
+        case IM_CF_NV12:   return "NV12";
+        case IM_CF_P010LE: return "P010LE";
+        case IM_CF_ABGR:   return "ABGR";
+        case IM_CF_ARGB:   return "ARGB";
+        case IM_CF_BGRA:   return "BGRA";
+        case IM_CF_RGBA:   return "RGBA";
+        case IM_CF_BGR:    return "BGR";
+        case IM_CF_RGB:    return "RGB";
+        default:           return "?";
+    }
+}
+
+static const char* TypeName(ImDataType type)
+{
+    switch (type)
+    {
+        case IM_DT_INT8:     return "int8";
+        case IM_DT_INT16:    return "int16";
+        case IM_DT_INT16_BE: return "int16_be";
+        case IM_DT_FLOAT16:  return "float16";
+        case IM_DT_FLOAT32:  return "float32";
+        default:             return "?";
+    }
+}
+
+static uint16_t Swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+
+static float Clamp01(float v) { return std::min(std::max(v, 0.f), 1.f); }
+
+static float Load(const ImGui::ImMat& m, size_t i)
+{
+    switch (m.type)
+    {
+        case IM_DT_INT8:     return (float)((const uint8_t *)m.data)[i];
+        case IM_DT_INT16:    return (float)((const uint16_t *)m.data)[i];
+        case IM_DT_INT16_BE: return (float)Swap16(((const uint16_t *)m.data)[i]);
+        case IM_DT_FLOAT16:  return im_float16_to_float32(((const uint16_t *)m.data)[i]);
+        case IM_DT_FLOAT32:  return ((const float *)m.data)[i];
+        default:             return 0.f;
+    }
+}
+
+static void Store(ImGui::ImMat& m, size_t i, float v)
+{
+    switch (m.type)
+    {
+        case IM_DT_INT8:     ((uint8_t *)m.data)[i] = (uint8_t)std::min(std::max(floorf(v * 255.f), 0.f), 255.f); break;
+        case IM_DT_INT16:    ((uint16_t *)m.data)[i] = (uint16_t)std::min(std::max(floorf(v * 65535.f), 0.f), 65535.f); break;
+        case IM_DT_INT16_BE: ((uint16_t *)m.data)[i] = Swap16((uint16_t)std::min(std::max(floorf(v * 65535.f), 0.f), 65535.f)); break;
+        case IM_DT_FLOAT16:  ((uint16_t *)m.data)[i] = im_float32_to_float16(Clamp01(v)); break;
+        case IM_DT_FLOAT32:  ((float *)m.data)[i] = Clamp01(v); break;
+        default: break;
+    }
+}
+
+static void Mapping(ImColorFormat format, int map[4])
+{
+    static const int abgr[4] = {0, 1, 2, 3}, argb[4] = {2, 1, 0, 3}, bgra[4] = {1, 2, 3, 0}, rgba[4] = {3, 2, 1, 0};
+    static const int bgr[4] = {0, 1, 2, 0}, rgb[4] = {2, 1, 0, 0}, none[4] = {0, 0, 0, 0};
+    const int* m = format == IM_CF_ABGR ? abgr : format == IM_CF_ARGB ? argb : format == IM_CF_BGRA ? bgra :
+                   format == IM_CF_RGBA ? rgba : format == IM_CF_BGR ? bgr : format == IM_CF_RGB ? rgb : none;
+    memcpy(map, m, sizeof(int) * 4);
+}
+
+static float MaxValue(ImDataType type, int depth)
+{
+    return type == IM_DT_FLOAT16 || type == IM_DT_FLOAT32 ? 1.f : (float)((1 << depth) - 1);
+}
+
+static void FillPattern(ImGui::ImMat& m, float max_value, uint32_t seed)
+{
+    for (size_t i = 0; i < m.total(); i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        float v = (float)(seed >> 8) / (float)(1 << 24);
+        // hit both ends of range now and then, they exercise clamping
+        if ((seed & 0x3F) == 0) v = 0.f;
+        if ((seed & 0x3F) == 1) v = 1.f;
+        switch (m.type)
+        {
+            case IM_DT_INT8:     ((uint8_t *)m.data)[i] = (uint8_t)(v * max_value); break;
+            case IM_DT_INT16:    ((uint16_t *)m.data)[i] = (uint16_t)(v * max_value); break;
+            case IM_DT_INT16_BE: ((uint16_t *)m.data)[i] = Swap16((uint16_t)(v * max_value)); break;
+            case IM_DT_FLOAT16:  ((uint16_t *)m.data)[i] = im_float32_to_float16(v); break;
+            case IM_DT_FLOAT32:  ((float *)m.data)[i] = v; break;
+            default: break;
+        }
+    }
+}
+
+// rgb rows of a 3 x n ImMat stored as interleaved rgba pixels of dst layout, alpha 1
+static void StorePixels(const ImGui::ImMat& rgb, ImGui::ImMat& dst)
+{
+    int map[4];
+    Mapping(dst.color_format, map);
+    for (int i = 0; i < dst.w * dst.h; i++)
+    {
+        const size_t o = (size_t)i * dst.c;
+        Store(dst, o + map[0], rgb.at<float>(i, 0));
+        Store(dst, o + map[1], rgb.at<float>(i, 1));
+        Store(dst, o + map[2], rgb.at<float>(i, 2));
+        Store(dst, o + map[3], 1.f);
+    }
+}
+
+// YUV2RGB shader without resize, samples are loaded like the shader, offset
+// and converted by color table matrix product
+static ImGui::ImMat GoldenYUV2RGB(const ImGui::ImMat& src, float in_scale)
+{
+    const ImColorFormat format = src.color_format;
+    const int w = src.w, h = src.h;
+    const int usw = format == IM_CF_YUV420 || format == IM_CF_YUV422 ? 2 : 1;
+    const int ush = format == IM_CF_YUV420 || format == IM_CF_NV12 || format == IM_CF_P010LE ? 2 : 1;
+    const bool int16 = src.type == IM_DT_INT16 || src.type == IM_DT_INT16_BE;
+    const bool interleaved = format == IM_CF_NV12 || (format == IM_CF_P010LE && int16);
+    const float scale = src.type == IM_DT_INT8 ? in_scale : int16 ? (format == IM_CF_P010LE ? 65535.f : in_scale) : 1.f;
+    const float y_offset = src.color_range == IM_CR_NARROW_RANGE ? 16.0f / 255.0f : 0.f;
+    ImGui::ImMat yuv;
+    yuv.create_type(w * h, 3, IM_DT_FLOAT32);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            size_t u_index, v_index;
+            if (interleaved)
+            {
+                u_index = (size_t)w * h + 2 * (((y / 2) * w) / 2 + x / 2);
+                v_index = u_index + 1;
+            }
+            else
+            {
+                u_index = (size_t)w * h + ((y / ush) * w) / usw + x / usw;
+                v_index = (format == IM_CF_YUV444 ? 2 * (size_t)w * h : (size_t)w * h + (w / usw) * (h / ush)) + ((y / ush) * w) / usw + x / usw;
+            }
+            const int i = y * w + x;
+            yuv.at<float>(i, 0) = Load(src, (size_t)i) / scale - y_offset;
+            yuv.at<float>(i, 1) = Load(src, u_index) / scale - 0.5f;
+            yuv.at<float>(i, 2) = Load(src, v_index) / scale - 0.5f;
+        }
+    }
+    ImGui::ImMat matrix = *ImGui::color_table[0][src.color_range][src.color_space];
+    ImGui::ImMat rgb = matrix * yuv;
+    rgb.clip(0.f, 1.f);
+    return rgb;
+}
+
+// RGB2YUV shader, color table matrix product plus offset, chroma is taken
+// from first pixel of every chroma block
+static void GoldenRGBA2YUV(const ImGui::ImMat& src, ImGui::ImMat& dst, ImColorFormat format, ImColorSpace space, ImColorRange range, float out_scale)
+{
+    const int w = src.w, h = src.h;
+    const size_t cstep = dst.cstep;
+    const int usw = format == IM_CF_YUV420 || format == IM_CF_YUV422 ? 2 : 1;
+    const int ush = format == IM_CF_YUV420 || format == IM_CF_NV12 ? 2 : 1;
+    const bool int16 = dst.type == IM_DT_INT16 || dst.type == IM_DT_INT16_BE;
+    const bool p010 = format == IM_CF_P010LE && int16;
+    const bool interleaved = format == IM_CF_NV12 || p010;
+    const float in_scale = src.type == IM_DT_INT8 ? 255.f : src.type == IM_DT_INT16 || src.type == IM_DT_INT16_BE ? 65535.f : 1.f;
+    const float offset[3] = { range == IM_CR_NARROW_RANGE ? 16.0f / 255.0f : 0.f, 0.5f, 0.5f };
+    int map[4];
+    Mapping(src.color_format, map);
+    ImGui::ImMat rgb;
+    rgb.create_type(w * h, 3, IM_DT_FLOAT32);
+    for (int i = 0; i < w * h; i++)
+    {
+        const size_t o = (size_t)i * src.c;
+        for (int k = 0; k < 3; k++)
+            rgb.at<float>(i, k) = Load(src, o + map[k]) / in_scale;
+    }
+    ImGui::ImMat matrix = *ImGui::color_table[1][range][space];
+    ImGui::ImMat yuv = matrix * rgb;
+    for (int i = 0; i < w * h; i++)
+        for (int k = 0; k < 3; k++)
+            yuv.at<float>(i, k) += offset[k];
+    yuv.clip(0.f, 1.f);
+    auto store = [&](size_t i, float v)
+    {
+        if (int16)
+        {
+            uint16_t q = p010 ? (uint16_t)((uint32_t)floorf(v * 255.f) | (uint32_t)floorf(v * 65535.f))
+                              : (uint16_t)std::min(std::max(floorf(v * out_scale), 0.f), out_scale);
+            ((uint16_t *)dst.data)[i] = dst.type == IM_DT_INT16_BE ? Swap16(q) : q;
+        }
+        else
+            Store(dst, i, v);
+    };
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            const int i = y * w + x;
+            store((size_t)i, yuv.at<float>(i, 0));
+            if (interleaved)
+            {
+                if (x % 2 || y % 2) continue;
+                const size_t u_index = cstep + 2 * (((y / 2) * w) / 2 + x / 2);
+                store(u_index, yuv.at<float>(i, 1));
+                store(u_index + 1, yuv.at<float>(i, 2));
+            }
+            else
+            {
+                if (x % usw || y % ush) continue;
+                const size_t uv = ((y / ush) * w) / usw + x / usw;
+                store(cstep + uv, yuv.at<float>(i, 1));
+                store((format == IM_CF_YUV444 ? 2 * cstep : cstep + (w / usw) * (h / ush)) + uv, yuv.at<float>(i, 2));
+            }
+        }
+    }
+}
+
+static bool SameData(const ImGui::ImMat& a, const ImGui::ImMat& b, size_t elements)
+{
+    return a.data && b.data && a.elemsize == b.elemsize && memcmp(a.data, b.data, elements * a.elemsize) == 0;
+}
+
+// largest difference in units of last place of integer output
+static double MaxDiff(const ImGui::ImMat& a, const ImGui::ImMat& b)
+{
+    double diff = 0;
+    const double unit = a.type == IM_DT_FLOAT16 || a.type == IM_DT_FLOAT32 ? 1.0 / 255.0 : 1.0;
+    const size_t n = std::min((size_t)a.w * a.h * a.c, (size_t)b.w * b.h * b.c);
+    for (size_t i = 0; i < n; i++)
+        diff = std::max(diff, fabs((double)Load(a, i) - (double)Load(b, i)) / unit);
+    return diff;
+}
+
+struct SourceType { ImDataType type; int depth; };
+
+static void TestYUV2RGBA(ImGui::ColorConvert_vulkan* gpu)
+{
+    const ImColorFormat formats[] = { IM_CF_YUV420, IM_CF_YUV422, IM_CF_YUV444, IM_CF_NV12, IM_CF_P010LE };
+    const SourceType sources[] = { {IM_DT_INT8, 8}, {IM_DT_INT16, 10}, {IM_DT_INT16, 16}, {IM_DT_INT16_BE, 10}, {IM_DT_FLOAT16, 16}, {IM_DT_FLOAT32, 32} };
+    const ImColorFormat outputs[] = { IM_CF_ABGR, IM_CF_ARGB, IM_CF_BGRA, IM_CF_RGBA };
+    const ImDataType out_types[] = { IM_DT_INT8, IM_DT_INT16, IM_DT_FLOAT16, IM_DT_FLOAT32 };
+    // wider than cpu row chunk, width isn't multiple of simd width
+    const int w = 270, h = 12;
+    double gpu_diff = 0;
+    char what[256];
+    for (auto format : formats)
+    for (auto source : sources)
+    for (int space = IM_CS_SRGB; space <= IM_CS_BT2020; space++)
+    for (int range = IM_CR_FULL_RANGE; range <= IM_CR_NARROW_RANGE; range++)
+    {
+        ImGui::ImMat yuv;
+        yuv.create_type(w, h, ImGui::GetChannelCountByColorFormat(format), source.type);
+        yuv.color_format = format;
+        yuv.color_space = (ImColorSpace)space;
+        yuv.color_range = (ImColorRange)range;
+        yuv.depth = source.depth;
+        FillPattern(yuv, MaxValue(source.type, source.depth), (uint32_t)(format * 131 + source.depth * 7 + space * 3 + range));
+        const float in_scale = MaxValue(source.type, source.depth);
+        const ImGui::ImMat golden = GoldenYUV2RGB(yuv, in_scale);
+        for (auto output : outputs)
+        for (auto out_type : out_types)
+        {
+            ImGui::ImMat expected, result;
+            expected.create_type(w, h, 4, out_type);
+            expected.color_format = output;
+            result.create_type(w, h, 4, out_type);
+            result.color_format = output;
+            StorePixels(golden, expected);
+            bool ok = ImGui::ColorConvert_cpu::YUV2RGBA(yuv, result, IM_INTERPOLATE_NEAREST, in_scale);
+            snprintf(what, sizeof(what), "YUV2RGBA %s %s %d bits space %d range %d -> %s %s",
+                FormatName(format), TypeName(source.type), source.depth, space, range, FormatName(output), TypeName(out_type));
+            Check(ok && SameData(expected, result, (size_t)w * h * 4), what);
+
+            if (gpu && source.type != IM_DT_INT16_BE && out_type != IM_DT_FLOAT32)
+            {
+                ImGui::ImMat shader;
+                shader.type = out_type;
+                shader.color_format = output;
+                if (gpu->YUV2RGBA(yuv, shader, IM_INTERPOLATE_NEAREST) > 0)
+                    gpu_diff = std::max(gpu_diff, MaxDiff(result, shader));
+            }
+        }
+    }
+    if (gpu)
+        fprintf(stdout, "  YUV2RGBA shader output max difference: %.2f LSB\n", gpu_diff);
+    Check(gpu_diff <= 1.0, "YUV2RGBA shader output differs by more than 1 LSB");
+}
+
+static void TestRGBA2YUV(ImGui::ColorConvert_vulkan* gpu)
+{
+    const ImColorFormat formats[] = { IM_CF_YUV420, IM_CF_YUV422, IM_CF_YUV444, IM_CF_NV12, IM_CF_P010LE };
+    const ImColorFormat inputs[] = { IM_CF_ABGR, IM_CF_ARGB, IM_CF_BGRA, IM_CF_RGBA, IM_CF_BGR, IM_CF_RGB };
+    const SourceType outputs[] = { {IM_DT_INT8, 8}, {IM_DT_INT16, 10}, {IM_DT_INT16, 16}, {IM_DT_FLOAT16, 16}, {IM_DT_FLOAT32, 32} };
+    const ImDataType in_types[] = { IM_DT_INT8, IM_DT_INT16, IM_DT_FLOAT32 };
+    const int w = 266, h = 10;
+    double gpu_diff = 0;
+    char what[256];
+    for (auto input : inputs)
+    for (auto in_type : in_types)
+    {
+        ImGui::ImMat rgb;
+        const int channels = input == IM_CF_BGR || input == IM_CF_RGB ? 3 : 4;
+        rgb.create_type(w, h, channels, in_type);
+        rgb.color_format = input;
+        FillPattern(rgb, MaxValue(in_type, in_type == IM_DT_INT8 ? 8 : 16), (uint32_t)(input * 17 + in_type));
+        for (auto format : formats)
+        for (auto output : outputs)
+        for (int space = IM_CS_SRGB; space <= IM_CS_BT2020; space++)
+        for (int range = IM_CR_FULL_RANGE; range <= IM_CR_NARROW_RANGE; range++)
+        {
+            const float out_scale = MaxValue(output.type, output.depth);
+            ImGui::ImMat expected, result;
+            expected.create_type(w, h, 4, output.type);
+            result.create_type(w, h, 4, output.type);
+            memset(expected.data, 0, expected.total() * expected.elemsize);
+            memset(result.data, 0, result.total() * result.elemsize);
+            GoldenRGBA2YUV(rgb, expected, format, (ImColorSpace)space, (ImColorRange)range, out_scale);
+            bool ok = ImGui::ColorConvert_cpu::RGBA2YUV(rgb, result, format, (ImColorSpace)space, (ImColorRange)range, out_scale);
+            snprintf(what, sizeof(what), "RGBA2YUV %s %s -> %s %s %d bits space %d range %d",
+                FormatName(input), TypeName(in_type), FormatName(format), TypeName(output.type), output.depth, space, range);
+            Check(ok && SameData(expected, result, result.total()), what);
+
+            // shader writes chroma from any pixel of its block, only luma is comparable
+            if (gpu && channels == 4 && in_type != IM_DT_FLOAT32 && output.type != IM_DT_FLOAT32)
+            {
+                ImGui::ImMat shader;
+                shader.type = output.type;
+                shader.color_format = format;
+                shader.color_space = (ImColorSpace)space;
+                shader.color_range = (ImColorRange)range;
+                shader.depth = output.depth;
+                if (gpu->RGBA2YUV(rgb, shader) > 0)
+                {
+                    ImGui::ImMat luma_cpu(w, h, result.data, result.elemsize), luma_gpu(w, h, shader.data, shader.elemsize);
+                    luma_cpu.type = luma_gpu.type = output.type;
+                    gpu_diff = std::max(gpu_diff, MaxDiff(luma_cpu, luma_gpu));
+                }
+            }
+        }
+    }
+    if (gpu)
+        fprintf(stdout, "  RGBA2YUV shader luma max difference: %.2f LSB\n", gpu_diff);
+    Check(gpu_diff <= 1.0, "RGBA2YUV shader output differs by more than 1 LSB");
+}
+
+static void TestGrayAndConv()
+{
+    const ImDataType types[] = { IM_DT_INT8, IM_DT_INT16, IM_DT_FLOAT16, IM_DT_FLOAT32 };
+    const ImColorFormat outputs[] = { IM_CF_ABGR, IM_CF_ARGB, IM_CF_BGRA, IM_CF_RGBA };
+    const ImColorFormat inputs[] = { IM_CF_ABGR, IM_CF_ARGB, IM_CF_BGRA, IM_CF_RGBA, IM_CF_BGR, IM_CF_RGB };
+    const int w = 261, h = 9;
+    char what[256];
+    for (auto in_type : types)
+    for (auto out_type : types)
+    {
+        // GRAY2RGBA, 10 bits for 16 bits integer input
+        const int depth = in_type == IM_DT_INT8 ? 8 : 10;
+        const float in_scale = MaxValue(IM_DT_INT16, depth);
+        ImGui::ImMat gray;
+        gray.create_type(w, h, 1, in_type);
+        FillPattern(gray, MaxValue(in_type, depth), (uint32_t)(in_type * 5 + out_type));
+        for (auto output : outputs)
+        {
+            ImGui::ImMat expected, result;
+            expected.create_type(w, h, 4, out_type);
+            expected.color_format = output;
+            result.create_type(w, h, 4, out_type);
+            result.color_format = output;
+            int map[4];
+            Mapping(output, map);
+            const float divisor = in_type == IM_DT_FLOAT16 || in_type == IM_DT_FLOAT32 ? 1.f : in_scale;
+            for (int i = 0; i < w * h; i++)
+            {
+                const float v = Load(gray, i) / divisor;
+                Store(expected, (size_t)i * 4 + map[0], v);
+                Store(expected, (size_t)i * 4 + map[1], v);
+                Store(expected, (size_t)i * 4 + map[2], v);
+                Store(expected, (size_t)i * 4 + map[3], 1.f);
+            }
+            bool ok = ImGui::ColorConvert_cpu::GRAY2RGBA(gray, result, in_scale);
+            snprintf(what, sizeof(what), "GRAY2RGBA %s -> %s %s", TypeName(in_type), FormatName(output), TypeName(out_type));
+            Check(ok && SameData(expected, result, (size_t)w * h * 4), what);
+        }
+
+        // Conv, every input layout to ABGR
+        for (auto input : inputs)
+        {
+            const int channels = input == IM_CF_BGR || input == IM_CF_RGB ? 3 : 4;
+            ImGui::ImMat rgb, expected, result;
+            rgb.create_type(w, h, channels, in_type);
+            rgb.color_format = input;
+            FillPattern(rgb, MaxValue(in_type, in_type == IM_DT_INT8 ? 8 : 16), (uint32_t)(input * 3 + in_type));
+            expected.create_type(w, h, 4, out_type);
+            result.create_type(w, h, 4, out_type);
+            int map[4];
+            Mapping(input, map);
+            const float divisor = in_type == IM_DT_INT8 ? 255.f : in_type == IM_DT_INT16 ? 65535.f : 1.f;
+            for (int i = 0; i < w * h; i++)
+            {
+                const size_t o = (size_t)i * channels;
+                for (int k = 0; k < 3; k++)
+                    Store(expected, (size_t)i * 4 + k, Load(rgb, o + map[k]) / divisor);
+                Store(expected, (size_t)i * 4 + 3, channels == 4 ? Load(rgb, o + map[3]) / divisor : 1.f);
+            }
+            bool ok = ImGui::ColorConvert_cpu::Conv(rgb, result);
+            snprintf(what, sizeof(what), "Conv %s %s -> ABGR %s", FormatName(input), TypeName(in_type), TypeName(out_type));
+            Check(ok && SameData(expected, result, (size_t)w * h * 4), what);
+        }
+    }
+}
+
+static void TestResize(ImGui::ColorConvert_vulkan* gpu)
+{
+    const ImInterpolateMode modes[] = { IM_INTERPOLATE_NEAREST, IM_INTERPOLATE_BILINEAR, IM_INTERPOLATE_BICUBIC, IM_INTERPOLATE_AREA };
+    const int sizes[][2] = { {1280, 720}, {320, 180}, {2560, 1440} };
+    ImGui::ImMat yuv;
+    yuv.create_type(1920, 1080, 2, IM_DT_INT8);
+    yuv.color_format = IM_CF_NV12;
+    yuv.color_space = IM_CS_BT709;
+    yuv.color_range = IM_CR_NARROW_RANGE;
+    FillPattern(yuv, 255.f, 7);
+    double gpu_diff = 0;
+    char what[256];
+    for (auto mode : modes)
+    for (auto size : sizes)
+    {
+        ImGui::ImMat result;
+        result.create_type(size[0], size[1], 4, IM_DT_INT8);
+        result.color_format = IM_CF_RGBA;
+        bool ok = ImGui::ColorConvert_cpu::YUV2RGBA(yuv, result, mode, 255.f);
+        snprintf(what, sizeof(what), "YUV2RGBA resize NV12 1920x1080 -> %dx%d mode %d", size[0], size[1], mode);
+        Check(ok, what);
+        if (gpu && ok)
+        {
+            ImGui::ImMat shader;
+            shader.w = size[0];
+            shader.h = size[1];
+            shader.type = IM_DT_INT8;
+            shader.color_format = IM_CF_RGBA;
+            if (gpu->YUV2RGBA(yuv, shader, mode) > 0)
+                gpu_diff = std::max(gpu_diff, MaxDiff(result, shader));
+        }
+    }
+    if (gpu)
+        fprintf(stdout, "  YUV2RGBA resize shader output max difference: %.2f LSB\n", gpu_diff);
+    Check(gpu_diff <= 1.0, "YUV2RGBA resize shader output differs by more than 1 LSB");
+}
+
+static void Benchmark(const char* label, int iterations, const std::function<bool()>& func)
+{
+    func();
+    auto start = Clock::now();
+    bool ok = true;
+    for (int i = 0; i < iterations; i++)
+        ok &= func();
+    const double ms = ElapsedMs(start) / iterations;
+    fprintf(stdout, "  %-36s %8.3f ms  %8.1f Mpixel/s%s\n", label, ms, 1920.0 * 1080.0 / 1000.0 / ms, ok ? "" : "  FAILED");
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    ImGui::ColorConvert_vulkan* gpu = nullptr;
+    if (ImGui::get_gpu_count() > 0)
+        gpu = new ImGui::ColorConvert_vulkan(ImGui::get_default_gpu_index());
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, cpu output is compared with shader" : "no, cpu backend only");
+
+    auto start = Clock::now();
+    TestYUV2RGBA(gpu);
+    TestRGBA2YUV(gpu);
+    TestGrayAndConv();
+    TestResize(gpu);
+    fprintf(stdout, "golden check: %d conversions, %d mismatches (%.1f s)\n", g_checks, g_failures, ElapsedMs(start) / 1000.0);
+
+    fprintf(stdout, "1080p throughput:\n");
+    ImGui::ImMat nv12, yuv420, rgba, rgba16, out;
+    nv12.create_type(1920, 1080, 2, IM_DT_INT8);
+    nv12.color_format = IM_CF_NV12;
+    nv12.color_space = IM_CS_BT709;
+    nv12.color_range = IM_CR_NARROW_RANGE;
+    FillPattern(nv12, 255.f, 1);
+    yuv420.create_type(1920, 1080, 2, IM_DT_INT16);
+    yuv420.color_format = IM_CF_YUV420;
+    yuv420.color_space = IM_CS_BT2020;
+    yuv420.color_range = IM_CR_NARROW_RANGE;
+    yuv420.depth = 10;
+    FillPattern(yuv420, 1023.f, 2);
+    rgba.create_type(1920, 1080, 4, IM_DT_INT8);
+    rgba.color_format = IM_CF_RGBA;
+    rgba16.create_type(1920, 1080, 4, IM_DT_INT16);
+    rgba16.color_format = IM_CF_RGBA;
+    out.create_type(1920, 1080, 4, IM_DT_INT8);
+    Benchmark("NV12 int8 -> RGBA int8", iterations, [&]() { return ImGui::ColorConvert_cpu::YUV2RGBA(nv12, rgba, IM_INTERPOLATE_NEAREST, 255.f); });
+    Benchmark("YUV420 10 bits -> RGBA int16", iterations, [&]() { return ImGui::ColorConvert_cpu::YUV2RGBA(yuv420, rgba16, IM_INTERPOLATE_NEAREST, 1023.f); });
+    Benchmark("RGBA int8 -> NV12 int8", iterations, [&]() { return ImGui::ColorConvert_cpu::RGBA2YUV(rgba, out, IM_CF_NV12, IM_CS_BT709, IM_CR_NARROW_RANGE, 255.f); });
+    Benchmark("RGBA int8 -> ABGR int8", iterations, [&]() { return ImGui::ColorConvert_cpu::Conv(rgba, out); });
+
+    if (gpu)
+        delete gpu;
+    return Result();
+}
@@ -0,0 +1,164 @@
+// Curve evaluation benchmark.
+//
+// KeyPointEditor curves with every curve type are evaluated by GetValue, by GetValues on sorted
+// and on shuffled times, and by the former linear scan copied below as reference. Batch and
+// single values must be the same, reference may differ by float rounding. Then 200 curves are
+// evaluated at audio rate for one 60 Hz frame, 800 sorted times each.
+//
+// usage: curve_benchmark [iterations]
+
+#include <imgui.h>
+#include <imgui_curve.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "test_utils.h"
+
+// GetValue before segment cache, linear scan and normalized smoothstep
+static float ReferenceValue(ImGui::KeyPointEditor& editor, size_t curveIndex, float t)
+{
+    auto range = editor.GetMax() - editor.GetMin() + ImVec2(1.f, 0.f);
+    auto value_range = fabs(editor.GetCurveMax(curveIndex) - editor.GetCurveMin(curveIndex));
+    auto pointToRange = [&](ImVec2 pt) { return (pt - editor.GetMin()) / range; };
+    const size_t ptCount = editor.GetCurvePointCount(curveIndex);
+    if (ptCount <= 0)
+        return 0;
+    const ImGui::ImCurveEdit::KeyPoint* pts = editor.GetPoints(curveIndex);
+    if (ptCount <= 1)
+        return pointToRange(pts[0].point).x;
+    for (int i = 0; i < (int)ptCount - 1; i++)
+    {
+        if (t >= pts[i].point.x && t <= pts[i + 1].point.x)
+        {
+            const ImVec2 p1 = pointToRange(pts[i].point);
+            const ImVec2 p2 = pointToRange(pts[i + 1].point);
+            float x = (t - pts[i].point.x) / (pts[i + 1].point.x - pts[i].point.x);
+            const ImVec2 sp = ImLerp(p1, p2, x);
+            ImGui::ImCurveEdit::CurveType type = (t - pts[i].point.x) < (pts[i + 1].point.x - t) ? pts[i].type : pts[i + 1].type;
+            const float rt = ImGui::ImCurveEdit::smoothstep(p1.x, p2.x, sp.x, type);
+            return ImLerp(p1.y, p2.y, rt) * value_range + editor.GetCurveMin(curveIndex);
+        }
+    }
+    return 0;
+}
+
+static uint32_t g_seed = 0x1234567;
+
+static float Random()
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return (float)(g_seed >> 8) / (float)(1 << 24);
+}
+
+// curve over [0, length] with a key point every length / (points - 1), point types cycle when mixed
+static void AddCurve(ImGui::KeyPointEditor& editor, int type, int points, float length, bool mixed = true)
+{
+    const int index = editor.AddCurve("curve" + std::to_string(editor.GetCurveCount()), (ImGui::ImCurveEdit::CurveType)type, IM_COL32_WHITE, true, -2.f, 3.f, 0.f);
+    for (int i = 0; i < points; i++)
+        editor.AddPoint(index, ImVec2(length * i / (points - 1), Random()), (ImGui::ImCurveEdit::CurveType)(mixed ? (type + i) % (ImGui::ImCurveEdit::BounceInOut + 1) : type));
+}
+
+static void CheckCurves()
+{
+    ImGui::KeyPointEditor editor;
+    editor.SetRangeX(0.f, 1000.f, false);
+    const int types = ImGui::ImCurveEdit::BounceInOut + 1;
+    for (int type = 0; type < types; type++)
+        AddCurve(editor, type, 2 + type % 7, 1000.f);
+
+    // sorted times with key points hit exactly and times outside, then shuffled
+    std::vector<float> ts;
+    for (int i = -20; i <= 10020; i++) ts.push_back(i * 0.1f);
+    for (int i = 0; i <= 6; i++) ts.push_back(1000.f * i / 6);
+    std::sort(ts.begin(), ts.end());
+    std::vector<float> shuffled = ts;
+    for (size_t i = shuffled.size() - 1; i > 0; i--)
+        std::swap(shuffled[i], shuffled[(size_t)(Random() * i)]);
+
+    std::vector<float> values(ts.size()), values_shuffled(ts.size());
+    float max_diff = 0;
+    bool same = true, outside = true;
+    for (size_t c = 0; c < editor.GetCurveCount(); c++)
+    {
+        editor.GetValues(c, ts.data(), values.data(), (int)ts.size());
+        editor.GetValues(c, shuffled.data(), values_shuffled.data(), (int)shuffled.size());
+        for (size_t i = 0; i < ts.size(); i++)
+        {
+            same &= values[i] == editor.GetValue(c, ts[i]);
+            same &= values_shuffled[i] == editor.GetValue(c, shuffled[i]);
+            max_diff = std::max(max_diff, fabsf(values[i] - ReferenceValue(editor, c, ts[i])));
+            if (ts[i] < 0 || ts[i] > 1000.f)
+                outside &= values[i] == 0;
+        }
+    }
+    fprintf(stdout, "  max difference to linear scan %.7f\n", max_diff);
+    Check(same, "GetValues differs from GetValue");
+    Check(outside, "value outside of key points");
+    Check(max_diff < 1e-4f, "GetValues differs from linear scan");
+
+    // cache follows edits
+    const float t = 400.f;
+    editor.EditPoint(0, 1, ImVec2(editor.GetPoint(0, 1).point.x, 2.5f), ImGui::ImCurveEdit::Linear);
+    Check(fabsf(editor.GetValue(0, t) - ReferenceValue(editor, 0, t)) < 1e-4f, "EditPoint");
+    editor.AddPoint(0, ImVec2(t, 0.9f), ImGui::ImCurveEdit::Smooth);
+    Check(fabsf(editor.GetValue(0, t) - (0.9f * 5.f - 2.f)) < 1e-4f, "AddPoint");
+    editor.DeletePoint(0, 0);
+    Check(fabsf(editor.GetValue(0, 0.f) - ReferenceValue(editor, 0, 0.f)) < 1e-4f, "DeletePoint");
+    editor.SetCurveMax(0, 13.f);
+    Check(fabsf(editor.GetValue(0, t) - (0.9f * 15.f - 2.f)) < 1e-4f, "SetCurveMax");
+    // value range is applied when read, so a range changed by reference needs no cache update
+    editor.GetMax().y *= 2.f;
+    Check(fabsf(editor.GetValue(0, t) - ReferenceValue(editor, 0, t)) < 1e-4f, "GetMax by reference");
+    editor.GetMax().y /= 2.f;
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    fprintf(stdout, "check of curves:\n");
+    CheckCurves();
+
+    // 200 curves of 10 seconds with 16 key points, one 60 Hz frame at 48 kHz
+    const int curves = 200, samples = 48000 / 60;
+    std::vector<float> ts(samples), values(samples);
+    for (int i = 0; i < samples; i++)
+        ts[i] = 5000.f + i * (1000.f / 48000.f);
+    float sum = 0;
+    for (int mixed = 0; mixed < 2; mixed++)
+    {
+        ImGui::KeyPointEditor editor;
+        editor.SetRangeX(0.f, 10000.f, false);
+        for (int c = 0; c < curves; c++)
+            AddCurve(editor, ImGui::ImCurveEdit::Smooth, 16, 10000.f, mixed != 0);
+        const double scan = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+                for (int i = 0; i < samples; i++)
+                    sum += ReferenceValue(editor, c, ts[i]);
+        });
+        const double single = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+                for (int i = 0; i < samples; i++)
+                    sum += editor.GetValue(c, ts[i]);
+        });
+        const double batch = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+            {
+                editor.GetValues(c, ts.data(), values.data(), samples);
+                sum += values[samples - 1];
+            }
+        });
+        fprintf(stdout, "%d curves x %d samples, %s:\n", curves, samples, mixed ? "mixed curve types" : "Smooth");
+        fprintf(stdout, "  linear scan %8.3f ms\n", scan);
+        fprintf(stdout, "  GetValue    %8.3f ms  speedup %.2fx\n", single, scan / single);
+        fprintf(stdout, "  GetValues   %8.3f ms  speedup %.2fx\n", batch, scan / batch);
+    }
+    if (sum == 0)
+        fprintf(stdout, "\n");
+
+    return Result();
+}
@@ -0,0 +1,272 @@
+// Baked curve table benchmark.
+//
+// KeyPointEditor curves of every curve type and Catmull-Rom splines are baked into ImCurveTable,
+// the table is checked against GetValue and ImSpline::EvaluateY at random times, every bake must report
+// success and stay within the tolerance, steps included, without growing to the size cap. Re-baking after
+// point edits must match a full bake and evaluate less. Then 200 curves are sampled at audio rate for one 60 Hz frame, 800
+// sorted times each, by GetValue, GetValues and the tables, and the same for splines.
+//
+// usage: curve_table_benchmark [iterations]
+
+#include <imgui.h>
+#include <imgui_curve.h>
+#include <imgui_spline.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "test_utils.h"
+
+static uint32_t g_seed = 0x1234567;
+
+static float Random()
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return (float)(g_seed >> 8) / (float)(1 << 24);
+}
+
+// curve over [0, length] with a key point every length / (points - 1), point types cycle when mixed
+static void AddCurve(ImGui::KeyPointEditor& editor, int type, int points, float length, bool mixed = true)
+{
+    const int index = editor.AddCurve("curve" + std::to_string(editor.GetCurveCount()), (ImGui::ImCurveEdit::CurveType)type, IM_COL32_WHITE, true, -2.f, 3.f, 0.f);
+    for (int i = 0; i < points; i++)
+        editor.AddPoint(index, ImVec2(length * i / (points - 1), Random()), (ImGui::ImCurveEdit::CurveType)(mixed ? (type + i) % (ImGui::ImCurveEdit::BounceInOut + 1) : type));
+}
+
+// splines through points every length / (points - 1), monotonic in x
+static std::vector<ImGui::ImSpline::cSpline2> MakeSplines(int points, float length)
+{
+    std::vector<ImVec2> p(points);
+    for (int i = 0; i < points; i++)
+        p[i] = ImVec2(length * i / (points - 1), Random() * 5.f - 2.f);
+    std::vector<ImGui::ImSpline::cSpline2> splines(ImGui::ImSpline::NumSplinesForPoints(points));
+    splines.resize(ImGui::ImSpline::SplinesFromPoints(points, p.data(), (int)splines.size(), splines.data()));
+    return splines;
+}
+
+static float TableError(const ImGui::ImCurveTable& table, const std::function<float(float)>& source, int count)
+{
+    float error = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const float x = table.x0 + (table.x1 - table.x0) * Random();
+        error = std::max(error, fabsf(table.Sample(x) - source(x)));
+    }
+    return error;
+}
+
+static void CheckCurves()
+{
+    const float tolerance = 1e-3f;
+    ImGui::KeyPointEditor editor;
+    editor.SetRangeX(0.f, 1000.f, false);
+    const int types = ImGui::ImCurveEdit::BounceInOut + 1;
+    for (int type = 0; type < types; type++)
+        AddCurve(editor, type, 2 + type % 7, 1000.f, false);
+
+    float max_ratio = 0;
+    int within = 0, max_intervals = 0;
+    std::vector<ImGui::ImCurveTable> tables(editor.GetCurveCount());
+    for (size_t c = 0; c < editor.GetCurveCount(); c++)
+    {
+        const bool ok = editor.BakeCurve(c, tables[c], tolerance);
+        const float error = TableError(tables[c], [&](float x) { return editor.GetValue(c, x); }, 20000);
+        if (ok && error <= tolerance && tables[c].Intervals() < tables[c].max_size)
+            within++;
+        else
+            fprintf(stdout, "  type %d: %d intervals, error %.7f, estimate %.7f\n", (int)c, tables[c].Intervals(), error, tables[c].max_error);
+        max_ratio = std::max(max_ratio, error / tolerance);
+        max_intervals = std::max(max_intervals, tables[c].Intervals());
+    }
+    fprintf(stdout, "  %d of %d curve types within tolerance, error up to %.2fx tolerance, up to %d intervals\n", within, types, max_ratio, max_intervals);
+    Check(within == types, "curve types within tolerance");
+
+    // single key point gives a constant table
+    ImGui::KeyPointEditor single;
+    single.SetRangeX(0.f, 1000.f, false);
+    single.AddCurve("single", ImGui::ImCurveEdit::Smooth, IM_COL32_WHITE, true, 0.f, 1.f, 0.f);
+    single.AddPoint(0, ImVec2(500.f, 0.5f), ImGui::ImCurveEdit::Smooth);
+    ImGui::ImCurveTable constant;
+    single.BakeCurve(0, constant);
+    Check(constant.Intervals() == 1 && constant.Sample(0.f) == single.GetValue(0, 500.f), "single point");
+
+    // re-bake after edits matches a full bake
+    ImGui::KeyPointEditor edited;
+    edited.SetRangeX(0.f, 10000.f, false);
+    AddCurve(edited, ImGui::ImCurveEdit::Smooth, 64, 10000.f);
+    ImGui::ImCurveTable table, full;
+    edited.BakeCurve(0, table, tolerance);
+    bool same = true;
+    for (int edit = 0; edit < 8; edit++)
+    {
+        const size_t point = 1 + (size_t)(Random() * 61);
+        switch (edit % 4)
+        {
+            case 0: edited.EditPoint(0, point, ImVec2(edited.GetPoint(0, point).point.x, Random() * 5.f - 2.f), ImGui::ImCurveEdit::Smooth); break;
+            case 1: edited.AddPoint(0, ImVec2(edited.GetPoint(0, point).point.x + 20.f, Random()), ImGui::ImCurveEdit::Linear); break;
+            case 2: edited.DeletePoint(0, point); break;
+            default: edited.SetCurvePointDefault(0, point); break;
+        }
+        edited.UpdateBakedCurve(0, table);
+        edited.BakeCurve(0, full, tolerance);
+        same &= table.Intervals() == full.Intervals() && table.starts == full.starts && table.max_error <= tolerance;
+        for (size_t i = 0; same && i < table.values.size(); i++)
+            same &= fabsf(table.values[i] - full.values[i]) <= 1e-5f;
+    }
+    Check(same, "UpdateBakedCurve differs from BakeCurve");
+    edited.SetCurveMax(0, 13.f);
+    const bool ok = edited.UpdateBakedCurve(0, table);
+    const float error = TableError(table, [&](float x) { return edited.GetValue(0, x); }, 20000);
+    Check(ok && error <= tolerance, "UpdateBakedCurve after SetCurveMax");
+}
+
+static void CheckSplines()
+{
+    const float tolerance = 1e-3f;
+    std::vector<ImGui::ImSpline::cSpline2> splines = MakeSplines(32, 1000.f);
+    const int count = (int)splines.size();
+
+    // EvaluateY inverts x of Position
+    float max_diff = 0;
+    for (int s = 0; s < count; s++)
+        for (int i = 0; i <= 16; i++)
+        {
+            const ImVec2 p = ImGui::ImSpline::Position(splines[s], i / 16.f);
+            float y = 0;
+            ImGui::ImSpline::EvaluateY(count, splines.data(), 1, &p.x, &y);
+            max_diff = std::max(max_diff, fabsf(y - p.y));
+        }
+    fprintf(stdout, "  EvaluateY difference to Position %.7f\n", max_diff);
+    Check(max_diff < 1e-3f, "EvaluateY");
+
+    ImGui::ImCurveTable table;
+    const bool ok = table.BakeSplines(count, splines.data(), tolerance);
+    const float error = TableError(table, [&](float x) { float y; ImGui::ImSpline::EvaluateY(count, splines.data(), 1, &x, &y); return y; }, 20000);
+    fprintf(stdout, "  spline table %d intervals, error %.7f, estimate %.7f\n", table.Intervals(), error, table.max_error);
+    Check(ok && error <= tolerance, "spline table error");
+
+    // moving one spline joint re-evaluates only the blocks around it
+    splines[10].yb.z += 0.1f;
+    splines[10].yb.w += 0.1f;
+    splines[11].yb.x += 0.1f;
+    splines[11].yb.y += 0.1f;
+    int evaluated = 0;
+    auto source = [&](const float* xs, float* out, int n) { evaluated += n; ImGui::ImSpline::EvaluateY(count, splines.data(), n, xs, out); };
+    table.Rebake(source, splines[10].xb.x, splines[11].xb.w);
+    const int partial = evaluated;
+    // same joints as BakeSplines
+    std::vector<float> joints;
+    for (int s = 1; s < count; s++)
+        joints.push_back(ImGui::ImSpline::Position0(splines[s]).x);
+    ImGui::ImCurveTable full;
+    evaluated = 0;
+    full.Bake(source, table.x0, table.x1, tolerance, 1 << 16, joints);
+    bool same = table.Intervals() == full.Intervals() && table.starts == full.starts;
+    for (size_t i = 0; same && i < table.values.size(); i++)
+        same &= table.values[i] == full.values[i];
+    fprintf(stdout, "  spline re-bake %d evaluations, full bake %d\n", partial, evaluated);
+    Check(same, "spline Rebake differs from Bake");
+    Check(partial < evaluated / 4, "spline Rebake evaluations");
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    fprintf(stdout, "check of curve tables:\n");
+    CheckCurves();
+    fprintf(stdout, "check of spline tables:\n");
+    CheckSplines();
+
+    // 200 curves of 10 seconds with 16 key points, one 60 Hz frame at 48 kHz
+    const int curves = 200, samples = 48000 / 60;
+    std::vector<float> ts(samples), values(samples);
+    for (int i = 0; i < samples; i++)
+        ts[i] = 5000.f + i * (1000.f / 48000.f);
+    float sum = 0;
+    {
+        ImGui::KeyPointEditor editor;
+        editor.SetRangeX(0.f, 10000.f, false);
+        for (int c = 0; c < curves; c++)
+            AddCurve(editor, ImGui::ImCurveEdit::Smooth, 16, 10000.f, false);
+        std::vector<ImGui::ImCurveTable> tables(curves);
+        const double bake = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+                editor.BakeCurve(c, tables[c]);
+        });
+        size_t bytes = 0;
+        for (auto& table : tables) bytes += table.values.size() * sizeof(float);
+        const double rebake = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+            {
+                editor.EditPoint(c, 7, ImVec2(editor.GetPoint(c, 7).point.x, Random() * 5.f - 2.f), ImGui::ImCurveEdit::Smooth);
+                editor.UpdateBakedCurve(c, tables[c]);
+            }
+        });
+        const double single = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+                for (int i = 0; i < samples; i++)
+                    sum += editor.GetValue(c, ts[i]);
+        });
+        const double batch = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+            {
+                editor.GetValues(c, ts.data(), values.data(), samples);
+                sum += values[samples - 1];
+            }
+        });
+        const double sample = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+                for (int i = 0; i < samples; i++)
+                    sum += tables[c].Sample(ts[i]);
+        });
+        const double sample_batch = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+            {
+                tables[c].Sample(ts.data(), values.data(), samples);
+                sum += values[samples - 1];
+            }
+        });
+        fprintf(stdout, "%d curves x %d samples, Smooth, %zu KB of tables:\n", curves, samples, bytes / 1024);
+        fprintf(stdout, "  BakeCurve        %8.3f ms\n", bake);
+        fprintf(stdout, "  EditPoint+Update %8.3f ms\n", rebake);
+        fprintf(stdout, "  GetValue         %8.3f ms\n", single);
+        fprintf(stdout, "  GetValues        %8.3f ms  speedup %.2fx\n", batch, single / batch);
+        fprintf(stdout, "  Sample           %8.3f ms  speedup %.2fx\n", sample, single / sample);
+        fprintf(stdout, "  Sample batch     %8.3f ms  speedup %.2fx\n", sample_batch, single / sample_batch);
+    }
+    {
+        std::vector<std::vector<ImGui::ImSpline::cSpline2>> splines(curves);
+        std::vector<ImGui::ImCurveTable> tables(curves);
+        for (int c = 0; c < curves; c++)
+        {
+            splines[c] = MakeSplines(16, 10000.f);
+            tables[c].BakeSplines((int)splines[c].size(), splines[c].data());
+        }
+        const double evaluate = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+            {
+                ImGui::ImSpline::EvaluateY((int)splines[c].size(), splines[c].data(), samples, ts.data(), values.data());
+                sum += values[samples - 1];
+            }
+        });
+        const double sample_batch = Measure(iterations, [&]() {
+            for (int c = 0; c < curves; c++)
+            {
+                tables[c].Sample(ts.data(), values.data(), samples);
+                sum += values[samples - 1];
+            }
+        });
+        fprintf(stdout, "%d splines x %d samples:\n", curves, samples);
+        fprintf(stdout, "  EvaluateY        %8.3f ms\n", evaluate);
+        fprintf(stdout, "  Sample batch     %8.3f ms  speedup %.2fx\n", sample_batch, evaluate / sample_batch);
+    }
+    if (sum == 0)
+        fprintf(stdout, "\n");
+
+    return Result();
+}
@@ -0,0 +1,209 @@
+// Filter graph benchmark.
+//
+// Brightness, contrast, gamma, exposure, saturation, hue and color invert are applied by one
+// FilterGraph_vulkan and checked against a per pixel reference of shaders math. When a vulkan
+// device is present, the same chain of separate filters, each one with its own upload, dispatch,
+// download and fence, is timed against the fused graph with one upload, dispatch and download,
+// and against frames submitted without waiting with two frames in flight. Without device the cpu point filter path is checked and timed.
+//
+// Software vulkan driver gives repeatable numbers without gpu, for example with mesa lavapipe:
+//   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json filter_graph_benchmark
+//
+// usage: filter_graph_benchmark [iterations]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <Brightness_vulkan.h>
+#include <Contrast_vulkan.h>
+#include <Gamma_vulkan.h>
+#include <Exposure_vulkan.h>
+#include <Saturation_vulkan.h>
+#include <Hue_vulkan.h>
+#include <ColorInvert_vulkan.h>
+#include <FilterGraph_vulkan.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "test_utils.h"
+
+static const float kBrightness = 0.05f, kContrast = 1.2f, kGamma = 0.9f, kExposure = 0.2f;
+static const float kSaturation = 1.3f, kHue = 30.f;
+
+// gradient with noise, width is not multiple of 8
+static ImGui::ImMat MakeFrame(int w, int h)
+{
+    ImGui::ImMat mat;
+    mat.create_type(w, h, 4, IM_DT_INT8);
+    uint32_t seed = 0x1234567;
+    for (int y = 0; y < h; y++)
+    {
+        uint8_t* p = (uint8_t *)mat.data + (size_t)y * w * 4;
+        for (int x = 0; x < w; x++, p += 4)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const int noise = (int)(seed >> 27) - 16;
+            p[0] = (uint8_t)std::min(std::max(x * 255 / w + noise, 0), 255);
+            p[1] = (uint8_t)std::min(std::max(y * 255 / h - noise, 0), 255);
+            p[2] = (uint8_t)std::min(std::max((x + y) * 255 / (w + h) + noise, 0), 255);
+            p[3] = (uint8_t)(seed >> 24);
+        }
+    }
+    return mat;
+}
+
+static void BuildGraph(ImGui::FilterGraph_vulkan& graph)
+{
+    graph.add(ImGui::FILTER_OP_BRIGHTNESS, kBrightness);
+    graph.add(ImGui::FILTER_OP_CONTRAST, kContrast);
+    graph.add(ImGui::FILTER_OP_GAMMA, kGamma);
+    graph.add(ImGui::FILTER_OP_EXPOSURE, kExposure);
+    graph.add(ImGui::FILTER_OP_SATURATION, kSaturation);
+    graph.add(ImGui::FILTER_OP_HUE, kHue);
+    graph.add(ImGui::FILTER_OP_COLOR_INVERT);
+}
+
+static inline float Clamp01(float v)
+{
+    return std::min(std::max(v, 0.f), 1.f);
+}
+
+// every filter as its own shader, in float
+static void Reference(const uint8_t* p, float out[4])
+{
+    float c[3] = {p[0] / 255.f, p[1] / 255.f, p[2] / 255.f};
+    for (int k = 0; k < 3; k++) c[k] = Clamp01(c[k] + kBrightness);
+    for (int k = 0; k < 3; k++) c[k] = Clamp01((c[k] - 0.5f) * kContrast + 0.5f);
+    for (int k = 0; k < 3; k++) c[k] = Clamp01(powf(c[k], kGamma));
+    for (int k = 0; k < 3; k++) c[k] = Clamp01(c[k] * powf(2.f, kExposure));
+    const float luminance = c[0] * 0.2125f + c[1] * 0.7154f + c[2] * 0.0721f;
+    for (int k = 0; k < 3; k++) c[k] = Clamp01(luminance * (1.f - kSaturation) + c[k] * kSaturation);
+    const float Y = c[0] * 0.299f + c[1] * 0.587f + c[2] * 0.114f;
+    float I = c[0] * 0.595716f - c[1] * 0.274453f - c[2] * 0.321263f;
+    float Q = c[0] * 0.211456f - c[1] * 0.522591f + c[2] * 0.31135f;
+    const float hue = atan2f(Q, I) - fmodf(kHue, 360.f) * (float)M_PI / 180.f;
+    const float chroma = sqrtf(I * I + Q * Q);
+    I = chroma * cosf(hue);
+    Q = chroma * sinf(hue);
+    c[0] = Clamp01(Y + I * 0.9563f + Q * 0.6210f);
+    c[1] = Clamp01(Y - I * 0.2721f - Q * 0.6474f);
+    c[2] = Clamp01(Y - I * 1.1070f + Q * 1.7046f);
+    for (int k = 0; k < 3; k++) out[k] = 1.f - c[k];
+    out[3] = p[3] / 255.f;
+}
+
+static void CheckGraph(ImGui::FilterGraph_vulkan& graph, float tolerance)
+{
+    ImGui::ImMat src = MakeFrame(203, 97);
+    ImGui::ImMat dst;
+    dst.type = IM_DT_FLOAT32;
+    graph.filter(src, dst);
+    Check(!dst.empty() && dst.w == src.w && dst.h == src.h && dst.c == 4, "graph output size");
+    if (dst.empty())
+        return;
+    float max_diff = 0;
+    for (size_t i = 0; i < (size_t)src.w * src.h; i++)
+    {
+        float ref[4];
+        Reference((const uint8_t *)src.data + i * 4, ref);
+        for (int k = 0; k < 4; k++)
+            max_diff = std::max(max_diff, fabsf(ref[k] - ((const float *)dst.data)[i * 4 + k]));
+    }
+    fprintf(stdout, "  max difference to reference %.6f\n", max_diff);
+    Check(max_diff <= tolerance, "graph differs from reference");
+
+    // changed value is applied without rebuilding graph
+    ImGui::FilterGraph_vulkan invert;
+    const int node = invert.add(ImGui::FILTER_OP_BRIGHTNESS, 0.f);
+    invert.add(ImGui::FILTER_OP_COLOR_INVERT);
+    invert.set_value(node, 1.f);
+    invert.filter(src, dst);
+    bool black = !dst.empty();
+    for (size_t i = 0; black && i < (size_t)src.w * src.h; i++)
+        black = ((const float *)dst.data)[i * 4] == 0.f;
+    Check(black, "set_value is not applied");
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+        return 1;
+
+    const bool gpu = ImGui::get_gpu_count() > 0;
+    const int device = gpu ? ImGui::get_default_gpu_index() : -1;
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, separate filters and fused graph are measured" : "no, cpu point filters only");
+
+    ImGui::FilterGraph_vulkan graph(device);
+    BuildGraph(graph);
+    fprintf(stdout, "check of 7 point filters:\n");
+    CheckGraph(graph, gpu ? 4.f / 255.f : 1e-5f);
+
+    const int w = 1920, h = 1080;
+    ImGui::ImMat src = MakeFrame(w, h);
+    ImGui::ImMat dst;
+    dst.type = IM_DT_INT8;
+    const double graph_ms = Measure(iterations, [&]() { graph.filter(src, dst); });
+    if (!gpu)
+    {
+        fprintf(stdout, "%dx%d cpu graph: %8.2f ms\n", w, h, graph_ms);
+    }
+    else
+    {
+        ImGui::Brightness_vulkan brightness(device);
+        ImGui::Contrast_vulkan contrast(device);
+        ImGui::Gamma_vulkan gamma(device);
+        ImGui::Exposure_vulkan exposure(device);
+        ImGui::Saturation_vulkan saturation(device);
+        ImGui::Hue_vulkan hue(device);
+        ImGui::ColorInvert_vulkan invert(device);
+        ImGui::ImMat a, b;
+        a.type = b.type = IM_DT_INT8;
+        const double chain_ms = Measure(iterations, [&]() {
+            brightness.filter(src, a, kBrightness);
+            contrast.filter(a, b, kContrast);
+            gamma.filter(b, a, kGamma);
+            exposure.filter(a, b, kExposure);
+            saturation.filter(b, a, kSaturation);
+            hue.filter(a, b, kHue);
+            invert.filter(b, a);
+        });
+        int max_diff = 0;
+        for (size_t i = 0; i < (size_t)w * h * 4 && !a.empty() && !dst.empty(); i++)
+            max_diff = std::max(max_diff, std::abs((int)((const uint8_t *)a.data)[i] - (int)((const uint8_t *)dst.data)[i]));
+        fprintf(stdout, "%dx%d, with upload and download:\n", w, h);
+        fprintf(stdout, "  separate filters %8.2f ms\n", chain_ms);
+        fprintf(stdout, "  fused graph      %8.2f ms  speedup %.2fx  max difference %d/255\n", graph_ms, chain_ms / graph_ms, max_diff);
+
+        // two frames in flight, frame i is recorded and uploaded while frame i - 1 runs
+        const int frames = 8;
+        ImGui::ImMat outputs[2];
+        outputs[0].type = outputs[1].type = IM_DT_INT8;
+        const double async_ms = Measure(iterations, [&]() {
+            uint64_t previous = 0;
+            for (int i = 0; i < frames; i++)
+            {
+                const uint64_t ticket = graph.submit(src, outputs[i % 2]);
+                graph.wait(previous);
+                previous = ticket;
+            }
+            graph.wait(previous);
+        }) / frames;
+        bool same = !outputs[1].empty() && outputs[1].w == dst.w && outputs[1].h == dst.h;
+        for (size_t i = 0; same && i < (size_t)w * h * 4; i++)
+            same = ((const uint8_t *)outputs[1].data)[i] == ((const uint8_t *)dst.data)[i];
+        Check(same, "async frame differs from filter()");
+        fprintf(stdout, "  async graph      %8.2f ms  per frame, 2 frames in flight\n", async_ms);
+#ifdef VULKAN_SHADER_BENCHMARK
+        const uint64_t ticket = graph.submit(src, dst);
+        graph.wait(ticket);
+        std::vector<std::pair<std::string, double>> stages;
+        if (graph.ring->get(ticket))
+            graph.ring->get(ticket)->benchmark_stages(stages);
+        for (auto& stage : stages)
+            fprintf(stdout, "    %-10s %8.3f ms\n", stage.first.c_str(), stage.second);
+#endif
+    }
+
+    return Result();
+}
@@ -0,0 +1,244 @@
+// fp16 conversion benchmark.
+//
+// Bulk conversions are checked against the scalar functions on every half value and on random
+// floats, scalar float to half is checked to round to nearest even against a double reference.
+// ImMat::convert_type is checked with round trips on a mat with padded channels, with float
+// and integer saturation and integer widening, and FLOAT16 element-wise ops against the per
+// element formula. Bulk and per element conversion of a 1080p RGBA frame are timed, then
+// convert_type and FLOAT16 scalar mul.
+//
+// usage: immat_fp16_benchmark [iterations]
+
+#include <immat.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "test_utils.h"
+
+static float FromBits(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, 4);
+    return f;
+}
+
+// nearest half with ties to even, by distance in double
+static bool IsNearestEven(float f, uint16_t h)
+{
+    if (std::isnan(f))
+        return (h & 0x7C00) == 0x7C00 && (h & 0x3FF) != 0;
+    const double v = f;
+    const double r = im_float16_to_float32(h);
+    if (std::fabs(v) >= 65520.0)
+        return std::isinf(r) && (r > 0) == (v > 0);
+    if (std::isinf(r) || std::signbit(r) != std::signbit(v))
+        return false;
+    const double err = std::fabs(v - r);
+    for (int d = -1; d <= 1; d += 2)
+    {
+        const uint16_t n = (uint16_t)(h + d);
+        if ((n & 0x7FFF) >= 0x7C00 || ((h & 0x7FFF) == 0 && d < 0))
+            continue;
+        const double e = std::fabs(v - (double)im_float16_to_float32(n));
+        if (e < err || (e == err && (h & 1)))
+            return false;
+    }
+    return true;
+}
+
+static void CheckConversions()
+{
+    std::vector<uint16_t> halves(65536), back(65536);
+    std::vector<float> floats(65536);
+    for (int i = 0; i < 65536; i++) halves[i] = (uint16_t)i;
+    im_float16_to_float32_n(floats.data(), halves.data(), halves.size());
+    bool same = true;
+    for (int i = 0; i < 65536; i++)
+    {
+        // F16C quiets signaling NaN
+        const float f = im_float16_to_float32(halves[i]);
+        same &= memcmp(&f, &floats[i], 4) == 0 || (std::isnan(f) && std::isnan(floats[i]));
+    }
+    Check(same, "im_float16_to_float32_n differs from scalar");
+    im_float32_to_float16_n(back.data(), floats.data(), floats.size());
+    same = true;
+    for (int i = 0; i < 65536; i++)
+        same &= (i & 0x7C00) == 0x7C00 && (i & 0x3FF) ? (back[i] & 0x7C00) == 0x7C00 && (back[i] & 0x3FF) : back[i] == i;
+    Check(same, "half round trip");
+
+    // random bits, small and big magnitudes to cover denormals and overflow
+    uint32_t seed = 0x1234567;
+    std::vector<float> values(1 << 20);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        const uint32_t bits = seed ^ (seed >> 7) << 19;
+        values[i] = i % 2 ? FromBits(bits) : FromBits((bits & 0x87FFFFFF) | 0x30000000);
+    }
+    values[0] = 65504.f; values[1] = 65519.99f; values[2] = 65520.f; values[3] = 5.96046448e-8f; values[4] = 2.98023224e-8f;
+    values[5] = 2.98023253e-8f; values[6] = 6.10351562e-5f; values[7] = 6.1035153e-5f; values[8] = -0.f; values[9] = 1.00048828125f;
+    std::vector<uint16_t> bulk(values.size()), bf_bulk(values.size());
+    im_float32_to_float16_n(bulk.data(), values.data(), values.size());
+    im_float32_to_bfloat16_n(bf_bulk.data(), values.data(), values.size());
+    bool nearest = true, same_scalar = true, same_bf = true;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        const uint16_t h = im_float32_to_float16(values[i]);
+        nearest &= IsNearestEven(values[i], h);
+        same_scalar &= bulk[i] == h || (std::isnan(values[i]) && (bulk[i] & 0x7C00) == 0x7C00);
+        same_bf &= bf_bulk[i] == im_float32_to_bfloat16(values[i]);
+    }
+    Check(nearest, "im_float32_to_float16 is not round to nearest even");
+    Check(same_scalar, "im_float32_to_float16_n differs from scalar");
+    Check(same_bf, "im_float32_to_bfloat16_n differs from scalar");
+    std::vector<float> bf_back(values.size());
+    im_bfloat16_to_float32_n(bf_back.data(), bf_bulk.data(), bf_bulk.size());
+    same = true;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        const float f = im_bfloat16_to_float32(bf_bulk[i]);
+        same &= memcmp(&f, &bf_back[i], 4) == 0;
+    }
+    Check(same, "im_bfloat16_to_float32_n differs from scalar");
+}
+
+static void CheckMat()
+{
+    // 3 x 5 pixels leaves padding after every channel
+    ImGui::ImMat a;
+    a.create_type(5, 3, 4, IM_DT_INT8);
+    for (int q = 0; q < a.c; q++)
+        for (int i = 0; i < a.w * a.h; i++)
+            ((uint8_t *)a.channel(q))[i] = (uint8_t)(q * 60 + i * 13);
+    ImGui::ImMat f = a.convert_type(IM_DT_FLOAT32);
+    ImGui::ImMat h = f.convert_type(IM_DT_FLOAT16);
+    ImGui::ImMat b = h.convert_type(IM_DT_INT8);
+    ImGui::ImMat d = h.convert_type(IM_DT_FLOAT64).convert_type(IM_DT_INT16);
+    Check(f.type == IM_DT_FLOAT32 && f.elemsize == 4 && f.depth == 32 && h.type == IM_DT_FLOAT16 && b.type == IM_DT_INT8, "convert_type attributes");
+    bool same = b.w == a.w && b.h == a.h && b.c == a.c;
+    for (int q = 0; same && q < a.c; q++)
+        for (int i = 0; i < a.w * a.h; i++)
+        {
+            same &= ((const uint8_t *)b.channel(q))[i] == ((const uint8_t *)a.channel(q))[i];
+            same &= ((const uint16_t *)d.channel(q))[i] == ((const uint8_t *)a.channel(q))[i];
+            same &= ((const float *)f.channel(q))[i] == ((const uint8_t *)a.channel(q))[i];
+        }
+    Check(same, "convert_type round trip");
+
+    // float to integer rounds and saturates
+    ImGui::ImMat v;
+    v.create_type(6, IM_DT_FLOAT32);
+    const float in[6] = {-3.f, 0.49f, 0.5f, 254.6f, 300.f, NAN};
+    const uint8_t out[6] = {0, 0, 1, 255, 255, 0};
+    memcpy(v.data, in, sizeof(in));
+    ImGui::ImMat u = v.convert_type(IM_DT_INT8);
+    Check(memcmp(u.data, out, sizeof(out)) == 0, "convert_type saturation");
+
+    // integer widening keeps the value, narrowing saturates
+    ImGui::ImMat i8;
+    i8.create_type(3, IM_DT_INT8);
+    const uint8_t in8[3] = {0, 127, 255};
+    memcpy(i8.data, in8, sizeof(in8));
+    ImGui::ImMat i16 = i8.convert_type(IM_DT_INT16), i32 = i8.convert_type(IM_DT_INT32), i64 = i8.convert_type(IM_DT_INT64);
+    bool widened = true;
+    for (int i = 0; i < 3; i++)
+        widened &= i16.at<uint16_t>(i) == in8[i] && i32.at<uint32_t>(i) == in8[i] && i64.at<uint64_t>(i) == in8[i];
+    ImGui::ImMat w16;
+    w16.create_type(3, IM_DT_INT16);
+    const uint16_t in16[3] = {0, 300, 65535};
+    memcpy(w16.data, in16, sizeof(in16));
+    ImGui::ImMat w32 = w16.convert_type(IM_DT_INT32), n8 = w16.convert_type(IM_DT_INT8);
+    for (int i = 0; i < 3; i++)
+        widened &= w32.at<uint32_t>(i) == in16[i];
+    Check(widened, "convert_type integer widening");
+    Check(n8.at<uint8_t>(0) == 0 && n8.at<uint8_t>(1) == 255 && n8.at<uint8_t>(2) == 255, "convert_type integer narrowing");
+
+    // element-wise FLOAT16 ops and clip against per element formula
+    ImGui::ImMat x = f.convert_type(IM_DT_FLOAT16);
+    ImGui::ImMat y = x * 0.3f;
+    y.clip(10.f, 200.f);
+    same = true;
+    for (int q = 0; q < x.c; q++)
+        for (int i = 0; i < x.w * x.h; i++)
+        {
+            float r = im_float16_to_float32(im_float32_to_float16(im_float16_to_float32(((const uint16_t *)x.channel(q))[i]) * 0.3f));
+            r = std::min(std::max(r, 10.f), 200.f);
+            same &= ((const uint16_t *)y.channel(q))[i] == im_float32_to_float16(r);
+        }
+    Check(same, "FLOAT16 mul and clip");
+    ImPixel pixel;
+    x.get_pixel(2, 1, pixel);
+    Check(pixel.r == im_float16_to_float32(x.at<uint16_t>(2, 1, 0)) && pixel.a == im_float16_to_float32(x.at<uint16_t>(2, 1, 3)), "FLOAT16 get_pixel");
+
+    ImGui::ImMat m1, m2;
+    m1.create_type(3, 2, IM_DT_FLOAT16);
+    m2.create_type(2, 3, IM_DT_FLOAT16);
+    for (int i = 0; i < 6; i++)
+    {
+        ((uint16_t *)m1.data)[i] = im_float32_to_float16(i + 1.f);
+        ((uint16_t *)m2.data)[i] = im_float32_to_float16(0.5f * i);
+    }
+    ImGui::ImMat p = m1 * m2;
+    // {1 2 3, 4 5 6} x {0 0.5, 1 1.5, 2 2.5}
+    const float expected[4] = {8.f, 11.f, 17.f, 24.5f};
+    same = p.w == 2 && p.h == 2 && p.type == IM_DT_FLOAT16;
+    for (int i = 0; same && i < 4; i++)
+        same &= im_float16_to_float32(((const uint16_t *)p.data)[i]) == expected[i];
+    Check(same, "FLOAT16 mat dot mul");
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+        return 1;
+
+    fprintf(stdout, "check of conversions:\n");
+    CheckConversions();
+    CheckMat();
+
+    const int w = 1920, h = 1080;
+    ImGui::ImMat frame;
+    frame.create_type(w, h, 4, IM_DT_FLOAT32);
+    const size_t size = frame.total();
+    float* pixels = (float *)frame.data;
+    for (size_t i = 0; i < size; i++)
+        pixels[i] = (float)(i % 1021) / 1021.f;
+    std::vector<uint16_t> halves(size);
+    std::vector<float> floats(size);
+
+    fprintf(stdout, "%dx%d RGBA, %s:\n", w, h,
+#if IM_F16C
+            "F16C"
+#elif IM_NEON_FP16
+            "NEON"
+#else
+            "scalar"
+#endif
+            );
+    const double to_half_scalar = Measure(iterations, [&]() { for (size_t i = 0; i < size; i++) halves[i] = im_float32_to_float16(pixels[i]); });
+    const double to_half = Measure(iterations, [&]() { im_float32_to_float16_n(halves.data(), pixels, size); });
+    const double to_float_scalar = Measure(iterations, [&]() { for (size_t i = 0; i < size; i++) floats[i] = im_float16_to_float32(halves[i]); });
+    const double to_float = Measure(iterations, [&]() { im_float16_to_float32_n(floats.data(), halves.data(), size); });
+    fprintf(stdout, "  float to half  per element %8.2f ms  bulk %8.2f ms  speedup %.2fx\n", to_half_scalar, to_half, to_half_scalar / to_half);
+    fprintf(stdout, "  half to float  per element %8.2f ms  bulk %8.2f ms  speedup %.2fx\n", to_float_scalar, to_float, to_float_scalar / to_float);
+
+    ImGui::ImMat half_frame, back;
+    const double convert = Measure(iterations, [&]() { half_frame = frame.convert_type(IM_DT_FLOAT16); });
+    const double convert_back = Measure(iterations, [&]() { back = half_frame.convert_type(IM_DT_FLOAT32); });
+    fprintf(stdout, "  convert_type FLOAT32 to FLOAT16 %8.2f ms  FLOAT16 to FLOAT32 %8.2f ms\n", convert, convert_back);
+
+    const uint16_t* src = (const uint16_t *)half_frame.data;
+    const double mul_scalar = Measure(iterations, [&]() {
+        for (size_t i = 0; i < size; i++)
+            halves[i] = im_float32_to_float16(im_float16_to_float32(src[i]) * 0.5f);
+    });
+    ImGui::ImMat scaled;
+    const double mul = Measure(iterations, [&]() { scaled = half_frame * 0.5f; });
+    Check(memcmp(scaled.data, halves.data(), size * 2) == 0, "FLOAT16 mul frame");
+    fprintf(stdout, "  FLOAT16 mul    per element %8.2f ms  blocks %8.2f ms  speedup %.2fx\n", mul_scalar, mul, mul_scalar / mul);
+
+    return Result();
+}
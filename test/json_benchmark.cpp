@@ -0,0 +1,152 @@
+// imgui_json parse/dump throughput benchmark.
+//
+// Generates a node graph shaped document (nodes with pins, positions and
+// colors, links between them), then measures how fast it is dumped and
+// parsed back with json::value, with the arena backed json::document and
+// with a bare SAX pass that only counts events.
+//
+// usage: json_benchmark [node_count] [iterations]
+
+#include <imgui.h>
+#include <imgui_json.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "test_utils.h"
+
+namespace json = imgui_json;
+
+static json::value MakeGraph(int nodeCount)
+{
+    json::value nodes;
+    json::value links;
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        json::value node;
+        node["id"]       = (double)(i * 3 + 1);
+        node["name"]     = "Node \"" + std::to_string(i) + "\"";
+        node["type"]     = i % 7 == 0 ? "Group" : "Blueprint";
+        node["location"] = json::vec2((float)(i % 250) * 160.0f, (float)(i / 250) * 80.0f + 0.5f);
+        node["color"]    = json::vec4(0.25f, 0.5f, 1.0f / (float)(1 + i % 5), 1.0f);
+        node["enabled"]  = i % 3 != 0;
+        node["scale"]    = 1.0 + (double)i * 1e-3;
+
+        json::value pins;
+        for (int p = 0; p < 4; ++p)
+        {
+            json::value pin;
+            pin["id"]   = (double)(i * 3 + 1 + p);
+            pin["kind"] = p < 2 ? "input" : "output";
+            pin["name"] = "pin_" + std::to_string(p);
+            pins.push_back(std::move(pin));
+        }
+        node["pins"] = std::move(pins);
+
+        nodes.push_back(std::move(node));
+
+        if (i > 0)
+        {
+            json::value link;
+            link["id"]    = (double)i;
+            link["start"] = (double)(i * 3);
+            link["end"]   = (double)(i * 3 + 2);
+            links.push_back(std::move(link));
+        }
+    }
+
+    json::value graph;
+    graph["version"] = 1.0;
+    graph["nodes"]   = std::move(nodes);
+    graph["links"]   = std::move(links);
+    return graph;
+}
+
+struct CountingHandler: json::sax_handler
+{
+    size_t events = 0;
+
+    bool on_null()                                  override { ++events; return true; }
+    bool on_boolean(json::boolean)                  override { ++events; return true; }
+    bool on_number(json::number)                    override { ++events; return true; }
+    bool on_string(const char*, size_t)             override { ++events; return true; }
+    bool on_vec2(const json::vec2&)                 override { ++events; return true; }
+    bool on_vec4(const json::vec4&)                 override { ++events; return true; }
+    bool on_begin_object()                          override { ++events; return true; }
+    bool on_key(const char*, size_t)                override { ++events; return true; }
+    bool on_end_object()                            override { ++events; return true; }
+    bool on_begin_array()                           override { ++events; return true; }
+    bool on_end_array()                             override { ++events; return true; }
+};
+
+static void Report(const char* label, double ms, size_t bytes, int iterations)
+{
+    const double avg = ms / iterations;
+    fprintf(stdout, "  %-28s %9.3f ms  %8.1f MB/s\n", label, avg, (double)bytes / (1024.0 * 1024.0) / (avg / 1000.0));
+}
+
+int main(int argc, char** argv)
+{
+    const int nodeCount  = argc > 1 ? atoi(argv[1]) : 100000;
+    const int iterations = argc > 2 ? atoi(argv[2]) : 3;
+    if (nodeCount <= 0 || iterations <= 0)
+        return 1;
+
+    const json::value graph = MakeGraph(nodeCount);
+
+    std::string compact, indented;
+    double compactMs = 0, indentedMs = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = Clock::now();
+        compact = graph.dump();
+        compactMs += ElapsedMs(start);
+
+        start = Clock::now();
+        indented = graph.dump(4);
+        indentedMs += ElapsedMs(start);
+    }
+
+    fprintf(stdout, "nodes: %d, compact: %.2f MB, indented: %.2f MB, %d iterations\n",
+        nodeCount, compact.size() / (1024.0 * 1024.0), indented.size() / (1024.0 * 1024.0), iterations);
+    fprintf(stdout, "dump:\n");
+    Report("value::dump()", compactMs, compact.size(), iterations);
+    Report("value::dump(4)", indentedMs, indented.size(), iterations);
+
+    double valueMs = 0, documentMs = 0, saxMs = 0, convertMs = 0;
+    bool ok = true;
+    size_t events = 0, arenaBytes = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto start = Clock::now();
+        json::value parsed = json::value::parse(indented);
+        valueMs += ElapsedMs(start);
+        ok &= !parsed.is_discarded() && parsed.dump() == compact;
+
+        json::document document;
+        start = Clock::now();
+        ok &= document.parse(indented);
+        documentMs += ElapsedMs(start);
+        arenaBytes = document.memory_used();
+
+        start = Clock::now();
+        json::value converted = document.root().to_value();
+        convertMs += ElapsedMs(start);
+        ok &= converted.dump() == compact;
+
+        CountingHandler handler;
+        start = Clock::now();
+        ok &= json::sax_parse(indented.data(), indented.size(), handler);
+        saxMs += ElapsedMs(start);
+        events = handler.events;
+    }
+
+    fprintf(stdout, "parse (indented input):\n");
+    Report("value::parse()", valueMs, indented.size(), iterations);
+    Report("document::parse()", documentMs, indented.size(), iterations);
+    Report("document -> value", convertMs, indented.size(), iterations);
+    Report("sax_parse(), counting only", saxMs, indented.size(), iterations);
+    fprintf(stdout, "  sax events: %zu, document arena: %.2f MB\n", events, arenaBytes / (1024.0 * 1024.0));
+    fprintf(stdout, "round trip: %s\n", ok ? "ok" : "MISMATCH");
+
+    return ok ? 0 : 1;
+}
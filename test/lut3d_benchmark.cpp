@@ -0,0 +1,257 @@
+// LUT3D cpu backend benchmark.
+//
+// Checks LUT3D_cpu with an identity lut, which must keep the source, and with a smooth lut
+// where trilinear and tetrahedral results are compared against the function it samples.
+// Pixels in the vector body and in the scalar tail of a row must map the same.
+// Then measures nearest/trilinear/tetrahedral throughput of a 65^3 lut at 1080p and 4K,
+// and LUT3D_vulkan creation from a .cube file, first parse and from parsed cube cache.
+//
+// usage: lut3d_benchmark [iterations]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <Lut3D_vulkan.h>
+#include <Lut3D_cpu.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+#include "test_utils.h"
+
+// smooth non linear grading the lut samples
+static void Grade(float r, float g, float b, float out[3])
+{
+    out[0] = r * r;
+    out[1] = sqrtf(g * 0.75f + 0.25f) - 0.5f;
+    out[2] = (r + g + b) / 3.f;
+}
+
+static std::vector<rgbvec> MakeLut(int size, bool identity)
+{
+    std::vector<rgbvec> table((size_t)size * size * size);
+    for (int r = 0; r < size; r++)
+    for (int g = 0; g < size; g++)
+    for (int b = 0; b < size; b++)
+    {
+        const float s = (float)(size - 1);
+        float out[3] = {r / s, g / s, b / s};
+        if (!identity)
+            Grade(r / s, g / s, b / s, out);
+        rgbvec& v = table[((size_t)r * size + g) * size + b];
+        v.r = out[0]; v.g = out[1]; v.b = out[2]; v.a = 0.f;
+    }
+    return table;
+}
+
+// interleaved pixel access, at() of packed mat adds channel in bytes
+template<typename T>
+static T* Pixel(const ImGui::ImMat& mat, int x, int y)
+{
+    return (T *)mat.data + ((size_t)y * mat.w + x) * mat.c;
+}
+
+static ImGui::ImMat MakeFrame(int w, int h, ImDataType type)
+{
+    ImGui::ImMat mat;
+    mat.create_type(w, h, 4, type);
+    uint32_t seed = 0x1234567;
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const float v[4] = {(float)x / w, (float)y / h, (float)(seed >> 24) / 255.f, 1.f};
+            for (int k = 0; k < 4; k++)
+            {
+                if (type == IM_DT_INT8)
+                    Pixel<uint8_t>(mat, x, y)[k] = (uint8_t)(v[k] * 255.f);
+                else
+                    Pixel<float>(mat, x, y)[k] = v[k];
+            }
+        }
+    }
+    return mat;
+}
+
+static void CheckIdentity()
+{
+    std::vector<rgbvec> table = MakeLut(17, true);
+    ImGui::ImMat src = MakeFrame(333, 77, IM_DT_INT8);
+    const int modes[3] = {IM_INTERPOLATE_NEAREST, IM_INTERPOLATE_TRILINEAR, IM_INTERPOLATE_TETRAHEDRAL};
+    for (int mode : modes)
+    {
+        ImGui::ImMat dst;
+        dst.type = IM_DT_INT8;
+        Check(ImGui::LUT3D_cpu::filter(src, dst, (const float *)table.data(), 17, mode), "identity filter failed");
+        if (dst.empty())
+            continue;
+        int max_diff = 0;
+        for (int y = 0; y < src.h; y++)
+        for (int x = 0; x < src.w; x++)
+        for (int k = 0; k < 3; k++)
+            max_diff = std::max(max_diff, std::abs((int)Pixel<uint8_t>(src, x, y)[k] - (int)Pixel<uint8_t>(dst, x, y)[k]));
+        // nearest snaps to 17 lattice points, linear modes keep the value up to rounding
+        Check(max_diff <= (mode == IM_INTERPOLATE_NEAREST ? 8 : 1), "identity lut changes source");
+    }
+}
+
+static void CheckSmooth()
+{
+    const int size = 33;
+    std::vector<rgbvec> table = MakeLut(size, false);
+    // 3 colors repeated, 11 pixels wide so the last 3 take the scalar tail of 8 wide kernels
+    ImGui::ImMat src;
+    src.create_type(11, 64, 4, IM_DT_FLOAT32);
+    uint32_t seed = 0x7654321;
+    for (int y = 0; y < src.h; y++)
+    {
+        float color[3][3];
+        for (int i = 0; i < 3; i++)
+        for (int k = 0; k < 3; k++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            color[i][k] = (float)(seed >> 8) / 16777216.f;
+        }
+        for (int x = 0; x < src.w; x++)
+        {
+            for (int k = 0; k < 3; k++)
+                Pixel<float>(src, x, y)[k] = color[x % 3][k];
+            Pixel<float>(src, x, y)[3] = 1.f;
+        }
+    }
+
+    const int modes[2] = {IM_INTERPOLATE_TRILINEAR, IM_INTERPOLATE_TETRAHEDRAL};
+    for (int mode : modes)
+    {
+        ImGui::ImMat dst;
+        dst.type = IM_DT_FLOAT32;
+        Check(ImGui::LUT3D_cpu::filter(src, dst, (const float *)table.data(), size, mode), "smooth filter failed");
+        if (dst.empty())
+            continue;
+        float max_error = 0, max_tail = 0;
+        for (int y = 0; y < src.h; y++)
+        for (int x = 0; x < src.w; x++)
+        {
+            float expect[3];
+            Grade(Pixel<float>(src, x, y)[0], Pixel<float>(src, x, y)[1], Pixel<float>(src, x, y)[2], expect);
+            for (int k = 0; k < 3; k++)
+            {
+                max_error = std::max(max_error, fabsf(Pixel<float>(dst, x, y)[k] - std::min(std::max(expect[k], 0.f), 1.f)));
+                max_tail = std::max(max_tail, fabsf(Pixel<float>(dst, x, y)[k] - Pixel<float>(dst, x % 3, y)[k]));
+            }
+            Check(Pixel<float>(dst, x, y)[3] == 1.f, "alpha is not opaque");
+        }
+        fprintf(stdout, "  %s max error %.6f\n", mode == IM_INTERPOLATE_TRILINEAR ? "trilinear  " : "tetrahedral", max_error);
+        Check(max_error < 2e-3f, "lut interpolation error");
+        Check(max_tail < 1e-5f, "scalar tail differs from vector body");
+    }
+}
+
+static std::string TempCubeFile()
+{
+#if defined(_WIN32)
+    char path[MAX_PATH];
+    GetTempPathA(MAX_PATH, path);
+    return std::string(path) + "lut3d_benchmark.cube";
+#else
+    return std::string("/tmp/lut3d_benchmark.cube");
+#endif
+}
+
+static bool WriteCube(const std::string& path, int size)
+{
+    FILE* fp = fopen(path.c_str(), "w");
+    if (!fp)
+        return false;
+    fprintf(fp, "TITLE \"lut3d benchmark\"\nLUT_3D_SIZE %d\n", size);
+    // red changes fastest in cube files
+    for (int b = 0; b < size; b++)
+    for (int g = 0; g < size; g++)
+    for (int r = 0; r < size; r++)
+    {
+        float out[3];
+        const float s = (float)(size - 1);
+        Grade(r / s, g / s, b / s, out);
+        fprintf(fp, "%.6f %.6f %.6f\n", out[0], out[1], out[2]);
+    }
+    return fclose(fp) == 0;
+}
+
+static void Benchmark(const char* label, int w, int h, int iterations, const std::function<bool()>& func)
+{
+    func();
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+        func();
+    const double ms = ElapsedMs(start) / iterations;
+    fprintf(stdout, "  %-36s %8.3f ms  %8.1f Mpixel/s\n", label, ms, (double)w * h / 1000.0 / ms);
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    const bool gpu = ImGui::get_gpu_count() > 0;
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, shader lut is measured as well" : "no, cpu backend only");
+
+    CheckIdentity();
+    CheckSmooth();
+    fprintf(stdout, "lut check: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+
+    const int size = 65;
+    std::vector<rgbvec> table = MakeLut(size, false);
+    const int sizes[2][2] = { {1920, 1080}, {3840, 2160} };
+    for (auto frame : sizes)
+    {
+        const int w = frame[0], h = frame[1];
+        ImGui::ImMat src = MakeFrame(w, h, IM_DT_INT8);
+        ImGui::ImMat dst;
+        dst.type = IM_DT_INT8;
+        fprintf(stdout, "%dx%d 65^3 lut cpu backend:\n", w, h);
+        Benchmark("nearest", w, h, iterations, [&]() { return ImGui::LUT3D_cpu::filter(src, dst, (const float *)table.data(), size, IM_INTERPOLATE_NEAREST); });
+        Benchmark("trilinear", w, h, iterations, [&]() { return ImGui::LUT3D_cpu::filter(src, dst, (const float *)table.data(), size, IM_INTERPOLATE_TRILINEAR); });
+        Benchmark("tetrahedral", w, h, iterations, [&]() { return ImGui::LUT3D_cpu::filter(src, dst, (const float *)table.data(), size, IM_INTERPOLATE_TETRAHEDRAL); });
+        if (gpu)
+        {
+            ImGui::LUT3D_vulkan trilinear(table.data(), size, 1.f, 1.f, 1.f, 1.f, IM_INTERPOLATE_TRILINEAR, ImGui::get_default_gpu_index());
+            ImGui::LUT3D_vulkan tetrahedral(table.data(), size, 1.f, 1.f, 1.f, 1.f, IM_INTERPOLATE_TETRAHEDRAL, ImGui::get_default_gpu_index());
+            fprintf(stdout, "%dx%d 65^3 lut vulkan, with upload and download:\n", w, h);
+            Benchmark("trilinear", w, h, iterations, [&]() { trilinear.filter(src, dst); return true; });
+            Benchmark("tetrahedral", w, h, iterations, [&]() { tetrahedral.filter(src, dst); return true; });
+        }
+    }
+
+    // parsed cube cache lives in process, first creation parses the file
+    const std::string cube = TempCubeFile();
+    if (WriteCube(cube, size))
+    {
+        auto start = Clock::now();
+        ImGui::LUT3D_vulkan* first = new ImGui::LUT3D_vulkan(cube, IM_INTERPOLATE_TETRAHEDRAL, ImGui::get_default_gpu_index());
+        const double first_ms = ElapsedMs(start);
+        start = Clock::now();
+        ImGui::LUT3D_vulkan* cached = new ImGui::LUT3D_vulkan(cube, IM_INTERPOLATE_TETRAHEDRAL, ImGui::get_default_gpu_index());
+        const double cached_ms = ElapsedMs(start);
+        fprintf(stdout, "  LUT3D_vulkan from 65^3 cube %8.3f ms, cached %8.3f ms\n", first_ms, cached_ms);
+
+        ImGui::ImMat src = MakeFrame(320, 180, IM_DT_INT8);
+        ImGui::ImMat dst0, dst1;
+        dst0.type = dst1.type = IM_DT_INT8;
+        first->filter(src, dst0);
+        cached->filter(src, dst1);
+        Check(!dst0.empty() && !dst1.empty() && memcmp(dst0.data, dst1.data, dst0.total() * dst0.elemsize) == 0, "cached cube differs");
+        delete first;
+        delete cached;
+        remove(cube.c_str());
+    }
+
+    return Result();
+}
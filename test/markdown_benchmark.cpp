@@ -0,0 +1,155 @@
+// Markdown benchmark.
+//
+// A long generated text with headings, lists, links, emphasis and separators is drawn without a backend
+// in a scrolled window, by Markdown on the whole text every frame and by a MarkdownDocument. The content
+// height and the items at the scroll position must be the same at several widths, after scrolling and
+// after a text change, the document must render only the visible lines.
+//
+// usage: markdown_benchmark [iterations]
+
+#include <imgui.h>
+#include <imgui_markdown.h>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "test_utils.h"
+
+static uint32_t g_seed = 0x1234567;
+
+static uint32_t Random()
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+static const char* g_words[] = { "markdown", "layout", "frame", "window", "text", "wrap", "font", "cache", "render", "line", "block", "scroll" };
+
+static std::string Sentence(int words)
+{
+    std::string s;
+    for (int i = 0; i < words; i++)
+    {
+        const char* word = g_words[Random() % 12];
+        const uint32_t style = Random() % 16;
+        if (i) s += ' ';
+        if (style == 0) s += std::string("*") + word + "*";
+        else if (style == 1) s += std::string("**") + word + "**";
+        else if (style == 2) s += std::string("[") + word + "](https://github.com/)";
+        else s += word;
+    }
+    return s;
+}
+
+static std::string Document(int sections)
+{
+    std::string text;
+    for (int i = 0; i < sections; i++)
+    {
+        text += "# Section " + std::to_string(i) + "\n";
+        text += Sentence(60) + "\n\n";
+        text += "## Details\n";
+        for (int j = 0; j < 4; j++)
+            text += "  * " + Sentence(12) + "\n";
+        text += "\n" + Sentence(40) + "\n";
+        text += "___\n";
+    }
+    return text;
+}
+
+static ImGui::MarkdownConfig g_config;
+
+struct FrameResult
+{
+    float content_height = 0;
+    float scroll_max = 0;
+    int vertices = 0;
+};
+
+static FrameResult Frame(const std::string& text, ImGui::MarkdownDocument* document, float width, float scroll)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2(width, 700));
+    ImGui::Begin(document ? "document" : "markdown", NULL, ImGuiWindowFlags_NoSavedSettings);
+    ImGui::SetScrollY(scroll);
+    const float y = ImGui::GetCursorPosY();
+    if (document)
+        ImGui::Markdown(*document, text.c_str(), text.length(), g_config);
+    else
+        ImGui::Markdown(text.c_str(), text.length(), g_config);
+    FrameResult result;
+    result.content_height = ImGui::GetCursorPosY() - y;
+    result.scroll_max = ImGui::GetScrollMaxY();
+    ImGui::End();
+    ImGui::Render();
+    // vertices inside the window below the title bar, Markdown leaves scissored quads outside
+    for (int i = 0; i < ImGui::GetDrawData()->CmdListsCount; i++)
+        for (const ImDrawVert& v : ImGui::GetDrawData()->CmdLists[i]->VtxBuffer)
+            result.vertices += v.pos.y >= 40 && v.pos.y < 660;
+    return result;
+}
+
+static bool Same(const FrameResult& a, const FrameResult& b)
+{
+    return fabsf(a.content_height - b.content_height) < 0.5f && fabsf(a.scroll_max - b.scroll_max) < 0.5f && a.vertices == b.vertices;
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    std::string text = Document(300);
+    ImGui::MarkdownDocument document;
+
+    fprintf(stdout, "check of layout, %zu KB text:\n", text.size() / 1024);
+    const float widths[] = { 900.f, 400.f, 1200.f };
+    for (float w : widths)
+    {
+        // first frames settle the scrollbar, then scroll into the middle
+        for (float scroll : { 0.f, 0.f, 0.f, 30000.f, 30000.f, 1e9f, 1e9f })
+        {
+            const FrameResult plain = Frame(text, NULL, w, scroll);
+            const FrameResult cached = Frame(text, &document, w, scroll);
+            if (!Same(plain, cached))
+            {
+                fprintf(stdout, "  width %.0f scroll %.0f: height %.1f / %.1f, vertices %d / %d\n", w, scroll, plain.content_height, cached.content_height, plain.vertices, cached.vertices);
+                Check(false, "document layout differs from Markdown");
+            }
+        }
+        fprintf(stdout, "  width %4.0f: height %.0f, %d of %zu lines rendered\n", w, document.Height(), document.renderedBlocks, document.blocks.size());
+        Check(document.renderedBlocks < 100, "lines rendered outside of the view");
+    }
+
+    // text change relayouts
+    text += "# Appended\n" + Sentence(200) + "\n";
+    text.replace(0, 9, "# Changed");
+    for (float scroll : { 0.f, 0.f, 1e9f, 1e9f })
+    {
+        const FrameResult plain = Frame(text, NULL, 900.f, scroll);
+        const FrameResult cached = Frame(text, &document, 900.f, scroll);
+        Check(Same(plain, cached), "document layout after text change");
+    }
+
+    const double plain = Measure(iterations, [&]() { Frame(text, NULL, 900.f, 30000.f); });
+    const double cached = Measure(iterations, [&]() { Frame(text, &document, 900.f, 30000.f); });
+    const double relayout = Measure(iterations, [&]() { document.Invalidate(); Frame(text, &document, 900.f, 30000.f); });
+    fprintf(stdout, "one frame of %zu KB markdown:\n", text.size() / 1024);
+    fprintf(stdout, "  Markdown         %8.3f ms\n", plain);
+    fprintf(stdout, "  MarkdownDocument %8.3f ms  speedup %.2fx\n", cached, plain / cached);
+    fprintf(stdout, "  relayout         %8.3f ms\n", relayout);
+    ImGui::DestroyContext();
+
+    return Result();
+}
@@ -0,0 +1,245 @@
+// Memory editor benchmark.
+//
+// FindBytes is checked against a naive search on data with many partial matches and timed against it
+// and std::search. The background search runs over a 1 GB virtual source read by PageReadFn, with
+// planted matches across chunk boundaries and progress reporting. Then the editor draws frames without
+// a backend over a 64 GB virtual source, per byte with ReadFn and paged with PageReadFn, each call
+// costing a microsecond, counting reads while scrolling and jumping.
+//
+// usage: memory_editor_benchmark [iterations]
+
+#include <imgui.h>
+#include <imgui_memory_editor.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "test_utils.h"
+
+static uint32_t g_seed = 0x1234567;
+
+static uint32_t Random()
+{
+    g_seed = g_seed * 1664525u + 1013904223u;
+    return g_seed >> 8;
+}
+
+static const ImU8* NaiveFind(const ImU8* data, size_t size, const ImU8* pattern, size_t pattern_size)
+{
+    for (size_t i = 0; i + pattern_size <= size; i++)
+        if (memcmp(data + i, pattern, pattern_size) == 0)
+            return data + i;
+    return NULL;
+}
+
+static void CheckFindBytes()
+{
+    // three letter alphabet, so first and last bytes match often
+    std::vector<ImU8> data(10000);
+    for (auto& b : data) b = (ImU8)('a' + Random() % 3);
+    bool same = true;
+    for (size_t pattern_size = 1; pattern_size <= 40; pattern_size++)
+        for (int trial = 0; trial < 20; trial++)
+        {
+            std::vector<ImU8> pattern(pattern_size);
+            if (trial % 2)
+            {
+                const size_t at = Random() % (data.size() - pattern_size + 1);
+                memcpy(pattern.data(), data.data() + at, pattern_size);
+            }
+            else
+                for (auto& b : pattern) b = (ImU8)('a' + Random() % 3);
+            const size_t start = Random() % 64, size = data.size() - start - Random() % 64;
+            same &= MemoryEditor::FindBytes(data.data() + start, size, pattern.data(), pattern_size) == NaiveFind(data.data() + start, size, pattern.data(), pattern_size);
+        }
+    // match in the last bytes
+    const ImU8 tail[] = { 'x', 'y', 'z' };
+    memcpy(data.data() + data.size() - 3, tail, 3);
+    same &= MemoryEditor::FindBytes(data.data(), data.size(), tail, 3) == data.data() + data.size() - 3;
+    same &= MemoryEditor::FindBytes(data.data(), 2, tail, 3) == NULL;
+    Check(same, "FindBytes differs from naive search");
+
+    MemoryEditor editor;
+    ImU8 pattern[8];
+    Check(editor.ParseSearchPattern("de AD be EF", pattern, sizeof(pattern)) == 4 && pattern[0] == 0xDE && pattern[3] == 0xEF, "hex pattern");
+    Check(editor.ParseSearchPattern("ABC", pattern, sizeof(pattern)) == 0, "odd hex pattern");
+    editor.OptSearchHex = false;
+    Check(editor.ParseSearchPattern("ABC", pattern, sizeof(pattern)) == 3 && pattern[2] == 'C', "text pattern");
+}
+
+// virtual data, a byte per 16 addresses from the address, markers planted at g_marks
+static const char g_marker[] = "NEEDLE";
+static std::vector<size_t> g_marks;
+
+static ImU8 VirtualByte(size_t off)
+{
+    for (size_t mark : g_marks)
+        if (off >= mark && off < mark + 6)
+            return (ImU8)g_marker[off - mark];
+    return (ImU8)(0x80 | ((off >> 4) & 0x7F));
+}
+
+static size_t VirtualPageRead(const ImU8* data, size_t off, ImU8* buf, size_t size)
+{
+    IM_UNUSED(data);
+    for (size_t i = 0; i < size; i += 16)
+        memset(buf + i, 0x80 | (((off + i) >> 4) & 0x7F), std::min((size_t)16, size - i));
+    for (size_t mark : g_marks)
+        for (size_t i = 0; i < 6; i++)
+            if (mark + i >= off && mark + i < off + size)
+                buf[mark + i - off] = (ImU8)g_marker[i];
+    return size;
+}
+
+static ImU8 VirtualRead(const ImU8* data, size_t off)
+{
+    IM_UNUSED(data);
+    return VirtualByte(off);
+}
+
+static void CheckSearch()
+{
+    const size_t size = (size_t)1 << 30;
+    const size_t chunk = MemoryEditor::SearchChunkSize;
+    g_marks = { 0, chunk - 3, chunk * 5 - 5, chunk * 77 + 12345, size - 6 };
+    MemoryEditor editor;
+    editor.PageReadFn = VirtualPageRead;
+    auto start = Clock::now();
+    Check(editor.StartSearch(NULL, size, (const ImU8*)g_marker, 6), "StartSearch");
+    float last_progress = 0;
+    bool monotonic = true;
+    while (editor.IsSearching())
+    {
+        const float progress = editor.GetSearchProgress();
+        monotonic &= progress >= last_progress;
+        last_progress = progress;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double ms = ElapsedMs(start);
+    fprintf(stdout, "  search of 1 GB %8.1f ms, %.0f MB/s, %zu found\n", ms, 1024.0 / ms * 1000.0, editor.GetSearchMatchCount());
+    Check(monotonic && editor.GetSearchProgress() == 1.0f, "search progress");
+    bool found = editor.GetSearchMatchCount() == g_marks.size();
+    for (size_t i = 0; found && i < g_marks.size(); i++)
+        found &= editor.GetSearchResult(i) == g_marks[i];
+    Check(found, "search results");
+
+    // cancel stops early
+    editor.StartSearch(NULL, size, (const ImU8*)g_marker, 6);
+    editor.CancelSearch();
+    Check(!editor.IsSearching() && editor.GetSearchProgress() < 1.0f, "CancelSearch");
+    g_marks.clear();
+}
+
+static size_t g_byte_reads = 0;
+static size_t g_page_reads = 0;
+
+// a call to a file or another process costs about a microsecond
+static void CallLatency()
+{
+    auto start = Clock::now();
+    while (ElapsedMs(start) < 0.001) {}
+}
+
+static ImU8 CountedRead(const ImU8* data, size_t off) { g_byte_reads++; CallLatency(); return VirtualRead(data, off); }
+static size_t CountedPageRead(const ImU8* data, size_t off, ImU8* buf, size_t size) { g_page_reads++; CallLatency(); return VirtualPageRead(data, off, buf, size); }
+
+static void Frame(MemoryEditor& editor, size_t size, const char* title)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2(800, 700));
+    editor.DrawWindow(title, NULL, size);
+    ImGui::Render();
+}
+
+static void CheckDraw(int iterations)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    const size_t size = (size_t)64 << 30;
+    MemoryEditor byte_editor;
+    byte_editor.ReadFn = CountedRead;
+    MemoryEditor page_editor;
+    page_editor.PageReadFn = CountedPageRead;
+    for (int i = 0; i < 3; i++)
+    {
+        Frame(byte_editor, size, "ReadFn");
+        Frame(page_editor, size, "PageReadFn");
+    }
+    g_byte_reads = g_page_reads = 0;
+    const double byte_ms = Measure(iterations, [&]() { Frame(byte_editor, size, "ReadFn"); });
+    const size_t byte_reads = g_byte_reads / (iterations + 1);
+    const double page_ms = Measure(iterations, [&]() { Frame(page_editor, size, "PageReadFn"); });
+    const size_t page_reads = g_page_reads;
+    fprintf(stdout, "64 GB virtual data, one frame:\n");
+    fprintf(stdout, "  ReadFn     %8.3f ms  %zu calls\n", byte_ms, byte_reads);
+    fprintf(stdout, "  PageReadFn %8.3f ms  %zu calls over %d frames\n", page_ms, page_reads, iterations + 1);
+    Check(page_reads == 0, "cached pages read again");
+
+    // jump to the middle and past the scroll window, the view is fetched in one bulk read
+    g_page_reads = 0;
+    page_editor.GotoAddr = size / 2 + 0x1234;
+    for (int i = 0; i < 3; i++)
+        Frame(page_editor, size, "PageReadFn");
+    fprintf(stdout, "  jump       %zu calls, %zu pages cached, window at line %zu\n", g_page_reads, page_editor.Pages.size(), page_editor.ScrollBaseLine);
+    Check(g_page_reads >= 1 && g_page_reads <= 3, "jump reads");
+    Check(page_editor.DataPreviewAddr == size / 2 + 0x1234 && page_editor.ScrollBaseLine > 0, "jump address");
+    ImU8 b = 0;
+    page_editor.ReadBytes(NULL, size / 2 + 0x1234, &b, 1);
+    Check(b == VirtualByte(size / 2 + 0x1234), "paged byte");
+
+    // scrolling a screen a frame reads only the rows coming into the prefetch range
+    g_page_reads = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        io.AddMousePosEvent(400.0f, 300.0f);
+        io.AddMouseWheelEvent(0.0f, -10.0f);
+        Frame(page_editor, size, "PageReadFn");
+    }
+    fprintf(stdout, "  scroll     %zu calls over 100 frames, %zu pages cached\n", g_page_reads, page_editor.Pages.size());
+    Check(g_page_reads <= 100, "scroll reads");
+    ImGui::DestroyContext();
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    fprintf(stdout, "check of FindBytes:\n");
+    CheckFindBytes();
+    fprintf(stdout, "check of search:\n");
+    CheckSearch();
+
+    // 64 MB of text like data, pattern at the end
+    std::vector<ImU8> data((size_t)64 << 20);
+    for (auto& b : data) b = (ImU8)('a' + Random() % 26);
+    const char* needle = "performance";
+    memcpy(data.data() + data.size() - 11, needle, 11);
+    size_t sum = 0;
+    const double naive = Measure(iterations / 4 + 1, [&]() { sum += NaiveFind(data.data(), data.size(), (const ImU8*)needle, 11) - data.data(); });
+    const double search = Measure(iterations / 4 + 1, [&]() { sum += std::search(data.begin(), data.end(), needle, needle + 11) - data.begin(); });
+    const double find = Measure(iterations / 4 + 1, [&]() { sum += MemoryEditor::FindBytes(data.data(), data.size(), (const ImU8*)needle, 11) - data.data(); });
+    fprintf(stdout, "search of 64 MB:\n");
+    fprintf(stdout, "  naive       %8.3f ms\n", naive);
+    fprintf(stdout, "  std::search %8.3f ms  speedup %.2fx\n", search, naive / search);
+    fprintf(stdout, "  FindBytes   %8.3f ms  speedup %.2fx\n", find, naive / find);
+    if (sum == 0)
+        fprintf(stdout, "\n");
+
+    CheckDraw(iterations);
+
+    return Result();
+}
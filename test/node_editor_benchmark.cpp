@@ -0,0 +1,193 @@
+// Headless node editor benchmark.
+//
+// Builds a large graph from scratch (every node chained to the next one by
+// a link) and measures the per-frame cost of ed::Begin()/ed::End() without
+// any rendering backend. Measured once at origin and once zoomed out to the
+// whole graph, where node collapsing and link simplification kick in, and
+// once more with links at full detail.
+// When settings file is given, editor saves to incremental binary settings
+// log and a few nodes are moved every frame to measure cost of saving.
+//
+// usage: node_editor_benchmark [node_count] [frame_count] [settings_file]
+
+#include <imgui.h>
+#include <imgui_node_editor.h>
+#include <cstdio>
+#include <cstdlib>
+#include "test_utils.h"
+
+namespace ed = ax::NodeEditor;
+
+struct FrameTiming
+{
+    double total = 0;   // whole frame, NewFrame() to Render()
+    double content = 0; // node/link submission between Begin and End
+    double begin = 0;   // ed::Begin()
+    double end = 0;     // ed::End()
+};
+
+static FrameTiming RunFrame(int nodeCount)
+{
+    FrameTiming timing;
+    auto frameStart = Clock::now();
+
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Benchmark", nullptr, ImGuiWindowFlags_NoDecoration);
+
+    auto start = Clock::now();
+    ed::Begin("Node Editor Benchmark");
+    timing.begin = ElapsedMs(start);
+
+    start = Clock::now();
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        const int nodeId = i * 3 + 1;
+        ed::BeginNode(nodeId);
+        ImGui::Text("Node %d", i);
+        ed::BeginPin(nodeId + 1, ed::PinKind::Input);
+        ImGui::TextUnformatted("-> In");
+        ed::EndPin();
+        ImGui::SameLine();
+        ed::BeginPin(nodeId + 2, ed::PinKind::Output);
+        ImGui::TextUnformatted("Out ->");
+        ed::EndPin();
+        ed::EndNode();
+    }
+    for (int i = 0; i + 1 < nodeCount; ++i)
+        ed::Link(i + 1, i * 3 + 3, (i + 1) * 3 + 2);
+    timing.content = ElapsedMs(start);
+
+    start = Clock::now();
+    ed::End();
+    timing.end = ElapsedMs(start);
+
+    ImGui::End();
+    ImGui::Render();
+
+    timing.total = ElapsedMs(frameStart);
+    return timing;
+}
+
+static ImVec2 GridPosition(int index, int columns)
+{
+    return ImVec2((float)(index % columns) * 160.0f, (float)(index / columns) * 80.0f);
+}
+
+static void MeasureFrames(const char* label, int nodeCount, int frameCount, int movedNodes = 0)
+{
+    if (frameCount <= 0)
+        return;
+
+    FrameTiming sum;
+    for (int frame = 0; frame < frameCount; ++frame)
+    {
+        // Nudge a few nodes, every one of them has to be saved at the end of frame
+        for (int i = 0; i < movedNodes && i < nodeCount; ++i)
+        {
+            const int index = (frame * movedNodes + i) % nodeCount;
+            ImVec2 position = GridPosition(index, 250);
+            position.y += (float)(frame % 2) * 8.0f;
+            ed::SetNodePosition(index * 3 + 1, position);
+        }
+
+        FrameTiming timing = RunFrame(nodeCount);
+        sum.total   += timing.total;
+        sum.content += timing.content;
+        sum.begin   += timing.begin;
+        sum.end     += timing.end;
+    }
+
+    const double n = (double)frameCount;
+    const auto stats = ed::GetRenderStats();
+    fprintf(stdout, "%s, view scale %.3f:\n", label, 1.0f / ed::GetCurrentZoom());
+    fprintf(stdout, "  steady frame: %8.3f ms (submit %8.3f ms, Begin %8.3f ms, End %8.3f ms) over %d frames\n",
+        sum.total / n, sum.content / n, sum.begin / n, sum.end / n, frameCount);
+    fprintf(stdout, "  nodes: %d visible, %d culled, %d collapsed; links: %d visible, %d culled, %d simplified\n",
+        stats.VisibleNodes, stats.CulledNodes, stats.CollapsedNodes,
+        stats.VisibleLinks, stats.CulledLinks, stats.SimplifiedLinks);
+}
+
+int main(int argc, char** argv)
+{
+    const int nodeCount  = argc > 1 ? atoi(argv[1]) : 50000;
+    const int frameCount = argc > 2 ? atoi(argv[2]) : 20;
+    const char* settings = argc > 3 ? argv[3] : nullptr;
+    const int columns    = 250;
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2(1920, 1080);
+    io.DeltaTime = 1.0f / 60.0f;
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset; // allow more than 64k vertices per draw list
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    io.Fonts->AddFontDefault();
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    ed::Config config;
+    config.SettingsFile = nullptr;
+    config.SettingsBinaryFile = settings;
+    config.SaveSettingsInBackground = true;
+    auto editor = ed::CreateEditor(&config);
+    ed::SetCurrentEditor(editor);
+
+    // Place nodes on a grid once, so layout does not depend on creation order
+    auto start = Clock::now();
+    FrameTiming first = RunFrame(nodeCount);
+    const double createMs = ElapsedMs(start);
+    for (int i = 0; i < nodeCount; ++i)
+        ed::SetNodePosition(i * 3 + 1, GridPosition(i, columns));
+
+    fprintf(stdout, "nodes: %d, links: %d\n", nodeCount, nodeCount > 0 ? nodeCount - 1 : 0);
+    fprintf(stdout, "create frame: %8.3f ms (submit %8.3f ms, Begin %8.3f ms, End %8.3f ms)\n",
+        createMs, first.content, first.begin, first.end);
+
+    MeasureFrames("origin view", nodeCount, frameCount);
+
+    // Zoomed out to whole graph with level of detail enabled, nodes collapse and links get simplified
+    auto& style = ed::GetStyle();
+    style.NodeCollapseZoom = 0.25f;
+    style.LinkSimplifyZoom = 0.5f;
+    style.LinkStraightZoom = 0.15f;
+    ed::NavigateToContent(0.0f);
+    RunFrame(nodeCount);
+    MeasureFrames("content view", nodeCount, frameCount);
+
+    // Same view with every link drawn as full curve, geometry comes from link cache
+    style.LinkSimplifyZoom = 0.0f;
+    style.LinkStraightZoom = 0.0f;
+    RunFrame(nodeCount);
+    MeasureFrames("content view, full detail links", nodeCount, frameCount);
+    style.NodeCollapseZoom = 0.0f;
+
+    if (settings)
+    {
+        MeasureFrames("editing, 16 nodes moved per frame", nodeCount, frameCount, 16);
+
+        const int lastNode = nodeCount - 1;
+        ed::SetNodePosition(lastNode * 3 + 1, ImVec2(-1234.0f, 4321.0f));
+        RunFrame(nodeCount);
+
+        ed::SetCurrentEditor(nullptr);
+        ed::DestroyEditor(editor);
+
+        // Settings must survive editor restart
+        auto start = Clock::now();
+        editor = ed::CreateEditor(&config);
+        ed::SetCurrentEditor(editor);
+        RunFrame(nodeCount);
+        const double loadMs = ElapsedMs(start);
+        const ImVec2 restored = ed::GetNodePosition(lastNode * 3 + 1);
+        fprintf(stdout, "reload frame: %8.3f ms, last node restored at (%.0f, %.0f): %s\n",
+            loadMs, restored.x, restored.y, restored.x == -1234.0f && restored.y == 4321.0f ? "ok" : "MISMATCH");
+    }
+
+    ed::SetCurrentEditor(nullptr);
+    ed::DestroyEditor(editor);
+    ImGui::DestroyContext();
+    return 0;
+}
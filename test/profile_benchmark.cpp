@@ -0,0 +1,169 @@
+// Instrumentation benchmark.
+//
+// Frames are drawn without a backend with ImProfile enabled, zones from the frame and from worker
+// threads must be recorded with their nesting, MemAlloc and draw data counters must match what the
+// frame did, the Chrome trace must contain frames, zones and counters, ImProfileClear must drop
+// earlier zones, and the profile window must draw.
+// Then the cost of a zone is timed disabled and enabled, and a frame with and without profiling.
+//
+// usage: profile_benchmark [iterations]
+
+#include <imgui.h>
+#include <imgui_helper.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test_utils.h"
+
+static int g_frame_allocs = 0;
+
+static void Frame(bool show_profile)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1280, 720);
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::NewFrame();
+    {
+        IM_PROFILE_ZONE("Frame");
+        {
+            IM_PROFILE_ZONE("Widgets");
+            ImGui::SetNextWindowPos(ImVec2(0, 0));
+            ImGui::SetNextWindowSize(ImVec2(400, 400));
+            ImGui::Begin("Widgets");
+            for (int i = 0; i < 100; i++)
+                ImGui::Text("line %d", i);
+            ImGui::End();
+        }
+        // known allocations
+        for (int i = 0; i < g_frame_allocs; i++)
+            ImGui::MemFree(ImGui::MemAlloc(100));
+        if (show_profile)
+            ImGui::ShowProfileWindow();
+    }
+    ImGui::Render();
+}
+
+static bool Contains(const std::string& text, const char* what)
+{
+    return text.find(what) != std::string::npos;
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    fprintf(stdout, "check of profile:\n");
+    Check(!ImGui::ImProfileZoneBegin("disabled"), "zone while disabled");
+    ImGui::ImProfileSetThreadName("Main");
+    ImGui::ImProfileEnable(true);
+    for (int i = 0; i < 4; i++)
+        Frame(false);
+    // allocations of a frame are ImGui's own plus the known ones, a frame is stored at the next NewFrame()
+    g_frame_allocs = 1000;
+    Frame(false);
+    g_frame_allocs = 0;
+    Frame(false);
+    const int base_allocs = ImGui::ImProfileGetFrame(ImGui::ImProfileGetFrameCount() - 2).AllocCount;
+    const ImGui::ImProfileFrame& frame = ImGui::ImProfileGetFrame(ImGui::ImProfileGetFrameCount() - 1);
+    fprintf(stdout, "  %d frames, %d allocs %zu bytes, %d frees, %d draw cmds, %d vertices\n", ImGui::ImProfileGetFrameCount(), frame.AllocCount, frame.AllocBytes, frame.FreeCount, frame.DrawCmds, frame.Vertices);
+    Check(ImGui::ImProfileGetFrameCount() == 5, "frame count");
+    Check(frame.AllocCount == base_allocs + 1000 && frame.FreeCount >= 1000 && frame.AllocBytes >= 100000, "MemAlloc counters");
+    Check(frame.Vertices == ImGui::GetDrawData()->TotalVtxCount && frame.DrawCmds > 0, "draw data counters");
+    Check(frame.FrameMs >= frame.CpuMs && frame.CpuMs > 0, "frame time");
+
+    // worker threads
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 3; t++)
+        workers.emplace_back([t]() {
+            std::string name = "Worker " + std::to_string(t);
+            ImGui::ImProfileSetThreadName(name.c_str());
+            for (int i = 0; i < 100; i++)
+            {
+                IM_PROFILE_ZONE("Job");
+                IM_PROFILE_ZONE("Step");
+            }
+        });
+    for (auto& worker : workers)
+        worker.join();
+    Frame(true);
+    Frame(true);
+
+    const char* path = "profile_benchmark_trace.json";
+    Check(ImGui::ImProfileExportChromeTrace(path), "export");
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string trace = stream.str();
+    remove(path);
+    size_t jobs = 0;
+    for (size_t at = trace.find("\"Job\""); at != std::string::npos; at = trace.find("\"Job\"", at + 1))
+        jobs++;
+    fprintf(stdout, "  trace %zu KB, %zu Job zones\n", trace.size() / 1024, jobs);
+    Check(trace.rfind("{\"displayTimeUnit\"", 0) == 0 && trace.find("\n]}") != std::string::npos, "trace format");
+    Check(Contains(trace, "\"Worker 2\"") && Contains(trace, "\"Main\"") && jobs == 300, "worker zones");
+    Check(Contains(trace, "\"NewFrame\"") && Contains(trace, "\"Render\"") && Contains(trace, "\"Widgets\"") && Contains(trace, "\"Frame\",\"ph\":\"X\""), "frame zones");
+    Check(Contains(trace, "\"MemAlloc\",\"ph\":\"C\"") && Contains(trace, "\"DrawData\",\"ph\":\"C\""), "counters");
+
+    // ring buffer keeps the latest zones
+    for (int i = 0; i < ImGui::ImProfileZoneCapacity + 100; i++)
+    {
+        IM_PROFILE_ZONE("Wrap");
+    }
+    Check(ImGui::ImProfileExportChromeTrace(path), "export after wrap");
+    remove(path);
+
+    // clear drops what was recorded before it, zones after it are kept
+    ImGui::ImProfileClear();
+    {
+        IM_PROFILE_ZONE("AfterClear");
+    }
+    Check(ImGui::ImProfileExportChromeTrace(path), "export after clear");
+    std::ifstream cleared_file(path);
+    std::stringstream cleared_stream;
+    cleared_stream << cleared_file.rdbuf();
+    cleared_file.close();
+    const std::string cleared = cleared_stream.str();
+    remove(path);
+    Check(Contains(cleared, "\"AfterClear\"") && !Contains(cleared, "\"Wrap\"") && !Contains(cleared, "\"Job\""), "clear");
+
+    // zone cost
+    const int zones = 1000000;
+    const double enabled_ms = Measure(1, [&]() {
+        for (int i = 0; i < zones; i++)
+        {
+            IM_PROFILE_ZONE("Zone");
+        }
+    });
+    const double enabled_frame = Measure(iterations, [&]() { Frame(false); });
+    ImGui::ImProfileEnable(false);
+    const double disabled_ms = Measure(1, [&]() {
+        for (int i = 0; i < zones; i++)
+        {
+            IM_PROFILE_ZONE("Zone");
+        }
+    });
+    const double disabled_frame = Measure(iterations, [&]() { Frame(false); });
+    fprintf(stdout, "zone cost:\n");
+    fprintf(stdout, "  disabled %8.2f ns\n", disabled_ms * 1e6 / zones);
+    fprintf(stdout, "  enabled  %8.2f ns\n", enabled_ms * 1e6 / zones);
+    fprintf(stdout, "frame:\n");
+    fprintf(stdout, "  disabled %8.3f ms\n", disabled_frame);
+    fprintf(stdout, "  enabled  %8.3f ms\n", enabled_frame);
+    ImGui::DestroyContext();
+
+    return Result();
+}
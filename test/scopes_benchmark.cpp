@@ -0,0 +1,155 @@
+// Scopes cpu backend benchmark.
+//
+// Measures Histogram, Waveform, Vector and CIE scope throughput of
+// Scopes_cpu at 1080p and 4K RGBA int8 sources. Before that, the scopes of
+// a flat gray frame are checked, every sample must land in one bin/row.
+// When a vulkan device is present, the shader scopes are measured as well.
+//
+// usage: scopes_benchmark [iterations]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <Histogram_vulkan.h>
+#include <Waveform_vulkan.h>
+#include <Vector_vulkan.h>
+#include <CIE_vulkan.h>
+#include <Scopes_cpu.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include "test_utils.h"
+
+// Rec709 rgb to xyz, laid out like CIE_vulkan xyz_matrix
+static const float xyz_matrix_709[9] = {
+    0.412391f, 0.212639f, 0.019331f,
+    0.357584f, 0.715169f, 0.119195f,
+    0.180481f, 0.072192f, 0.950532f
+};
+
+static ImGui::ImMat MakeFrame(int w, int h, bool flat)
+{
+    ImGui::ImMat mat;
+    mat.create_type(w, h, 4, IM_DT_INT8);
+    uint32_t seed = 0x1234567;
+    for (int y = 0; y < h; y++)
+    {
+        uint8_t* p = (uint8_t *)mat.data + (size_t)y * w * 4;
+        for (int x = 0; x < w; x++, p += 4)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            p[0] = flat ? 128 : (uint8_t)(x * 255 / w);
+            p[1] = flat ? 128 : (uint8_t)(y * 255 / h);
+            p[2] = flat ? 128 : (uint8_t)(seed >> 24);
+            p[3] = 255;
+        }
+    }
+    return mat;
+}
+
+static void CheckFlatFrame(const ImGui::ImMat& xyz_matrix, const ImGui::ImMat& background)
+{
+    const int w = 640, h = 360;
+    ImGui::ImMat src = MakeFrame(w, h, true);
+    ImGui::ImMat dst;
+
+    // histogram samples even rows and columns, gray is counted once per channel
+    Check(ImGui::Scopes_cpu::Histogram(src, dst, 256, 1.f, false), "Histogram failed");
+    for (int k = 0; k < 4 && !dst.empty(); k++)
+    {
+        const float* data = (const float *)dst.data + k * dst.cstep;
+        float total = 0, peak = 0;
+        for (int i = 0; i < 256; i++) { total += data[i]; peak = std::max(peak, data[i]); }
+        Check(total == (float)(w / 2 * h / 2) && peak == total, "Histogram gray bin");
+    }
+
+    // waveform counts h / 2 samples of every column into one row
+    Check(ImGui::Scopes_cpu::Waveform(src, dst, 256, 1.f, false, false), "Waveform failed");
+    if (!dst.empty())
+    {
+        Check(dst.w == w && dst.h == 256 && dst.c == 4, "Waveform size");
+        int lit = 0;
+        for (int i = 0; i < dst.w * dst.h; i++)
+            lit += ((const uint8_t *)dst.data)[i * 4] == h / 2 ? 1 : 0;
+        Check(lit == w, "Waveform gray row");
+    }
+
+    // gray has no saturation, vector is a dot at center
+    Check(ImGui::Scopes_cpu::Vector(src, dst, 512, 1.f), "Vector failed");
+    if (!dst.empty())
+    {
+        const uint8_t* data = (const uint8_t *)dst.data;
+        Check(data[(256 * 512 + 256) * 4 + 3] == 255 && data[(256 * 512 + 300) * 4 + 3] == 0, "Vector gray point");
+    }
+
+    Check(ImGui::Scopes_cpu::CIE(src, dst, xyz_matrix, background, ImGui::XYY, 1.f, true), "CIE failed");
+    if (!dst.empty())
+    {
+        // white point of Rec709 (0.3127, 0.3290)
+        const int x = (int)(511 * 0.3127f), y = 511 - (int)(511 * 0.3290f);
+        int lit = 0;
+        for (int i = 0; i < 512 * 512; i++)
+            lit += ((const uint8_t *)dst.data)[i * 4] == 255 ? 1 : 0;
+        Check(((const uint8_t *)dst.data)[(y * 512 + x) * 4] == 255 && lit == 1, "CIE white point");
+    }
+}
+
+static void Benchmark(const char* label, int w, int h, int iterations, const std::function<double()>& func)
+{
+    func();
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+        func();
+    const double ms = ElapsedMs(start) / iterations;
+    fprintf(stdout, "  %-36s %8.3f ms  %8.1f Mpixel/s\n", label, ms, (double)w * h / 1000.0 / ms);
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        return 1;
+
+    const bool gpu = ImGui::get_gpu_count() > 0;
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, shader scopes are measured as well" : "no, cpu backend only");
+
+    ImGui::ImMat xyz_matrix;
+    xyz_matrix.create(3, 3, 4u, 1, nullptr);
+    for (int i = 0; i < 9; i++)
+        ((float *)xyz_matrix.data)[i] = xyz_matrix_709[i];
+    ImGui::ImMat background;
+    background.create(512, 512, 4, 1u, 4);
+    background.fill((int8_t)0);
+
+    CheckFlatFrame(xyz_matrix, background);
+    fprintf(stdout, "flat frame check: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+
+    const int sizes[2][2] = { {1920, 1080}, {3840, 2160} };
+    for (auto size : sizes)
+    {
+        const int w = size[0], h = size[1];
+        ImGui::ImMat src = MakeFrame(w, h, false);
+        ImGui::ImMat dst;
+        fprintf(stdout, "%dx%d cpu backend:\n", w, h);
+        Benchmark("Histogram", w, h, iterations, [&]() { return ImGui::Scopes_cpu::Histogram(src, dst, 256, 1.f, false) ? 1. : 0.; });
+        Benchmark("Waveform", w, h, iterations, [&]() { return ImGui::Scopes_cpu::Waveform(src, dst, 256, 0.1f, false, false) ? 1. : 0.; });
+        Benchmark("Waveform separate with Y", w, h, iterations, [&]() { return ImGui::Scopes_cpu::Waveform(src, dst, 256, 0.1f, true, true) ? 1. : 0.; });
+        Benchmark("Vector", w, h, iterations, [&]() { return ImGui::Scopes_cpu::Vector(src, dst, 512, 0.01f) ? 1. : 0.; });
+        Benchmark("CIE", w, h, iterations, [&]() { return ImGui::Scopes_cpu::CIE(src, dst, xyz_matrix, background, ImGui::XYY, 0.01f, true) ? 1. : 0.; });
+        if (gpu)
+        {
+            ImGui::Histogram_vulkan histogram(ImGui::get_default_gpu_index());
+            ImGui::Waveform_vulkan waveform(ImGui::get_default_gpu_index());
+            ImGui::Vector_vulkan vector(ImGui::get_default_gpu_index());
+            ImGui::CIE_vulkan cie(ImGui::get_default_gpu_index());
+            fprintf(stdout, "%dx%d vulkan, with upload and download:\n", w, h);
+            Benchmark("Histogram", w, h, iterations, [&]() { return histogram.scope(src, dst, 256, 1.f, false); });
+            Benchmark("Waveform", w, h, iterations, [&]() { return waveform.scope(src, dst, 256, 0.1f, false, false); });
+            Benchmark("Waveform separate with Y", w, h, iterations, [&]() { return waveform.scope(src, dst, 256, 0.1f, true, true); });
+            Benchmark("Vector", w, h, iterations, [&]() { return vector.scope(src, dst, 0.01f); });
+            Benchmark("CIE", w, h, iterations, [&]() { return cie.scope(src, dst, 0.01f, true); });
+        }
+    }
+
+    return Result();
+}
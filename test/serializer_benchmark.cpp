@@ -0,0 +1,414 @@
+// Deserializer benchmark.
+//
+// A workspace like file is written by ImGuiHelper::Serializer: a few header fields, then one section
+// per node starting with an [INT:node] field and holding FT_FLOAT arrays, doubles, flags, a string
+// and a FT_TEXTLINE block. It is loaded with the copying constructor, with mapFile(...) and parsed
+// in place, and with mapFile(...) and parseSections("node", ...) on all cores. Every mode must serve
+// the same values, which are compared with strtod(...) of the written text. Number parsing is also
+// checked against strtod(...) on random values, and a small text checks "\r\n", ',' decimal
+// separator, nan/inf and resuming after the callback has stopped parsing.
+//
+// Float curves are also saved as text FLOAT-4 fields and with Serializer::saveBinary(...), sizes
+// and save and load times are compared. Binary values must come back bit exact, and a binary field
+// with a broken char must be rejected without losing the next field.
+//
+// usage: serializer_benchmark [megabytes]
+
+#include <imgui.h>
+#include <imgui_helper.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "test_utils.h"
+
+static const char* kFileName = "serializer_benchmark.tmp";
+static const char* kBinaryFileName = "serializer_benchmark_binary.tmp";
+static const int kKeysPerNode = 48;
+static const int kCurveSize = 1 << 20;
+
+// what a section served, sums are in field order so every mode gets the same bits
+struct SectionStats
+{
+    int fields = 0;
+    double sum = 0;
+    uint32_t hash = 2166136261u;
+
+    void text(const char* s)
+    {
+        for (; *s; s++) hash = (hash ^ (uint8_t)*s) * 16777619u;
+        hash = (hash ^ '\n') * 16777619u;
+    }
+    bool operator==(const SectionStats& o) const { return fields == o.fields && sum == o.sum && hash == o.hash; }
+};
+
+static void Accumulate(SectionStats& s, ImGui::FieldType ft, int numArrayElements, void* pValue)
+{
+    s.fields++;
+    switch (ft)
+    {
+    case ImGui::FT_FLOAT:
+    case ImGui::FT_COLOR:    for (int i = 0; i < numArrayElements; i++) s.sum += ((const float*)pValue)[i]; break;
+    case ImGui::FT_DOUBLE:   for (int i = 0; i < numArrayElements; i++) s.sum += ((const double*)pValue)[i]; break;
+    case ImGui::FT_UNSIGNED: for (int i = 0; i < numArrayElements; i++) s.sum += ((const unsigned*)pValue)[i]; break;
+    case ImGui::FT_BOOL:     for (int i = 0; i < numArrayElements; i++) s.sum += ((const bool*)pValue)[i] ? 1 : 0; break;
+    case ImGui::FT_INT:
+    case ImGui::FT_ENUM:     for (int i = 0; i < numArrayElements; i++) s.sum += ((const int*)pValue)[i]; break;
+    default:                 s.text((const char*)pValue); break;
+    }
+}
+
+// writes the file and returns what every section must serve
+static std::vector<SectionStats> WriteWorkspace(size_t bytes)
+{
+    std::vector<SectionStats> expected(1);
+    ImGuiHelper::Serializer s(kFileName);
+    int version = 3;
+    s.save(&version, "version");
+    expected[0].fields++;
+    expected[0].sum += version;
+    s.save("serializer_benchmark", "application");
+    expected[0].fields++;
+    expected[0].text("serializer_benchmark");
+
+    char text[64];
+    uint32_t seed = 0x1234567;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed; };
+    auto value = [&next]() { return ((int)(next() >> 8) - (1 << 23)) / 4096.f; };
+    // values as the deserializer reads them back
+    auto written_float = [&text](float v, int prec) { snprintf(text, sizeof(text), "%.*f", prec, v); return (double)(float)strtod(text, NULL); };
+    FILE* f = ImFileOpen(kFileName, "rb");
+    for (int node = 0;; node++)
+    {
+        if ((node & 255) == 0 && f)
+        {
+            fseek(f, 0, SEEK_END);
+            if ((size_t)ftell(f) >= bytes) break;
+        }
+        SectionStats st;
+        s.save(&node, "node");
+        st.fields++;
+        st.sum += node;
+        float pos[2] = {value(), value()};
+        s.save(pos, "pos", 2);
+        st.fields++;
+        for (int i = 0; i < 2; i++) st.sum += written_float(pos[i], 3);
+        for (int k = 0; k < kKeysPerNode; k++)
+        {
+            float key[4] = {value(), value(), value(), value()};
+            s.save(key, "key", 4, 6);
+            st.fields++;
+            for (int i = 0; i < 4; i++) st.sum += written_float(key[i], 6);
+        }
+        double time[2] = {next() / 1000.0, next() / 7.0};
+        s.save(time, "time", 2, 9);
+        st.fields++;
+        for (int i = 0; i < 2; i++)
+        {
+            snprintf(text, sizeof(text), "%.*f", 9, time[i]);
+            st.sum += strtod(text, NULL);
+        }
+        unsigned flags = next();
+        s.save(&flags, "flags");
+        st.fields++;
+        st.sum += flags;
+        bool enabled[2] = {(next() & 1) != 0, (next() & 1) != 0};
+        s.save(enabled, "enabled", 2);
+        st.fields++;
+        st.sum += (enabled[0] ? 1 : 0) + (enabled[1] ? 1 : 0);
+        float color[4] = {0.25f, 0.5f, 0.75f, 1.f};
+        s.save(ImGui::FT_COLOR, color, "color", 4);
+        st.fields++;
+        st.sum += 2.5;
+        snprintf(text, sizeof(text), "Node %d [label]", node);
+        s.save(text, "label");
+        st.fields++;
+        st.text(text);
+        // header like text inside a value must not split sections
+        s.saveTextLines("first line\n[INT:node]\nthird line", "comment");
+        st.text("first line");
+        st.text("[INT:node]");
+        st.text("third line");
+        st.fields += 3;
+        expected.push_back(st);
+    }
+    if (f) fclose(f);
+    return expected;
+}
+
+struct ParseState
+{
+    std::vector<SectionStats> stats;
+};
+
+static bool ParseCallback(ImGui::FieldType ft, int numArrayElements, void* pValue, const char* name, void* userPtr)
+{
+    ParseState& state = *(ParseState*)userPtr;
+    if (state.stats.empty() || strcmp(name, "node") == 0) state.stats.emplace_back();
+    Accumulate(state.stats.back(), ft, numArrayElements, pValue);
+    return false;
+}
+
+static bool SectionCallback(ImGui::FieldType ft, int numArrayElements, void* pValue, const char* /*name*/, int section, void* userPtr)
+{
+    ParseState& state = *(ParseState*)userPtr;
+    Accumulate(state.stats[section], ft, numArrayElements, pValue);
+    return false;
+}
+
+static void CheckNumbers()
+{
+    // as Serializer writes them and with all significant digits
+    uint32_t seed = 42;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed; };
+    std::string text;
+    std::vector<double> expected;
+    char buffer[128];
+    for (int i = 0; i < 20000; i++)
+    {
+        const double v = ((double)next() - 2147483648.0) * pow(10.0, (int)(next() % 24) - 12) / (1 + next() % 1000);
+        if (i & 1) snprintf(buffer, sizeof(buffer), "%.*f", (int)(next() % 10), v);
+        else snprintf(buffer, sizeof(buffer), "%.17g", v);
+        text += "[DOUBLE:v]\n";
+        text += buffer;
+        text += "\n\n";
+        expected.push_back(strtod(buffer, NULL));
+    }
+    struct State { std::vector<double> values; } state;
+    ImGuiHelper::Deserializer d(text.c_str(), text.size() + 1);
+    d.parse([](ImGui::FieldType, int, void* pValue, const char*, void* userPtr) {
+        ((State*)userPtr)->values.push_back(*(const double*)pValue);
+        return false;
+    }, &state);
+    Check(state.values.size() == expected.size(), "number of doubles");
+    int exact = 0, within_ulp = 0;
+    for (size_t i = 0; i < state.values.size() && i < expected.size(); i++)
+    {
+        const double e = expected[i], v = state.values[i];
+        if (v == e) exact++;
+        else if (v == nextafter(e, INFINITY) || v == nextafter(e, -INFINITY)) within_ulp++;
+        else if (i & 1) Check(false, "fixed point double");
+    }
+    fprintf(stdout, "  %d of %zu doubles equal to strtod, %d within 1 ulp\n", exact, expected.size(), within_ulp);
+    Check(exact + within_ulp == (int)expected.size(), "doubles within 1 ulp of strtod");
+}
+
+static void CheckSmall()
+{
+    static const char text[] =
+        "[INT:version]\r\n2\r\n\r\n"
+        "[FOO-2:unknown]\r\n1 2\r\n\r\n"
+        "[FLOAT-2:a]\r\n1,5 -2e3\r\n\r\n"
+        "[STRING:c]\r\nx\r\n\r\n"
+        "[STRING-6:s]\r\nab\r\ncd\r\n\r\n"
+        "[TEXTLINE-2:t]\r\nl1\r\nl2\r\n\r\n"
+        "[DOUBLE-2:d]\r\ninf -nan\r\n\r\n"
+        "[BOOL-2:b]\r\n1 0\r\n";
+    struct State
+    {
+        std::string log;
+        const char* stopAt;
+    };
+    auto callback = [](ImGui::FieldType ft, int numArrayElements, void* pValue, const char* name, void* userPtr) {
+        State& state = *(State*)userPtr;
+        char buffer[64];
+        switch (ft)
+        {
+        case ImGui::FT_INT:      snprintf(buffer, sizeof(buffer), "%s=%d;", name, *(int*)pValue); break;
+        case ImGui::FT_FLOAT:    snprintf(buffer, sizeof(buffer), "%s=%g,%g;", name, ((float*)pValue)[0], ((float*)pValue)[1]); break;
+        case ImGui::FT_DOUBLE:   snprintf(buffer, sizeof(buffer), "%s=%g,%s;", name, ((double*)pValue)[0], std::isnan(((double*)pValue)[1]) ? "nan" : "?"); break;
+        case ImGui::FT_BOOL:     snprintf(buffer, sizeof(buffer), "%s=%d,%d;", name, ((bool*)pValue)[0], ((bool*)pValue)[1]); break;
+        case ImGui::FT_TEXTLINE: snprintf(buffer, sizeof(buffer), "%s%d=%s;", name, numArrayElements, (char*)pValue); break;
+        default:                 snprintf(buffer, sizeof(buffer), "%s=%s|%d;", name, (char*)pValue, numArrayElements); break;
+        }
+        state.log += buffer;
+        return state.stopAt && strcmp(name, state.stopAt) == 0;
+    };
+    static const char* expected = "version=2;a=1.5,-2000;c=x|1;s=ab\r\ncd|6;t0=l1;t1=l2;d=inf,nan;b=1,0;";
+    ImGuiHelper::Deserializer d(text, sizeof(text));
+    State all {"", NULL};
+    d.parse(callback, &all);
+    Check(all.log == expected, "small text");
+    if (all.log != expected) fprintf(stdout, "  %s\n", all.log.c_str());
+
+    State first {"", "c"}, rest {"", NULL};
+    const char* resume = d.parse(callback, &first);
+    d.parse(callback, &rest, resume);
+    Check(first.log + rest.log == expected, "parse resumed after callback stopped");
+
+    ImVector<const char*> starts;
+    Check(d.findSections("t", starts) == 2 && strncmp(starts[1], "[TEXTLINE-2:t]", 14) == 0, "findSections");
+}
+
+static void CheckBinary()
+{
+    double values[1000];
+    for (int i = 0; i < 1000; i++) values[i] = sin(i * 0.01) * 1e5;
+    static const int ints[3] = {-1, 7, 1 << 30};
+    ImGuiHelper::Serializer s;
+    s.saveBinary(values, "values", 1000);
+    s.saveBinary(ints, "ints", 3);
+    std::string text(s.getBuffer());
+    struct State
+    {
+        bool values;
+        bool ints;
+    };
+    auto callback = [](ImGui::FieldType ft, int numArrayElements, void* pValue, const char* name, void* userPtr) {
+        State& state = *(State*)userPtr;
+        if (strcmp(name, "values") == 0)
+        {
+            state.values = ft == ImGui::FT_DOUBLE && numArrayElements == 1000;
+            for (int i = 0; i < 1000 && state.values; i++) state.values = ((const double*)pValue)[i] == sin(i * 0.01) * 1e5;
+        }
+        else if (strcmp(name, "ints") == 0)
+            state.ints = ft == ImGui::FT_INT && numArrayElements == 3 && memcmp(pValue, ints, sizeof(ints)) == 0;
+        return false;
+    };
+    State state {false, false};
+    ImGuiHelper::Deserializer d(text.c_str(), text.size() + 1);
+    d.parse(callback, &state);
+    Check(state.values && state.ints, "binary round trip");
+
+    // a changed char in the middle of the data
+    text[text.find("#B85 ") + 100] ^= 1;
+    State broken {false, false};
+    ImGuiHelper::Deserializer d2(text.c_str(), text.size() + 1);
+    d2.parse(callback, &broken);
+    Check(!broken.values && broken.ints, "broken binary field is rejected");
+}
+
+static void MeasureBinary(int curves)
+{
+    std::vector<float> curve(kCurveSize);
+    for (int i = 0; i < kCurveSize; i++) curve[i] = sinf(i * 0.001f) * (1.f + i / (float)kCurveSize);
+    auto file_mb = [](const char* filename) {
+        FILE* f = ImFileOpen(filename, "rb");
+        if (!f) return 0.0;
+        fseek(f, 0, SEEK_END);
+        const double mb = (double)ftell(f) / (1024.0 * 1024.0);
+        fclose(f);
+        return mb;
+    };
+    auto start = Clock::now();
+    {
+        ImGuiHelper::Serializer s(kFileName);
+        for (int c = 0; c < curves; c++)
+            for (int i = 0; i < kCurveSize; i += 4)
+                s.save(&curve[i], "curve", 4, 6);
+    }
+    const double text_save_ms = ElapsedMs(start);
+    start = Clock::now();
+    {
+        ImGuiHelper::Serializer s(kBinaryFileName);
+        for (int c = 0; c < curves; c++)
+            s.saveBinary(curve.data(), "curve", kCurveSize);
+    }
+    const double binary_save_ms = ElapsedMs(start);
+
+    struct State
+    {
+        const std::vector<float>* curve;
+        size_t values;
+        bool same;
+    };
+    auto callback = [](ImGui::FieldType, int numArrayElements, void* pValue, const char*, void* userPtr) {
+        State& state = *(State*)userPtr;
+        if (numArrayElements == kCurveSize)
+            state.same &= memcmp(pValue, state.curve->data(), kCurveSize * sizeof(float)) == 0;
+        state.values += numArrayElements;
+        return false;
+    };
+    State text_state {&curve, 0, true}, binary_state {&curve, 0, true};
+    start = Clock::now();
+    {
+        ImGuiHelper::Deserializer d;
+        d.mapFile(kFileName);
+        d.parse(callback, &text_state);
+    }
+    const double text_load_ms = ElapsedMs(start);
+    start = Clock::now();
+    {
+        ImGuiHelper::Deserializer d;
+        d.mapFile(kBinaryFileName);
+        d.parse(callback, &binary_state);
+    }
+    const double binary_load_ms = ElapsedMs(start);
+
+    const double raw_mb = (double)curves * kCurveSize * sizeof(float) / (1024.0 * 1024.0);
+    fprintf(stdout, "%d float curves of %d values, %.0f MB raw:\n", curves, kCurveSize, raw_mb);
+    fprintf(stdout, "  text FLOAT-4 %%.6f  %8.1f MB  save %8.0f ms  load %8.0f ms\n", file_mb(kFileName), text_save_ms, text_load_ms);
+    fprintf(stdout, "  saveBinary          %8.1f MB  save %8.0f ms  load %8.0f ms  (%.1fx smaller, %.1fx faster save, %.1fx faster load)\n",
+            file_mb(kBinaryFileName), binary_save_ms, binary_load_ms, file_mb(kFileName) / file_mb(kBinaryFileName),
+            text_save_ms / binary_save_ms, text_load_ms / binary_load_ms);
+    Check(text_state.values == (size_t)curves * kCurveSize, "text curves");
+    Check(binary_state.values == (size_t)curves * kCurveSize && binary_state.same, "binary curves");
+    remove(kFileName);
+    remove(kBinaryFileName);
+}
+
+int main(int argc, char** argv)
+{
+    const int megabytes = argc > 1 ? atoi(argv[1]) : 256;
+    if (megabytes <= 0)
+        return 1;
+
+    fprintf(stdout, "check of number parsing and small text:\n");
+    CheckNumbers();
+    CheckSmall();
+    CheckBinary();
+
+    auto start = Clock::now();
+    const std::vector<SectionStats> expected = WriteWorkspace((size_t)megabytes * 1024 * 1024);
+    const double write_ms = ElapsedMs(start);
+    FILE* f = ImFileOpen(kFileName, "rb");
+    if (!f)
+    {
+        fprintf(stdout, "can't write %s\n", kFileName);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    const double mb = (double)ftell(f) / (1024.0 * 1024.0);
+    fclose(f);
+    fprintf(stdout, "%.0f MB file with %zu sections, written by Serializer in %.0f ms\n", mb, expected.size(), write_ms);
+
+    {
+        start = Clock::now();
+        ImGuiHelper::Deserializer d(kFileName);
+        ParseState state;
+        d.parse(ParseCallback, &state);
+        const double ms = ElapsedMs(start);
+        fprintf(stdout, "  read and parse           %8.0f ms  %8.1f MB/s\n", ms, mb / (ms / 1000.0));
+        Check(state.stats == expected, "read and parse");
+    }
+    {
+        start = Clock::now();
+        ImGuiHelper::Deserializer d;
+        d.mapFile(kFileName);
+        ParseState state;
+        d.parse(ParseCallback, &state);
+        const double ms = ElapsedMs(start);
+        fprintf(stdout, "  map and parse            %8.0f ms  %8.1f MB/s\n", ms, mb / (ms / 1000.0));
+        Check(state.stats == expected, "map and parse");
+    }
+    {
+        start = Clock::now();
+        ImGuiHelper::Deserializer d;
+        d.mapFile(kFileName);
+        ParseState state;
+        state.stats.resize(expected.size());
+        const int sections = d.parseSections("node", SectionCallback, &state);
+        const double ms = ElapsedMs(start);
+        fprintf(stdout, "  map and parseSections    %8.0f ms  %8.1f MB/s  (%u threads)\n", ms, mb / (ms / 1000.0), std::thread::hardware_concurrency());
+        Check(sections == (int)expected.size() && state.stats == expected, "map and parseSections");
+    }
+    remove(kFileName);
+
+    MeasureBinary(std::max(1, megabytes / 16));
+
+    return Result();
+}
@@ -0,0 +1,293 @@
+// Shader cache test.
+//
+// Compiles a shader twice with the disk cache enabled, the second compile must be loaded from
+// cache and produce the same spirv. A corrupted cache file must be ignored and recompiled.
+// This needs no vulkan device. With VKSHADER_SPIRV_PREBUILT, packing, peak and every filter
+// shader must be found in the embedded table with the source and options the runtime compiles
+// it with. Then, with a device, measures ColorConvert_vulkan creation, which compiles and
+// creates all its pipelines, with an empty cache and after ImVulkanShaderClear/
+// ImVulkanShaderInit with a warm cache.
+//
+// usage: shader_cache_test [cache dir]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <ColorConvert_vulkan.h>
+#include <imvk_Packing_shader.h>
+#include <imvk_mat_shader.h>
+#include <ColorConvert_shader.h>
+// filter shader headers share macro and array names, each one goes in its own namespace
+#define BILATERAL_DEFECT    // Bilateral_vulkan.cpp builds its shader with it
+namespace Bilateral_shader {
+#include <Bilateral_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Brightness_shader {
+#include <Brightness_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace ColorInvert_shader {
+#include <ColorInvert_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Contrast_shader {
+#include <Contrast_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Exposure_shader {
+#include <Exposure_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Filter2D_shader {
+#include <Filter2D_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_FILTER_MAIN
+namespace Filter2DS_shader {
+#include <Filter2DS_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_FILTER_COLUMN_MAIN
+#undef SHADER_FILTER_ROW_MAIN
+#undef SHADER_FILTER_COLUMN_MONO_MAIN
+#undef SHADER_FILTER_ROW_MONO_MAIN
+namespace Gamma_shader {
+#include <Gamma_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Hue_shader {
+#include <Hue_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_HUE
+#undef SHADER_MAIN
+namespace Saturation_shader {
+#include <Saturation_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Lut3D_shader {
+#include <Lut3D_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_LUT3D_NEARSET
+#undef SHADER_LUT3D_TRILINEAR
+#undef SHADER_LUT3D_TETRAHEDRAL
+#undef SHADER_LUT3D
+#undef SHADER_LUT3D_MAIN
+namespace Dilation_shader {
+#include <Dilation_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+namespace Erosion_shader {
+#include <Erosion_shader.h>
+}
+#undef SHADER_PARAM
+#undef SHADER_MAIN
+#include <cstdio>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+#include "test_utils.h"
+
+static const char test_shader[] = R"(
+#version 450
+layout (constant_id = 0) const int w = 0;
+layout (binding = 0) buffer data_blob { float data[]; };
+void main()
+{
+    int gx = int(gl_GlobalInvocationID.x);
+    if (gx >= w)
+        return;
+    data[gx] = data[gx] * 2.f + 1.f;
+}
+)";
+
+static std::string TempCacheDir()
+{
+#if defined(_WIN32)
+    char path[MAX_PATH];
+    GetTempPathA(MAX_PATH, path);
+    return std::string(path) + "shader_cache_test";
+#else
+    return std::string("/tmp/shader_cache_test");
+#endif
+}
+
+static void CheckSpirvCache()
+{
+    ImGui::Option opt;
+    std::vector<uint32_t> cold, warm, again;
+
+    auto start = Clock::now();
+    Check(ImGui::compile_spirv_module(test_shader, opt, cold) == 0, "compile");
+    const double cold_ms = ElapsedMs(start);
+
+    start = Clock::now();
+    Check(ImGui::compile_spirv_module(test_shader, opt, warm) == 0, "cached compile");
+    const double warm_ms = ElapsedMs(start);
+    Check(!cold.empty() && cold == warm, "cached spirv differs");
+    fprintf(stdout, "  spirv compile %8.3f ms, from cache %8.3f ms\n", cold_ms, warm_ms);
+
+    // different option flags must not share cache entry
+    opt.use_fp16_storage = !opt.use_fp16_storage;
+    Check(ImGui::compile_spirv_module(test_shader, opt, again) == 0, "compile with other option");
+    opt.use_fp16_storage = !opt.use_fp16_storage;
+
+    // corrupt every cache file, compile must fall back to glslang
+    const std::string dir = ImGui::get_shader_cache_dir() + "spirv/";
+    int corrupted = 0;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA find;
+    HANDLE handle = FindFirstFileA((dir + "*.spv").c_str(), &find);
+    for (bool ok = handle != INVALID_HANDLE_VALUE; ok; ok = FindNextFileA(handle, &find))
+    {
+        FILE* fp = fopen((dir + find.cFileName).c_str(), "r+b");
+#else
+    FILE* list = popen(("ls " + dir + "*.spv").c_str(), "r");
+    char name[1024];
+    while (list && fgets(name, sizeof(name), list))
+    {
+        std::string file(name);
+        file.erase(file.find_last_not_of("\r\n") + 1);
+        FILE* fp = fopen(file.c_str(), "r+b");
+#endif
+        if (!fp)
+            continue;
+        fseek(fp, 48, SEEK_SET);
+        fputc(0x5a, fp);
+        fclose(fp);
+        corrupted++;
+    }
+#if defined(_WIN32)
+    if (handle != INVALID_HANDLE_VALUE)
+        FindClose(handle);
+#else
+    if (list)
+        pclose(list);
+#endif
+    Check(corrupted >= 2, "cache files written");
+
+    again.clear();
+    Check(ImGui::compile_spirv_module(test_shader, opt, again) == 0, "compile with corrupted cache");
+    Check(again == cold, "spirv after corrupted cache differs");
+}
+
+// shaders of Packing_vulkan::create_pipeline, same cast type, fp32 to fp16, fp16 to fp32
+static const char* packing_same[] = {packing, packing_pack4to1, packing_pack8to1, packing_pack4, packing_pack1to4, packing_pack8to4, packing_pack8, packing_pack1to8, packing_pack4to8};
+static const char* packing_to_fp16[] = {packing_fp32_to_fp16, packing_pack4to1_fp32_to_fp16, packing_pack8to1_fp32_to_fp16, packing_pack4_fp32_to_fp16, packing_pack1to4_fp32_to_fp16,
+                                        packing_pack8to4_fp32_to_fp16, packing_pack8_fp32_to_fp16, packing_pack1to8_fp32_to_fp16, packing_pack4to8_fp32_to_fp16};
+static const char* packing_to_fp32[] = {packing_fp16_to_fp32, packing_pack4to1_fp16_to_fp32, packing_pack8to1_fp16_to_fp32, packing_pack4_fp16_to_fp32, packing_pack1to4_fp16_to_fp32,
+                                        packing_pack8to4_fp16_to_fp32, packing_pack8_fp16_to_fp32, packing_pack1to8_fp16_to_fp32, packing_pack4to8_fp16_to_fp32};
+
+static void CheckPrebuilt()
+{
+    const int count = ImGui::get_prebuilt_spirv_count();
+    if (count == 0)
+    {
+        fprintf(stdout, "  no precompiled spirv, VKSHADER_SPIRV_PREBUILT is off\n");
+        return;
+    }
+    int keys = 0, missing = 0;
+    auto resolve = [&](const char* comp, const ImGui::Option& opt)
+    {
+        keys++;
+        if (!ImGui::has_prebuilt_spirv(comp, opt))
+            missing++;
+    };
+
+    // packing uops, options as VulkanDevice creates them
+    ImGui::Option opt;
+    for (int i0 = 0; i0 < 2; i0++)
+        for (int i1 = 0; i1 < 2; i1++)
+            for (int j0 = 0; j0 < 3; j0++)
+                for (int j1 = 0; j1 < 3; j1++)
+                {
+                    if ((j0 == 1 && j1 == 2) || (j0 == 2 && j1 == 1))
+                        continue;
+                    ImGui::get_uop_option(i0, i1, j0, j1, opt);
+                    const char** shaders = j0 == j1 ? packing_same : j0 == 0 ? packing_to_fp16 : packing_to_fp32;
+                    for (int k = 0; k < 9; k++)
+                        resolve(shaders[k], opt);
+                }
+
+    // ImVulkanPeak
+    const char* peak_shaders[] = {glsl_p1_data, glsl_p4_data, glsl_p8_data};
+    for (int storage_type = 0; storage_type < 3; storage_type++)
+        for (int arithmetic_type = 0; arithmetic_type < 2; arithmetic_type++)
+        {
+            opt = ImGui::Option();
+            opt.use_fp16_packed = storage_type == 1;
+            opt.use_fp16_storage = storage_type == 2;
+            opt.use_fp16_arithmetic = arithmetic_type == 1;
+            for (const char* shader : peak_shaders)
+                resolve(shader, opt);
+        }
+
+    // filters, with and without VULKAN_SHADER_FP16
+    const char* filter_shaders[] = {YUV2RGB_data, Y_U_V2RGB_data, RGB2YUV_data, GRAY2RGB_data, Conv_data,
+                                    Bilateral_shader::Filter_data, Brightness_shader::Filter_data, ColorInvert_shader::Filter_data,
+                                    Contrast_shader::Filter_data, Exposure_shader::Filter_data, Filter2D_shader::Filter_data,
+                                    Filter2DS_shader::FilterColumn_data, Filter2DS_shader::FilterRow_data,
+                                    Filter2DS_shader::FilterColumnMono_data, Filter2DS_shader::FilterRowMono_data,
+                                    Gamma_shader::Filter_data, Hue_shader::Filter_data, Saturation_shader::Filter_data,
+                                    Lut3D_shader::LUT3D_data, Dilation_shader::Filter_data, Erosion_shader::Filter_data};
+    for (int fp16 = 0; fp16 < 2; fp16++)
+    {
+        opt = ImGui::Option();
+        opt.use_fp16_arithmetic = fp16 == 1;
+        opt.use_fp16_storage = fp16 == 1;
+        for (const char* shader : filter_shaders)
+            resolve(shader, opt);
+    }
+
+    fprintf(stdout, "  %d precompiled modules, %d of %d runtime keys missing\n", count, missing, keys);
+    Check(missing == 0, "runtime key without precompiled spirv");
+}
+
+static double CreateColorConvert()
+{
+    auto start = Clock::now();
+    ImGui::ColorConvert_vulkan* convert = new ImGui::ColorConvert_vulkan(ImGui::get_default_gpu_index());
+    const double ms = ElapsedMs(start);
+    delete convert;
+    return ms;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string cache_dir = argc > 1 ? argv[1] : TempCacheDir();
+
+    ImGui::ImVulkanShaderInit(cache_dir);
+    fprintf(stdout, "cache dir: %s\n", ImGui::get_shader_cache_dir().c_str());
+
+    // spirv compile and cache need no device
+    CheckPrebuilt();
+    CheckSpirvCache();
+    fprintf(stdout, "spirv cache check: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+    if (ImGui::get_gpu_count() <= 0)
+    {
+        fprintf(stdout, "no vulkan device, pipeline timing skipped\n");
+        ImGui::ImVulkanShaderClear();
+        return Result();
+    }
+
+    // first run of a clean cache dir is cold, later runs start warm from disk
+    const double first_ms = CreateColorConvert();
+    ImGui::ImVulkanShaderClear();
+    ImGui::ImVulkanShaderInit(cache_dir);
+    const double warm_ms = CreateColorConvert();
+    fprintf(stdout, "  ColorConvert_vulkan create %8.3f ms, after reinit %8.3f ms\n", first_ms, warm_ms);
+
+    ImGui::ImVulkanShaderClear();
+    return Result();
+}
@@ -0,0 +1,48 @@
+// Helpers shared by the tests and benchmarks of this directory.
+//
+// Check() counts failures instead of stopping, so one run reports every mismatch, and Result()
+// prints the final "result:" line and gives the exit code. Measure() returns the average time
+// of one call in ms after a warm up call.
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static inline double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static int g_checks = 0;
+static int g_failures = 0;
+
+static inline void Check(bool ok, const char* what)
+{
+    g_checks++;
+    if (!ok)
+    {
+        g_failures++;
+        // a broken kernel fails every case, the first ones are enough
+        if (g_failures <= 20)
+            fprintf(stdout, "  MISMATCH: %s\n", what);
+    }
+}
+
+static inline double Measure(int iterations, const std::function<void()>& func)
+{
+    func();
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+        func();
+    return ElapsedMs(start) / iterations;
+}
+
+static inline int Result()
+{
+    fprintf(stdout, "result: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+// Resize and warp cpu backend benchmark.
+//
+// Checks Warp_cpu resize of every interpolation mode against a direct per pixel reference with
+// clamped borders, for up, down and mixed scales of INT8/INT16/FLOAT32 mats with 1, 3 and 4
+// channels. Warps must keep a frame with identity matrix, move it by integer translation, rotate
+// it by 90 degrees and fill pixels out of crop with border color, affine and perspective matrices
+// of same transform must give same frame. Then resize and warps are timed on a 1080p frame.
+// When a vulkan device is present, the shader filters are measured as well.
+//
+// usage: warp_benchmark [iterations]
+
+#include <immat.h>
+#include <ImVulkanShader.h>
+#include <Resize_vulkan.h>
+#include <warpAffine_vulkan.h>
+#include <warpPerspective_vulkan.h>
+#include <Warp_cpu.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include "test_utils.h"
+
+static double Scale(ImDataType type)
+{
+    return type == IM_DT_INT8 ? 255.0 : type == IM_DT_INT16 ? 65535.0 : 1.0;
+}
+
+// channel value as unit double
+static double Value(const ImGui::ImMat& mat, int x, int y, int k)
+{
+    const size_t i = ((size_t)y * mat.w + x) * mat.c + k;
+    switch (mat.type)
+    {
+        case IM_DT_INT8: return ((const uint8_t *)mat.data)[i] / 255.0;
+        case IM_DT_INT16: return ((const uint16_t *)mat.data)[i] / 65535.0;
+        default: return ((const float *)mat.data)[i];
+    }
+}
+
+static ImGui::ImMat MakeFrame(int w, int h, int c, ImDataType type)
+{
+    ImGui::ImMat mat;
+    mat.create_type(w, h, c, type);
+    uint32_t seed = 0x1234567;
+    for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++)
+    for (int k = 0; k < c; k++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        // smooth gradient with noise, so interpolation matters
+        const double v = std::min(std::max(0.5 + 0.4 * sin(x * 0.3 + k) * cos(y * 0.2) + ((seed >> 24) / 255.0 - 0.5) * 0.2, 0.0), 1.0);
+        const size_t i = ((size_t)y * w + x) * c + k;
+        if (type == IM_DT_INT8) ((uint8_t *)mat.data)[i] = (uint8_t)(v * 255.0);
+        else if (type == IM_DT_INT16) ((uint16_t *)mat.data)[i] = (uint16_t)(v * 65535.0);
+        else ((float *)mat.data)[i] = (float)v;
+    }
+    return mat;
+}
+
+// taps of output i on one axis with clamped source indices, as Resize_vulkan modes
+static void AxisTaps(int i, int src_n, int dst_n, ImInterpolateMode type, std::vector<int>& index, std::vector<double>& weight)
+{
+    const double scale = (double)src_n / dst_n;
+    index.clear();
+    weight.clear();
+    auto add = [&](int k, double w) { index.push_back(std::min(std::max(k, 0), src_n - 1)); weight.push_back(w); };
+    if (type == IM_INTERPOLATE_BILINEAR)
+    {
+        const double s = i * scale;
+        const int s0 = (int)floor(s);
+        add(s0, 1.0 - (s - s0));
+        add(s0 + 1, s - s0);
+    }
+    else if (type == IM_INTERPOLATE_BICUBIC)
+    {
+        const double s = (i + 0.5) * scale - 0.5, A = -0.75;
+        const int s0 = (int)floor(s);
+        const double f = s - s0;
+        const double c0 = ((A * (f + 1) - 5 * A) * (f + 1) + 8 * A) * (f + 1) - 4 * A;
+        const double c1 = ((A + 2) * f - (A + 3)) * f * f + 1;
+        const double c2 = ((A + 2) * (1 - f) - (A + 3)) * (1 - f) * (1 - f) + 1;
+        add(s0 - 1, c0); add(s0, c1); add(s0 + 1, c2); add(s0 + 2, 1 - c0 - c1 - c2);
+    }
+    else if (type == IM_INTERPOLATE_AREA && scale > 1.0)
+    {
+        const double s0 = i * scale, s1 = std::min(s0 + scale, (double)src_n);
+        for (int k = (int)floor(s0); k < (int)ceil(s1); k++)
+            add(k, (std::min(s1, k + 1.0) - std::max(s0, (double)k)) / (s1 - s0));
+    }
+    else if (type == IM_INTERPOLATE_AREA)
+    {
+        const int s0 = (int)floor(i * scale);
+        double f = (i + 1) - (s0 + 1) / scale;
+        f = f <= 0 ? 0 : f - floor(f);
+        add(s0, 1 - f);
+        add(s0 + 1, f);
+    }
+    else
+        add((int)floor(i * scale), 1.0);
+}
+
+static void CheckResize()
+{
+    const ImInterpolateMode modes[] = {IM_INTERPOLATE_NEAREST, IM_INTERPOLATE_BILINEAR, IM_INTERPOLATE_BICUBIC, IM_INTERPOLATE_AREA};
+    const ImDataType types[] = {IM_DT_INT8, IM_DT_INT16, IM_DT_FLOAT32};
+    struct { int sw, sh, dw, dh; } sizes[] = {{37, 23, 80, 51}, {37, 23, 11, 7}, {37, 23, 19, 40}, {2, 3, 9, 5}};
+    const int channels[] = {4, 3, 1};
+    std::vector<int> ix, iy;
+    std::vector<double> wx, wy;
+    for (auto type : types)
+    for (int c : channels)
+    for (auto size : sizes)
+    {
+        ImGui::ImMat src = MakeFrame(size.sw, size.sh, c, type);
+        for (auto mode : modes)
+        {
+            ImGui::ImMat dst;
+            dst.create_type(size.dw, size.dh, c, type);
+            dst.color_format = src.color_format;
+            Check(ImGui::Warp_cpu::Resize(src, dst, mode), "Resize failed");
+            double max_diff = 0;
+            for (int y = 0; y < size.dh; y++)
+            for (int x = 0; x < size.dw; x++)
+            {
+                AxisTaps(x, size.sw, size.dw, mode, ix, wx);
+                AxisTaps(y, size.sh, size.dh, mode, iy, wy);
+                for (int k = 0; k < c; k++)
+                {
+                    double v = 0;
+                    for (size_t j = 0; j < iy.size(); j++)
+                        for (size_t i = 0; i < ix.size(); i++)
+                            v += wy[j] * wx[i] * Value(src, ix[i], iy[j], k);
+                    v = std::min(std::max(v, 0.0), 1.0);
+                    max_diff = std::max(max_diff, fabs(v - Value(dst, x, y, k)) * Scale(type));
+                }
+            }
+            // integer types round once at end, fixed point and float sums may round other way
+            Check(max_diff <= (type == IM_DT_FLOAT32 ? 1e-4 : 1.0), "Resize differs from reference");
+        }
+        // destination of other layout is converted from source layout
+        ImGui::ImMat same, other;
+        same.create_type(size.dw, size.dh, c, type);
+        same.color_format = src.color_format;
+        other.create_type(size.dw, size.dh, 4, IM_DT_FLOAT32);
+        ImGui::Warp_cpu::Resize(src, same, IM_INTERPOLATE_BILINEAR);
+        ImGui::Warp_cpu::Resize(src, other, IM_INTERPOLATE_BILINEAR);
+        double max_diff = 0;
+        for (int y = 0; y < size.dh; y++)
+        for (int x = 0; x < size.dw; x++)
+        for (int k = 0; k < 3; k++)
+            max_diff = std::max(max_diff, fabs(Value(same, x, y, c == 1 ? 0 : k) - Value(other, x, y, k)));
+        Check(max_diff < 1e-6, "Resize into other layout differs");
+    }
+}
+
+static ImGui::ImMat Matrix(const std::vector<float>& values)
+{
+    ImGui::ImMat M;
+    M.create_type(3, (int)values.size() / 3, IM_DT_FLOAT32);
+    std::copy(values.begin(), values.end(), (float *)M.data);
+    return M;
+}
+
+static int MaxDiff(const ImGui::ImMat& a, const ImGui::ImMat& b)
+{
+    int diff = 0;
+    for (size_t i = 0; i < (size_t)a.w * a.h * a.c; i++)
+        diff = std::max(diff, std::abs((int)((const uint8_t *)a.data)[i] - (int)((const uint8_t *)b.data)[i]));
+    return diff;
+}
+
+static void CheckWarp()
+{
+    const int w = 67, h = 45;
+    ImGui::ImMat src = MakeFrame(w, h, 4, IM_DT_INT8);
+    const ImPixel border(1.f, 0.f, 0.5f, 1.f);
+    const uint8_t border8[4] = {255, 0, 127, 255};
+    const ImInterpolateMode modes[] = {IM_INTERPOLATE_NEAREST, IM_INTERPOLATE_BILINEAR, IM_INTERPOLATE_BICUBIC};
+    auto make_dst = [](int dw, int dh) { ImGui::ImMat dst; dst.create_type(dw, dh, 4, IM_DT_INT8); return dst; };
+    for (auto mode : modes)
+    {
+        ImGui::ImMat affine = make_dst(w, h), perspective = make_dst(w, h);
+        Check(ImGui::Warp_cpu::warpAffine(src, affine, Matrix({1, 0, 0, 0, 1, 0}), mode, border, ImPixel()), "warpAffine failed");
+        Check(ImGui::Warp_cpu::warpPerspective(src, perspective, Matrix({1, 0, 0, 0, 1, 0, 0, 0, 1}), mode, border, ImPixel()), "warpPerspective failed");
+        Check(MaxDiff(src, affine) == 0 && MaxDiff(src, perspective) == 0, "identity warp changes frame");
+
+        // dst(x, y) = src(x + 5, y - 3)
+        ImGui::ImMat moved = make_dst(w, h);
+        ImGui::Warp_cpu::warpAffine(src, moved, Matrix({1, 0, 5, 0, 1, -3}), mode, border, ImPixel());
+        bool ok = true;
+        for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+        for (int k = 0; k < 4; k++)
+        {
+            const bool inside = x + 5 < w && y - 3 >= 0;
+            const uint8_t expect = inside ? ((const uint8_t *)src.data)[((size_t)(y - 3) * w + x + 5) * 4 + k] : border8[k];
+            const uint8_t value = ((const uint8_t *)moved.data)[((size_t)y * w + x) * 4 + k];
+            // bicubic window of last inside pixels takes border with zero weight
+            ok &= value == expect;
+        }
+        Check(ok, "translation differs");
+    }
+
+    // dst of h x w, dst(x, y) = src(y, h - 1 - x)
+    ImGui::ImMat rotated = make_dst(h, w);
+    ImGui::Warp_cpu::warpAffine(src, rotated, Matrix({0, 1, 0, -1, 0, (float)(h - 1)}), IM_INTERPOLATE_NEAREST, border, ImPixel());
+    bool ok = true;
+    for (int y = 0; y < w; y++)
+    for (int x = 0; x < h; x++)
+    for (int k = 0; k < 4; k++)
+        ok &= ((const uint8_t *)rotated.data)[((size_t)y * h + x) * 4 + k] == ((const uint8_t *)src.data)[((size_t)(h - 1 - x) * w + y) * 4 + k];
+    Check(ok, "rotation by 90 degrees differs");
+
+    // crop l 2, t 3, r 4, b 5
+    ImGui::ImMat cropped = make_dst(w, h);
+    ImGui::Warp_cpu::warpAffine(src, cropped, Matrix({1, 0, 0, 0, 1, 0}), IM_INTERPOLATE_NEAREST, border, ImPixel(2, 3, 4, 5));
+    ok = true;
+    for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++)
+    for (int k = 0; k < 4; k++)
+    {
+        const size_t i = ((size_t)y * w + x) * 4 + k;
+        const bool inside = x >= 2 && x < w - 4 && y >= 3 && y < h - 5;
+        ok &= ((const uint8_t *)cropped.data)[i] == (inside ? ((const uint8_t *)src.data)[i] : border8[k]);
+    }
+    Check(ok, "crop differs");
+
+    // rotation by 30 degrees about center, both ways round sub pixel positions differently
+    const float a = 0.5235988f, cx = w * 0.5f, cy = h * 0.5f;
+    const std::vector<float> rotation = {cosf(a), -sinf(a), cx - cx * cosf(a) + cy * sinf(a), sinf(a), cosf(a), cy - cx * sinf(a) - cy * cosf(a)};
+    std::vector<float> rotation3(rotation);
+    rotation3.insert(rotation3.end(), {0, 0, 1});
+    ImGui::ImMat affine = make_dst(w, h), perspective = make_dst(w, h);
+    ImGui::Warp_cpu::warpAffine(src, affine, Matrix(rotation), IM_INTERPOLATE_BILINEAR, border, ImPixel());
+    ImGui::Warp_cpu::warpPerspective(src, perspective, Matrix(rotation3), IM_INTERPOLATE_BILINEAR, border, ImPixel());
+    int differ = 0;
+    for (size_t i = 0; i < (size_t)w * h * 4; i++)
+        differ += std::abs((int)((const uint8_t *)affine.data)[i] - (int)((const uint8_t *)perspective.data)[i]) > 2;
+    Check(differ < w * h * 4 / 100, "affine and perspective of same rotation differ");
+}
+
+static void Benchmark(const char* label, const char* mode, int w, int h, int iterations, const std::function<void()>& func)
+{
+    func();
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+        func();
+    const double ms = ElapsedMs(start) / iterations;
+    fprintf(stdout, "  %-26s %-9s %8.3f ms  %8.1f Mpixel/s\n", label, mode, ms, (double)w * h / 1000.0 / ms);
+}
+
+int main(int argc, char** argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+        return 1;
+
+    const bool gpu = ImGui::get_gpu_count() > 0;
+    fprintf(stdout, "vulkan device: %s\n", gpu ? "yes, shader filters are measured as well" : "no, cpu backend only");
+
+    CheckResize();
+    fprintf(stdout, "resize check: %s\n", g_failures == 0 ? "ok" : "MISMATCH");
+    const int resize_failures = g_failures;
+    CheckWarp();
+    fprintf(stdout, "warp check: %s\n", g_failures == resize_failures ? "ok" : "MISMATCH");
+
+    const int w = 1920, h = 1080;
+    const char* mode_names[] = {"nearest", "bilinear", "bicubic", "area"};
+    const ImInterpolateMode modes[] = {IM_INTERPOLATE_NEAREST, IM_INTERPOLATE_BILINEAR, IM_INTERPOLATE_BICUBIC, IM_INTERPOLATE_AREA};
+    struct { const char* label; int dw, dh; } targets[] = {{"INT8 to 1280x720", 1280, 720}, {"INT8 to 3840x2160", 3840, 2160}, {"INT8 to 480x270", 480, 270}};
+    ImGui::ImMat src = MakeFrame(w, h, 4, IM_DT_INT8);
+    ImGui::ImMat src16 = MakeFrame(w, h, 4, IM_DT_INT16);
+    ImGui::ImMat src32 = MakeFrame(w, h, 4, IM_DT_FLOAT32);
+    fprintf(stdout, "%dx%d cpu backend, Mpixel/s of destination:\n", w, h);
+    for (auto target : targets)
+    {
+        ImGui::ImMat dst;
+        dst.create_type(target.dw, target.dh, 4, IM_DT_INT8);
+        for (int m = 0; m < 4; m++)
+            Benchmark(target.label, mode_names[m], target.dw, target.dh, iterations, [&]() { ImGui::Warp_cpu::Resize(src, dst, modes[m]); });
+    }
+    ImGui::ImMat dst16, dst32;
+    dst16.create_type(1280, 720, 4, IM_DT_INT16);
+    dst32.create_type(1280, 720, 4, IM_DT_FLOAT32);
+    for (int m = 1; m < 3; m++)
+    {
+        Benchmark("INT16 to 1280x720", mode_names[m], 1280, 720, iterations, [&]() { ImGui::Warp_cpu::Resize(src16, dst16, modes[m]); });
+        Benchmark("FLOAT32 to 1280x720", mode_names[m], 1280, 720, iterations, [&]() { ImGui::Warp_cpu::Resize(src32, dst32, modes[m]); });
+    }
+
+    // rotation by 15 degrees with scale 0.9 about center, perspective adds a small tilt
+    const float a = 0.2617994f, s = 1.f / 0.9f, cx = w * 0.5f, cy = h * 0.5f;
+    ImGui::ImMat affine_m = Matrix({s * cosf(a), -s * sinf(a), cx - s * (cx * cosf(a) - cy * sinf(a)), s * sinf(a), s * cosf(a), cy - s * (cx * sinf(a) + cy * cosf(a))});
+    ImGui::ImMat perspective_m = Matrix({s * cosf(a), -s * sinf(a), cx - s * (cx * cosf(a) - cy * sinf(a)), s * sinf(a), s * cosf(a), cy - s * (cx * sinf(a) + cy * cosf(a)), 2e-5f, 1e-5f, 1.f});
+    ImGui::ImMat dst;
+    dst.create_type(w, h, 4, IM_DT_INT8);
+    for (int m = 0; m < 3; m++)
+    {
+        Benchmark("INT8 warpAffine", mode_names[m], w, h, iterations, [&]() { ImGui::Warp_cpu::warpAffine(src, dst, affine_m, modes[m], ImPixel(), ImPixel()); });
+        Benchmark("INT8 warpPerspective", mode_names[m], w, h, iterations, [&]() { ImGui::Warp_cpu::warpPerspective(src, dst, perspective_m, modes[m], ImPixel(), ImPixel()); });
+    }
+    if (gpu)
+    {
+        ImGui::Resize_vulkan resize(ImGui::get_default_gpu_index());
+        ImGui::warpAffine_vulkan affine(ImGui::get_default_gpu_index());
+        ImGui::warpPerspective_vulkan perspective(ImGui::get_default_gpu_index());
+        fprintf(stdout, "%dx%d vulkan, with upload and download:\n", w, h);
+        for (auto target : targets)
+        {
+            ImGui::ImMat gpu_dst;
+            gpu_dst.create_type(target.dw, target.dh, 4, IM_DT_INT8);
+            for (int m = 0; m < 4; m++)
+                Benchmark(target.label, mode_names[m], target.dw, target.dh, iterations, [&]() { resize.Resize(src, gpu_dst, 0.f, 0.f, modes[m]); });
+        }
+        ImGui::ImMat gpu_dst;
+        gpu_dst.type = IM_DT_INT8;
+        for (int m = 0; m < 3; m++)
+        {
+            Benchmark("INT8 warpAffine", mode_names[m], w, h, iterations, [&]() { affine.warp(src, gpu_dst, affine_m, modes[m]); });
+            Benchmark("INT8 warpPerspective", mode_names[m], w, h, iterations, [&]() { perspective.warp(src, gpu_dst, perspective_m, modes[m]); });
+        }
+    }
+
+    return Result();
+}